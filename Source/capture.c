@@ -0,0 +1,360 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: capture.c,v $
+Title           :   Frame capture
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Writes what the back end hands the hardware for each
+					render to a capture file, in the format in capture.h,
+					so it can be replayed through the simulator without
+					the application.
+
+					Changed texture pages are found by keeping a checksum
+					of every page and comparing it each frame. That reads
+					all of texture memory once a frame, which is slow, but
+					only while capturing.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: capture.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_CAPTURE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "pvrosapi.h"
+#include "texapi.h"
+#include "sglmem.h"
+#include "profile.h"
+#include "capture.h"
+
+typedef enum
+{
+	CAPTURE_UNKNOWN,	/* sgl.ini not read yet */
+	CAPTURE_OFF,
+	CAPTURE_ON
+
+} CAPTURE_STATE;
+
+static CAPTURE_STATE	eState = CAPTURE_UNKNOWN;
+
+static FILE				*fpCapture = NULL;
+
+static sgl_uint32		u32Skip;			/* renders still to skip */
+static sgl_uint32		u32FramesLeft;		/* 0 is no limit */
+static sgl_uint32		u32Frame;
+
+static sgl_uint32		u32TexPages;
+static sgl_uint32		*pu32PageSum = NULL;
+static sgl_bool			bPageSumsValid;
+
+/*
+// Checksum of one texture page (Fletcher-32 over the words)
+*/
+static sgl_uint32 PageSum (const CAPTURE_UINT32 *pu32Page)
+{
+	sgl_uint32	u32A = 0, u32B = 0;
+	int			k;
+
+	for (k = 0; k < (int) (CAPTURE_PAGE_BYTES / 4); k++)
+	{
+		u32A = (u32A + pu32Page[k]) % 65535UL;
+		u32B = (u32B + u32A) % 65535UL;
+	}
+
+	return ((u32B << 16) | u32A);
+}
+
+/*
+// Writes a chunk header and its data, or just the header if pData is
+// NULL. Returns FALSE if the write failed.
+*/
+static sgl_bool WriteChunk (sgl_uint32 u32Tag, const void *pData, sgl_uint32 u32Bytes)
+{
+	CAPTURE_CHUNK	Chunk;
+
+	Chunk.u32Tag = u32Tag;
+	Chunk.u32Bytes = u32Bytes;
+
+	if (fwrite (&Chunk, sizeof (Chunk), 1, fpCapture) != 1)
+	{
+		return (FALSE);
+	}
+
+	if (pData && u32Bytes && (fwrite (pData, u32Bytes, 1, fpCapture) != 1))
+	{
+		return (FALSE);
+	}
+
+	return (TRUE);
+}
+
+/*
+// Writes a chunk of sgl_uint32s as 32 bit words
+*/
+static sgl_bool WriteWords (sgl_uint32 u32Tag, const sgl_uint32 *pu32Words, sgl_uint32 u32Words)
+{
+	CAPTURE_UINT32	Words[256];
+	sgl_uint32		u32Done, k, n;
+
+	if (sizeof (sgl_uint32) == sizeof (CAPTURE_UINT32))
+	{
+		return (WriteChunk (u32Tag, pu32Words, u32Words * sizeof (CAPTURE_UINT32)));
+	}
+
+	if (!WriteChunk (u32Tag, NULL, u32Words * sizeof (CAPTURE_UINT32)))
+	{
+		return (FALSE);
+	}
+
+	for (u32Done = 0; u32Done < u32Words; u32Done += n)
+	{
+		n = u32Words - u32Done;
+
+		if (n > 256)
+		{
+			n = 256;
+		}
+
+		for (k = 0; k < n; k++)
+		{
+			Words[k] = (CAPTURE_UINT32) pu32Words[u32Done + k];
+		}
+
+		if (fwrite (Words, n * sizeof (CAPTURE_UINT32), 1, fpCapture) != 1)
+		{
+			return (FALSE);
+		}
+	}
+
+	return (TRUE);
+}
+
+/*
+// Writes the parameter words used so far in one of the device's buffers
+*/
+static sgl_bool WriteParams (sgl_uint32 u32Tag, const PVR_PARAM_BUFF *pBuff)
+{
+	sgl_uint32	u32Words = pBuff->uBufferPos;
+
+	if ((pBuff->pBuffer == NULL) || (u32Words > pBuff->uBufferLimit))
+	{
+		u32Words = 0;
+	}
+
+	return (WriteWords (u32Tag, pBuff->pBuffer, u32Words));
+}
+
+/*
+// Reads the settings and opens the file, on the first render
+*/
+static void CaptureOpen (HLDEVICE hLDev)
+{
+	char			szFile[256];
+	CAPTURE_HEADER	Header;
+	sgl_uint32		u32TexBytes;
+
+	eState = CAPTURE_OFF;
+
+	SglReadPrivateProfileString ("Capture", "File", "", szFile, sizeof (szFile), "sgl.ini");
+
+	if (szFile[0] == '\0')
+	{
+		return;
+	}
+
+	u32Skip = (sgl_uint32) SglReadPrivateProfileInt ("Capture", "First", 0, "sgl.ini");
+	u32FramesLeft = (sgl_uint32) SglReadPrivateProfileInt ("Capture", "Frames", 100, "sgl.ini");
+
+	u32TexBytes = hLDev->TexasMemBytes & ~(CAPTURE_PAGE_BYTES - 1);
+	u32TexPages = u32TexBytes >> CAPTURE_PAGE_SHIFT;
+
+	if (u32TexPages)
+	{
+		pu32PageSum = SGLMalloc (u32TexPages * sizeof (sgl_uint32));
+
+		if (pu32PageSum == NULL)
+		{
+			DPF ((DBG_ERROR, "CaptureOpen: no memory for page sums"));
+			return;
+		}
+	}
+
+	fpCapture = fopen (szFile, "wb");
+
+	if (fpCapture == NULL)
+	{
+		DPF ((DBG_ERROR, "CaptureOpen: can't create %s", szFile));
+		CaptureClose ();
+		return;
+	}
+
+	Header.u32Magic = CAPTURE_MAGIC;
+	Header.u32Version = CAPTURE_VERSION;
+	Header.u32HeaderBytes = sizeof (Header);
+	Header.u32ByteOrder = CAPTURE_BYTE_ORDER;
+	Header.u32DeviceType = (sgl_uint32) hLDev->DeviceType;
+	Header.u32TexMemBytes = u32TexBytes;
+	Header.u32PageBytes = CAPTURE_PAGE_BYTES;
+	Header.u32Reserved = 0;
+
+	if (fwrite (&Header, sizeof (Header), 1, fpCapture) != 1)
+	{
+		CaptureClose ();
+		return;
+	}
+
+	DPF ((DBG_MESSAGE, "CaptureOpen: capturing to %s", szFile));
+
+	bPageSumsValid = FALSE;
+	u32Frame = 0;
+
+	eState = CAPTURE_ON;
+}
+
+/*===========================================
+ * Function:	CaptureFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Writes one render to the capture file, if capturing.
+ *
+ * Params:		HLDEVICE hLDev: the logical device about to render
+ *				sgl_bool bStrip: TRUE if this is one strip of a frame
+ *
+ * Return:		void
+ *========================================================================================*/
+void CaptureFrame (HLDEVICE hLDev, sgl_bool bStrip)
+{
+	CAPTURE_FRAME		Frame;
+	const CAPTURE_UINT32	*pu32TexMem;
+	CAPTURE_UINT32		u32Page;
+	sgl_uint32			u32Sum;
+	sgl_bool			bOK;
+
+	if (eState == CAPTURE_UNKNOWN)
+	{
+		CaptureOpen (hLDev);
+	}
+
+	if (eState != CAPTURE_ON)
+	{
+		return;
+	}
+
+	if (u32Skip != 0)
+	{
+		u32Skip--;
+		return;
+	}
+
+	pu32TexMem = NULL;
+
+	if (hLDev->TexHeap != NULL)
+	{
+		pu32TexMem = (const CAPTURE_UINT32 *) ((HTEXHEAP) hLDev->TexHeap)->pTextureMemory;
+	}
+
+	Frame.u32Frame = u32Frame++;
+	Frame.u32Flags = bStrip ? CAPTURE_FRAME_STRIP : 0;
+
+	bOK = WriteChunk (CAPTURE_TAG_FRAME, &Frame, sizeof (Frame)) &&
+		  WriteWords (CAPTURE_TAG_REGS, hLDev->Registers, CAPTURE_NUM_REGS) &&
+		  WriteParams (CAPTURE_TAG_ISP, &hLDev->Buffers[PVR_PARAM_TYPE_ISP]) &&
+		  WriteParams (CAPTURE_TAG_TSP, &hLDev->Buffers[PVR_PARAM_TYPE_TSP]) &&
+		  WriteParams (CAPTURE_TAG_REGION, &hLDev->Buffers[PVR_PARAM_TYPE_REGION]);
+
+	/*
+	// Texture pages that have changed since the last frame
+	*/
+	if (pu32TexMem != NULL)
+	{
+		for (u32Page = 0; bOK && (u32Page < u32TexPages); u32Page++)
+		{
+			const CAPTURE_UINT32 *pu32Page = pu32TexMem + (u32Page << (CAPTURE_PAGE_SHIFT - 2));
+
+			u32Sum = PageSum (pu32Page);
+
+			if (!bPageSumsValid || (u32Sum != pu32PageSum[u32Page]))
+			{
+				CAPTURE_CHUNK	Chunk;
+
+				pu32PageSum[u32Page] = u32Sum;
+
+				Chunk.u32Tag = CAPTURE_TAG_TEXTURE;
+				Chunk.u32Bytes = sizeof (CAPTURE_UINT32) + CAPTURE_PAGE_BYTES;
+
+				bOK = (fwrite (&Chunk, sizeof (Chunk), 1, fpCapture) == 1) &&
+					  (fwrite (&u32Page, sizeof (u32Page), 1, fpCapture) == 1) &&
+					  (fwrite (pu32Page, CAPTURE_PAGE_BYTES, 1, fpCapture) == 1);
+			}
+		}
+
+		bPageSumsValid = TRUE;
+	}
+
+	bOK = bOK && WriteChunk (CAPTURE_TAG_END, NULL, 0);
+
+	/* Keep what we have readable if the application never shuts down */
+	fflush (fpCapture);
+
+	if (!bOK)
+	{
+		DPF ((DBG_ERROR, "CaptureFrame: write failed, capture stopped"));
+		CaptureClose ();
+	}
+	else if (u32FramesLeft && (--u32FramesLeft == 0))
+	{
+		DPF ((DBG_MESSAGE, "CaptureFrame: %lu frames captured", (unsigned long) u32Frame));
+		CaptureClose ();
+	}
+}
+
+/*===========================================
+ * Function:	CaptureClose
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Ends the capture, if there is one.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void CaptureClose (void)
+{
+	if (fpCapture != NULL)
+	{
+		fclose (fpCapture);
+		fpCapture = NULL;
+	}
+
+	if (pu32PageSum != NULL)
+	{
+		SGLFree (pu32PageSum);
+		pu32PageSum = NULL;
+	}
+
+	if (eState != CAPTURE_UNKNOWN)
+	{
+		eState = CAPTURE_OFF;
+	}
+}
+
+/* capture.c */
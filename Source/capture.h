@@ -0,0 +1,151 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: capture.h,v $
+Title           :   CAPTURE.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Frame capture file format, shared by the driver, which
+					writes it, and the replay tool (tools/replay), which
+					reads it.
+
+					A capture is a CAPTURE_HEADER followed by chunks. Each
+					chunk is a CAPTURE_CHUNK giving its tag and the number
+					of bytes of data after it, which is always a whole
+					number of 32 bit words. A frame is a CAPTURE_TAG_FRAME
+					chunk, then the register, parameter and texture chunks
+					for it, then a CAPTURE_TAG_END chunk. Readers must skip
+					tags they don't know, so chunks can be added without
+					changing the version; the version only goes up if an
+					existing chunk changes.
+
+					Everything is written in the byte order of the machine
+					doing the capture; u32ByteOrder lets a reader tell.
+
+					Texture memory is split into pages. The first frame
+					carries every page, later frames only the pages that
+					have changed since the frame before, so a reader keeps
+					its own copy of texture memory and applies them.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: capture.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+/*
+// sgl_uint32 is a long, which isn't 32 bits everywhere, so the file uses
+// its own type
+*/
+typedef unsigned int	CAPTURE_UINT32;
+
+#define CAPTURE_MAGIC			0x43474C53UL	/* "SLGC" read as bytes */
+#define CAPTURE_VERSION			1
+#define CAPTURE_BYTE_ORDER		0x01020304UL
+
+/* The PCX register shadow, indexed by the PCX_ offsets in pcx/hwregs.h */
+#define CAPTURE_NUM_REGS		32
+
+#define CAPTURE_PAGE_SHIFT		12
+#define CAPTURE_PAGE_BYTES		(1UL << CAPTURE_PAGE_SHIFT)
+
+/*
+// Chunk tags, as four characters
+*/
+#define CAPTURE_TAG(a,b,c,d)	((CAPTURE_UINT32) (a) | ((CAPTURE_UINT32) (b) << 8) | \
+								 ((CAPTURE_UINT32) (c) << 16) | ((CAPTURE_UINT32) (d) << 24))
+
+#define CAPTURE_TAG_FRAME		CAPTURE_TAG ('F','R','M','E')	/* CAPTURE_FRAME */
+#define CAPTURE_TAG_REGS		CAPTURE_TAG ('R','E','G','S')	/* CAPTURE_NUM_REGS words */
+#define CAPTURE_TAG_ISP			CAPTURE_TAG ('I','S','P','B')	/* ISP parameter words */
+#define CAPTURE_TAG_TSP			CAPTURE_TAG ('T','S','P','B')	/* TSP parameter words */
+#define CAPTURE_TAG_REGION		CAPTURE_TAG ('R','G','N','B')	/* region (object pointer) words */
+#define CAPTURE_TAG_TEXTURE		CAPTURE_TAG ('T','E','X','P')	/* page number, then the page */
+#define CAPTURE_TAG_END			CAPTURE_TAG ('E','N','D','F')	/* no data */
+
+/* CAPTURE_FRAME u32Flags */
+#define CAPTURE_FRAME_STRIP		0x00000001UL	/* one strip of a strip rendered frame */
+
+typedef struct tagCAPTURE_HEADER
+{
+	CAPTURE_UINT32	u32Magic;			/* CAPTURE_MAGIC */
+	CAPTURE_UINT32	u32Version;			/* CAPTURE_VERSION */
+	CAPTURE_UINT32	u32HeaderBytes;		/* sizeof (CAPTURE_HEADER) when written */
+	CAPTURE_UINT32	u32ByteOrder;		/* CAPTURE_BYTE_ORDER */
+	CAPTURE_UINT32	u32DeviceType;		/* the DEVICE_TYPE of the board */
+	CAPTURE_UINT32	u32TexMemBytes;		/* size of texture memory */
+	CAPTURE_UINT32	u32PageBytes;		/* CAPTURE_PAGE_BYTES */
+	CAPTURE_UINT32	u32Reserved;
+
+} CAPTURE_HEADER;
+
+typedef struct tagCAPTURE_CHUNK
+{
+	CAPTURE_UINT32	u32Tag;
+	CAPTURE_UINT32	u32Bytes;			/* data following, a multiple of 4 */
+
+} CAPTURE_CHUNK;
+
+typedef struct tagCAPTURE_FRAME
+{
+	CAPTURE_UINT32	u32Frame;			/* count of renders since capture began */
+	CAPTURE_UINT32	u32Flags;			/* CAPTURE_FRAME_ flags */
+
+} CAPTURE_FRAME;
+
+/*
+// The rest is for the driver only
+*/
+#ifdef __PVROSAPI_H__
+
+/*===========================================
+ * Function:	CaptureFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Called by the back end just before it starts a render.
+ *				Writes the registers, parameter buffers and changed
+ *				texture pages for it if capturing is on, which it is
+ *				when the [Capture] File entry of sgl.ini names a file.
+ *				[Capture] First skips that many renders first, and
+ *				[Capture] Frames (default 100, 0 for no limit) says how
+ *				many to write before the file is closed.
+ *
+ * Params:		HLDEVICE hLDev: the logical device about to render
+ *				sgl_bool bStrip: TRUE if this is one strip of a frame
+ *
+ * Return:		void
+ *========================================================================================*/
+void CaptureFrame (HLDEVICE hLDev, sgl_bool bStrip);
+
+/*===========================================
+ * Function:	CaptureClose
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Ends the capture, if there is one.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void CaptureClose (void);
+
+#endif /* __PVROSAPI_H__ */
+
+#endif /* __CAPTURE_H__ */
+
+/*------------------------------- End of File -------------------------------*/
@@ -173,6 +173,7 @@
 #include "pvrosapi.h"
 #include "parmbuff.h"
 #include "sglmem.h"
+#include "sglthrd.h"
 
 #if DAG_TRANS_SORTING
 	#include "dtri.h" /* for ITRI structure */
@@ -370,6 +371,7 @@ typedef struct	_region_header {
 #if DAG_TRANS_SORTING
 	PTRANSTRIINDEX_STRUCT uTransTriList;
 	sgl_uint16 usTransTriCounter;	  /* Total number of tris */
+	TRANS_PASSES_STRUCT sTransPasses; /* Sorted, waiting to be output */
 #endif /* DAG_TRANS_SORTING */
 	sgl_uint32 CurTSetId[2];			/* Current TRANSSET Ids					*/
 	sgl_uint16 nPassCount;			/* Number of translucent passes in a tile.	*/
@@ -3584,7 +3586,7 @@ static INLINE sgl_uint32 *GenerateDAGTransPtr ( REGION_HEADER *pRegion, sgl_uint
 	sgl_uint32 nDiscardedPlanes = *dPlanes;
 
 	/* Output the graph in passes */
-  	curAddr = Traverse(pRegion->usTransTriCounter, curAddr, &RegionPlanes);
+  	curAddr = OutputTransPasses(&pRegion->sTransPasses, curAddr, &RegionPlanes);
 
 	/* Remove objects that put number of planes over the limit.*/
 	nDiscardedPlanes += RegionPlanes;
@@ -3888,6 +3890,91 @@ static int DumpedOne = 1;
 
 int number = 0;
 
+#if DAG_TRANS_SORTING
+/* Regions with translucent triangles to sort this frame */
+#define MAX_TRANS_SORT_JOBS	(MAX_X_REGIONS * ((MAX_Y_RESOLUTION/2)+1))
+
+static REGION_HEADER *pTransSortJobs[MAX_TRANS_SORT_JOBS];
+
+/*****************************************************************************
+ * Function Name  : SortTransTask
+ * Inputs         : nTask   - index into pTransSortJobs
+ *					nThread - thread running the task, whose workspace it uses
+ * Returns        : 
+ * Global Used    : pTransSortJobs
+ * Description    : Thread pool task for SortRegionsTransTris.
+ *****************************************************************************/
+static void SortTransTask( void *pContext, int nTask, int nThread )
+{
+	REGION_HEADER *pRegion = pTransSortJobs[nTask];
+
+	SortRegionTransTris( (sgl_uint32) pRegion->usTransTriCounter,
+						 pRegion->uTransTriList, &pRegion->sTransPasses, nThread );
+}
+
+/*****************************************************************************
+ * Function Name  : SortRegionsTransTris
+ * Inputs         : pRegionsRect - regions to output
+ *					pStrip       - first strip to output
+ *					pLastStrip   - last strip to output
+ * Returns        : 
+ * Global Used    : pTransSortJobs
+ * Description    : Sorts the translucent triangles of every region that is
+ *					about to be output, leaving the passes in each region's
+ *					sTransPasses. It visits the same strips and regions as
+ *					the output loop in GenerateObjectPtrLite, which outputs
+ *					every region with translucent triangles, and the sort
+ *					stops recording passes once they couldn't be put in.
+ *					Regions don't depend on each other, so they are shared
+ *					out over the thread pool.
+ *****************************************************************************/
+static void SortRegionsTransTris( const REGIONS_RECT_STRUCT *const pRegionsRect,
+								  REGION_STRIP *pStrip, REGION_STRIP *pLastStrip )
+{
+	int nJobs = 0, nJob, nThreads = SglThreadPoolCount();
+
+	for ( ;; pStrip = pStrip->pNext )
+	{
+		int Width = pStrip->Width;
+		int Region = pRegionsRect->FirstXRegion >> Width;
+		int LastRegion = pRegionsRect->LastXRegion >> Width;
+
+		for ( ; Region <= LastRegion; Region++ )
+		{
+			if ( pStrip->Regions[Region].uTransTriList != NULL )
+			{
+				ASSERT( nJobs < MAX_TRANS_SORT_JOBS );
+				pTransSortJobs[nJobs++] = &pStrip->Regions[Region];
+			}
+		}
+
+		/* Last strip done */
+		if ( pStrip == pLastStrip ) break;
+	}
+
+	if ( nJobs == 0 )
+	{
+		return;
+	}
+
+	/* Every thread in the pool needs a workspace to go parallel */
+	if ( ( nJobs > 1 ) && ( nThreads > 1 ) &&
+		 ( PrepareTransortWorkspaces( nThreads ) == nThreads ) )
+	{
+		SglThreadParallelFor( nJobs, SortTransTask, NULL );
+	}
+	else
+	{
+		PrepareTransortWorkspaces( 1 );
+
+		for ( nJob = 0; nJob < nJobs; nJob++ )
+		{
+			SortTransTask( NULL, nJob, 0 );
+		}
+	}
+}
+#endif /*DAG_TRANS_SORTING*/
+
 /*****************************************************************************
  * Function Name  : GenerateObjectPtrLite
  * Inputs         : bRenderAllRegions - if nonzero then all regions are
@@ -3966,6 +4053,11 @@ int GenerateObjectPtrLite( const REGIONS_RECT_STRUCT *const pRegionsRect,
 	}
 #endif
 
+#if DAG_TRANS_SORTING
+	/* Sort every region's translucent triangles before any are output */
+	SortRegionsTransTris( pRegionsRect, pStrip, pLastStrip );
+#endif
+
 	for ( ;; pStrip = pStrip->pNext )
 	{
 		REGION_HEADER *pRegion;
@@ -4066,16 +4158,12 @@ int GenerateObjectPtrLite( const REGIONS_RECT_STRUCT *const pRegionsRect,
 			/* We need to fiddle with the new sorting algorithm.
 			 */
 			if ( pRegion->uTransTriList != NULL )
-			{	/* Create the graph
-				 */
-				DoTheStuff( (sgl_uint32) pRegion->usTransTriCounter, 
-							&pRegion->uTransTriList );
-
-				/* Calculate the number of planes need for the new sorting algorothm.
+			{	/* The graph was made by SortRegionsTransTris. Get the number
+				 * of planes need for the new sorting algorothm.
 				 * This is required regardless if vignetting fix is being used or
 				 * not. Needed to cycle through the graph.
 				 */
-				uSortedPlanes = FixForVignetting(pRegion->usTransTriCounter);
+				uSortedPlanes = pRegion->sTransPasses.uSortedPlanes;
 			}
 
 #endif /*DAG_TRANS_SORTING*/		 
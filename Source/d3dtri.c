@@ -468,7 +468,7 @@ static void ProcessD3DPolys (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -488,7 +488,7 @@ static void ProcessD3DPolys (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -648,7 +648,7 @@ static void ProcessD3DTriPrimitives (	PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -668,7 +668,7 @@ static void ProcessD3DTriPrimitives (	PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -831,7 +831,7 @@ static void ProcessD3DTransTris(PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -852,7 +852,7 @@ static void ProcessD3DTransTris(PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
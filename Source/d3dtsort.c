@@ -94,10 +94,12 @@
  * 
  *************************************************************************/
 
+#include <string.h>
 #include "sgl_defs.h"
 #include "pvrosapi.h"
 #include "sgl_math.h"
 #include "sglmem.h"
+#include "sglthrd.h"
 #include "pvrlims.h"
 #include "dtri.h"
 #include "dregion.h"
@@ -108,16 +110,18 @@
 	My local functions
 ************************************************************************/
 
-PTRIANGLE_REFERENCE NewTriangleReference( void );
+typedef struct _sort_workspace_ *PSORT_WORKSPACE;
 
-void Intersect( PTRANSTRI_STRUCT *ppsTriNodes, PTRANSTRI_STRUCT *ppsLeftStack, PTRANSTRI_STRUCT *ppsRightStack, unsigned bIsAscending, unsigned uNumTris, unsigned uLevel );
+PTRIANGLE_REFERENCE NewTriangleReference( PSORT_WORKSPACE psWs );
+
+void Intersect( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, PTRANSTRI_STRUCT *ppsLeftStack, PTRANSTRI_STRUCT *ppsRightStack, unsigned bIsAscending, unsigned uNumTris, unsigned uLevel );
 
 #if FOUL_OR_NEWFOUL_ALLINTERSECTS
-	void FoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, sgl_uint32 uNumItris ); 
-	void NewFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris );
+	void FoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, sgl_uint32 uNumItris ); 
+	void NewFoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris );
 #endif /*FOUL_OR_NEWFOUL_ALLINTERSECTS*/
 
-void NewerFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris );
+void NewerFoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris );
 /* Other prototypes in D3Dreg.h */
 
 /************************************************************************
@@ -141,11 +145,20 @@ typedef struct _LOCAL_REF_
 typedef struct _LOCAL_NODE_
 {
 	PTRANSTRI_STRUCT psTriNode;
+	float fMin[2];		/* Bounding box, grown by BOUNDS_MARGIN */
+	float fMax[2];
 	struct _LOCAL_NODE_ *psMarkedBy;
 	PLOCAL_REF psParents;
 	PLOCAL_REF psChildren;
 } LOCAL_NODE, *PLOCAL_NODE;
 
+/* An overlap candidate found by SweepBounds */
+typedef struct _BROAD_PAIR_
+{
+	int nOther;						/* Lower numbered node of the pair */
+	struct _BROAD_PAIR_ *psNext;
+} BROAD_PAIR, *PBROAD_PAIR;
+
 /************************************************************************
 	My local defines
 ************************************************************************/
@@ -166,6 +179,17 @@ typedef struct _LOCAL_NODE_
 #define Z 2
 
 
+/* References in the first block; later blocks double in size */
+#define REF_BLOCK_FIRST (MAX_NUM_REGION_TRIS * 4)
+
+/*
+	Triangles whose bounding boxes are further apart than this can't be
+	found to overlap. The edge lines in fAdjoint are normalised so |A|+|B|
+	is 1, so the TOL that Overlaps allows either side of a line is never
+	more than TOL * sqrt(2) pixels.
+*/
+#define BOUNDS_MARGIN 0.01f
+
 /* For CreatePasses */
 #define LOCAL_REFS 10000
 #define LOCAL_NODES 1000
@@ -206,27 +230,61 @@ const sgl_uint32 ClearMask	= 0xffff0fff;
 const sgl_uint32 TOL = 0x3b03126f;
 const float fMaxMinVal = 100000.0f;
 
-char        *pcWorkspace = NULL;;
-char        *pcWorkspacePtr;
-sgl_uint32  uWorkspaceStart;
-sgl_uint16	g_usCellCount = 0; /* For hashing */
+/*
+	The graph edges come from a list of blocks that grows as a region needs
+	more. The blocks are kept from one region to the next, so a new one is
+	only allocated when a region has more overlaps than any before it.
+*/
+typedef struct _ref_block_
+{
+	struct _ref_block_	*psNext;
+	sgl_uint32			uNumRefs;
+	TRIANGLE_REFERENCE	sRefs[1];	/* Really uNumRefs of them */
+} REF_BLOCK, *PREF_BLOCK;
+
+/*
+	Everything needed to sort one region. Each thread sorting regions has
+	its own, so regions can be sorted at the same time. The triangles are
+	copied in, as a triangle in several regions has a graph node in each.
+	The passes a workspace records are kept until the end of the frame.
+*/
+typedef struct _sort_workspace_
+{
+	TRANSTRI_STRUCT		sTris[MAX_NUM_REGION_TRIS];
+	PTRANSTRI_STRUCT	psTriNodes[MAX_NUM_REGION_TRIS];
+	PTRANSTRI_STRUCT	ppsTriNodePtrs[NUM_PPSTRINODEPTRS];  /* Array of pointers for partitioning */
+	PTRANSTRI_STRUCT	*ppsDisplayList;
+
+	LOCAL_REF			sLocalRefs[LOCAL_REFS];
+	LOCAL_NODE			sLocalNodes[LOCAL_NODES];
+
+	/* Broadphase for NewAllIntersects */
+	BROAD_PAIR			sPairs[LOCAL_REFS];
+	PBROAD_PAIR			psCandidates[LOCAL_NODES];
+	int					nSweep[LOCAL_NODES];
+	int					nActive[LOCAL_NODES];
+
+	HASH_STRUCT			Hash[HASH_SIZE];
+	sgl_uint16			usCellCount; /* For hashing */
 
-static sgl_uint32 uNumPasses;
-static sgl_uint32 g_uPasses;
+	sgl_uint32			uNumPasses;
+	sgl_uint32			uPasses;
 
-PTRANSTRI_STRUCT  psTriNodes[MAX_NUM_REGION_TRIS];
-PTRANSTRI_STRUCT  ppsTriNodePtrs[NUM_PPSTRINODEPTRS];  /* Array of pointers for partitioning */
-PTRANSTRI_STRUCT  *ppsDisplayList = ppsTriNodePtrs;
+	PREF_BLOCK			psRefBlocks;		/* First block */
+	PREF_BLOCK			psRefBlock;			/* Block being allocated from */
+	sgl_uint32			uRefBlockUsed;		/* References used in psRefBlock */
 
-LOCAL_REF *psLocalRefs;
-LOCAL_NODE *psLocalNodes;
+	sgl_uint32			*puPassWords;		/* Passes recorded this frame */
+	sgl_uint32			uPassWords;			/* Words used */
+	sgl_uint32			uMaxPassWords;		/* Words allocated */
+} SORT_WORKSPACE;
+
+static PSORT_WORKSPACE psWorkspaces[SGL_MAX_THREADS];
 
 #if DEBUG
 	sgl_uint32 g_uInter;
 #endif
 
-static HASH_STRUCT Hash[HASH_SIZE];
-
 /* 
 	INLINE functions - Sgn is an expansion of:
 	#define SIDE(A) ((fabs(A) > TOL) ? (((A) > 0) ? 1 : -1) : 0)
@@ -254,92 +312,187 @@ static INLINE int Sgn(float fA)
 }
 
 /*
-	These functions allocate memory for new edges and nodes in the DAG
-	They just bump a pointer through a statically allocated lump called the workspace
+	Allocates a block of graph edges and links it after psAfter (or makes it
+	the workspace's first block if psAfter is NULL)
 */
-sgl_bool InitialiseTransortMemory( void )
+static PREF_BLOCK NewRefBlock( PSORT_WORKSPACE psWs, PREF_BLOCK psAfter, sgl_uint32 uNumRefs )
 {
-	/* Calculate in bytes */
-#if (MAX_NUM_REGION_TRIS > 512)
-	/* Cut down space as tris more tris are less likely to overlap each other */
-	uWorkspaceStart = ( ( sizeof( TRIANGLE_REFERENCE ) * ( (MAX_NUM_REGION_TRIS/16) * MAX_NUM_REGION_TRIS -1)) )  ;
-#else
-	uWorkspaceStart = ( ( sizeof( TRIANGLE_REFERENCE ) * ( (MAX_NUM_REGION_TRIS) * MAX_NUM_REGION_TRIS -1)) )  ;
-#endif
-	
-	pcWorkspace = SGLMalloc( uWorkspaceStart );	
+	PREF_BLOCK psBlock;
 
-	psLocalRefs = (LOCAL_REF *)SGLMalloc(sizeof(LOCAL_REF)*LOCAL_REFS);
-	psLocalNodes = (LOCAL_NODE *)SGLMalloc(sizeof(LOCAL_NODE)*LOCAL_NODES);
+	psBlock = (PREF_BLOCK)SGLMalloc( sizeof( REF_BLOCK ) + (uNumRefs - 1) * sizeof( TRIANGLE_REFERENCE ) );
 
-	if (!(pcWorkspace && psLocalRefs && psLocalNodes))
+	if (psBlock)
 	{
-		return (FALSE);
+		psBlock->psNext = NULL;
+		psBlock->uNumRefs = uNumRefs;
+
+		if (psAfter)
+		{
+			psAfter->psNext = psBlock;
+		}
+		else
+		{
+			psWs->psRefBlocks = psBlock;
+		}
 	}
 
-	return (TRUE);
+	return psBlock;
 }
 
-void FinalizeTransortMemory( void )
+static void FreeWorkspace( PSORT_WORKSPACE psWs )
 {
-	if (pcWorkspace)
-	{				  
-		DPF((DBG_MESSAGE,"Releasing Transorting Workspace memory"));
-		SGLFree(pcWorkspace);	
+	while (psWs->psRefBlocks)
+	{
+		PREF_BLOCK psNext = psWs->psRefBlocks->psNext;
+
+		SGLFree(psWs->psRefBlocks);
+		psWs->psRefBlocks = psNext;
 	}
-	if (psLocalRefs)
+
+	if (psWs->puPassWords)
 	{
-		DPF((DBG_MESSAGE,"Releasing Graph Reference memory"));
+		SGLFree(psWs->puPassWords);
+	}
+
+	SGLFree(psWs);
+}
 
-		SGLFree(psLocalRefs);
+static PSORT_WORKSPACE NewWorkspace( void )
+{
+	PSORT_WORKSPACE psWs;
+
+	psWs = (PSORT_WORKSPACE)SGLMalloc( sizeof( SORT_WORKSPACE ) );
+
+	if (psWs)
+	{
+		psWs->ppsDisplayList = psWs->ppsTriNodePtrs;
+
+		memset( psWs->Hash, 0, sizeof( psWs->Hash ) );
+		psWs->usCellCount = 0;
+
+		psWs->psRefBlocks = NULL;
+		psWs->psRefBlock = NewRefBlock( psWs, NULL, REF_BLOCK_FIRST );
+		psWs->uRefBlockUsed = 0;
+
+		psWs->puPassWords = NULL;
+		psWs->uPassWords = 0;
+		psWs->uMaxPassWords = 0;
+
+		if (!psWs->psRefBlock)
+		{
+			FreeWorkspace( psWs );
+			psWs = NULL;
+		}
 	}
-	if (psLocalNodes)
+
+	return psWs;
+}
+
+/*
+	These functions allocate memory for new edges and nodes in the DAG
+	Only the first thread's workspace is allocated here, the others
+	when PrepareTransortWorkspaces first asks for them
+*/
+sgl_bool InitialiseTransortMemory( void )
+{
+	if (!psWorkspaces[0])
 	{
-		DPF((DBG_MESSAGE,"Releasing Graph Node memory"));
-		SGLFree(psLocalNodes);
+		psWorkspaces[0] = NewWorkspace();
 	}
 
-	pcWorkspace = NULL;
-	psLocalRefs = NULL;
-	psLocalNodes = NULL;
+	if (!psWorkspaces[0])
+	{
+		return (FALSE);
+	}
+
+	return (TRUE);
 }
 
-static INLINE PTRIANGLE_REFERENCE NewTriangleReference( void )
+void FinalizeTransortMemory( void )
 {
-    PTRIANGLE_REFERENCE psTriRef;
+	int k;
 
-	if (pcWorkspacePtr > (pcWorkspace + uWorkspaceStart))
+	for (k = 0; k < SGL_MAX_THREADS; k++)
 	{
-		#if 0
- 		PVROSPrintf("NewTriangleReference: ws=%08X, ptr=%08x, ws+limit=%08X\n",
-					 pcWorkspace, pcWorkspacePtr,(pcWorkspace + uWorkspaceStart));
-		#endif
-		return NULL;
+		if (psWorkspaces[k])
+		{				  
+			DPF((DBG_MESSAGE,"Releasing Transorting Workspace memory"));
+			FreeWorkspace(psWorkspaces[k]);
+			psWorkspaces[k] = NULL;
+		}
+	}
+}
+
+/*
+	Called at the start of each frame's output. Makes sure there are up to
+	nWorkspaces workspaces and throws away the last frame's passes.
+	Returns how many workspaces there are, at least 1.
+*/
+int PrepareTransortWorkspaces( int nWorkspaces )
+{
+	int k;
+
+	for (k = 0; k < SGL_MAX_THREADS; k++)
+	{
+		if (!psWorkspaces[k] && (k < nWorkspaces))
+		{
+			psWorkspaces[k] = NewWorkspace();
+
+			if (!psWorkspaces[k])
+			{
+				DPF((DBG_WARNING,"PrepareTransortWorkspaces: out of memory, using %d",k));
+			}
+		}
+
+		if (!psWorkspaces[k])
+		{
+			break;
+		}
+
+		psWorkspaces[k]->uPassWords = 0;
 	}
 
-    psTriRef = (PTRIANGLE_REFERENCE)pcWorkspacePtr;
-    pcWorkspacePtr += sizeof( TRIANGLE_REFERENCE );
+	return ((k < nWorkspaces) ? k : nWorkspaces);
+}
 
-    return psTriRef;
+static INLINE PTRIANGLE_REFERENCE NewTriangleReference( PSORT_WORKSPACE psWs )
+{
+	if (psWs->uRefBlockUsed == psWs->psRefBlock->uNumRefs)
+	{
+		/* Move on to the next block, adding one if this is the last */
+		if (psWs->psRefBlock->psNext == NULL)
+		{
+			if (!NewRefBlock( psWs, psWs->psRefBlock, psWs->psRefBlock->uNumRefs * 2 ))
+			{
+				DPF((DBG_WARNING,"NewTriangleReference: out of memory"));
+				return NULL;
+			}
+		}
+
+		psWs->psRefBlock = psWs->psRefBlock->psNext;
+		psWs->uRefBlockUsed = 0;
+	}
+
+	return &psWs->psRefBlock->sRefs[psWs->uRefBlockUsed++];
 }
 
 
 /*
     Builds the new display DAG
 	This is the function to call to get it all going -- it builds the graph
-	It uses the global psItris array as the input array, and builds the graph inside
-	the global pcWorkspace memory. For display, or generation of object lists, we then
+	It copies the region's triangles into the workspace, and builds the graph inside
+	the workspace's blocks of graph edges. For display, or generation of object lists, we then
 	call Traverse, which ouputs all the passes individually.
 */
 
-void DoTheStuff( sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT *prTriangleIndicesList )
+static void DoTheStuff( PSORT_WORKSPACE psWs, sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT pTriangleIndicesList )
 {
     sgl_uint32 uCount,i,j=0;
-	PTRANSTRIINDEX_STRUCT pTriangleIndicesList = *prTriangleIndicesList;
 
     /* Reset the workspace */
-    pcWorkspacePtr = pcWorkspace;
-	g_uPasses = 0;
+    psWs->psRefBlock = psWs->psRefBlocks;
+	psWs->uRefBlockUsed = 0;
+	psWs->uPasses = 0;
 
 #if DEBUG
 	g_uInter  = 0;
@@ -358,22 +511,24 @@ void DoTheStuff( sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT *prTriangleIndicesList
 		for(i = 0; i<uCount; i++)
 		{
 			PTRANSTRI_STRUCT	psTriangle;
-			psTriangle = &gpTransTris[ pTriangleIndicesList->usIndex[i] ];
+			psTriangle = &psWs->sTris[j];
+
+			*psTriangle = gpTransTris[ pTriangleIndicesList->usIndex[i] ];
 
 		    psTriangle->psChildren = NULL;
 		    psTriangle->usNumLocks = 0;
 						
-			ppsTriNodePtrs[j] = psTriangle;
-			psTriNodes[j++]   = psTriangle;		
+			psWs->ppsTriNodePtrs[j] = psTriangle;
+			psWs->psTriNodes[j++]   = psTriangle;		
 		}
 		uCount = NUM_INDICES_IN_BLOCK;
 		pTriangleIndicesList = pTriangleIndicesList->pNext;
 	}														   
 
 	/* Space partitioning stuff */
-	Intersect( ppsTriNodePtrs, ppsTriNodePtrs + uPolys, &ppsTriNodePtrs[NUM_PPSTRINODEPTRS - 1], 1, uPolys, 0 );	
+	Intersect( psWs, psWs->ppsTriNodePtrs, psWs->ppsTriNodePtrs + uPolys, &psWs->ppsTriNodePtrs[NUM_PPSTRINODEPTRS - 1], 1, uPolys, 0 );	
 
-	g_usCellCount++;
+	psWs->usCellCount++;
 }
 
 /*
@@ -533,11 +688,11 @@ static sgl_uint32 Overlaps( PTRANSTRI_STRUCT psTriA, PTRANSTRI_STRUCT psTriB, fl
 /*
 	Adds an edge to the graph
 */
-static INLINE void AddRef( PTRANSTRI_STRUCT psParent, PTRANSTRI_STRUCT psChild )
+static INLINE void AddRef( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT psParent, PTRANSTRI_STRUCT psChild )
 {	
 	PTRIANGLE_REFERENCE psTriRef;
 
-    psTriRef = NewTriangleReference();
+    psTriRef = NewTriangleReference( psWs );
 
 	if (psTriRef)
 	{
@@ -624,8 +779,9 @@ void DFSVertex( PTRANSTRI_STRUCT psTriNode )
 	This breaks all cycles in the graph by doing a depth-first traversal
 	I'll probably recode this to use an explicit stack
 */
-sgl_uint32 DoDFS( sgl_uint32 uPolys )
+sgl_uint32 DoDFS( PSORT_WORKSPACE psWs, sgl_uint32 uPolys )
 {
+    PTRANSTRI_STRUCT *psTriNodes = psWs->psTriNodes;
     sgl_uint32 i;
 	sgl_uint16 usMaxDepth;
 	usMaxDepth = 0;
@@ -646,44 +802,64 @@ sgl_uint32 DoDFS( sgl_uint32 uPolys )
 }
 
 /*
-	This function takes start and end indices into the global ppsDisplatList[]
-	array. It then displays all of them, but you would probably
-	replace this with a function to generate lists of display objects (though that
-	could be done directly during Traverse)
+	This function takes start and end indices into the workspace's ppsDisplayList[]
+	array, and records them as the next pass. The passes are only output, by
+	OutputTransPasses, once the region's other passes are known. Returns the
+	planes the pass will take.
 */
 
-sgl_uint32* DoDisplay( sgl_uint32 uStartIndex, sgl_uint32 uEndIndex, sgl_uint32* pAddr, sgl_uint32 *rpPlanes )
+static sgl_uint32 RecordPass( PSORT_WORKSPACE psWs, sgl_uint32 uStartIndex, sgl_uint32 uEndIndex )
 {
-    sgl_uint32 i;
-	sgl_uint32 tmp0;
-    PTRANSTRI_STRUCT psItri;
+    sgl_uint32 i, uNeeded, uPlanes;
+	sgl_uint32 *puWord;
 
-	/* Do we have enough room for the pass to be inserted.
-	 * If not don't put it in.
-	 */
-	if (*rpPlanes < SAFETY_MARGIN_TRANS)
+	uNeeded = psWs->uPassWords + 1 + (uEndIndex - uStartIndex);
+
+	if (uNeeded > psWs->uMaxPassWords)
 	{
-		IW( pAddr++, 0, DummyTransData);
-		*rpPlanes += NUM_TRANS_PASS_START_PLANES;
+		sgl_uint32 uMax = psWs->uMaxPassWords ? psWs->uMaxPassWords * 2 : MAX_NUM_REGION_TRIS * 4;
+		sgl_uint32 *puWords;
 
-	    for(i = uStartIndex; i < uEndIndex; i++)
-	    {	
-	        psItri = ppsDisplayList[i];
+		if (uMax < uNeeded)
+		{
+			uMax = uNeeded;
+		}
 
-			tmp0 = psItri->uObjPtr;
-			IW( pAddr++, 0, tmp0);
-			*rpPlanes += ((tmp0 >> OBJ_PCOUNT_SHIFT) & OBJ_PCOUNT_MASK);
-	    }
+		puWords = (sgl_uint32 *)SGLRealloc( psWs->puPassWords, uMax * sizeof( sgl_uint32 ) );
 
-		IW( pAddr++, 0, DummyTransFlushData);
-		*rpPlanes += FLUSH_PLANE;
+		if (!puWords)
+		{
+			DPF((DBG_WARNING,"RecordPass: out of memory, pass dropped"));
+			return (0);
+		}
+
+		psWs->puPassWords = puWords;
+		psWs->uMaxPassWords = uMax;
 	}
 
-	return (pAddr);
+	puWord = psWs->puPassWords + psWs->uPassWords;
+
+	*puWord++ = uEndIndex - uStartIndex;
+
+	uPlanes = NUM_TRANS_PASS_START_PLANES + FLUSH_PLANE;
+
+    for(i = uStartIndex; i < uEndIndex; i++)
+    {	
+		sgl_uint32 uObjPtr = psWs->ppsDisplayList[i]->uObjPtr;
+
+		*puWord++ = uObjPtr;
+		uPlanes += (uObjPtr >> OBJ_PCOUNT_SHIFT) & OBJ_PCOUNT_MASK;
+    }
+
+	psWs->uPassWords = uNeeded;
+
+	return (uPlanes);
 }
 
-sgl_uint32* DisplayRemainingTriangles( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes )
+static sgl_uint32 DisplayRemainingTriangles( PSORT_WORKSPACE psWs, sgl_uint32 uPolys )
 {
+    PTRANSTRI_STRUCT *psTriNodes = psWs->psTriNodes;
+    PTRANSTRI_STRUCT *ppsDisplayList = psWs->ppsDisplayList;
     sgl_uint32 i, uEnd;
     uEnd = 0;
 
@@ -696,22 +872,20 @@ sgl_uint32* DisplayRemainingTriangles( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl
         }
     }
 
-    pAddr = DoDisplay( 0, uEnd, pAddr, rpPlanes);
-
-	return(pAddr);
+    return (RecordPass( psWs, 0, uEnd ));
 }
 
-sgl_uint32 FixForVignetting( sgl_uint32 uPolys )
+static sgl_uint32 FixForVignetting( PSORT_WORKSPACE psWs, sgl_uint32 uPolys )
 {
 	sgl_uint32 uTransPassPlanes;
 	
     /* Initial pass -- find and remove all cycles */	
-    uNumPasses = DoDFS( uPolys );
+    psWs->uNumPasses = DoDFS( psWs, uPolys );
 
-	if (uNumPasses > nMaxPassCount) uNumPasses = nMaxPassCount;
+	if (psWs->uNumPasses > nMaxPassCount) psWs->uNumPasses = nMaxPassCount;
 
 	uTransPassPlanes = (uPolys * 4 /* planes in a triangle */) + 
-					   (uNumPasses * (NUM_TRANS_PASS_START_PLANES + FLUSH_PLANE));
+					   (psWs->uNumPasses * (NUM_TRANS_PASS_START_PLANES + FLUSH_PLANE));
 
 	/* Return the number of planes required for this new sorting.
 	 */
@@ -720,13 +894,22 @@ sgl_uint32 FixForVignetting( sgl_uint32 uPolys )
 
 
 /*
-	Traverse -- this displays all the triangles in the form of sorted passes
+	Traverse -- this records all the triangles in the form of sorted passes
 	It could be simply modified to add triangles to object lists
+
+	OutputTransPasses only puts a pass in while the region is under
+	SAFETY_MARGIN_TRANS planes, and by then the region has at least its
+	padded opaque pass and flush. Once the passes recorded so far would
+	take even that over the margin, none of the rest can be output, so
+	they aren't recorded.
 */
 
-sgl_uint32* Traverse( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes )
+static void Traverse( PSORT_WORKSPACE psWs, sgl_uint32 uPolys )
 {
+    PTRANSTRI_STRUCT *psTriNodes = psWs->psTriNodes;
+    PTRANSTRI_STRUCT *ppsDisplayList = psWs->ppsDisplayList;
     sgl_uint32 uStart, uEnd, uNewStart, uNewEnd, i;
+	sgl_uint32 uRoomPlanes = REGION_PLANE_MIN + FLUSH_PLANE;
     PTRIANGLE_REFERENCE psChild;
 
     /* Second pass -- collect all those triangles that are unlocked */
@@ -827,17 +1010,20 @@ sgl_uint32* Traverse( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes
 #endif
     
 	/* Pre decrement, taking into account the final pass */
-	uNumPasses--; 
+	psWs->uNumPasses--; 
     
     /* Third and subsequent passes -- go through the display list unlocking children */
-    while (uStart != uEnd)
+    while ((uStart != uEnd) && (uRoomPlanes < SAFETY_MARGIN_TRANS))
     {	
 		/* Generate a pass now, thank you very much */
-	    pAddr = DoDisplay( uStart, uEnd, pAddr, rpPlanes);
+	    uRoomPlanes += RecordPass( psWs, uStart, uEnd );
 
-   		if (++g_uPasses == uNumPasses)		
+   		if (++psWs->uPasses == psWs->uNumPasses)		
 		{			
-			pAddr = DisplayRemainingTriangles( uPolys, pAddr, rpPlanes);
+			if (uRoomPlanes < SAFETY_MARGIN_TRANS)
+			{
+				DisplayRemainingTriangles( psWs, uPolys );
+			}
 			break;
 		}
 
@@ -886,7 +1072,7 @@ sgl_uint32* Traverse( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes
 		if (fp)
 		{
 			#if DEBUG
-				PVROSPrintf("Writing vertex data to %s (took %d passes)\n",szOutputFileName,g_uPasses+1);
+				PVROSPrintf("Writing vertex data to %s (took %d passes)\n",szOutputFileName,psWs->uPasses+1);
 			#else
 				PVROSPrintf("Writing vertex data to %s\n",szOutputFileName);
 			#endif
@@ -907,10 +1093,9 @@ sgl_uint32* Traverse( sgl_uint32 uPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes
 #if 0
 	if(uPolys > 12) 
 	{
-		PVROSPrintf("%d: %d, ",uPolys,g_uPasses +1 );
+		PVROSPrintf("%d: %d, ",uPolys,psWs->uPasses +1 );
 	}
 #endif
-	return (pAddr);
 }
 
 /*****************************************************************************
@@ -1023,14 +1208,96 @@ static INLINE void MarkDescendents( PLOCAL_NODE psLocalNode, PLOCAL_NODE psMarke
 	}
 }
 
-static void NewAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
+/*
+	Sweep and prune over the local nodes' bounding boxes. The nodes are
+	sorted on their left edge and swept left to right, keeping those whose
+	right edge the sweep hasn't passed yet. Each pair that also overlaps in
+	y goes on the candidate list of its higher numbered node, highest first,
+	which is the order NewAllIntersects has always visited them in.
+	Returns FALSE if there are more pairs than sPairs holds.
+*/
+static sgl_bool SweepBounds( PSORT_WORKSPACE psWs, unsigned uNumItris )
+{
+	LOCAL_NODE *psLocalNodes = psWs->sLocalNodes;
+	int *pnSweep = psWs->nSweep;
+	int *pnActive = psWs->nActive;
+	unsigned i, k, a, uActive, uKeep, uPairs;
+
+	/* Insertion sort on the left edge; the lists here are short */
+	for(i = 0; i < uNumItris; i++)
+	{
+		psWs->psCandidates[i] = NULL;
+
+		for(k = i; (k > 0) && (psLocalNodes[pnSweep[k - 1]].fMin[X] > psLocalNodes[i].fMin[X]); k--)
+		{
+			pnSweep[k] = pnSweep[k - 1];
+		}
+		pnSweep[k] = i;
+	}
+
+	uActive = 0;
+	uPairs = 0;
+
+	for(k = 0; k < uNumItris; k++)
+	{
+		int n = pnSweep[k];
+		PLOCAL_NODE psN = &psLocalNodes[n];
+
+		for(a = 0, uKeep = 0; a < uActive; a++)
+		{
+			int m = pnActive[a];
+			PLOCAL_NODE psM = &psLocalNodes[m];
+
+			if (psM->fMax[X] < psN->fMin[X])
+			{
+				/* Nothing further right can reach it either */
+				continue;
+			}
+
+			pnActive[uKeep++] = m;
+
+			if ((psM->fMin[Y] <= psN->fMax[Y]) && (psN->fMin[Y] <= psM->fMax[Y]))
+			{
+				int nHi = (n > m) ? n : m;
+				int nLo = (n > m) ? m : n;
+				PBROAD_PAIR *ppsLink = &psWs->psCandidates[nHi];
+
+				if (uPairs == LOCAL_REFS)
+				{
+					return (FALSE);
+				}
+
+				while ((*ppsLink != NULL) && ((*ppsLink)->nOther > nLo))
+				{
+					ppsLink = &(*ppsLink)->psNext;
+				}
+
+				psWs->sPairs[uPairs].nOther = nLo;
+				psWs->sPairs[uPairs].psNext = *ppsLink;
+				*ppsLink = &psWs->sPairs[uPairs++];
+			}
+		}
+
+		pnActive[uKeep] = n;
+		uActive = uKeep + 1;
+	}
+
+	return (TRUE);
+}
+
+static void NewAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 {
+	LOCAL_REF *psLocalRefs = psWs->sLocalRefs;
+	LOCAL_NODE *psLocalNodes = psWs->sLocalNodes;
+	HASH_STRUCT *Hash = psWs->Hash;
 	int i, j;
 	unsigned h;
 	unsigned uLocalRefInd;
 	float fPoint[2];
 	sgl_uint16 uResult;
 	sgl_uint32 uKey;
+	sgl_bool bSwept;
+	PBROAD_PAIR psPair;
 
 	/*
 		First create the local nodes
@@ -1038,23 +1305,65 @@ static void NewAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris
 	uLocalRefInd = 0;
 	for(i = 0; i < uNumItris; i++)
 	{
-		psLocalNodes[i].psTriNode = ppsTriNodes[i];		/* Probably can be taken out */
+		PTRANSTRI_STRUCT psItri = ppsTriNodes[i];
+
+		psLocalNodes[i].psTriNode = psItri;		/* Probably can be taken out */
 		psLocalNodes[i].psMarkedBy = NULL;
 		psLocalNodes[i].psParents = NULL;
 		psLocalNodes[i].psChildren = NULL;
+
+		/* Bounds for rejecting pairs before the full overlap test */
+		for(h = 0; h < 2; h++)
+		{
+			float fMin = psItri->fVerts[0][h];
+			float fMax = fMin;
+
+			if (psItri->fVerts[1][h] < fMin) fMin = psItri->fVerts[1][h];
+			if (psItri->fVerts[1][h] > fMax) fMax = psItri->fVerts[1][h];
+			if (psItri->fVerts[2][h] < fMin) fMin = psItri->fVerts[2][h];
+			if (psItri->fVerts[2][h] > fMax) fMax = psItri->fVerts[2][h];
+
+			psLocalNodes[i].fMin[h] = fMin - BOUNDS_MARGIN;
+			psLocalNodes[i].fMax[h] = fMax + BOUNDS_MARGIN;
+		}
 	}
 
+	/*
+		Only pairs whose bounds overlap need looking at. The pairs the sweep
+		leaves out are ones the bounds test below finds Disjoint, and a
+		Disjoint pair adds no edges, so the graph is the same as testing
+		every pair. If the sweep runs out of room every pair is tried.
+	*/
+	bSwept = SweepBounds( psWs, uNumItris );
+
 	for(i = 0; i < uNumItris; i++)
 	{
-		for(j = i - 1; j >= 0; j--)
+		psPair = psWs->psCandidates[i];
+		j = i;
+
+		for(;;)
 		{
+			if (bSwept)
+			{
+				if (psPair == NULL)
+				{
+					break;
+				}
+				j = psPair->nOther;
+				psPair = psPair->psNext;
+			}
+			else if (--j < 0)
+			{
+				break;
+			}
+
 		    h = ((unsigned)ppsTriNodes[i] ^ ((unsigned)ppsTriNodes[j] >> 2)) % HASH_SIZE;
 
 			if (psLocalNodes[j].psMarkedBy != &psLocalNodes[i])
 			{
 	            if (
 	            	 (
-	            	  (Hash[h].p[0] == ppsTriNodes[i] && Hash[h].p[1] == ppsTriNodes[j] && Hash[h].usRef == g_usCellCount) ||
+	            	  (Hash[h].p[0] == ppsTriNodes[i] && Hash[h].p[1] == ppsTriNodes[j] && Hash[h].usRef == psWs->usCellCount) ||
 	                  (Hash[h].p[0] == ppsTriNodes[j] && Hash[h].p[1] == ppsTriNodes[i])
 	                  )
 	                )
@@ -1062,6 +1371,14 @@ static void NewAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris
 	            {
 					uResult = Hash[h].uResult;
 				}
+				else if ((psLocalNodes[i].fMin[0] > psLocalNodes[j].fMax[0]) ||
+						 (psLocalNodes[j].fMin[0] > psLocalNodes[i].fMax[0]) ||
+						 (psLocalNodes[i].fMin[1] > psLocalNodes[j].fMax[1]) ||
+						 (psLocalNodes[j].fMin[1] > psLocalNodes[i].fMax[1]))
+				{
+					/* Too far apart to overlap */
+					uResult = Disjoint;
+				}
 				else if (Overlaps( ppsTriNodes[i], ppsTriNodes[j], fPoint ))
 				{
 					uResult = isAinfrontofB( ppsTriNodes[i], ppsTriNodes[j], fPoint ) ? AinfrontofB : BinfrontofA;
@@ -1107,7 +1424,7 @@ static void NewAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris
 	            Hash[h].p[0] = ppsTriNodes[i];
 	            Hash[h].p[1] = ppsTriNodes[j];
 				Hash[h].uResult = uResult;
-				Hash[h].usRef = g_usCellCount;
+				Hash[h].usRef = psWs->usCellCount;
 			}
 		}
 	}
@@ -1122,7 +1439,7 @@ static void NewAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris
 
 		while (psLocalRef != NULL)
 		{
-			AddRef( ppsTriNodes[i], ppsTriNodes[psLocalRef->psLocalNode - psLocalNodes] );
+			AddRef( psWs, ppsTriNodes[i], ppsTriNodes[psLocalRef->psLocalNode - psLocalNodes] );
 			psLocalRef = psLocalRef->psNext;
 		}
 	}
@@ -1297,7 +1614,7 @@ static INLINE void ChooseSplitLine( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNum
     lowest (ascending) element in the list on entry
 */
 
-static void Intersect( PTRANSTRI_STRUCT *ppsTriNodes, PTRANSTRI_STRUCT *ppsLeftStack, PTRANSTRI_STRUCT *ppsRightStack, unsigned bIsAscending, unsigned uNumTris, unsigned uLevel )
+static void Intersect( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, PTRANSTRI_STRUCT *ppsLeftStack, PTRANSTRI_STRUCT *ppsRightStack, unsigned bIsAscending, unsigned uNumTris, unsigned uLevel )
 {
     unsigned uNumLeft, uNumRight, uNumShared;
     float fLine[3];
@@ -1311,21 +1628,21 @@ static void Intersect( PTRANSTRI_STRUCT *ppsTriNodes, PTRANSTRI_STRUCT *ppsLeftS
 
     if (uNumLeft == (uNumLeft + uNumRight - uNumShared))
     {
-        NewerFoulAllIntersects( ppsLeftStack - uNumLeft, uNumLeft );
+        NewerFoulAllIntersects( psWs, ppsLeftStack - uNumLeft, uNumLeft );
     }
     else if (uNumRight == (uNumLeft + uNumRight - uNumShared))
     {
-        NewerFoulAllIntersects( ppsRightStack + 1, uNumRight );
+        NewerFoulAllIntersects( psWs, ppsRightStack + 1, uNumRight );
     }
     else if ((uNumShared * 5) > uNumLeft + uNumRight || uNumLeft == 0 || uNumRight == 0)
     {
-    	NewerFoulAllIntersects( ppsRightStack + 1, uNumRight );
-    	NewerFoulAllIntersects( ppsLeftStack - uNumLeft, uNumLeft );
+    	NewerFoulAllIntersects( psWs, ppsRightStack + 1, uNumRight );
+    	NewerFoulAllIntersects( psWs, ppsLeftStack - uNumLeft, uNumLeft );
     }
     else
     {
-    	if (uNumLeft > 1) Intersect( ppsLeftStack - uNumLeft, ppsLeftStack, ppsRightStack, 1, uNumLeft, uLevel + 1 );
-    	if (uNumRight > 1) Intersect( ppsRightStack + uNumRight, ppsLeftStack, ppsRightStack, 0, uNumRight, uLevel + 1 );
+    	if (uNumLeft > 1) Intersect( psWs, ppsLeftStack - uNumLeft, ppsLeftStack, ppsRightStack, 1, uNumLeft, uLevel + 1 );
+    	if (uNumRight > 1) Intersect( psWs, ppsRightStack + uNumRight, ppsLeftStack, ppsRightStack, 0, uNumRight, uLevel + 1 );
     }
 }
 
@@ -1495,7 +1812,7 @@ static void SortTriNodes( PTRANSTRI_STRUCT *arr, sgl_uint32 uNumItris )
 #endif
 
 
-void CreatePasses( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
+void CreatePasses( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 {
 	unsigned i, j, k, t;
 	unsigned uSetSize, uEnd;
@@ -1539,7 +1856,7 @@ void CreatePasses( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 
 			for(k = i; k < t; k++)
 			{
-				AddRef( ppsTriNodes[j], ppsTriNodes[k] );
+				AddRef( psWs, ppsTriNodes[j], ppsTriNodes[k] );
 			}
 		}
 		j = i;
@@ -1551,14 +1868,14 @@ void CreatePasses( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 	{
 		for(k = uEnd; k < uNumItris; k++)
 		{
-			AddRef( ppsTriNodes[uEnd - 1], ppsTriNodes[k] );
+			AddRef( psWs, ppsTriNodes[uEnd - 1], ppsTriNodes[k] );
 		}
 	}
 
 	/* And do these top few properly */
 	if (uNumItris - uEnd > 0)
 	{
-		NewAllIntersects( &ppsTriNodes[uEnd], uNumItris - uEnd );
+		NewAllIntersects( psWs, &ppsTriNodes[uEnd], uNumItris - uEnd );
 	}
 
 }
@@ -1568,7 +1885,7 @@ void CreatePasses( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 	In this routine we do a quick sort on the z-coordinates
 */
 #if FOUL_OR_NEWFOUL_ALLINTERSECTS
-static void FoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, sgl_uint32 uNumItris )
+static void FoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, sgl_uint32 uNumItris )
 {
 
 	SortTriNodes( ppsTriNodes, uNumItris );
@@ -1579,16 +1896,16 @@ static void FoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, sgl_uint32 uNumItr
 
 		for(i = 0; i < uNumItris - 1; i++)
 		{
-			AddRef( ppsTriNodes[i], ppsTriNodes[i + 1] );
+			AddRef( psWs, ppsTriNodes[i], ppsTriNodes[i + 1] );
 		}
 	}
 	else
 	{
-		NewAllIntersects( ppsTriNodes, uNumItris );
+		NewAllIntersects( psWs, ppsTriNodes, uNumItris );
 	}
 }
 
-static void NewFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
+static void NewFoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 {
 	unsigned i, j, k, t;
 	unsigned uSetStartIndex;
@@ -1620,7 +1937,7 @@ static void NewFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumIt
 					{
 						for(t = uSetStartIndex; t < i; t++)
 						{
-							AddRef( ppsTriNodes[k], ppsTriNodes[t] );
+							AddRef( psWs, ppsTriNodes[k], ppsTriNodes[t] );
 						}
 					}
 					uLastSetStartIndex = uSetStartIndex;
@@ -1634,7 +1951,7 @@ static void NewFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumIt
 		{
 			for(t = uSetStartIndex; t < i; t++)
 			{
-				AddRef( ppsTriNodes[k], ppsTriNodes[t] );
+				AddRef( psWs, ppsTriNodes[k], ppsTriNodes[t] );
 			}
 		}
 
@@ -1642,14 +1959,80 @@ static void NewFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumIt
 	else
 	{
 		SortTriNodes( ppsTriNodes, uNumItris );
-		NewAllIntersects( ppsTriNodes, uNumItris );
+		NewAllIntersects( psWs, ppsTriNodes, uNumItris );
 	}
 }
 #endif /*FOUL_OR_NEWFOUL_ALLINTERSECTS*/
 
-static void NewerFoulAllIntersects( PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
+static void NewerFoulAllIntersects( PSORT_WORKSPACE psWs, PTRANSTRI_STRUCT *ppsTriNodes, unsigned uNumItris )
 {
-	CreatePasses( ppsTriNodes, uNumItris );
+	CreatePasses( psWs, ppsTriNodes, uNumItris );
+}
+
+/*
+	Sorts one region's triangles in workspace nWorkspace, which no other
+	thread may be using, and records the passes in psPasses for
+	OutputTransPasses. Regions may be sorted in any order.
+*/
+void SortRegionTransTris( sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT pTriangleIndicesList,
+						  PTRANS_PASSES_STRUCT psPasses, int nWorkspace )
+{
+	PSORT_WORKSPACE psWs = psWorkspaces[nWorkspace];
+
+	/* Create the graph */
+	DoTheStuff( psWs, uPolys, pTriangleIndicesList );
+
+	/* The planes the passes need, for the vignetting fix */
+	psPasses->uSortedPlanes = FixForVignetting( psWs, uPolys );
+
+	/* Record the graph in passes */
+	psPasses->uWorkspace = (sgl_uint32) nWorkspace;
+	psPasses->uStart = psWs->uPassWords;
+
+	Traverse( psWs, uPolys );
+
+	psPasses->uWords = psWs->uPassWords - psPasses->uStart;
+}
+
+/*
+	Outputs the passes SortRegionTransTris recorded for a region. A pass
+	is only put in if there is room for it.
+*/
+sgl_uint32* OutputTransPasses( const TRANS_PASSES_STRUCT *psPasses, sgl_uint32* pAddr, sgl_uint32 *rpPlanes )
+{
+	const sgl_uint32 *puWord, *puEnd;
+	sgl_uint32 i, uCount, tmp0;
+
+	puWord = psWorkspaces[psPasses->uWorkspace]->puPassWords + psPasses->uStart;
+	puEnd = puWord + psPasses->uWords;
+
+	while (puWord != puEnd)
+	{
+		uCount = *puWord++;
+
+		/* Do we have enough room for the pass to be inserted.
+		 * If not don't put it in.
+		 */
+		if (*rpPlanes < SAFETY_MARGIN_TRANS)
+		{
+			IW( pAddr++, 0, DummyTransData);
+			*rpPlanes += NUM_TRANS_PASS_START_PLANES;
+
+		    for(i = 0; i < uCount; i++)
+		    {	
+				tmp0 = puWord[i];
+				IW( pAddr++, 0, tmp0);
+				*rpPlanes += ((tmp0 >> OBJ_PCOUNT_SHIFT) & OBJ_PCOUNT_MASK);
+		    }
+
+			IW( pAddr++, 0, DummyTransFlushData);
+			*rpPlanes += FLUSH_PLANE;
+		}
+
+		puWord += uCount;
+	}
+
+	return (pAddr);
 }
 
 #endif /* DAG_TRANS_SORTING */
@@ -104,13 +104,24 @@ typedef struct _transtriindex_struct
 } TRANSTRIINDEX_STRUCT, *PTRANSTRIINDEX_STRUCT;
 
 
+/* A region's sorted passes, kept until the region is output */
+typedef struct _trans_passes_struct
+{
+	sgl_uint32	uWorkspace;		/* Workspace the passes were recorded in */
+	sgl_uint32	uStart;			/* Offset of the first word in it */
+	sgl_uint32	uWords;			/* For each pass, a count then the object pointers */
+	sgl_uint32	uSortedPlanes;	/* Planes needed for all the passes */
+} TRANS_PASSES_STRUCT, *PTRANS_PASSES_STRUCT;
+
+
 /* Prototypes */
-void DoTheStuff( sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT *prTriangleIndicesList );
-sgl_uint32* Traverse( sgl_uint32 nPolys, sgl_uint32* pAddr, sgl_uint32 *rpPlanes );
-sgl_uint32 FixForVignetting( sgl_uint32 uPolys );
+void SortRegionTransTris( sgl_uint32 uPolys, PTRANSTRIINDEX_STRUCT pTriangleIndicesList,
+						  PTRANS_PASSES_STRUCT psPasses, int nWorkspace );
+sgl_uint32* OutputTransPasses( const TRANS_PASSES_STRUCT *psPasses, sgl_uint32* pAddr, sgl_uint32 *rpPlanes );
 
 sgl_bool InitialiseTransortMemory( void );
 void FinalizeTransortMemory( void );
+int PrepareTransortWorkspaces( int nWorkspaces );
 
 
 extern void AddRegionD3DTransTris( PITRI *rpTri, int nXYDataInc,
@@ -91,6 +91,194 @@ extern int _ProcessTriCoreLite ( PPIR pAddfn, sgl_uint32 NewObject, sgl_int32 nN
 #define ProcessTriCoreLite _ProcessTriCoreLite
 #else
 		   
+#if !CHUNKING
+
+/*
+// Lane width of the vector setup kernel, 1 if there is none; 0 until the
+// first call picks one.
+*/
+static int			nSetupLanes = 0;
+static TRISETUPFN	pfnTriSetup = NULL;
+
+/**************************************************************************
+ * Function Name  : ProcessTriLanes
+ * Inputs         : PPIR pAddfn, sgl_uint32 uDefaultType,
+ *					sgl_uint32 uOrBackType, sgl_uint32 *puDoneFirst 
+ * Outputs        : None
+ * Returns        : Number of triangles processed.
+ * Global Used    : gPDC, gpPDC
+ * Description    : The body of ProcessTriCoreLite done nSetupLanes at a
+ *					time. The kernel does the geometry for a whole group;
+ *					the lanes are then taken in order to do the rest, so
+ *					the buffer fills exactly as the one at a time loop
+ *					fills it. Faces are only used up as their lanes are
+ *					taken, so when the buffer fills part way through a
+ *					group, the rest is set up again on the next call.
+ *
+ **************************************************************************/
+
+static int ProcessTriLanes ( PPIR pAddfn, sgl_uint32 uDefaultType,
+							 sgl_uint32 uOrBackType, sgl_uint32 *puDoneFirst )
+{
+	PITRI			pTri = gpTri;
+	TRISETUPLANES	Lanes;
+	TRISETUPCONTEXT	Ctx;
+	int				nFaceSize;
+	sgl_bool		bD3DFaces;
+
+	bD3DFaces = (gPDC.Context.u32Flags & SGLTT_FACESIND3DFORMAT) != 0;
+	nFaceSize = bD3DFaces ? sizeof (SGLD3DFACE) : 3 * sizeof (int);
+
+	Ctx.fAddToXY = fAddToXY;
+	Ctx.fMinInvZ = fMinInvZ;
+	Ctx.ShiftRegX = gpPDC->ShiftRegX;
+	Ctx.bCullBackfacing = gpPDC->Context.bCullBackfacing;
+	Ctx.bDoClipping = gpPDC->Context.bDoClipping;
+	Ctx.FirstXRegion = gpPDC->Context.FirstXRegion;
+	Ctx.FirstYRegion = gpPDC->Context.FirstYRegion;
+	Ctx.LastXRegion = gpPDC->Context.LastXRegion;
+	Ctx.LastYRegion = gpPDC->Context.LastYRegion;
+
+	while ( gpPDC->nInputTriangles )
+	{
+		int nLanes = MIN (gpPDC->nInputTriangles, nSetupLanes);
+		int k;
+
+		/*
+		// Fetch the vertices of the next group, repeating the last face
+		// to fill any spare lanes.
+		*/
+		for (k = 0; k < nSetupLanes; k++)
+		{
+			const int *pnFaces = (const int *) ((char *) gpPDC->pFace +
+												MIN (k, nLanes - 1) * nFaceSize);
+
+			if (bD3DFaces)
+			{
+				Lanes.pV[0][k] = gPDC.pVertices + (pnFaces[0] & 0xFFFF);
+				Lanes.pV[1][k] = gPDC.pVertices + (pnFaces[0] >> 16);
+				Lanes.pV[2][k] = gPDC.pVertices + (pnFaces[1] & 0xFFFF);
+			}
+			else
+			{
+				Lanes.pV[0][k] = gPDC.pVertices + pnFaces[0];
+				Lanes.pV[1][k] = gPDC.pVertices + pnFaces[1];
+				Lanes.pV[2][k] = gPDC.pVertices + pnFaces[2];
+			}
+		}
+
+		pfnTriSetup (&Lanes, &Ctx);
+
+		for (k = 0; k < nLanes; k++)
+		{
+			sgl_uint32	uLane = 1 << k;
+			sgl_uint32	uCurrentType = uDefaultType;
+			
+			/* Decrement nInputTriangles to zero not -1 */
+			gpPDC->nInputTriangles--;
+
+			gpPDC->pFace = (void *) ((char *) gpPDC->pFace + nFaceSize);
+
+			if (!(Lanes.uFaced & uLane))
+			{
+				continue;
+			}
+
+			pTri->TSPControlWord = 	gPDC.TSPControlWord;
+			pTri->BaseColour = 		Lanes.pV[0][k]->u32Colour;
+
+			gpPDC->pV1 = (PSGLVERTEX) Lanes.pV[1][k];
+
+			if (Lanes.uFlipped & uLane)
+			{
+				gpPDC->pV0 = (PSGLVERTEX) Lanes.pV[2][k];
+				gpPDC->pV2 = (PSGLVERTEX) Lanes.pV[0][k];
+
+				uCurrentType |= uOrBackType;
+			}
+			else
+			{
+				gpPDC->pV0 = (PSGLVERTEX) Lanes.pV[0][k];
+				gpPDC->pV2 = (PSGLVERTEX) Lanes.pV[2][k];
+			}
+
+			if (gpPDC->Context.u32Flags & SGLTT_DISABLEZBUFFER)
+			{
+				float BogusZIncremented = gfBogusInvZ+ (float) BOGUSINVZ_INCREMENT;
+
+				pTri->fZ[0] = pTri->fZ[1] = pTri->fZ[2] = gfBogusInvZ;
+
+				gfBogusInvZ = BogusZIncremented;
+			}
+			else
+			{
+				pTri->fZ[0] = Lanes.fZ[0][k];
+				pTri->fZ[1] = Lanes.fZ[1][k];
+				pTri->fZ[2] = Lanes.fZ[2][k];
+			}
+
+			if (!(Lanes.uKept & uLane))
+			{
+				/* Outside the clip regions */
+				continue;
+			}
+
+			pTri->fAdjoint[0][0] = Lanes.fAdjoint[0][0][k];
+			pTri->fAdjoint[0][1] = Lanes.fAdjoint[0][1][k];
+			pTri->fAdjoint[0][2] = Lanes.fAdjoint[0][2][k];
+			pTri->fAdjoint[1][0] = Lanes.fAdjoint[1][0][k];
+			pTri->fAdjoint[1][1] = Lanes.fAdjoint[1][1][k];
+			pTri->fAdjoint[1][2] = Lanes.fAdjoint[1][2][k];
+			pTri->fAdjoint[2][0] = Lanes.fAdjoint[2][0][k];
+			pTri->fAdjoint[2][1] = Lanes.fAdjoint[2][1][k];
+			pTri->fAdjoint[2][2] = Lanes.fAdjoint[2][2][k];
+
+			if (gpPDC->TSPControlWord & MASK_TRANS)
+			{
+				sgl_uint32 uDFIndex = (uCurrentType & 1);
+
+				if (!puDoneFirst[uDFIndex])
+				{
+					uCurrentType |= PACKED_TRANSTYPE_SETMARK;
+					puDoneFirst[uDFIndex] = TRUE;
+				}
+			}
+
+			pTri->f1OverDet = Lanes.f1OverDet[k];
+			pTri->reg.u = ENCODE_OBJXYDATA( uCurrentType, 
+											Lanes.Reg[0][k], Lanes.Reg[1][k],
+											Lanes.Reg[2][k], Lanes.Reg[3][k] );
+
+			if ( pAddfn != NULL )
+			{
+				/* Call the type specific thing here */
+				pAddfn( pTri );
+			}
+							
+			if ( ProcessFlatTexFn != NULL )
+			{
+				/* Texture stuff in line */
+				ProcessFlatTexFn( pTri );
+			}
+				
+			/* Next material structure */
+			gpMatCurrent++;
+							
+			if ( ++pTri == &gpTri[IBUFFERSIZE] )
+			{
+				/* Filled up the buffer! */
+				return (IBUFFERSIZE);
+			}
+		}
+	}
+
+	/* Return number in intermediate buffer this time */
+	return( (int) ( pTri - gpTri ) );
+
+} /* ProcessTriLanes */
+
+#endif /* !CHUNKING */
+
 extern int ProcessTriCoreLite ( PPIR pAddfn, sgl_uint32 NewObject, sgl_int32 nNextTriInc)
 {
 	PITRI	pTri = gpTri;
@@ -154,6 +342,20 @@ extern int ProcessTriCoreLite ( PPIR pAddfn, sgl_uint32 NewObject, sgl_int32 nNe
 		uOrBackType = 0;
 	}
 
+	#if !CHUNKING
+
+		if (nSetupLanes == 0)
+		{
+			nSetupLanes = TriSetupSelect (&pfnTriSetup);
+		}
+
+		if (nSetupLanes > 1)
+		{
+			return (ProcessTriLanes (pAddfn, uDefaultType, uOrBackType, uDoneFirst));
+		}
+
+	#endif
+
 	while ( gpPDC->nInputTriangles )
 	{
 		/*
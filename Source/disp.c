@@ -371,12 +371,9 @@ static FOGHIGHLIGHT eExtraStatus[IBUFFERSIZE];
 **
 **********************************************************************/
 
-void GenerateDepthInfo(PITRI pTri, sgl_uint32 nPolys)
+void GenerateDepthInfo(PITRI pTri, sgl_uint32 nPolys,
+					   TRANS_REGION_DEPTHS_STRUCT *pGDepth)
 {
-	TRANS_REGION_DEPTHS_STRUCT* pGDepth;
-
-	pGDepth = &gDepthInfo[0];	
-
 	for ( ; nPolys; nPolys--, pGDepth++)
 	{
 		/* static variable should init these to zero */
@@ -2566,28 +2563,32 @@ extern void PackISPPolygonCoreClipTested(sgl_uint32 *pPlaneMem, sgl_uint32 nPoly
 **
 ** Hardware: PCX1, PCX2, PCX2_003
 **
+** Lays nTriangles ISP objects out from *rISPPos, moving on to the next
+** Sabre page wherever one would straddle a page limit, and leaves
+** *rISPPos just past the last one. uParts says what to write: planes,
+** region objects, both, or nothing at all to just find the layout.
+** Every caller lays a run out the same way, which is what lets space
+** sized by ReserveISPTri be filled exactly by PackISPTriAt.
 **
-**
+** Objects go to the regions at most IBUFFERSIZE at a time so the depth
+** info fits on the stack, leaving nothing shared between callers that
+** work on separate runs.
 **
 **********************************************************************/
 
-int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement)
+static int PlaceISPTri (PITRI pTri, int nTriangles, sgl_uint32 *rISPPos,
+						sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement,
+						sgl_uint32 uParts)
 {
+	TRANS_REGION_DEPTHS_STRUCT DepthInfo[IBUFFERSIZE];
 	sgl_uint32	ChunkLimit, CurrentPos, DataSize, ChunkSize, nPolysInChunk;
 	int 	nPolys;
 	
-	SGL_TIME_START(PACK_ISPTRI_TIME)
-
 	nPolys = nTriangles;
-				
-	if (gPDC.TSPControlWord & MASK_TRANS)
-	{
-		GenerateDepthInfo (pTri, nPolys);
-	}
 
 	while (nPolys)
 	{
-		CurrentPos = GetStartOfObject (PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos, WORDS_PER_PLANE * 4);
+		CurrentPos = GetStartOfObject (*rISPPos, WORDS_PER_PLANE * 4);
 
 		if (CurrentPos == PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferLimit)
 		{
@@ -2595,16 +2596,14 @@ int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIn
 		}
 		else
 		{
-			DataSize = WORDS_PER_PLANE * 4 * nPolys;
+			nPolysInChunk = MIN (nPolys, IBUFFERSIZE);
+
+			DataSize = WORDS_PER_PLANE * 4 * nPolysInChunk;
 
 			ChunkLimit = GetSabreLimit (CurrentPos);
 			ChunkSize = ChunkLimit - CurrentPos;
 
-			if (DataSize < ChunkSize)
-			{
-				nPolysInChunk = nPolys;
-			}
-			else
+			if (DataSize >= ChunkSize)
 			{
 				nPolysInChunk = ChunkSize / (WORDS_PER_PLANE * 4);
 				
@@ -2616,34 +2615,73 @@ int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIn
 				DataSize = WORDS_PER_PLANE * 4 * nPolysInChunk;
 			}
 			
-			AddRegionObjects((sgl_uint32 *) &(pTri->reg), sizeof (ITRI),
-								  4, nPolysInChunk, CurrentPos, gDepthInfo, sizeof(TRANS_REGION_DEPTHS_STRUCT));
+			if (uParts & ISPTRI_REGIONS)
+			{
+				if (gPDC.TSPControlWord & MASK_TRANS)
+				{
+					GenerateDepthInfo (pTri, nPolysInChunk, DepthInfo);
+				}
 
-			PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos = CurrentPos + DataSize;
+				AddRegionObjects((sgl_uint32 *) &(pTri->reg), sizeof (ITRI),
+								  4, nPolysInChunk, CurrentPos, DepthInfo, sizeof(TRANS_REGION_DEPTHS_STRUCT));
+			}
+
+			*rISPPos = CurrentPos + DataSize;
 
 			nPolys -= nPolysInChunk;
 			
-			SGL_TIME_START(PACK_ISPCORE_TIME)
-
-			/*
-			// If we aren't guaranteed that vertices are on screen, then
-			// use the safer pack routine
-			*/
-			if(gPDC.Context.bDoClipping)
+			if (uParts & ISPTRI_PLANES)
 			{
-				PackISPCoreClipTested( &(PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer[CurrentPos]), 
-							nPolysInChunk, &TSPAddr, &pTri,
-							sizeof (ITRI), TSPIncrement );
+				SGL_TIME_START(PACK_ISPCORE_TIME)
+
+				/*
+				// If we aren't guaranteed that vertices are on screen, then
+				// use the safer pack routine
+				*/
+				if(gPDC.Context.bDoClipping)
+				{
+					PackISPCoreClipTested( &(PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer[CurrentPos]), 
+								nPolysInChunk, &TSPAddr, &pTri,
+								sizeof (ITRI), TSPIncrement );
+				}
+				else
+				{
+					PackISPCore( &(PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer[CurrentPos]), 
+								nPolysInChunk, &TSPAddr, &pTri,
+								sizeof (ITRI), TSPIncrement );
+				}
+
+				SGL_TIME_STOP(PACK_ISPCORE_TIME)
 			}
-			else
+			else if (uParts & ISPTRI_REGIONS)
 			{
-				PackISPCore( &(PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer[CurrentPos]), 
-							nPolysInChunk, &TSPAddr, &pTri,
-							sizeof (ITRI), TSPIncrement );
+				pTri += nPolysInChunk;
 			}
-			SGL_TIME_STOP(PACK_ISPCORE_TIME)
 		}
 	}
+
+	return (nTriangles - nPolys);
+}
+
+/**********************************************************************
+**
+** Hardware: PCX1, PCX2, PCX2_003
+**
+**
+**
+**
+**********************************************************************/
+
+int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement)
+{
+	int 	nPolys;
+	
+	SGL_TIME_START(PACK_ISPTRI_TIME)
+
+	nPolys = nTriangles - PlaceISPTri (pTri, nTriangles,
+									   &PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos,
+									   TSPAddr, TSPIncrement,
+									   ISPTRI_PLANES | ISPTRI_REGIONS);
 	
 	if (nPolys)
 	{
@@ -2655,6 +2693,43 @@ int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIn
 	return (nTriangles - nPolys);
 }
 
+/**********************************************************************
+**
+** Hardware: PCX1, PCX2, PCX2_003
+**
+** Claims ISP space for nTriangles objects at the current buffer position
+** without writing anything, so a chunk can be packed later with
+** PackISPTriAt while other chunks are being claimed or packed. The start
+** of the space goes to *rISPPos; returns how many objects fitted.
+**
+**********************************************************************/
+
+int ReserveISPTri (int nTriangles, sgl_uint32 *rISPPos)
+{
+	*rISPPos = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+
+	return (PlaceISPTri (NULL, nTriangles,
+						 &PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos,
+						 0, 0, 0));
+}
+
+/**********************************************************************
+**
+** Hardware: PCX1, PCX2, PCX2_003
+**
+** Fills in space claimed by ReserveISPTri. Does not touch the buffer
+** position, so it may run on any thread. The planes and the region
+** objects can be written in separate calls (see ISPTRI_PLANES).
+**
+**********************************************************************/
+
+int PackISPTriAt (PITRI pTri, int nTriangles, sgl_uint32 ISPPos,
+				  sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement, sgl_uint32 uParts)
+{
+	return (PlaceISPTri (pTri, nTriangles, &ISPPos,
+						 TSPAddr, TSPIncrement, uParts));
+}
+
 #if (PCX2 || PCX2_003) && !FORCE_NO_FPU
 
 /**********************************************************************
@@ -2686,7 +2761,7 @@ int PackISPTriExtra (PITRI rpTri, PIMATERIAL rpMat,
 
 	if (gPDC.TSPControlWord & MASK_TRANS)
 	{
-		GenerateDepthInfo (pTri, nPolys);
+		GenerateDepthInfo (pTri, nPolys, gDepthInfo);
 	}
 
 	while (nPolys)
@@ -2832,7 +2907,7 @@ int PackISPPolygonExtra (PITRI rpTri, PIMATERIAL rpMat, PIEDGE pEdge, int nPolyg
 
 	if (gPDC.TSPControlWord & MASK_TRANS)
 	{
-		GenerateDepthInfo (pTri, nPolys);
+		GenerateDepthInfo (pTri, nPolys, gDepthInfo);
 	}
 
 	nPlanePolys = nPolys;
@@ -3024,7 +3099,7 @@ int PackISPPolygon (PITRI pTri, PIMATERIAL pMat, PIEDGE pEdge, int nPolygons,
 
 	if (gPDC.TSPControlWord & MASK_TRANS)
 	{
-		GenerateDepthInfo (pTri, nPolys);
+		GenerateDepthInfo (pTri, nPolys, gDepthInfo);
 	}
 
 	nPlanePolys = nPolys;
@@ -50,6 +50,15 @@
 
 int PackISPTri (PITRI pTri, int nTriangles, sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement);
 
+/* What PackISPTriAt writes for a chunk reserved with ReserveISPTri */
+#define ISPTRI_PLANES	0x00000001
+#define ISPTRI_REGIONS	0x00000002
+
+int ReserveISPTri (int nTriangles, sgl_uint32 *rISPPos);
+
+int PackISPTriAt (PITRI pTri, int nTriangles, sgl_uint32 ISPPos,
+				  sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement, sgl_uint32 uParts);
+
 int PackISPTriExtra (PITRI pTri, PIMATERIAL pMat, int nTriangles, 
 					 sgl_uint32 TSPAddr, sgl_uint32 TSPIncrement);
 
@@ -185,6 +185,8 @@ int CALL_CONV sgl_create_camera( float fZoomFactor,
 	*/
     CAMERA_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -208,9 +210,9 @@ int CALL_CONV sgl_create_camera( float fZoomFactor,
 	}
 
     pNode->node_hdr.n16_node_type = nt_camera;
-    pNode->node_hdr.n16_name =
+    pNode->node_hdr.n32_name =
       AddNamedItem(dlUserGlobals.pNamtab, pNode, nt_camera);
-	if (pNode->node_hdr.n16_name == sgl_err_no_name)
+	if (pNode->node_hdr.n32_name == sgl_err_no_name)
 	{
 		SGLFree(pNode);
 		return SglError(sgl_err_no_name);
@@ -255,7 +257,7 @@ int CALL_CONV sgl_create_camera( float fZoomFactor,
 	// RETURN:
 	// -------
 	*/
-    return SglError(pNode->node_hdr.n16_name);
+    return SglError(pNode->node_hdr.n32_name);
 }
 
 
@@ -314,6 +316,8 @@ void CALL_CONV sgl_set_camera( int nName, float fZoomFactor,
 {
     CAMERA_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -355,6 +359,8 @@ void CALL_CONV sgl_set_fog( int nCamera, sgl_colour colour,
 {
 	CAMERA_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -470,6 +476,8 @@ void CALL_CONV sgl_set_background_colour( int nCamera, sgl_colour colour )
 {
 	CAMERA_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -264,6 +264,16 @@
 */
 #define CHUNK_SIZE 10
 
+/*
+// ----------------
+// CONVEX GENERATION
+// ----------------
+// The last value given to a convex node's u32_generation. Every node gets
+// a new one each time it is created or completed, so a node that reuses a
+// deleted one's memory never looks the same as it.
+*/
+static sgl_uint32 u32ConvexGeneration = 0;
+
 
 /*
 // ===========================================================================
@@ -308,7 +318,7 @@ static int CreateConvex(const CONVEX_FLAGS_ENUM ConvexType)
 	}
 
 	pNode->node_hdr.n16_node_type = nt_convex;
-	pNode->node_hdr.n16_name	  = NM_INVALID_NAME;
+	pNode->node_hdr.n32_name	  = NM_INVALID_NAME;
 
 	pNode->u16_num_planes = 0;
 	pNode->u16_max_planes = CHUNK_SIZE;
@@ -317,6 +327,8 @@ static int CreateConvex(const CONVEX_FLAGS_ENUM ConvexType)
 	  cf_all_text_wrap | cf_all_smooth | cf_all_visible | cf_see_inside;
 
 	pNode->edge_info = NULL;
+	pNode->pparent_list = NULL;
+	pNode->u32_generation = ++u32ConvexGeneration;
 
 	pNode->plane_data =
 	  SGLMalloc(pNode->u16_max_planes * sizeof(CONV_PLANE_STRUCT));
@@ -343,6 +355,7 @@ static int CreateConvex(const CONVEX_FLAGS_ENUM ConvexType)
 	// ============
 	*/
 	AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
+	pNode->pparent_list = dlUserGlobals.pCurrentList;
 	dlUserGlobals.pCurrentConvex = pNode;
 	return sgl_no_err;
 }
@@ -1630,6 +1643,12 @@ void DlCompleteCurrentConvex(void)
 			ASSERT(pNode->local_materials == NULL);
 		}
 
+		/*
+		// The convex (and its bounding box) may have changed
+		*/
+		DlInvalidateListBounds(pNode->pparent_list);
+		pNode->u32_generation = ++u32ConvexGeneration;
+
 		dlUserGlobals.pCurrentConvex = NULL;
 	}
 }
@@ -1792,6 +1811,7 @@ void DlDeleteConvexNodeRefs(DL_NODE_STRUCT *pNodeHdr)
  *****************************************************************************/
 int CALL_CONV sgl_create_convex( sgl_bool bGenerateName )
 {
+	DlMarkEdited ();
 
 #if !WIN32
     if (SglInitialise())
@@ -1819,8 +1839,8 @@ int CALL_CONV sgl_create_convex( sgl_bool bGenerateName )
 			nName = AddNamedItem(dlUserGlobals.pNamtab,
 			  dlUserGlobals.pCurrentConvex, nt_convex);
 
-			dlUserGlobals.pCurrentConvex->node_hdr.n16_name =
-			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int16)nName;
+			dlUserGlobals.pCurrentConvex->node_hdr.n32_name =
+			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int32)nName;
 			return SglError(nName);
 		}
 		else
@@ -1850,6 +1870,8 @@ void CALL_CONV sgl_modify_convex( int nName, sgl_bool bClearPolyhedron )
 	*/
     CONVEX_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -1946,6 +1968,8 @@ void CALL_CONV sgl_add_simple_plane( sgl_vector surfacePoint,
 	CONVEX_NODE_STRUCT *pNode;
 	CONV_PLANE_STRUCT  *pPlane;
 
+	DlMarkEdited ();
+
 	if (surfacePoint == NULL || normal == NULL)
 	{
 		DPFDEV((DBG_WARNING, "sgl_add_simple_plane: calling with bad parameters"));	
@@ -1982,6 +2006,8 @@ void CALL_CONV sgl_add_shadow_limit_plane( sgl_vector surfacePoint,
     SHAD_LIM_NODE_STRUCT *pNode;
 	CONV_PLANE_STRUCT  *pPlane;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -2004,7 +2030,7 @@ void CALL_CONV sgl_add_shadow_limit_plane( sgl_vector surfacePoint,
 	  }
 
 	pNode->node_hdr.n16_node_type = nt_shadow_limit;
-	pNode->node_hdr.n16_name	  = NM_INVALID_NAME;
+	pNode->node_hdr.n32_name	  = NM_INVALID_NAME;
 	pNode->node_hdr.next_node	  = NULL;
 
 	/*
@@ -2063,6 +2089,8 @@ void CALL_CONV sgl_add_plane( sgl_vector surfacePoint,
 	CONVEX_NODE_STRUCT *pNode;
 	CONV_PLANE_STRUCT  *pPlane;
 
+	DlMarkEdited ();
+
 	/*
 	// check whether point information is present
 	*/
@@ -2147,6 +2175,8 @@ void CALL_CONV sgl_set_simple_plane( int nPlaneIndex, sgl_vector surfacePoint,
 	CONVEX_NODE_STRUCT *pNode;
 	CONV_PLANE_STRUCT  *pPlane;
 
+	DlMarkEdited ();
+
 	if (surfacePoint == NULL || normal == NULL)
 	{
 		DPFDEV((DBG_WARNING, "sgl_set_simple_plane: calling with bad parameters"));	
@@ -2190,6 +2220,8 @@ void CALL_CONV sgl_set_plane( int nPlaneIndex,
 	CONVEX_NODE_STRUCT *pNode;
 	CONV_PLANE_STRUCT  *pPlane;
 
+	DlMarkEdited ();
+
 	/*
 	// check whether point information is present
 	*/
@@ -2275,6 +2307,8 @@ void CALL_CONV sgl_delete_plane( int nPlaneIndex )
 	CONV_SHADING_STRUCT	*pDestShading=NULL,*pSrcShading=NULL;
 	CONV_POINTS_STRUCT *pDestPoints=NULL,*pSrcPoints=NULL;
 
+	DlMarkEdited ();
+
 	nError = CommonSetPlane(&pNode,NULL, nPlaneIndex);
 	if (nError != sgl_no_err)
 	{
@@ -2400,6 +2434,7 @@ int CALL_CONV sgl_create_light_volume( const sgl_bool bGenerateName,
 							 		   const sgl_bool bLightVol,
 									   const int LightName)
 {
+	DlMarkEdited ();
 
 #if !WIN32
     if (SglInitialise())
@@ -2463,8 +2498,8 @@ int CALL_CONV sgl_create_light_volume( const sgl_bool bGenerateName,
 			nName = AddNamedItem(dlUserGlobals.pNamtab,
 			  dlUserGlobals.pCurrentConvex, nt_convex);
 
-			dlUserGlobals.pCurrentConvex->node_hdr.n16_name =
-			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int16)nName;
+			dlUserGlobals.pCurrentConvex->node_hdr.n32_name =
+			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int32)nName;
 			return SglError(nName);
 		}
 		else
@@ -2486,6 +2521,7 @@ int CALL_CONV sgl_create_light_volume( const sgl_bool bGenerateName,
  *****************************************************************************/
 int CALL_CONV sgl_create_hidden_convex( sgl_bool bGenerateName )
 {
+	DlMarkEdited ();
 
 #if !WIN32
     if (SglInitialise())
@@ -2513,8 +2549,8 @@ int CALL_CONV sgl_create_hidden_convex( sgl_bool bGenerateName )
 			nName = AddNamedItem(dlUserGlobals.pNamtab,
 			  dlUserGlobals.pCurrentConvex, nt_convex);
 
-			dlUserGlobals.pCurrentConvex->node_hdr.n16_name =
-			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int16)nName;
+			dlUserGlobals.pCurrentConvex->node_hdr.n32_name =
+			  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int32)nName;
 			return SglError(nName);
 		}
 		else
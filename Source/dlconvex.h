@@ -333,6 +333,19 @@ typedef struct
 	*/
 	BBOX_CENT_STRUCT bbox;
 
+	/*
+	// Pointer to this nodes parent list, so its bounds can be
+	// invalidated when the convex is changed
+	*/
+	LIST_NODE_STRUCT * pparent_list;
+
+	/*
+	// Changed whenever the convex is created or completed, so that
+	// anything built from it, such as the shadow volumes cached in
+	// rnshadow.c, can tell when it is out of date
+	*/
+	sgl_uint32 u32_generation;
+
 	/*
 	// pointer to the list of plane data. Note this
 	// points to the first element of an array of planes
@@ -125,7 +125,7 @@ void DlDeleteNode(DL_NODE_STRUCT * pNode)
 	int name, type;
 
 
-	name = pNode->n16_name;
+	name = pNode->n32_name;
 	type = pNode->n16_node_type;
 
 	/*
@@ -305,7 +305,7 @@ void DlDeleteNode(DL_NODE_STRUCT * pNode)
 		/*
 		// Remove it from the name table
 		*/
-		DeleteNamedItem(dlUserGlobals.pNamtab,pNode->n16_name);
+		DeleteNamedItem(dlUserGlobals.pNamtab,pNode->n32_name);
 		
 	}
 
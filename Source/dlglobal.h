@@ -50,6 +50,19 @@ typedef struct
 	MATERIAL_NODE_STRUCT	*pCurrentMaterial;
 	MESH_NODE_STRUCT		*pCurrentMesh;
 
+	/*
+	// Count of edits to the display list and to anything it refers to
+	// (textures, devices and viewports). sgl_render compares this with
+	// the count when it last built a frame to see if it can reuse it.
+	*/
+	sgl_uint32				u32EditCount;
+
+	/*
+	// Incremented each time sgl_compact_texture_memory moves textures, so
+	// materials know to fetch their texture's control word again.
+	*/
+	sgl_uint32				u32TextureMoveCount;
+
 } DL_USER_GLOBALS_STRUCT;
 
 
@@ -61,6 +74,11 @@ typedef struct
 // be extended later
 */
 extern DL_USER_GLOBALS_STRUCT	dlUserGlobals;
+
+/*
+// Called by each API routine that changes something sgl_render would draw
+*/
+#define DlMarkEdited()	(dlUserGlobals.u32EditCount++)
 		     
 
 
@@ -290,8 +290,9 @@ static void SetAmbientLight( LIGHT_NODE_STRUCT * pLightNode,
 	if (StoreHeader)
 	{
 		pLightNode->node_hdr.n16_node_type = (sgl_int16) nt_light;
-		pLightNode->node_hdr.n16_name	  = (sgl_int16) name;
+		pLightNode->node_hdr.n32_name	  = (sgl_int32) name;
 		pLightNode->node_hdr.next_node	  = NULL;
+		pLightNode->range = 0.0f;
 	}
 
 	/* store light info */
@@ -346,8 +347,9 @@ static void SetParallelLight( LIGHT_NODE_STRUCT * pLightNode,
 	if (StoreHeader)
 	{
 		pLightNode->node_hdr.n16_node_type = (sgl_int16) nt_light;
-		pLightNode->node_hdr.n16_name	  = (sgl_int16) name;
+		pLightNode->node_hdr.n32_name	  = (sgl_int32) name;
 		pLightNode->node_hdr.next_node	  = NULL;
+		pLightNode->range = 0.0f;
 	}
 
 	/* store light info */
@@ -414,8 +416,9 @@ static void SetPointLight( LIGHT_NODE_STRUCT * pLightNode,
    	if (StoreHeader)
 	{
 		pLightNode->node_hdr.n16_node_type = (sgl_int16) nt_light;
-		pLightNode->node_hdr.n16_name	  = (sgl_int16) name;
+		pLightNode->node_hdr.n32_name	  = (sgl_int32) name;
 		pLightNode->node_hdr.next_node	  = NULL;
+		pLightNode->range = 0.0f;
 	}
 
 	/* store light info */
@@ -500,6 +503,8 @@ int	CALL_CONV sgl_create_ambient_light( sgl_bool generate_name,
 
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -620,6 +625,8 @@ int	CALL_CONV sgl_create_parallel_light( sgl_bool generate_name,
 
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -742,6 +749,8 @@ int	CALL_CONV sgl_create_point_light( sgl_bool generate_name,
 
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -847,6 +856,8 @@ void CALL_CONV sgl_set_ambient_light( int name, sgl_colour colour,
 {
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -922,6 +933,8 @@ void CALL_CONV sgl_set_parallel_light( int name, sgl_colour colour,
 {
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -996,6 +1009,8 @@ void CALL_CONV sgl_set_point_light( int name, sgl_colour colour,
 {
 	LIGHT_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1058,6 +1073,8 @@ void CALL_CONV sgl_position_light( int name )
 	LIGHT_NODE_STRUCT 		* litNode;
 	LIGHT_POS_NODE_STRUCT 	* posNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1113,7 +1130,7 @@ void CALL_CONV sgl_position_light( int name )
 	/* store header information  */
 
 	posNode->node_hdr.n16_node_type = (sgl_int16) nt_light_pos;
-	posNode->node_hdr.n16_name	  = (sgl_int16) NM_INVALID_NAME;
+	posNode->node_hdr.n32_name	  = (sgl_int32) NM_INVALID_NAME;
 	posNode->node_hdr.next_node	  = NULL;
 
 	posNode->light_name=name;
@@ -1162,6 +1179,8 @@ void CALL_CONV sgl_switch_light( int name,
 	LIGHT_SWITCH_NODE_STRUCT * pNode;
 	LIGHT_SWITCH_NODE_STRUCT *pLast;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1230,7 +1249,7 @@ void CALL_CONV sgl_switch_light( int name,
 		/* store header information  */
 
 		pNode->node_hdr.n16_node_type = (sgl_int16) nt_light_switch;
-		pNode->node_hdr.n16_name	  = (sgl_int16) NM_INVALID_NAME;
+		pNode->node_hdr.n32_name	  = (sgl_int32) NM_INVALID_NAME;
 		pNode->node_hdr.next_node	  = NULL;
 
 		pNode->light_name=name;
@@ -1251,6 +1270,71 @@ void CALL_CONV sgl_switch_light( int name,
 }
 
 
+/**************************************************************************
+ * Function Name  : sgl_set_light_range
+ * Inputs         : name			- name of the light
+					range			- how far it reaches, or 0 for
+									  everywhere
+ * Outputs        : 
+ * Input/Output	  : 
+ * Returns        : 
+ * Global Used    : dlUserGlobals structure
+ * Description    : Sets how far a point light reaches. The shading doesn't
+ *					fade lights with distance, so this is only a promise
+ *					that the light doesn't matter to objects further away;
+ *					when there are more lights than can be used at once,
+ *					those objects are shaded without it. It is ignored
+ *					for other types of light.
+ *
+ **************************************************************************/
+
+void CALL_CONV sgl_set_light_range( int name, float range )
+{
+	LIGHT_NODE_STRUCT * pNode;
+
+	DlMarkEdited ();
+
+  	/*	
+		Initialise sgl if this hasn't yet been done		
+	*/
+#if !WIN32
+	if(SglInitialise() != 0)
+	{
+		/*
+			We failed to initialise sgl
+		*/
+		SglError(sgl_err_failed_init);
+		return;
+	}
+#endif
+
+	/*
+	   Tidy up current transforms etc...
+	*/
+
+	DlCompleteCurrentMaterial();
+	DlCompleteCurrentTransform();
+	DlCompleteCurrentConvex();
+	DlCompleteCurrentMesh();
+
+	/* Make sure that given name is the name of a light */
+
+    if ( GetNamedItemType(dlUserGlobals.pNamtab, name) != nt_light )
+	{
+		/* the given name is invalid */
+
+    	SglError(sgl_err_bad_name);
+		return; 
+	}
+
+    pNode = GetNamedItem(dlUserGlobals.pNamtab, name);
+
+	pNode->range = (range > 0.0f) ? range : 0.0f;
+
+	SglError(sgl_no_err);
+}
+
+
 /**************************************************************************
  * Function Name  : sgl_pseudo_multishadows
  * Inputs         : name			- name of light being positioned 
@@ -1267,6 +1351,8 @@ void CALL_CONV sgl_pseudo_multishadows ( sgl_bool enable,
 {
 	MULTI_SHADOW_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
   	/*	
 	//	Initialise sgl if this hasn't yet been done		
 	*/
@@ -1307,7 +1393,7 @@ void CALL_CONV sgl_pseudo_multishadows ( sgl_bool enable,
 	// Fill in the header details
 	*/
 	pNode->node_hdr.n16_node_type = (sgl_int16) nt_multi_shadow;
-	pNode->node_hdr.n16_name	  = NM_INVALID_NAME;
+	pNode->node_hdr.n32_name	  = NM_INVALID_NAME;
 	
 	/*
 	// Store the supplied values
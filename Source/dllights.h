@@ -174,6 +174,12 @@ typedef struct
 	int   concentration;
 	float log2concentration;
 
+	/*
+	// How far a point light reaches, as set by sgl_set_light_range, or
+	// 0 if it reaches everything.
+	*/
+	float range;
+
 	/*
 	// Optional reference to a light position node
 	*/
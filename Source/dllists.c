@@ -151,6 +151,8 @@ static void DisconnectNodeFromList(LIST_NODE_STRUCT *pList,
 	ASSERT(pList->node_hdr.n16_node_type == nt_list_node);
 	ASSERT(pNode != NULL)
 
+	DlInvalidateListBounds(pList);
+
 	/*
 	// See if the node to disconnect is the first one in the list
 	*/
@@ -294,6 +296,8 @@ static void ClearDisplayList(LIST_NODE_STRUCT *  pList)
 	*/
 	pList->pfirst  = NULL;
 	pList->plast   = NULL;
+
+	DlInvalidateListBounds(pList);
 }
 
 
@@ -352,7 +356,7 @@ void InitListNode(LIST_NODE_STRUCT * pListNode,
 	// next node is just for cleanliness/error catching.
 	*/
 	pListNode->node_hdr.n16_node_type = (sgl_int16) nt_list_node;
-	pListNode->node_hdr.n16_name	  = (sgl_int16) name;
+	pListNode->node_hdr.n32_name	  = (sgl_int32) name;
 	pListNode->node_hdr.next_node	  = NULL;
 
 	/*
@@ -370,6 +374,11 @@ void InitListNode(LIST_NODE_STRUCT * pListNode,
 	*/
 	pListNode->flags   = (list_flags_enum) (lf_process_list | lf_preserve_state);
 
+	/*
+	// The bounds get worked out when they are first needed
+	*/
+	pListNode->bounds_flags = 0;
+
 }
 
 
@@ -446,6 +455,33 @@ void AppendNodeToList(LIST_NODE_STRUCT *  pParentList,
 	*/
 	pTheNode->next_node = NULL;
 
+	DlInvalidateListBounds(pParentList);
+
+}
+
+
+/**************************************************************************
+ * Function Name  : DlInvalidateListBounds
+ * Inputs         : pList	- pointer to a list node, or NULL
+ * Outputs        : None
+ * Input/Output	  : 
+ * Returns        : None
+ * Global Used    : None
+ * Description    : Marks the bounds of the list, and of every list above
+ *					it, as out of date. Called whenever something that may
+ *					move or enlarge what a list draws is changed.
+ *
+ **************************************************************************/
+
+void DlInvalidateListBounds(LIST_NODE_STRUCT *  pList)
+{
+	while(pList != NULL)
+	{
+		ASSERT(pList->node_hdr.n16_node_type == nt_list_node);
+
+		pList->bounds_flags = 0;
+		pList = pList->pparent;
+	}
 }
 
 
@@ -482,6 +518,8 @@ int	CALL_CONV sgl_create_list( sgl_bool generate_name,
 
 	LIST_NODE_STRUCT * pList;
 
+	DlMarkEdited ();
+
 	/*
 	// Set generate name flag in the cases where it is pointless NOT to do so
 	*/
@@ -687,6 +725,8 @@ void CALL_CONV sgl_modify_list ( int list_name,
 	*/
 	LIST_NODE_STRUCT * pList;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -795,6 +835,8 @@ void CALL_CONV sgl_delete_list ( int list_name )
 	// Pointer to the list to delete, and its parent, if any
 	*/
 	LIST_NODE_STRUCT * pList, *pParent;
+
+	DlMarkEdited ();
 	
 	/*
 	// Do initialise if necesary. ABORT if error.
@@ -907,6 +949,8 @@ void CALL_CONV sgl_detach_list ( int list_name )
 	*/
 	LIST_NODE_STRUCT * pList;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -1052,6 +1096,8 @@ void CALL_CONV sgl_attach_list ( int list_name )
 	*/
 	LIST_NODE_STRUCT * pList;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -1160,6 +1206,8 @@ void CALL_CONV sgl_set_ignore_list ( int list_name, sgl_bool ignore )
 	LIST_NODE_STRUCT * pList;
 	int	NodeType;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -1216,6 +1264,11 @@ void CALL_CONV sgl_set_ignore_list ( int list_name, sgl_bool ignore )
 		pList->flags |= lf_process_list;
 	}
 
+	/*
+	// The lists above this one may now draw more or less
+	*/
+	DlInvalidateListBounds(pList);
+
 
 	/*
 	// All went OK
@@ -1258,6 +1311,8 @@ void CALL_CONV sgl_use_instance( int list_to_instance )
 	LIST_NODE_STRUCT * pInstancedList;
 	INSTANCE_NODE_STRUCT *pInstance;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -1325,7 +1380,7 @@ void CALL_CONV sgl_use_instance( int list_to_instance )
 	// and the list that is instanced.
 	*/
 	pInstance->node_hdr.n16_node_type =  nt_instance;
-	pInstance->node_hdr.n16_name	  =  NM_INVALID_NAME;
+	pInstance->node_hdr.n32_name	  =  NM_INVALID_NAME;
 	pInstance->referenced_list = list_to_instance;
 
 
@@ -1410,6 +1465,8 @@ void CALL_CONV sgl_instance_substitutions( int num_subs_param,
 
 	int replacementName, replaceeName;
 
+	DlMarkEdited ();
+
 	/*
 	// Do initialise if necesary. ABORT if error.
 	*/
@@ -1448,7 +1505,7 @@ void CALL_CONV sgl_instance_substitutions( int num_subs_param,
 	// (NOTE No name)
 	*/
 	pSubNode->node_hdr.n16_node_type = nt_inst_subs;
-	pSubNode->node_hdr.n16_name		 = NM_INVALID_NAME;
+	pSubNode->node_hdr.n32_name		 = NM_INVALID_NAME;
 
 	/*
 	// Add it to the current display list
@@ -1500,7 +1557,7 @@ void CALL_CONV sgl_instance_substitutions( int num_subs_param,
 		// Paranoia ... check the type and name of the referenced node
 		*/
 		ASSERT(((DL_NODE_STRUCT*)itemPtr)->n16_node_type == replaceeType)
-		ASSERT(((DL_NODE_STRUCT*)itemPtr)->n16_name		 == replaceeName)
+		ASSERT(((DL_NODE_STRUCT*)itemPtr)->n32_name		 == replaceeName)
 		
 		/*
 		// Now check the replacement - it is also valid to replace it with NULL
@@ -1533,7 +1590,7 @@ void CALL_CONV sgl_instance_substitutions( int num_subs_param,
 			// Paranoia ... check the type and name of the referenced node
 			*/
 			ASSERT(((DL_NODE_STRUCT*)itemPtr)->n16_node_type == replacementType)
-			ASSERT(((DL_NODE_STRUCT*)itemPtr)->n16_name		 == replacementName)
+			ASSERT(((DL_NODE_STRUCT*)itemPtr)->n32_name		 == replacementName)
 
 		}/*end if name valid*/
 
@@ -1598,7 +1655,7 @@ void  DlDeleteSubstitutionNodeRefs(DL_NODE_STRUCT *pNode)
 	// Test we haven't been given nonsense
 	*/
 	ASSERT(pSubNode->node_hdr.n16_node_type == nt_inst_subs)
-	ASSERT(pSubNode->node_hdr.n16_name	== NM_INVALID_NAME)
+	ASSERT(pSubNode->node_hdr.n32_name	== NM_INVALID_NAME)
 	
 	ASSERT(pSubNode->num_subs >= 0)
 	ASSERT(pSubNode->num_subs <= SGL_MAX_INSTANCE_PARAMS)
@@ -1698,7 +1755,7 @@ static void DumpAndRecurseList(LIST_NODE_STRUCT *pList,
 	// Print out this list's details
 	*/
 	fprintf(outfile, "%sList.  Name:%d  %s %s\n", pPaddingString,
-					   (int)pList->node_hdr.n16_name,
+					   (int)pList->node_hdr.n32_name,
 						igno, pres);
 					   	
 	/*
@@ -1725,14 +1782,14 @@ static void DumpAndRecurseList(LIST_NODE_STRUCT *pList,
 			case nt_convex:
 			{
 				fprintf(outfile, "%sConvex: Name%d\n",
-						pPaddingString, pNode->n16_name);
+						pPaddingString, pNode->n32_name);
 				break;
 			}
 
 			case nt_mesh:
 			{
 				fprintf(outfile, "%sMesh: Name%d\n",
-						pPaddingString, pNode->n16_name);
+						pPaddingString, pNode->n32_name);
 				break;
 			}
 
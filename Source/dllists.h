@@ -61,6 +61,28 @@ typedef enum
 
 }list_flags_enum;
 
+/*
+// List Bounds Flags (see the bounds in the list node)
+//
+// Valid:	the rest of the flags and the bounds are up to date. Cleared
+//			by DlInvalidateListBounds whenever anything that could move
+//			or enlarge what the list draws is changed.
+//
+// Cullable: the list (and everything under it) only draws convex
+//			primitives and meshes that have bounding boxes, and leaves no
+//			mark on the state outside the list, so traversal can skip it
+//			if its bounds are off screen.
+//
+// Empty:	a cullable list that draws nothing at all.
+*/
+typedef enum
+{
+	lbf_valid	 = (1<<0),
+	lbf_cullable = (1<<1),
+	lbf_empty	 = (1<<2)
+
+}list_bounds_flags_enum;
+
 typedef struct _LIST_NODE_STRUCT
 {
 
@@ -86,6 +108,13 @@ typedef struct _LIST_NODE_STRUCT
 	DL_NODE_STRUCT * pfirst;
 	DL_NODE_STRUCT * plast;
 
+	/*
+	// The bounds of what the list draws, in the space the list is
+	// entered in. Worked out by the renderer when it needs them.
+	*/
+	int bounds_flags;
+	BBOX_MINMAX_STRUCT bounds;
+
 } LIST_NODE_STRUCT;
 
 
@@ -128,7 +157,7 @@ typedef struct
 	/*
 	// List of the substitutions to make
 	*/
-	sgl_int16	param_list[SGL_MAX_INSTANCE_PARAMS][2];
+	sgl_int32	param_list[SGL_MAX_INSTANCE_PARAMS][2];
 
 } INSTANCE_SUBS_NODE_STRUCT;
 
@@ -151,6 +180,8 @@ extern void  DlDeleteListNodeRefs(DL_NODE_STRUCT *pNode);
 extern void AppendNodeToList(LIST_NODE_STRUCT *  pParentList,
 							void * pNode);
 
+extern void DlInvalidateListBounds(LIST_NODE_STRUCT *  pList);
+
 
 
 
@@ -315,6 +315,8 @@ int CALL_CONV sgl_create_detail_levels( sgl_bool bGenerateName,
     LOD_NODE_STRUCT *pNode;
     int nReturn=0; /* This zero value is for 'undefined' return conditions. */
 
+	DlMarkEdited ();
+
 
 #if !WIN32
     if (SglInitialise())
@@ -346,13 +348,13 @@ int CALL_CONV sgl_create_detail_levels( sgl_bool bGenerateName,
 		int nName;
 
 		nName = AddNamedItem(dlUserGlobals.pNamtab, pNode, nt_lod);
-		pNode->node_hdr.n16_name =
-		  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int16)nName;
+		pNode->node_hdr.n32_name =
+		  nName == sgl_err_no_name ? NM_INVALID_NAME : (sgl_int32)nName;
 		nReturn = nName;
 	}
 	else
 	{
-    	pNode->node_hdr.n16_name = NM_INVALID_NAME;
+    	pNode->node_hdr.n32_name = NM_INVALID_NAME;
 		/* Return value undefined. */
 	}
 
@@ -456,6 +458,8 @@ void CALL_CONV sgl_set_detail_levels( int nName,
 {
     LOD_NODE_STRUCT *pNode;
 
+	DlMarkEdited ();
+
 	ASSERT(boxCorner1 != NULL)
 	ASSERT(boxCorner2 != NULL)
 	ASSERT(pnModels != NULL)
@@ -351,7 +351,7 @@ void DlDeleteMaterialNodeRefs (DL_NODE_STRUCT *pNode)
 	ASSERT (pMaterial);
 	ASSERT (pMaterial->node_hdr.n16_node_type == nt_material);
 
-	DPF ((DBG_VERBOSE, "deleting material structure (name = %d)", pMaterial->node_hdr.n16_name));
+	DPF ((DBG_VERBOSE, "deleting material structure (name = %d)", pMaterial->node_hdr.n32_name));
 
 	if (pMaterial->pwrap_data)
 	{
@@ -398,6 +398,8 @@ int CALL_CONV sgl_create_material ( sgl_bool generate_name,
 	sgl_bool bCreateLocalConvex = (param_is_local && (dlUserGlobals.pCurrentConvex != NULL));
 	sgl_bool bCreateLocalMesh = (param_is_local && (dlUserGlobals.pCurrentMesh != NULL));
 
+	DlMarkEdited ();
+
 /* #if !WIN32 */
 /* 	if (SglInitialise()) */
 /* 	{ */
@@ -447,7 +449,7 @@ int CALL_CONV sgl_create_material ( sgl_bool generate_name,
 			{
 				/* the user wants the name returned */
 
-				pMaterial->node_hdr.n16_name = nName;
+				pMaterial->node_hdr.n32_name = nName;
 				nError = nName;
 			}
 		}
@@ -455,7 +457,7 @@ int CALL_CONV sgl_create_material ( sgl_bool generate_name,
 		{
 			/* no name, no error */
 
-			pMaterial->node_hdr.n16_name = NM_INVALID_NAME;
+			pMaterial->node_hdr.n32_name = NM_INVALID_NAME;
 			nError = sgl_no_err;
 		}
 
@@ -545,6 +547,120 @@ int CALL_CONV sgl_create_material ( sgl_bool generate_name,
 	return (SglError (nError));
 }
 
+/*===========================================
+ * Function:	sgl_create_materials
+ *===========================================
+ *
+ * Scope:		SGL API
+ *
+ * Purpose:		Creates count named, non-local materials in one go, as if
+ *				sgl_create_material (TRUE, FALSE) had been called count times.
+ *				The names are all added to the name table at once, so it only
+ *				has to grow once. If any part fails, nothing is created.
+ *
+ * Params:		int count: number of materials to create
+ *				int *names: the count names are returned here
+ *
+ * Return:		int -ve error, or sgl_no_err
+ *
+ * Globals accessed:	dlUserGlobals.pCurrentMaterial
+ *						dlUserGlobals.pNamtab
+ *						dlUserGlobals.pCurrentList
+ *========================================================================================*/
+int CALL_CONV sgl_create_materials ( int count, int *names )
+{
+	int nError = sgl_no_err;
+	int i;
+	MATERIAL_NODE_STRUCT **ppMaterials;
+
+	if ((count <= 0) || (names == NULL))
+	{
+		return (SglError (sgl_err_bad_parameter));
+	}
+
+	DlMarkEdited ();
+
+	TidyUpCurrentState (FALSE);
+
+	/* starting new materials, so complete the previous one if it exists */
+
+	DlCompleteCurrentMaterial ();
+
+	/* allocate all the material structures first */
+
+	ppMaterials = SGLMalloc (count * sizeof (MATERIAL_NODE_STRUCT *));
+
+	if (!ppMaterials)
+	{
+		DPF ((DBG_ERROR, "sgl_create_materials: SGLMalloc failed"));
+		return (SglError (sgl_err_no_mem));
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		ppMaterials[i] = SGLMalloc (sizeof (MATERIAL_NODE_STRUCT));
+
+		if (!ppMaterials[i])
+		{
+			DPF ((DBG_ERROR, "sgl_create_materials: SGLMalloc failed"));
+			nError = sgl_err_no_mem;
+			break;
+		}
+	}
+
+	if (nError == sgl_no_err)
+	{
+		/* add all the names to the name table */
+
+		ASSERT (dlUserGlobals.pNamtab);
+
+		if (AddNamedItems (dlUserGlobals.pNamtab, count, (void **) ppMaterials,
+						   nt_material, names) != 0)
+		{
+			DPF ((DBG_ERROR, "sgl_create_materials: couldn't add material blocks to name table"));
+			nError = sgl_err_no_name;
+		}
+	}
+
+	if (nError != sgl_no_err)
+	{
+		/* free the blocks that were allocated */
+
+		while (i-- > 0)
+		{
+			SGLFree (ppMaterials[i]);
+		}
+	}
+	else
+	{
+		ASSERT (dlUserGlobals.pCurrentList);
+
+		/* append them to the current list, and initialise them */
+
+		for (i = 0; i < count; i++)
+		{
+			MATERIAL_NODE_STRUCT *pMaterial = ppMaterials[i];
+
+			pMaterial->node_hdr.n16_node_type = nt_material;
+			pMaterial->node_hdr.n32_name = names[i];
+
+			AppendNodeToList (dlUserGlobals.pCurrentList, pMaterial);
+
+			pMaterial->data_flags = 0; /* not local */
+			pMaterial->pwrap_data = NULL;
+			pMaterial->text_effect = 0;
+		}
+
+		/* the last one is the current material */
+
+		dlUserGlobals.pCurrentMaterial = ppMaterials[count - 1];
+	}
+
+	SGLFree (ppMaterials);
+
+	return (SglError (nError));
+}
+
 /*===========================================
  * Function:	sgl_use_material_instance
  *===========================================
@@ -571,6 +687,8 @@ void CALL_CONV sgl_use_material_instance ( int instanced_material,
 	sgl_bool bCreateLocalConvex = (param_is_local && (dlUserGlobals.pCurrentConvex != NULL));
 	sgl_bool bCreateLocalMesh = (param_is_local && (dlUserGlobals.pCurrentMesh != NULL));
 
+	DlMarkEdited ();
+
 	/*
 	// Initialise the system if necessary
 	*/
@@ -614,7 +732,7 @@ void CALL_CONV sgl_use_material_instance ( int instanced_material,
 	else
 	{
 		pMaterial->node_hdr.n16_node_type = nt_material;
-		pMaterial->node_hdr.n16_name = NM_INVALID_NAME;
+		pMaterial->node_hdr.n32_name = NM_INVALID_NAME;
 
 		ASSERT (dlUserGlobals.pCurrentList);
 
@@ -715,6 +833,8 @@ void CALL_CONV sgl_modify_material ( int nName, sgl_bool bClearMaterial )
 	int nError;
 	MATERIAL_NODE_STRUCT *pMaterial;
 
+	DlMarkEdited ();
+
 
 	/*
 	// Initialise the system if necessary
@@ -794,6 +914,8 @@ void CALL_CONV sgl_set_ambient ( sgl_colour cColour )
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	ASSERT (cColour);
 
 	/*
@@ -855,6 +977,8 @@ void CALL_CONV sgl_set_diffuse ( sgl_colour cColour )
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	ASSERT (cColour);
 
 	/*
@@ -918,6 +1042,8 @@ void CALL_CONV sgl_set_specular ( sgl_colour cColour, int nShininess )
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	ASSERT (cColour);
 
 	/*
@@ -1017,6 +1143,8 @@ void CALL_CONV sgl_set_glow ( sgl_colour cColour )
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	ASSERT (cColour);
 
 	/*
@@ -1077,6 +1205,8 @@ void CALL_CONV sgl_set_opacity ( float fOpacity )
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	/*
 	// Initialise the system if necessary
 	*/
@@ -1143,6 +1273,8 @@ void CALL_CONV sgl_set_texture_map ( int nTextureName,
 	int itemType;
 	HTEXTURE hTexture;
 
+	DlMarkEdited ();
+
 	/*
 	// Initialise the system if necessary
 	*/
@@ -1233,6 +1365,8 @@ void CALL_CONV sgl_set_texture_map ( int nTextureName,
 					*/
 					pMaterial->pcached_texture = NULL;
 					pMaterial->texture_control = hTexture->TSPTextureControlWord;
+					pMaterial->texture_name = nTextureName;
+					pMaterial->texture_moves = dlUserGlobals.u32TextureMoveCount;
 				}
 				else
 				{
@@ -1284,6 +1418,8 @@ void CALL_CONV sgl_set_texture_effect (sgl_bool fAffectAmbient,
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	/*
 	// Initialise the system if necessary
 	*/
@@ -1380,6 +1516,8 @@ void CALL_CONV sgl_set_smap ( sgl_smap_types SMapType,
 {
 	int nError;
 
+	DlMarkEdited ();
+
 
 	/*
 	// Initialise the system if necessary
@@ -1476,6 +1614,8 @@ void CALL_CONV sgl_set_omap ( sgl_omap_types OMapType,
 {
 	int nError;
 
+	DlMarkEdited ();
+
 	/*
 	// Initialise the system if necessary
 	*/
@@ -1584,7 +1724,7 @@ void DumpMaterial(	MATERIAL_NODE_STRUCT* pNode,
 	else
 	{
 		fprintf(outfile, "%sMaterial: Name:%d\n",
-			 pPaddingString, pNode->node_hdr.n16_name);
+			 pPaddingString, pNode->node_hdr.n32_name);
 
 		if (MatFlags & mnf_has_diffuse)
 		{
@@ -201,6 +201,8 @@ typedef struct
 	*/
 	void * 	pcached_texture;
 	sgl_uint32	texture_control;  /*contains the address and sizes etc in TEXAS format*/
+	int			texture_name;	  /* to fetch texture_control again if it moves */
+	sgl_uint32	texture_moves;	  /* dlUserGlobals.u32TextureMoveCount when fetched */
 	int	text_effect;
 
 	/*
@@ -429,6 +429,8 @@ static int      CheckCurrentMesh (void);
 static int      AddEdgeToAdjacencyInfo (PMESH_NODE_STRUCT pMesh, sgl_uint32 nIDV1, sgl_uint32 nIDV2, int nFaceID);
 static int      RemoveEdgeFromAdjacencyInfo (PMESH_NODE_STRUCT pMesh, int nEdgeID);
 static int 		set_face_data (PMESH_NODE_STRUCT pMesh, PFACE pFace, int nNumToAdd, int *pnVertexIDs, int fDoAdjacency);
+static void		FreeCompiledMesh (PMESH_NODE_STRUCT pMesh);
+static void		CompileMesh (PMESH_NODE_STRUCT pMesh);
 
 /*
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -834,6 +836,128 @@ static sgl_bool FindIdenticalVertex (void *pvVertex, sgl_uint32 pvData)
 	return (TRUE);
 }
 
+/*
+// To find an identical vertex without trying every one, the vertex list
+// is indexed by which cell of a grid the position is in. The cells are
+// VERTEX_CELL_BLURS times the position tolerance, so any vertex within
+// the tolerance is in the same cell or a neighbouring one; we look in
+// every cell within twice the tolerance, which is usually just one.
+// Cell numbers are clamped, which keeps silly coordinates right, if slow.
+*/
+#define VERTEX_CELL_BLURS	4.0
+#define MAX_VERTEX_CELL		1.0e9
+
+static double VertexCellScale (void)
+{
+	double fCell = VERTEX_CELL_BLURS * ((gfBlurPos > 0.0f) ? gfBlurPos : 0.0001f);
+
+	return (1.0 / fCell);
+}
+
+static sgl_int32 VertexCell (double fPos, double fScale)
+{
+	double fCell = floor (fPos * fScale);
+
+	if (fCell > MAX_VERTEX_CELL)
+	{
+		fCell = MAX_VERTEX_CELL;
+	}
+	else if (fCell < -MAX_VERTEX_CELL)
+	{
+		fCell = -MAX_VERTEX_CELL;
+	}
+
+	return ((sgl_int32) fCell);
+}
+
+static sgl_uint32 VertexCellKey (sgl_int32 nX, sgl_int32 nY, sgl_int32 nZ)
+{
+	return (((sgl_uint32) nX * 73856093UL) ^ 
+			((sgl_uint32) nY * 19349663UL) ^ 
+			((sgl_uint32) nZ * 83492791UL));
+}
+
+/*===========================================
+ * Function:    KeyVertex
+ *===========================================
+ *
+ * Scope:	    static to this module
+ *
+ * Purpose:	  	Key of a vertex in the vertex list index
+ *
+ * Params:	    void *pvVertex: DLVERTEXDATA
+ *
+ * Return:	    key of the cell the vertex is in
+ *========================================================================================*/
+static sgl_uint32 KeyVertex (void *pvVertex)
+{
+	PDLVERTEXDATA pDLVertexData = pvVertex;
+	double fScale = VertexCellScale ();
+
+	return (VertexCellKey (VertexCell (pDLVertexData->pV->vVertex[0], fScale),
+						   VertexCell (pDLVertexData->pV->vVertex[1], fScale),
+						   VertexCell (pDLVertexData->pV->vVertex[2], fScale)));
+}
+
+/*===========================================
+ * Function:    FindVertex
+ *===========================================
+ *
+ * Scope:	    static to this module
+ *
+ * Purpose:	  	Finds the first vertex in a mesh that FindIdenticalVertex
+ *				says is identical to the one given, using the vertex index.
+ *
+ * Params:	    PMESH_NODE_STRUCT pMesh
+ *			    POPTVERTEX pOV: the vertex
+ *
+ * Return:	    PDLVERTEXDATA, or NULL if there isn't one
+ *========================================================================================*/
+static PDLVERTEXDATA FindVertex (PMESH_NODE_STRUCT pMesh, POPTVERTEX pOV)
+{
+	PDLVERTEXDATA pFound, pDLVertexData;
+	sgl_int32 nLo[3], nHi[3], nX, nY, nZ;
+	double fScale, fSlack;
+	int k;
+
+	if (!ListAddIndex (pMesh->Vertices, 0, KeyVertex))
+	{
+		return (ListFindItem (pMesh->Vertices, FindIdenticalVertex, (sgl_uint32) pOV));
+	}
+
+	fScale = VertexCellScale ();
+	fSlack = 2.0 * gfBlurPos;
+
+	for (k = 0; k < 3; ++k)
+	{
+		nLo[k] = VertexCell (pOV->Vertex[k] - fSlack, fScale);
+		nHi[k] = VertexCell (pOV->Vertex[k] + fSlack, fScale);
+	}
+
+	pFound = NULL;
+
+	for (nX = nLo[0]; nX <= nHi[0]; ++nX)
+	{
+		for (nY = nLo[1]; nY <= nHi[1]; ++nY)
+		{
+			for (nZ = nLo[2]; nZ <= nHi[2]; ++nZ)
+			{
+				pDLVertexData = ListFindKeyedItem (pMesh->Vertices, 0, 
+												   VertexCellKey (nX, nY, nZ),
+												   FindIdenticalVertex, (sgl_uint32) pOV);
+
+				/* keep the first in the list, as ListFindItem would */
+				if (pDLVertexData && (!pFound || (pDLVertexData < pFound)))
+				{
+					pFound = pDLVertexData;
+				}
+			}
+		}
+	}
+
+	return (pFound);
+}
+
 /*===========================================
  * Function:    AddEdgeToAdjacencyInfo
  *===========================================
@@ -1437,6 +1561,185 @@ static int set_face_data (PMESH_NODE_STRUCT pMesh, PFACE pFace, int nNumToAdd, i
 
 } /* set_face_data */
 
+/*===========================================
+ * Function:    FreeCompiledMesh
+ *===========================================
+ *
+ * Scope:	      static to this module
+ *
+ * Purpose:	  Throws away the compiled (structure of arrays) form of a
+ *				  mesh, so the renderer uses pVertexData and the faces.
+ *
+ * Params:	    PMESH_NODE_STRUCT pMesh
+ *
+ * Return:	    void
+ *========================================================================================*/
+static void FreeCompiledMesh (PMESH_NODE_STRUCT pMesh)
+{
+	if (pMesh->pCompiled)
+	{
+		SGLFree (pMesh->pCompiled);
+		pMesh->pCompiled = NULL;
+	}
+}
+
+/*===========================================
+ * Function:    CompileMesh
+ *===========================================
+ *
+ * Scope:	      static to this module
+ *
+ * Purpose:	  Builds the compiled form of a mesh (see dlmesh.h): vertex
+ *				  positions, normals and UVs, and face planes. The normals
+ *				  and UVs come from the vertex list, so this must be done
+ *				  before an anonymous mesh's lists are thrown away. If
+ *				  there isn't the memory the mesh is left without it,
+ *				  which only costs speed.
+ *
+ * Params:	    PMESH_NODE_STRUCT pMesh
+ *
+ * Return:	    void
+ *========================================================================================*/
+static void CompileMesh (PMESH_NODE_STRUCT pMesh)
+{
+	int				k, nVertices, nFaces, nVPad, nFPad, nListed;
+	sgl_uint32		uSize;
+	PCOMPILED_MESH_STRUCT pC;
+	PVERTEX			pV;
+	PDLVERTEXDATA	pDLVertexData;
+	PFACE			pFace;
+	float			*pf;
+
+	FreeCompiledMesh (pMesh);
+
+	nVertices = pMesh->nVertices;
+	nFaces = pMesh->Faces ? ListGetItemsInList (pMesh->Faces) : 0;
+
+	if ((nVertices == 0) || (nFaces == 0) || (pMesh->pVertexData == NULL))
+	{
+		return;
+	}
+
+	nVPad = (nVertices + COMPILED_MESH_PAD - 1) & ~(COMPILED_MESH_PAD - 1);
+	nFPad = (nFaces + COMPILED_MESH_PAD - 1) & ~(COMPILED_MESH_PAD - 1);
+
+	/*
+	// 8 floats and the flags a vertex, 3 floats and the vertex ID a face
+	*/
+	uSize = sizeof (COMPILED_MESH_STRUCT) + 
+			nVPad * (8 * sizeof (float) + sizeof (sgl_uint32)) +
+			nFPad * (3 * sizeof (float) + sizeof (int));
+
+	pC = SGLMalloc (uSize);
+
+	if (pC == NULL)
+	{
+		DPF ((DBG_WARNING, "CompileMesh: no memory, mesh left uncompiled"));
+		return;
+	}
+
+	pC->nVertices = nVertices;
+	pC->nFaces = nFaces;
+
+	pf = (float *) (pC + 1);
+
+	pC->pfX  = pf;	pf += nVPad;
+	pC->pfY  = pf;	pf += nVPad;
+	pC->pfZ  = pf;	pf += nVPad;
+	pC->pfNX = pf;	pf += nVPad;
+	pC->pfNY = pf;	pf += nVPad;
+	pC->pfNZ = pf;	pf += nVPad;
+	pC->pfU  = pf;	pf += nVPad;
+	pC->pfV  = pf;	pf += nVPad;
+	pC->pfPlaneNX = pf;	pf += nFPad;
+	pC->pfPlaneNY = pf;	pf += nFPad;
+	pC->pfPlaneNZ = pf;	pf += nFPad;
+
+	pC->pu32Flags = (sgl_uint32 *) pf;
+	pC->pnPlaneVertex = (int *) (pC->pu32Flags + nVPad);
+
+	/*
+	// Positions
+	*/
+	pV = pMesh->pVertexData;
+
+	for (k = 0; k < nVertices; ++k, ++pV)
+	{
+		pC->pfX[k] = pV->vVertex[0];
+		pC->pfY[k] = pV->vVertex[1];
+		pC->pfZ[k] = pV->vVertex[2];
+
+		pC->pfNX[k] = pC->pfNY[k] = pC->pfNZ[k] = 0.0f;
+		pC->pfU[k] = pC->pfV[k] = 0.0f;
+		pC->pu32Flags[k] = 0;
+	}
+
+	/*
+	// Normals and UVs. The vertex list is in the same order as
+	// pVertexData.
+	*/
+	nListed = pMesh->Vertices ? ListGetItemsInList (pMesh->Vertices) : 0;
+	ASSERT (nListed <= nVertices);
+
+	pDLVertexData = nListed ? ListFindItemFast (pMesh->Vertices, 0) : NULL;
+
+	for (k = 0; k < nListed; ++k, ++pDLVertexData)
+	{
+		ASSERT (pDLVertexData->pV == pMesh->pVertexData + k);
+
+		if (pDLVertexData->Flags & VERTEX_HAS_NORMAL)
+		{
+			pC->pfNX[k] = pDLVertexData->vNormal[0];
+			pC->pfNY[k] = pDLVertexData->vNormal[1];
+			pC->pfNZ[k] = pDLVertexData->vNormal[2];
+		}
+
+		if (pDLVertexData->Flags & VERTEX_HAS_UV)
+		{
+			pC->pfU[k] = pDLVertexData->v2UV[0];
+			pC->pfV[k] = pDLVertexData->v2UV[1];
+		}
+
+		pC->pu32Flags[k] = pDLVertexData->Flags & (VERTEX_HAS_NORMAL | VERTEX_HAS_UV);
+	}
+
+	for (k = nVertices; k < nVPad; ++k)
+	{
+		pC->pfX[k]  = pC->pfX[nVertices - 1];
+		pC->pfY[k]  = pC->pfY[nVertices - 1];
+		pC->pfZ[k]  = pC->pfZ[nVertices - 1];
+		pC->pfNX[k] = pC->pfNX[nVertices - 1];
+		pC->pfNY[k] = pC->pfNY[nVertices - 1];
+		pC->pfNZ[k] = pC->pfNZ[nVertices - 1];
+		pC->pfU[k]  = pC->pfU[nVertices - 1];
+		pC->pfV[k]  = pC->pfV[nVertices - 1];
+		pC->pu32Flags[k] = pC->pu32Flags[nVertices - 1];
+	}
+
+	/*
+	// Planes
+	*/
+	pFace = ListFindItemFast (pMesh->Faces, 0);
+
+	for (k = 0; k < nFaces; ++k, ++pFace)
+	{
+		pC->pfPlaneNX[k] = pFace->PlaneData.normal[0];
+		pC->pfPlaneNY[k] = pFace->PlaneData.normal[1];
+		pC->pfPlaneNZ[k] = pFace->PlaneData.normal[2];
+		pC->pnPlaneVertex[k] = pFace->pnVertexIDs[0];
+	}
+
+	for (/*Nil*/; k < nFPad; ++k)
+	{
+		pC->pfPlaneNX[k] = pC->pfPlaneNX[nFaces - 1];
+		pC->pfPlaneNY[k] = pC->pfPlaneNY[nFaces - 1];
+		pC->pfPlaneNZ[k] = pC->pfPlaneNZ[nFaces - 1];
+		pC->pnPlaneVertex[k] = pC->pnPlaneVertex[nFaces - 1];
+	}
+
+	pMesh->pCompiled = pC;
+}
+
 
 /*
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -1525,11 +1828,17 @@ void DlCompleteCurrentMesh (void)
 		**		ListGetItemsInList(dlUserGlobals.pCurrentMesh->Edges);
 		*/
 
+		/*
+		// Build the compiled form the renderer reads. This needs the
+		// vertex list, so do it before an anonymous mesh loses it.
+		*/
+		CompileMesh (dlUserGlobals.pCurrentMesh);
+
 		/*
 		// If this is an anonymous mesh, then delete the bits we dont
 		// need for rendering
 		*/
-		if(dlUserGlobals.pCurrentMesh->node_hdr.n16_name == NM_INVALID_NAME)
+		if(dlUserGlobals.pCurrentMesh->node_hdr.n32_name == NM_INVALID_NAME)
 		{
 			/*
 			// We dont need the edge and vertex structures that are used
@@ -1545,6 +1854,10 @@ void DlCompleteCurrentMesh (void)
 
 		}/*end if anonymous*/
 
+		/*
+		// The mesh (and its bounding box) may have changed
+		*/
+		DlInvalidateListBounds (dlUserGlobals.pCurrentMesh->pparent_list);
 
 		/* finished with current mesh - set ptr to NULL */
 
@@ -1575,7 +1888,7 @@ void DlDeleteMeshNodeRefs (DL_NODE_STRUCT *pNode)
 	ASSERT (pMesh);
 	ASSERT (pMesh->node_hdr.n16_node_type == nt_mesh);
 
-	DPF ((DBG_VERBOSE, "deleting mesh structure (name = %d)", pMesh->node_hdr.n16_name));
+	DPF ((DBG_VERBOSE, "deleting mesh structure (name = %d)", pMesh->node_hdr.n32_name));
 
 	/* clean up vertex and nFace lists */
 	
@@ -1593,6 +1906,8 @@ void DlDeleteMeshNodeRefs (DL_NODE_STRUCT *pNode)
 	  pMesh->pVertexData = NULL;
 	}
 
+	FreeCompiledMesh (pMesh);
+
 	if (pMesh->pEdgeData)
 	{
 	  SGLFree (pMesh->pEdgeData);
@@ -1725,6 +2040,8 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 	int nError;
 	MESH_NODE_STRUCT *pMesh;
 
+	DlMarkEdited ();
+
 	if (!gDlMeshInitialised)
 	{
 		DlMeshInitialise ();
@@ -1753,7 +2070,7 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 		// Set up the node header
 		*/
 		pMesh->node_hdr.n16_node_type = nt_mesh;
-		pMesh->node_hdr.n16_name	  = NM_INVALID_NAME;
+		pMesh->node_hdr.n32_name	  = NM_INVALID_NAME;
 
 	#if ENUMERATE_MESHES
 		pMesh->MeshNumber = CurrentMeshNumber;
@@ -1778,6 +2095,10 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 		pMesh->pVertexData = NULL;
 		pMesh->pEdgeData = NULL;
 
+		pMesh->pCompiled = NULL;
+
+		pMesh->pparent_list = NULL;
+
 		pMesh->pTextureData = NULL;
 		pMesh->pShadingData = NULL;
 		pMesh->pPointsData = NULL;
@@ -1824,7 +2145,7 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 				{
 					/* the user wants the name returned */
 
-					pMesh->node_hdr.n16_name = nName;
+					pMesh->node_hdr.n32_name = nName;
 					nError = nName;
 				}
 			}
@@ -1832,7 +2153,7 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 			{
 				/* no name, no error */
 
-				pMesh->node_hdr.n16_name = NM_INVALID_NAME;
+				pMesh->node_hdr.n32_name = NM_INVALID_NAME;
 				nError = sgl_no_err;
 			}
 
@@ -1844,6 +2165,7 @@ int CALL_CONV sgl_create_mesh ( sgl_bool bGenerateName )
 				ASSERT (dlUserGlobals.pCurrentList);
 			
 				AppendNodeToList (dlUserGlobals.pCurrentList, pMesh);
+				pMesh->pparent_list = dlUserGlobals.pCurrentList;
 
 				/* OK, set the current mesh global to point to new one */
 	
@@ -1911,6 +2233,8 @@ void CALL_CONV sgl_delete_mesh ( int nMeshName )
 {
 	int     nError;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 
 	DlCompleteCurrentMesh ();
@@ -1955,7 +2279,7 @@ void CALL_CONV sgl_delete_mesh ( int nMeshName )
 		// is deleted.
 		*/
 		pMesh->node_hdr.n16_node_type = nt_dummy;
-		pMesh->node_hdr.n16_name	  = NM_INVALID_NAME;
+		pMesh->node_hdr.n32_name	  = NM_INVALID_NAME;
 
 		nError = sgl_no_err;
 	}
@@ -1980,6 +2304,8 @@ void CALL_CONV sgl_modify_mesh ( int nMeshName, sgl_bool bClearMesh )
 {
 	int     nError;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 
 	DlCompleteCurrentMesh ();
@@ -2008,6 +2334,12 @@ void CALL_CONV sgl_modify_mesh ( int nMeshName, sgl_bool bClearMesh )
 
 		dlUserGlobals.pCurrentMesh = pMesh;
 
+		/*
+		// The compiled form goes out of date as soon as anything is
+		// changed, so render from the vertex data until it is complete
+		*/
+		FreeCompiledMesh (pMesh);
+
 		if (bClearMesh)
 		{
 			ListDeleteList (&pMesh->Vertices);
@@ -2143,6 +2475,8 @@ void CALL_CONV sgl_set_cull_mode( sgl_cull_mode cull_mode )
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 	int nError= sgl_no_err;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 	CheckCurrentMesh ();
 	if (!pMesh)
@@ -2187,6 +2521,8 @@ void CALL_CONV sgl_add_vertices ( int nNumToAdd, sgl_vector *vVertices,
 	int nError;
 	PMESH_NODE_STRUCT pMesh;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 	CheckCurrentMesh ();
 	pMesh = dlUserGlobals.pCurrentMesh;
@@ -2286,8 +2622,7 @@ void CALL_CONV sgl_add_vertices ( int nNumToAdd, sgl_vector *vVertices,
 				OV.Normal = (vNormals) ? vNormals[k] : NULL;
 				OV.UV = (v2UVs) ? v2UVs[k] : NULL;
 				
-				pDLVertexData = ListFindItem (pMesh->Vertices, 
-											  FindIdenticalVertex, (sgl_uint32) &OV);
+				pDLVertexData = FindVertex (pMesh, &OV);
 
 				if (!pDLVertexData)
 				{
@@ -2380,6 +2715,8 @@ void CALL_CONV sgl_add_face ( int nNumToAdd, int *pnVertexIDs )
 
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 	
 	#if ENUMERATE_MESHES
@@ -2950,6 +3287,8 @@ void CALL_CONV sgl_set_vertex ( int nVertex, sgl_vector vPosition,
 	PFACE pFace;
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 
+	DlMarkEdited ();
+
 	ASSERT (vPosition);
 
 	TidyUpCurrentState ();
@@ -2998,6 +3337,9 @@ void CALL_CONV sgl_set_vertex ( int nVertex, sgl_vector vPosition,
 			/* pDLVertexData->Flags = 0;*/
 
 			memcpy (pDLVertexData->pV->vVertex, vPosition, sizeof (sgl_vector));
+
+			/* it may have moved to another cell of the vertex index */
+			ListReKeyItem (pMesh->Vertices, pDLVertexData);
 			
 			if (vNormal && (pDLVertexData->Flags & VERTEX_HAS_NORMAL))
 			{
@@ -3127,6 +3469,8 @@ void CALL_CONV sgl_set_face ( int nFace, int nNumVertices,
 	int nError;
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 
 	if (!pMesh)
@@ -3236,6 +3580,8 @@ void CALL_CONV sgl_delete_vertex ( int nVertex )
 	int i,k;
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 
+	DlMarkEdited ();
+
 	TidyUpCurrentState ();
 
 	if (!pMesh)
@@ -3349,6 +3695,8 @@ void CALL_CONV sgl_delete_face( int nFace )
 	int nEdgeID;
 	PMESH_NODE_STRUCT pMesh = dlUserGlobals.pCurrentMesh;
 
+	DlMarkEdited ();
+
 
 	TidyUpCurrentState ();
 
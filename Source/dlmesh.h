@@ -192,6 +192,35 @@ typedef struct tagFACE
 				
 } FACE, *PFACE;
 
+/*
+// The compiled form of a mesh: the vertex and face data the renderer
+// reads every frame, a structure of arrays so it can be transformed
+// several at a time. It is one allocation, with the arrays following
+// the struct. Each array is padded to a multiple of COMPILED_MESH_PAD
+// entries with copies of the last real one, so a group of lanes never
+// runs off the end.
+//
+// Vertex normals and UVs are zero (and the flag clear) for vertices
+// that don't have them. The planes are the face normals in model space,
+// with the vertex each one's D is taken from (pnVertexIDs[0]).
+*/
+#define COMPILED_MESH_PAD	8
+
+typedef struct tagCOMPILED_MESH_STRUCT
+{
+	int				nVertices;
+	int				nFaces;
+
+	float			*pfX, *pfY, *pfZ;
+	float			*pfNX, *pfNY, *pfNZ;
+	float			*pfU, *pfV;
+	sgl_uint32		*pu32Flags;			/* VERTEX_HAS_NORMAL, VERTEX_HAS_UV */
+
+	float			*pfPlaneNX, *pfPlaneNY, *pfPlaneNZ;
+	int				*pnPlaneVertex;
+
+} COMPILED_MESH_STRUCT, *PCOMPILED_MESH_STRUCT;
+
 typedef struct tagMESHMATERIAL
 {
 	MATERIAL_NODE_STRUCT    *pMaterial;
@@ -218,6 +247,12 @@ typedef struct
 	*/
 	BBOX_CENT_STRUCT CentBBox;
 
+	/*
+	// Pointer to this nodes parent list, so its bounds can be
+	// invalidated when the mesh is completed
+	*/
+	LIST_NODE_STRUCT * pparent_list;
+
 	/*
 	// Store the polygon culling mode for the mesh
 	*/
@@ -230,6 +265,15 @@ typedef struct
 	PEDGE					pEdgeData;
 	int						nVertices;
 	int						nEdges;
+
+	/*
+	// The compiled form of the mesh (see COMPILED_MESH_STRUCT). Built by
+	// DlCompleteCurrentMesh and freed while the mesh is being edited;
+	// NULL if there isn't one, in which case pVertexData and the face
+	// list are used.
+	*/
+	COMPILED_MESH_STRUCT	*pCompiled;
+
 	/* 
 	// these are all pointers to lists (list.h) 
 	*/
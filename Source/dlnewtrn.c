@@ -46,6 +46,8 @@ void CALL_CONV sgl_new_translucent()
 {
 	NTRAN_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -75,7 +77,7 @@ void CALL_CONV sgl_new_translucent()
    	} 
 
 	pNode->node_hdr.n16_node_type = (sgl_int16) nt_newtran;
-	pNode->node_hdr.n16_name	  = (sgl_int16) NM_INVALID_NAME;
+	pNode->node_hdr.n32_name	  = (sgl_int32) NM_INVALID_NAME;
 	pNode->node_hdr.next_node	  = NULL;
 
 	AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
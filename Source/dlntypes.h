@@ -150,7 +150,7 @@ typedef struct _DL_NODE_STRUCT
 	/*
 	// Optional name.
 	*/
-	sgl_int16 	n16_name;
+	sgl_int32 	n32_name;
 
 
 	struct _DL_NODE_STRUCT * next_node;
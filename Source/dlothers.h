@@ -61,6 +61,12 @@ typedef struct
 	*/
 	TRANSFORM_STRUCT transform;
 
+	/*
+	// Pointer to this nodes parent list, so its bounds can be
+	// invalidated when the transform is changed
+	*/
+	LIST_NODE_STRUCT * pparent_list;
+
 } TRANSFORM_NODE_STRUCT;
 
 
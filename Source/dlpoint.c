@@ -143,14 +143,14 @@ void DlDeletePointNodeRefs(DL_NODE_STRUCT *pNodeHdr)
 		// --------------------------
 		*/
 		ASSERT(pPointNode->ppoint_position->point_name ==
-		  pPointNode->node_hdr.n16_name);
+		  pPointNode->node_hdr.n32_name);
 
 		/*
 		// ------------------------------
 		// Unregister and clear reference
 		// ------------------------------
 		*/
-		DecNamedItemUsage(dlUserGlobals.pNamtab,pPointNode->node_hdr.n16_name);
+		DecNamedItemUsage(dlUserGlobals.pNamtab,pPointNode->node_hdr.n32_name);
 		pPointNode->ppoint_position->point_name = NM_INVALID_NAME;
 	}
 }
@@ -226,8 +226,8 @@ void DlDeletePointSwitchNodeRefs(DL_NODE_STRUCT *pNodeHdr)
 	// Unregister reference to point node
 	// ----------------------------------
 	*/
-	ASSERT(pSwitchNode->n16_point_name != NM_INVALID_NAME);
-	DecNamedItemUsage(dlUserGlobals.pNamtab, pSwitchNode->n16_point_name);
+	ASSERT(pSwitchNode->n32_point_name != NM_INVALID_NAME);
+	DecNamedItemUsage(dlUserGlobals.pNamtab, pSwitchNode->n32_point_name);
 }
 
 
@@ -257,6 +257,8 @@ int CALL_CONV sgl_create_point( sgl_vector offset,
 	*/
     POINT_NODE_STRUCT *pPointNode;
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -280,9 +282,9 @@ int CALL_CONV sgl_create_point( sgl_vector offset,
 	}
 
     pPointNode->node_hdr.n16_node_type = nt_point;
-    pPointNode->node_hdr.n16_name =
+    pPointNode->node_hdr.n32_name =
       AddNamedItem(dlUserGlobals.pNamtab, pPointNode, nt_point);
-    if (pPointNode->node_hdr.n16_name == sgl_err_no_name)
+    if (pPointNode->node_hdr.n32_name == sgl_err_no_name)
     {
 	    SGLFree(pPointNode);
 		return SglError(sgl_err_no_name);
@@ -304,7 +306,7 @@ int CALL_CONV sgl_create_point( sgl_vector offset,
 	// Return
 	// ------
 	*/
-    return SglError(pPointNode->node_hdr.n16_name);
+    return SglError(pPointNode->node_hdr.n32_name);
 }
 
 
@@ -323,6 +325,8 @@ void CALL_CONV sgl_set_point( int nName, sgl_vector offset,
 {
     POINT_NODE_STRUCT *pPointNode;
 
+	DlMarkEdited ();
+
     /*
 	// ----------
 	// Initialise
@@ -383,6 +387,8 @@ void CALL_CONV sgl_switch_point( int nName, sgl_bool bEnableCheck )
     POINT_NODE_STRUCT *pPointNode;
 #endif
 
+	DlMarkEdited ();
+
 #if !WIN32
     if (SglInitialise())
 	{
@@ -414,16 +420,16 @@ void CALL_CONV sgl_switch_point( int nName, sgl_bool bEnableCheck )
 #if DEBUG
     pPointNode = GetNamedItem(dlUserGlobals.pNamtab, nName);
 	ASSERT(pPointNode->node_hdr.n16_node_type == nt_point);
-	ASSERT(pPointNode->node_hdr.n16_name == nName);
+	ASSERT(pPointNode->node_hdr.n32_name == nName);
 #endif
 
 	/*
 	// Set the stored values in the node appropriately
 	*/
 	pSwitchNode->node_hdr.n16_node_type = nt_point_switch;
-	pSwitchNode->node_hdr.n16_name		= NM_INVALID_NAME;
+	pSwitchNode->node_hdr.n32_name		= NM_INVALID_NAME;
 
-	pSwitchNode->n16_point_name	= nName;
+	pSwitchNode->n32_point_name	= nName;
 
 	/* The following guarantees it fits in 16 bits) */
 	pSwitchNode->n16_enable_check = (bEnableCheck != 0);
@@ -464,6 +470,8 @@ void CALL_CONV sgl_position_point( int nName )
     POINT_POSITION_NODE_STRUCT *pPosNode;
     POINT_NODE_STRUCT          *pPointNode;
 
+	DlMarkEdited ();
+
     /*
 	// ----------
 	// Initialise
@@ -503,7 +511,7 @@ void CALL_CONV sgl_position_point( int nName )
 	// Fill in the header info (type and "unused" name):
 	*/
     pPosNode->node_hdr.n16_node_type = nt_point_pos;
-    pPosNode->node_hdr.n16_name		 = NM_INVALID_NAME;
+    pPosNode->node_hdr.n32_name		 = NM_INVALID_NAME;
 
     pPosNode->point_name = nName;
 
@@ -617,7 +625,7 @@ int CALL_CONV sgl_query_point( int nName, sgl_vector position,
 		{
 			int nItem;
 
-			pCollisionData->object_name = (int)pPointNode->n16ObjectName;
+			pCollisionData->object_name = (int)pPointNode->n32ObjectName;
 
 			ASSERT(pPointNode->n16ObjectPlane >= 0);
 			pCollisionData->object_plane = pPointNode->n16ObjectPlane;
@@ -630,7 +638,7 @@ int CALL_CONV sgl_query_point( int nName, sgl_vector position,
 			ASSERT(pPointNode->n16PathLength <= SGL_MAX_PATH);
 			for (nItem = 0; nItem < pPointNode->n16PathLength; nItem++)
 			{
-				pCollisionData->path[nItem] = (int)pPointNode->pn16Path[nItem];
+				pCollisionData->path[nItem] = (int)pPointNode->pn32Path[nItem];
 			}
 			pCollisionData->path_length = pPointNode->n16PathLength;
 		}
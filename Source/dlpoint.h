@@ -68,7 +68,7 @@ typedef struct
 	// The name of the positioned point.  This is needed in case we delete
 	// the position information and we have to refer back to the point.
 	*/
-	sgl_int16 point_name;
+	sgl_int32 point_name;
 
 	/*
 	// Pointer to this nodes parent list, so that we can backtrack up the
@@ -125,11 +125,11 @@ typedef struct
 	*/
 	sgl_vector	position;  /* 3D position relative to origin (not camera) */
 	sgl_int16	n16Collision;  /* boolean: Whether or not hit in this render */
-	sgl_int16	n16ObjectName;
+	sgl_int32	n32ObjectName;
 	sgl_int16	n16ObjectPlane;
 	sgl_vector	normal;
 	float		fD;
-	sgl_int16	pn16Path[SGL_MAX_PATH]; /* high SGL_MAX_PATH will consume RAM */
+	sgl_int32	pn32Path[SGL_MAX_PATH]; /* high SGL_MAX_PATH will consume RAM */
 	sgl_int16	n16PathLength;
 
 } POINT_NODE_STRUCT;
@@ -147,12 +147,11 @@ typedef struct
 	// NOTE: If the corresponding point node is deleted this value will not be
 	// changed, though the name will not be reused until this node is deleted.
 	*/
-	sgl_int16 n16_point_name;
+	sgl_int32 n32_point_name;
 
 	/*
 	// Set whether we are enabling or disabling collision detection.
-	// This is effectively a BOOL, but we'll pack it into 16 bits so hopefully
-	// it will abut the point name above.
+	// This is effectively a BOOL, packed into 16 bits.
 	*/
 	sgl_int16 n16_enable_check;
 
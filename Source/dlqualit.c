@@ -138,7 +138,7 @@ static void QualSet( const QUAL_ENUM WhatToSet,
 	// Set the header details
 	*/
 	pNode->node_hdr.n16_node_type = nt_quality;
-	pNode->node_hdr.n16_name	  = NM_INVALID_NAME;
+	pNode->node_hdr.n32_name	  = NM_INVALID_NAME;
 
 
 	/*
@@ -176,6 +176,8 @@ static void QualSet( const QUAL_ENUM WhatToSet,
  **************************************************************************/
 void CALL_CONV sgl_qual_texture_filter(const sgl_texture_filter_type eFilterType)
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_TEXTURE_FILTERING, FALSE, FALSE, eFilterType);
 }
 
@@ -193,6 +195,8 @@ void CALL_CONV sgl_qual_texture_filter(const sgl_texture_filter_type eFilterType
  **************************************************************************/
 void CALL_CONV sgl_qual_dither(const sgl_bool enable)
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_DITHERING, enable, FALSE, (sgl_texture_filter_type)0);
 }
 
@@ -211,6 +215,8 @@ void CALL_CONV sgl_qual_dither(const sgl_bool enable)
  **************************************************************************/
 void CALL_CONV sgl_qual_smooth_shading( const sgl_bool enable )
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_SMOOTH_SHAD, enable, FALSE, (sgl_texture_filter_type)0);
 }
 
@@ -228,6 +234,8 @@ void CALL_CONV sgl_qual_smooth_shading( const sgl_bool enable )
  **************************************************************************/
 void CALL_CONV sgl_qual_texturing(const sgl_bool enable )
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_TEXTURE, enable, FALSE, (sgl_texture_filter_type)0);
 }
 
@@ -244,6 +252,8 @@ void CALL_CONV sgl_qual_texturing(const sgl_bool enable )
  **************************************************************************/
 void CALL_CONV sgl_qual_generate_shadows( const sgl_bool enable )
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_SHADOWS, enable, FALSE, (sgl_texture_filter_type)0);
 }
 
@@ -260,6 +270,8 @@ void CALL_CONV sgl_qual_generate_shadows( const sgl_bool enable )
  **************************************************************************/
 void CALL_CONV sgl_qual_fog( const sgl_bool enable )
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_FOG, enable, FALSE, (sgl_texture_filter_type)0);
 }
 
@@ -278,6 +290,8 @@ void CALL_CONV sgl_qual_fog( const sgl_bool enable )
 void CALL_CONV sgl_qual_collision_detection( const sgl_bool enable,
 											 const sgl_bool enable_offscreen )
 {
+	DlMarkEdited ();
+
 	QualSet(QFE_COLLISIONS, enable, enable_offscreen, (sgl_texture_filter_type)0);
 }
 
@@ -773,11 +773,13 @@ void InitTransformNode(TRANSFORM_NODE_STRUCT * pTranNode,int name)
 {
 
 	pTranNode->node_hdr.n16_node_type = (sgl_int16) nt_transform;
-	pTranNode->node_hdr.n16_name	  = (sgl_int16) name;
+	pTranNode->node_hdr.n32_name	  = (sgl_int32) name;
 	pTranNode->node_hdr.next_node	  = NULL;
 
 	SetIdentityMatrix(&(pTranNode->transform));
 
+	pTranNode->pparent_list = NULL;
+
 }
 
 
@@ -806,6 +808,8 @@ int	CALL_CONV sgl_create_transform( sgl_bool generate_name )
 
 	TRANSFORM_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -879,6 +883,7 @@ int	CALL_CONV sgl_create_transform( sgl_bool generate_name )
 	InitTransformNode(pNode, name);
 
 	AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
+	pNode->pparent_list = dlUserGlobals.pCurrentList;
 
 
 	/* Newly created transform node becomes the current transform */
@@ -912,6 +917,8 @@ void CALL_CONV sgl_modify_transform( int name, sgl_bool clear_transform )
 
 	TRANSFORM_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -952,7 +959,10 @@ void CALL_CONV sgl_modify_transform( int name, sgl_bool clear_transform )
 	/*	reset the transformation if requested */
 
 	if (clear_transform)
+	{
 		SetIdentityMatrix(&(pNode->transform));
+		DlInvalidateListBounds(pNode->pparent_list);
+	}
 
 
 	/* the named transform becomes the current transform */
@@ -985,6 +995,8 @@ void CALL_CONV sgl_translate( float x, float y, float z )
 {
 	TRANSFORM_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1023,6 +1035,7 @@ void CALL_CONV sgl_translate( float x, float y, float z )
 		InitTransformNode(pNode, NM_INVALID_NAME);
 
 		AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
+		pNode->pparent_list = dlUserGlobals.pCurrentList;
 
 
 		/* Newly created transform node becomes the current transform */
@@ -1032,6 +1045,7 @@ void CALL_CONV sgl_translate( float x, float y, float z )
 
 
 	Translate(x, y, z, &(dlUserGlobals.pCurrentTransform->transform));
+	DlInvalidateListBounds(dlUserGlobals.pCurrentTransform->pparent_list);
 
 	SglError(sgl_no_err);
 
@@ -1045,6 +1059,8 @@ void CALL_CONV sgl_scale( float x, float y, float z )
 
 	TRANSFORM_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1083,6 +1099,7 @@ void CALL_CONV sgl_scale( float x, float y, float z )
 		InitTransformNode(pNode, NM_INVALID_NAME);
 
 		AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
+		pNode->pparent_list = dlUserGlobals.pCurrentList;
 
 
 		/* Newly created transform node becomes the current transform */
@@ -1094,6 +1111,7 @@ void CALL_CONV sgl_scale( float x, float y, float z )
 
 
    	Scale(x, y, z, &(pNode->transform));
+	DlInvalidateListBounds(pNode->pparent_list);
 
 	SglError(sgl_no_err);
 
@@ -1105,6 +1123,8 @@ void CALL_CONV sgl_rotate( sgl_vector axis, float angle )
 {
 	TRANSFORM_NODE_STRUCT * pNode;
 
+	DlMarkEdited ();
+
 	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1143,6 +1163,7 @@ void CALL_CONV sgl_rotate( sgl_vector axis, float angle )
 		InitTransformNode(pNode, NM_INVALID_NAME);
 
 		AppendNodeToList(dlUserGlobals.pCurrentList, pNode);
+		pNode->pparent_list = dlUserGlobals.pCurrentList;
 
 
 		/* Newly created transform node becomes the current transform */
@@ -1153,6 +1174,7 @@ void CALL_CONV sgl_rotate( sgl_vector axis, float angle )
 		pNode = dlUserGlobals.pCurrentTransform;
 
 	Rotate(axis,angle,&(pNode->transform));
+	DlInvalidateListBounds(pNode->pparent_list);
 
 	SglError(sgl_no_err);
 }
@@ -46,66 +46,66 @@ typedef	void (*PACKFLAT) (PITRI, PIMATERIAL, int);
 PACKFLAT PackFlat = PackFlatAndStore;
 
 
-static void PackTriHigh (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHigh (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHigh (gpTri, gpMat, nPolys, 4, pTSP);
+	PackTSPHigh (pTri, pMat, nPolys, 4, pTSP);
 }
 
 
-static void PackTriFlatTex (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTex (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
 	/* Call either PackFlatAndStore() or PackFlatDecalAndStore() depending
 	 * on whether DECAL selected.
 	 */
-	PackFlat (gpTri, gpMat, nPolys);
+	PackFlat (pTri, pMat, nPolys);
 
 	SGL_TIME_START(TEXTURE_TIME)
 
-	PackTSPTexFn (gpMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
 
 	SGL_TIME_STOP(TEXTURE_TIME)
 
 }
 
-static void PackTriHighTex (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTex (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
 	/* Call either PackFlatAndStore() or PackFlatDecalAndStore() depending
 	 * on whether DECAL selected.
 	 */
-	PackFlat (gpTri, gpMat, nPolys);
+	PackFlat (pTri, pMat, nPolys);
 
 	SGL_TIME_START(TEXTURE_TIME)
 
-	PackTSPTexFn (gpMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
 
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriSmooth (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmooth (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmooth (gpTri, gpMat, nPolys, 4, 0, pTSP);
+	PackTSPSmooth (pTri, pMat, nPolys, 4, 0, pTSP);
 }
 
-static void PackTriNativeSmooth (sgl_uint32 *pTSP, int nPolys)
+static void PackTriNativeSmooth (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmooth (gpTri, gpMat, nPolys, 4, 0, pTSP);
+	PackTSPSmooth (pTri, pMat, nPolys, 4, 0, pTSP);
 }
 
-static void PackTriSmoothTex (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothTex (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackSmoothAndStore (gpTri, gpMat, nPolys);
+	PackSmoothAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
 
-	PackTSPTexFn (gpMat, nPolys, SMOOTHTEX, 10, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, SMOOTHTEX, 10, pTSP, sizeof(IMATERIAL));
 
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriNativeSmoothTex (sgl_uint32 *pTSP, int nPolys)
+static void PackTriNativeSmoothTex (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackSmoothAndStore (gpTri, gpMat, nPolys);
+	PackSmoothAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, SMOOTHTEX, 10, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, SMOOTHTEX, 10, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
@@ -115,43 +115,43 @@ static void PackTriNativeSmoothTex (sgl_uint32 *pTSP, int nPolys)
 // ============================================================================
 */
 
-static void PackTriFlatShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPFlatShad (gpTri, gpMat, nPolys, 2, pTSP);
+	PackTSPFlatShad (pTri, pMat, nPolys, 2, pTSP);
 }
 
-static void PackTriHighShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHighShad (gpTri, gpMat, nPolys, 4, pTSP);
+	PackTSPHighShad (pTri, pMat, nPolys, 4, pTSP);
 }
 
-static void PackTriFlatTexShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTexShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackFlatShadAndStore (gpTri, gpMat, nPolys);
+	PackFlatShadAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriHighTexShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTexShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackFlatShadAndStore (gpTri, gpMat, nPolys);
+	PackFlatShadAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriSmoothShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmoothShad (gpTri, gpMat, nPolys, 6, 0, pTSP);
+	PackTSPSmoothShad (pTri, pMat, nPolys, 6, 0, pTSP);
 }
 
-static void PackTriSmoothTexShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothTexShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackSmoothShadAndStore (gpTri, gpMat, nPolys);
+	PackSmoothShadAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
 
-	PackTSPTexFn (gpMat, nPolys, SMOOTHSHADTEX, 12, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, SMOOTHSHADTEX, 12, pTSP, sizeof(IMATERIAL));
 
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
@@ -162,42 +162,42 @@ static void PackTriSmoothTexShad (sgl_uint32 *pTSP, int nPolys)
 // ============================================================================
 */
 
-static void PackTriFlatLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPFlatLiVol (gpTri, gpMat, nPolys, 2, pTSP);
+	PackTSPFlatLiVol (pTri, pMat, nPolys, 2, pTSP);
 }
 
-static void PackTriHighLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHighLiVol (gpTri, gpMat, nPolys, 4, pTSP);
+	PackTSPHighLiVol (pTri, pMat, nPolys, 4, pTSP);
 }
 
-static void PackTriFlatTexLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTexLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackFlatLiVolAndStore (gpTri, gpMat, nPolys);
+	PackFlatLiVolAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, FLATTEX, 8, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriHighTexLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTexLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackFlatLiVolAndStore (gpTri, gpMat, nPolys);
+	PackFlatLiVolAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, HIGHTEX, 10, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
-static void PackTriSmoothLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmoothLiVol (gpTri, gpMat, nPolys, 6, 0, pTSP);
+	PackTSPSmoothLiVol (pTri, pMat, nPolys, 6, 0, pTSP);
 }
 
-static void PackTriSmoothTexLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothTexLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackSmoothLiVolAndStore (gpTri, gpMat, nPolys);
+	PackSmoothLiVolAndStore (pTri, pMat, nPolys);
 	SGL_TIME_START(TEXTURE_TIME)
-	PackTSPTexFn (gpMat, nPolys, SMOOTHSHADTEX, 12, pTSP, sizeof(IMATERIAL));
+	PackTSPTexFn (pMat, nPolys, SMOOTHSHADTEX, 12, pTSP, sizeof(IMATERIAL));
 	SGL_TIME_STOP(TEXTURE_TIME)
 }
 
@@ -213,47 +213,47 @@ static void PackTriSmoothTexLiVol (sgl_uint32 *pTSP, int nPolys)
 // ============================================================================
 */
 
-static void PackTriFlatTrans (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTrans (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPFlatTrans (gpTri, gpMat, nPolys, 8, pTSP);
+	PackTSPFlatTrans (pTri, pMat, nPolys, 8, pTSP);
 }
 
 
-static void PackTriSmoothTrans (sgl_uint32 *pTSP, int nPolys)
+static void PackTriSmoothTrans (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmooth (gpTri, gpMat, nPolys, 10, 6, pTSP);
-	PackTSPTransTex (gpTri, gpMat, nPolys, -2, 10, pTSP + 2);
+	PackTSPSmooth (pTri, pMat, nPolys, 10, 6, pTSP);
+	PackTSPTransTex (pTri, pMat, nPolys, -2, 10, pTSP + 2);
 }
 
-static void PackTriNativeSmoothTrans (sgl_uint32 *pTSP, int nPolys)
+static void PackTriNativeSmoothTrans (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPSmooth (gpTri, gpMat, nPolys, 10, 6, pTSP);
-	PackTSPTransTex (gpTri, gpMat, nPolys, -2, 10, pTSP + 2);
+	PackTSPSmooth (pTri, pMat, nPolys, 10, 6, pTSP);
+	PackTSPTransTex (pTri, pMat, nPolys, -2, 10, pTSP + 2);
 }
 
-static void PackTriHighTrans (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTrans (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHighTrans (gpTri, gpMat, nPolys, 10, pTSP);
+	PackTSPHighTrans (pTri, pMat, nPolys, 10, pTSP);
 }
 
-static void PackTriFlatTransShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTransShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPFlatTransShad (gpTri, gpMat, nPolys, 8, pTSP);
+	PackTSPFlatTransShad (pTri, pMat, nPolys, 8, pTSP);
 }
 
-static void PackTriHighTransShad (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTransShad (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHighTransShad (gpTri, gpMat, nPolys, 10, pTSP);
+	PackTSPHighTransShad (pTri, pMat, nPolys, 10, pTSP);
 }
 
-static void PackTriFlatTransLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriFlatTransLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPFlatTransLiVol (gpTri, gpMat, nPolys, 8, pTSP);
+	PackTSPFlatTransLiVol (pTri, pMat, nPolys, 8, pTSP);
 }
 
-static void PackTriHighTransLiVol (sgl_uint32 *pTSP, int nPolys)
+static void PackTriHighTransLiVol (PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys)
 {
-	PackTSPHighTransLiVol (gpTri, gpMat, nPolys, 10, pTSP);
+	PackTSPHighTransLiVol (pTri, pMat, nPolys, 10, pTSP);
 }
 
 
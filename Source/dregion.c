@@ -435,6 +435,7 @@
 #include "pvrosapi.h"
 #include "parmbuff.h"
 #include "sglmem.h"
+#include "sglthrd.h"
 
 SGL_EXTERN_TIME_REF /* if we are timing code */
 
@@ -698,24 +699,73 @@ static REGION_STRIP_EXTRA RegionStripExtra[(MAX_Y_RESOLUTION/2)+1];
 /* We can use the following mask to aid object merging in AddRegionObjects */
 static sgl_uint32 SigXYMask;
 
-/* To combine OPAQUE objects we use this per frame identifier */
-static sgl_uint32 OpaqueId;
-static sgl_uint32 TransOpaqueId;
-
 /* To comprehend the screen and tile sizes we retrieve RegionInfo */
 DEVICE_REGION_INFO_STRUCT RegionInfo;
 
-/* We must globally allocate CurrentTransSetId to control set formation */
-static sgl_uint32 CurrentTransSetId[2];
-
 /* As we go along we may build up some free STRIPs */
 static REGION_STRIP *FreeRegionStrip;
 
-/* OBJECT_BLOCKs can be reused via the permanent Chunk header list */
-static sgl_uint32 **FreeObjChunk, *AllChunkHdrs;
+/************************************************************************
+
+	Objects may be added from several threads at once (see RegionBinsBegin)
+	so everything the Add routines allocate or count with lives in a
+	REGION_ARENA, one per pool thread. Serial code only ever uses the first.
+
+	While binning, each thread adds into REGION_BINs rather than into the
+	real strips. A bin shadows the REGION_HEADERs of each strip it touches
+	and the bins are merged back in order before any output is generated.
+
+************************************************************************/
+
+typedef struct _region_bin_strip {
+	REGION_HEADER *Regions;				/* Shadows pStrip->Regions		*/
+	int nRegions;						/* Room in Regions, follows us	*/
+	REGION_STRIP *pStrip;				/* Real strip these belong to	*/
+	int YBase;							/* BaseOfStrips[] of that strip	*/
+	struct _region_bin_strip *pNext;	/* Touched or free list link	*/
+} REGION_BIN_STRIP;
+
+typedef struct _region_bin {
+	REGION_BIN_STRIP *pStrips[(MAX_Y_RESOLUTION/2)+1]; /* By YBase		*/
+	REGION_BIN_STRIP *pTouched;			/* Strips with objects in them	*/
+	struct _region_arena *pArena;		/* Arena that filled the bin	*/
+} REGION_BIN;
+
+typedef struct _region_arena {
+	/* OBJECT_BLOCKs can be reused via the permanent Chunk header list */
+	sgl_uint32 **FreeObjChunk, *AllChunkHdrs;
+
+	/* TRANSFACE_LISTs are allocated from an OBJECT_BLOCK */
+	TRANSFACE_LIST *pNextTransFace;
+
+	/* To combine OPAQUE objects we use this per frame identifier */
+	sgl_uint32 OpaqueId;
+	sgl_uint32 TransOpaqueId;
+
+	/* CurrentTransSetId controls set formation */
+	sgl_uint32 CurrentTransSetId[2];
+
+	REGION_BIN *pBin;					/* Bin being filled, or NULL	*/
+	REGION_BIN_STRIP *pFreeBinStrips;	/* Recycled bin strips			*/
+} REGION_ARENA;
+
+static REGION_ARENA RegionArenas[SGL_MAX_THREADS];
+
+/* Bins waiting to be merged, in submission order */
+static REGION_BIN *pRegionBins;
+static int nRegionBins, nRegionBinsAlloc, nRegionBinBase;
 
-/* TRANSFACE_LISTs are allocated from an OBJECT_BLOCK */
-static TRANSFACE_LIST *pNextTransFace;
+/* TRUE while pool threads may be adding objects */
+static sgl_bool bRegionBinning;
+
+/* Arena for the calling thread */
+#define CURRENT_ARENA() \
+	( bRegionBinning ? &RegionArenas[SglThreadIndex()] : RegionArenas )
+
+/* Each bin forms its own translucent sets, well clear of serial ids.
+   With at most MAX_REGION_BINS pending the ids stay below 0x60000000 */
+#define MAX_REGION_BINS			512
+#define BIN_TRANS_SET_ID(nBin) (0x40000000UL + (((sgl_uint32) (nBin)) << 20))
 
 /* Special object addresses or pointers */
 static sgl_uint32 DummyObjData = ULONG_MAX;
@@ -877,7 +927,8 @@ static INLINE REGION_STRIP *AllocRegionStrip( int YBase, int Height, int Width )
 	return (pStrip);
 }
 
-static void AllocObjectChunk( void );
+static void AllocObjectChunk( REGION_ARENA *pArena );
+static void ReleaseRegionBins( sgl_bool bMerge, sgl_bool bShortAtmos );
 
 /**************************************************************************
  * Function Name  : InitRegionDataL
@@ -891,11 +942,13 @@ static void AllocObjectChunk( void );
  **************************************************************************/
 void InitRegionDataL()
 {
+	REGION_ARENA *pArena = RegionArenas;
+
 	/* Reset all globals */
-	CurrentTransSetId[0] = 0;
-	CurrentTransSetId[1] = 1;
+	pArena->CurrentTransSetId[0] = 0;
+	pArena->CurrentTransSetId[1] = 1;
 	FreeRegionStrip		 = NULL;
-	pNextTransFace       = NULL;
+	pArena->pNextTransFace = NULL;
 	OutputHeight         = 0;
 	RegionXMagic         = 32;
 	MaxHeight			 = 0;
@@ -903,15 +956,18 @@ void InitRegionDataL()
 	MergeHeight			 = 0;
 	LastTileLimit        = 0;
 	SigXYMask            = (sgl_uint32) ~0;
-	OpaqueId             = 0;
-	TransOpaqueId        = 0;
+	pArena->OpaqueId     = 0;
+	pArena->TransOpaqueId = 0;
+	pArena->pBin         = NULL;
+	bRegionBinning       = FALSE;
+	nRegionBins          = 0;
 	memset( &pRegionStrips, 0, sizeof(pRegionStrips) );
 	memset( &BaseOfStrips, 0, sizeof(BaseOfStrips) );
 	memset( &RegionInfo, 0, sizeof(DEVICE_REGION_INFO_STRUCT) );
 
 	/* We need at least one chunk's worth of space to simplify startup */
-	FreeObjChunk = &AllChunkHdrs;
-	AllocObjectChunk();
+	pArena->FreeObjChunk = &pArena->AllChunkHdrs;
+	AllocObjectChunk( pArena );
 
 }
 
@@ -1228,20 +1284,37 @@ else
 			}
 		}
 
-		/* Reset translucent set counter */
-		CurrentTransSetId[0] = 0;
-		CurrentTransSetId[1] = 1;
+		for ( YReg = 0; YReg < SGL_MAX_THREADS; YReg++ )
+		{
+			REGION_ARENA *pArena = &RegionArenas[YReg];
+
+			/* Reset translucent set counter */
+			pArena->CurrentTransSetId[0] = 0;
+			pArena->CurrentTransSetId[1] = 1;
+
+			if ( pArena->AllChunkHdrs != NULL )
+			{
+				/* Recycle all OBJECT_BLOCKs */
+				pArena->FreeObjChunk = (sgl_uint32 **) pArena->AllChunkHdrs;
+			}
 
-		/* Recycle all OBJECT_BLOCKs */
-		FreeObjChunk = (sgl_uint32 **) AllChunkHdrs;
+			/* Reset TRANSFACE_LIST allocator too */
+			pArena->pNextTransFace = NULL;
+		}
+	}
 
-		/* Reset TRANSFACE_LIST allocator too */
-		pNextTransFace = NULL;
+	/* Anything still binned belonged to the last frame */
+	if ( nRegionBins != 0 )
+	{
+		ReleaseRegionBins( FALSE, FALSE );
 	}
 
-	/* Always set OpaqueId to a value unlikely to match an ISPAddr later */
-	OpaqueId =		0x80000000;
-	TransOpaqueId = 0x80000000;
+	for ( YReg = 0; YReg < SGL_MAX_THREADS; YReg++ )
+	{
+		/* Always set OpaqueId to a value unlikely to match an ISPAddr later */
+		RegionArenas[YReg].OpaqueId =		0x80000000;
+		RegionArenas[YReg].TransOpaqueId = 0x80000000;
+	}
    	
 	if ( CurrentMinHeight > MinHeight )
 	{
@@ -1340,7 +1413,7 @@ int MaxRegionWidth( void )
 
 /**************************************************************************
  * Function Name  : AllocObjectChunk
- * Inputs         : NONE
+ * Inputs         : pArena - arena to extend
  * Outputs        : NONE
  * Input/Output	  : NONE
  * Returns        : NONE
@@ -1355,7 +1428,7 @@ struct _object_chunk {
 	OBJECT_BLOCK Blocks[BLOCKS_PER_CHUNK+1];
 };
 
-static void AllocObjectChunk( void )
+static void AllocObjectChunk( REGION_ARENA *pArena )
 {
 	sgl_uint8 *pData = (sgl_uint8 *) NEW(struct _object_chunk);	/* Never returns NULL */
 	OBJECT_BLOCK *pBlock, *pEnd;
@@ -1394,13 +1467,14 @@ static void AllocObjectChunk( void )
 	while ( ++pBlock != pEnd );
 
 	/* Extend free list and set next free */
-	*FreeObjChunk = pChunkHdr;
-	FreeObjChunk = (sgl_uint32 **) pChunkHdr;
+	*pArena->FreeObjChunk = pChunkHdr;
+	pArena->FreeObjChunk = (sgl_uint32 **) pChunkHdr;
 }
 
 /**************************************************************************
  * Function Name  : AllocObjectBlock
- * Inputs         : rpLastSlot - Pointer to FULL block in current list
+ * Inputs         : pArena     - arena of the calling thread
+ *                : rpLastSlot - Pointer to FULL block in current list
  *                : Entry     - We need the space to store this entry
  * Outputs        : NONE
  * Input/Output	  : NONE
@@ -1408,23 +1482,24 @@ static void AllocObjectChunk( void )
  * Globals Used   : FreeObjChunk
  * Description    : Called when an OBJECT_BLOCK list is to be extended
  **************************************************************************/
-static INLINE sgl_uint32 *AllocObjectBlock( sgl_uint32 **rpLastSlot, sgl_uint32 Entry )
+static INLINE sgl_uint32 *AllocObjectBlock( REGION_ARENA *pArena,
+									sgl_uint32 **rpLastSlot, sgl_uint32 Entry )
 {
-	sgl_uint32 *pBlock = PTR_SET_SUB( FreeObjChunk );
+	sgl_uint32 *pBlock = PTR_SET_SUB( pArena->FreeObjChunk );
 
-	if ( PTR_SET_EMPTY(FreeObjChunk, BLOCKS_PER_CHUNK) )
+	if ( PTR_SET_EMPTY(pArena->FreeObjChunk, BLOCKS_PER_CHUNK) )
 	{
 		/* Don't leave the FreeObjChunk pointer on EMPTY */
 
-		if ( *FreeObjChunk == NULL )
+		if ( *pArena->FreeObjChunk == NULL )
 		{
 			/* Allocate a new chunk of blocks */
-			AllocObjectChunk();
+			AllocObjectChunk( pArena );
 		}
 		else
 		{
 			/* Advance to the next pre-allocated chunk */
-			FreeObjChunk = (sgl_uint32 **) *FreeObjChunk;
+			pArena->FreeObjChunk = (sgl_uint32 **) *pArena->FreeObjChunk;
 		}
 	}
 
@@ -1445,7 +1520,8 @@ static INLINE sgl_uint32 *AllocObjectBlock( sgl_uint32 **rpLastSlot, sgl_uint32
 
 /**************************************************************************
  * Function Name  : AllocTransObjBlock
- * Inputs         : rpLastSlot - By ref. pointer to FULL end of list block
+ * Inputs         : pArena     - arena of the calling thread
+ *                : rpLastSlot - By ref. pointer to FULL end of list block
  *                : Entry      - We need the space to store this entry
  * Outputs        : NONE
  * Input/Output	  : NONE
@@ -1456,18 +1532,19 @@ static INLINE sgl_uint32 *AllocObjectBlock( sgl_uint32 **rpLastSlot, sgl_uint32
  *                  lists provided we reserve the remainder of a new
  *                  OBJECT_BLOCK for further TRANSOBJ_BLOCKs.
  **************************************************************************/
-static INLINE void AllocTransObjBlock( sgl_uint32 **rpLastSlot, sgl_uint32 Entry )
+static INLINE void AllocTransObjBlock( REGION_ARENA *pArena,
+									sgl_uint32 **rpLastSlot, sgl_uint32 Entry )
 {
-	if ( PTR_SET_EMPTY( pNextTransFace, OBJECTS_PER_BLOCK ) )
+	if ( PTR_SET_EMPTY( pArena->pNextTransFace, OBJECTS_PER_BLOCK ) )
 	{
 		/* Allocate new OBJECT_BLOCK to store this entry */
-		pNextTransFace = ((TRANSFACE_LIST *)
-								AllocObjectBlock( rpLastSlot, Entry )) + 1;
+		pArena->pNextTransFace = ((TRANSFACE_LIST *)
+						AllocObjectBlock( pArena, rpLastSlot, Entry )) + 1;
 	}
 	else
 	{
 		/* Allocate from remainder of current pNextTransFace block */
-		TRANSOBJ_BLOCK *pBlock = (TRANSOBJ_BLOCK *) pNextTransFace++;
+		TRANSOBJ_BLOCK *pBlock = (TRANSOBJ_BLOCK *) pArena->pNextTransFace++;
 		
 		ASSERT( PTR_SET_FULL( *rpLastSlot, TRANSOBJS_PER_BLOCK ) );
 		ASSERT( PTR_SET_EMPTY( pBlock, TRANSOBJS_PER_BLOCK ) );
@@ -1483,7 +1560,8 @@ static INLINE void AllocTransObjBlock( sgl_uint32 **rpLastSlot, sgl_uint32 Entry
 
 /**************************************************************************
  * Function Name  : AllocTransFaceList
- * Inputs         : pRegion   - region requiring a new TRANSFACE_LIST object
+ * Inputs         : pArena    - arena of the calling thread
+ *                : pRegion   - region requiring a new TRANSFACE_LIST object
  *				  : SetId     - TransSetId of new set requested
  *                : Entry     - First entry in new set
  *                : EntryZ    - Z of first entry in new set
@@ -1494,29 +1572,29 @@ static INLINE void AllocTransObjBlock( sgl_uint32 **rpLastSlot, sgl_uint32 Entry
  * Description    : Called when pRegion->CurTSetId[SetId & 1] needs to change
  *				   
 **************************************************************************/
-static INLINE void AllocTransFaceList( REGION_HEADER *pRegion,
+static INLINE void AllocTransFaceList( REGION_ARENA *pArena, REGION_HEADER *pRegion,
 						sgl_uint32 SetId, sgl_uint32 Entry, float EntryZ )
 {
-	TRANSFACE_LIST *pNew = pNextTransFace++;
+	TRANSFACE_LIST *pNew = pArena->pNextTransFace++;
 	
 	if ( PTR_SET_EMPTY( pNew, OBJECTS_PER_BLOCK ) )
 	{
 		sgl_uint32 *pBlock = NULL;
 		
 		/* Allocate new OBJECT_BLOCK to hold head of TRANSOBJ_BLOCK list */
-		pNew = ((TRANSFACE_LIST *) AllocObjectBlock( &pBlock, Entry )) + 1;
+		pNew = ((TRANSFACE_LIST *) AllocObjectBlock( pArena, &pBlock, Entry )) + 1;
 
 		/* We use the next segment of the OBJECT_BLOCK as the TRANSFACE_LIST */
 		pNew->pLastSlot = pBlock;
 
 		/* Setup next allocation */
-		pNextTransFace = pNew + 1;
+		pArena->pNextTransFace = pNew + 1;
 	}
 	else
 	{
 		/* List is initially empty so insert first entry */
 		pNew->pLastSlot = NULL;
-		AllocTransObjBlock( &pNew->pLastSlot, Entry );
+		AllocTransObjBlock( pArena, &pNew->pLastSlot, Entry );
 	}
 
 	/* Initialise new TRANSFACE_LIST with NearestZ of first EntryZ */
@@ -1529,6 +1607,445 @@ static INLINE void AllocTransFaceList( REGION_HEADER *pRegion,
 	pRegion->CurTSetId[SetId & 1] = SetId;
 }
 
+/**************************************************************************
+ **************************************************************************
+
+	Per-thread binning. RegionBinsBegin opens a run of bins, each task
+	selects its own bin with RegionBinSelect and adds objects as normal
+	into shadow REGION_HEADERs, and the bins are merged into the real
+	strips in bin order before any output is generated.
+
+	The merge copies list entries rather than splicing blocks so that the
+	output code can keep assuming every block but the last is full. The
+	source blocks are scrap afterwards so their links are reused to walk
+	each list in its original order. Translucent sets are self contained
+	and are simply linked in.
+
+ **************************************************************************
+ **************************************************************************/
+
+/* The REGION_HEADERs to add to, the real ones unless binning */
+#define STRIP_REGIONS( pArena, pStrip, RY ) \
+	( ( (pArena)->pBin == NULL ) ? (pStrip)->Regions : \
+	  BinStripRegions( (pArena), (pStrip), BaseOfStrips[RY] ) )
+
+/**************************************************************************
+ * Function Name  : BinStripRegions
+ * Inputs         : pArena - arena of the calling thread
+ *                : pStrip - strip being added to
+ *                : YBase  - BaseOfStrips[] of the strip
+ * Outputs        : NONE
+ * Input/Output	  : NONE
+ * Returns        : REGION_HEADER * - shadow regions for the current bin
+ * Globals Used   : RegionInfo
+ * Description    : Finds or creates this bin's copy of a strip's regions.
+ **************************************************************************/
+static REGION_HEADER *BinStripRegions( REGION_ARENA *pArena,
+									   REGION_STRIP *pStrip, int YBase )
+{
+	REGION_BIN *pBin = pArena->pBin;
+	REGION_BIN_STRIP *pBinStrip = pBin->pStrips[YBase];
+
+	if ( pBinStrip == NULL )
+	{
+		pBinStrip = pArena->pFreeBinStrips;
+
+		if ( pBinStrip != NULL )
+		{
+			pArena->pFreeBinStrips = pBinStrip->pNext;
+
+			if ( pBinStrip->nRegions < RegionInfo.NumXRegions )
+			{
+				/* From a narrower screen */
+				SGLFree( pBinStrip );
+				pBinStrip = NULL;
+			}
+		}
+
+		if ( pBinStrip == NULL )
+		{
+			/* Only as many headers as the screen is regions wide */
+			pBinStrip = SGLMalloc( sizeof(REGION_BIN_STRIP) +
+								   sizeof(REGION_HEADER) *
+								   RegionInfo.NumXRegions );	/* Never returns NULL */
+			ASSERT((pBinStrip != NULL));
+
+			pBinStrip->Regions  = (REGION_HEADER *) (pBinStrip + 1);
+			pBinStrip->nRegions = RegionInfo.NumXRegions;
+		}
+
+		memset( pBinStrip->Regions, 0, sizeof(REGION_HEADER) *
+									   RegionInfo.NumXRegions );
+
+		pBinStrip->pStrip = pStrip;
+		pBinStrip->YBase  = YBase;
+
+		pBinStrip->pNext = pBin->pTouched;
+		pBin->pTouched = pBinStrip;
+		pBin->pStrips[YBase] = pBinStrip;
+	}
+
+	return ( pBinStrip->Regions );
+}
+
+/**************************************************************************
+ * Function Name  : MergeObjList
+ * Inputs         : pArena  - arena to allocate new blocks from
+ *                : pSrc    - last entry of the bin's list
+ *                : Entries - OBJECTS_PER_BLOCK or TRANSOBJS_PER_BLOCK
+ * Outputs        : NONE
+ * Input/Output	  : rpDst   - last entry of the real list
+ *                : pPlanes - opaque plane count to limit, or NULL
+ * Returns        : NONE
+ * Globals Used   : NONE
+ * Description    : Appends a bin's list to a real one in insertion order.
+ *                  The pPrev links of the source are reversed to do so.
+ *                  With pPlanes the same plane limit AddRegionObjects
+ *                  applies is applied to each entry.
+ **************************************************************************/
+static void MergeObjList( REGION_ARENA *pArena, sgl_uint32 **rpDst,
+						  sgl_uint32 *pSrc, sgl_uint32 Entries,
+						  sgl_uint16 *pPlanes )
+{
+	sgl_uint32 nLast = PTR_SET_SIZE( pSrc, Entries );
+	sgl_uint32 *pBlock = pSrc - nLast, *pNewer = NULL, *pOlder;
+
+	/* Reverse the block list, the newest block ends up terminating it */
+	while ( ( pOlder = (sgl_uint32 *) pBlock[0] ) != NULL )
+	{
+		pBlock[0] = (sgl_uint32) pNewer;
+		pNewer = pBlock;
+		pBlock = pOlder - Entries;
+	}
+
+	pBlock[0] = (sgl_uint32) pNewer;
+
+	do
+	{
+		sgl_uint32 *pNext = (sgl_uint32 *) pBlock[0];
+		sgl_uint32 n, nEntries = ( pNext == NULL ) ? nLast : Entries;
+
+		for ( n = 1; n <= nEntries; n++ )
+		{
+			sgl_uint32 Entry = pBlock[n];
+
+			if ( pPlanes != NULL )
+			{
+				sgl_uint32 Planes = (Entry >> OBJ_PCOUNT_SHIFT) & OBJ_PCOUNT_MASK;
+
+				if ( ( *pPlanes + Planes ) >
+							(REGION_PLANE_LIM-(SAFETY_MARGIN_OPAQ*2)) )
+				{
+					/* Too many opaque objects make you sad */
+					continue;
+				}
+
+				*pPlanes += (sgl_uint16) Planes;
+			}
+
+			if ( !PTR_SET_FULL( *rpDst, Entries ) )
+			{
+				/* Add the data */
+				PTR_SET_ADD( *rpDst, Entry );
+			}
+			else
+			if ( Entries == OBJECTS_PER_BLOCK )
+			{
+				AllocObjectBlock( pArena, rpDst, Entry );
+			}
+			else
+			{
+				AllocTransObjBlock( pArena, rpDst, Entry );
+			}
+		}
+
+		pBlock = pNext;
+	}
+	while ( pBlock != NULL );
+}
+
+/**************************************************************************
+ * Function Name  : MergeRegion
+ * Inputs         : pArena      - arena to allocate new blocks from
+ *                : pSrc        - a bin's shadow of pDst
+ *                : bShortAtmos - SHADOW and LIGHTVOL use TRANSOBJ_BLOCKs
+ * Outputs        : NONE
+ * Input/Output	  : pDst        - real region
+ * Returns        : NONE
+ * Globals Used   : NONE
+ * Description    : Adds everything binned for a region after what the
+ *                  region already holds.
+ **************************************************************************/
+static void MergeRegion( REGION_ARENA *pArena, REGION_HEADER *pDst,
+						 REGION_HEADER *pSrc, sgl_bool bShortAtmos )
+{
+	sgl_uint32 AtmosEntries = bShortAtmos ? TRANSOBJS_PER_BLOCK :
+											OBJECTS_PER_BLOCK;
+	int k;
+
+#if !(PCX2 || PCX2_003)
+	pDst->HeightStats[HAPPY] += pSrc->HeightStats[HAPPY];
+	pDst->HeightStats[BUSY]  += pSrc->HeightStats[BUSY];
+	pDst->HeightStats[SAD]   += pSrc->HeightStats[SAD];
+#endif
+
+	if ( pSrc->pLastSlots[OPAQUE] != NULL )
+	{
+		MergeObjList( pArena, pDst->pLastSlots + OPAQUE,
+					  pSrc->pLastSlots[OPAQUE], OBJECTS_PER_BLOCK,
+					  &pDst->OpaquePlanes );
+
+		/* Next serial object must not merge with a copied one */
+		pDst->PrevOpaqueId = pArena->OpaqueId - 1;
+	}
+
+	if ( pSrc->pLastSlots[SHADOW] != NULL )
+	{
+		MergeObjList( pArena, pDst->pLastSlots + SHADOW,
+					  pSrc->pLastSlots[SHADOW], AtmosEntries, NULL );
+	}
+
+	if ( pSrc->pLastSlots[LIGHTVOL] != NULL )
+	{
+		MergeObjList( pArena, pDst->pLastSlots + LIGHTVOL,
+					  pSrc->pLastSlots[LIGHTVOL], AtmosEntries, NULL );
+	}
+
+	if ( pSrc->pLastSlots[OPAQUETRANS] != NULL )
+	{
+		MergeObjList( pArena, pDst->pLastSlots + OPAQUETRANS,
+					  pSrc->pLastSlots[OPAQUETRANS], OBJECTS_PER_BLOCK, NULL );
+
+		pDst->TransOpaquePlanes += pSrc->TransOpaquePlanes;
+		pDst->PrevTransOpaqueId = pArena->TransOpaqueId - 1;
+	}
+
+	for ( k = 0; k < 4; k++ )
+	{
+		if ( pSrc->pExtraSlots[k] != NULL )
+		{
+			MergeObjList( pArena, pDst->pExtraSlots + k,
+						  pSrc->pExtraSlots[k], OBJECTS_PER_BLOCK, NULL );
+
+			pDst->ExtraPlanes[k] += pSrc->ExtraPlanes[k];
+		}
+	}
+
+	for ( k = 0; k < 2; k++ )
+	{
+		TRANSFACE_LIST *pOldest = pSrc->pCurTSet[k];
+
+		if ( pOldest != NULL )
+		{
+			/* Link the bin's FRONT/BACK sets in after the current ones */
+			while ( pOldest->pPre != NULL )
+			{
+				pOldest = pOldest->pPre;
+			}
+
+			pOldest->pPre = pDst->pCurTSet[k];
+
+			pDst->pCurTSet[k]  = pSrc->pCurTSet[k];
+			pDst->CurTSetId[k] = pSrc->CurTSetId[k];
+		}
+	}
+
+	pDst->nPassCount += pSrc->nPassCount;
+}
+
+/**************************************************************************
+ * Function Name  : ReleaseRegionBins
+ * Inputs         : bMerge      - merge the bins, otherwise discard them
+ *                : bShortAtmos - see MergeRegion
+ * Outputs        : NONE
+ * Input/Output	  : NONE
+ * Returns        : NONE
+ * Globals Used   : pRegionBins, nRegionBins, RegionArenas
+ * Description    : Empties every pending bin, in order, returning the
+ *                  shadow strips to the arenas that allocated them.
+ **************************************************************************/
+static void ReleaseRegionBins( sgl_bool bMerge, sgl_bool bShortAtmos )
+{
+	REGION_ARENA *pArena = RegionArenas;
+	int nBin;
+
+	ASSERT( !bRegionBinning );
+
+	/* Serial adds go straight to the strips again */
+	pArena->pBin = NULL;
+
+	for ( nBin = 0; nBin < nRegionBins; nBin++ )
+	{
+		REGION_BIN *pBin = pRegionBins + nBin;
+		REGION_BIN_STRIP *pBinStrip;
+
+		while ( ( pBinStrip = pBin->pTouched ) != NULL )
+		{
+			pBin->pTouched = pBinStrip->pNext;
+
+			if ( bMerge )
+			{
+				REGION_HEADER *pDst = pBinStrip->pStrip->Regions;
+				REGION_HEADER *pSrc = pBinStrip->Regions;
+				int nRegions;
+
+				for ( nRegions = RegionInfo.NumXRegions; nRegions != 0;
+					  nRegions--, pDst++, pSrc++ )
+				{
+					MergeRegion( pArena, pDst, pSrc, bShortAtmos );
+				}
+			}
+
+			pBin->pStrips[pBinStrip->YBase] = NULL;
+
+			pBinStrip->pNext = pBin->pArena->pFreeBinStrips;
+			pBin->pArena->pFreeBinStrips = pBinStrip;
+		}
+	}
+
+	nRegionBins = 0;
+}
+
+/* Cheap test so each output routine can merge any pending bins */
+#define MERGE_REGION_BINS( bShortAtmos ) \
+	if ( nRegionBins != 0 ) ReleaseRegionBins( TRUE, (bShortAtmos) )
+
+/**************************************************************************
+ * Function Name  : RegionBinsBegin
+ * Inputs         : nBins - number of bins (tasks) about to add objects
+ * Outputs        : NONE
+ * Input/Output	  : NONE
+ * Returns        : TRUE if binning has started, FALSE to stay serial
+ * Globals Used   : pRegionBins, RegionArenas
+ * Description    : Call on the submitting thread before running tasks
+ *                  that add objects; each task then calls RegionBinSelect
+ *                  with its task number. The bins follow any already
+ *                  pending so several runs per frame keep their order.
+ **************************************************************************/
+sgl_bool RegionBinsBegin( int nBins )
+{
+	int k, nNeeded;
+
+	ASSERT( !bRegionBinning );
+
+	/* Room for the bins plus one to follow on with serial adds */
+	nNeeded = nRegionBins + nBins + 1;
+
+	if ( nNeeded > MAX_REGION_BINS )
+	{
+		/* Out of translucent set ids for this frame */
+		DPF((DBG_WARNING, "RegionBinsBegin: %d bins pending, staying serial", nNeeded));
+		return ( FALSE );
+	}
+
+	if ( nNeeded > nRegionBinsAlloc )
+	{
+		int nCurrent = RegionArenas[0].pBin ?
+			(int) (RegionArenas[0].pBin - pRegionBins) : -1;
+		REGION_BIN *pNew;
+
+		if ( pRegionBins == NULL )
+		{
+			pNew = SGLMalloc( nNeeded * sizeof(REGION_BIN) );
+		}
+		else
+		{
+			pNew = SGLRealloc( pRegionBins, nNeeded * sizeof(REGION_BIN) );
+		}
+
+		if ( pNew == NULL )
+		{
+			DPF((DBG_WARNING, "RegionBinsBegin: no memory for %d bins", nNeeded));
+			return ( FALSE );
+		}
+
+		pRegionBins = pNew;
+		nRegionBinsAlloc = nNeeded;
+
+		if ( nCurrent >= 0 )
+		{
+			RegionArenas[0].pBin = pRegionBins + nCurrent;
+		}
+	}
+
+	memset( pRegionBins + nRegionBins, 0, (nBins + 1) * sizeof(REGION_BIN) );
+
+	for ( k = 1; k < SglThreadPoolCount(); k++ )
+	{
+		REGION_ARENA *pArena = &RegionArenas[k];
+
+		if ( pArena->FreeObjChunk == NULL )
+		{
+			/* First use of this thread's arena */
+			pArena->FreeObjChunk = &pArena->AllChunkHdrs;
+			AllocObjectChunk( pArena );
+
+			pArena->OpaqueId = 0x80000000;
+			pArena->TransOpaqueId = 0x80000000;
+		}
+	}
+
+	nRegionBinBase = nRegionBins;
+	nRegionBins = nNeeded;
+	bRegionBinning = TRUE;
+
+	return ( TRUE );
+}
+
+/**************************************************************************
+ * Function Name  : RegionBinSelect
+ * Inputs         : nBin - 0 to nBins-1, as passed to RegionBinsBegin
+ * Outputs        : NONE
+ * Input/Output	  : NONE
+ * Returns        : NONE
+ * Globals Used   : RegionArenas
+ * Description    : Directs this thread's adds into the given bin.
+ *                  A translucent set never continues across bins.
+ **************************************************************************/
+void RegionBinSelect( int nBin )
+{
+	REGION_ARENA *pArena = &RegionArenas[SglThreadIndex()];
+	REGION_BIN *pBin;
+
+	nBin += nRegionBinBase;
+	pBin = pRegionBins + nBin;
+
+	ASSERT( nBin < nRegionBins );
+
+	pBin->pArena = pArena;
+	pArena->pBin = pBin;
+
+	pArena->CurrentTransSetId[0] = BIN_TRANS_SET_ID(nBin);
+	pArena->CurrentTransSetId[1] = BIN_TRANS_SET_ID(nBin) + 1;
+}
+
+/**************************************************************************
+ * Function Name  : RegionBinsEnd
+ * Inputs         : NONE
+ * Outputs        : NONE
+ * Input/Output	  : NONE
+ * Returns        : NONE
+ * Globals Used   : RegionArenas
+ * Description    : Call on the submitting thread once all the tasks are
+ *                  done. Later serial adds go into a final bin so they
+ *                  stay behind the binned objects until the merge.
+ **************************************************************************/
+void RegionBinsEnd( void )
+{
+	int k;
+
+	ASSERT( bRegionBinning );
+
+	bRegionBinning = FALSE;
+
+	for ( k = 1; k < SGL_MAX_THREADS; k++ )
+	{
+		RegionArenas[k].pBin = NULL;
+	}
+
+	RegionBinSelect( nRegionBins - 1 - nRegionBinBase );
+}
+
 /**************************************************************************
  **************************************************************************
 
@@ -1550,6 +2067,7 @@ static INLINE void AllocTransFaceList( REGION_HEADER *pRegion,
 **************************************************************************/
 void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 NextISPAddr;
 	int RY0, RY1, RX0, RX1;
 #if PCX1 
@@ -1568,7 +2086,7 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 	NextISPAddr = ISPAddr + (Planes << 2) ;
 #endif
 
-	OpaqueId++;
+	pArena->OpaqueId++;
 
 	/* Start at the first Y line effected */
 	RX1 =  XYData      & 0x1f;
@@ -1581,6 +2099,7 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 		/* Get pointer to the strip containing this ROW */
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip */
 #if PCX1
@@ -1609,8 +2128,8 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 #endif
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -1632,7 +2151,7 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 			}
 		
 			/* Setup for recognition of next object */
-			DeltaId = OpaqueId - pRegion->PrevOpaqueId;
+			DeltaId = pArena->OpaqueId - pRegion->PrevOpaqueId;
 			pRegion->PrevOpaqueId = NextISPAddr;
 	
 			if ( DeltaId == 1 )
@@ -1656,7 +2175,7 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 			else
 			{
 				/* New block to hold this entry please */
-				AllocObjectBlock( pRegion->pLastSlots+OPAQUE,
+				AllocObjectBlock( pArena, pRegion->pLastSlots+OPAQUE,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -1684,6 +2203,7 @@ void AddRegionSolid( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 **************************************************************************/
 void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 NextISPAddr;
 	int RY0, RY1, RX0, RX1;
 	int Type = (XYData>>29); /* Shadow or Light Vol */
@@ -1702,7 +2222,7 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 	NextISPAddr = ISPAddr + (Planes << 2) ;
 #endif
 
-	OpaqueId++;
+	pArena->OpaqueId++;
 
 	/* Start at the first Y line effected */
 	RX1 =  XYData      & 0x1f;
@@ -1715,6 +2235,7 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 		/* Get pointer to the strip containing this ROW */
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip */
 
@@ -1744,8 +2265,8 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 #endif
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -1759,7 +2280,7 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 #endif
 
 			/* Setup for recognition of next object */
-			DeltaId = OpaqueId - pRegion->PrevOpaqueId;
+			DeltaId = pArena->OpaqueId - pRegion->PrevOpaqueId;
 			pRegion->PrevOpaqueId = NextISPAddr;
 	
 			if ( DeltaId == 1 )
@@ -1783,7 +2304,7 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 			else
 			{
 				/* New block to hold this entry please */
-				AllocObjectBlock( pRegion->pLastSlots+Type,
+				AllocObjectBlock( pArena, pRegion->pLastSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -1810,6 +2331,7 @@ void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 **************************************************************************/
 static void AddRegionShadorLV( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	int RY0, RY1, RX0, RX1;
 #if PCX1
 	int HSlot;
@@ -1826,6 +2348,7 @@ static void AddRegionShadorLV( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32
 		/* Get pointer to the strip containing this ROW */
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip */
 
@@ -1855,8 +2378,8 @@ static void AddRegionShadorLV( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32
 #endif
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -1878,7 +2401,7 @@ static void AddRegionShadorLV( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32
 			else
 			{
 				/* New block to hold this entry please */
-				AllocTransObjBlock( rpLastSlot, ISPAddr +
+				AllocTransObjBlock( pArena, rpLastSlot, ISPAddr +
 								    (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -1909,6 +2432,7 @@ static void AddRegionShadorLV( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32
 void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Planes,
 					   sgl_uint32 ISPAddr, const TRANS_REGION_DEPTHS_STRUCT *pZData)
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	int RY0, RY1, RX0, RX1;
 #if PCX1
 	int HSlot;
@@ -1928,6 +2452,7 @@ void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Plan
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
 		float Depth;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip, then Calculate 
 		   starting depth of object on this strip (mid Y used) */
@@ -1965,8 +2490,8 @@ void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Plan
 #endif
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -1989,7 +2514,7 @@ void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Plan
 				pRegion->nPassCount++;
 
 				/* Setup a new list */
-				AllocTransFaceList( pRegion, TransSetId, ISPAddr+
+				AllocTransFaceList( pArena, pRegion, TransSetId, ISPAddr+
 									(Planes<<OBJ_PCOUNT_SHIFT), Depth );
 				continue;
 			}
@@ -2022,7 +2547,7 @@ void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Plan
 			else
 			{
 				/* New block to hold this entry please */
-				AllocTransObjBlock( &(pList->pLastSlot), ISPAddr +
+				AllocTransObjBlock( pArena, &(pList->pLastSlot), ISPAddr +
 								    (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -2049,6 +2574,7 @@ void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint32 Plan
 **************************************************************************/
 static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr )
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 NextISPAddr;
 	int RY0, RY1, RX0, RX1;
 #if PCX1
@@ -2067,7 +2593,7 @@ static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint
 	NextISPAddr = ISPAddr + (Planes << 2) ;
 #endif
 
-	TransOpaqueId++;
+	pArena->TransOpaqueId++;
 
 	/* Start at the first Y line effected */
 	RX1 =  XYData      & 0x1f;
@@ -2080,6 +2606,7 @@ static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint
 		/* Get pointer to the strip containing this ROW */
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip */
 
@@ -2109,8 +2636,8 @@ static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint
 #endif
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -2125,7 +2652,7 @@ static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint
 			pRegion->TransOpaquePlanes += Planes;
 
 			/* Setup for recognition of next object */
-			DeltaId = TransOpaqueId - pRegion->PrevTransOpaqueId;
+			DeltaId = pArena->TransOpaqueId - pRegion->PrevTransOpaqueId;
 			pRegion->PrevTransOpaqueId = NextISPAddr;
 	
 			if ( DeltaId == 1 )
@@ -2149,7 +2676,7 @@ static void AddRegionTransOpaque( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint
 			else
 			{
 				/* New block to hold this entry please */
-				AllocObjectBlock( pRegion->pLastSlots+Type,
+				AllocObjectBlock( pArena, pRegion->pLastSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -2185,6 +2712,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
                        sgl_uint32 PlanesPerPoly, int nPolys, sgl_uint32 ISPAddr,
 					   const TRANS_REGION_DEPTHS_STRUCT *pZData, int nZDataInc)
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 Mask = SigXYMask;
 	sgl_uint32 Type = (*pXYData)>>29;
 		
@@ -2197,7 +2725,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 		ASSERT( ( ( PlanesPerPoly * nPolys ) < OBJ_PCOUNT_MASK ) );
 	
 		/* Start new block of OpaqueIds for this group */
-		OpaqueId++;
+		pArena->OpaqueId++;
 
 		do
 		{	/* Process each object */
@@ -2219,7 +2747,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 			}
 
 			/* Allocate one OpaqueId to each insertion */
-			OpaqueId++;
+			pArena->OpaqueId++;
 						
 			/* Start at the first Y line effected */
 			RX1 =  XYData      & 0x1f;
@@ -2232,6 +2760,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 				/* Get pointer to the strip containing this ROW */
 				REGION_STRIP *pStrip = pRegionStrips[RY0];
 				REGION_HEADER *pRegion, *pLastReg;
+				REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 				/* Advance RY0 to first line of next strip */
 
@@ -2261,8 +2790,8 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 		#endif
 
 				/* Get pointers to the region of interest */
-				pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-				pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+				pRegion	 = pRegions + (RX0>>pStrip->Width);
+				pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 				do
 				{
@@ -2284,8 +2813,8 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 					}
 
 					/* Setup for recognition of next object */
-					DeltaId = OpaqueId - pRegion->PrevOpaqueId;
-					pRegion->PrevOpaqueId = OpaqueId;
+					DeltaId = pArena->OpaqueId - pRegion->PrevOpaqueId;
+					pRegion->PrevOpaqueId = pArena->OpaqueId;
 	
 					if ( DeltaId == 1 )
 					{
@@ -2309,7 +2838,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 					else
 					{
 						/* New block to hold this entry please */
-						AllocObjectBlock( pRegion->pLastSlots+Type,
+						AllocObjectBlock( pArena, pRegion->pLastSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 					}
 				}
@@ -2362,13 +2891,13 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 				if 	( ( Type & PACKED_TRANSTYPE_SETMARK ) == 0 )
 				{
 					/* Object is part of current FRONT/BACK object set */
-					TransSetId = CurrentTransSetId[Type & 1];
+					TransSetId = pArena->CurrentTransSetId[Type & 1];
 				}
 				else
 				{
 					/* Object is part of next FRONT/BACK object set
 					 */
-					TransSetId = ( CurrentTransSetId[Type & 1] += 2 );
+					TransSetId = ( pArena->CurrentTransSetId[Type & 1] += 2 );
 				}
 
 				/* Add translucent object to scene */
@@ -2408,6 +2937,7 @@ void AddRegionObjects( sgl_uint32 *pXYData, int nXYDataInc,
 static void AddRegionHighlightFog( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr,
  									int Type)
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	int RY0, RY1, RX0, RX1;
 	
 	ASSERT((ISPAddr<(PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferLimit - Planes)));
@@ -2423,13 +2953,14 @@ static void AddRegionHighlightFog( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uin
 		/* Get pointer to the strip containing this ROW */
 		REGION_STRIP *pStrip = pRegionStrips[RY0];
 		REGION_HEADER *pRegion, *pLastReg;
+		REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 		/* Advance RY0 to first line of next strip */
 		RY0 = BaseOfStrips[RY0] + pStrip->Height;
 
 		/* Get pointers to the region of interest */
-		pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-		pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+		pRegion	 = pRegions + (RX0>>pStrip->Width);
+		pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 		do
 		{
@@ -2445,7 +2976,7 @@ static void AddRegionHighlightFog( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uin
 			else
 			{
 				/* New block to hold this entry please */
-				AllocObjectBlock( pRegion->pExtraSlots+Type,
+				AllocObjectBlock( pArena, pRegion->pExtraSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 			}
 		}
@@ -2480,6 +3011,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 					   const TRANS_REGION_DEPTHS_STRUCT *pZData, int nZDataInc, 
 					   PFOGHIGHLIGHT pFogHighlight)
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 Mask = SigXYMask;
 	sgl_uint32 Type = (*pXYData)>>29;
 		
@@ -2492,7 +3024,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 		ASSERT( ( ( PlanesPerPoly * nPolys ) < OBJ_PCOUNT_MASK ) );
 	
 		/* Start new block of OpaqueIds for this group */
-		OpaqueId++;
+		pArena->OpaqueId++;
 
 		do
 		{	/* Process each object */
@@ -2508,7 +3040,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 			VFogPlanes = (*pFogHighlight & VERTEX_FOG)?1:0;	
 			pFogHighlight++;
 			/* Allocate one OpaqueId to each insertion */
-			OpaqueId++;
+			pArena->OpaqueId++;
 						
 			/* Start at the first Y line effected */
 			RX1 =  XYData      & 0x1f;
@@ -2521,13 +3053,14 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 				/* Get pointer to the strip containing this ROW */
 				REGION_STRIP *pStrip = pRegionStrips[RY0];
 				REGION_HEADER *pRegion, *pLastReg;
+				REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 				/* Advance RY0 to first line of next strip */
 				RY0 = BaseOfStrips[RY0] + pStrip->Height;
 
 				/* Get pointers to the region of interest */
-				pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-				pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+				pRegion	 = pRegions + (RX0>>pStrip->Width);
+				pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 				do
 				{
@@ -2540,7 +3073,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 					}
 
 					/* Setup for recognition of next object */
-					pRegion->PrevOpaqueId = OpaqueId;
+					pRegion->PrevOpaqueId = pArena->OpaqueId;
 	
 					if ( !PTR_SET_FULL( pRegion->pLastSlots[Type],
 													OBJECTS_PER_BLOCK ) )
@@ -2552,7 +3085,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 					else
 					{
 						/* New block to hold this entry please */
-						AllocObjectBlock( pRegion->pLastSlots+Type,
+						AllocObjectBlock( pArena, pRegion->pLastSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 					}
 
@@ -2574,7 +3107,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 							else
 							{
 								/* New block to hold this entry please */
-								AllocObjectBlock( pRegion->pExtraSlots+GOURAUDHIGHLIGHT,
+								AllocObjectBlock( pArena, pRegion->pExtraSlots+GOURAUDHIGHLIGHT,
 												  ISPAddr + 
 												  ((Planes+1)<<OBJ_PCOUNT_SHIFT) );
 							}
@@ -2594,7 +3127,7 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 							else
 							{
 								/* New block to hold this entry please */
-								AllocObjectBlock( pRegion->pExtraSlots+VERTEXFOG,
+								AllocObjectBlock( pArena, pRegion->pExtraSlots+VERTEXFOG,
 												  ISPAddr + 
 												  ((Planes+1+SmoothHighPlanes)<<OBJ_PCOUNT_SHIFT) );
 							}
@@ -2655,13 +3188,13 @@ void AddRegionObjectsExtra( sgl_uint32 *pXYData, int nXYDataInc,
 				if 	( ( Type & PACKED_TRANSTYPE_SETMARK ) == 0 )
 				{
 					/* Object is part of current FRONT/BACK object set */
-					TransSetId = CurrentTransSetId[Type & 1];
+					TransSetId = pArena->CurrentTransSetId[Type & 1];
 				}
 				else
 				{
 					/* Object is part of next FRONT/BACK object set
 					 */
-					TransSetId = ( CurrentTransSetId[Type & 1] += 2 );
+					TransSetId = ( pArena->CurrentTransSetId[Type & 1] += 2 );
 				}
 
 				/* Add translucent object to scene */
@@ -2734,6 +3267,7 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
                        sgl_uint32 PlanesPerPoly, int nPolys, sgl_uint32 ISPAddr,
 					   const TRANS_REGION_DEPTHS_STRUCT *pZData, int nZDataInc)
 {
+	REGION_ARENA *pArena = CURRENT_ARENA();
 	sgl_uint32 Mask = SigXYMask;
 	sgl_uint32 Type = (*pXYData)>>29;
 		
@@ -2746,7 +3280,7 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 		ASSERT( ( ( PlanesPerPoly * nPolys ) < OBJ_PCOUNT_MASK ) );
 	
 		/* Start new block of OpaqueIds for this group */
-		OpaqueId++;
+		pArena->OpaqueId++;
 
 		do
 		{	/* Process each object */
@@ -2777,7 +3311,7 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 #endif
 
 			/* Allocate one OpaqueId to each insertion */
-			OpaqueId++;
+			pArena->OpaqueId++;
 						
 			/* Start at the first Y line effected */
 			RX1 =  XYData      & 0x1f;
@@ -2790,6 +3324,7 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 				/* Get pointer to the strip containing this ROW */
 				REGION_STRIP *pStrip = pRegionStrips[RY0];
 				REGION_HEADER *pRegion, *pLastReg;
+				REGION_HEADER *pRegions = STRIP_REGIONS( pArena, pStrip, RY0 );
 
 				/* Advance RY0 to first line of next strip */
 
@@ -2819,8 +3354,8 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 		#endif
 
 				/* Get pointers to the region of interest */
-				pRegion	 = pStrip->Regions + (RX0>>pStrip->Width);
-				pLastReg = pStrip->Regions + (RX1>>pStrip->Width) + 1;
+				pRegion	 = pRegions + (RX0>>pStrip->Width);
+				pLastReg = pRegions + (RX1>>pStrip->Width) + 1;
 
 				do
 				{
@@ -2842,8 +3377,8 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 					}
 
 					/* Setup for recognition of next object */
-					DeltaId = OpaqueId - pRegion->PrevOpaqueId;
-					pRegion->PrevOpaqueId = OpaqueId;
+					DeltaId = pArena->OpaqueId - pRegion->PrevOpaqueId;
+					pRegion->PrevOpaqueId = pArena->OpaqueId;
 
 #if 0
 /* Remove pointer concatenaion since it is impossible to
@@ -2872,7 +3407,7 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 					else
 					{
 						/* New block to hold this entry please */
-						AllocObjectBlock( pRegion->pLastSlots+Type,
+						AllocObjectBlock( pArena, pRegion->pLastSlots+Type,
 								ISPAddr + (Planes<<OBJ_PCOUNT_SHIFT) );
 					}
 				}
@@ -2926,12 +3461,12 @@ void AddRegionObjectsLightMap( sgl_uint32 *pXYData, int nXYDataInc,
 				if ( ( Type & PACKED_TRANSTYPE_SETMARK ) == 0 )
 				{
 					/* Object is part of current FRONT/BACK object set */
-					TransSetId = CurrentTransSetId[Type & 1];
+					TransSetId = pArena->CurrentTransSetId[Type & 1];
 				}
 				else
 				{
 					/* Object is part of next FRONT/BACK object set */
-					TransSetId = ( CurrentTransSetId[Type & 1] += 2 );
+					TransSetId = ( pArena->CurrentTransSetId[Type & 1] += 2 );
 				}
 
 				/* Add translucent object to scene */
@@ -3354,6 +3889,7 @@ static INLINE sgl_uint32 *MemcpyAndCount( sgl_uint32 *pDest,
  * Function Name  : OutputLongList (internal only  Assumed INLINE!)
  * Inputs         : pLast    - pointer to the last object inserted in the list
  *				  : pAddr    - address last used to store output
+ * Input/Output   : LowRoom  - lowest value RoomLeft has reached
  * Returns        : sgl_uint32 * - address last used to store output
  * Description    : Flattens the content of the list into pAddr, performs
  *                : post-increment on destination address.
@@ -3361,10 +3897,12 @@ static INLINE sgl_uint32 *MemcpyAndCount( sgl_uint32 *pDest,
  *                : order by doing the deepest block first.
  *                : On PCX2 the blocks should already be in the parameter
  *                : space and it will only be necessary to setup the pointer.
+ *                : RoomLeft is given back when objects over the plane limit
+ *                : are removed, so LowRoom records the value before that.
  **************************************************************************/
 static sgl_uint32 *OutputLongList(sgl_uint32 *pObjData, sgl_uint32 *pAddr, 
 							  sgl_uint32 *RoomLeft, sgl_uint32 *Planes,
-							  sgl_uint32 *uTotalPlanes)
+							  sgl_uint32 *uTotalPlanes, sgl_uint32 *LowRoom)
 {
 #define PTR_MASK ( sizeof(sgl_uint32) * (OBJECTS_PER_BLOCK|3) )
 	sgl_uint32 *pNext, *pPtr = pObjData, nObjInLast;
@@ -3402,6 +3940,11 @@ static sgl_uint32 *OutputLongList(sgl_uint32 *pObjData, sgl_uint32 *pAddr,
 		else
 		{
 			*uTotalPlanes += *Planes; 
+
+			if (*RoomLeft < *LowRoom)
+			{
+				*LowRoom = *RoomLeft;
+			}
 			
 			/* Remove objects that put number of planes over the limit */
 			while (*Planes > (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2) )
@@ -3427,6 +3970,11 @@ static sgl_uint32 *OutputLongList(sgl_uint32 *pObjData, sgl_uint32 *pAddr,
 	}
 
 	*uTotalPlanes += *Planes;
+
+	if (*RoomLeft < *LowRoom)
+	{
+		*LowRoom = *RoomLeft;
+	}
 	
 	/* Remove objects that put number of planes over the limit */
 	while (*Planes > (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2) )
@@ -3760,19 +4308,463 @@ static sgl_uint32 *OutputShortList( const sgl_uint32 *pObjData, sgl_uint32 *pAdd
 }
 
 
+/*
+// Strips of regions are output in two passes when there are threads to
+// spare. The first pass outputs every strip into a per-thread scratch buffer
+// just to find its size, the sizes then give each strip its own slice of the
+// region parameter buffer, and the second pass outputs every strip straight
+// into its slice. The result is identical to outputting the strips in order.
+//
+// Sorting the translucent face lists rearranges them, so the first pass
+// records the regions it sorted in the strip's Sorted mask and the second
+// pass outputs those lists as they are.
+*/
+#define MAX_STRIP_JOBS	((MAX_Y_RESOLUTION/2)+1)
+
+/*
+// GenerateObjectPtr only lets RoomLeft change the content of a strip when it
+// is down to a block of objects plus the 20 words the strip loop keeps back.
+*/
+#define STRIP_ROOM_MARGIN	(OBJECTS_PER_BLOCK + 20)
+
+typedef struct _strip_ptr_job {
+	REGION_STRIP *pStrip;
+	sgl_uint32 RegionMask;		/* Regions to render (GenerateObjectPtr)   */
+	int Width;					/* Strip width used this frame			*/
+	sgl_uint32 Sorted;			/* Regions with sorted translucent lists */
+	sgl_uint32 *pAddr;			/* Second pass output address			*/
+	sgl_uint32 Words;			/* Size of the strip's output			*/
+	sgl_uint32 RoomLeft;		/* RoomLeft at start of strip			*/
+	sgl_uint32 LowRoom;			/* Lowest RoomLeft reached in strip		*/
+	int nRendered;				/* Regions output by the strip			*/
+	int PlaneTally;				/* Split or merge info for the strip	*/
+	int TotalPlanes, TransPasses, TransPlanes, ViFixes;	/* Lite stats	*/
+} STRIP_PTR_JOB;
+
+typedef struct _strip_ptr_context {
+	const REGIONS_RECT_STRUCT *pRegionsRect;
+	sgl_bool bRenderAllRegions;
+	sgl_bool bSizing;				/* First pass into scratch buffers	*/
+	sgl_uint32 ScratchWords;
+	sgl_uint32 *LastValidAddress;
+} STRIP_PTR_CONTEXT;
+
+static STRIP_PTR_JOB StripJobs[MAX_STRIP_JOBS];
+static sgl_uint32 *pStripScratch[SGL_MAX_THREADS];
+static sgl_uint32 StripScratchWords = 0;
+
 /*****************************************************************************
- * Function Name  : GenerateObjectPtr
- * Inputs         : 
- *					
- * Returns        : Number of regions rendered (nNumRegionsRendered).
- * Global Used    : RegionData, and ISP parameter buffer in rnglobals
- * Description    : 
- *                  Generates object reference part of sabre parameter data
- *					using the pRegionStrips object list structure.
- *
+ * Function Name  : StripScratchAlloc
+ * Inputs         : nThreads - number of threads that need a buffer
+ *					Words    - size needed for each buffer
+ * Returns        : TRUE if the buffers are available
+ * Global Used    : pStripScratch, StripScratchWords
+ * Description    : Makes sure each thread has a scratch buffer big enough
+ *					for the first pass of parallel strip output. Buffers are
+ *					kept from frame to frame.
  *****************************************************************************/
-int GenerateObjectPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
-					   sgl_uint32 *pRegionMask )
+static sgl_bool StripScratchAlloc( int nThreads, sgl_uint32 Words )
+{
+	int k;
+
+	if ( Words > StripScratchWords )
+	{
+		/* Throw the old ones away rather than copy them */
+		for ( k = 0; k < SGL_MAX_THREADS; k++ )
+		{
+			if ( pStripScratch[k] != NULL )
+			{
+				SGLFree( pStripScratch[k] );
+				pStripScratch[k] = NULL;
+			}
+		}
+
+		StripScratchWords = Words;
+	}
+
+	for ( k = 0; k < nThreads; k++ )
+	{
+		if ( pStripScratch[k] == NULL )
+		{
+			pStripScratch[k] = SGLMalloc( StripScratchWords * sizeof(sgl_uint32) );
+
+			if ( pStripScratch[k] == NULL )
+			{
+				DPF((DBG_WARNING, "StripScratchAlloc: out of memory, strips output serially"));
+				return ( FALSE );
+			}
+		}
+	}
+
+	return ( TRUE );
+}
+
+/*****************************************************************************
+ * Function Name  : GenerateStripPtr
+ * Inputs         : pRegionsRect     - regions to output
+ *					LastValidAddress - end of the output buffer
+ * Input/Output   : pJob             - strip to output, the results are
+ *									   returned in here as well
+ *					rRoomLeft        - room left in the output buffer
+ * Returns        : Address after the strip's output
+ * Global Used    : RegionData
+ * Description    : Generates the object pointers for one strip of regions
+ *					for GenerateObjectPtr.
+ *****************************************************************************/
+static sgl_uint32 *GenerateStripPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
+									 STRIP_PTR_JOB *pJob, sgl_uint32 *curAddr,
+									 sgl_uint32 *LastValidAddress,
+									 sgl_uint32 *rRoomLeft )
+{
+	REGION_STRIP *pStrip = pJob->pStrip;
+	REGION_HEADER *pRegion;
+	sgl_uint32 RegionWord, RegionBit;
+	sgl_uint32 uRegionMask;
+	sgl_uint32 uBusiestTile = 0;
+	sgl_uint32 uSadness = 0;
+	sgl_uint32 RoomLeft = *rRoomLeft;
+	sgl_uint32 LowRoom = RoomLeft;
+	sgl_uint32 Sorted = pJob->Sorted;
+	int Width = pJob->Width, Regions;
+	int nRendered = 0;
+
+	/* Start one after the last region of size XSize<<Width */
+	Regions = (pRegionsRect->LastXRegion >> Width) + 1;
+
+	/* Calculate starting address in region array */
+	pRegion = pStrip->Regions +	Regions;
+			
+	/* Calculate region word corresponding to our starting point */
+	RegionWord = pStrip->RegionWordY + AddRegionWordXData(Regions, Width);
+
+	/* Number of regions to be processed */
+	Regions = Regions - (pRegionsRect->FirstXRegion >> Width);
+	
+	/* Identify which regions not to render */
+	uRegionMask = pJob->RegionMask << (MAX_X_REGIONS - 1 - pRegionsRect->LastXRegion);		
+
+	do
+	{
+		TRANSFACE_LIST *pHead, *pTail;
+		sgl_uint32 RegionPlanes, uTotalPlanes, DummyPlanes;
+		sgl_uint32 TransPassPlanes;
+
+		/* Previous region please, get Opaque counter */
+		DummyPlanes = 0;
+		RegionPlanes = (--pRegion)->OpaquePlanes;
+		uTotalPlanes = RegionPlanes;
+		RegionBit = 1UL << (pRegion - pStrip->Regions);
+					
+		/* Pre-adjust running values for every tile scanned */
+		RegionWord -= DeltaRegionWordX( Width );
+
+
+		if (!(uRegionMask & 0x80000000)) /* Region is masked out */
+		{
+			uRegionMask <<= 1 + Width;
+			continue;
+		}
+
+		/* Need to render this region */
+		nRendered++;
+
+		/* Start first pass */
+		if(RoomLeft)
+		{
+			*curAddr++ = RegionWord;
+			RoomLeft--;
+			ASSERT((LastValidAddress >= curAddr));
+		}
+
+		if ( pRegion->pLastSlots[OPAQUE] != NULL && RoomLeft)
+		{
+			/* Add opaque objects */
+			curAddr = OutputLongList(pRegion->pLastSlots[OPAQUE],
+									 curAddr, &RoomLeft, &DummyPlanes,
+									 &uTotalPlanes, &LowRoom);
+			ASSERT((LastValidAddress >= curAddr));
+
+		}
+		
+		if ( pRegion->pLastSlots[LIGHTVOL] != NULL && RoomLeft 
+			 && RegionPlanes < (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2))
+ 		{
+			/* Copy all the light volumes */
+			curAddr = OutputLongList(pRegion->pLastSlots[LIGHTVOL], 
+									 curAddr, &RoomLeft, &RegionPlanes,
+									 &uTotalPlanes, &LowRoom);
+			ASSERT((LastValidAddress >= curAddr));
+		}
+		
+		if ( pRegion->pLastSlots[SHADOW] != NULL && RoomLeft 
+			 && RegionPlanes < (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2))
+		{
+			/* Copy all the shadows */
+			curAddr = OutputLongList(pRegion->pLastSlots[SHADOW], 
+									 curAddr, &RoomLeft,  &RegionPlanes,
+									 &uTotalPlanes, &LowRoom);
+			ASSERT((LastValidAddress >= curAddr));
+		}
+		
+		/* Each pass must have at least REGION_PLANE_MIN planes for 
+		   the sabre chip to work so pad the region  up to meet this
+		   condition.												*/
+		while((RegionPlanes < REGION_PLANE_MIN )&& RoomLeft)
+		{				
+			/* Add dummy objects until we meet our min criterion */
+			*curAddr++ = DummyObjData;
+			ASSERT((LastValidAddress >= curAddr));
+			RegionPlanes += NUM_DUMMY_OBJECT_PLANES;
+			uTotalPlanes += NUM_DUMMY_OBJECT_PLANES;
+			RoomLeft--;
+		}
+
+		/* Add the flushing plane for the opaque pass !!!!!!! */
+		if(RoomLeft)
+		{
+			*curAddr++ = DummyFlushData;	
+			ASSERT((LastValidAddress >= curAddr));
+			uTotalPlanes += FLUSH_PLANE;
+			RegionPlanes += FLUSH_PLANE;
+			RoomLeft--;
+		}
+
+		/* Translucent object handling */
+		pHead = pRegion->pCurTSet[0];
+		pTail = pRegion->pCurTSet[1];
+				
+		if ( ( ( pHead != pTail ) || ( Sorted & RegionBit ) ) &&
+			 (RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Need to sort them. Already sorted if vignetting solution used,
+			 * or if the strip has been output once already.
+			 */
+			if ( !( Sorted & RegionBit ) )
+			{
+				if(gNoSortTransFaces == NO_SORT || gNoSortTransFaces == REVERSED_NO_SORT)
+				{
+					pHead = NoSortTransFaceLists( pRegion, pHead);
+				}
+				else
+				{
+					pHead = SortTransFaceLists( pRegion, pHead, pTail );
+				}
+
+				Sorted |= RegionBit;
+			}
+
+#if VIGNETTE_FIX
+			/* This is a vignetting fix. It simply counts all the planes in every pass.
+			 * If the total pass count puts the plane count for a tile over 1024 then
+			 * the first pass is started out of cache.
+			 */
+			if (RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
+			{
+				TRANSFACE_LIST *pLocalHead = pHead;
+
+				TransPassPlanes = 0;
+
+				/* Check every pass.
+				 */
+				do
+				{
+					/* Count begin translucent pass plane.
+					 */	
+					TransPassPlanes += NUM_TRANS_PASS_START_PLANES;
+
+					/* Count planes. Translucent planes first.
+					 */
+					TransPassPlanes += CountShortList( pLocalHead->pLastSlot);
+
+					/* Count flushing plane.
+					 */
+					TransPassPlanes += FLUSH_PLANE;
+
+					pLocalHead = pLocalHead->pPost;
+				} while ( pLocalHead != NULL );
+
+#if PCX1
+				/* Extra translucent pass for PCX1.
+				 */
+				TransPassPlanes += NUM_TRANS_PASS_START_PLANES +
+								   FLUSH_PLANE +
+								   NUM_DUMMY_OBJECT_PLANES;
+#endif
+
+				if ((RegionPlanes + TransPassPlanes) > IN_PLANE_CACHE_BOUNDARY)
+				{
+					/* Overwrite old flushing plane
+					 */
+					curAddr--;
+					
+					while ((RegionPlanes < IN_PLANE_CACHE_BOUNDARY) && RoomLeft)
+					{				
+						/* Add dummy objects until we meet our min criterion
+						 */
+						*curAddr++ = DummyObjDataLarge;
+						RegionPlanes += NUM_DUMMY_OBJECT_PLANES_LARGE;
+						RoomLeft--;
+					}
+					
+					/* Replace flushing plane
+					 */
+					*curAddr++ = DummyFlushData;
+				}
+			}
+#endif
+			do
+			{	
+				/* Add the dummy translucent object for this pass */
+				if(RoomLeft)
+				{
+					*curAddr++ = DummyTransData;					
+					RoomLeft--;
+					ASSERT((LastValidAddress >= curAddr));
+				}
+				RegionPlanes += NUM_TRANS_PASS_START_PLANES;
+				uTotalPlanes += NUM_TRANS_PASS_START_PLANES;
+
+				/* Zero the plane count for upcoming pass */
+				TransPassPlanes = 0;
+
+				if(RoomLeft)
+				{
+					/* Add all the translucent objects */
+					curAddr = OutputSafeShortList( pHead->pLastSlot, 
+												   curAddr, 
+												   &RegionPlanes, &TransPassPlanes,
+												   &RoomLeft,
+												   &uTotalPlanes);
+					ASSERT((LastValidAddress >= curAddr));
+				}									
+
+				if(RoomLeft)
+				{
+					/* Add the flushing plane for this pass !!!!!!! */
+					*curAddr++ = DummyTransFlushData;
+					ASSERT((LastValidAddress >= curAddr));
+					RegionPlanes+= FLUSH_PLANE;
+					uTotalPlanes+= FLUSH_PLANE;
+					RoomLeft--;
+				}
+
+				pHead = pHead->pPost;
+			}
+			while ( ( pHead != NULL ) && 
+					(RegionPlanes < SAFETY_MARGIN_TRANS) );
+
+#if PCX1
+			/* extra pass to get rid of smooth/trans/shadow bug */
+			if(RoomLeft > 3)
+			{
+				curAddr[0] = DummyTransData + (1 << OBJ_PCOUNT_SHIFT);
+				curAddr[1] = DummyTransObjData;
+				curAddr[2] = DummyTransFlushData;
+				curAddr += 3;
+				ASSERT((LastValidAddress >= curAddr));
+				RoomLeft -= 3;
+			}
+			/* RegionPlanes isn't used after this point, so don't increment*/
+			uTotalPlanes+= NUM_TRANS_PASS_START_PLANES + FLUSH_PLANE + NUM_DUMMY_OBJECT_PLANES;
+#endif
+		}
+
+		/* Update the plane information this strip */
+		
+#if !(PCX2 || PCX2_003)
+/* Disable dynamic tile sizing for PCX2.
+ */
+		if ( uTotalPlanes > ((REGION_PLANE_LIM * 3)/4) ) /* 75% of maximum as threshold */
+		{
+			/* DECIDE WHAT TO DO */
+			if ( (pRegion->HeightStats[BUSY] > ((pRegion->HeightStats[SAD])<<1)) && (uTotalPlanes > uBusiestTile) )
+			{					
+				/* For splitting the tile - note the busiest tile*/
+				uBusiestTile = uTotalPlanes;
+			}
+		}
+		else if ((SAFETY_MARGIN_OPAQ << 1) > uTotalPlanes) 				
+		{
+			if ( (pRegion->HeightStats[SAD] > ((pRegion->HeightStats[HAPPY])<<1)) && (uTotalPlanes > uSadness) )
+			{
+				/* Attempt to merge */
+				uSadness += uTotalPlanes;
+			}
+		}
+#endif
+
+		uRegionMask <<= 1 + Width;
+
+	} while ( --Regions != 0  && RoomLeft>20);
+
+	if ( RoomLeft < LowRoom )
+	{
+		LowRoom = RoomLeft;
+	}
+
+#if !(PCX2 || PCX2_003)
+	/* Record info on whether to split or merge */
+	pJob->PlaneTally = uBusiestTile - uSadness;
+#endif
+
+	pJob->Sorted = Sorted;
+	pJob->LowRoom = LowRoom;
+	pJob->nRendered = nRendered;
+
+	*rRoomLeft = RoomLeft;
+	return ( curAddr );
+}
+
+/*****************************************************************************
+ * Function Name  : GenerateStripPtrTask
+ * Inputs         : pContext - STRIP_PTR_CONTEXT for the frame
+ *					nTask    - strip to output
+ *					nThread  - thread running the task
+ * Returns        : None
+ * Global Used    : StripJobs, pStripScratch
+ * Description    : Thread pool task for either pass of GenerateObjectPtr.
+ *****************************************************************************/
+static void GenerateStripPtrTask( void *pContext, int nTask, int nThread )
+{
+	STRIP_PTR_CONTEXT *pCtx = (STRIP_PTR_CONTEXT *) pContext;
+	STRIP_PTR_JOB *pJob = &StripJobs[nTask];
+	sgl_uint32 RoomLeft = pJob->RoomLeft;
+	sgl_uint32 *pAddr;
+
+	if ( pCtx->bSizing )
+	{
+		pAddr = GenerateStripPtr( pCtx->pRegionsRect, pJob, pStripScratch[nThread],
+								  pStripScratch[nThread] + pCtx->ScratchWords,
+								  &RoomLeft );
+
+		pJob->Words = (sgl_uint32) (pAddr - pStripScratch[nThread]);
+	}
+	else
+	{
+		pAddr = GenerateStripPtr( pCtx->pRegionsRect, pJob, pJob->pAddr,
+								  pCtx->LastValidAddress, &RoomLeft );
+
+		ASSERT( pAddr == (pJob->pAddr + pJob->Words) );
+	}
+}
+
+/*****************************************************************************
+ * Function Name  : GenerateObjectPtr
+ * Inputs         : 
+ *					
+ * Returns        : Number of regions rendered (nNumRegionsRendered).
+ * Global Used    : RegionData, and ISP parameter buffer in rnglobals
+ * Description    : 
+ *                  Generates object reference part of sabre parameter data
+ *					using the pRegionStrips object list structure.
+ *
+ *					Strips are output in parallel for as long as there is
+ *					enough room for RoomLeft not to matter, the rest are
+ *					output in order here.
+ *
+ *****************************************************************************/
+int GenerateObjectPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
+					   sgl_uint32 *pRegionMask )
 {
 	REGION_STRIP *pStrip, *pLastStrip;
 #if !DUMP_PARAMS
@@ -3782,13 +4774,15 @@ int GenerateObjectPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
 	*/
 	sgl_uint32 *curAddr;
 #endif
-	sgl_uint32 uRegionMask; /* For eash strip */
 	int nCurrentHeight = 0; /* For when number of strip in a tile > 1*/ 
 	sgl_uint32 *LastValidAddress;
 	sgl_uint32 RoomLeft = 0;
-	sgl_uint32 InitRoom = 0;
  	int nNumRegionsRendered = 0;
+	int nJobs, nJob, nFirstSerial;
 	
+	/* Bring in anything added on other threads first */
+	MERGE_REGION_BINS( FALSE );
+
 	/* Get pointer to where we are building this info */
 	curAddr = PVRParamBuffs[PVR_PARAM_TYPE_REGION].pBuffer + 
 		PVRParamBuffs[PVR_PARAM_TYPE_REGION].uBufferPos;
@@ -3828,298 +4822,113 @@ int GenerateObjectPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
 		pRegionMask += (pRegionsRect->FirstYRegion);
 	}
 
-	/* Reset render counter */
-	nNumRegionsRendered = 0;
-	
-	for(;;pStrip=pStrip->pNext)
+	/* List the strips, with the mask of regions to render in each */
+	for ( nJobs = 0;; pStrip = pStrip->pNext )
 	{
-		REGION_HEADER *pRegion;
-		sgl_uint32 RegionWord;
-		sgl_uint32 uBusiestTile = 0;
-		sgl_uint32 uSadness = 0;
-		int Width = pStrip->Width, Regions;
+		STRIP_PTR_JOB *pJob = &StripJobs[nJobs++];
 
-		if(MergeHeight < 256)
-		{
-			Width = 1;
-			pStrip->Width = 1;
-		}
-
-		/* Start one after the last region of size XSize<<Width */
-		Regions = (pRegionsRect->LastXRegion >> Width) + 1;
- 
-		/* Calculate starting address in region array */
-		pRegion = pStrip->Regions +	Regions;
-				
-		/* Calculate region word corresponding to our starting point */
-		RegionWord = pStrip->RegionWordY + AddRegionWordXData(Regions, Width);
+		ASSERT(nJobs <= MAX_STRIP_JOBS);
 
-		/* Number of regions to be processed */
-		Regions = Regions - (pRegionsRect->FirstXRegion >> Width);
-		
-		/* Identify which regions not to render */
-		uRegionMask = (*pRegionMask) << (MAX_X_REGIONS - 1 - pRegionsRect->LastXRegion);		
+		pJob->pStrip = pStrip;
+		pJob->RegionMask = *pRegionMask;
+		pJob->Width = (MergeHeight < 256) ? 1 : pStrip->Width;
+		pJob->Sorted = 0;
+		pJob->RoomLeft = RoomLeft;
 
-		do
+		nCurrentHeight += pStrip->Height << Y_SHIFT;
+		if (nCurrentHeight >= RegionInfo.YSize) /* Next row of tiles */
 		{
-			TRANSFACE_LIST *pHead, *pTail;
-			sgl_uint32 RegionPlanes, uTotalPlanes, DummyPlanes;
-			sgl_uint32 TransPassPlanes;
-
-			/* Previous region please, get Opaque counter */
-			DummyPlanes = 0;
-			RegionPlanes = (--pRegion)->OpaquePlanes;
-			uTotalPlanes = RegionPlanes;
-						
-			/* Pre-adjust running values for every tile scanned */
-			RegionWord -= DeltaRegionWordX( Width );
-
-
-			if (!(uRegionMask & 0x80000000)) /* Region is masked out */
-			{
-				uRegionMask <<= 1 + Width;
-				continue;
-			}
-
-			/* Need to render this region */
-			nNumRegionsRendered++;
-
-			/* Start first pass */
-			if(RoomLeft)
-			{
-				*curAddr++ = RegionWord;
-				RoomLeft--;
-				ASSERT((LastValidAddress >= curAddr));
-			}
-
-			if ( pRegion->pLastSlots[OPAQUE] != NULL && RoomLeft)
-			{
-				/* Add opaque objects */
-				curAddr = OutputLongList(pRegion->pLastSlots[OPAQUE],
-										 curAddr, &RoomLeft, &DummyPlanes,
-										 &uTotalPlanes);
-				ASSERT((LastValidAddress >= curAddr));
-
-			}
-			
-			if ( pRegion->pLastSlots[LIGHTVOL] != NULL && RoomLeft 
-				 && RegionPlanes < (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2))
- 			{
-				/* Copy all the light volumes */
-				curAddr = OutputLongList(pRegion->pLastSlots[LIGHTVOL], 
-										 curAddr, &RoomLeft, &RegionPlanes,
-										 &uTotalPlanes);
-				ASSERT((LastValidAddress >= curAddr));
-			}
-			
-			if ( pRegion->pLastSlots[SHADOW] != NULL && RoomLeft 
-				 && RegionPlanes < (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ*2))
-			{
-				/* Copy all the shadows */
-				curAddr = OutputLongList(pRegion->pLastSlots[SHADOW], 
-										 curAddr, &RoomLeft,  &RegionPlanes,
-										 &uTotalPlanes);
-				ASSERT((LastValidAddress >= curAddr));
-			}
-			
-			/* Each pass must have at least REGION_PLANE_MIN planes for 
-			   the sabre chip to work so pad the region  up to meet this
-			   condition.												*/
-			while((RegionPlanes < REGION_PLANE_MIN )&& RoomLeft)
-			{				
-				/* Add dummy objects until we meet our min criterion */
-				*curAddr++ = DummyObjData;
-				ASSERT((LastValidAddress >= curAddr));
-				RegionPlanes += NUM_DUMMY_OBJECT_PLANES;
-				uTotalPlanes += NUM_DUMMY_OBJECT_PLANES;
-				RoomLeft--;
-			}
-
-			/* Add the flushing plane for the opaque pass !!!!!!! */
-			if(RoomLeft)
-			{
-				*curAddr++ = DummyFlushData;	
-				ASSERT((LastValidAddress >= curAddr));
-				uTotalPlanes += FLUSH_PLANE;
-				RegionPlanes += FLUSH_PLANE;
-				RoomLeft--;
-			}
-
-			/* Translucent object handling */
-			pHead = pRegion->pCurTSet[0];
-			pTail = pRegion->pCurTSet[1];
-					
-			if ( ( pHead != pTail ) && (RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Need to sort them. Already sorted if vignetting solution used.
-				 */
-				if(gNoSortTransFaces == NO_SORT || gNoSortTransFaces == REVERSED_NO_SORT)
-				{
-					pHead = NoSortTransFaceLists( pRegion, pHead);
-				}
-				else
-				{
-					pHead = SortTransFaceLists( pRegion, pHead, pTail );
-				}
-
-#if VIGNETTE_FIX
-				/* This is a vignetting fix. It simply counts all the planes in every pass.
-				 * If the total pass count puts the plane count for a tile over 1024 then
-				 * the first pass is started out of cache.
-				 */
-				if (RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
-				{
-					TRANSFACE_LIST *pLocalHead = pHead;
-
-					TransPassPlanes = 0;
-
-					/* Check every pass.
-					 */
-					do
-					{
-						/* Count begin translucent pass plane.
-						 */	
-						TransPassPlanes += NUM_TRANS_PASS_START_PLANES;
-
-						/* Count planes. Translucent planes first.
-						 */
-						TransPassPlanes += CountShortList( pLocalHead->pLastSlot);
-
-						/* Count flushing plane.
-						 */
-						TransPassPlanes += FLUSH_PLANE;
-
-						pLocalHead = pLocalHead->pPost;
-					} while ( pLocalHead != NULL );
-
-#if PCX1
-					/* Extra translucent pass for PCX1.
-					 */
-					TransPassPlanes += NUM_TRANS_PASS_START_PLANES +
-									   FLUSH_PLANE +
-									   NUM_DUMMY_OBJECT_PLANES;
-#endif
+			nCurrentHeight = 0;
+			pRegionMask++;			
+		}
 
-					if ((RegionPlanes + TransPassPlanes) > IN_PLANE_CACHE_BOUNDARY)
-					{
-						/* Overwrite old flushing plane
-						 */
-						curAddr--;
-						
-						while ((RegionPlanes < IN_PLANE_CACHE_BOUNDARY) && RoomLeft)
-						{				
-							/* Add dummy objects until we meet our min criterion
-							 */
-							*curAddr++ = DummyObjDataLarge;
-							RegionPlanes += NUM_DUMMY_OBJECT_PLANES_LARGE;
-							RoomLeft--;
-						}
-						
-						/* Replace flushing plane
-						 */
-						*curAddr++ = DummyFlushData;
-					}
-				}
-#endif
-				do
-				{	
-					/* Add the dummy translucent object for this pass */
-					if(RoomLeft)
-					{
-						*curAddr++ = DummyTransData;					
-						RoomLeft--;
-						ASSERT((LastValidAddress >= curAddr));
-					}
-					RegionPlanes += NUM_TRANS_PASS_START_PLANES;
-					uTotalPlanes += NUM_TRANS_PASS_START_PLANES;
+		/* Last strip done */
+		if ( pStrip == pLastStrip ) break;
+	}
 
-					/* Zero the plane count for upcoming pass */
-					TransPassPlanes = 0;
+	/* Reset render counter */
+	nNumRegionsRendered = 0;
+	nFirstSerial = 0;
 
-					if(RoomLeft)
-					{
-						/* Add all the translucent objects */
-						curAddr = OutputSafeShortList( pHead->pLastSlot, 
-													   curAddr, 
-													   &RegionPlanes, &TransPassPlanes,
-													   &RoomLeft,
-													   &uTotalPlanes);
-						ASSERT((LastValidAddress >= curAddr));
-					}									
-
-					if(RoomLeft)
-					{
-						/* Add the flushing plane for this pass !!!!!!! */
-						*curAddr++ = DummyTransFlushData;
-						ASSERT((LastValidAddress >= curAddr));
-						RegionPlanes+= FLUSH_PLANE;
-						uTotalPlanes+= FLUSH_PLANE;
-						RoomLeft--;
-					}
+#if !DUMP_PARAMS
+	if ( ( nJobs > 1 ) && ( SglThreadPoolCount() > 1 ) &&
+		 StripScratchAlloc( SglThreadPoolCount(), 
+							RoomLeft + OBJECT_POINTER_SAFETY_MARGIN ) )
+	{
+		STRIP_PTR_CONTEXT Context;
+		sgl_uint32 Used = 0;
 
-					pHead = pHead->pPost;
-				}
-				while ( ( pHead != NULL ) && 
-						(RegionPlanes < SAFETY_MARGIN_TRANS) );
+		Context.pRegionsRect = pRegionsRect;
+		Context.bRenderAllRegions = FALSE;
+		Context.bSizing = TRUE;
+		Context.ScratchWords = RoomLeft + OBJECT_POINTER_SAFETY_MARGIN;
+		Context.LastValidAddress = LastValidAddress;
 
-#if PCX1
-				/* extra pass to get rid of smooth/trans/shadow bug */
-				if(RoomLeft > 3)
-				{
-					curAddr[0] = DummyTransData + (1 << OBJ_PCOUNT_SHIFT);
-					curAddr[1] = DummyTransObjData;
-					curAddr[2] = DummyTransFlushData;
-					curAddr += 3;
-					ASSERT((LastValidAddress >= curAddr));
-					RoomLeft -= 3;
-				}
-				/* RegionPlanes isn't used after this point, so don't increment*/
-				uTotalPlanes+= NUM_TRANS_PASS_START_PLANES + FLUSH_PLANE + NUM_DUMMY_OBJECT_PLANES;
-#endif
-			}
-	
-			/* Update the plane information this strip */
-			
-#if !(PCX2 || PCX2_003)
-/* Disable dynamic tile sizing for PCX2.
- */
-			if ( uTotalPlanes > ((REGION_PLANE_LIM * 3)/4) ) /* 75% of maximum as threshold */
+		/* First pass, size every strip as if it had all the room */
+		SglThreadParallelFor( nJobs, GenerateStripPtrTask, &Context );
+
+		/* Give the strips their slices while RoomLeft can't affect them */
+		for ( nJob = 0; nJob < nJobs; nJob++ )
+		{
+			STRIP_PTR_JOB *pJob = &StripJobs[nJob];
+
+			if ( pJob->LowRoom <= ( Used + STRIP_ROOM_MARGIN ) )
 			{
-				/* DECIDE WHAT TO DO */
-				if ( (pRegion->HeightStats[BUSY] > ((pRegion->HeightStats[SAD])<<1)) && (uTotalPlanes > uBusiestTile) )
-				{					
-					/* For splitting the tile - note the busiest tile*/
-					uBusiestTile = uTotalPlanes;
-				}
+				break;
 			}
-			else if ((SAFETY_MARGIN_OPAQ << 1) > uTotalPlanes) 				
+
+			pJob->pAddr = curAddr + Used;
+			pJob->RoomLeft = RoomLeft - Used;
+			Used += pJob->Words;
+		}
+
+		nFirstSerial = nJob;
+
+		if ( nFirstSerial != 0 )
+		{
+			/* Second pass, output the strips into their slices */
+			Context.bSizing = FALSE;
+			SglThreadParallelFor( nFirstSerial, GenerateStripPtrTask, &Context );
+
+			for ( nJob = 0; nJob < nFirstSerial; nJob++ )
 			{
-				if ( (pRegion->HeightStats[SAD] > ((pRegion->HeightStats[HAPPY])<<1)) && (uTotalPlanes > uSadness) )
+				STRIP_PTR_JOB *pJob = &StripJobs[nJob];
+
+				if(MergeHeight < 256)
 				{
-					/* Attempt to merge */
-					uSadness += uTotalPlanes;
+					pJob->pStrip->Width = 1;
 				}
-			}
-#endif
-
-			uRegionMask <<= 1 + Width;
 
-		} while ( --Regions != 0  && RoomLeft>20);
-		
 #if !(PCX2 || PCX2_003)
-/* Disable dynamic tile sizing for PCX2.
- */
-		/* Record info on whether to split or merge */
-		pStrip->PlaneTally = uBusiestTile - uSadness;
+				pJob->pStrip->PlaneTally = pJob->PlaneTally;
 #endif
+				nNumRegionsRendered += pJob->nRendered;
+			}
 
-		nCurrentHeight += pStrip->Height << Y_SHIFT;
-		if (nCurrentHeight >= RegionInfo.YSize) /* Next row of tiles */
+			curAddr += Used;
+			RoomLeft -= Used;
+		}
+	}
+#endif
+
+	/* Output any strips that are left in order */
+	for ( nJob = nFirstSerial; nJob < nJobs; nJob++ )
+	{
+		STRIP_PTR_JOB *pJob = &StripJobs[nJob];
+
+		if(MergeHeight < 256)
 		{
-			nCurrentHeight = 0;
-			pRegionMask++;			
+			pJob->pStrip->Width = 1;
 		}
 
+		curAddr = GenerateStripPtr( pRegionsRect, pJob, curAddr,
+									LastValidAddress, &RoomLeft );
+		nNumRegionsRendered += pJob->nRendered;
+
+#if !(PCX2 || PCX2_003)
+		pJob->pStrip->PlaneTally = pJob->PlaneTally;
+#endif
+
 		if(RoomLeft<=20 ) 
 		{
 			/* as we might not have a dummy pass or flushing plane in this
@@ -4137,9 +4946,6 @@ int GenerateObjectPtr( const REGIONS_RECT_STRUCT *const pRegionsRect,
 			
 			break;
 		}
-		
-		/* Last strip done */
-		if ( pStrip == pLastStrip) break;
 	}
 	
 #if PCX1 || PCX2 || PCX2_003
@@ -4500,17 +5306,446 @@ static INLINE CountTotalTranslucentPlanes ( REGION_HEADER *pRegion,
 
 	}
 
-	*tPlanes = TransPassPlanes;
+	*tPlanes = TransPassPlanes;
+
+}/* end of CountTotalTranslucentPlanes */
+#endif
+
+#if _DEBUG
+static int DumpedOne = 1;
+#endif
+
+#define FRAME_STATS 0
+#define REGION_STATS 0
+
+/* Region and frame stats output */
+static FILE *dump = NULL;
+
+/*****************************************************************************
+ * Function Name  : GenerateStripPtrLite
+ * Inputs         : pRegionsRect      - regions to output
+ *					bRenderAllRegions - if nonzero then all regions are
+ *					 rendered, irrespective of whether they are empty.
+ * Input/Output   : pJob              - strip to output, the results are
+ *										returned in here as well
+ * Returns        : Address after the strip's output
+ * Global Used    : RegionData
+ * Description    : Generates the object pointers for one strip of regions
+ *					for GenerateObjectPtrLite.
+ *****************************************************************************/
+static sgl_uint32 *GenerateStripPtrLite( const REGIONS_RECT_STRUCT *const pRegionsRect,
+										 sgl_bool bRenderAllRegions,
+										 STRIP_PTR_JOB *pJob, sgl_uint32 *curAddr )
+{
+	REGION_STRIP *pStrip = pJob->pStrip;
+	REGION_HEADER *pRegion;
+	sgl_uint32 RegionWord, RegionBit;
+	sgl_uint32 uBusiestTile = 0;
+	sgl_uint32 uSadness = 0;
+	sgl_uint32 Sorted = pJob->Sorted;
+	int Width = pJob->Width, Regions;
+	int nRendered = 0;
+	sgl_int32	nPassCountCat;
+
+	pJob->TotalPlanes = 0;
+	pJob->TransPasses = 0;
+	pJob->TransPlanes = 0;
+	pJob->ViFixes = 0;
+
+	/* Start one after the last region of size XSize<<Width */
+	Regions = (pRegionsRect->LastXRegion >> Width) + 1;
+
+	/* Calculate starting address in region array */
+	pRegion = pStrip->Regions +	Regions;
+
+	/* Calculate region word corresponding to our starting point */
+	RegionWord = pStrip->RegionWordY + AddRegionWordXData(Regions, Width);
+
+	/* Number of regions to be processed */
+	Regions = Regions - (pRegionsRect->FirstXRegion >> Width);
+
+	do
+	{
+		TRANSFACE_LIST *pHead, *pTail;
+		sgl_uint32 RegionPlanes;
+		sgl_uint32 nDiscardedPlanes = 0;
+		sgl_uint32 TransPassPlanes = 0;
+		int RegionTotalPlanes=0, RegionTransPasses=0, RegionTransPlanes=0, ViFix=0;
+
+		/* Previous region please, get Opaque counter */
+		RegionPlanes = (--pRegion)->OpaquePlanes;
+		RegionBit = 1UL << (pRegion - pStrip->Regions);
+					
+		/* Pre-adjust running values for every tile scanned */
+		RegionWord -= DeltaRegionWordX( Width );
+
+		/* Ignore the background OPAQUE object which is always there */
+		if ( (!bRenderAllRegions)             &&
+			 ( RegionPlanes < 2 )             &&
+			 ( pRegion->pLastSlots[OPAQUETRANS] == NULL ) &&
+			 ( pRegion->pCurTSet[0] == NULL ) &&
+			 ( pRegion->pCurTSet[1] == NULL )    )
+		{
+			/* Next region please, increase size of strip if possible */
+			continue;
+		}
+					
+		/* Need to render this region */
+		nRendered++;
+
+		/* Start first pass */
+		IW( curAddr++, 0, RegionWord);
+
+		if ( pRegion->pLastSlots[OPAQUE] != NULL )
+		{
+			/* Add opaque objects */
+			curAddr = GenerateOpaquePtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+										  OPAQUE, (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ));
+		}
+
+		/* Each pass must have at least REGION_PLANE_MIN planes for 
+		   the sabre chip to work so pad the region  up to meet this
+		   condition.												*/
+
+		while(RegionPlanes < REGION_PLANE_MIN)
+		{				
+			/* Add dummy objects until we meet our min criterion */
+  				IW(curAddr++, 0, DummyObjData);
+  				RegionPlanes += NUM_DUMMY_OBJECT_PLANES;
+			/*	DPF((DBG_VERBOSE, "---- Padding Region with extra planes to make > 33 ----"));*/
+		}
+
+		/* Add the flushing plane for the opaque pass !!!!!!! */
+		curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyFlushData); 
+					
+		/* Translucent object handling	*/
+		pHead = pRegion->pCurTSet[0];
+		pTail = pRegion->pCurTSet[1];
+
+		/* Sort the translucent passes. We always need to do this regardless
+		 * if the vignetting fix is being implemented or not.
+		 */
+		if ( ( ( pHead != pTail ) || ( Sorted & RegionBit ) ) && 
+			 (RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Need to sort them, unless the strip has been output once
+			 * already.
+			 */
+			if ( !( Sorted & RegionBit ) )
+			{
+				if(gNoSortTransFaces == NO_SORT || gNoSortTransFaces == REVERSED_NO_SORT)
+				{
+					pHead = NoSortTransFaceLists( pRegion, pHead);
+				}
+				else
+				{
+					pHead = SortTransFaceLists( pRegion, pHead, pTail );
+				}
+
+				Sorted |= RegionBit;
+			}
+		}
+		else
+		{
+			/* Set it to NULL if we aren't happy. ie no translucent triangles.
+			 */
+			pHead = NULL;
+		}
+
+#if VIGNETTE_FIX
+		/* Only implement vignetting fix if plane count less than cache boundary.
+		 */
+		if (RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
+		{
+			/* This is the vignetting fix. It simply counts all the planes in every pass.
+			 * If the total pass count puts the plane count for a tile over 1024 then
+			 * the first pass is started out of cache.
+			 */
+			CountTotalTranslucentPlanes (pRegion, RegionPlanes, 
+												 &TransPassPlanes,
+												 pHead);
+
+			/* Pad out the opaque pass over the cache boundary if the sum of
+			 * the translucent planes plus the current tile plane count exceeds
+			 * the cache boundary.
+			 *
+			 * This fix prevents vignetting since this is due to the translucent
+			 * pass crossing the cache boundary.
+			 */
+			if ((RegionPlanes + TransPassPlanes) > IN_PLANE_CACHE_BOUNDARY)
+			{
+				/* Overwrite old flushing plane
+				 */
+				curAddr--;
+						
+				while(RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
+				{				
+					/* Add dummy objects until we meet our min criterion
+					 */
+					IW( curAddr++, 0, DummyObjDataLarge);
+					RegionPlanes += NUM_DUMMY_OBJECT_PLANES_LARGE;
+				}
+						
+				/* Replace flushing plane
+				 */
+				IW( curAddr++, 0, DummyFlushData);
+				ViFix = 1;
+			}
+		}
+#endif		
+		/* Jim's new D3D translucent solution. 
+		** Only inserted if plane count below the safety margin.
+		*/
+		if ((pRegion->pLastSlots[OPAQUETRANS] != NULL ) && 
+			(RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Add the dummy begin translucent pass object for this pass. */
+			IW(curAddr++ , 0, DummyTransData);
+			RegionPlanes += 
+				NUM_TRANS_PASS_START_PLANES + pRegion->TransOpaquePlanes;
+
+			/* Add OpaqueTrans objects */
+			curAddr = GenerateOpaquePtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+									 OPAQUETRANS, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
+		   
+			/* Add the flushing plane for this pass !!!!!!!	*/
+			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+		}
+	
+
+		/* GOURAUD Highlight objects pass */
+		if ((pRegion->pExtraSlots[GOURAUDHIGHLIGHT] != NULL ) &&
+			(RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Add the dummy begin translucent pass object for this pass.*/
+			IW(curAddr++ , 0, DummyTransData);
+			RegionPlanes += 
+				NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[GOURAUDHIGHLIGHT];
+
+			/* Add GOURAUD Highlight objects */
+			curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+									 GOURAUDHIGHLIGHT, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
+		   
+			/* Add the flushing plane for this pass !!!!!!!	*/
+			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+		}
+	   
+	    /* Vertex Fog objects pass */
+		if ((pRegion->pExtraSlots[VERTEXFOG] != NULL ) &&
+			(RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Add the dummy begin translucent pass object for this pass. */
+			IW(curAddr++ , 0, DummyTransData);
+			RegionPlanes += 
+				NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[VERTEXFOG];
+
+			/* Add GOURAUD Highlight objects */
+			curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+									 VERTEXFOG, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
+		   
+			/* Add the flushing plane for this pass !!!!!!!	*/
+			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+		}
+
+		/* Initialise count.  */
+		TransPassPlanes = 0;
+
+		/* Normal translucent pass handling. The are translucent passes if pHead != NULL.
+		 * The translucent passes have already been sorted.
+		 */
+		if ( pHead )
+		{
+			RegionTransPlanes = RegionPlanes;
+
+			/* Calculate the number of translucent passes to concatenate.  */
+			nPassCountCat = pRegion->nPassCount - nMaxPassCount + 1;
+					
+			/* Stuff in the (m - n + 1) passes together. */
+			if (nPassCountCat > 0)
+			{
+				RegionTransPasses++;
+
+				/* Add the dummy begin translucent pass object for this pass  */
+				IW( curAddr++, 0, DummyTransData);
+				RegionPlanes += NUM_TRANS_PASS_START_PLANES;
+
+				while ( (nPassCountCat > 0) &&
+						(RegionPlanes < SAFETY_MARGIN_TRANS) && 
+						( pHead != NULL ) )
+				{
+					/* Decrement the count.	 */
+					nPassCountCat--;
+
+					/* Zero the plane count for upcoming pass */
+					TransPassPlanes = 0;
+					
+					/* Add all the translucent objects */
+					curAddr = GenerateTransPtr ( pRegion, curAddr, &RegionPlanes,
+								   &nDiscardedPlanes, &TransPassPlanes, pHead); 
+
+				   	pHead = pHead->pPost;
+				}
+
+				/* Add the flushing plane for this pass !!!!!!! */
+				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+			}
+
+			/* Stuff in the rest of the passes.	*/
+			while ( ( pHead != NULL ) && (RegionPlanes < SAFETY_MARGIN_TRANS))
+			{
+				RegionTransPasses++;
+
+				/* Add the dummy begin translucent pass object for this pass */
+				IW( curAddr++, 0, DummyTransData);
+				RegionPlanes += NUM_TRANS_PASS_START_PLANES;
+
+				/* Zero the plane count for upcoming pass */
+				TransPassPlanes = 0;
+				
+				/* Add all the translucent objects */
+				curAddr = GenerateTransPtr ( pRegion, curAddr, &RegionPlanes,
+								   &nDiscardedPlanes, &TransPassPlanes, pHead); 
+
+			   	/* Add the flushing plane for this pass !!!!!!!	*/
+				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+				 
+				pHead = pHead->pPost;
+			}
+
+			#if PCX1
+				/* Size of the above loop is always known, unroll it? */
+				IW( curAddr, 0, (DummyTransData + (1 << OBJ_PCOUNT_SHIFT)));
+				IW( curAddr, 1, DummyTransObjData);
+				IW( curAddr, 2, DummyTransFlushData);
+				curAddr+=3;
+
+				RegionPlanes+= NUM_TRANS_PASS_START_PLANES +
+							   FLUSH_PLANE +
+							   NUM_DUMMY_OBJECT_PLANES;
+			#endif
+			RegionTransPlanes = RegionPlanes - RegionTransPlanes;
+		}
+
+	
+
+		/* Gouraud Highlight for Translucent objects pass */
+		if ((pRegion->pExtraSlots[TRANS_GOURAUDHIGHLIGHT] != NULL ) &&
+			(RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Add the dummy begin translucent pass object for this pass.*/
+			IW(curAddr++ , 0, DummyTransData);
+			RegionPlanes += 
+				NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[TRANS_GOURAUDHIGHLIGHT];
+
+			/* Add GOURAUD Highlight objects */
+			curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+									 TRANS_GOURAUDHIGHLIGHT, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
+		   
+			/* Add the flushing plane for this pass !!!!!!!	*/
+			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+		}
+	   
+	    /* Vertex Fog  for Translucent objects pass */
+		if ((pRegion->pExtraSlots[TRANS_VERTEXFOG] != NULL ) &&
+			(RegionPlanes < SAFETY_MARGIN_TRANS))
+		{
+			/* Add the dummy begin translucent pass object for this pass. */
+			IW(curAddr++ , 0, DummyTransData);
+			RegionPlanes += 
+				NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[TRANS_VERTEXFOG];
+
+			/* Add GOURAUD Highlight objects */
+			curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
+									 TRANS_VERTEXFOG, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
+		   
+			/* Add the flushing plane for this pass !!!!!!!	*/
+			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
+		}
+
+		pJob->TotalPlanes+=RegionPlanes;
+		pJob->TransPlanes+=RegionTransPlanes;
+		pJob->TransPasses+=RegionTransPasses;
+		pJob->ViFixes+=ViFix;
+		/* Update the plane information this strip */
+#if REGION_STATS
+if(dump!=NULL)
+{
+	fprintf(dump,"%-5.1d%-12.d%-14.1d%-d\n", 
+			ViFix, RegionPlanes, RegionTransPlanes, RegionTransPasses);	
+}
+#endif
+							
+RegionPlanes += nDiscardedPlanes;			
+
+#if !(PCX2 || PCX2_003)
+/* Disable dynamic tile sizing for PCX2. */
+		if ( RegionPlanes > ((REGION_PLANE_LIM * 3)/4) ) /* 75% of maximum as threshold */
+		{
+			/* DECIDE WHAT TO DO */
+			if ( (pRegion->HeightStats[BUSY] > ((pRegion->HeightStats[SAD])<<1)) && 
+				 (RegionPlanes > uBusiestTile) )
+			{					
+				/* For splitting the tile - note the busiest tile*/
+					uBusiestTile = RegionPlanes;
+			}
+		}
+		else if ((SAFETY_MARGIN_OPAQ << 1) > RegionPlanes) 				
+		{
+			if ( (pRegion->HeightStats[SAD] > ((pRegion->HeightStats[HAPPY])<<1)) && 
+				 (RegionPlanes > uSadness) )
+			{
+				/* Attempt to merge */
+					uSadness += RegionPlanes;
+			}
+		}
+#endif
+
+	} while ( --Regions != 0 );
+
+#if !(PCX2 || PCX2_003)
+/* Disable dynamic tile sizing for PCX2.  */
+	/* Record info on whether to split or merge */
+	pStrip->PlaneTally = uBusiestTile - uSadness;
+#endif
+
+	pJob->Sorted = Sorted;
+	pJob->nRendered = nRendered;
+
+	return ( curAddr );
+}
+
+/*****************************************************************************
+ * Function Name  : GenerateStripPtrLiteTask
+ * Inputs         : pContext - STRIP_PTR_CONTEXT for the frame
+ *					nTask    - strip to output
+ *					nThread  - thread running the task
+ * Returns        : None
+ * Global Used    : StripJobs, pStripScratch
+ * Description    : Thread pool task for either pass of GenerateObjectPtrLite.
+ *****************************************************************************/
+static void GenerateStripPtrLiteTask( void *pContext, int nTask, int nThread )
+{
+	STRIP_PTR_CONTEXT *pCtx = (STRIP_PTR_CONTEXT *) pContext;
+	STRIP_PTR_JOB *pJob = &StripJobs[nTask];
+	sgl_uint32 *pAddr;
+
+	if ( pCtx->bSizing )
+	{
+		pAddr = GenerateStripPtrLite( pCtx->pRegionsRect, pCtx->bRenderAllRegions,
+									  pJob, pStripScratch[nThread] );
 
-}/* end of CountTotalTranslucentPlanes */
-#endif
+		pJob->Words = (sgl_uint32) (pAddr - pStripScratch[nThread]);
+		ASSERT( pJob->Words <= pCtx->ScratchWords );
+	}
+	else
+	{
+		pAddr = GenerateStripPtrLite( pCtx->pRegionsRect, pCtx->bRenderAllRegions,
+									  pJob, pJob->pAddr );
 
-#if _DEBUG
-static int DumpedOne = 1;
-#endif
+		ASSERT( pAddr == (pJob->pAddr + pJob->Words) );
+	}
+}
 
-#define FRAME_STATS 0
-#define REGION_STATS 0
 
 /*****************************************************************************
  * Function Name  : GenerateObjectPtrLite
@@ -4542,12 +5777,15 @@ int GenerateObjectPtrLite( const REGIONS_RECT_STRUCT *const pRegionsRect,
 		int LastYLine = (pRegionsRect->LastYRegion+1) * YRegLines;
 		
 	int nNumRegionsRendered = 0;
+	int nJobs, nJob;
 #if _DEBUG
 	int FoundOverload = DumpedOne;
 #endif
 
 	int FrameTotalPlanes=0, FrameTransPasses=0, FrameTransPlanes=0, FrameViFixes=0;
-	static FILE *dump = NULL;
+
+	/* Bring in anything added on other threads first */
+	MERGE_REGION_BINS( TRUE );
 
 #if REGION_STATS
 	if(dump==NULL)
@@ -4591,366 +5829,75 @@ int GenerateObjectPtrLite( const REGIONS_RECT_STRUCT *const pRegionsRect,
 	}
 #endif
 
-	for ( ;; pStrip = pStrip->pNext )
+	/* List the strips */
+	for ( nJobs = 0;; pStrip = pStrip->pNext )
 	{
-		REGION_HEADER *pRegion;
-		sgl_uint32 RegionWord;
-		sgl_uint32 uBusiestTile = 0;
-		sgl_uint32 uSadness = 0;
-		int Width = pStrip->Width, Regions;
-		sgl_int32	nPassCountCat;
-
-		/* Start one after the last region of size XSize<<Width */
-		Regions = (pRegionsRect->LastXRegion >> Width) + 1;
-
-		/* Calculate starting address in region array */
-		pRegion = pStrip->Regions +	Regions;
-
-		/* Calculate region word corresponding to our starting point */
-		RegionWord = pStrip->RegionWordY + AddRegionWordXData(Regions, Width);
-
-		/* Number of regions to be processed */
-		Regions = Regions - (pRegionsRect->FirstXRegion >> Width);
-
-		do
-		{
-			TRANSFACE_LIST *pHead, *pTail;
-			sgl_uint32 RegionPlanes;
-			sgl_uint32 nDiscardedPlanes = 0;
-			sgl_uint32 TransPassPlanes = 0;
-			int RegionTotalPlanes=0, RegionTransPasses=0, RegionTransPlanes=0, ViFix=0;
-
-			/* Previous region please, get Opaque counter */
-			RegionPlanes = (--pRegion)->OpaquePlanes;
-						
-			/* Pre-adjust running values for every tile scanned */
-			RegionWord -= DeltaRegionWordX( Width );
-
-			/* Ignore the background OPAQUE object which is always there */
-			if ( (!bRenderAllRegions)             &&
-				 ( RegionPlanes < 2 )             &&
-				 ( pRegion->pLastSlots[OPAQUETRANS] == NULL ) &&
-				 ( pRegion->pCurTSet[0] == NULL ) &&
-				 ( pRegion->pCurTSet[1] == NULL )    )
-			{
-				/* Next region please, increase size of strip if possible */
-				continue;
-			}
-						
-			/* Need to render this region */
-			nNumRegionsRendered++;
-
-			/* Start first pass */
-			IW( curAddr++, 0, RegionWord);
-
-			if ( pRegion->pLastSlots[OPAQUE] != NULL )
-			{
-				/* Add opaque objects */
-				curAddr = GenerateOpaquePtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-											  OPAQUE, (REGION_PLANE_LIM - SAFETY_MARGIN_OPAQ));
-			}
-
-			/* Each pass must have at least REGION_PLANE_MIN planes for 
-			   the sabre chip to work so pad the region  up to meet this
-			   condition.												*/
-
-			while(RegionPlanes < REGION_PLANE_MIN)
-			{				
-				/* Add dummy objects until we meet our min criterion */
-  				IW(curAddr++, 0, DummyObjData);
-  				RegionPlanes += NUM_DUMMY_OBJECT_PLANES;
-				/*	DPF((DBG_VERBOSE, "---- Padding Region with extra planes to make > 33 ----"));*/
-			}
-
-			/* Add the flushing plane for the opaque pass !!!!!!! */
-			curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyFlushData); 
-						
-			/* Translucent object handling	*/
-			pHead = pRegion->pCurTSet[0];
-			pTail = pRegion->pCurTSet[1];
-
-			/* Sort the translucent passes. We always need to do this regardless
-			 * if the vignetting fix is being implemented or not.
-			 */
-			if (( pHead != pTail ) && (RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Need to sort them. 
-				 */
-				if(gNoSortTransFaces == NO_SORT || gNoSortTransFaces == REVERSED_NO_SORT)
-				{
-					pHead = NoSortTransFaceLists( pRegion, pHead);
-				}
-				else
-				{
-					pHead = SortTransFaceLists( pRegion, pHead, pTail );
-				}
-			}
-			else
-			{
-				/* Set it to NULL if we aren't happy. ie no translucent triangles.
-				 */
-				pHead = NULL;
-			}
-
-#if VIGNETTE_FIX
-			/* Only implement vignetting fix if plane count less than cache boundary.
-			 */
-			if (RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
-			{
-				/* This is the vignetting fix. It simply counts all the planes in every pass.
-				 * If the total pass count puts the plane count for a tile over 1024 then
-				 * the first pass is started out of cache.
-				 */
-				CountTotalTranslucentPlanes (pRegion, RegionPlanes, 
-													 &TransPassPlanes,
-													 pHead);
-
-				/* Pad out the opaque pass over the cache boundary if the sum of
-				 * the translucent planes plus the current tile plane count exceeds
-				 * the cache boundary.
-				 *
-				 * This fix prevents vignetting since this is due to the translucent
-				 * pass crossing the cache boundary.
-				 */
-				if ((RegionPlanes + TransPassPlanes) > IN_PLANE_CACHE_BOUNDARY)
-				{
-					/* Overwrite old flushing plane
-					 */
-					curAddr--;
-							
-					while(RegionPlanes < IN_PLANE_CACHE_BOUNDARY)
-					{				
-						/* Add dummy objects until we meet our min criterion
-						 */
-						IW( curAddr++, 0, DummyObjDataLarge);
-						RegionPlanes += NUM_DUMMY_OBJECT_PLANES_LARGE;
-					}
-							
-					/* Replace flushing plane
-					 */
-					IW( curAddr++, 0, DummyFlushData);
-					ViFix = 1;
-				}
-			}
-#endif		
-			/* Jim's new D3D translucent solution. 
-			** Only inserted if plane count below the safety margin.
-			*/
-			if ((pRegion->pLastSlots[OPAQUETRANS] != NULL ) && 
-				(RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Add the dummy begin translucent pass object for this pass. */
-				IW(curAddr++ , 0, DummyTransData);
-				RegionPlanes += 
-					NUM_TRANS_PASS_START_PLANES + pRegion->TransOpaquePlanes;
+		STRIP_PTR_JOB *pJob = &StripJobs[nJobs++];
 
-				/* Add OpaqueTrans objects */
-				curAddr = GenerateOpaquePtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-										 OPAQUETRANS, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
-			   
-				/* Add the flushing plane for this pass !!!!!!!	*/
-				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-			}
-		
-
-			/* GOURAUD Highlight objects pass */
-			if ((pRegion->pExtraSlots[GOURAUDHIGHLIGHT] != NULL ) &&
-				(RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Add the dummy begin translucent pass object for this pass.*/
-				IW(curAddr++ , 0, DummyTransData);
-				RegionPlanes += 
-					NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[GOURAUDHIGHLIGHT];
-
-				/* Add GOURAUD Highlight objects */
-				curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-										 GOURAUDHIGHLIGHT, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
-			   
-				/* Add the flushing plane for this pass !!!!!!!	*/
-				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-			}
-		   
-		    /* Vertex Fog objects pass */
-			if ((pRegion->pExtraSlots[VERTEXFOG] != NULL ) &&
-				(RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Add the dummy begin translucent pass object for this pass. */
-				IW(curAddr++ , 0, DummyTransData);
-				RegionPlanes += 
-					NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[VERTEXFOG];
-
-				/* Add GOURAUD Highlight objects */
-				curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-										 VERTEXFOG, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
-			   
-				/* Add the flushing plane for this pass !!!!!!!	*/
-				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-			}
-
-			/* Initialise count.  */
-			TransPassPlanes = 0;
-
-			/* Normal translucent pass handling. The are translucent passes if pHead != NULL.
-			 * The translucent passes have already been sorted.
-			 */
-			if ( pHead )
-			{
-				RegionTransPlanes = RegionPlanes;
-
-				/* Calculate the number of translucent passes to concatenate.  */
-				nPassCountCat = pRegion->nPassCount - nMaxPassCount + 1;
-						
-				/* Stuff in the (m - n + 1) passes together. */
-				if (nPassCountCat > 0)
-				{
-					RegionTransPasses++;
-
-					/* Add the dummy begin translucent pass object for this pass  */
-					IW( curAddr++, 0, DummyTransData);
-					RegionPlanes += NUM_TRANS_PASS_START_PLANES;
-
-					while ( (nPassCountCat > 0) &&
-							(RegionPlanes < SAFETY_MARGIN_TRANS) && 
-							( pHead != NULL ) )
-					{
-						/* Decrement the count.	 */
-						nPassCountCat--;
-
-						/* Zero the plane count for upcoming pass */
-						TransPassPlanes = 0;
-						
-						/* Add all the translucent objects */
-						curAddr = GenerateTransPtr ( pRegion, curAddr, &RegionPlanes,
-									   &nDiscardedPlanes, &TransPassPlanes, pHead); 
-
-					   	pHead = pHead->pPost;
-					}
-
-					/* Add the flushing plane for this pass !!!!!!! */
-					curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-				}
-
-				/* Stuff in the rest of the passes.	*/
-				while ( ( pHead != NULL ) && (RegionPlanes < SAFETY_MARGIN_TRANS))
-				{
-					RegionTransPasses++;
-
-					/* Add the dummy begin translucent pass object for this pass */
-					IW( curAddr++, 0, DummyTransData);
-					RegionPlanes += NUM_TRANS_PASS_START_PLANES;
-
-					/* Zero the plane count for upcoming pass */
-					TransPassPlanes = 0;
-					
-					/* Add all the translucent objects */
-					curAddr = GenerateTransPtr ( pRegion, curAddr, &RegionPlanes,
-									   &nDiscardedPlanes, &TransPassPlanes, pHead); 
+		ASSERT(nJobs <= MAX_STRIP_JOBS);
 
-				   	/* Add the flushing plane for this pass !!!!!!!	*/
-					curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-					 
-					pHead = pHead->pPost;
-				}
+		pJob->pStrip = pStrip;
+		pJob->Width = pStrip->Width;
+		pJob->Sorted = 0;
 
-				#if PCX1
-					/* Size of the above loop is always known, unroll it? */
-					IW( curAddr, 0, (DummyTransData + (1 << OBJ_PCOUNT_SHIFT)));
-					IW( curAddr, 1, DummyTransObjData);
-					IW( curAddr, 2, DummyTransFlushData);
-					curAddr+=3;
+		/* Last strip done */
+		if ( pStrip == pLastStrip ) break;
+	}
 
-					RegionPlanes+= NUM_TRANS_PASS_START_PLANES +
-								   FLUSH_PLANE +
-								   NUM_DUMMY_OBJECT_PLANES;
-				#endif
-				RegionTransPlanes = RegionPlanes - RegionTransPlanes;
-			}
+#if !DUMP_PARAMS && !REGION_STATS
+	/*
+	// Nothing limits the size of the output here, so the scratch buffers
+	// only need to be as big as the parameter buffer.
+	*/
+	if ( ( nJobs > 1 ) && ( SglThreadPoolCount() > 1 ) &&
+		 StripScratchAlloc( SglThreadPoolCount(), 
+							PVRParamBuffs[PVR_PARAM_TYPE_REGION].uBufferLimit -
+							PVRParamBuffs[PVR_PARAM_TYPE_REGION].uBufferPos ) )
+	{
+		STRIP_PTR_CONTEXT Context;
+		sgl_uint32 Used = 0;
 
-		
+		Context.pRegionsRect = pRegionsRect;
+		Context.bRenderAllRegions = bRenderAllRegions;
+		Context.bSizing = TRUE;
+		Context.ScratchWords = StripScratchWords;
+		Context.LastValidAddress = NULL;
 
-			/* Gouraud Highlight for Translucent objects pass */
-			if ((pRegion->pExtraSlots[TRANS_GOURAUDHIGHLIGHT] != NULL ) &&
-				(RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Add the dummy begin translucent pass object for this pass.*/
-				IW(curAddr++ , 0, DummyTransData);
-				RegionPlanes += 
-					NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[TRANS_GOURAUDHIGHLIGHT];
+		/* First pass, size every strip */
+		SglThreadParallelFor( nJobs, GenerateStripPtrLiteTask, &Context );
 
-				/* Add GOURAUD Highlight objects */
-				curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-										 TRANS_GOURAUDHIGHLIGHT, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
-			   
-				/* Add the flushing plane for this pass !!!!!!!	*/
-				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-			}
-		   
-		    /* Vertex Fog  for Translucent objects pass */
-			if ((pRegion->pExtraSlots[TRANS_VERTEXFOG] != NULL ) &&
-				(RegionPlanes < SAFETY_MARGIN_TRANS))
-			{
-				/* Add the dummy begin translucent pass object for this pass. */
-				IW(curAddr++ , 0, DummyTransData);
-				RegionPlanes += 
-					NUM_TRANS_PASS_START_PLANES + pRegion->ExtraPlanes[TRANS_VERTEXFOG];
+		for ( nJob = 0; nJob < nJobs; nJob++ )
+		{
+			StripJobs[nJob].pAddr = curAddr + Used;
+			Used += StripJobs[nJob].Words;
+		}
 
-				/* Add GOURAUD Highlight objects */
-				curAddr = GenerateExtraPtr ( pRegion, curAddr, &RegionPlanes, &nDiscardedPlanes,
-										 TRANS_VERTEXFOG, (SAFETY_MARGIN_TRANS - MIN_TRANS_PLANES));
-			   
-				/* Add the flushing plane for this pass !!!!!!!	*/
-				curAddr = OutputFlushingPlanes ( curAddr, &RegionPlanes, DummyTransFlushData); 
-			}
+		/* Second pass, output the strips into their slices */
+		Context.bSizing = FALSE;
+		SglThreadParallelFor( nJobs, GenerateStripPtrLiteTask, &Context );
 
-			FrameTotalPlanes+=RegionPlanes;
-			FrameTransPlanes+=RegionTransPlanes;
-			FrameTransPasses+=RegionTransPasses;
-			FrameViFixes+=ViFix;
-			/* Update the plane information this strip */
-#if REGION_STATS
-	if(dump!=NULL)
-	{
-		fprintf(dump,"%-5.1d%-12.d%-14.1d%-d\n", 
-				ViFix, RegionPlanes, RegionTransPlanes, RegionTransPasses);	
+		curAddr += Used;
 	}
+	else
 #endif
-								
-	RegionPlanes += nDiscardedPlanes;			
-
-#if !(PCX2 || PCX2_003)
-/* Disable dynamic tile sizing for PCX2. */
-			if ( RegionPlanes > ((REGION_PLANE_LIM * 3)/4) ) /* 75% of maximum as threshold */
-			{
-				/* DECIDE WHAT TO DO */
-				if ( (pRegion->HeightStats[BUSY] > ((pRegion->HeightStats[SAD])<<1)) && 
-					 (RegionPlanes > uBusiestTile) )
-				{					
-					/* For splitting the tile - note the busiest tile*/
-						uBusiestTile = RegionPlanes;
-				}
-			}
-			else if ((SAFETY_MARGIN_OPAQ << 1) > RegionPlanes) 				
-			{
-				if ( (pRegion->HeightStats[SAD] > ((pRegion->HeightStats[HAPPY])<<1)) && 
-					 (RegionPlanes > uSadness) )
-				{
-					/* Attempt to merge */
-						uSadness += RegionPlanes;
-				}
-			}
-#endif
-
-		} while ( --Regions != 0 );
+	{
+		for ( nJob = 0; nJob < nJobs; nJob++ )
+		{
+			curAddr = GenerateStripPtrLite( pRegionsRect, bRenderAllRegions,
+											&StripJobs[nJob], curAddr );
+		}
+	}
 
-#if !(PCX2 || PCX2_003)
-/* Disable dynamic tile sizing for PCX2.  */
-		/* Record info on whether to split or merge */
-		pStrip->PlaneTally = uBusiestTile - uSadness;
-#endif
+	for ( nJob = 0; nJob < nJobs; nJob++ )
+	{
+		STRIP_PTR_JOB *pJob = &StripJobs[nJob];
 
-		/* Last strip done */
-		if ( pStrip == pLastStrip ) break;
-	} /* end of for loop */
+		nNumRegionsRendered += pJob->nRendered;
+		FrameTotalPlanes += pJob->TotalPlanes;
+		FrameTransPlanes += pJob->TransPlanes;
+		FrameTransPasses += pJob->TransPasses;
+		FrameViFixes += pJob->ViFixes;
+	}
 
 	#if PCX1 || PCX2 || PCX2_003
 		/* With PCX1 and PCX2 the very last pointer must be marked with an end bit. */
@@ -5071,6 +6018,9 @@ void GenerateObjectPtrLiteStrip( const REGIONS_RECT_STRUCT *const pRegionsRect,
 	REGION_STRIP_EXTRA 	*pRegionStripExtra = RegionStripExtra;
 	sgl_uint32				RegionDataStart;
 	
+	/* Bring in anything added on other threads first */
+	MERGE_REGION_BINS( TRUE );
+
 	/* Get pointer to where we are building this info */
 	curAddr = PVRParamBuffs[PVR_PARAM_TYPE_REGION].pBuffer + 
 		PVRParamBuffs[PVR_PARAM_TYPE_REGION].uBufferPos;
@@ -5513,6 +6463,9 @@ int SetupStripLite (int nStrip,
 	int HeightSoFar = 0;
 	int RegionsSoFar = 0;
 
+	/* Bring in anything added on other threads first */
+	MERGE_REGION_BINS( TRUE );
+
 	nStrip <<= (5 - Y_SHIFT);
 
 	pRegionStripData->fObjectsPresent = FALSE;
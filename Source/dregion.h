@@ -225,6 +225,15 @@ extern void AddRegionSeeThru( sgl_uint32 XYData, sgl_uint32 TransSetId, sgl_uint
 
 extern void AddRegionAtmos( sgl_uint32 XYData, sgl_uint32 Planes, sgl_uint32 ISPAddr );
 
+/* To add objects from several threads at once call RegionBinsBegin with
+   the number of tasks before running them, RegionBinSelect(nTask) at the
+   start of each task and RegionBinsEnd once they have all finished. The
+   objects come out in task order as if added serially, except that a
+   translucent set never continues from one task into the next.        */
+extern sgl_bool RegionBinsBegin( int nBins );
+extern void RegionBinSelect( int nBin );
+extern void RegionBinsEnd( void );
+
 /* Use these to decide what the real maximum tile size is, MaxY happens
    to correspond to RegionInfo.YSize at the moment but whoe knows?
    RegionInfo.XSize is currently the minimum tile width however so you
@@ -589,6 +589,10 @@
 #include "parmbuff.h"
 #include "pvrlims.h"
 #include "texapi.h"
+#include "sglmem.h"
+#include "profile.h"
+#include "sglthrd.h"
+#include "dtrisimd.h"
 
 SGL_EXTERN_TIME_REF /* if we are timing code */
 
@@ -845,7 +849,7 @@ static void ProcessD3DPolys (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -865,7 +869,7 @@ static void ProcessD3DPolys (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -878,6 +882,483 @@ static void ProcessD3DPolys (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn,
 	}
 }
 
+/*
+// ============================================================================
+// 						THREADED TRIANGLE PROCESSING
+// ============================================================================
+//
+// Large batches of triangles are shared out over the thread pool. Setting
+// a triangle up runs the per polygon routines, and they all work through
+// the one PROCESSDATACONTEXT, so that stays serial: the triangles are set
+// up a batch at a time into a staging buffer. ISP and TSP space for each
+// chunk of the batch is then claimed in submission order, and the chunks
+// are packed in parallel while one more task sets up the next batch.
+//
+// Each pack task adds its region objects into its own region bin, so they
+// come out in submission order. Translucent triangles that share sets are
+// added to the regions serially once the chunks are packed instead, since
+// a translucent set cannot carry on from one bin into the next.
+//
+// Setting up the next batch alongside the packing is safe because the two
+// share none of gpPDC's state. Setup only moves the input cursor
+// (nInputTriangles, pFace and pV0 to pV2) and writes the staging buffers.
+// The pack side reads TSPControlWord and Context.bDoClipping, which are
+// fixed before ProcessTris starts, plus the batch being packed. The TSP
+// packers take everything from the ITRI and IMATERIAL arrays they are
+// handed. ProcessTrisThreaded asserts that the fixed fields stay put.
+//
+// Opaque objects added from different bins are never merged into one
+// region entry, so the region lists can hold more entries than the serial
+// path makes. The entries still point at the same planes, and the planes
+// and TSP data are laid out exactly as the serial path lays them out, so
+// the image is the same. DEBUG builds can check the parameter data with
+// [Threads] DirectTrianglesVerify in sgl.ini, which packs every batch a
+// second time on one thread and compares the two.
+*/
+
+#define THREAD_CHUNK_TRIS	64		/* triangles per pack task */
+#define THREAD_BATCH_CHUNKS	16
+#define THREAD_BATCH_TRIS	(THREAD_CHUNK_TRIS * THREAD_BATCH_CHUNKS)
+
+typedef struct tagTRICHUNK
+{
+	int			nFirst;			/* index into the batch */
+	int			nTris;
+	sgl_uint32	ISPPos;			/* claimed with ReserveISPTri */
+	sgl_uint32	TSPAddr;
+
+} TRICHUNK;
+
+typedef struct tagTRIBATCH
+{
+	PITRI		pTri;
+	PIMATERIAL	pMat;
+	int			nTris;
+	int			nChunks;
+	TRICHUNK	Chunks[THREAD_BATCH_CHUNKS];
+
+} TRIBATCH;
+
+typedef struct tagTRIPIPE
+{
+	PPIR		pPerPolyfn;
+	PBPR		pPerBuffn;
+	sgl_uint32	TSPWords;
+	sgl_uint32	NewObject;
+	int			nInputLeft;		/* triangles not yet set up */
+	sgl_uint32	uParts;			/* what the pack tasks write */
+	TRIBATCH	*pPack;
+	TRIBATCH	*pSetup;		/* NULL after the last batch */
+	TRIBATCH	Batches[2];
+
+} TRIPIPE;
+
+/* Minimum batch to thread, from sgl.ini; 0 turns threading off */
+static int nThreadTriMin = -1;
+
+#if DEBUG
+/* Repack each batch serially and compare, from sgl.ini */
+static int nThreadTriVerify = -1;
+#endif
+
+/* Staging for both batches, allocated the first time it is needed */
+static PITRI		pThreadTri = NULL;
+static PIMATERIAL	pThreadMat = NULL;
+
+/**********************************************************************
+**
+** Decides whether the current batch of triangles is worth threading.
+**
+**********************************************************************/
+
+static sgl_bool UseThreadedTris (void)
+{
+#ifdef METRIC
+
+	/* The code timers are not per thread */
+	return (FALSE);
+
+#else
+
+	if (nThreadTriMin < 0)
+	{
+		nThreadTriMin = SglReadPrivateProfileInt ("Threads", "DirectTriangles",
+												  1024, "sgl.ini");
+	}
+
+	if ((nThreadTriMin == 0) ||
+		(gpPDC->nInputTriangles < nThreadTriMin) ||
+		(SglThreadPoolCount () < 2))
+	{
+		return (FALSE);
+	}
+
+#if PCX2 || PCX2_003
+	/* The extra planes take a TSP size that is only known once packed */
+	if((gpPDC->Context.u32Flags & SGLTT_VERTEXFOG) || 
+	   (gpPDC->Context.u32Flags & (SGLTT_HIGHLIGHT | SGLTT_GOURAUD)))
+	{
+		return (FALSE);
+	}
+#endif
+
+	if (pThreadTri == NULL)
+	{
+		pThreadTri = SGLMalloc (2 * THREAD_BATCH_TRIS * sizeof (ITRI));
+		pThreadMat = SGLMalloc (2 * THREAD_BATCH_TRIS * sizeof (IMATERIAL));
+
+		if ((pThreadTri == NULL) || (pThreadMat == NULL))
+		{
+			DPFDEV ((DBG_WARNING, "UseThreadedTris: No memory for staging"));
+
+			if (pThreadTri != NULL)
+			{
+				SGLFree (pThreadTri);
+				pThreadTri = NULL;
+			}
+
+			if (pThreadMat != NULL)
+			{
+				SGLFree (pThreadMat);
+				pThreadMat = NULL;
+			}
+
+			return (FALSE);
+		}
+	}
+
+	return (TRUE);
+
+#endif
+}
+
+/**********************************************************************
+**
+** Sets up to THREAD_BATCH_TRIS input triangles into pBatch, copying each
+** burst out of gpTri/gpMat as ProcessTriCoreLite fills them.
+**
+**********************************************************************/
+
+static void SetupTriBatch (TRIPIPE *pPipe, TRIBATCH *pBatch)
+{
+	int nBurst;
+
+	gpPDC->nInputTriangles = MIN (pPipe->nInputLeft, THREAD_BATCH_TRIS);
+	pPipe->nInputLeft -= gpPDC->nInputTriangles;
+
+	pBatch->nTris = 0;
+
+	while ( gpPDC->nInputTriangles != 0 )
+	{
+		gpMatCurrent = gpMat;			/* pPerPolyFn updates this */
+
+		nBurst = ProcessTriCoreLite ( pPipe->pPerPolyfn, pPipe->NewObject, 0);
+		pPipe->NewObject = FALSE;
+
+		memcpy (pBatch->pTri + pBatch->nTris, gpTri, nBurst * sizeof (ITRI));
+		memcpy (pBatch->pMat + pBatch->nTris, gpMat, nBurst * sizeof (IMATERIAL));
+
+		pBatch->nTris += nBurst;
+	}
+}
+
+/**********************************************************************
+**
+** Splits a set up batch into chunks and claims the ISP and TSP space of
+** each in turn. If the buffers fill up the batch is cut short and no more
+** input is set up, as ProcessTris does.
+**
+**********************************************************************/
+
+static void ReserveTriBatch (TRIPIPE *pPipe, TRIBATCH *pBatch)
+{
+	sgl_uint32 	TSPSpaceAvailable;
+	int			nFirst, nTris, nFit;
+	sgl_bool	bFull = FALSE;
+
+	pBatch->nChunks = 0;
+
+	for (nFirst = 0; (nFirst < pBatch->nTris) && !bFull; nFirst += nTris)
+	{
+		TRICHUNK *pChunk = &pBatch->Chunks[pBatch->nChunks];
+
+		nTris = MIN (pBatch->nTris - nFirst, THREAD_CHUNK_TRIS);
+
+		TSPSpaceAvailable = PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferLimit -
+							PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos;
+
+		if (TSPSpaceAvailable < (nTris * pPipe->TSPWords))
+		{
+			TSPSpaceAvailable = PVROSExtendTSPBuffer (gHLogicalDev);
+			
+			if (TSPSpaceAvailable < (nTris * pPipe->TSPWords))
+			{
+				nTris = TSPSpaceAvailable / pPipe->TSPWords;
+				bFull = TRUE;
+			}
+		}
+
+		nFit = ReserveISPTri (nTris, &pChunk->ISPPos);
+
+		if (nFit < nTris)
+		{
+			DPFDEV ((DBG_WARNING, "ReserveTriBatch: Out of ISP buffer space"));
+
+			nTris = nFit;
+			bFull = TRUE;
+		}
+
+		pChunk->nFirst = nFirst;
+		pChunk->nTris = nTris;
+		pChunk->TSPAddr = PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos;
+
+		PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos += pPipe->TSPWords * nTris;
+
+		if (nTris != 0)
+		{
+			pBatch->nChunks++;
+		}
+	}
+
+	if (bFull)
+	{
+		/* buffer full so stop after this batch */
+		pPipe->nInputLeft = 0;
+	}
+}
+
+/**********************************************************************
+**
+** Packs one chunk of the current batch into the space claimed for it.
+**
+**********************************************************************/
+
+static void PackTriChunk (TRIPIPE *pPipe, TRICHUNK *pChunk, sgl_uint32 uParts)
+{
+	TRIBATCH	*pBatch = pPipe->pPack;
+	PITRI		pTri = pBatch->pTri + pChunk->nFirst;
+	PIMATERIAL	pMat = pBatch->pMat + pChunk->nFirst;
+	sgl_uint32	*pTSP;
+
+	PackISPTriAt (pTri, pChunk->nTris, pChunk->ISPPos,
+				  pChunk->TSPAddr >> 1, pPipe->TSPWords >> 1, uParts);
+
+	/* Get address of buffer in host-land */
+	pTSP = PVRParamBuffs[PVR_PARAM_TYPE_TSP].pBuffer + pChunk->TSPAddr;
+
+	if ( pPipe->pPerBuffn != NULL )
+	{
+		/* Call additonal type specific handler */
+		pPipe->pPerBuffn (pTri, pMat, pTSP, pChunk->nTris);
+	}
+	else
+	{
+		/* Call flat shading packer */
+		PackTSPFlat (pTri, pMat, pChunk->nTris, 2, pTSP);
+	}
+}
+
+#if DEBUG
+
+/**********************************************************************
+**
+** Packs the current batch again on this thread and checks that the ISP
+** and TSP data come out the same as the threaded pack left them.
+**
+**********************************************************************/
+
+static void VerifyTriBatch (TRIPIPE *pPipe, sgl_uint32 ISPEnd, sgl_uint32 TSPEnd)
+{
+	TRIBATCH	*pBatch = pPipe->pPack;
+	sgl_uint32	ISPStart, TSPStart, ISPWords, TSPWords;
+	sgl_uint32	*pISPCopy, *pTSPCopy;
+	int			k;
+
+	if (pBatch->nChunks == 0)
+	{
+		return;
+	}
+
+	ISPStart = pBatch->Chunks[0].ISPPos;
+	TSPStart = pBatch->Chunks[0].TSPAddr;
+	ISPWords = ISPEnd - ISPStart;
+	TSPWords = TSPEnd - TSPStart;
+
+	pISPCopy = SGLMalloc (ISPWords * sizeof (sgl_uint32));
+	pTSPCopy = SGLMalloc (TSPWords * sizeof (sgl_uint32));
+
+	if ((pISPCopy != NULL) && (pTSPCopy != NULL))
+	{
+		memcpy (pISPCopy, PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer + ISPStart,
+				ISPWords * sizeof (sgl_uint32));
+		memcpy (pTSPCopy, PVRParamBuffs[PVR_PARAM_TYPE_TSP].pBuffer + TSPStart,
+				TSPWords * sizeof (sgl_uint32));
+
+		for (k = 0; k < pBatch->nChunks; k++)
+		{
+			PackTriChunk (pPipe, &pBatch->Chunks[k], ISPTRI_PLANES);
+		}
+
+		if (memcmp (pISPCopy, PVRParamBuffs[PVR_PARAM_TYPE_ISP].pBuffer + ISPStart,
+					ISPWords * sizeof (sgl_uint32)) ||
+			memcmp (pTSPCopy, PVRParamBuffs[PVR_PARAM_TYPE_TSP].pBuffer + TSPStart,
+					TSPWords * sizeof (sgl_uint32)))
+		{
+			DPF ((DBG_ERROR, "VerifyTriBatch: threaded and serial packs differ"));
+			ASSERT (FALSE);
+		}
+	}
+
+	if (pISPCopy != NULL)
+	{
+		SGLFree (pISPCopy);
+	}
+
+	if (pTSPCopy != NULL)
+	{
+		SGLFree (pTSPCopy);
+	}
+}
+
+#endif
+
+/**********************************************************************
+**
+** Task 0 sets up the next batch, the others each pack one chunk of the
+** current one into the space claimed for it.
+**
+**********************************************************************/
+
+static void ProcessTriTask (void *pContext, int nTask, int nThread)
+{
+	TRIPIPE *pPipe = (TRIPIPE *) pContext;
+
+	#if DO_FPU_PRECISION
+	sgl_uint32 uSaveFPU = SglThreadSetupFPU (nThread);
+	#endif
+
+	if (pPipe->uParts & ISPTRI_REGIONS)
+	{
+		RegionBinSelect (nTask);
+	}
+
+	if (nTask == 0)
+	{
+		if (pPipe->pSetup != NULL)
+		{
+			SetupTriBatch (pPipe, pPipe->pSetup);
+		}
+	}
+	else
+	{
+		PackTriChunk (pPipe, &pPipe->pPack->Chunks[nTask - 1], pPipe->uParts);
+	}
+
+	#if DO_FPU_PRECISION
+	SglThreadRestoreFPU (nThread, uSaveFPU);
+	#endif
+}
+
+/**********************************************************************
+**
+** Threaded equivalent of ProcessTris, for batches UseThreadedTris allows.
+**
+**********************************************************************/
+
+static void ProcessTrisThreaded (PPIR pPerPolyfn, 
+								 PBPR pPerBuffn, 
+								 sgl_uint32 TSPWords)
+{
+	TRIPIPE		Pipe;
+	sgl_bool	bSerialRegions;
+	sgl_uint32	TSPControlWord = gpPDC->TSPControlWord;
+	sgl_bool	bDoClipping = gpPDC->Context.bDoClipping;
+	int			k, nBatch = 0;
+#if DEBUG
+	sgl_uint32	ISPEnd, TSPEnd;
+#endif
+
+	Pipe.pPerPolyfn = pPerPolyfn;
+	Pipe.pPerBuffn = pPerBuffn;
+	Pipe.TSPWords = TSPWords;
+	Pipe.NewObject = TRUE;
+	Pipe.nInputLeft = gpPDC->nInputTriangles;
+
+	for (k = 0; k < 2; k++)
+	{
+		Pipe.Batches[k].pTri = pThreadTri + (k * THREAD_BATCH_TRIS);
+		Pipe.Batches[k].pMat = pThreadMat + (k * THREAD_BATCH_TRIS);
+	}
+
+	/* Unless each triangle starts a new one, translucent sets span chunks */
+	bSerialRegions = (gpPDC->TSPControlWord & MASK_TRANS) &&
+					 !(gpPDC->Context.u32Flags & (SGLTT_OPAQUE | SGLTT_NEWPASSPERTRI));
+
+#if DEBUG
+	if (nThreadTriVerify < 0)
+	{
+		nThreadTriVerify = SglReadPrivateProfileInt ("Threads", "DirectTrianglesVerify",
+													 0, "sgl.ini");
+	}
+#endif
+
+	SetupTriBatch (&Pipe, &Pipe.Batches[0]);
+
+	do
+	{
+		Pipe.pPack = &Pipe.Batches[nBatch];
+
+		ReserveTriBatch (&Pipe, Pipe.pPack);
+
+	#if DEBUG
+		ISPEnd = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+		TSPEnd = PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos;
+	#endif
+
+		nBatch ^= 1;
+		Pipe.pSetup = (Pipe.nInputLeft != 0) ? &Pipe.Batches[nBatch] : NULL;
+
+		Pipe.uParts = ISPTRI_PLANES;
+
+		if (!bSerialRegions && RegionBinsBegin (Pipe.pPack->nChunks + 1))
+		{
+			Pipe.uParts |= ISPTRI_REGIONS;
+		}
+
+		SglThreadParallelFor (Pipe.pPack->nChunks + 1, ProcessTriTask, &Pipe);
+
+		/* Setup must not touch what the pack tasks read (see above) */
+		ASSERT (gpPDC->TSPControlWord == TSPControlWord);
+		ASSERT (gpPDC->Context.bDoClipping == bDoClipping);
+
+	#if DEBUG
+		if (nThreadTriVerify)
+		{
+			VerifyTriBatch (&Pipe, ISPEnd, TSPEnd);
+		}
+	#endif
+
+		if (Pipe.uParts & ISPTRI_REGIONS)
+		{
+			RegionBinsEnd ();
+		}
+		else
+		{
+			/* Add the objects to the regions in submission order */
+			for (k = 0; k < Pipe.pPack->nChunks; k++)
+			{
+				TRICHUNK *pChunk = &Pipe.pPack->Chunks[k];
+
+				PackISPTriAt (Pipe.pPack->pTri + pChunk->nFirst, pChunk->nTris,
+							  pChunk->ISPPos, 0, 0, ISPTRI_REGIONS);
+			}
+		}
+	}
+	while (Pipe.pSetup != NULL);
+
+	gpPDC->nInputTriangles = 0;
+}
+
 /**********************************************************************
 **
 **
@@ -895,6 +1376,12 @@ static void ProcessTris (PVRHANDLE TexHeap,
 	sgl_uint32	*pTSP;
 	sgl_uint32	NewObject = TRUE;
 	
+	if (UseThreadedTris ())
+	{
+		ProcessTrisThreaded (pPerPolyfn, pPerBuffn, TSPWords);
+		return;
+	}
+
 	while ( gpPDC->nInputTriangles != 0 )
 	{
 		int nBurst;
@@ -1016,7 +1503,7 @@ static void ProcessTris (PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -1036,7 +1523,7 @@ static void ProcessTris (PVRHANDLE TexHeap,
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -1188,7 +1675,7 @@ static void ProcessQuads (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn, sg
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -1208,7 +1695,7 @@ static void ProcessQuads (PVRHANDLE TexHeap, PPIR pPerPolyfn, PBPR pPerBuffn, sg
 			if ( pPerBuffn != NULL )
 			{
 				/* Call additonal type specific handler */
-				pPerBuffn (pTSP, nBurst);
+				pPerBuffn (gpTri, gpMat, pTSP, nBurst);
 			}
 			else
 			{
@@ -310,7 +310,7 @@ typedef enum
 typedef void (* PPIR)(PITRI pTri);
 
 /* per buffer pack routines */
-typedef void (* PBPR)(sgl_uint32 *pTSP, int nPolys);
+typedef void (* PBPR)(PITRI pTri, PIMATERIAL pMat, sgl_uint32 *pTSP, int nPolys);
 
 typedef int (* PROCESSCOREFN)(PPIR pAddfn);
 
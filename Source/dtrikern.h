@@ -0,0 +1,209 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: dtrikern.h,v $
+Title           :   DTRIKERN.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Body of a triangle setup kernel, written once in terms
+					of the vector macros and included by dtrisimd.c for
+					each instruction set. The includer defines
+					TRISETUP_KERNEL, TRISETUP_LANES, TRISETUP_TARGET and the
+					VF_ / VI_ macros first.
+
+					Each lane does what one pass round the ProcessTriCoreLite
+					loop does with its triangle, up to the point where the
+					region box is known. The arithmetic is done in the same
+					order, so the results match the scalar code.
+
+Program Type    :   C include file (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: dtrikern.h,v $
+
+;--
+*****************************************************************************/
+
+static TRISETUP_TARGET void TRISETUP_KERNEL (TRISETUPLANES *pLanes,
+											 const TRISETUPCONTEXT *pCtx)
+{
+	VF	X0, Y0, W0, X1, Y1, W1, X2, Y2, W2, T;
+	VF	AdjX0, AdjX1, AdjX2, fDet, fNegDet;
+	VF	mSmall, mTiny, mNegSmall, mNegTiny, mSubPixel, mCull, mFlip;
+	VF	RegMax, RegMin;
+	VF	fAddToXY = VF_SET1 (pCtx->fAddToXY);
+	VI	rX0, rY0, rX1, rY1, mClip;
+
+	V_LOAD_XYW (pLanes->pV[0], X0, Y0, W0);
+	V_LOAD_XYW (pLanes->pV[1], X1, Y1, W1);
+	V_LOAD_XYW (pLanes->pV[2], X2, Y2, W2);
+
+	X0 = VF_ADD (X0, fAddToXY);
+	X1 = VF_ADD (X1, fAddToXY);
+	X2 = VF_ADD (X2, fAddToXY);
+
+	Y0 = VF_ADD (Y0, fAddToXY);
+	Y1 = VF_ADD (Y1, fAddToXY);
+	Y2 = VF_ADD (Y2, fAddToXY);
+
+	/*
+	// Row 2 of the adjoint, and the determinant
+	*/
+	AdjX0 = VF_SUB (VF_MUL (X1, Y2), VF_MUL (X2, Y1));
+	AdjX1 = VF_SUB (VF_MUL (X2, Y0), VF_MUL (X0, Y2));
+	AdjX2 = VF_SUB (VF_MUL (X0, Y1), VF_MUL (X1, Y0));
+
+	fDet = VF_ADD (VF_ADD (AdjX0, AdjX1), AdjX2);
+	fNegDet = VF_NEG (fDet);
+
+	/*
+	// A triangle covers no pixel centre if all its X or all its Y
+	// values truncate to the same integer.
+	*/
+	{
+		VI	iA, iB, iC;
+		VI	mSameX, mSameY;
+
+		iA = VF_TOI (X0);
+		iB = VF_TOI (X1);
+		iC = VF_TOI (X2);
+		mSameX = VI_AND (VI_EQ (iA, iB), VI_EQ (iA, iC));
+
+		iA = VF_TOI (Y0);
+		iB = VF_TOI (Y1);
+		iC = VF_TOI (Y2);
+		mSameY = VI_AND (VI_EQ (iA, iB), VI_EQ (iA, iC));
+
+		mSubPixel = VI_TO_VF (VI_OR (mSameX, mSameY));
+	}
+
+	/*
+	// Small front faces are culled if they miss every pixel centre.
+	// A determinant under epsilon is a back face: cull it outright, or
+	// if it is allowed flip it and cull it if it is tiny or misses.
+	*/
+	mSmall = VF_LT (fDet, VF_SET1 (LARGE_EPSILON_AS_FLOAT));
+	mTiny  = VF_LT (fDet, VF_SET1 (EPSILON_AS_FLOAT));
+
+	mCull = VF_AND (VF_ANDNOT (mTiny, mSmall), mSubPixel);
+
+	if (pCtx->bCullBackfacing)
+	{
+		mCull = VF_OR (mCull, mTiny);
+	}
+	else
+	{
+		mNegSmall = VF_LT (fNegDet, VF_SET1 (LARGE_EPSILON_AS_FLOAT));
+		mNegTiny  = VF_LT (fNegDet, VF_SET1 (EPSILON_AS_FLOAT));
+
+		mCull = VF_OR (mCull,
+					   VF_AND (mTiny,
+							   VF_AND (mNegSmall, VF_OR (mNegTiny, mSubPixel))));
+	}
+
+	mFlip = VF_ANDNOT (mCull, mTiny);
+
+	/*
+	// Flipping swaps vertices 0 and 2, which negates the determinant and
+	// negates and reverses row 2 of the adjoint.
+	*/
+	T  = VF_SEL (mFlip, X2, X0);
+	X2 = VF_SEL (mFlip, X0, X2);
+	X0 = T;
+
+	T  = VF_SEL (mFlip, Y2, Y0);
+	Y2 = VF_SEL (mFlip, Y0, Y2);
+	Y0 = T;
+
+	T  = VF_SEL (mFlip, W2, W0);
+	W2 = VF_SEL (mFlip, W0, W2);
+	W0 = T;
+
+	fDet = VF_SEL (mFlip, fNegDet, fDet);
+
+	T	  = VF_SEL (mFlip, VF_NEG (AdjX2), AdjX0);
+	AdjX1 = VF_SEL (mFlip, VF_NEG (AdjX1), AdjX1);
+	AdjX2 = VF_SEL (mFlip, VF_NEG (AdjX0), AdjX2);
+	AdjX0 = T;
+
+	VF_STORE (pLanes->fAdjoint[2][0], AdjX0);
+	VF_STORE (pLanes->fAdjoint[2][1], AdjX1);
+	VF_STORE (pLanes->fAdjoint[2][2], AdjX2);
+
+	/*
+	// The rest of the adjoint
+	*/
+	VF_STORE (pLanes->fAdjoint[0][0], VF_SUB (Y1, Y2));
+	VF_STORE (pLanes->fAdjoint[0][1], VF_SUB (Y2, Y0));
+	VF_STORE (pLanes->fAdjoint[0][2], VF_SUB (Y0, Y1));
+
+	VF_STORE (pLanes->fAdjoint[1][0], VF_SUB (X2, X1));
+	VF_STORE (pLanes->fAdjoint[1][1], VF_SUB (X0, X2));
+	VF_STORE (pLanes->fAdjoint[1][2], VF_SUB (X1, X0));
+
+	T = VF_SET1 (pCtx->fMinInvZ);
+
+	VF_STORE (pLanes->fZ[0], VF_MUL (W0, T));
+	VF_STORE (pLanes->fZ[1], VF_MUL (W1, T));
+	VF_STORE (pLanes->fZ[2], VF_MUL (W2, T));
+
+	VF_STORE (pLanes->f1OverDet, VF_DIV (VF_SET1 (1.0f), fDet));
+
+	/*
+	// Region bounding box. The minimum is pulled in by fAddToXY unless
+	// the triangle has no width (or height).
+	*/
+	RegMax = VF_MAX (VF_MAX (X0, X1), X2);
+	RegMin = VF_MIN (VF_MIN (X0, X1), X2);
+
+	RegMin = VF_SEL (VF_LT (RegMin, RegMax), VF_SUB (RegMin, fAddToXY), RegMin);
+
+	rX0 = VI_SRA (VF_TOI (RegMin), pCtx->ShiftRegX);
+	rX1 = VI_SRA (VF_TOI (RegMax), pCtx->ShiftRegX);
+
+	RegMax = VF_MAX (VF_MAX (Y0, Y1), Y2);
+	RegMin = VF_MIN (VF_MIN (Y0, Y1), Y2);
+
+	RegMin = VF_SEL (VF_LT (RegMin, RegMax), VF_SUB (RegMin, fAddToXY), RegMin);
+
+	rY0 = VF_TOI (RegMin);
+	rY1 = VF_TOI (RegMax);
+
+	mClip = VI_SET1 (0);
+
+	if (pCtx->bDoClipping)
+	{
+		VI	First, Last;
+
+		First = VI_SET1 (pCtx->FirstXRegion);
+		Last  = VI_SET1 (pCtx->LastXRegion);
+
+		rX0 = VI_MAX (rX0, First);
+		mClip = VI_OR (mClip, VI_OR (VI_GT (First, rX1), VI_GT (rX0, Last)));
+		rX1 = VI_MIN (rX1, Last);
+
+		First = VI_SET1 (pCtx->FirstYRegion);
+		Last  = VI_SET1 (pCtx->LastYRegion);
+
+		rY0 = VI_MAX (rY0, First);
+		mClip = VI_OR (mClip, VI_OR (VI_GT (First, rY1), VI_GT (rY0, Last)));
+		rY1 = VI_MIN (rY1, Last);
+	}
+
+	VI_STORE (pLanes->Reg[0], rX0);
+	VI_STORE (pLanes->Reg[1], rY0);
+	VI_STORE (pLanes->Reg[2], rX1);
+	VI_STORE (pLanes->Reg[3], rY1);
+
+	pLanes->uFaced = ~VF_MASK (mCull) & ((1 << TRISETUP_LANES) - 1);
+	pLanes->uKept = pLanes->uFaced & ~VF_MASK (VI_TO_VF (mClip));
+	pLanes->uFlipped = VF_MASK (mFlip);
+}
+
+/*------------------------------- End of File -------------------------------*/
@@ -0,0 +1,297 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: dtrisimd.c,v $
+Title           :   Vector triangle setup
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   SSE2 and AVX2 versions of the triangle setup done by
+					ProcessTriCoreLite, for the builds that use its C
+					version. See dtrisimd.h.
+
+					The kernel body is in dtrikern.h and is built once per
+					instruction set. With gcc (and clang) on x86 every
+					kernel is built whatever the -m flags say, using the
+					target attribute, and the CPU is asked at run time which
+					ones it can run. Other compilers only get the kernels
+					their own flags allow.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: dtrisimd.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_DTRISIMD
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "pvrosapi.h"
+#include "profile.h"
+#include "dtrisimd.h"
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+	#define TRISETUP_GCC_X86	1
+#else
+	#define TRISETUP_GCC_X86	0
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define TRISETUP_SSE2		1
+	#define TRISETUP_HAS_SSE2	TRUE
+#elif TRISETUP_GCC_X86
+	#define TRISETUP_SSE2		1
+	#define TRISETUP_HAS_SSE2	__builtin_cpu_supports ("sse2")
+#else
+	#define TRISETUP_SSE2		0
+#endif
+
+#if defined (__AVX2__)
+	#define TRISETUP_AVX2		1
+	#define TRISETUP_HAS_AVX2	TRUE
+#elif TRISETUP_GCC_X86
+	#define TRISETUP_AVX2		1
+	#define TRISETUP_HAS_AVX2	__builtin_cpu_supports ("avx2")
+#else
+	#define TRISETUP_AVX2		0
+#endif
+
+/*
+// ============================================================================
+// 								SSE2 (4 LANES)
+// ============================================================================
+*/
+
+#if TRISETUP_SSE2
+
+#include <emmintrin.h>
+
+#if defined (__SSE2__) || !TRISETUP_GCC_X86
+	#define TRISETUP_TARGET
+#else
+	#define TRISETUP_TARGET		__attribute__ ((target ("sse2")))
+#endif
+
+#define TRISETUP_KERNEL		TriSetupSSE2
+#define TRISETUP_LANES		4
+
+#define VF				__m128
+#define VI				__m128i
+
+#define VF_SET1(x)		_mm_set1_ps (x)
+#define VF_STORE(p,a)	_mm_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm_add_ps ((a), (b))
+#define VF_SUB(a,b)		_mm_sub_ps ((a), (b))
+#define VF_MUL(a,b)		_mm_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm_div_ps ((a), (b))
+#define VF_MIN(a,b)		_mm_min_ps ((a), (b))
+#define VF_MAX(a,b)		_mm_max_ps ((a), (b))
+#define VF_LT(a,b)		_mm_cmplt_ps ((a), (b))
+#define VF_AND(a,b)		_mm_and_ps ((a), (b))
+#define VF_OR(a,b)		_mm_or_ps ((a), (b))
+#define VF_ANDNOT(a,b)	_mm_andnot_ps ((a), (b))
+#define VF_NEG(a)		_mm_xor_ps ((a), _mm_set1_ps (-0.0f))
+#define VF_MASK(m)		_mm_movemask_ps (m)
+#define VF_TOI(a)		_mm_cvttps_epi32 (a)
+
+#define VI_SET1(x)		_mm_set1_epi32 (x)
+#define VI_STORE(p,a)	_mm_storeu_si128 ((__m128i *) (p), (a))
+#define VI_AND(a,b)		_mm_and_si128 ((a), (b))
+#define VI_OR(a,b)		_mm_or_si128 ((a), (b))
+#define VI_EQ(a,b)		_mm_cmpeq_epi32 ((a), (b))
+#define VI_GT(a,b)		_mm_cmpgt_epi32 ((a), (b))
+#define VI_SRA(a,n)		_mm_sra_epi32 ((a), _mm_cvtsi32_si128 (n))
+#define VI_TO_VF(a)		_mm_castsi128_ps (a)
+
+/* No packed 32 bit min and max before SSE4.1 */
+#define VI_SEL(m,a,b)	_mm_or_si128 (_mm_and_si128 ((m), (a)), _mm_andnot_si128 ((m), (b)))
+#define VI_MAX(a,b)		VI_SEL (_mm_cmpgt_epi32 ((a), (b)), (a), (b))
+#define VI_MIN(a,b)		VI_SEL (_mm_cmpgt_epi32 ((a), (b)), (b), (a))
+
+#define VF_SEL(m,a,b)	_mm_or_ps (_mm_and_ps ((m), (a)), _mm_andnot_ps ((m), (b)))
+
+/*
+// Loads fX, fY, fZ, fInvW of four vertices and transposes them, keeping
+// the X, Y and 1/w rows.
+*/
+#define V_LOAD_XYW(ppV, X, Y, W)									\
+{																	\
+	__m128 r0 = _mm_loadu_ps (&(ppV)[0]->fX);						\
+	__m128 r1 = _mm_loadu_ps (&(ppV)[1]->fX);						\
+	__m128 r2 = _mm_loadu_ps (&(ppV)[2]->fX);						\
+	__m128 r3 = _mm_loadu_ps (&(ppV)[3]->fX);						\
+	__m128 t0 = _mm_unpacklo_ps (r0, r1);							\
+	__m128 t1 = _mm_unpacklo_ps (r2, r3);							\
+	__m128 t2 = _mm_unpackhi_ps (r0, r1);							\
+	__m128 t3 = _mm_unpackhi_ps (r2, r3);							\
+	(X) = _mm_movelh_ps (t0, t1);									\
+	(Y) = _mm_movehl_ps (t1, t0);									\
+	(W) = _mm_movehl_ps (t3, t2);									\
+}
+
+#include "dtrikern.h"
+
+#undef TRISETUP_TARGET
+#undef TRISETUP_KERNEL
+#undef TRISETUP_LANES
+#undef VF
+#undef VI
+#undef VF_SET1
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_MIN
+#undef VF_MAX
+#undef VF_LT
+#undef VF_AND
+#undef VF_OR
+#undef VF_ANDNOT
+#undef VF_NEG
+#undef VF_MASK
+#undef VF_TOI
+#undef VF_SEL
+#undef VI_SET1
+#undef VI_STORE
+#undef VI_AND
+#undef VI_OR
+#undef VI_EQ
+#undef VI_GT
+#undef VI_SRA
+#undef VI_TO_VF
+#undef VI_SEL
+#undef VI_MAX
+#undef VI_MIN
+#undef V_LOAD_XYW
+
+#endif /* TRISETUP_SSE2 */
+
+/*
+// ============================================================================
+// 								AVX2 (8 LANES)
+// ============================================================================
+*/
+
+#if TRISETUP_AVX2
+
+#include <immintrin.h>
+
+#if defined (__AVX2__) || !TRISETUP_GCC_X86
+	#define TRISETUP_TARGET
+#else
+	#define TRISETUP_TARGET		__attribute__ ((target ("avx2")))
+#endif
+
+#define TRISETUP_KERNEL		TriSetupAVX2
+#define TRISETUP_LANES		8
+
+#define VF				__m256
+#define VI				__m256i
+
+#define VF_SET1(x)		_mm256_set1_ps (x)
+#define VF_STORE(p,a)	_mm256_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm256_add_ps ((a), (b))
+#define VF_SUB(a,b)		_mm256_sub_ps ((a), (b))
+#define VF_MUL(a,b)		_mm256_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm256_div_ps ((a), (b))
+#define VF_MIN(a,b)		_mm256_min_ps ((a), (b))
+#define VF_MAX(a,b)		_mm256_max_ps ((a), (b))
+#define VF_LT(a,b)		_mm256_cmp_ps ((a), (b), _CMP_LT_OS)
+#define VF_AND(a,b)		_mm256_and_ps ((a), (b))
+#define VF_OR(a,b)		_mm256_or_ps ((a), (b))
+#define VF_ANDNOT(a,b)	_mm256_andnot_ps ((a), (b))
+#define VF_NEG(a)		_mm256_xor_ps ((a), _mm256_set1_ps (-0.0f))
+#define VF_MASK(m)		_mm256_movemask_ps (m)
+#define VF_TOI(a)		_mm256_cvttps_epi32 (a)
+#define VF_SEL(m,a,b)	_mm256_blendv_ps ((b), (a), (m))
+
+#define VI_SET1(x)		_mm256_set1_epi32 (x)
+#define VI_STORE(p,a)	_mm256_storeu_si256 ((__m256i *) (p), (a))
+#define VI_AND(a,b)		_mm256_and_si256 ((a), (b))
+#define VI_OR(a,b)		_mm256_or_si256 ((a), (b))
+#define VI_EQ(a,b)		_mm256_cmpeq_epi32 ((a), (b))
+#define VI_GT(a,b)		_mm256_cmpgt_epi32 ((a), (b))
+#define VI_SRA(a,n)		_mm256_sra_epi32 ((a), _mm_cvtsi32_si128 (n))
+#define VI_MAX(a,b)		_mm256_max_epi32 ((a), (b))
+#define VI_MIN(a,b)		_mm256_min_epi32 ((a), (b))
+#define VI_TO_VF(a)		_mm256_castsi256_ps (a)
+
+/*
+// As the SSE2 version, with vertices 0-3 in the low half of each register
+// and 4-7 in the high half. The shuffles work within each half.
+*/
+#define V_LOAD_ROW(ppV, k)											\
+	_mm256_insertf128_ps (_mm256_castps128_ps256 (					\
+		_mm_loadu_ps (&(ppV)[k]->fX)), _mm_loadu_ps (&(ppV)[(k)+4]->fX), 1)
+
+#define V_LOAD_XYW(ppV, X, Y, W)									\
+{																	\
+	__m256 r0 = V_LOAD_ROW (ppV, 0);								\
+	__m256 r1 = V_LOAD_ROW (ppV, 1);								\
+	__m256 r2 = V_LOAD_ROW (ppV, 2);								\
+	__m256 r3 = V_LOAD_ROW (ppV, 3);								\
+	__m256 t0 = _mm256_unpacklo_ps (r0, r1);						\
+	__m256 t1 = _mm256_unpacklo_ps (r2, r3);						\
+	__m256 t2 = _mm256_unpackhi_ps (r0, r1);						\
+	__m256 t3 = _mm256_unpackhi_ps (r2, r3);						\
+	(X) = _mm256_shuffle_ps (t0, t1, 0x44);							\
+	(Y) = _mm256_shuffle_ps (t0, t1, 0xEE);							\
+	(W) = _mm256_shuffle_ps (t2, t3, 0xEE);							\
+}
+
+#include "dtrikern.h"
+
+#endif /* TRISETUP_AVX2 */
+
+/*
+// ============================================================================
+// 								DISPATCH
+// ============================================================================
+*/
+
+int TriSetupSelect (TRISETUPFN *pfnSetup)
+{
+	int nMaxLanes;
+
+	nMaxLanes = SglReadPrivateProfileInt ("Direct", "SetupLanes",
+										  TRISETUP_MAX_LANES, "sgl.ini");
+
+	*pfnSetup = NULL;
+
+	#if TRISETUP_GCC_X86
+		__builtin_cpu_init ();
+	#endif
+
+	#if TRISETUP_AVX2
+
+		if ((nMaxLanes >= 8) && TRISETUP_HAS_AVX2)
+		{
+			*pfnSetup = TriSetupAVX2;
+			return (8);
+		}
+
+	#endif
+
+	#if TRISETUP_SSE2
+
+		if ((nMaxLanes >= 4) && TRISETUP_HAS_SSE2)
+		{
+			*pfnSetup = TriSetupSSE2;
+			return (4);
+		}
+
+	#endif
+
+	return (1);
+}
+
+/* dtrisimd.c */
@@ -0,0 +1,100 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: dtrisimd.h,v $
+Title           :   DTRISIMD.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Vector triangle setup for the C version of
+					ProcessTriCoreLite. A kernel takes a group of triangles
+					by vertex pointer, works out their adjoints,
+					determinants, depths and region boxes a lane per
+					triangle, and says which of them to keep. Everything
+					stateful (the translucent set marks, bogus Z and the
+					per polygon routines) stays with the caller, which
+					walks the lanes in order.
+
+					The widest kernel the CPU can run is picked at run
+					time. Builds whose compiler has no SSE2 have no kernel
+					at all and keep the one at a time loop.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: dtrisimd.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __DTRISIMD_H__
+#define __DTRISIMD_H__
+
+/* Widest group any kernel handles */
+#define TRISETUP_MAX_LANES	8
+
+/*
+// The bits of the PROCESSDATACONTEXT and friends that the kernels read,
+// gathered once per call so the kernels need no globals.
+*/
+typedef struct tagTRISETUPCONTEXT
+{
+	float		fAddToXY;
+	float		fMinInvZ;
+	int			ShiftRegX;
+	sgl_bool	bCullBackfacing;
+	sgl_bool	bDoClipping;
+	int			FirstXRegion;
+	int			FirstYRegion;
+	int			LastXRegion;
+	int			LastYRegion;
+
+} TRISETUPCONTEXT;
+
+/*
+// One group of triangles in structure of arrays form. The caller fills
+// pV (padding any unused lanes with a real triangle); the kernel fills in
+// the rest. The region values are int, as they are stored a lane at a time. For flipped faces vertices 0 and 2 have been swapped in the
+// results, but not in pV.
+*/
+typedef struct tagTRISETUPLANES
+{
+	const SGLVERTEX	*pV[3][TRISETUP_MAX_LANES];
+
+	float		fAdjoint[3][3][TRISETUP_MAX_LANES];
+	float		f1OverDet[TRISETUP_MAX_LANES];
+	float		fZ[3][TRISETUP_MAX_LANES];
+	int			Reg[4][TRISETUP_MAX_LANES];		/* rX0, rY0, rX1, rY1 */
+
+	sgl_uint32	uFaced;			/* lanes that passed the face culling */
+	sgl_uint32	uKept;			/* ... and are inside the clip regions */
+	sgl_uint32	uFlipped;		/* lanes with vertices 0 and 2 swapped */
+
+} TRISETUPLANES;
+
+typedef void (* TRISETUPFN)(TRISETUPLANES *pLanes, const TRISETUPCONTEXT *pCtx);
+
+/*===========================================
+ * Function:	TriSetupSelect
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Picks the widest kernel the CPU supports, unless the
+ *				[Direct] SetupLanes entry in sgl.ini asks for a narrower
+ *				one (1 turns the kernels off).
+ *
+ * Params:		TRISETUPFN *pfnSetup: receives the kernel
+ *
+ * Return:		Lanes the kernel handles per call, or 1 if there is none.
+ *========================================================================================*/
+int TriSetupSelect (TRISETUPFN *pfnSetup);
+
+#endif /* __DTRISIMD_H__ */
+
+/*------------------------------- End of File -------------------------------*/
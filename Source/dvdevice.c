@@ -319,6 +319,9 @@ int	CALL_CONV sgl_create_screen_device ( int device_number,
 #if ISPTSP
 	DEVICE_REGION_INFO_STRUCT RegionInfo;
 #endif
+
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -432,7 +435,7 @@ int	CALL_CONV sgl_create_screen_device ( int device_number,
 
 	
 	pNode->node_hdr.n16_node_type = (sgl_int16) nt_device;
-	pNode->node_hdr.n16_name	  = (sgl_int16) name;
+	pNode->node_hdr.n32_name	  = (sgl_int32) name;
 	pNode->node_hdr.next_node	  = NULL;
 
 	pNode->pLastViewport = NULL; 
@@ -616,6 +619,8 @@ void CALL_CONV sgl_delete_device( int device )
 	VIEWPORT_NODE_STRUCT *vNode;
 	DL_NODE_STRUCT	*nextNode;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -657,7 +662,7 @@ void CALL_CONV sgl_delete_device( int device )
 
 	   	nextNode = nextNode->next_node;
 
-	    DeleteNamedItem(dlUserGlobals.pNamtab,vNode->node_hdr.n16_name);
+	    DeleteNamedItem(dlUserGlobals.pNamtab,vNode->node_hdr.n32_name);
 
 		SGLFree(vNode);
 	}
@@ -709,6 +714,8 @@ int CALL_CONV sgl_create_viewport( int parent_device,
 	int y;
 	sgl_uint32 XRegionBits;
 	DEVICE_REGION_INFO_STRUCT RegionInfo;
+
+	DlMarkEdited ();
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -792,7 +799,7 @@ int CALL_CONV sgl_create_viewport( int parent_device,
 
 
 	vNode->node_hdr.n16_node_type = (sgl_int16) nt_viewport;
-	vNode->node_hdr.n16_name	  = (sgl_int16) name;
+	vNode->node_hdr.n32_name	  = (sgl_int32) name;
 	vNode->node_hdr.next_node	  = NULL;
 
 	vNode->Left = left;
@@ -1005,6 +1012,8 @@ int	CALL_CONV sgl_set_viewport( int viewport,
 	sgl_uint32 XRegionBits;
 	DEVICE_REGION_INFO_STRUCT RegionInfo;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1127,6 +1136,8 @@ void CALL_CONV sgl_subtract_viewport( int viewport,
     VIEWPORT_NODE_STRUCT * vNode, *vRemovedNode;
 	int y;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1233,6 +1244,8 @@ void CALL_CONV sgl_delete_viewport( int viewport )
     DEVICE_NODE_STRUCT 		* dNode;
 	DL_NODE_STRUCT			* pPrevious;
 
+	DlMarkEdited ();
+
   	/*	
 		Initialise sgl if this hasn't yet been done		
 	*/
@@ -1314,7 +1327,7 @@ void CALL_CONV sgl_delete_viewport( int viewport )
 
 	/* set the node free */
 
-    DeleteNamedItem(dlUserGlobals.pNamtab,vNode->node_hdr.n16_name);
+    DeleteNamedItem(dlUserGlobals.pNamtab,vNode->node_hdr.n32_name);
 
 	SGLFree(vNode);
 
@@ -0,0 +1,281 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: frmpipe.c,v $
+Title           :   Frame pipeline
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Render fences and the pipeline depth. See frmpipe.h.
+
+					The fences are two counters: the last fence issued,
+					which only the thread submitting renders moves, and
+					the last retired, which the back end moves (possibly
+					from a thread of its own).
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: frmpipe.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_FRMPIPE
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "pvrosapi.h"
+#include "hwinterf.h"
+#include "profile.h"
+#include "sglthrd.h"
+#include "frmpipe.h"
+
+static int					nDepth = 0;
+
+static volatile FRAME_FENCE	u32Issued = 0;
+static volatile FRAME_FENCE	u32Retired = 0;
+
+static sgl_bool				bBackEndSignals = FALSE;
+static SGLEVENT				hRetired = NULL;
+
+/*===========================================
+ * Function:	FramePipeDepth
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the pipeline depth, reading it from sgl.ini the
+ *				first time.
+ *
+ * Params:		void
+ *
+ * Return:		int: 1 .. FRAME_PIPE_MAX_DEPTH
+ *========================================================================================*/
+int FramePipeDepth (void)
+{
+	if (nDepth == 0)
+	{
+		nDepth = SglReadPrivateProfileInt ("Render", "PipelineDepth", 2, "sgl.ini");
+
+		if (nDepth < 1)
+		{
+			nDepth = 1;
+		}
+		else if (nDepth > FRAME_PIPE_MAX_DEPTH)
+		{
+			nDepth = FRAME_PIPE_MAX_DEPTH;
+		}
+	}
+
+	return (nDepth);
+}
+
+/*===========================================
+ * Function:	FramePipeSetSignalled
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Says whether the back end retires fences itself, from
+ *				another thread, so that waits can sleep on an event
+ *				instead of polling HWFinishedRender.
+ *
+ * Params:		sgl_bool bSignalled
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeSetSignalled (sgl_bool bSignalled)
+{
+	if (bSignalled && (hRetired == NULL))
+	{
+		hRetired = SglEventCreate (FALSE, FALSE);
+
+		if (hRetired == NULL)
+		{
+			/* Fall back to polling */
+			bSignalled = FALSE;
+		}
+	}
+
+	bBackEndSignals = bSignalled;
+}
+
+/*===========================================
+ * Function:	FramePipeIssue
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Called by the back end as it starts a render.
+ *
+ * Params:		void
+ *
+ * Return:		FRAME_FENCE: the fence for the new render
+ *========================================================================================*/
+FRAME_FENCE FramePipeIssue (void)
+{
+	FRAME_FENCE Fence = u32Issued + 1;
+
+	/* Skip 0, which means "nothing to wait for" */
+	if (Fence == 0)
+	{
+		Fence = 1;
+	}
+
+	u32Issued = Fence;
+
+	return (Fence);
+}
+
+/*===========================================
+ * Function:	FramePipeLastIssued
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the fence of the most recently started render.
+ *
+ * Params:		void
+ *
+ * Return:		FRAME_FENCE
+ *========================================================================================*/
+FRAME_FENCE FramePipeLastIssued (void)
+{
+	return (u32Issued);
+}
+
+/*===========================================
+ * Function:	FramePipeRetire
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Called by the back end when the render with the given
+ *				fence, and every one before it, has finished.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeRetire (FRAME_FENCE Fence)
+{
+	if ((sgl_int32) (Fence - u32Retired) > 0)
+	{
+		u32Retired = Fence;
+
+		if (bBackEndSignals)
+		{
+			SglEventSet (hRetired);
+		}
+	}
+}
+
+/*===========================================
+ * Function:	FramePipeIsDone
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Tests a fence without waiting.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		TRUE if the render has finished
+ *========================================================================================*/
+sgl_bool FramePipeIsDone (FRAME_FENCE Fence)
+{
+	return ((Fence == 0) || ((sgl_int32) (u32Retired - Fence) >= 0));
+}
+
+/*===========================================
+ * Function:	FramePipeWait
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Waits until a fence is retired.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeWait (FRAME_FENCE Fence)
+{
+	/* Nobody will ever retire a fence that has not been issued */
+	if ((sgl_int32) (Fence - u32Issued) > 0)
+	{
+		Fence = u32Issued;
+	}
+
+	while (!FramePipeIsDone (Fence))
+	{
+		if (bBackEndSignals)
+		{
+			/* Auto reset, so a retire before we got here is not lost */
+			SglEventWait (hRetired);
+		}
+		else if (HWFinishedRender ())
+		{
+			/* Nothing is rendering, so everything issued is done */
+			FramePipeRetire (u32Issued);
+		}
+		else
+		{
+			/* Give up the rest of the time slice */
+			PVROSDelay (PVR_DELAY_MS, 0);
+		}
+	}
+}
+
+/*===========================================
+ * Function:	FramePipeBeginFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Called before a new frame takes its parameter buffers.
+ *				Waits until no more than depth - 1 renders are still
+ *				outstanding.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeBeginFrame (void)
+{
+	FRAME_FENCE uAhead = (FRAME_FENCE) (FramePipeDepth () - 1);
+
+	if (u32Issued > uAhead)
+	{
+		FramePipeWait (u32Issued - uAhead);
+	}
+}
+
+/*===========================================
+ * Function:	FramePipeEndFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Called once a frame's render has been started. With a
+ *				depth of 1 it waits for the render to finish.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeEndFrame (void)
+{
+	if (FramePipeDepth () == 1)
+	{
+		FramePipeWait (u32Issued);
+	}
+}
+
+/* frmpipe.c */
@@ -0,0 +1,189 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: frmpipe.h,v $
+Title           :   FRMPIPE.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Frame pipeline. Lets the application build one frame
+					while earlier ones are still rendering, up to a depth
+					set by the [Render] PipelineDepth entry of sgl.ini:
+
+						1	every frame is rendered before sgl_render (or
+							sgltri_render) returns
+						2	one frame renders while the next is built (the
+							default, and what the drivers always did)
+						3	two frames may be queued behind the one being
+							built, where the back end can hold them
+
+					Each render the back end starts is given a fence, a
+					sequence number that is retired when the render has
+					finished. Waiting for a fence sleeps on an event when
+					the back end can signal completion itself (the
+					simulator's render thread), and otherwise polls the
+					back end with HWFinishedRender, giving the CPU away
+					between polls rather than spinning on the bus.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: frmpipe.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __FRMPIPE_H__
+#define __FRMPIPE_H__
+
+/* Deepest pipeline allowed */
+#define FRAME_PIPE_MAX_DEPTH	3
+
+/*
+// Fences count up from 1; fence 0 is always retired. Compare them with
+// FramePipeIsDone rather than directly, as they wrap.
+*/
+typedef sgl_uint32 FRAME_FENCE;
+
+/*===========================================
+ * Function:	FramePipeDepth
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the pipeline depth, reading it from sgl.ini the
+ *				first time.
+ *
+ * Params:		void
+ *
+ * Return:		int: 1 .. FRAME_PIPE_MAX_DEPTH
+ *========================================================================================*/
+int FramePipeDepth (void);
+
+/*===========================================
+ * Function:	FramePipeSetSignalled
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Says whether the back end retires fences itself, from
+ *				another thread, so that waits can sleep on an event
+ *				instead of polling HWFinishedRender.
+ *
+ * Params:		sgl_bool bSignalled
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeSetSignalled (sgl_bool bSignalled);
+
+/*===========================================
+ * Function:	FramePipeIssue
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Called by the back end as it starts a render.
+ *
+ * Params:		void
+ *
+ * Return:		FRAME_FENCE: the fence for the new render
+ *========================================================================================*/
+FRAME_FENCE FramePipeIssue (void);
+
+/*===========================================
+ * Function:	FramePipeLastIssued
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the fence of the most recently started render.
+ *
+ * Params:		void
+ *
+ * Return:		FRAME_FENCE
+ *========================================================================================*/
+FRAME_FENCE FramePipeLastIssued (void);
+
+/*===========================================
+ * Function:	FramePipeRetire
+ *===========================================
+ *
+ * Scope:		SGL (back ends)
+ *
+ * Purpose:		Called by the back end when the render with the given
+ *				fence, and every one before it, has finished. Retiring a
+ *				fence that is already retired does nothing.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeRetire (FRAME_FENCE Fence);
+
+/*===========================================
+ * Function:	FramePipeIsDone
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Tests a fence without waiting.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		TRUE if the render has finished
+ *========================================================================================*/
+sgl_bool FramePipeIsDone (FRAME_FENCE Fence);
+
+/*===========================================
+ * Function:	FramePipeWait
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Waits until a fence is retired.
+ *
+ * Params:		FRAME_FENCE Fence
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeWait (FRAME_FENCE Fence);
+
+/*===========================================
+ * Function:	FramePipeBeginFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Called before a new frame takes its parameter buffers.
+ *				Waits until no more than depth - 1 renders are still
+ *				outstanding.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeBeginFrame (void);
+
+/*===========================================
+ * Function:	FramePipeEndFrame
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Called once a frame's render has been started. With a
+ *				depth of 1 it waits for the render to finish.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void FramePipeEndFrame (void);
+
+#endif /* __FRMPIPE_H__ */
+
+/*------------------------------- End of File -------------------------------*/
@@ -158,6 +158,9 @@ char TexturePath[]="";						/* path to texture directory */
 static PLIST 	gpTextureCache = NULL;		/* root of texture cache list */
 static sgl_bool gbCacheInitialised = FALSE;	/* TRUE if cache is initialised, FALSE if not */
 
+#define CACHE_BY_DATA	0					/* cache list index keyed on the filename */
+#define CACHE_BY_NAME	1					/* cache list index keyed on the texture name */
+
 /*========================================================================================*/
 /*========================================================================================*/
 /*									STATIC FUNCTIONS									  */
@@ -234,6 +237,56 @@ static int OnFindCacheEntryByName (PCVOID pData, sgl_uint32 u32Extra)
 	return (pCE->nTextureName == (int) u32Extra);
 }
 
+/*===========================================
+ * Function:    OnKeyCacheEntryByData
+ *===========================================
+ *
+ * Scope:	      static to this module
+ *
+ * Purpose:	      Key of a cache entry in the CACHE_BY_DATA index: a hash
+ *				  (FNV-1a) of the filename
+ *
+ * Params:	      void *pData - pointer to the cache entry
+ *
+ * Return:	      key
+ *========================================================================================*/
+static sgl_uint32 OnKeyCacheEntryByData (void *pData)
+{
+	PTEXCACHEENTRY pCE = (PTEXCACHEENTRY) pData;
+	sgl_uint32 u32Key = 2166136261UL;
+	int k;
+
+	ASSERT (pCE != NULL);
+
+	for (k = 0; (k < 128) && pCE->data.szFileName[k]; ++k)
+	{
+		u32Key = ((u32Key ^ (unsigned char) pCE->data.szFileName[k]) * 16777619UL) & 0xFFFFFFFFUL;
+	}
+
+	return (u32Key);
+}
+
+/*===========================================
+ * Function:    OnKeyCacheEntryByName
+ *===========================================
+ *
+ * Scope:	      static to this module
+ *
+ * Purpose:	      Key of a cache entry in the CACHE_BY_NAME index
+ *
+ * Params:	      void *pData - pointer to the cache entry
+ *
+ * Return:	      key
+ *========================================================================================*/
+static sgl_uint32 OnKeyCacheEntryByName (void *pData)
+{
+	PTEXCACHEENTRY pCE = (PTEXCACHEENTRY) pData;
+
+	ASSERT (pCE != NULL);
+
+	return ((sgl_uint32) pCE->nTextureName);
+}
+
 /*===========================================
  * Function:    InitBMPTextureCache
  *===========================================
@@ -251,6 +304,16 @@ static sgl_bool InitBMPTextureCache ()
 	if (!gbCacheInitialised)
 	{
 		gbCacheInitialised = ListInitialiseList (&gpTextureCache, sizeof (TEXCACHEENTRY), 20, OnDeleteCacheEntry);
+
+		/* 
+		// Without the indexes the cache is just searched, so failing
+		// to add them doesn't matter
+		*/
+		if (gbCacheInitialised)
+		{
+			ListAddIndex (gpTextureCache, CACHE_BY_DATA, OnKeyCacheEntryByData);
+			ListAddIndex (gpTextureCache, CACHE_BY_NAME, OnKeyCacheEntryByName);
+		}
 	}
 	return (gbCacheInitialised);
 }
@@ -349,8 +412,8 @@ int CALL_CONV LoadBMPTexture( char *pszFilename, sgl_bool bTranslucent,
 			CE.data.generate_mipmap = generate_mipmap;
 			CE.data.dither = dither;
 	
-			pFCE = ListFindItem (gpTextureCache, (FINDITEMFN)OnFindCacheEntryByData,
-												 (sgl_uint32) &CE);
+			pFCE = ListFindKeyedItem (gpTextureCache, CACHE_BY_DATA, OnKeyCacheEntryByData (&CE),
+									  (FINDITEMFN)OnFindCacheEntryByData, (sgl_uint32) &CE);
 			
 			if (pFCE)
 			{
@@ -458,15 +521,15 @@ void CALL_CONV FreeBMPTexture( int nTextureName )
 	}
 	else
 	{
-		pFCE = ListFindItem (gpTextureCache, (FINDITEMFN)OnFindCacheEntryByName, 
-											 (sgl_uint32) nTextureName);
+		pFCE = ListFindKeyedItem (gpTextureCache, CACHE_BY_NAME, (sgl_uint32) nTextureName,
+								  (FINDITEMFN)OnFindCacheEntryByName, (sgl_uint32) nTextureName);
 	
 		if (pFCE)
 		{
 			if (--pFCE->nUsageCount == 0)
 			{
-				ListRemoveItem (gpTextureCache, (FINDITEMFN)OnFindCacheEntryByName, 
-												(sgl_uint32) nTextureName);
+				ListRemoveKeyedItem (gpTextureCache, CACHE_BY_NAME, (sgl_uint32) nTextureName,
+									 (FINDITEMFN)OnFindCacheEntryByName, (sgl_uint32) nTextureName);
 			}
 			else
 			{
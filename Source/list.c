@@ -224,6 +224,253 @@ static sgl_bool ExpandList (PLIST pvListData)
 	return (pList->pList != NULL);
 }
 
+/*
+// A keyed index: a chained hash table of item numbers. Item numbers
+// rather than pointers are kept, as the items move when the list grows.
+// The per item arrays are indexed by item number, and items are only
+// keyed when the index is next used, by which time the client has
+// filled them in.
+*/
+typedef struct tagLISTINDEX
+{
+	KEYITEMFN	pfnKeyItem;
+	int			nIndexed;		/* items 0 .. nIndexed-1 are in the table */
+	int			nSize;			/* entries in pnNext and pu32Keys */
+	int			nBucketBits;
+	int			*pnHeads;		/* first item in each bucket, or NULL_ITEM */
+	int			*pnNext;		/* next item in the same bucket, or NULL_ITEM */
+	sgl_uint32	*pu32Keys;		/* key of each item */
+
+} LISTINDEX;
+
+#define MIN_INDEX_BITS 4
+
+#define INDEX_BUCKET(pIndex, uKey) \
+	((int) ((((uKey) * 0x9E3779B9UL) & 0xFFFFFFFFUL) >> (32 - (pIndex)->nBucketBits)))
+
+static void LinkItem (LISTINDEX *pIndex, int nItem)
+{
+	int nBucket = INDEX_BUCKET (pIndex, pIndex->pu32Keys[nItem]);
+
+	pIndex->pnNext[nItem] = pIndex->pnHeads[nBucket];
+	pIndex->pnHeads[nBucket] = nItem;
+}
+
+static void UnlinkItem (LISTINDEX *pIndex, int nItem)
+{
+	int *pnLink = &pIndex->pnHeads[INDEX_BUCKET (pIndex, pIndex->pu32Keys[nItem])];
+
+	while (*pnLink != nItem)
+	{
+		ASSERT (*pnLink != NULL_ITEM);
+		pnLink = &pIndex->pnNext[*pnLink];
+	}
+
+	*pnLink = pIndex->pnNext[nItem];
+}
+
+/*===========================================
+ * Function:	GrowIndex
+ *===========================================
+ *
+ * Scope:		Static to this module
+ *
+ * Purpose:		Makes room in an index for nItems items, with at least as many
+ *				buckets as items.
+ *
+ * Params:		LISTINDEX *pIndex
+ *				int nItems
+ *
+ * Return:		TRUE if successful
+ *========================================================================================*/
+static sgl_bool GrowIndex (LISTINDEX *pIndex, int nItems)
+{
+	int nBits, k;
+
+	if (nItems > pIndex->nSize)
+	{
+		int 		nSize = pIndex->nSize * 2;
+		int 		*pnNext;
+		sgl_uint32	*pu32Keys;
+
+		if (nSize < nItems)
+		{
+			nSize = nItems;
+		}
+
+		pnNext = InternalRealloc (pIndex->pnNext, nSize * sizeof (int));
+
+		if (!pnNext)
+		{
+			return (FALSE);
+		}
+
+		pIndex->pnNext = pnNext;
+
+		pu32Keys = InternalRealloc (pIndex->pu32Keys, nSize * sizeof (sgl_uint32));
+
+		if (!pu32Keys)
+		{
+			return (FALSE);
+		}
+
+		pIndex->pu32Keys = pu32Keys;
+		pIndex->nSize = nSize;
+	}
+
+	for (nBits = MIN_INDEX_BITS; (nBits < 30) && ((1 << nBits) < nItems); ++nBits)
+	{
+		/* Nothing */
+	}
+
+	if (nBits > pIndex->nBucketBits)
+	{
+		int *pnHeads = SGLMalloc ((1 << nBits) * sizeof (int));
+
+		if (!pnHeads)
+		{
+			/* Longer chains, but still right */
+			return (pIndex->pnHeads != NULL);
+		}
+
+		for (k = 0; k < (1 << nBits); ++k)
+		{
+			pnHeads[k] = NULL_ITEM;
+		}
+
+		if (pIndex->pnHeads)
+		{
+			SGLFree (pIndex->pnHeads);
+		}
+
+		pIndex->pnHeads = pnHeads;
+		pIndex->nBucketBits = nBits;
+
+		for (k = 0; k < pIndex->nIndexed; ++k)
+		{
+			LinkItem (pIndex, k);
+		}
+	}
+
+	return (TRUE);
+}
+
+/*===========================================
+ * Function:	CatchUpIndex
+ *===========================================
+ *
+ * Scope:		Static to this module
+ *
+ * Purpose:		Keys any items added since an index was last used.
+ *
+ * Params:		LIST *pList
+ *				int nIndex
+ *
+ * Return:		LISTINDEX *: the index, or NULL if there isn't one or it
+ *							 couldn't be grown
+ *========================================================================================*/
+static LISTINDEX *CatchUpIndex (LIST *pList, int nIndex)
+{
+	LISTINDEX *pIndex;
+
+	ASSERT ((nIndex >= 0) && (nIndex < LIST_MAX_INDEXES));
+
+	pIndex = pList->pIndex[nIndex];
+
+	if (pIndex && (pIndex->nIndexed < pList->nItemsInList))
+	{
+		int k;
+
+		if (!GrowIndex (pIndex, pList->nItemsInList))
+		{
+			DPF ((DBG_WARNING, "CatchUpIndex: no memory, searching instead"));
+			return (NULL);
+		}
+
+		for (k = pIndex->nIndexed; k < pList->nItemsInList; ++k)
+		{
+			pIndex->pu32Keys[k] = pIndex->pfnKeyItem ((void *) ((sgl_uint32) pList->pList + (k * pList->uItemSize)));
+			LinkItem (pIndex, k);
+		}
+
+		pIndex->nIndexed = pList->nItemsInList;
+	}
+
+	return (pIndex);
+}
+
+/*===========================================
+ * Function:	RemoveFromIndexes
+ *===========================================
+ *
+ * Scope:		Static to this module
+ *
+ * Purpose:		Takes an item out of the list's indexes and renumbers the items
+ *				after it, which are about to move down one.
+ *
+ * Params:		LIST *pList
+ *				int nItem
+ *
+ * Return:		void
+ *========================================================================================*/
+static void RemoveFromIndexes (LIST *pList, int nItem)
+{
+	int n, k;
+
+	for (n = 0; n < LIST_MAX_INDEXES; ++n)
+	{
+		LISTINDEX *pIndex = pList->pIndex[n];
+
+		if (pIndex && (nItem < pIndex->nIndexed))
+		{
+			UnlinkItem (pIndex, nItem);
+
+			memmove (&pIndex->pnNext[nItem], &pIndex->pnNext[nItem + 1], 
+					 (pIndex->nIndexed - (nItem + 1)) * sizeof (int));
+			memmove (&pIndex->pu32Keys[nItem], &pIndex->pu32Keys[nItem + 1], 
+					 (pIndex->nIndexed - (nItem + 1)) * sizeof (sgl_uint32));
+
+			--pIndex->nIndexed;
+
+			for (k = 0; k < (1 << pIndex->nBucketBits); ++k)
+			{
+				if (pIndex->pnHeads[k] > nItem)
+				{
+					--pIndex->pnHeads[k];
+				}
+			}
+
+			for (k = 0; k < pIndex->nIndexed; ++k)
+			{
+				if (pIndex->pnNext[k] > nItem)
+				{
+					--pIndex->pnNext[k];
+				}
+			}
+		}
+	}
+}
+
+static void DeleteIndex (LISTINDEX *pIndex)
+{
+	if (pIndex->pnHeads)
+	{
+		SGLFree (pIndex->pnHeads);
+	}
+
+	if (pIndex->pnNext)
+	{
+		SGLFree (pIndex->pnNext);
+	}
+
+	if (pIndex->pu32Keys)
+	{
+		SGLFree (pIndex->pu32Keys);
+	}
+
+	SGLFree (pIndex);
+}
+
 /*
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -386,6 +633,8 @@ sgl_bool ListRemoveItem (PLIST pvListData, FINDITEMFN pfnFindItem, sgl_uint32 wF
 
 		if (pItem != NULL)
 		{
+			RemoveFromIndexes (pList, which);
+
 			#if defined sun || defined sparc
 
 				int i;
@@ -472,6 +721,7 @@ sgl_bool ListEnumItems (PLIST pvListData, ENUMITEMFN pfnEnumItems, sgl_uint32 wE
 sgl_bool ListInitialiseList (PLIST *ppvListData, sgl_uint32 uItemSize, sgl_uint32 uBlockSize, DESTROYITEMFN pfnOnDestroyItem)
 {
 	LIST *pList = SGLMalloc (sizeof (LIST));
+	int k;
 
 	ASSERT (ppvListData != NULL);
 
@@ -494,6 +744,11 @@ sgl_bool ListInitialiseList (PLIST *ppvListData, sgl_uint32 uItemSize, sgl_uint3
 		pList->uMaxItems = 0;
 		pList->uItemSize = uItemSize;
 		pList->nItemsInList = 0;
+
+		for (k = 0; k < LIST_MAX_INDEXES; ++k)
+		{
+			pList->pIndex[k] = NULL;
+		}
 				
 		*ppvListData = (PLIST) pList;
 
@@ -520,6 +775,7 @@ sgl_bool ListInitialiseList (PLIST *ppvListData, sgl_uint32 uItemSize, sgl_uint3
 sgl_bool ListDeleteList (PLIST *ppvListData)
 {
 	LIST *pList = *ppvListData;
+	int k;
 
 	ASSERT (ppvListData != NULL);
 
@@ -542,6 +798,14 @@ sgl_bool ListDeleteList (PLIST *ppvListData)
 			SGLFree (pList->pList);
 		}
 
+		for (k = 0; k < LIST_MAX_INDEXES; ++k)
+		{
+			if (pList->pIndex[k])
+			{
+				DeleteIndex (pList->pIndex[k]);
+			}
+		}
+
 		SGLFree (pList);
 		*ppvListData = NULL;
 	}
@@ -549,4 +813,185 @@ sgl_bool ListDeleteList (PLIST *ppvListData)
 	return (TRUE);
 }
 
+/*===========================================
+ * Function:	ListAddIndex
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Gives the list a hash index for ListFindKeyedItem.
+ *
+ * Params:		PLIST pvListData: list to index
+ *				int nIndex: 0 .. LIST_MAX_INDEXES-1
+ *				KEYITEMFN pfnKeyItem: returns the key of an item
+ *
+ * Return:		TRUE if successful
+ *				FALSE if not
+ *========================================================================================*/
+sgl_bool ListAddIndex (PLIST pvListData, int nIndex, KEYITEMFN pfnKeyItem)
+{
+	LIST *pList = pvListData;
+	LISTINDEX *pIndex;
+
+	ASSERT (pList);
+	ASSERT ((nIndex >= 0) && (nIndex < LIST_MAX_INDEXES));
+	ASSERT (pfnKeyItem);
+
+	if (pList->pIndex[nIndex])
+	{
+		ASSERT (pList->pIndex[nIndex]->pfnKeyItem == pfnKeyItem);
+		return (TRUE);
+	}
+
+	pIndex = SGLMalloc (sizeof (LISTINDEX));
+
+	if (!pIndex)
+	{
+		DPF ((DBG_WARNING, "ListAddIndex: no memory"));
+		return (FALSE);
+	}
+
+	pIndex->pfnKeyItem = pfnKeyItem;
+	pIndex->nIndexed = 0;
+	pIndex->nSize = 0;
+	pIndex->nBucketBits = 0;
+	pIndex->pnHeads = NULL;
+	pIndex->pnNext = NULL;
+	pIndex->pu32Keys = NULL;
+
+	if (!GrowIndex (pIndex, 1 << MIN_INDEX_BITS))
+	{
+		DPF ((DBG_WARNING, "ListAddIndex: no memory"));
+		DeleteIndex (pIndex);
+		return (FALSE);
+	}
+
+	pList->pIndex[nIndex] = pIndex;
+
+	return (TRUE);
+}
+
+/*===========================================
+ * Function:	ListFindKeyedItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Search the items with the given key using passed callback.
+ *
+ * Params:		PLIST pvListData: List to search
+ *				int nIndex: index added with ListAddIndex
+ *				sgl_uint32 uKey: key of the item wanted
+ *				FINDITEMFN pfnFindItem: callback function tha returns TRUE if item matches
+ *				sgl_uint32 wFindItemData: data to pass to callback
+ *
+ * Return:		void *: ptr to item if successful
+ *						NULL if not
+ *========================================================================================*/
+void * ListFindKeyedItem (PLIST pvListData, int nIndex, sgl_uint32 uKey, 
+						  FINDITEMFN pfnFindItem, sgl_uint32 wFindItemData)
+{
+	LIST *pList = pvListData;
+	LISTINDEX *pIndex;
+	int k, nFound;
+	
+	ASSERT (pList);
+	ASSERT (pfnFindItem);
+
+	pIndex = CatchUpIndex (pList, nIndex);
+
+	if (!pIndex)
+	{
+		/* The key only narrows the search, so this finds the same item */
+		return (ListFindItem (pList, pfnFindItem, wFindItemData));
+	}
+
+	/*
+	// Chains aren't in list order, so look at all of it and keep the
+	// first match in the list
+	*/
+	nFound = NULL_ITEM;
+
+	for (k = pIndex->pnHeads[INDEX_BUCKET (pIndex, uKey)]; k != NULL_ITEM; k = pIndex->pnNext[k])
+	{
+		if ((pIndex->pu32Keys[k] == uKey) && 
+			((nFound == NULL_ITEM) || (k < nFound)) &&
+			pfnFindItem ((void *) ((sgl_uint32) pList->pList + (k * pList->uItemSize)), wFindItemData))
+		{
+			nFound = k;
+		}
+	}
+
+	if (nFound == NULL_ITEM)
+	{
+		return (NULL);
+	}
+
+	return ((void *) ((sgl_uint32) pList->pList + (nFound * pList->uItemSize)));
+}
+
+/*===========================================
+ * Function:	ListRemoveKeyedItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Find item with ListFindKeyedItem and remove it from list
+ *
+ * Params:		as ListFindKeyedItem
+ *
+ * Return:		TRUE if successful
+ *				FALSE if not
+ *========================================================================================*/
+sgl_bool ListRemoveKeyedItem (PLIST pvListData, int nIndex, sgl_uint32 uKey, 
+							  FINDITEMFN pfnFindItem, sgl_uint32 wFindItemData)
+{
+	void *pItem = ListFindKeyedItem (pvListData, nIndex, uKey, pfnFindItem, wFindItemData);
+
+	if (pItem == NULL)
+	{
+		return (FALSE);
+	}
+
+	return (ListRemoveItem (pvListData, NULL, ListGetItemID (pvListData, pItem)));
+}
+
+/*===========================================
+ * Function:	ListReKeyItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Re-keys an item whose key fields have changed.
+ *
+ * Params:		PLIST pvListData: list the item is in
+ *				void *pItem: the item
+ *
+ * Return:		void
+ *========================================================================================*/
+void ListReKeyItem (PLIST pvListData, void *pItem)
+{
+	LIST *pList = pvListData;
+	int n, nItem;
+
+	ASSERT (pList);
+
+	nItem = ListGetItemID (pList, pItem);
+
+	ASSERT ((nItem >= 0) && (nItem < pList->nItemsInList));
+
+	for (n = 0; n < LIST_MAX_INDEXES; ++n)
+	{
+		LISTINDEX *pIndex = pList->pIndex[n];
+
+		/* Items not keyed yet will be keyed as they are now */
+		if (pIndex && (nItem < pIndex->nIndexed))
+		{
+			UnlinkItem (pIndex, nItem);
+			pIndex->pu32Keys[nItem] = pIndex->pfnKeyItem (pItem);
+			LinkItem (pIndex, nItem);
+		}
+	}
+}
+
 /* list.c */
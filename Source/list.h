@@ -136,6 +136,22 @@ typedef sgl_bool (* FINDITEMFN)(void *, sgl_uint32);
 typedef const void *PCVOID;
 typedef void (* DESTROYITEMFN)(PCVOID);
 
+/*===========================================
+ * Typedef:		KEYITEMFN
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Callback used by a list index (see ListAddIndex) to get the key of
+ *				an item. Items that a FINDITEMFN used with the index would match must
+ *				have the same key; items with the same key needn't match.
+ *
+ * Params:		void * Item: ptr to Item
+ *
+ * Return:		sgl_uint32 key
+ *========================================================================================*/
+typedef sgl_uint32 (* KEYITEMFN)(void *);
+
 /*
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -148,6 +164,9 @@ typedef int ITEM_ID;
 
 #define NULL_ITEM ((ITEM_ID)-1)
 
+/* number of keyed indexes a list can have */
+#define LIST_MAX_INDEXES 2
+
 typedef struct tagLIST
 {
 	void			*pList;
@@ -156,6 +175,7 @@ typedef struct tagLIST
 	sgl_uint32			uBlockSize;
 	sgl_uint32			uItemSize;
 	DESTROYITEMFN	pfnOnDestroyItem;
+	struct tagLISTINDEX	*pIndex[LIST_MAX_INDEXES];	/* private to list.c */
 } LIST, *PLIST;
 
 /*
@@ -263,6 +283,80 @@ sgl_bool ListInitialiseList (PLIST *ppvListData, sgl_uint32 uItemSize, sgl_uint3
  *========================================================================================*/
 sgl_bool 	ListDeleteList (PLIST * pList);
 
+/*===========================================
+ * Function:	ListAddIndex
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Gives the list a hash index, so ListFindKeyedItem can find items
+ *				without calling a FINDITEMFN for every one. Items are keyed when
+ *				the index is next used, so fill in an item after ListAddItem as
+ *				usual; if a key field of an item already in the list is changed,
+ *				call ListReKeyItem. Does nothing if the index is already there.
+ *
+ * Params:		PLIST pList: list to index
+ *				int nIndex: 0 .. LIST_MAX_INDEXES-1
+ *				KEYITEMFN pfnKeyItem: returns the key of an item
+ *
+ * Return:		TRUE if successful
+ *				FALSE if not (the keyed functions then search the list)
+ *========================================================================================*/
+sgl_bool 	ListAddIndex (PLIST pList, int nIndex, KEYITEMFN pfnKeyItem);
+
+/*===========================================
+ * Function:	ListFindKeyedItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		As ListFindItem, but only tries the items with the given key. Of
+ *				those, the first in the list that matches is returned, as
+ *				ListFindItem would.
+ *
+ * Params:		PLIST pList: list to search
+ *				int nIndex: index added with ListAddIndex
+ *				sgl_uint32 uKey: key of the item wanted
+ *				FINDITEMFN pfnFindItem: callback function that returns TRUE if item matches
+ *				sgl_uint32 wFindItemData: data to pass to callback
+ *
+ * Return:		void *: ptr to item if successful
+ *						NULL if not
+ *========================================================================================*/
+void * 	ListFindKeyedItem (PLIST pList, int nIndex, sgl_uint32 uKey, 
+						   FINDITEMFN pfnFindItem, sgl_uint32 wFindItemData);
+
+/*===========================================
+ * Function:	ListRemoveKeyedItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		As ListRemoveItem, finding the item with ListFindKeyedItem.
+ *
+ * Params:		as ListFindKeyedItem
+ *
+ * Return:		TRUE if successful
+ *				FALSE if not
+ *========================================================================================*/
+sgl_bool 	ListRemoveKeyedItem (PLIST pList, int nIndex, sgl_uint32 uKey, 
+							 FINDITEMFN pfnFindItem, sgl_uint32 wFindItemData);
+
+/*===========================================
+ * Function:	ListReKeyItem
+ *===========================================
+ *
+ * Scope:		Project
+ *
+ * Purpose:		Tells the list's indexes that an item's key may have changed.
+ *
+ * Params:		PLIST pList: list the item is in
+ *				void *pItem: the item
+ *
+ * Return:		void
+ *========================================================================================*/
+void 	ListReKeyItem (PLIST pList, void *pItem);
+
 /*
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -38,6 +38,24 @@ sgl_uint32 nTotalPolygonsInFrame, nTransPolygonsInFrame, nOpaquePolygonsInFrame;
  *========================================================================================*/
 sgl_uint32  SglTimeNow(void)
 {
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+
+	return ((sgl_uint32) (__builtin_ia32_rdtsc () >> 4));
+
+#elif defined (__GNUC__)
+
+	/*
+	// No time stamp counter off x86: use the performance counter, which
+	// SglCPUFreq measures the rate of just the same
+	*/
+	LARGE_INTEGER Now;
+
+	QueryPerformanceCounter (&Now);
+
+	return ((sgl_uint32) Now.QuadPart);
+
+#else
+
 	static sgl_uint32 Time;
 
 	__asm
@@ -56,6 +74,8 @@ sgl_uint32  SglTimeNow(void)
 		}
 
 	return Time;
+
+#endif
 }
 
 /*===========================================
@@ -211,3 +231,487 @@ sgl_uint32 HWGetTick(void)
 #endif
 
 #endif
+
+/************************************************/
+/*												*/
+/* Frame profiler (see metrics.h)				*/
+/*												*/
+/************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sglthrd.h"
+
+#define PROF_MAX_DEPTH		16
+#define PROF_NUM_EVENTS		4096	/* must be a power of 2 */
+#define PROF_NUM_FRAMES		64
+
+/*
+// One stopped timer. Events go into a ring that any thread can add to
+// without a lock: a thread takes a ticket with SglAtomicAdd, and stamps
+// the slot with the ticket (plus one) once it has filled it in. A reader
+// that sees the same stamp before and after copying a slot knows the copy
+// is whole.
+*/
+typedef struct
+{
+	sgl_int32	nStamp;			/* 0 while being written */
+	sgl_uint16	u16Timer;
+	sgl_uint16	u16Thread;
+	sgl_uint32	u32Frame;
+	sgl_uint32	u32Start;		/* microseconds since enabled */
+	sgl_uint32	u32Duration;
+
+} PROF_EVENT;
+
+/*
+// Each thread has its own stack of running timers, indexed by
+// SglThreadIndex, so the worker threads never touch each other's.
+*/
+typedef struct
+{
+	int			nDepth;
+	int			nTimer[PROF_MAX_DEPTH];
+	sgl_uint32	u32Start[PROF_MAX_DEPTH];
+
+} PROF_STACK;
+
+volatile sgl_bool bSglProfiling = FALSE;
+
+static PROF_STACK			ProfStack[SGL_MAX_THREADS];
+
+static volatile PROF_EVENT	ProfEvent[PROF_NUM_EVENTS];
+static volatile sgl_int32	nProfNextEvent = 0;
+
+/* Zone totals for the frame in progress */
+static volatile sgl_int32	nProfZoneTime[sgl_profile_num_zones];
+static volatile sgl_int32	nProfZoneCount[sgl_profile_num_zones];
+static volatile sgl_int32	nProfCount[PROF_NUM_COUNTS];
+
+/* Ring of finished frames; frame n is in slot n % PROF_NUM_FRAMES */
+static sgl_profile_frame_info	ProfFrame[PROF_NUM_FRAMES];
+static volatile sgl_int32		nProfFrames = 0;
+
+static char *pszProfZoneName[sgl_profile_num_zones] =
+{
+	"frame",
+	"traversal",
+	"projection",
+	"shading",
+	"packing",
+	"regions",
+	"render_wait"
+};
+
+/*
+// The profiler's clock counts microseconds from the last
+// sgl_profile_enable.
+*/
+#if WIN32
+
+static LARGE_INTEGER ProfClockBase, ProfClockFreq;
+
+static void ProfClockReset (void)
+{
+	QueryPerformanceFrequency (&ProfClockFreq);
+	QueryPerformanceCounter (&ProfClockBase);
+}
+
+static sgl_uint32 ProfClock (void)
+{
+	LARGE_INTEGER Now;
+
+	QueryPerformanceCounter (&Now);
+
+	return ((sgl_uint32) (((Now.QuadPart - ProfClockBase.QuadPart) * 1000000) /
+						  ProfClockFreq.QuadPart));
+}
+
+#elif defined (GCC) || defined (__unix__)
+
+static struct timespec ProfClockBase;
+
+static void ProfClockReset (void)
+{
+	clock_gettime (CLOCK_MONOTONIC, &ProfClockBase);
+}
+
+static sgl_uint32 ProfClock (void)
+{
+	struct timespec Now;
+
+	clock_gettime (CLOCK_MONOTONIC, &Now);
+
+	return ((sgl_uint32) ((Now.tv_sec - ProfClockBase.tv_sec) * 1000000 +
+						  (Now.tv_nsec - ProfClockBase.tv_nsec) / 1000));
+}
+
+#else
+
+static clock_t ProfClockBase;
+
+static void ProfClockReset (void)
+{
+	ProfClockBase = clock ();
+}
+
+static sgl_uint32 ProfClock (void)
+{
+	return ((sgl_uint32) ((double) (clock () - ProfClockBase) *
+						  (1.0e6 / CLOCKS_PER_SEC)));
+}
+
+#endif
+
+static char *ProfTimerName (int nTimer)
+{
+	switch (nTimer)
+	{
+		case TOTAL_RENDER_TIME:			return ("TOTAL_RENDER_TIME");
+		case DATABASE_TRAVERSAL_TIME:	return ("DATABASE_TRAVERSAL_TIME");
+		case PROJECTION_TIME:			return ("PROJECTION_TIME");
+		case SMOOTH_PARAM_TIME:			return ("SMOOTH_PARAM_TIME");
+		case FLAT_PARAM_TIME:			return ("FLAT_PARAM_TIME");
+		case FLATTEXTURE_PARAM_TIME:	return ("FLATTEXTURE_PARAM_TIME");
+		case PACK_OPAQUE_TIME:			return ("PACK_OPAQUE_TIME");
+		case PACK_MESH_TIME:			return ("PACK_MESH_TIME");
+		case PACK_ISPTRI_TIME:			return ("PACK_ISPTRI_TIME");
+		case SGLTRI_PACKTRI_TIME:		return ("SGLTRI_PACKTRI_TIME");
+		case GENERATE_TIME:				return ("GENERATE_TIME");
+		case RENDER_WAITING_TIME:		return ("RENDER_WAITING_TIME");
+		default:						return ("UNKNOWN");
+	}
+}
+
+/*
+// Moves the zone totals into the frame ring. Only the thread that ran
+// the frame gets here, after its workers have finished.
+*/
+static void ProfEndFrame (sgl_uint32 u32Start, sgl_uint32 u32Duration)
+{
+	sgl_profile_frame_info	*pFrame;
+	sgl_int32				nTime, nCount;
+	int						nZone;
+
+	pFrame = &ProfFrame[nProfFrames % PROF_NUM_FRAMES];
+
+	pFrame->u32Frame = (sgl_uint32) nProfFrames;
+	pFrame->u32StartTime = u32Start;
+
+	pFrame->u32ZoneTime[sgl_profile_frame] = u32Duration;
+	pFrame->u32ZoneCount[sgl_profile_frame] = 1;
+
+	for (nZone = sgl_profile_frame + 1; nZone < sgl_profile_num_zones; nZone++)
+	{
+		/* Subtract rather than clear, in case a late add is in flight */
+		nTime = nProfZoneTime[nZone];
+		nCount = nProfZoneCount[nZone];
+
+		SglAtomicAdd (&nProfZoneTime[nZone], -nTime);
+		SglAtomicAdd (&nProfZoneCount[nZone], -nCount);
+
+		pFrame->u32ZoneTime[nZone] = (sgl_uint32) nTime;
+		pFrame->u32ZoneCount[nZone] = (sgl_uint32) nCount;
+	}
+
+	nCount = nProfCount[PROF_SHADOW_CACHE_HITS];
+	SglAtomicAdd (&nProfCount[PROF_SHADOW_CACHE_HITS], -nCount);
+	pFrame->u32ShadowCacheHits = (sgl_uint32) nCount;
+
+	nCount = nProfCount[PROF_SHADOW_CACHE_MISSES];
+	SglAtomicAdd (&nProfCount[PROF_SHADOW_CACHE_MISSES], -nCount);
+	pFrame->u32ShadowCacheMisses = (sgl_uint32) nCount;
+
+	SglAtomicAdd (&nProfFrames, 1);
+}
+
+/*===========================================
+ * Function:	SglProfileStart
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Pushes a profiled timer onto the calling thread's stack.
+ *
+ * Params:		int nTimer: one of TIMER_TYPES with a zone
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileStart (int nTimer)
+{
+	PROF_STACK *pStack = &ProfStack[SglThreadIndex ()];
+
+	/* Too deep: lose it rather than a timer further down */
+	if (pStack->nDepth < PROF_MAX_DEPTH)
+	{
+		pStack->nTimer[pStack->nDepth] = nTimer;
+		pStack->u32Start[pStack->nDepth] = ProfClock ();
+		pStack->nDepth++;
+	}
+}
+
+/*===========================================
+ * Function:	SglProfileStop
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Pops a timer off the calling thread's stack and records it.
+ *				Anything started after it and not stopped is dropped, and
+ *				a timer that is not on the stack is ignored, so the odd
+ *				unmatched stop on an error path does no harm. Stopping
+ *				TOTAL_RENDER_TIME ends the frame.
+ *
+ * Params:		int nTimer: one of TIMER_TYPES with a zone
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileStop (int nTimer)
+{
+	int					nThread = SglThreadIndex ();
+	PROF_STACK			*pStack = &ProfStack[nThread];
+	volatile PROF_EVENT	*pEvent;
+	sgl_uint32			u32Start, u32Duration;
+	sgl_int32			nTicket;
+	int					nDepth, nZone, k;
+
+	for (nDepth = pStack->nDepth - 1; nDepth >= 0; nDepth--)
+	{
+		if (pStack->nTimer[nDepth] == nTimer)
+		{
+			break;
+		}
+	}
+
+	if (nDepth < 0)
+	{
+		return;
+	}
+
+	pStack->nDepth = nDepth;
+
+	u32Start = pStack->u32Start[nDepth];
+	u32Duration = ProfClock () - u32Start;
+
+	nTicket = SglAtomicAdd (&nProfNextEvent, 1);
+	pEvent = &ProfEvent[nTicket & (PROF_NUM_EVENTS - 1)];
+
+	pEvent->nStamp = 0;
+	pEvent->u16Timer = (sgl_uint16) nTimer;
+	pEvent->u16Thread = (sgl_uint16) nThread;
+	pEvent->u32Frame = (sgl_uint32) nProfFrames;
+	pEvent->u32Start = u32Start;
+	pEvent->u32Duration = u32Duration;
+	pEvent->nStamp = nTicket + 1;
+
+	nZone = SGL_PROFILE_ZONE (nTimer);
+
+	if (nZone == sgl_profile_frame)
+	{
+		ProfEndFrame (u32Start, u32Duration);
+		return;
+	}
+
+	/*
+	// A timer inside another of the same zone (PACK_MESH_TIME within
+	// PACK_OPAQUE_TIME, say) is already counted by the outer one.
+	*/
+	for (k = 0; k < nDepth; k++)
+	{
+		if (SGL_PROFILE_ZONE (pStack->nTimer[k]) == nZone)
+		{
+			return;
+		}
+	}
+
+	SglAtomicAdd (&nProfZoneTime[nZone], (sgl_int32) u32Duration);
+	SglAtomicAdd (&nProfZoneCount[nZone], 1);
+}
+
+/*===========================================
+ * Function:	SglProfileCount
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Adds to one of the profiler's per frame counts. Safe to
+ *				call from any thread.
+ *
+ * Params:		int nCount: one of PROF_COUNT_TYPES
+ *				int nAdd: how much to add
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileCount (int nCount, int nAdd)
+{
+	SglAtomicAdd (&nProfCount[nCount], (sgl_int32) nAdd);
+}
+
+/******************************************************************************
+ * Function Name: sgl_profile_enable
+ *
+ * Inputs       : bEnable: TRUE to start profiling, FALSE to stop
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : bSglProfiling and the profiler's rings
+ *
+ * Description  : Starting profiling throws away anything recorded before.
+ *				  It should be called between frames: a timer already
+ *				  running when profiling starts is simply not recorded.
+ *****************************************************************************/
+
+extern void CALL_CONV sgl_profile_enable (sgl_bool bEnable)
+{
+	int nEvent, nZone, nCount;
+
+	bSglProfiling = FALSE;
+
+	if (bEnable)
+	{
+		memset (ProfStack, 0, sizeof (ProfStack));
+		memset (ProfFrame, 0, sizeof (ProfFrame));
+
+		for (nEvent = 0; nEvent < PROF_NUM_EVENTS; nEvent++)
+		{
+			ProfEvent[nEvent].nStamp = 0;
+		}
+
+		for (nZone = 0; nZone < sgl_profile_num_zones; nZone++)
+		{
+			nProfZoneTime[nZone] = 0;
+			nProfZoneCount[nZone] = 0;
+		}
+
+		for (nCount = 0; nCount < PROF_NUM_COUNTS; nCount++)
+		{
+			nProfCount[nCount] = 0;
+		}
+
+		nProfNextEvent = 0;
+		nProfFrames = 0;
+
+		ProfClockReset ();
+
+		bSglProfiling = TRUE;
+	}
+
+	SglError (sgl_no_err);
+
+} /* sgl_profile_enable */
+
+/******************************************************************************
+ * Function Name: sgl_profile_get_frames
+ *
+ * Inputs       : nMaxFrames: room in pFrames
+ * Outputs      : pFrames: the most recent frames, oldest first
+ * Returns      : Number of frames copied
+ * Globals Used : The frame ring
+ *
+ * Description  : The oldest slot in the ring is the next to be reused, so
+ *				  it is never copied.
+ *****************************************************************************/
+
+extern int CALL_CONV sgl_profile_get_frames (sgl_profile_frame_info *pFrames,
+											 int nMaxFrames)
+{
+	sgl_int32	nFrames = nProfFrames;
+	int			nCopy, k;
+
+	if ((pFrames == NULL) || (nMaxFrames < 0))
+	{
+		SglError (sgl_err_bad_parameter);
+		return (0);
+	}
+
+	nCopy = (nFrames < PROF_NUM_FRAMES - 1) ? (int) nFrames : PROF_NUM_FRAMES - 1;
+
+	if (nCopy > nMaxFrames)
+	{
+		nCopy = nMaxFrames;
+	}
+
+	for (k = 0; k < nCopy; k++)
+	{
+		pFrames[k] = ProfFrame[(nFrames - nCopy + k) % PROF_NUM_FRAMES];
+	}
+
+	SglError (sgl_no_err);
+
+	return (nCopy);
+
+} /* sgl_profile_get_frames */
+
+/******************************************************************************
+ * Function Name: sgl_profile_write_trace
+ *
+ * Inputs       : pszFileName: file to write
+ * Outputs      : -
+ * Returns      : Number of events written, or sgl_err_bad_parameter
+ * Globals Used : The event ring
+ *
+ * Description  : Writes the events still in the ring as complete ("X")
+ *				  events of the Chrome trace format, one thread per SGL
+ *				  thread. Slots being rewritten while we read them are
+ *				  skipped.
+ *****************************************************************************/
+
+extern int CALL_CONV sgl_profile_write_trace (char *pszFileName)
+{
+	FILE		*fp;
+	sgl_int32	nFirst, nLast, nTicket, nStamp;
+	PROF_EVENT	Event;
+	int			nWritten = 0;
+
+	if ((pszFileName == NULL) || ((fp = fopen (pszFileName, "wt")) == NULL))
+	{
+		SglError (sgl_err_bad_parameter);
+		return (sgl_err_bad_parameter);
+	}
+
+	nLast = nProfNextEvent;
+	nFirst = (nLast > PROF_NUM_EVENTS) ? nLast - PROF_NUM_EVENTS : 0;
+
+	fprintf (fp, "{\"traceEvents\":[\n");
+
+	for (nTicket = nFirst; nTicket < nLast; nTicket++)
+	{
+		volatile PROF_EVENT *pEvent = &ProfEvent[nTicket & (PROF_NUM_EVENTS - 1)];
+
+		nStamp = pEvent->nStamp;
+
+		Event.u16Timer = pEvent->u16Timer;
+		Event.u16Thread = pEvent->u16Thread;
+		Event.u32Frame = pEvent->u32Frame;
+		Event.u32Start = pEvent->u32Start;
+		Event.u32Duration = pEvent->u32Duration;
+
+		if ((nStamp != nTicket + 1) || (pEvent->nStamp != nStamp))
+		{
+			continue;
+		}
+
+		fprintf (fp, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+					 "\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%d,"
+					 "\"args\":{\"frame\":%lu}}",
+				 nWritten ? ",\n" : "",
+				 ProfTimerName (Event.u16Timer),
+				 pszProfZoneName[SGL_PROFILE_ZONE (Event.u16Timer)],
+				 (unsigned long) Event.u32Start,
+				 (unsigned long) Event.u32Duration,
+				 (int) Event.u16Thread,
+				 (unsigned long) Event.u32Frame);
+
+		nWritten++;
+	}
+
+	fprintf (fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose (fp);
+
+	SglError (sgl_no_err);
+
+	return (nWritten);
+
+} /* sgl_profile_write_trace */
+
+/* metrics.c */
@@ -19,6 +19,184 @@
 
 #endif
 
+/*
+// The timers. These are known to every build, so that the frame profiler
+// (below) can pick out the ones it records when METRIC is off.
+*/
+typedef enum 
+{ 
+	DUMMY=0,
+	TOTAL_APP_TIME, 
+	TOTAL_RENDER_TIME, 
+	TIMER_TIME,
+	RENDER_WAITING_TIME, 
+	PLANE_STUFF_TIME,
+	MESH_NODE_TIME,	
+	DATABASE_TRAVERSAL_TIME, 
+	TRIVIAL_REJECTION_TIME, 
+	TRANSFORM_FACES_ALL_TIME, 
+	TRANSFORM_FACES_PARTLY_TIME, 
+	TRANSFORM_EDGES_ALL_TIME, 
+	TRANSFORM_EDGES_PARTLY_TIME, 
+	TRANSFORM_VERTICES_ALL_TIME, 
+	TRANSFORM_VERTICES_PARTLY_TIME, 
+	TRANSFORM_COMPUTE_SABRE_ALL_TIME, 
+	TRANSFORM_COMPUTE_SABRE_PARTLY_TIME, 
+	TRANSFORM_VISIBLE_CONVEX_TIME,
+	TRANSFORM_PLANES_TIME,
+	DETERMINE_PLANES_REGION_TIME,
+	DETERMINE_BBOX_REGION_TIME,
+	ADD_REGION_OPAQUE_TIME,
+	ADD_REGION_SHADOW_TIME,
+	ADD_REGION_LIGHTVOL_TIME,
+	ADD_REGION_TRANSLUC_TIME,
+	PUT_PLANES_REGION_TIME,
+	PROJECTION_TIME, 
+	PROJECT_REP_TIME, 
+	TEXTURE_TIME, 
+	SMOOTH_OBJ_PRECALC_TIME, 
+	SMOOTH_DATA_PRECALC_TIME, 
+	SMOOTH_TRI_CLIP_PARAM_TIME, 
+	SMOOTH_TRI_PARAM_TIME, 
+	SMOOTH_ADJ_PARAM_TIME, 
+	SMOOTH_PARAM_TIME, 
+	FLAT_PARAM_TIME, 
+	FLATTEXTURE_PARAM_TIME, 
+	SHADOW_VOL_TIME,
+	PROCESS_CONVEX_NODE_TIME,
+	PROCESS_SHADOW_TIME,
+	PACK_OPAQUE_TIME,
+	PACK_MESH_TIME,
+	PACK_QUADS_TIME,
+	PACK_TRIANGLES_TIME,
+	PACK_PLANE_TIME,
+	PACK_20BIT_TIME,
+	PACK_LIGHTSHADVOL_TIME,
+	PACK_TEXAS_TIME,
+	PACK_MESH_ORDERED_TIME,
+	PACK_TEXAS_NT_TIME,
+	PACK_TEXAS_FT_TIME,
+	PACK_TEXAS_ST_TIME,
+	PACK_TEXAS_TRI_TIME,
+	PACK_TEXAS_TRINT_TIME,
+	PACK_TEXAS_TRISH_TIME,
+	PACK_TEXAS_TRILV_TIME,
+	PACK_TEXAS_TRINTSH_TIME,
+	PACK_TEXAS_TRINTLV_TIME,
+
+	TEXTURE_PARAMETER_SETUP_TIME, 
+	PARAMETER_TRANSFER_TIME, 
+	SGLTRI_STARTOFFRAME1_TIME,
+	SGLTRI_STARTOFFRAME2_TIME,
+	GENERATE_TIME,
+	SGLTRI_TRIANGLES_TIME,
+	SGLTRI_PROCESS_TIME,
+	SGLTRI_PACKTRI_TIME,
+	PACK_ISPTRI_TIME,
+	PACK_ISPCORE_TIME,
+	INPUT_D3DTRI_COUNT,
+	INPUT_D3DPOLY_COUNT,
+	INPUT_LITEQUAD_COUNT,
+	INPUT_LITETRI_COUNT,
+	PERPOLYPROC_TIME,
+
+	NUM_TIMERS						 
+} TIMER_TYPES;
+
+/*
+// Frame profiler
+//
+// Records how long each frame spends in a few broad zones, for the
+// sgl_profile_ calls in sgl.h. A zone is fed by one or more of the timers
+// above; SGL_PROFILE_ZONE says which, and is -1 for the timers it ignores.
+// It is a constant expression, so in builds without METRIC the
+// SGL_TIME_START and SGL_TIME_STOP of every other timer still compile to
+// nothing, and the ones it keeps cost a test of bSglProfiling.
+//
+// METRIC builds keep their own Times table and do not feed the profiler.
+*/
+#define SGL_PROFILE_ZONE(X)											\
+	(((X) == TOTAL_RENDER_TIME)			? sgl_profile_frame :		\
+	 ((X) == DATABASE_TRAVERSAL_TIME)	? sgl_profile_traversal :	\
+	 ((X) == PROJECTION_TIME)			? sgl_profile_projection :	\
+	 ((X) == SMOOTH_PARAM_TIME)			? sgl_profile_shading :		\
+	 ((X) == FLAT_PARAM_TIME)			? sgl_profile_shading :		\
+	 ((X) == FLATTEXTURE_PARAM_TIME)	? sgl_profile_shading :		\
+	 ((X) == PACK_OPAQUE_TIME)			? sgl_profile_packing :		\
+	 ((X) == PACK_MESH_TIME)			? sgl_profile_packing :		\
+	 ((X) == PACK_ISPTRI_TIME)			? sgl_profile_packing :		\
+	 ((X) == SGLTRI_PACKTRI_TIME)		? sgl_profile_packing :		\
+	 ((X) == GENERATE_TIME)				? sgl_profile_regions :		\
+	 ((X) == RENDER_WAITING_TIME)		? sgl_profile_render_wait : -1)
+
+/*
+// Event counts the profiler keeps alongside its zones, one frame at a
+// time. SGL_PROFILE_COUNT adds to one.
+*/
+typedef enum
+{
+	PROF_SHADOW_CACHE_HITS,
+	PROF_SHADOW_CACHE_MISSES,
+
+	PROF_NUM_COUNTS
+
+} PROF_COUNT_TYPES;
+
+#define SGL_PROFILE_COUNT(X, N)	{ if (bSglProfiling) SglProfileCount ((X), (N)); }
+
+#define SGL_PROFILE_START(X)	{ if ((SGL_PROFILE_ZONE(X) >= 0) && bSglProfiling) SglProfileStart (X); }
+#define SGL_PROFILE_STOP(X)		{ if ((SGL_PROFILE_ZONE(X) >= 0) && bSglProfiling) SglProfileStop (X); }
+
+extern volatile sgl_bool bSglProfiling;
+
+/*===========================================
+ * Function:	SglProfileStart
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Pushes a profiled timer onto the calling thread's stack.
+ *
+ * Params:		int nTimer: one of TIMER_TYPES with a zone
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileStart (int nTimer);
+
+/*===========================================
+ * Function:	SglProfileStop
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Pops a timer off the calling thread's stack and records it.
+ *				Anything started after it and not stopped is dropped, and
+ *				a timer that is not on the stack is ignored, so the odd
+ *				unmatched stop on an error path does no harm. Stopping
+ *				TOTAL_RENDER_TIME ends the frame.
+ *
+ * Params:		int nTimer: one of TIMER_TYPES with a zone
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileStop (int nTimer);
+
+/*===========================================
+ * Function:	SglProfileCount
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Adds to one of the profiler's per frame counts. Safe to
+ *				call from any thread.
+ *
+ * Params:		int nCount: one of PROF_COUNT_TYPES
+ *				int nAdd: how much to add
+ *
+ * Return:		none
+ *========================================================================================*/
+void SglProfileCount (int nCount, int nAdd);
+
 #ifdef METRIC
 
 	/*===========================================
@@ -76,85 +254,6 @@
 		#endif
 	} Temporal_Data;
  
-	typedef enum 
-	{ 
-		DUMMY=0,
-		TOTAL_APP_TIME, 
-		TOTAL_RENDER_TIME, 
-		TIMER_TIME,
-		RENDER_WAITING_TIME, 
-		PLANE_STUFF_TIME,
-		MESH_NODE_TIME,	
-		DATABASE_TRAVERSAL_TIME, 
-		TRIVIAL_REJECTION_TIME, 
-		TRANSFORM_FACES_ALL_TIME, 
-		TRANSFORM_FACES_PARTLY_TIME, 
-		TRANSFORM_EDGES_ALL_TIME, 
-		TRANSFORM_EDGES_PARTLY_TIME, 
-		TRANSFORM_VERTICES_ALL_TIME, 
-		TRANSFORM_VERTICES_PARTLY_TIME, 
-		TRANSFORM_COMPUTE_SABRE_ALL_TIME, 
-		TRANSFORM_COMPUTE_SABRE_PARTLY_TIME, 
-		TRANSFORM_VISIBLE_CONVEX_TIME,
-		TRANSFORM_PLANES_TIME,
-		DETERMINE_PLANES_REGION_TIME,
-		DETERMINE_BBOX_REGION_TIME,
-		ADD_REGION_OPAQUE_TIME,
-		ADD_REGION_SHADOW_TIME,
-		ADD_REGION_LIGHTVOL_TIME,
-		ADD_REGION_TRANSLUC_TIME,
-		PUT_PLANES_REGION_TIME,
-		PROJECTION_TIME, 
-		PROJECT_REP_TIME, 
-		TEXTURE_TIME, 
-		SMOOTH_OBJ_PRECALC_TIME, 
-		SMOOTH_DATA_PRECALC_TIME, 
-		SMOOTH_TRI_CLIP_PARAM_TIME, 
-		SMOOTH_TRI_PARAM_TIME, 
-		SMOOTH_ADJ_PARAM_TIME, 
-		SMOOTH_PARAM_TIME, 
-		FLAT_PARAM_TIME, 
-		FLATTEXTURE_PARAM_TIME, 
-		SHADOW_VOL_TIME,
-		PROCESS_CONVEX_NODE_TIME,
-		PROCESS_SHADOW_TIME,
-		PACK_OPAQUE_TIME,
-		PACK_MESH_TIME,
-		PACK_QUADS_TIME,
-		PACK_TRIANGLES_TIME,
-		PACK_PLANE_TIME,
-		PACK_20BIT_TIME,
-		PACK_LIGHTSHADVOL_TIME,
-		PACK_TEXAS_TIME,
-		PACK_MESH_ORDERED_TIME,
-		PACK_TEXAS_NT_TIME,
-		PACK_TEXAS_FT_TIME,
-		PACK_TEXAS_ST_TIME,
-		PACK_TEXAS_TRI_TIME,
-		PACK_TEXAS_TRINT_TIME,
-		PACK_TEXAS_TRISH_TIME,
-		PACK_TEXAS_TRILV_TIME,
-		PACK_TEXAS_TRINTSH_TIME,
-		PACK_TEXAS_TRINTLV_TIME,
-
-		TEXTURE_PARAMETER_SETUP_TIME, 
-		PARAMETER_TRANSFER_TIME, 
-		SGLTRI_STARTOFFRAME1_TIME,
-		SGLTRI_STARTOFFRAME2_TIME,
-		GENERATE_TIME,
-		SGLTRI_TRIANGLES_TIME,
-		SGLTRI_PROCESS_TIME,
-		SGLTRI_PACKTRI_TIME,
-		PACK_ISPTRI_TIME,
-		PACK_ISPCORE_TIME,
-		INPUT_D3DTRI_COUNT,
-		INPUT_D3DPOLY_COUNT,
-		INPUT_LITEQUAD_COUNT,
-		INPUT_LITETRI_COUNT,
-		PERPOLYPROC_TIME,
-
-		NUM_TIMERS						 
-	} TIMER_TYPES;
 
 	#ifdef SGL_APP
 
@@ -258,45 +357,45 @@
 
 	#ifdef METRIC2
 
-		#define SGL_TIME_RESET(X)      { Times[##X].Count = 0;  Times[##X].Total = 0; Times[##X].Start = 0;  Times[##X].Stop = 0; Times[##X].Max = 0; Times[##X].Stack = 0; TStack = 0;}
-		#define SGL_TIME_START(X)      { 	if ( Times[##X].Stack != 0 ) { Times[##X].Count |= 0xE0000000L; }\
-							if ( (Times[##X].Stack = TStack) != 0 ) { Times[TStack].Stop += ( SglTimeNow() - Times[TStack].Start ); } \
-							Times[##X].Count += 1; Times[##X].Start = SglTimeNow(); Times[##X].Stop = 0; TStack = ##X; }
+		#define SGL_TIME_RESET(X)      { Times[X].Count = 0;  Times[X].Total = 0; Times[X].Start = 0;  Times[X].Stop = 0; Times[X].Max = 0; Times[X].Stack = 0; TStack = 0;}
+		#define SGL_TIME_START(X)      { 	if ( Times[X].Stack != 0 ) { Times[X].Count |= 0xE0000000L; }\
+							if ( (Times[X].Stack = TStack) != 0 ) { Times[TStack].Stop += ( SglTimeNow() - Times[TStack].Start ); } \
+							Times[X].Count += 1; Times[X].Start = SglTimeNow(); Times[X].Stop = 0; TStack = X; }
 		#define SGL_TIME_SUSPEND(X)
 		#define SGL_TIME_RESUME(X)
-		#define SGL_TIME_STOP(X)       { if ( ##X != TStack ) { Times[TStack].Count |= 0x80000000L; Times[##X].Count |= 0xC0000000L; }\
+		#define SGL_TIME_STOP(X)       { if ( X != TStack ) { Times[TStack].Count |= 0x80000000L; Times[X].Count |= 0xC0000000L; }\
 						   Times[TStack].Stop += (SglTimeNow() - Times[TStack].Start);\
 					       Times[TStack].Total += Times[TStack].Stop;\
 					       Times[TStack].Max = (( Times[TStack].Max < Times[TStack].Stop ) ? Times[TStack].Stop : Times[TStack].Max);\
-						   if ( (TStack = Times[##X].Stack) != 0 ) { Times[TStack].Start = SglTimeNow(); }\
-					   Times[##X].Stack = 0; }
+						   if ( (TStack = Times[X].Stack) != 0 ) { Times[TStack].Start = SglTimeNow(); }\
+					   Times[X].Stack = 0; }
 
 		/* In situations where you cannot stand the overheads of even the old
 		metrics stuff as it was, use this to group up instances that need timing
 		within a loop to register the time only once outside the loop. */
-		#define SGL_TIME_FASTINIT(X)   Times[##X].Stop = 0;
-		#define SGL_TIME_FASTENTER(X)	 Times[##X].Stop -= SglTimeNow();
-		#define SGL_TIME_FASTEXIT(X)	 Times[##X].Stop += SglTimeNow();
-		#define SGL_TIME_FASTDONE(X)   { Times[##X].Count += 1;\
-					       Times[##X].Total += Times[##X].Stop;\
-					       Times[##X].Max = (( Times[##X].Max < Times[##X].Stop ) ? Times[##X].Stop : Times[##X].Max);\
-						   if ( TStack != 0 ) Times[TStack].Start += Times[##X].Stop; }
+		#define SGL_TIME_FASTINIT(X)   Times[X].Stop = 0;
+		#define SGL_TIME_FASTENTER(X)	 Times[X].Stop -= SglTimeNow();
+		#define SGL_TIME_FASTEXIT(X)	 Times[X].Stop += SglTimeNow();
+		#define SGL_TIME_FASTDONE(X)   { Times[X].Count += 1;\
+					       Times[X].Total += Times[X].Stop;\
+					       Times[X].Max = (( Times[X].Max < Times[X].Stop ) ? Times[X].Stop : Times[X].Max);\
+						   if ( TStack != 0 ) Times[TStack].Start += Times[X].Stop; }
 
 	#else
 
-		#define SGL_TIME_RESET(X)      { Times[##X].Count = 0;  Times[##X].Total = 0; Times[##X].Start = 0;  Times[##X].Stop = 0; }
-		#define SGL_TIME_START(X)      { Times[##X].Count += 1; Times[##X].Start = SglTimeNow(); }
-		#define SGL_TIME_SUSPEND(X)    { Times[##X].Total += SglTimeNow() - Times[##X].Start; }
-		#define SGL_TIME_RESUME(X)     { Times[##X].Start = SglTimeNow(); }
-		#define SGL_TIME_STOP(X)       { Times[##X].Stop = SglTimeNow(); Times[##X].Total += Times[##X].Stop - Times[##X].Start; }
+		#define SGL_TIME_RESET(X)      { Times[X].Count = 0;  Times[X].Total = 0; Times[X].Start = 0;  Times[X].Stop = 0; }
+		#define SGL_TIME_START(X)      { Times[X].Count += 1; Times[X].Start = SglTimeNow(); }
+		#define SGL_TIME_SUSPEND(X)    { Times[X].Total += SglTimeNow() - Times[X].Start; }
+		#define SGL_TIME_RESUME(X)     { Times[X].Start = SglTimeNow(); }
+		#define SGL_TIME_STOP(X)       { Times[X].Stop = SglTimeNow(); Times[X].Total += Times[X].Stop - Times[X].Start; }
 
 	#endif
 
 	#define GET_TICK_FREQ(X)       { X =  SglCPUFreq();  }
-	#define TOTAL_DIV_COUNT(X)     (Times[##X].Count == 0) ? 0.0f : (float)(Times[##X].Total / Times[##X].Count);
+	#define TOTAL_DIV_COUNT(X)     (Times[X].Count == 0) ? 0.0f : (float)(Times[X].Total / Times[X].Count);
 
-	#define SGL_TIME_READ_MS(X)    ((float)(Times[##X].Total))
-	#define SGL_TIME_READ_COUNT(X) ((long)(Times[##X].Count)) 
+	#define SGL_TIME_READ_MS(X)    ((float)(Times[X].Total))
+	#define SGL_TIME_READ_COUNT(X) ((long)(Times[X].Count)) 
 
 	/* Different definitions and references to the time data */
 	#ifdef METRIC2
@@ -311,7 +410,7 @@
 
 	#endif
 
-	#define GET_TIME_NAME(X)       timer_names[##X].name 
+	#define GET_TIME_NAME(X)       timer_names[X].name 
 
 #else /* METRIC */
 
@@ -324,12 +423,15 @@
 		sgl_uint32 Start, Stop, Count, Total;
 	}   Temporal_Data;
 
-	#define NUM_TIMERS             1 
+	/*
+	// Only the frame profiler's timers do anything, and then only while
+	// it is enabled.
+	*/
 	#define SGL_TIME_RESET(X) 
-	#define SGL_TIME_START(X) 
+	#define SGL_TIME_START(X)      SGL_PROFILE_START(X)
 	#define SGL_TIME_SUSPEND(X)    
 	#define SGL_TIME_RESUME(X)     
-	#define SGL_TIME_STOP(X)       
+	#define SGL_TIME_STOP(X)       SGL_PROFILE_STOP(X)
 	#define GET_TICK_FREQ(X)        
 	#define TOTAL_DIV_COUNT(X)     0.0f 
 
@@ -337,8 +439,8 @@
 	#define SGL_TIME_READ_COUNT(X) 0L 
 
 	/* Different definitions and references to the time data */
-	#define SGL_GLOBAL_TIME_DEFN   Temporal_Data Times[NUM_TIMERS];        /* for rnrender.c */
-	#define SGL_EXTERN_TIME_REF    extern Temporal_Data Times[NUM_TIMERS]; /* for sgl dlls */
+	#define SGL_GLOBAL_TIME_DEFN   Temporal_Data Times[1];        /* for rnrender.c */
+	#define SGL_EXTERN_TIME_REF    extern Temporal_Data Times[1]; /* for sgl dlls */
 
 
 	#define GET_TIME_NAME(X)       0 
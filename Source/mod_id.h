@@ -185,7 +185,14 @@ enum
 	MODID_TEXAS,
 	MODID_NEW_THIN,
 	MODID_D3DISP,
-	MODID_D3DTRI
+	MODID_D3DTRI,
+	MODID_SGLTHRD,
+	MODID_DTRISIMD,
+	MODID_FRMPIPE,
+	MODID_CAPTURE,
+	MODID_TEXCONV,
+	MODID_RNMSIMD,
+	MODID_RNCSIMD
 };
 
 /*
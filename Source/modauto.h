@@ -102,9 +102,16 @@ static ENUMSTRUCT Modules[] =
 	{88, "MODID_TEXAS", ""},
 	{89, "MODID_NEW_THIN", ""},
 	{90, "MODID_D3DISP", ""},
-	{91, "MODID_D3DTRI", ""}
+	{91, "MODID_D3DTRI", ""},
+	{92, "MODID_SGLTHRD", ""},
+	{93, "MODID_DTRISIMD", ""},
+	{94, "MODID_FRMPIPE", ""},
+	{95, "MODID_CAPTURE", ""},
+	{96, "MODID_TEXCONV", ""},
+	{97, "MODID_RNMSIMD", ""},
+	{98, "MODID_RNCSIMD", ""}
 };
 
-#define NUM_ITEMS_IN_MODULES_ARRAY 92
+#define NUM_ITEMS_IN_MODULES_ARRAY 99
 
 /* end of file */
@@ -11,10 +11,12 @@
 *				This code is based on the concept of the name tables
 *				from RGL.
 *				Basically, a name table maintains a mapping from a
-*				system assigned name (a positive integer (16 bit))
+*				system assigned name (a positive integer (30 bit))
 *				to a pointer to the named item. 
 *
 *				The mapping from Name to Pointer must be "fast".
+*				It is done with a hash table, and the table grows
+*				as more names are needed, up to about a million entries.
 *
 *				When a name is released, it should be a while before it
 *				is re-used. This makes it easier for the user to catch
@@ -111,21 +113,38 @@
 #include "sgl_defs.h"
 #include "nm_intf.h"
 #include "dlntypes.h"
+#include "dlnodes.h"
+#include "dlglobal.h"
 #include "pvrosapi.h"
 #include "texapi.h"
 #include "sglmem.h"
 #include "getnamtb.h"
 
 /*
-// For the initial version, stick with a fixed sized name table.
-// Stay with the KISS priciple for the moment.
+// The table starts small and doubles as needed. Names are kept in 32
+// bits (sgl_int32 in the display list nodes) but only use the bottom 30,
+// so that they stay positive whatever the size of an int, and clear of
+// the error codes.
 //
-// To produce a very efficient "hash" function, use a power of 2, and
-// simply use the lower bits of the name to access the table of entries.
+// As before, a name is the entry index in the low bits, with the entry's
+// generation counter in the bits above. The counter goes up each time
+// the entry is freed, and freed entries go on the end of the free list,
+// so a deleted name isn't handed out again for a long while. The index
+// takes as many bits as the table has when the name is given out, so a
+// small table leaves more bits for the generation; a full table still
+// leaves 10. The table stops well short of the names so that there is
+// always a free one.
+//
+// Names made at different table sizes don't follow the same layout, so
+// a hash table, open addressed with linear probing, maps a name to its
+// entry.
 */
-#define SHIFT_UP	15 /*how many bits are used for indexing in the table*/
-#define MAX_NAM_TAB (1 << (SHIFT_UP-1))
-#define HASH_MASK   (MAX_NAM_TAB - 1)
+#define NAME_SPACE		0x40000000L		/* names are 0 .. 2^30 - 1 */
+#define FIRST_ENTRIES	1024
+#define MAX_ENTRIES		0x100000L		/* 2^20 */
+
+/* Empty hash slot */
+#define NO_ENTRY		(-1)
 
 
 /*
@@ -145,7 +164,7 @@ typedef struct
 	// free OR is one which is to be deleted BUT the reference
 	// count was not ZERO
 	*/
-	sgl_int16	n16name;
+	sgl_int32	n32name;
 
 	/* Reference count (eg for instances)*/
 	sgl_int16	n16count;	
@@ -154,7 +173,7 @@ typedef struct
 	// The following field is used to speed up allocation of new
 	// names once the name table starts to get fragmented.
 	*/
-	sgl_int16	n16nextfree;	
+	sgl_int32	n32nextfree;	
 
 	/*
 	// WHEN a valid name is stored, this is "type" of named entity.
@@ -162,7 +181,19 @@ typedef struct
 	// the reference count drops to 0. In the free case, it should be
 	// set to -1.
 	*/
-	sgl_int16	n16entity_type; 
+	sgl_int32	n32entity_type; 
+
+	/*
+	// The name the entry is in the hash table under (whether or not it
+	// has been deleted), or -1 if the entry is free.
+	*/
+	sgl_int32	n32hashed_name;
+
+	/*
+	// Goes up each time the entry is freed. Its low bits make up the top
+	// of the entry's name.
+	*/
+	sgl_uint32	u32generation;
 
 	/* Pointer to the data */
 	void	* p_entity;	
@@ -176,33 +207,272 @@ typedef struct
 typedef struct
 {
 	/* 
-	// The basis for the next name to use. This is incremented, with
-	// each allocation, and then the lower bits are masked off and
-	// combined with the index to produce a name.
-	//
-	// When it gets too big, it is reset to zero.
+	// Where to start looking for a name, in the rare case that every
+	// generation of an entry's name is already in use.
 	*/
-	int name_base;
+	int next_name;
 
 	/*
 	// Keep track of which entries are free in the table via a simple
-	// linked list. To make life REALLY simple for us, we consider there
-	// to be no available names when the first and last free indices are
-	// equal. That is, there actually is one free element left, however
-	// ignoring it just reduces the number of cases to handle a bit.....
+	// linked list. Freed entries go on the end, so it is a while before
+	// they are used again.
 	*/
-	int first_free;	/* The free entry in a "linked List" to use*/
-	int last_free;	/* The last entry in that list */
-	
-	TAB_ENT_STRUCT entries[MAX_NAM_TAB];
+	int first_free;	/* The free entry in a "linked List" to use, or -1 */
+	int last_free;	/* The last entry in that list, or -1 */
+	int num_free;
 
-}NAMTAB_STRUCT;
+	/*
+	// Always a power of 2. index_bits is its log 2, the number of bits
+	// of a new name taken by the entry index.
+	*/
+	int num_entries;
+	int index_bits;
+	TAB_ENT_STRUCT *entries;
+
+	/*
+	// Entry index for each hash slot, or NO_ENTRY. There are at least
+	// twice as many slots as entries.
+	*/
+	int hash_bits;
+	sgl_int32 *hash;
 
+}NAMTAB_STRUCT;
 
 extern HLDEVICE 	gHLogicalDev;
 extern PTEXAPI_IF 	gpTextureIF;
 
 
+/*
+// The hash slot a name starts looking from (Fibonacci hashing, as names
+// are given out in sequence)
+*/
+#define HOME_SLOT(name, bits) \
+	((int) ((((sgl_uint32) (name) * 0x9E3779B1UL) & 0xFFFFFFFFUL) >> (32 - (bits))))
+
+
+/**************************************************************************
+ * Function Name  : find_entry		INTERNAL ONLY ROUTINE
+ * Inputs Only    : p_namtab, name
+ * Outputs Only   : 
+ * Returns        : the index of the entry hashed under name, or -1
+ * Global Used    : None
+ * Description    : Looks the name up in the hash table. The entry may be
+ *					a deleted one waiting for its reference count to drop.
+ **************************************************************************/
+static int find_entry(const NAMTAB_STRUCT * p_namtab, int name)
+{
+	int mask = (1 << p_namtab->hash_bits) - 1;
+	int slot = HOME_SLOT(name, p_namtab->hash_bits);
+	int index;
+
+	while((index = p_namtab->hash[slot]) != NO_ENTRY)
+	{
+		if(p_namtab->entries[index].n32hashed_name == name)
+		{
+			return (index);
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return (-1);
+}
+
+
+/**************************************************************************
+ * Function Name  : hash_insert		INTERNAL ONLY ROUTINE
+ * Inputs Only    : index
+ * Outputs Only   : 
+ * Input/output	  : p_namtab
+ * Returns        : None
+ * Global Used    : None
+ * Description    : Adds the entry to the hash table, under its
+ *					n32hashed_name.
+ **************************************************************************/
+static void hash_insert(NAMTAB_STRUCT * p_namtab, int index)
+{
+	int mask = (1 << p_namtab->hash_bits) - 1;
+	int slot = HOME_SLOT(p_namtab->entries[index].n32hashed_name,
+						 p_namtab->hash_bits);
+
+	while(p_namtab->hash[slot] != NO_ENTRY)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	p_namtab->hash[slot] = (sgl_int32) index;
+}
+
+
+/**************************************************************************
+ * Function Name  : hash_remove		INTERNAL ONLY ROUTINE
+ * Inputs Only    : index
+ * Outputs Only   : 
+ * Input/output	  : p_namtab
+ * Returns        : None
+ * Global Used    : None
+ * Description    : Takes the entry out of the hash table. The entries
+ *					after it in the same run are moved back to fill the
+ *					gap, so that lookups never need to step over deleted
+ *					slots.
+ **************************************************************************/
+static void hash_remove(NAMTAB_STRUCT * p_namtab, int index)
+{
+	int mask = (1 << p_namtab->hash_bits) - 1;
+	int gap, slot, home;
+
+	gap = HOME_SLOT(p_namtab->entries[index].n32hashed_name,
+					p_namtab->hash_bits);
+
+	while(p_namtab->hash[gap] != index)
+	{
+		ASSERT(p_namtab->hash[gap] != NO_ENTRY);
+		gap = (gap + 1) & mask;
+	}
+
+	slot = gap;
+
+	for(;;)
+	{
+		slot = (slot + 1) & mask;
+
+		if(p_namtab->hash[slot] == NO_ENTRY)
+		{
+			break;
+		}
+
+		home = HOME_SLOT(p_namtab->entries[p_namtab->hash[slot]].n32hashed_name,
+						 p_namtab->hash_bits);
+
+		/*
+		// This one can fill the gap if its home is not in the cyclic
+		// range (gap, slot]
+		*/
+		if(((slot - home) & mask) >= ((slot - gap) & mask))
+		{
+			p_namtab->hash[gap] = p_namtab->hash[slot];
+			gap = slot;
+		}
+	}
+
+	p_namtab->hash[gap] = NO_ENTRY;
+}
+
+
+/**************************************************************************
+ * Function Name  : grow_table		INTERNAL ONLY ROUTINE
+ * Inputs Only    : 
+ * Outputs Only   : 
+ * Input/output	  : p_namtab
+ * Returns        : non zero if there wasn't the memory, or the table is
+ *					already as big as it can be.
+ * Global Used    : None
+ * Description    : Doubles the number of entries, putting the new ones on
+ *					the free list, and rebuilds the hash table to suit.
+ **************************************************************************/
+static int grow_table(NAMTAB_STRUCT * p_namtab)
+{
+	TAB_ENT_STRUCT * p_entries;
+	sgl_int32 * p_hash;
+	int new_entries, hash_bits;
+	int i;
+
+	if(p_namtab->num_entries >= MAX_ENTRIES)
+	{
+		return (-1);
+	}
+
+	new_entries = p_namtab->num_entries ? (p_namtab->num_entries * 2) : FIRST_ENTRIES;
+
+	if(new_entries > MAX_ENTRIES)
+	{
+		new_entries = MAX_ENTRIES;
+	}
+
+	for(hash_bits = 1; (1 << hash_bits) < (new_entries * 2); hash_bits++)
+	{
+		/* nothing */
+	}
+
+	p_hash = SGLMalloc((1 << hash_bits) * sizeof(sgl_int32));
+
+	if(p_hash == NULL)
+	{
+		return (-1);
+	}
+
+	p_entries = SGLRealloc(p_namtab->entries, new_entries * sizeof(TAB_ENT_STRUCT));
+
+	if(p_entries == NULL)
+	{
+		SGLFree(p_hash);
+		return (-1);
+	}
+
+	/*
+	// Put the new entries on the end of the free list, lowest first
+	*/
+	for(i = p_namtab->num_entries; i < new_entries; i++)
+	{
+		p_entries[i].n32name = -1;
+		p_entries[i].n16count = 0;
+		p_entries[i].n32nextfree = (sgl_int32) ((i + 1 < new_entries) ? (i + 1) : -1);
+		p_entries[i].n32entity_type = -1;
+		p_entries[i].n32hashed_name = -1;
+		p_entries[i].u32generation = 0;
+		p_entries[i].p_entity = NULL;
+	}
+
+	if(p_namtab->last_free == -1)
+	{
+		p_namtab->first_free = p_namtab->num_entries;
+	}
+	else
+	{
+		p_entries[p_namtab->last_free].n32nextfree = (sgl_int32) p_namtab->num_entries;
+	}
+
+	p_namtab->last_free = new_entries - 1;
+
+	p_namtab->num_free += new_entries - p_namtab->num_entries;
+	p_namtab->num_entries = new_entries;
+	p_namtab->entries = p_entries;
+
+	for(p_namtab->index_bits = 0;
+		(1 << p_namtab->index_bits) < new_entries;
+		p_namtab->index_bits++)
+	{
+		/* nothing */
+	}
+
+	/*
+	// and hash everything again
+	*/
+	if(p_namtab->hash != NULL)
+	{
+		SGLFree(p_namtab->hash);
+	}
+
+	p_namtab->hash = p_hash;
+	p_namtab->hash_bits = hash_bits;
+
+	for(i = 0; i < (1 << hash_bits); i++)
+	{
+		p_hash[i] = NO_ENTRY;
+	}
+
+	for(i = 0; i < p_namtab->num_entries; i++)
+	{
+		if(p_entries[i].n32hashed_name != -1)
+		{
+			hash_insert(p_namtab, i);
+		}
+	}
+
+	return (0);
+}
+
+
 /**************************************************************************
  * Function Name  : clear_entries		INTERNAL ONLY ROUTINE
  * Inputs Only    : 
@@ -210,7 +480,8 @@ extern PTEXAPI_IF 	gpTextureIF;
  * Input/output	  : p_namtab  - reinitialises the contents of a name table
  * Returns        : None
  * Global Used    : None
- * Description    : Reinitialises the entries of a name table.
+ * Description    : Reinitialises the entries of a name table. It keeps
+ *					the size it has grown to.
  *					INTERNAL ONLY
  **************************************************************************/
 static void clear_entries(NAMTAB_STRUCT * p_namtab)
@@ -236,15 +507,17 @@ static void clear_entries(NAMTAB_STRUCT * p_namtab)
 	// be unallocated (i.e. -1) and setting up the next free
 	// spot (i.e. the next one - except for the very last
 	*/
-	for(i=0; i < MAX_NAM_TAB; i ++, p_ent++)
+	for(i=0; i < p_namtab->num_entries; i ++, p_ent++)
 	{
 		/*
 		// fill in its details
 		*/
-		p_ent->n16name = -1;	/*indicates free (ish)*/
+		p_ent->n32name = -1;	/*indicates free (ish)*/
 		p_ent->n16count=  0;
-		p_ent->n16nextfree = i+1;
-		p_ent->n16entity_type = -1; /* indicates free*/
+		p_ent->n32nextfree = (sgl_int32) (i+1);
+		p_ent->n32entity_type = -1; /* indicates free*/
+		p_ent->n32hashed_name = -1;
+		p_ent->u32generation = 0;
 		p_ent->p_entity = NULL;
 
 	}/*end for*/
@@ -252,16 +525,22 @@ static void clear_entries(NAMTAB_STRUCT * p_namtab)
 	/*
 	// tidy up the last one as there is no next index...
 	*/
-	p_namtab->entries[MAX_NAM_TAB -1 ].n16nextfree = -1;
+	p_namtab->entries[p_namtab->num_entries - 1].n32nextfree = -1;
+
+	for(i = 0; i < (1 << p_namtab->hash_bits); i++)
+	{
+		p_namtab->hash[i] = NO_ENTRY;
+	}
 
 	/*
 	// Set up where to go looking for a free spot,
-	// and the base to produce names.
+	// and the first name to fall back on.
 	*/
-	p_namtab->name_base = 0;
+	p_namtab->next_name = 0;
 
 	p_namtab->first_free = 0;
-	p_namtab->last_free  = (MAX_NAM_TAB - 1);
+	p_namtab->last_free = p_namtab->num_entries - 1;
+	p_namtab->num_free = p_namtab->num_entries;
 
 }
 
@@ -311,15 +590,33 @@ int InitNamtab(P_NAMTAB_STRUCT * namtab_param)
 	*/
 	else	
 	{
-		/*
-		// Save the pointer to the struct
-		*/
-		*namtab_param = (P_NAMTAB_STRUCT)p_namtab;
+		p_namtab->next_name = 0;
+		p_namtab->first_free = -1;
+		p_namtab->last_free = -1;
+		p_namtab->num_free = 0;
+		p_namtab->num_entries = 0;
+		p_namtab->index_bits = 0;
+		p_namtab->entries = NULL;
+		p_namtab->hash_bits = 0;
+		p_namtab->hash = NULL;
 
 		/*
-		// Initialise all the entries
+		// Get the first lot of entries
 		*/
-		clear_entries(p_namtab);
+		if(grow_table(p_namtab) != 0)
+		{
+			SGLFree(p_namtab);
+
+			result = -1;
+			*namtab_param = NULL;
+		}
+		else
+		{
+			/*
+			// Save the pointer to the struct
+			*/
+			*namtab_param = (P_NAMTAB_STRUCT)p_namtab;
+		}
 
 	}/* end else */
 
@@ -358,6 +655,142 @@ void ClearNamtab(P_NAMTAB_STRUCT namtab)
 }
 
 
+/**************************************************************************
+ * Function Name  : ReserveNames
+ * Inputs Only    : count
+ * Outputs Only   : 
+ * Input/output	  : namtab    - the name table to add to
+ * Returns        : non zero if there can't be that many more names
+ * Global Used    : None
+ * Description    : Grows the table now so that count more names can be
+ *					added without it having to grow again.
+ **************************************************************************/
+
+int ReserveNames(P_NAMTAB_STRUCT namtab, int count)
+{
+	/*  Pointer to the real data */
+	NAMTAB_STRUCT * p_namtab;
+
+	ASSERT(namtab != NULL)
+	p_namtab = (NAMTAB_STRUCT *) namtab;
+
+	while(p_namtab->num_free < count)
+	{
+		if(grow_table(p_namtab) != 0)
+		{
+			return (-1);
+		}
+	}
+
+	return (0);
+}
+
+
+/**************************************************************************
+ * Function Name  : add_item		INTERNAL ONLY ROUTINE
+ * Inputs Only    : item (a pointer), and entity type
+ * Outputs Only   : 
+ * Input/output	  : p_namtab  - the name table to add to
+ * Returns        : assigned name of added entity
+ * Global Used    : None
+ * Description    : Takes the entry at the front of the free list, which
+ *					there must be, and gives it a name made from its index
+ *					and generation.
+ **************************************************************************/
+static int add_item(NAMTAB_STRUCT * p_namtab,
+					void *	   item,
+					int	   entity_type)
+{
+	int name;
+	int free_slot;
+	int tries;
+
+	/*  Pointer to an individual entry */
+	TAB_ENT_STRUCT * p_ent;
+
+	ASSERT(p_namtab->num_free != 0);
+
+	/*
+	// Get the next free spot in the table
+	*/
+	free_slot = p_namtab->first_free;
+
+	/*
+	// get easy access to this entry
+	*/
+	p_ent =& p_namtab->entries[free_slot];
+
+	/*
+	// Update the next free entry in the main name table
+	//
+	// (And, when debugging, in the entry as well)
+	*/
+	p_namtab->first_free = p_ent->n32nextfree;
+	p_namtab->num_free --;
+
+	if(p_namtab->first_free == -1)
+	{
+		p_namtab->last_free = -1;
+	}
+
+	#ifdef DEBUG
+	p_ent->n32nextfree = -2;
+	#endif
+
+	/*
+	// Compute a name for this thing, by putting the generation in
+	// the bits above the entry index. A name given out when the
+	// table was smaller can have the same value, in which case move
+	// on a generation.
+	*/
+	tries = (int) (NAME_SPACE >> p_namtab->index_bits);
+
+	do
+	{
+		name = (int) (((p_ent->u32generation << p_namtab->index_bits) | free_slot) &
+					  (NAME_SPACE - 1));
+
+		if(find_entry(p_namtab, name) == -1)
+		{
+			break;
+		}
+
+		p_ent->u32generation ++;
+
+	} while(--tries != 0);
+
+	/*
+	// If every generation is in use, take the next name that isn't.
+	// There are fewer entries than names, so there is always one.
+	*/
+	if(tries == 0)
+	{
+		name = p_namtab->next_name;
+
+		while(find_entry(p_namtab, name) != -1)
+		{
+			name = (int) ((name + 1) & (NAME_SPACE - 1));
+		}
+
+		p_namtab->next_name = (int) ((name + 1) & (NAME_SPACE - 1));
+	}
+
+
+	/*
+	// Store the data in the entry
+	*/
+	p_ent->n32name = (sgl_int32) name;
+	p_ent->n16count=  0;
+	p_ent->n32entity_type = (sgl_int32) entity_type;
+	p_ent->n32hashed_name = (sgl_int32) name;
+	p_ent->p_entity = item;
+
+	hash_insert(p_namtab, free_slot);
+
+	return (name);
+}
+
+
 /**************************************************************************
  * Function Name  : AddNamedItem
  * Inputs Only    : item (a pointer), and entity type
@@ -374,14 +807,8 @@ int AddNamedItem( P_NAMTAB_STRUCT namtab,
 					void *	   item,
 						int	   entity_type)
 {
-	int name;
-	int free_slot;
-
 	/*  Pointer to the real data */
 	NAMTAB_STRUCT * p_namtab;
-	
-	/*  Pointer to an individual entry */
-	TAB_ENT_STRUCT * p_ent;
 
 
 	/*
@@ -391,73 +818,60 @@ int AddNamedItem( P_NAMTAB_STRUCT namtab,
 	p_namtab = (NAMTAB_STRUCT *) namtab;
 
 
-
 	/*
-	// Get the next free spot in the table
+	// if the table is full, try to make it bigger
 	*/
-	free_slot = p_namtab->first_free;
-	
-	/*
-	// if the table is "full"...
-	*/
-	if(free_slot == p_namtab->last_free)
+	if((p_namtab->num_free == 0) && (grow_table(p_namtab) != 0))
 	{
-		name =  sgl_err_no_name;
+		return (sgl_err_no_name);
 	}
-	/*
-	// else fill in the details
-	*/
-	else
-	{
-		/*
-		// get easy access to this entry
-		*/
-		p_ent =& p_namtab->entries[free_slot];
 
-		/*
-		// Update the next free entry in the main name table
-		//
-		// (And, when debugging, in the entry as well)
-		*/
-		p_namtab->first_free = p_ent->n16nextfree;
+	return (add_item(p_namtab, item, entity_type));
+}
 
-		#ifdef DEBUG
-		p_ent->n16nextfree = -2;
-		#endif
 
-		/*
-		// Compute a name for this thing, by masking off the index
-		// bits in the name base, and then putting in the entry index.
-		*/
-		name = (p_namtab->name_base & ~HASH_MASK) | free_slot;
+/**************************************************************************
+ * Function Name  : AddNamedItems
+ * Inputs Only    : count, items (count pointers), and entity type
+ * Outputs Only   : names     - count assigned names
+ * Input/output	  : namtab    - the name table to add to
+ * Returns        : 0, or sgl_err_no_name if there aren't count free names
+ * Global Used    : None
+ * Description    : Adds count entries of the same type in one go. The
+ *					table grows once, up front, and either all of the
+ *					items are added or none are.
+ **************************************************************************/
 
+int AddNamedItems( P_NAMTAB_STRUCT namtab,
+					int	   count,
+					void ** items,
+					int	   entity_type,
+					int	 * names)
+{
+	/*  Pointer to the real data */
+	NAMTAB_STRUCT * p_namtab;
 
-		/*
-		// Store the data in the entry
-		*/
-		p_ent->n16name = (sgl_int16) name;
-		p_ent->n16count=  0;
-		p_ent->n16entity_type = (sgl_int16) entity_type;
-		p_ent->p_entity = item;
+	int i;
 
 
-		/*
-		// move the name base on to the next potential entry,
-		// reseting it back to zero if it grows too large.
-		//
-		// NOTE Dont let it get bigger than our 16Bit names! Say
-		// allow it to 3/4s of the max value.
-		*/
-		p_namtab->name_base += MAX_NAM_TAB;
-		if(p_namtab->name_base > ((3*SHRT_MAX)/4) )
-		{
-			p_namtab->name_base = 0;
-		} /*end if*/
-		
-	} /*end else*/
-	
+	/*
+	// retype the namtab to the internal format
+	*/
+	ASSERT(namtab != NULL)
+	p_namtab = (NAMTAB_STRUCT *) namtab;
 
-	return (name);
+
+	if(ReserveNames(namtab, count) != 0)
+	{
+		return (sgl_err_no_name);
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		names[i] = add_item(p_namtab, items[i], entity_type);
+	}
+
+	return (0);
 }
 
 /**************************************************************************
@@ -475,8 +889,7 @@ void * GetNamedItem(P_NAMTAB_STRUCT namtab,
 	/*  Pointer to the real data */
 	NAMTAB_STRUCT * p_namtab;
 	
-	/*  Pointer to an individual entry */
-	TAB_ENT_STRUCT * p_ent;
+	int index;
 
 	void * result;
 
@@ -488,26 +901,25 @@ void * GetNamedItem(P_NAMTAB_STRUCT namtab,
 
 
 	/*
-	// Check that the name is at least positive.
+	// Check that the name is at least valid.
 	*/
-	if(name < 0)
+	if((name < 0) || (name >= NAME_SPACE))
 	{
 		result = NULL;
 	}
 	else
 	{
 		/*
-		// Map the name to the unique index, and get a pointer
-		// to that entry
+		// Look up the entry
 		*/
-		p_ent =& p_namtab->entries[name & HASH_MASK];
+		index = find_entry(p_namtab, name);
 
 		/*
-		// Do the names match? If so get the pointer to the data
+		// Is it there, and not deleted? If so get the pointer to the data
 		*/
-		if(p_ent->n16name == name)
+		if((index != -1) && (p_namtab->entries[index].n32name == name))
 		{
-			result = p_ent->p_entity;
+			result = p_namtab->entries[index].p_entity;
 		}
 		/*
 		// Else this name is unknown
@@ -537,8 +949,7 @@ int  GetNamedItemType(P_NAMTAB_STRUCT namtab,
 	/*  Pointer to the real data */
 	NAMTAB_STRUCT * p_namtab;
 	
-	/*  Pointer to an individual entry */
-	TAB_ENT_STRUCT * p_ent;
+	int index;
 
 	int result;
 
@@ -549,26 +960,25 @@ int  GetNamedItemType(P_NAMTAB_STRUCT namtab,
 	p_namtab = (NAMTAB_STRUCT *) namtab;
 
 	/*
-	// Check that the name is at least positive.
+	// Check that the name is at least valid.
 	*/
-	if(name < 0)
+	if((name < 0) || (name >= NAME_SPACE))
 	{
 		result = -1;
 	}
 	else
 	{
 		/*
-		// Map the name to the unique index, and get a pointer
-		// that entry
+		// Look up the entry
 		*/
-		p_ent =& p_namtab->entries[name & HASH_MASK];
+		index = find_entry(p_namtab, name);
 
 		/*
-		// Do the names match? If so get the entity type
+		// Is it there, and not deleted? If so get the entity type
 		*/
-		if(p_ent->n16name == name)
+		if((index != -1) && (p_namtab->entries[index].n32name == name))
 		{
-			result = p_ent->n16entity_type;
+			result = p_namtab->entries[index].n32entity_type;
 		}
 		/*
 		// Else this name is unknown
@@ -604,8 +1014,7 @@ void * GetNamedItemAndType(P_NAMTAB_STRUCT pExternNamtab,
 	/*  Pointer to the real data */
 	NAMTAB_STRUCT * p_namtab;
 	
-	/*  Pointer to an individual entry */
-	TAB_ENT_STRUCT * p_ent;
+	int index;
 
 	/*
 	// retype the namtab to the internal format
@@ -615,9 +1024,9 @@ void * GetNamedItemAndType(P_NAMTAB_STRUCT pExternNamtab,
 
 
 	/*
-	// Check that the name is at least positive.
+	// Check that the name is at least valid.
 	*/
-	if(name < 0)
+	if((name < 0) || (name >= NAME_SPACE))
 	{
 		pItem = NULL;
 		*nType = -1;
@@ -625,18 +1034,17 @@ void * GetNamedItemAndType(P_NAMTAB_STRUCT pExternNamtab,
 	else
 	{
 		/*
-		// Map the name to the unique index, and get a pointer
-		// to that entry
+		// Look up the entry
 		*/
-		p_ent =& p_namtab->entries[name & HASH_MASK];
+		index = find_entry(p_namtab, name);
 
 		/*
-		// Do the names match? If so get the pointer to the data
+		// Is it there, and not deleted? If so get the pointer to the data
 		*/
-		if(p_ent->n16name == name)
+		if((index != -1) && (p_namtab->entries[index].n32name == name))
 		{
-			pItem = p_ent->p_entity;
-			*nType = p_ent->n16entity_type;
+			pItem = p_namtab->entries[index].p_entity;
+			*nType = p_namtab->entries[index].n32entity_type;
 		}
 		/*
 		// Else this name is unknown
@@ -697,6 +1105,8 @@ void CALL_CONV sgl_delete_all_textures ( void )
 	TAB_ENT_STRUCT * pEnt;			/*  Pointer to an individual entry */
 	int i;
 
+	DlMarkEdited ();
+
 	if (pNamtab = (P_NAMTAB_STRUCT) GetNameTable ())
 	{
 		/* Step through the name table */
@@ -705,9 +1115,9 @@ void CALL_CONV sgl_delete_all_textures ( void )
 		ASSERT(p_namtab != NULL);
 	
 		pEnt = & p_namtab->entries[0];
-		for(i= MAX_NAM_TAB; i != 0 ; i --, pEnt++)
+		for(i= p_namtab->num_entries; i != 0 ; i --, pEnt++)
 		{
-			if (pEnt->n16entity_type == nt_texture)
+			if (pEnt->n32entity_type == nt_texture)
 			{
 				gpTextureIF->pfnTextureFree (gHLogicalDev->TexHeap, pEnt->p_entity);
 			}	
@@ -716,15 +1126,52 @@ void CALL_CONV sgl_delete_all_textures ( void )
 }
 
 
+/**************************************************************************
+ * Function Name  : sgl_reserve_names
+ * Inputs Only    : count
+ * Outputs Only   : -
+ * Input/output	  : -
+ * Returns        : sgl_no_err, or sgl_err_no_name if there can't be
+ *					that many more names.
+ * Global Used    : None
+ * Description    : Makes room in the name table for count more names in
+ *					one go, before they are created.
+ **************************************************************************/
+
+int CALL_CONV sgl_reserve_names ( int count )
+{
+	P_NAMTAB_STRUCT pNamtab;
+
+	if (count < 0)
+	{
+		return SglError(sgl_err_bad_parameter);
+	}
+
+	if ((pNamtab = (P_NAMTAB_STRUCT) GetNameTable ()) == NULL)
+	{
+		return SglError(sgl_err_failed_init);
+	}
+
+	if (ReserveNames (pNamtab, count) != 0)
+	{
+		return SglError(sgl_err_no_name);
+	}
+
+	return SglError(sgl_no_err);
+}
+
+
 /**************************************************************************
  * Function Name : add_to_free_list 	INTERNAL ONLY ROUTINE
  * Inputs Only   : index, namtab
  * Outputs Only  : 
  * Returns       : None
  * Global Used   : None
- * Description   : Given the index of an entry, it cleans up the values contained
- *				   and adds it on to the free list of entries. It is put on the
- *				   end to reduce the chance of the same name be reproduced...
+ * Description   : Given the index of an entry, it takes it out of the hash
+ *				   table, cleans up the values contained and adds it on to
+ *				   the free list of entries. It moves the entry on a
+ *				   generation, and is put on the end, to reduce the chance
+ *				   of the same name be reproduced...
  **************************************************************************/
 static void add_to_free_list(NAMTAB_STRUCT *p_namtab,
 						int  index)
@@ -732,30 +1179,36 @@ static void add_to_free_list(NAMTAB_STRUCT *p_namtab,
 	/*  Pointer to an individual entry */
 	TAB_ENT_STRUCT * p_ent;
 
-	/*
-	// Get access to the current last entry and set its next
-	// index to be the entry which is being added on...
-	*/
-	p_ent = & p_namtab->entries[p_namtab->last_free];
-	p_ent->n16nextfree = index;
+	hash_remove(p_namtab, index);
 
 	/*
-	// get access to the entry being plocked on the end
+	// get access to the entry being freed
 	*/
 	p_ent = & p_namtab->entries[index];
 
 	/*
-	// clear out the two relevent fields that mark it as free,
-	// (and for neatness, set the next free to be -1)
+	// clear out the relevent fields that mark it as free
 	*/
-	p_ent->n16name = -1;
-	p_ent->n16entity_type = -1;
-	p_ent->n16nextfree = -1;
+	p_ent->n32name = -1;
+	p_ent->n32entity_type = -1;
+	p_ent->n32hashed_name = -1;
+	p_ent->n32nextfree = -1;
+	p_ent->u32generation ++;
 
 	/*
-	// finally, set the last_free to index this entry
+	// Put it on the end of the free list
 	*/
+	if(p_namtab->last_free == -1)
+	{
+		p_namtab->first_free = index;
+	}
+	else
+	{
+		p_namtab->entries[p_namtab->last_free].n32nextfree = (sgl_int32) index;
+	}
+
 	p_namtab->last_free = index;
+	p_namtab->num_free ++;
 
 }
 
@@ -784,34 +1237,35 @@ static void add_to_free_list(NAMTAB_STRUCT *p_namtab,
  *				prevents the counts from going out of control...
  **************************************************************************/
 static void change_named_item_usage(NAMTAB_STRUCT * p_namtab,
-				  					sgl_int16		 name,
+				  					sgl_int32		 name,
 									int			 increment)
 {
 
 	/*  Pointer to an individual entry */
 	TAB_ENT_STRUCT * p_ent;
 
+	int index;
+
 	/*
-	// Check that the name is at least positive.
+	// Check that the name is at least positive, and known.
 	*/
-	if(name >= 0)
+	if((name >= 0) && ((index = find_entry(p_namtab, name)) != -1))
 	{
 		/*
-		// Map the name to the unique index, and get a pointer
-		// that entry
+		// Get a pointer to that entry
 		*/
-		p_ent =& p_namtab->entries[name & HASH_MASK];
+		p_ent =& p_namtab->entries[index];
 
 		/* /////////////
 		// Has this entry been deleted?
 		///////////// */
-		if(p_ent->n16name == -1)
+		if(p_ent->n32name == -1)
 		{
 			/* 
 			// Then check if this is the one we want, and we are just waiting
 			// for the usage count to hit zero.
 			*/
-			if(p_ent->n16entity_type == name)
+			if(p_ent->n32entity_type == name)
 			{
 				ASSERT(p_ent->n16count > 0)
 
@@ -836,7 +1290,7 @@ static void change_named_item_usage(NAMTAB_STRUCT * p_namtab,
 					*/
 					if(p_ent->n16count == 0)
 					{
-						add_to_free_list(p_namtab, name & HASH_MASK);
+						add_to_free_list(p_namtab, index);
 					}
 				}/* Else decrementing */
 
@@ -846,7 +1300,7 @@ static void change_named_item_usage(NAMTAB_STRUCT * p_namtab,
 		/* /////////////
 		// Else, is this name unrecognised?
 		///////////// */
-		else if(p_ent->n16name != name)
+		else if(p_ent->n32name != name)
 		{
 			/* Do nothing*/
 		}
@@ -915,7 +1369,7 @@ void IncNamedItemUsage(P_NAMTAB_STRUCT namtab,
 	ASSERT(namtab != NULL)
 	p_namtab = (NAMTAB_STRUCT *) namtab;
 	
-	change_named_item_usage( p_namtab, (sgl_int16)name, 1);
+	change_named_item_usage( p_namtab, (sgl_int32)name, 1);
 
 }
 
@@ -943,7 +1397,7 @@ void DecNamedItemUsage(P_NAMTAB_STRUCT namtab,
 	ASSERT(namtab != NULL)
 	p_namtab = (NAMTAB_STRUCT *) namtab;
 	
-	change_named_item_usage( p_namtab, (sgl_int16)name, 0);
+	change_named_item_usage( p_namtab, (sgl_int32)name, 0);
 }
 
 
@@ -967,6 +1421,8 @@ extern void DeleteNamedItem(P_NAMTAB_STRUCT namtab,
 	/*  Pointer to an individual entry */
 	TAB_ENT_STRUCT * p_ent;
 
+	int index;
+
 
 	/*
 	// retype the namtab to the internal format
@@ -975,25 +1431,25 @@ extern void DeleteNamedItem(P_NAMTAB_STRUCT namtab,
 	p_namtab = (NAMTAB_STRUCT *) namtab;
 
 
-	if(name >= 0)
+	if((name >= 0) && (name < NAME_SPACE) &&
+	   ((index = find_entry(p_namtab, name)) != -1))
 	{
 		/*
-		// Map the name to the unique index, and get a pointer
-		// that entry
+		// Get a pointer to that entry
 		*/
-		p_ent = & p_namtab->entries[name & HASH_MASK];
+		p_ent = & p_namtab->entries[index];
 		
 		/* /////////////
 		// Does the name match?
 		///////////// */
-		if(p_ent->n16name == name)
+		if(p_ent->n32name == name)
 		{
 			/*
 			// If the usage count is Zero, then really delete it
 			*/
 			if(p_ent->n16count == 0)
 			{
-				add_to_free_list(p_namtab, name & HASH_MASK);
+				add_to_free_list(p_namtab, index);
 			}
 			/*
 			// Else, copy the name into the entity_type (i.e. its other
@@ -1001,8 +1457,8 @@ extern void DeleteNamedItem(P_NAMTAB_STRUCT namtab,
 			*/
 			else
 			{
-				p_ent->n16entity_type = name;
-				p_ent->n16name = -1;
+				p_ent->n32entity_type = name;
+				p_ent->n32name = -1;
 			}
 
 		}/*end if name matches*/
@@ -1051,9 +1507,9 @@ void GetNameStats(P_NAMTAB_STRUCT pnamtab,	NAME_STATS_STRUCT *pNameStats)
 	// Step through the name table and count the number of each type
 	*/
 	p_ent = & p_namtab->entries[0];
-	for(i= MAX_NAM_TAB; i != 0 ; i --, p_ent++)
+	for(i= p_namtab->num_entries; i != 0 ; i --, p_ent++)
 	{
-		switch(p_ent->n16entity_type)
+		switch(p_ent->n32entity_type)
 		{
 			case nt_list_node: 
 			{
@@ -107,6 +107,28 @@ extern int AddNamedItem( P_NAMTAB_STRUCT pnamtab,
 
 
 
+/*
+// Add count items of the same type, and get a name for each in names.
+// Either all of them are added, or (if the table can't hold that many)
+// none are and it returns sgl_err_no_name.
+*/
+extern int AddNamedItems( P_NAMTAB_STRUCT pnamtab,
+					int	   count,
+					void ** items,
+					int	   entity_type,
+					int	 * names);
+
+
+
+/*
+// Make sure count more names can be added without the table growing.
+// Returns non zero if it can't hold that many.
+*/
+extern int ReserveNames( P_NAMTAB_STRUCT pnamtab,
+					int	   count);
+
+
+
 /*
 // Retrieve a pointer to a named object. If the returned pointer
 // is NULL then there is no such entry.
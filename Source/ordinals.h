@@ -241,6 +241,13 @@ TOPSTRING
 	ZFUNCTION(SglSetGlobal, 135, void)
 	ZFUNCTION(SglInitialise, 136, int)
 	 /*ZFUNCTION(SglGetFuncptrs,137, int )*/
+	YFUNCTION(sgl_profile_enable,138, void )
+	YFUNCTION(sgl_profile_get_frames,139, int )
+	YFUNCTION(sgl_profile_write_trace,140, int )
+	YFUNCTION(sgl_compact_texture_memory,141, unsigned long )
+	YFUNCTION(sgl_reserve_names,142, int )
+	YFUNCTION(sgl_set_light_range,143, void )
+	YFUNCTION(sgl_create_materials,144, int )
 	LAST_PUBLIC_FUNCTION
 /*************************************
 ** Insert private functions after here 	
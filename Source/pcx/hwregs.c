@@ -339,6 +339,8 @@
 #include "pvrlims.h"
 
 #include "metrics.h"
+#include "frmpipe.h"
+#include "capture.h"
 SGL_EXTERN_TIME_REF /* if we are timing code */
 
 sgl_uint32 DetermineTexMemConfig( sgl_uint32 uSettings );
@@ -526,6 +528,9 @@ sgl_bool CALL_CONV HWFinishedRender(void)
 		{
 			bEndOfRender = TRUE;
 
+			/* The board renders one frame at a time */
+			FramePipeRetire (FramePipeLastIssued ());
+
 			/* Detected Hardware end-of-render */
 			PVROSCallback (gHLogicalDev, CB_END_OF_RENDER, NULL);
 
@@ -574,10 +579,8 @@ void CALL_CONV HWStartRender(sgl_bool bFlipRequested, HDISPLAY hDisplay, sgl_boo
 	SGL_TIME_SUSPEND(TOTAL_RENDER_TIME);
 	SGL_TIME_START(RENDER_WAITING_TIME);
 
-	while (!HWFinishedRender ())
-	{
-		/* Do nothing */
-	}
+	/* The board has one set of render registers */
+	FramePipeWait (FramePipeLastIssued ());
 	
 	SGL_TIME_STOP(RENDER_WAITING_TIME);
 	SGL_TIME_RESUME(TOTAL_RENDER_TIME);
@@ -606,7 +609,10 @@ void CALL_CONV HWStartRender(sgl_bool bFlipRequested, HDISPLAY hDisplay, sgl_boo
 
 		ProgramStrideReg (PRCS.PhysRenderBufferStride);
 		
+		CaptureFrame (gHLogicalDev, FALSE);
+
 		PVROSScheduleRender (gHLogicalDev);
+		FramePipeIssue ();
 	}
 
 	bEndOfRender = FALSE;
@@ -615,7 +621,10 @@ void CALL_CONV HWStartRender(sgl_bool bFlipRequested, HDISPLAY hDisplay, sgl_boo
 /*****************/
 void CALL_CONV HWStartRenderStrip()
 {
+	CaptureFrame (gHLogicalDev, TRUE);
+
 	PVROSScheduleRender (gHLogicalDev);
+	FramePipeIssue ();
 	bEndOfRender = FALSE;
 }
 
@@ -732,7 +732,7 @@ void RnSetupDefaultCamera(CAMERA_NODE_STRUCT *pDefaultCamera)
 	*/
 	#if DEBUG
 		pDefaultCamera->node_hdr.n16_node_type = -1;
-		pDefaultCamera->node_hdr.n16_name = -1;
+		pDefaultCamera->node_hdr.n32_name = -1;
 		pDefaultCamera->node_hdr.next_node = NULL;
 	#endif
 	
@@ -0,0 +1,86 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rnckern.h,v $
+Title           :   RNCKERN.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Body of the convex plane projection kernel, written once
+					in terms of the vector macros and included by rncsimd.c
+					for each instruction set. The includer defines
+					CONVPROJ_KERNEL, CONVPROJ_TARGET and the VF_ / VI_
+					macros first.
+
+					Each lane does what RnProjectAndClassifyPlanes does
+					with a plane that is safe to project, in the same order,
+					so the results match the scalar code.
+
+Program Type    :   C include file (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rnckern.h,v $
+
+;--
+*****************************************************************************/
+
+static CONVPROJ_TARGET void CONVPROJ_KERNEL (CONVPROJLANES *pLanes,
+											 int nFirst,
+											 const CONVPROJCONTEXT *pCtx)
+{
+	VF	NX, NY, NZ, D;
+	VF	CentreDotNorm, XBorder, YBorder, MaxBorder, Safe, InvD, Middle;
+	VI	Category;
+
+	NX = VF_LOAD (pLanes->fNormal[0] + nFirst);
+	NY = VF_LOAD (pLanes->fNormal[1] + nFirst);
+	NZ = VF_LOAD (pLanes->fNormal[2] + nFirst);
+	D  = VF_LOAD (pLanes->fD + nFirst);
+
+	/*
+	// Dot product of the normal and the centre of the pseudo rendered
+	// region, and the offsets to its corners
+	*/
+	CentreDotNorm = VF_ADD (VF_ADD (VF_MUL (NX, VF_SET1 (pCtx->RCentre[0])),
+									VF_MUL (NY, VF_SET1 (pCtx->RCentre[1]))),
+							VF_MUL (NZ, VF_SET1 (pCtx->RCentre[2])));
+
+	XBorder = VF_MUL (NX, VF_SET1 (pCtx->xToCorner));
+	YBorder = VF_MUL (NY, VF_SET1 (pCtx->yToCorner));
+	MaxBorder = VF_ADD (VF_ABS (XBorder), VF_ABS (YBorder));
+
+	/* every corner meets the plane safely far away */
+	Safe = VF_LT (VF_ADD (VF_ABS (CentreDotNorm), MaxBorder), VF_ABS (D));
+
+	/* the other lanes divide by 1 and aren't used */
+	InvD = VF_DIV (VF_SET1 (pCtx->fOverflowRescale),
+				   VF_SEL (Safe, D, VF_SET1 (1.0f)));
+
+	VF_STORE (pLanes->fA + nFirst,
+			  VF_MUL (VF_MUL (NX, VF_SET1 (pCtx->xPerPixel)), InvD));
+	VF_STORE (pLanes->fB + nFirst,
+			  VF_MUL (VF_MUL (NY, VF_SET1 (pCtx->yPerPixel)), InvD));
+
+	Middle = VF_SUB (CentreDotNorm, VF_ADD (XBorder, YBorder));
+
+	VF_STORE (pLanes->fC + nFirst, VF_MUL (Middle, InvD));
+	VI_STORE (pLanes->nC + nFirst,
+			  VF_TOI (VF_MUL (Middle, VF_MUL (InvD, VF_SET1 (pCtx->fFixedScale)))));
+
+	/*
+	// Forward if d <= 0, else reverse, and invisible if the caller says so
+	*/
+	Category = VI_OR (VI_AND (VF_TO_VI (VF_LT (VF_SET1 (0.0f), D)),
+							  VI_SET1 (CONVPROJ_RV)),
+					  VI_LOAD (pLanes->nInvisible + nFirst));
+
+	VI_STORE (pLanes->nCategory + nFirst,
+			  VI_SEL (VF_TO_VI (Safe), Category, VI_SET1 (CONVPROJ_TRICKY)));
+}
+
+/*------------------------------- End of File -------------------------------*/
@@ -498,6 +498,7 @@
 
 /* Needed for to use dregion.c optimisation routines. */
 #include "dregion.h"
+#include "rncsimd.h"
 
 SGL_EXTERN_TIME_REF /* if we are timing code */
 
@@ -545,6 +546,13 @@ static  USED_MATERIAL_TAB   UsedMaterials;
 /* bit of a hack really ... */
 static SMOOTHPARAMS gSP;
 
+/*
+// The plane projection kernel picked by RnConvexOnSglInitialise, or NULL
+// to use ProjectPlanesOneAtATime
+*/
+static CONVPROJFN	gpfnConvProj = NULL;
+static int			gnConvProjLanes = 1;
+
 
 /**************************************************************************
 * Function Name  : DetermineRegionDistances (LOCAL FUNCTION)
@@ -759,6 +767,69 @@ static void DetermineRegionDistances( REGIONS_RECT_STRUCT * Regions,
 }	
 
 
+/**************************************************************************
+* Function Name  : ProjectPlanesOneAtATime (LOCAL FUNCTION)
+* Inputs         : The planes' normals, d values and visibility, the
+*				   projection values and the number of planes
+* Outputs        : A, B and C and the category of each plane
+* Returns        : None
+* Global Used    : None
+*
+* Description    : What the vector kernels in rncsimd.c do, for builds or
+*				   CPUs that have none.
+**************************************************************************/
+static void ProjectPlanesOneAtATime(CONVPROJLANES *pLanes,
+									const CONVPROJCONTEXT *pCtx,
+									const int nPlanes)
+{
+	int k;
+
+	for(k = 0; k < nPlanes; k++)
+	{
+		float centreDotNorm, XBorder, YBorder, MaxBorder, invD;
+
+		/*
+		// Dot product of planes normal and the point at the centre
+		// of the "pseudo" rendered region, and the offsets to the
+		// corners
+		*/
+		centreDotNorm = pLanes->fNormal[0][k] * pCtx->RCentre[0] +
+						pLanes->fNormal[1][k] * pCtx->RCentre[1] +
+						pLanes->fNormal[2][k] * pCtx->RCentre[2];
+		XBorder = pLanes->fNormal[0][k] * pCtx->xToCorner;
+		YBorder = pLanes->fNormal[1][k] * pCtx->yToCorner;
+		MaxBorder = sfabs(XBorder) + sfabs(YBorder);
+
+		/*
+		// Check that the plane doesn't come too close to the camera.
+		// This tests that ALL corners of pseudo rendered region
+		// intersect the plane safely far enough away.
+		*/
+		if(sfabs(pLanes->fD[k]) <= (sfabs(centreDotNorm) + MaxBorder))
+		{
+			pLanes->nCategory[k] = CONVPROJ_TRICKY;
+			continue;
+		}
+
+		/*
+		// If A and B could span the same range as C, the following would
+		// just be a division by Z. However, A and B are "n" bits less (in
+		// max value) so to prevent overflow (which is more likely to
+		// occur as the size of the device goes down) we rescale it.
+		*/
+		invD = pCtx->fOverflowRescale / pLanes->fD[k];
+
+		pLanes->fA[k] = pLanes->fNormal[0][k] * pCtx->xPerPixel * invD;
+		pLanes->fB[k] = pLanes->fNormal[1][k] * pCtx->yPerPixel * invD;
+		pLanes->fC[k] = (centreDotNorm - (XBorder + YBorder)) * invD;
+		pLanes->nC[k] = (sgl_int32) ((centreDotNorm - (XBorder + YBorder)) *
+									 (invD * pCtx->fFixedScale));
+
+		pLanes->nCategory[k] = ((pLanes->fD[k] <= 0.0f) ? CONVPROJ_FV : CONVPROJ_RV) |
+								pLanes->nInvisible[k];
+	}
+}
+
 /**************************************************************************
 * Function Name  : RnProjectAndClassifyPlanes (LOCAL FUNCTION)
 * Inputs         : pointer to convex node
@@ -784,6 +855,7 @@ static void DetermineRegionDistances( REGIONS_RECT_STRUCT * Regions,
 *
 *
 **************************************************************************/
+
 static sgl_bool RnProjectAndClassifyPlanes(const int NumPlanesToDo,
 					/*
 					// Pointer to the first plane of the batch
@@ -802,7 +874,13 @@ static sgl_bool RnProjectAndClassifyPlanes(const int NumPlanesToDo,
 										int * pRVAffected)
 {
 
-	int i;
+	int i, k, nGroup;
+
+	/*
+	// A group of planes in the form the projection kernels want
+	*/
+	CONVPROJCONTEXT Ctx;
+	CONVPROJLANES Lanes;
 
 	int LocalFVAffected;
 	int LocalRVAffected;
@@ -814,18 +892,25 @@ static sgl_bool RnProjectAndClassifyPlanes(const int NumPlanesToDo,
 	TRANSFORMED_PLANE_STRUCT ** ppFVplane;
 	TRANSFORMED_PLANE_STRUCT ** ppRVplane;
 	PROJECTION_MATRIX_STRUCT * const pProjMat  = RnGlobalGetProjMat();
-	sgl_vector RCentre;
 	float xToCorner, yToCorner, xPerPixel, yPerPixel;
 	float fOverflowRescale;
 
-	RCentre[0] = pProjMat->RCentre[0];
-	RCentre[1] = pProjMat->RCentre[1];
-	RCentre[2] = pProjMat->RCentre[2];
 	xToCorner = pProjMat->xToCorner;
 	yToCorner = pProjMat->yToCorner;
 	yPerPixel = pProjMat->yPerPixel;
 	xPerPixel = pProjMat->xPerPixel;
 	fOverflowRescale = pProjMat->fOverflowRescale;
+
+	Ctx.RCentre[0] = pProjMat->RCentre[0];
+	Ctx.RCentre[1] = pProjMat->RCentre[1];
+	Ctx.RCentre[2] = pProjMat->RCentre[2];
+	Ctx.xToCorner = xToCorner;
+	Ctx.yToCorner = yToCorner;
+	Ctx.xPerPixel = xPerPixel;
+	Ctx.yPerPixel = yPerPixel;
+	Ctx.fOverflowRescale = fOverflowRescale;
+	Ctx.fFixedScale = FLOAT_TO_FIXED;
+
 	/*
 	// Check the number of planes in each category list
 	*/
@@ -846,304 +931,303 @@ static sgl_bool RnProjectAndClassifyPlanes(const int NumPlanesToDo,
 
 	ppFVplane = &PlaneLists->FVPlanes[PlaneLists->NumFV];
 	ppRVplane = &PlaneLists->RVPlanes[PlaneLists->NumRV];
+
 	/*
-	// Step through the planes in this batch
+	// Step through the planes a group at a time. The kernel projects
+	// the whole group and says which list each plane goes on, then the
+	// planes are stored straight onto those lists. Only the planes that
+	// aren't safe to project are looked at one at a time.
 	*/
-	for(i = 0; i < NumPlanesToDo; i++, pPlane++, pTextureData++, 
-									   pShadingData++, pPointsData++)
+	for(i = 0; i < NumPlanesToDo; i += nGroup)
 	{
-		float centreDotNorm;
-		float XBorder, YBorder, MaxBorder;
+		nGroup = NumPlanesToDo - i;
+		if(nGroup > CONVPROJ_MAX_LANES)
+		{
+			nGroup = CONVPROJ_MAX_LANES;
+		}
 
 		/*
-		// Do checking for perpendicular plane cases
-		//
-		// Dot product of planes normal and the point at the centre
-		// of the "pseudo" rendered region, and the offsets to the
-		// corners
+		// Load the group into lanes. A kernel always does all of its
+		// lanes, so the spare ones get copies of the last plane.
 		*/
-		centreDotNorm = DotProd(pPlane->normal, RCentre);
-		XBorder = pPlane->normal[0] * xToCorner;
-		YBorder = pPlane->normal[1] * yToCorner;
-		MaxBorder = sfabs(XBorder) + sfabs(YBorder);
+		for(k = 0; k < CONVPROJ_MAX_LANES; k++)
+		{
+			const TRANSFORMED_PLANE_STRUCT *pLane = &pPlane[MIN(k, nGroup - 1)];
 
-		/****************************
-		// Check that the plane doesn't come too close to the camera.
-		// This tests that ALL corners of pseudo rendered region intersect
-		// the plane safely far enough away.
-		****************************/
-		DPFOO((DBG_MESSAGE, "Only Using simple Projection!"));
+			Lanes.fNormal[0][k] = pLane->normal[0];
+			Lanes.fNormal[1][k] = pLane->normal[1];
+			Lanes.fNormal[2][k] = pLane->normal[2];
+			Lanes.fD[k] = pLane->d;
+			Lanes.nInvisible[k] = (pLane->flags & pf_visible) ? 0 : 1;
+		}
 
-		if(sfabs(pPlane->d) > (sfabs(centreDotNorm) + MaxBorder))
+		if(gpfnConvProj != NULL)
 		{
-			float invD;
+			for(k = 0; k < nGroup; k += gnConvProjLanes)
+			{
+				gpfnConvProj(&Lanes, k, &Ctx);
+			}
+		}
+		else
+		{
+			ProjectPlanesOneAtATime(&Lanes, &Ctx, nGroup);
+		}
 
-			/*
-			// The plane is quite safe to project.
-			// If A and B could span the same range as C, the following
-			// would just be a division by Z. However, A and B are "n" bits
-			// less (in max value) so to prevent overflow (which is more
-			// likely to occur as the size of the device goes down) 
-			// we rescale it.
-			*/
-			invD = fOverflowRescale/ pPlane->d;
+		for(k = 0; k < nGroup; k++, pPlane++, pTextureData++, 
+									pShadingData++, pPointsData++)
+		{
+			float centreDotNorm;
+			float XBorder;
+			float YBorder;
+			float MaxBorder;
+
+			DPFOO((DBG_MESSAGE, "Only Using simple Projection!"));
 
+			if(Lanes.nCategory[k] != CONVPROJ_TRICKY)
+			{
 #if (PCX2 || PCX2_003) && !FORCE_NO_FPU
-			pPlane->f32A = pPlane->normal[0] * xPerPixel * invD;
-			pPlane->f32B = pPlane->normal[1] * yPerPixel * invD;
-			pPlane->f32C = ((centreDotNorm - (XBorder + YBorder))* invD);
+				pPlane->f32A = Lanes.fA[k];
+				pPlane->f32B = Lanes.fB[k];
+				pPlane->f32C = Lanes.fC[k];
 #else
-		    SGL_TIME_SUSPEND(PROJECTION_TIME)
-			pPlane->n32A =
-			  PackTo20Bit(pPlane->normal[0] * xPerPixel * invD);
-			pPlane->n32B =
-			  PackTo20Bit(pPlane->normal[1] * yPerPixel * invD);
-		    SGL_TIME_RESUME(PROJECTION_TIME)
-
-			/* 
-			// NOTE: Following calculation may not be accurate enough....
-			// (C is the value at pixel (0,0))
-			//
-			// First rescale by FLOAT TO FIXED.
-			*/
-			invD = invD * FLOAT_TO_FIXED;
-			pPlane->n32C= (sgl_int32) ((centreDotNorm - (XBorder + YBorder))* invD);
+			    SGL_TIME_SUSPEND(PROJECTION_TIME)
+				pPlane->n32A = PackTo20Bit(Lanes.fA[k]);
+				pPlane->n32B = PackTo20Bit(Lanes.fB[k]);
+			    SGL_TIME_RESUME(PROJECTION_TIME)
+
+				/* 
+				// NOTE: C may not be accurate enough....
+				// (C is the value at pixel (0,0))
+				*/
+				pPlane->n32C = Lanes.nC[k];
 #endif
+			}
 
 			/*
-			// Add the plane to the correct category
-			// If a forward plane (i.e. negative d)
+			// Add the plane to the list the kernel picked
 			*/
-			if(pPlane->d <= 0.0f)
+			switch(Lanes.nCategory[k])
 			{
+			case CONVPROJ_FV:
 				/*
-				// Decide if visible or invisible, and add to
-				// the required list.
+				// Save as forward visible
 				*/
-				if(pPlane->flags & pf_visible)
-				{
-					/*
-					// Save as forward visible
-					*/
-					*ppFVplane = pPlane;
-					ppFVplane ++;
-					LocalFVAffected++;
+				*ppFVplane = pPlane;
+				ppFVplane ++;
+				LocalFVAffected++;
 
-					/*
-					// In case we need it, store the
-					// shading/ texturing data for the plane
-					*/
-					pPlane->pTextureData  =	pTextureData;
-					pPlane->pShadingData  = pShadingData;
-					pPlane->pPointsData  = pPointsData;
-						
-				}
+				/*
+				// In case we need it, store the
+				// shading/ texturing data for the plane
+				*/
+				pPlane->pTextureData  =	pTextureData;
+				pPlane->pShadingData  = pShadingData;
+				pPlane->pPointsData  = pPointsData;
+				break;
+
+			case CONVPROJ_FI:
 				/*
 				// Save as forward INvisible
 				*/
-				else
-				{
-					PlaneLists->FIPlanes[PlaneLists->NumFI] = pPlane;
-					PlaneLists->NumFI++;
-				}
-			}
-			/*
-			// Else a reverse plane
-			*/
-			else
-			{
+				PlaneLists->FIPlanes[PlaneLists->NumFI] = pPlane;
+				PlaneLists->NumFI++;
+				break;
+
+			case CONVPROJ_RV:
+				/*
+				// Save as Reverse visible
+				*/
+				*ppRVplane = pPlane;
+				ppRVplane ++;
+				LocalRVAffected++;
+
+				pPlane->pTextureData  =	 pTextureData;
+				pPlane->pShadingData  =  pShadingData;
+				pPlane->pPointsData  = pPointsData;
+				break;
+
+			case CONVPROJ_RI:
 				/*
-				// Decide if visible or invisible, and add to
-				// the required list.
+				// Save as Reverse INvisible
 				*/
-				if(pPlane->flags & pf_visible)
+				PlaneLists->RIPlanes[PlaneLists->NumRI] = pPlane;
+				PlaneLists->NumRI++;
+				break;
+
+			default:
+				/*
+				// The sums the kernel threw away, for this plane only
+				*/
+				centreDotNorm = DotProd(pPlane->normal, pProjMat->RCentre);
+				XBorder = pPlane->normal[0] * xToCorner;
+				YBorder = pPlane->normal[1] * yToCorner;
+				MaxBorder = sfabs(XBorder) + sfabs(YBorder);
+
+				/*****************************
+				// ELSE we have a tricky plane which MIGHT be perpendicular
+				//
+				// Determine whether it is just too close to the eye, or always behind.
+				//
+				// If so then:
+				//   If the plane is facing in the direction of the camera then the
+				//   whole object can be rejected, else just the plane can be rejected.
+				// 
+				// This tests if ALL of the corners are IN FRONT of the clipping
+				// plane.
+				*****************************/
+				if ( (sfabs(pPlane->d) * pProjMat->fProjectedClipDist) <=
+					      (sfabs(centreDotNorm) - MaxBorder) )
 				{
-					/*
-					// Save as Reverse visible
-					*/
-					*ppRVplane = pPlane;
-					ppRVplane ++;
-					LocalRVAffected++;
+					DPF((DBG_MESSAGE,
+						"Got Plane too close everywhere: d:%f  N:[%f,%f,%f]", 
+						pPlane->d, pPlane->normal[0], 
+						pPlane->normal[1], pPlane->normal[2] ));
 
-					/*
-					// In case we need it, store the
-					// shading/ texturing data for the plane
-					*/
-					pPlane->pTextureData  =	 pTextureData;
-					pPlane->pShadingData  =  pShadingData;
-					pPlane->pPointsData  = pPointsData;
+					if (pPlane->normal[2] > 0.0f)
+					{
+						/* Reject the whole object */
+						SGL_TIME_STOP(PROJECTION_TIME)
+						return TRUE; /* object is offscreen */
+					}
+					else
+					{
+						/* Reject (ignore) the plane */
+					}
 				}
+				/*****************************
+				// Else it needs the perpendicular treatment
+				*****************************/
 				else
 				{
+					float middle;
+					float offset;
+					float maxValue;
+
+					DPF((DBG_MESSAGE, 
+						"Got Perp Plane: d:%f  N:[%f,%f,%f]Using Min (not clip) dist)", 
+						 pPlane->d, pPlane->normal[0], 
+						 pPlane->normal[1], pPlane->normal[2] ));
+			
 					/*
-					// Save as Reverse INvisible
+					// if the rep point is in front of the clipping plane,
+					// use the clipping plane as the plane that we intersect
+					// the per plane with.
 					*/
-					PlaneLists->RIPlanes[PlaneLists->NumRI] = pPlane;
-					PlaneLists->NumRI++;
-				}
-
-			}/*end if (foward plane) else*/
+					if(sfabs(pPlane->repPnt[2]) < pProjMat->foregroundDistance)
+					{
+						offset = pPlane->d * pProjMat->invForegroundDistance;
+					}
+					/*
+					// Else use the z=repPnt[2] plane (approximately)
+					*/
+					else
+					{
+						offset = pPlane->d * pProjMat->RCentre[2] *
+											ApproxRecip(pPlane->repPnt[2]);
+					}/*end else*/
 
-		}
-		/*****************************
-		// ELSE we have a tricky plane which MIGHT be perpendicular
-		//
-		// Determine whether it is just too close to the eye, or always behind.
-		//
-		// If so then:
-		//   If the plane is facing in the direction of the camera then the
-		//   whole object can be rejected, else just the plane can be rejected.
-		// 
-		// This tests if ALL of the corners are IN FRONT of the clipping
-		// plane.
-		*****************************/
-		else if ( (sfabs(pPlane->d) * pProjMat->fProjectedClipDist) <=
-			      (sfabs(centreDotNorm) - MaxBorder) )
-		{
-			DPF((DBG_MESSAGE,
-				"Got Plane too close everywhere: d:%f  N:[%f,%f,%f]", 
-				pPlane->d, pPlane->normal[0], 
-				pPlane->normal[1], pPlane->normal[2] ));
+					/*
+					// The plane is intersected with either the foreground clip
+					// distance, or the z= repZ plane.
+					// Work out how large a naive function that specifies the line
+					// equation (in the form Ax+By+C=0) will be for the extreme
+					// X and Y values.
+					// (also work out how small it will get... We may be able to
+					// reject the whole plane, or if we are lucky, the entire
+					// object).
+					*/
+					middle = (centreDotNorm - offset);
+				
+					/*
+					// Is this object is completely off the PSEUDO 
+					// RENDERED RECT / DEVICE?
+					//
+					// Effectively, get the minimum value, i.e.
+					//     minValue = middle - MaxBorder;
+					// and see if this is positive.
+					// i.e.
+					//     minValue = middle - MaxBorder >= 0;
+					// i.e.
+					*/
+					if(middle >= MaxBorder)
+					{
+						DPF((DBG_MESSAGE, 
+							"Perpendicular plane rejects object: d:%f  N:[%f,%f,%f]", 
+							pPlane->d, pPlane->normal[0], 
+							pPlane->normal[1], pPlane->normal[2] ));
 
-			if (pPlane->normal[2] > 0.0f)
-			{
-				/* Reject the whole object */
-				SGL_TIME_STOP(PROJECTION_TIME)
-				return TRUE; /* object is offscreen */
-			}
-			else
-			{
-				/* Reject (ignore) the plane */
-			}
-		}
-		/*****************************
-		// Else it needs the perpendicular treatment
-		*****************************/
-		else
-		{
-			float middle;
-			float offset;
-			float maxValue;
-
-			DPF((DBG_MESSAGE, 
-				"Got Perp Plane: d:%f  N:[%f,%f,%f]Using Min (not clip) dist)", 
-				 pPlane->d, pPlane->normal[0], 
-				 pPlane->normal[1], pPlane->normal[2] ));
+					    SGL_TIME_STOP(PROJECTION_TIME)
+						return TRUE;
+					}
+					/*
+					// Is this plane off the pseudo rendered rect,
+					// (but the object probably still on)
+					//
+					// This occurs when the maximum possible value is negative i.e.
+					//		maxValue = middle + MaxBorder <= 0.0;
+					// i.e.
+					// 		middle <= - MaxBorder
+					*/
+					else if(middle <= -MaxBorder)
+					{
+						DPF((DBG_MESSAGE, 
+							"Perp plane off device - ignoring it: d:%f  N:[%f,%f,%f]", 
+							pPlane->d, pPlane->normal[0], 
+							pPlane->normal[1], pPlane->normal[2] ));
+
+						/*
+						// ignore this plane, but continue with the others
+						*/
+						continue;
+					}/*end special rejection cases for perp planes*/
 			
-			/*
-			// if the rep point is in front of the clipping plane,
-			// use the clipping plane as the plane that we intersect
-			// the per plane with.
-			*/
-			if(sfabs(pPlane->repPnt[2]) < pProjMat->foregroundDistance)
-			{
-				offset = pPlane->d * pProjMat->invForegroundDistance;
-			}
-			/*
-			// Else use the z=repPnt[2] plane (approximately)
-			*/
-			else
-			{
-				offset = pPlane->d * pProjMat->RCentre[2] *
-									ApproxRecip(pPlane->repPnt[2]);
-			}/*end else*/
+			
+					/*
+					// Note that we negate here, because the hardware states
+					// and object is inside when the function > 0, while we
+					// are inside the object when N.X < 0...
+					*/
+	#if (PCX2 || PCX2_003) && !FORCE_NO_FPU
+					maxValue = -fOverflowRescale;
 
-			/*
-			// The plane is intersected with either the foreground clip
-			// distance, or the z= repZ plane.
-			// Work out how large a naive function that specifies the line
-			// equation (in the form Ax+By+C=0) will be for the extreme
-			// X and Y values.
-			// (also work out how small it will get... We may be able to
-			// reject the whole plane, or if we are lucky, the entire
-			// object).
-			*/
-			middle = (centreDotNorm - offset);
-				
-			/*
-			// Is this object is completely off the PSEUDO 
-			// RENDERED RECT / DEVICE?
-			//
-			// Effectively, get the minimum value, i.e.
-			//     minValue = middle - MaxBorder;
-			// and see if this is positive.
-			// i.e.
-			//     minValue = middle - MaxBorder >= 0;
-			// i.e.
-			*/
-			if(middle >= MaxBorder)
-			{
-				DPF((DBG_MESSAGE, 
-					"Perpendicular plane rejects object: d:%f  N:[%f,%f,%f]", 
-					pPlane->d, pPlane->normal[0], 
-					pPlane->normal[1], pPlane->normal[2] ));
+					/* PCX2 hardware performs scaling when planes are perpendicular.
+					 */
+					pPlane->f32A = (pPlane->normal[0] * xPerPixel * maxValue);
+					pPlane->f32B = (pPlane->normal[1] * yPerPixel * maxValue);
+					pPlane->f32C = ((middle - (XBorder + YBorder)) * maxValue);
+	#else
+					/*
+					// Generate a scaling value based on the max Value. Effectively
+					// we want to divide through by the ABSOLUTE  max value so that
+					//  we don't exceed the limits of the fixed point hardware. 
+					*/
+					maxValue = sfabs(middle) + MaxBorder;
+					maxValue = -fOverflowRescale * ApproxRecip(maxValue);
 
-			    SGL_TIME_STOP(PROJECTION_TIME)
-				return TRUE;
-			}
-			/*
-			// Is this plane off the pseudo rendered rect,
-			// (but the object probably still on)
-			//
-			// This occurs when the maximum possible value is negative i.e.
-			//		maxValue = middle + MaxBorder <= 0.0;
-			// i.e.
-			// 		middle <= - MaxBorder
-			*/
-			else if(middle <= -MaxBorder)
-			{
-				DPF((DBG_MESSAGE, 
-					"Perp plane off device - ignoring it: d:%f  N:[%f,%f,%f]", 
-					pPlane->d, pPlane->normal[0], 
-					pPlane->normal[1], pPlane->normal[2] ));
+				    SGL_TIME_SUSPEND(PROJECTION_TIME)
 
-				/*
-				// ignore this plane, but continue with the others
-				*/
-				continue;
-			}/*end special rejection cases for perp planes*/
-			
-			
-			/*
-			// Note that we negate here, because the hardware states
-			// and object is inside when the function > 0, while we
-			// are inside the object when N.X < 0...
-			*/
-#if (PCX2 || PCX2_003) && !FORCE_NO_FPU
-			maxValue = -fOverflowRescale;
+					pPlane->n32A = PackTo20Bit(pPlane->normal[0] * xPerPixel * maxValue);
+					pPlane->n32B = PackTo20Bit(pPlane->normal[1] * yPerPixel * maxValue);
 
-			/* PCX2 hardware performs scaling when planes are perpendicular.
-			 */
-			pPlane->f32A = (pPlane->normal[0] * xPerPixel * maxValue);
-			pPlane->f32B = (pPlane->normal[1] * yPerPixel * maxValue);
-			pPlane->f32C = ((middle - (XBorder + YBorder)) * maxValue);
-#else
-			/*
-			// Generate a scaling value based on the max Value. Effectively
-			// we want to divide through by the ABSOLUTE  max value so that
-			//  we don't exceed the limits of the fixed point hardware. 
-			*/
-			maxValue = sfabs(middle) + MaxBorder;
-			maxValue = -fOverflowRescale * ApproxRecip(maxValue);
+				    SGL_TIME_RESUME(PROJECTION_TIME)
 
-		    SGL_TIME_SUSPEND(PROJECTION_TIME)
+					pPlane->n32C = (sgl_int32)((middle - (XBorder + YBorder))*maxValue*FLOAT_TO_FIXED);
+	#endif
 
-			pPlane->n32A = PackTo20Bit(pPlane->normal[0] * xPerPixel * maxValue);
-			pPlane->n32B = PackTo20Bit(pPlane->normal[1] * yPerPixel * maxValue);
 
-		    SGL_TIME_RESUME(PROJECTION_TIME)
+			 		/*
+					// add it to the perpendicular plane list
+					*/
+					PlaneLists->PEPlanes[PlaneLists->NumPE] = pPlane;
+					PlaneLists->NumPE ++;
 
-			pPlane->n32C = (sgl_int32)((middle - (XBorder + YBorder))*maxValue*FLOAT_TO_FIXED);
-#endif
+				} /*if then else*/
 
+				break;
 
-	 		/*
-			// add it to the perpendicular plane list
-			*/
-			PlaneLists->PEPlanes[PlaneLists->NumPE] = pPlane;
-			PlaneLists->NumPE ++;
+			}/*end switch (category)*/
 
-		} /*if then else*/
+		}/* END FOR storing the group*/
 
 	}/* END FOR stepping through planes*/
 
@@ -1202,6 +1286,21 @@ static sgl_bool RnProjectAndClassifyPlanes(const int NumPlanesToDo,
 } /* RnProjectAndClassifyPlanes */
 
 
+/**************************************************************************
+* Function Name  : RnConvexOnSglInitialise
+* Inputs         : None
+* Outputs        : None
+* Returns        : None
+* Global Used    : gpfnConvProj, gnConvProjLanes
+*
+* Description    : Picks the plane projection kernel for this CPU.
+**************************************************************************/
+void RnConvexOnSglInitialise(void)
+{
+	gnConvProjLanes = ConvProjSelect(&gpfnConvProj);
+}
+
+
 /**************************************************************************
 * Function Name  : RnProjectAndClassifyMaterialsPlanes (LOCAL FUNCTION)
 * Inputs         : Convex object, 
@@ -61,6 +61,8 @@ extern sgl_bool RnProcessLightOrShadVolume(const CONVEX_NODE_STRUCT  *pConvex,
 								TRANS_PLANE_ARRAY_TYPE transformedPlanes, 
 								const BBOX_MINMAX_STRUCT *pBBox);
 
+extern void RnConvexOnSglInitialise(void);
+
 
 
 /*
@@ -0,0 +1,218 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rncsimd.c,v $
+Title           :   Vector convex plane projection
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   SSE2 and AVX2 versions of the projection and
+					classification rnconvpr.c does on the planes of a
+					convex object. See rncsimd.h.
+
+					The kernel body is in rnckern.h and is built once per
+					instruction set, the same way as the mesh kernels in
+					rnmsimd.c.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rncsimd.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_RNCSIMD
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "pvrosapi.h"
+#include "rncsimd.h"
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+	#define CONVPROJ_GCC_X86	1
+#else
+	#define CONVPROJ_GCC_X86	0
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define CONVPROJ_SSE2		1
+	#define CONVPROJ_HAS_SSE2	TRUE
+#elif CONVPROJ_GCC_X86
+	#define CONVPROJ_SSE2		1
+	#define CONVPROJ_HAS_SSE2	__builtin_cpu_supports ("sse2")
+#else
+	#define CONVPROJ_SSE2		0
+#endif
+
+#if defined (__AVX2__)
+	#define CONVPROJ_AVX2		1
+	#define CONVPROJ_HAS_AVX2	TRUE
+#elif CONVPROJ_GCC_X86
+	#define CONVPROJ_AVX2		1
+	#define CONVPROJ_HAS_AVX2	__builtin_cpu_supports ("avx2")
+#else
+	#define CONVPROJ_AVX2		0
+#endif
+
+/*
+// ============================================================================
+// 								SSE2 (4 LANES)
+// ============================================================================
+*/
+
+#if CONVPROJ_SSE2
+
+#include <emmintrin.h>
+
+#if defined (__SSE2__) || !CONVPROJ_GCC_X86
+	#define CONVPROJ_TARGET
+#else
+	#define CONVPROJ_TARGET	__attribute__ ((target ("sse2")))
+#endif
+
+#define CONVPROJ_KERNEL	ConvProjSSE2
+
+#define VF				__m128
+#define VI				__m128i
+
+#define VF_SET1(x)		_mm_set1_ps (x)
+#define VF_LOAD(p)		_mm_loadu_ps (p)
+#define VF_STORE(p,a)	_mm_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm_add_ps ((a), (b))
+#define VF_SUB(a,b)		_mm_sub_ps ((a), (b))
+#define VF_MUL(a,b)		_mm_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm_div_ps ((a), (b))
+#define VF_ABS(a)		_mm_andnot_ps (_mm_set1_ps (-0.0f), (a))
+#define VF_LT(a,b)		_mm_cmplt_ps ((a), (b))
+#define VF_SEL(m,a,b)	_mm_or_ps (_mm_and_ps ((m), (a)), _mm_andnot_ps ((m), (b)))
+#define VF_TOI(a)		_mm_cvttps_epi32 (a)
+#define VF_TO_VI(a)		_mm_castps_si128 (a)
+
+#define VI_SET1(x)		_mm_set1_epi32 (x)
+#define VI_LOAD(p)		_mm_loadu_si128 ((const __m128i *) (p))
+#define VI_STORE(p,a)	_mm_storeu_si128 ((__m128i *) (p), (a))
+#define VI_AND(a,b)		_mm_and_si128 ((a), (b))
+#define VI_OR(a,b)		_mm_or_si128 ((a), (b))
+#define VI_SEL(m,a,b)	_mm_or_si128 (_mm_and_si128 ((m), (a)), _mm_andnot_si128 ((m), (b)))
+
+#include "rnckern.h"
+
+#undef CONVPROJ_TARGET
+#undef CONVPROJ_KERNEL
+#undef VF
+#undef VI
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_ABS
+#undef VF_LT
+#undef VF_SEL
+#undef VF_TOI
+#undef VF_TO_VI
+#undef VI_SET1
+#undef VI_LOAD
+#undef VI_STORE
+#undef VI_AND
+#undef VI_OR
+#undef VI_SEL
+
+#endif /* CONVPROJ_SSE2 */
+
+/*
+// ============================================================================
+// 								AVX2 (8 LANES)
+// ============================================================================
+*/
+
+#if CONVPROJ_AVX2
+
+#include <immintrin.h>
+
+#if defined (__AVX2__) || !CONVPROJ_GCC_X86
+	#define CONVPROJ_TARGET
+#else
+	#define CONVPROJ_TARGET	__attribute__ ((target ("avx2")))
+#endif
+
+#define CONVPROJ_KERNEL	ConvProjAVX2
+
+#define VF				__m256
+#define VI				__m256i
+
+#define VF_SET1(x)		_mm256_set1_ps (x)
+#define VF_LOAD(p)		_mm256_loadu_ps (p)
+#define VF_STORE(p,a)	_mm256_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm256_add_ps ((a), (b))
+#define VF_SUB(a,b)		_mm256_sub_ps ((a), (b))
+#define VF_MUL(a,b)		_mm256_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm256_div_ps ((a), (b))
+#define VF_ABS(a)		_mm256_andnot_ps (_mm256_set1_ps (-0.0f), (a))
+#define VF_LT(a,b)		_mm256_cmp_ps ((a), (b), _CMP_LT_OS)
+#define VF_SEL(m,a,b)	_mm256_blendv_ps ((b), (a), (m))
+#define VF_TOI(a)		_mm256_cvttps_epi32 (a)
+#define VF_TO_VI(a)		_mm256_castps_si256 (a)
+
+#define VI_SET1(x)		_mm256_set1_epi32 (x)
+#define VI_LOAD(p)		_mm256_loadu_si256 ((const __m256i *) (p))
+#define VI_STORE(p,a)	_mm256_storeu_si256 ((__m256i *) (p), (a))
+#define VI_AND(a,b)		_mm256_and_si256 ((a), (b))
+#define VI_OR(a,b)		_mm256_or_si256 ((a), (b))
+#define VI_SEL(m,a,b)	_mm256_blendv_epi8 ((b), (a), (m))
+
+#include "rnckern.h"
+
+#endif /* CONVPROJ_AVX2 */
+
+/*
+// ============================================================================
+// 								DISPATCH
+// ============================================================================
+*/
+
+int ConvProjSelect (CONVPROJFN *ppfnProject)
+{
+	int nMaxLanes;
+
+	nMaxLanes = SglReadPrivateProfileInt ("Convex", "SimdLanes",
+										  CONVPROJ_MAX_LANES, "sgl.ini");
+
+	*ppfnProject = NULL;
+
+	#if CONVPROJ_GCC_X86
+		__builtin_cpu_init ();
+	#endif
+
+	#if CONVPROJ_AVX2
+
+		if ((nMaxLanes >= 8) && CONVPROJ_HAS_AVX2)
+		{
+			*ppfnProject = ConvProjAVX2;
+			return (8);
+		}
+
+	#endif
+
+	#if CONVPROJ_SSE2
+
+		if ((nMaxLanes >= 4) && CONVPROJ_HAS_SSE2)
+		{
+			*ppfnProject = ConvProjSSE2;
+			return (4);
+		}
+
+	#endif
+
+	return (1);
+}
+
+/* rncsimd.c */
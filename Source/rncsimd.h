@@ -0,0 +1,107 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rncsimd.h,v $
+Title           :   RNCSIMD.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Vector projection and classification of the transformed
+					planes of a convex object (see RnProjectAndClassifyPlanes
+					in rnconvpr.c). A kernel takes a group of planes in
+					structure of arrays form, works out A, B and C for the
+					ones that are safe to project and says which category
+					list each plane goes on, in the same order as the one
+					at a time code, so the results match it.
+
+					The widest kernel the CPU can run is picked at run time.
+					Builds whose compiler has no SSE2 have none, and use the
+					one at a time version in rnconvpr.c.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rncsimd.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __RNCSIMD_H__
+#define __RNCSIMD_H__
+
+/* Widest group any kernel handles */
+#define CONVPROJ_MAX_LANES	8
+
+/*
+// The category lists of PLANE_CATEGORIES_STRUCT a plane goes on. Planes
+// that aren't safe to project might be perpendicular, or off screen,
+// which the caller works out one at a time.
+*/
+#define CONVPROJ_FV			0
+#define CONVPROJ_FI			1
+#define CONVPROJ_RV			2
+#define CONVPROJ_RI			3
+#define CONVPROJ_TRICKY		4
+
+/*
+// The projection matrix values the kernels use, gathered once per call
+*/
+typedef struct tagCONVPROJCONTEXT
+{
+	float	RCentre[3];
+	float	xToCorner, yToCorner;
+	float	xPerPixel, yPerPixel;
+	float	fOverflowRescale;
+	float	fFixedScale;		/* FLOAT_TO_FIXED */
+
+} CONVPROJCONTEXT;
+
+/*
+// One group of planes. The caller fills in the normals, d values and
+// whether each plane is invisible (0 or 1); a kernel fills in the rest for
+// as many lanes as it handles, starting at nFirst.
+// A and B are before packing. C is in fC, and in nC as the fixed point
+// value the packed parameters want. Only lanes in the safe categories
+// have meaningful A, B and C.
+*/
+typedef struct tagCONVPROJLANES
+{
+	float		fNormal[3][CONVPROJ_MAX_LANES];
+	float		fD[CONVPROJ_MAX_LANES];
+	int			nInvisible[CONVPROJ_MAX_LANES];
+
+	float		fA[CONVPROJ_MAX_LANES];
+	float		fB[CONVPROJ_MAX_LANES];
+	float		fC[CONVPROJ_MAX_LANES];
+	sgl_int32	nC[CONVPROJ_MAX_LANES];
+	int			nCategory[CONVPROJ_MAX_LANES];
+
+} CONVPROJLANES;
+
+typedef void (* CONVPROJFN)(CONVPROJLANES *pLanes, int nFirst,
+							const CONVPROJCONTEXT *pCtx);
+
+/*===========================================
+ * Function:	ConvProjSelect
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Picks the widest kernel the CPU supports, unless the
+ *				[Convex] SimdLanes entry in sgl.ini asks for a narrower
+ *				one (1 turns the kernels off).
+ *
+ * Params:		CONVPROJFN *ppfnProject: receives the kernel, or NULL
+ *
+ * Return:		Lanes the kernel handles per call, or 1 if there is none.
+ *========================================================================================*/
+int ConvProjSelect (CONVPROJFN *ppfnProject);
+
+#endif /* __RNCSIMD_H__ */
+
+/*------------------------------- End of File -------------------------------*/
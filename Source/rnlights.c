@@ -153,9 +153,162 @@
 #include "rntrav.h"
 #include "rnglobal.h"
 #include "rnlights.h"
+#include "sglmem.h"
+#include "profile.h"
 
 
 
+/**************************************************************************
+ * Function Name  : FillParLightEntry
+ * Inputs         : plightNode,ptransform
+					  
+ * Outputs        : pCurrEntry
+ * Input/Output	  : plightState
+						  
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Fills in a light entry for a parallel light, leaving
+ *					the shadow and slot fields to the caller.
+ *				   
+ **************************************************************************/
+
+static void FillParLightEntry(LIGHT_ENTRY_STRUCT * pCurrEntry,
+							  const LIGHT_NODE_STRUCT * plightNode,
+							  const TRANSFORM_STRUCT * ptransform,
+							  LIGHTS_STATE_STRUCT	* plightState)
+{
+	/* 
+	// set light flags, both light and highlights are being set. 
+	// Note: highlights_on is only relevent if smooth_highlights bit is set 
+	// also, shadow part of flags has become redundant 
+	*/
+	pCurrEntry->light_flags = plightNode->flags | light_on | highlights_on; 
+	pCurrEntry->light_name	= plightNode->node_hdr.n32_name;
+	pCurrEntry->range		= 0.0f;
+
+
+	/* have to transform direction vector */
+
+	TransformDirVector( ptransform, plightNode->direction, 
+						pCurrEntry->direction);
+
+	/* direction vector must be normalised */
+					
+	if(ptransform->scale_flag==uniform_scale)
+	{
+   		pCurrEntry->direction[0]*=ptransform->rescale;
+	   	pCurrEntry->direction[1]*=ptransform->rescale;
+	   	pCurrEntry->direction[2]*=ptransform->rescale;
+	}
+	else if(ptransform->scale_flag==arbitrary_scale)
+	{
+		VecNormalise(pCurrEntry->direction);
+	} /* else if no_scale we dont have to do anything */
+
+
+   	if (plightNode->flags & coloured)
+   	{
+		/* I am assuming that the earl grey flag is set as default */
+
+		plightState->flags &= ~lsf_earl_grey; /* clear earl_grey flag */ 
+
+	   	pCurrEntry->colour[0]=plightNode->colour[0];
+	  	pCurrEntry->colour[1]=plightNode->colour[1];
+	   	pCurrEntry->colour[2]=plightNode->colour[2];
+   	}
+	else
+		pCurrEntry->colour[0]=plightNode->colour[0];
+
+
+	/* 
+	// must negate dir vector for the lighting calc 
+	// We do this as it makes the shading slightly cheaper
+	*/
+	VecNegate(pCurrEntry->direction);
+}
+
+
+/**************************************************************************
+ * Function Name  : FillPointLightEntry
+ * Inputs         : plightNode,ptransform
+					  
+ * Outputs        : pCurrEntry
+ * Input/Output	  : plightState
+						  
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Fills in a light entry for a point light, leaving the
+ *					shadow and slot fields to the caller.
+ *				   
+ **************************************************************************/
+
+static void FillPointLightEntry(LIGHT_ENTRY_STRUCT * pCurrEntry,
+								const LIGHT_NODE_STRUCT * plightNode,
+								const TRANSFORM_STRUCT * ptransform,
+								LIGHTS_STATE_STRUCT	* plightState)
+{
+	/* 
+	// set light flags, both light and highlights are being set. 
+	// Note: highlights_on is only relevent if smooth_highlights bit is set 
+	// also, shadow part of flags has become redundant
+	*/
+
+	pCurrEntry->light_flags = plightNode->flags | light_on | highlights_on; 
+	pCurrEntry->light_name	= plightNode->node_hdr.n32_name;
+
+	plightState->flags|=lsf_has_point_light;
+
+
+	/* have to transform both position and direction vector */
+
+	TransformDirVector( ptransform, plightNode->direction, 
+						pCurrEntry->direction);
+
+
+	/* direction vector must be normalised */
+
+	if(ptransform->scale_flag==uniform_scale)
+	{
+	   	pCurrEntry->direction[0]*= ptransform->rescale;
+		pCurrEntry->direction[1]*= ptransform->rescale;
+	  	pCurrEntry->direction[2]*= ptransform->rescale;
+	}
+	else if(ptransform->scale_flag==arbitrary_scale)
+	{
+	   	VecNormalise(pCurrEntry->direction);
+
+	} /* else if no_scale we dont have to do anything */
+
+
+ 	TransformVector( ptransform, plightNode->position,
+					 pCurrEntry->position);
+
+   	if (plightNode->flags & coloured)
+   	{
+		/* I am assuming that the earl grey flag is set as default */
+
+		plightState->flags &= ~lsf_earl_grey; /* clear earl_grey flag */ 
+
+	   	pCurrEntry->colour[0]= plightNode->colour[0];
+	  	pCurrEntry->colour[1]= plightNode->colour[1];
+	   	pCurrEntry->colour[2]= plightNode->colour[2];
+   	}
+   	else
+		pCurrEntry->colour[0]=plightNode->colour[0];
+
+
+	pCurrEntry->concentration= plightNode->concentration;
+   	pCurrEntry->log2concentration=plightNode->log2concentration;
+	pCurrEntry->range = plightNode->range;
+
+	/* 
+	// must negate dir vector for the lighting calc 
+	// We do this as it makes the shading slightly cheaper
+	*/
+	VecNegate(pCurrEntry->direction);
+}
+
+
 /**************************************************************************
  * Function Name  : SetParLightData
  * Inputs         : lightNode,tranNode
@@ -229,54 +382,7 @@ static LIGHT_ENTRY_STRUCT * SetParLightData( const LIGHT_NODE_STRUCT * plightNod
 	plightState->numOnParLights ++;
 	
 
-	/* 
-	// set light flags, both light and highlights are being set. 
-	// Note: highlights_on is only relevent if smooth_highlights bit is set 
-	// also, shadow part of flags has become redundant 
-	*/
-	pCurrEntry->light_flags = plightNode->flags | light_on | highlights_on; 
-	pCurrEntry->light_name	= plightNode->node_hdr.n16_name;
-
-
-
-	/* have to transform direction vector */
-
-	TransformDirVector( ptransform, plightNode->direction, 
-						pCurrEntry->direction);
-
-	/* direction vector must be normalised */
-					
-	if(ptransform->scale_flag==uniform_scale)
-	{
-   		pCurrEntry->direction[0]*=ptransform->rescale;
-	   	pCurrEntry->direction[1]*=ptransform->rescale;
-	   	pCurrEntry->direction[2]*=ptransform->rescale;
-	}
-	else if(ptransform->scale_flag==arbitrary_scale)
-	{
-		VecNormalise(pCurrEntry->direction);
-	} /* else if no_scale we dont have to do anything */
-
-
-   	if (plightNode->flags & coloured)
-   	{
-		/* I am assuming that the earl grey flag is set as default */
-
-		plightState->flags &= ~lsf_earl_grey; /* clear earl_grey flag */ 
-
-	   	pCurrEntry->colour[0]=plightNode->colour[0];
-	  	pCurrEntry->colour[1]=plightNode->colour[1];
-	   	pCurrEntry->colour[2]=plightNode->colour[2];
-   	}
-	else
-		pCurrEntry->colour[0]=plightNode->colour[0];
-
-
-	/* 
-	// must negate dir vector for the lighting calc 
-	// We do this as it makes the shading slightly cheaper
-	*/
-	VecNegate(pCurrEntry->direction);
+	FillParLightEntry(pCurrEntry, plightNode, ptransform, plightState);
 
 	/*
 	// Return the pointer to the entry
@@ -343,283 +449,1152 @@ static LIGHT_ENTRY_STRUCT * SetPointLightData(const LIGHT_NODE_STRUCT	*plightNod
 	plightState->numOnPntLights ++;
 
 
-	/* 
-	// set light flags, both light and highlights are being set. 
-	// Note: highlights_on is only relevent if smooth_highlights bit is set 
-	// also, shadow part of flags has become redundant
+	FillPointLightEntry(pCurrEntry, plightNode, ptransform, plightState);
+
+	/*
+	// Return the pointer to the entry
 	*/
+	return (pCurrEntry);
+}
 
-	pCurrEntry->light_flags = plightNode->flags | light_on | highlights_on; 
-	pCurrEntry->light_name	= plightNode->node_hdr.n16_name;
 
-	plightState->flags|=lsf_has_point_light;
 
 
-	/* have to transform both position and direction vector */
 
-	TransformDirVector( ptransform, plightNode->direction, 
-						pCurrEntry->direction);
+/**************************************************************************
+ * Function Name  : CalcAverageCol
+ * Inputs         : 
+					  
+ * Outputs        :  
+ * Input/Output	  : lightState
+						  
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Calculates average light colour for light slot 
+					zero, plus the smooth shading intensity values 
+ *					
+ *				   
+ **************************************************************************/
 
 
-	/* direction vector must be normalised */
+void	CalcAverageCol(LIGHTS_STATE_STRUCT	* lightState)
+{
+	int	curEntry;
+	int numOnLights[NUM_LIGHT_SLOTS];
+	sgl_vector	SummedCol[NUM_LIGHT_SLOTS];
+	float fRescale[NUM_LIGHT_SLOTS];
+	float SummedBrightness[NUM_LIGHT_SLOTS];
+	int nSlot;
+	float i;
 
-	if(ptransform->scale_flag==uniform_scale)
+	/* init the average light colours */
+
+	numOnLights[0] = 1;
+
+	if (lightState->flags & lsf_ambient_grey)
 	{
-	   	pCurrEntry->direction[0]*= ptransform->rescale;
-		pCurrEntry->direction[1]*= ptransform->rescale;
-	  	pCurrEntry->direction[2]*= ptransform->rescale;
+		i = lightState->ambient_colour[0];
+	
+		SummedCol[0][0] = i;
+		SummedCol[0][1] = i;
+		SummedCol[0][2] = i;
+
+	  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
+		SummedBrightness[0] = ssqrt (3.0f * (i * i));
+	  #else
+		SummedBrightness[0] = (float)sqrt (3.0f * (i * i));
+	  #endif
 	}
-	else if(ptransform->scale_flag==arbitrary_scale)
+	else if ((lightState->ambient_colour[0] > 0.0f) ||
+			 (lightState->ambient_colour[1] > 0.0f) ||
+			 (lightState->ambient_colour[2] > 0.0f))
 	{
-	   	VecNormalise(pCurrEntry->direction);
+		SummedCol[0][0] = lightState->ambient_colour[0];
+		SummedCol[0][1] = lightState->ambient_colour[1];
+		SummedCol[0][2] = lightState->ambient_colour[2];
 
-	} /* else if no_scale we dont have to do anything */
+		SummedBrightness[0] = VecLength (lightState->ambient_colour);
+	}
+	else
+	{
+		numOnLights[0] = 0;
 
+		SummedCol[0][0] = 0.0f;
+		SummedCol[0][1] = 0.0f;
+		SummedCol[0][2] = 0.0f;
 
- 	TransformVector( ptransform, plightNode->position,
-					 pCurrEntry->position);
+		SummedBrightness[0] = 0.0f;
+	}
 
-   	if (plightNode->flags & coloured)
-   	{
-		/* I am assuming that the earl grey flag is set as default */
+	for (nSlot = 1; nSlot < NUM_LIGHT_SLOTS; ++nSlot)
+	{
+		SummedCol[nSlot][0] = 0.0f;
+		SummedCol[nSlot][1] = 0.0f;
+		SummedCol[nSlot][2] = 0.0f;
+		
+		SummedBrightness[nSlot] = 0.0f;
 
-		plightState->flags &= ~lsf_earl_grey; /* clear earl_grey flag */ 
+		numOnLights[nSlot] = 0;
+	}
 
-	   	pCurrEntry->colour[0]= plightNode->colour[0];
-	  	pCurrEntry->colour[1]= plightNode->colour[1];
-	   	pCurrEntry->colour[2]= plightNode->colour[2];
-   	}
-   	else
-		pCurrEntry->colour[0]=plightNode->colour[0];
+	/* step through all the lights currently in the light entry table */
 
+	for (curEntry = 0; curEntry < (lightState->num_lights); curEntry++)
+	{
+		/* only add components of lights that are switched on */
 
-	pCurrEntry->concentration= plightNode->concentration;
-   	pCurrEntry->log2concentration=plightNode->log2concentration;
+		if (lightState->light_entries[curEntry].light_flags & light_on)
+		{
+			nSlot = lightState->light_entries[curEntry].light_colour_slot;
 
-	/* 
-	// must negate dir vector for the lighting calc 
-	// We do this as it makes the shading slightly cheaper
+			ASSERT (nSlot >= 0);			
+			ASSERT (nSlot <= NUM_LIGHT_SLOTS);			
+
+			if (lightState->light_entries[curEntry].light_flags & coloured)
+			{
+				SummedCol[nSlot][0] += lightState->light_entries[curEntry].colour[0];
+				SummedCol[nSlot][1] += lightState->light_entries[curEntry].colour[1];
+				SummedCol[nSlot][2] += lightState->light_entries[curEntry].colour[2];
+
+				SummedBrightness[nSlot] += VecLength (lightState->light_entries[curEntry].colour);
+			}
+			else
+			{
+				i = lightState->light_entries[curEntry].colour[0];
+
+				SummedCol[nSlot][0] += i;
+				SummedCol[nSlot][1] += i;
+				SummedCol[nSlot][2] += i;
+
+			  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
+				SummedBrightness[nSlot] += ssqrt (3.0f * (i * i));
+			  #else
+				SummedBrightness[nSlot] += (float)sqrt (3.0f * (i * i));
+			  #endif
+			}
+
+			numOnLights[nSlot]++;
+		}
+	}
+
+	/* calculate the average colours */
+	
+	for (nSlot = 0; nSlot < NUM_LIGHT_SLOTS; ++nSlot)
+	{
+		if (numOnLights[nSlot])
+		{
+			SummedBrightness[nSlot] = 1.0f / SummedBrightness[nSlot];
+			
+			#if 1
+
+			if (SummedCol[nSlot][0] > 1.0f || SummedCol[nSlot][1] > 1.0f || SummedCol[nSlot][2] > 1.0f)
+			{
+				float fMax = SummedCol[nSlot][0];
+				float f1overMax;
+
+				CHOOSE_MAX (fMax, SummedCol[nSlot][1]);
+				CHOOSE_MAX (fMax, SummedCol[nSlot][2]);
+
+				fRescale[nSlot] = fMax;
+				f1overMax = 1.0f / fMax;
+
+				SummedCol[nSlot][0] *= f1overMax; 
+				SummedCol[nSlot][1] *= f1overMax; 
+				SummedCol[nSlot][2] *= f1overMax; 
+			}
+			else
+			{
+				fRescale[nSlot] = 1.0f;
+			}
+
+			#else
+
+			fRescale[nSlot] = 1.0f;
+
+			#endif
+
+			lightState->light_slots[nSlot].colour[0] = SummedCol[nSlot][0];
+			lightState->light_slots[nSlot].colour[1] = SummedCol[nSlot][1];
+			lightState->light_slots[nSlot].colour[2] = SummedCol[nSlot][2];
+
+			if (nSlot == 0)	
+			{
+				float fAmbientVecLength;
+
+				if (lightState->flags & lsf_ambient_grey)
+				{
+				  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
+					fAmbientVecLength = ssqrt (3.0f * (lightState->ambient_colour[0] * lightState->ambient_colour[0]));
+				  #else
+					fAmbientVecLength = (float)sqrt (3.0f * (lightState->ambient_colour[0] * lightState->ambient_colour[0]));
+				  #endif
+				}
+				else
+				{
+					fAmbientVecLength = VecLength (lightState->ambient_colour);
+				}
+
+				lightState->ambient_smooth_intensity = fAmbientVecLength * SummedBrightness[nSlot] * fRescale[nSlot];
+			}
+		}
+	}
+
+	/* find largest dot product */
+
+	for (curEntry = 0; curEntry < lightState->num_lights; curEntry++)
+	{
+		/* only interested in lights that are switched on */
+
+		if (lightState->light_entries[curEntry].light_flags & light_on)
+		{
+			float fVecLength;
+
+			nSlot = lightState->light_entries[curEntry].light_colour_slot;
+	
+			if (lightState->light_entries[curEntry].light_flags & coloured)
+			{
+				fVecLength = VecLength (lightState->light_entries[curEntry].colour);
+			}
+			else
+			{
+				fVecLength = (float)sqrt (3.0f * (lightState->light_entries[curEntry].colour[0] * 
+										lightState->light_entries[curEntry].colour[0]));
+			}
+
+			lightState->light_entries[curEntry].smooth_intensity = fVecLength * SummedBrightness[nSlot] * fRescale[nSlot];   
+		}
+	}
+
+	/* clear dirty flag bit. Is now nice and clean */
+   	lightState->flags &= ~lsf_dirty_smooth;
+}	
+
+
+
+/*
+// ------------------
+// THE LIGHT MANAGER
+// ------------------
+// The light state only has room for SGL_MAX_ACTIVE_LIGHTS lights, and that
+// is all the shading code ever looks at. Parallel and point lights that
+// turn up once it is full go into the light manager's pool, and before an
+// object is shaded the lights that matter most to it are picked from both
+// and put in a light state of its own (see RnSelectObjectLights).
+//
+// The pool works like the light state stack. A light state only records
+// how many pool lights were in scope when it was made (num_pool_lights),
+// so lights added inside a list that has since been left get written over
+// by the next ones. Switching a pool light on or off puts a changed copy
+// on top, rather than altering the original that lights further out still
+// see.
+//
+// Point lights given a range go in a grid, so that an object only looks at
+// the ones that reach it. The rest (parallel lights, and point lights with
+// no range) are looked at for every object. The grid is built when it is
+// first needed after the pool changes, which is once a frame when the
+// lights come before the objects.
+*/
+typedef struct
+{
+	LIGHT_ENTRY_STRUCT	Entry;
+
+	/*
+	// The pool light this is a switched copy of, and the last switched
+	// copy made of this one, or -1. Either may have been written over
+	// since, so they are only believed if they agree.
 	*/
-	VecNegate(pCurrEntry->direction);
+	int nReplaces;
+	int nReplacedBy;
+
+} POOL_LIGHT_STRUCT;
+
+static POOL_LIGHT_STRUCT	*pPoolLights = NULL;
+static int					nPoolAlloc = 0;
+
+/*
+// Most pool lights used so far this frame, and a count of all the lights
+// added, which says when the grid is out of date.
+*/
+static int					nPoolTop = 0;
+static sgl_uint32			u32PoolChanges = 0;
+
+/*
+// The grid. Cell c's lights are pnCellLights[pnCellStart[c]] up to
+// pnCellLights[pnCellStart[c + 1]]. nGridCells is 0 if no light has a
+// range, and bGridOK is FALSE if there wasn't the memory for it, in which
+// case all the pool lights are looked at.
+*/
+#define LIGHT_GRID_MAX_CELLS	16		/* per axis */
+
+static sgl_uint32	u32GridChanges = 0;
+static sgl_bool		bGridOK = FALSE;
+
+static int			nGridCells[3];
+static float		fGridMin[3], fGridScale[3];
+
+static int			*pnCellStart = NULL;
+static int			nCellStartAlloc = 0;
+static int			*pnCellLights = NULL;
+static int			nCellLightsAlloc = 0;
+
+static int			*pnUnbounded = NULL;
+static int			nUnbounded = 0;
+
+/*
+// Which query last saw each pool light, as a light can be in many cells
+*/
+static sgl_uint32	*pu32Visited = NULL;
+static sgl_uint32	u32Visit = 0;
+static int			nPerLightAlloc = 0;
+
+/*
+// Most lights an object is shaded with, from [Lights] PerObject in
+// sgl.ini. Lights that cast shadows are always kept, whatever this is.
+*/
+static int nLightsPerObject = -1;
+
+/*
+// The light state handed to the shading code. Objects are processed one
+// at a time, so one will do.
+*/
+static LIGHTS_STATE_STRUCT SelectedLights;
+
+
+/*
+// The lights chosen for an object so far, brightest first
+*/
+typedef struct
+{
+	const BBOX_MINMAX_STRUCT *pBox;		/* NULL if the object is unbounded */
+	int		nScope;						/* pool lights in scope */
+
+	int		nWanted;
+	int		nChosen;
+	float	fScore[SGL_MAX_ACTIVE_LIGHTS];
+	const LIGHT_ENTRY_STRUCT *pChosen[SGL_MAX_ACTIVE_LIGHTS];
+
+} LIGHT_CHOICE_STRUCT;
+
+
+/**************************************************************************
+ * Function Name  : RnResetLightPool
+ * Inputs         :
+ * Outputs        :
+ * Input/Output	  :
+ * Returns        :
+ * Global Used    : the light pool
+ * Description    : Empties the light pool at the start of a frame.
+ *
+ **************************************************************************/
+
+void RnResetLightPool(void)
+{
+	nPoolTop = 0;
+	u32PoolChanges++;
+}
+
+
+/**************************************************************************
+ * Function Name  : AddPoolLight
+ * Inputs         :
+ * Outputs        :
+ * Input/Output	  : plightState
+ *
+ * Returns        : pointer to the new pool light, or NULL if there was no
+ *					memory for it
+ * Global Used    : the light pool
+ * Description    : Puts a new light on top of the pool lights in scope.
+ *					The pool may move, so pointers into it aren't kept
+ *					across calls.
+ *
+ **************************************************************************/
+
+static POOL_LIGHT_STRUCT * AddPoolLight(LIGHTS_STATE_STRUCT * plightState)
+{
+	POOL_LIGHT_STRUCT *pLight;
+	int nLight = plightState->num_pool_lights;
+
+	if (nLight >= nPoolAlloc)
+	{
+		int nNewAlloc = (nPoolAlloc == 0) ? 64 : (nPoolAlloc * 2);
+
+		if (pPoolLights == NULL)
+		{
+			pLight = SGLMalloc (nNewAlloc * sizeof(POOL_LIGHT_STRUCT));
+		}
+		else
+		{
+			pLight = SGLRealloc (pPoolLights,
+								 nNewAlloc * sizeof(POOL_LIGHT_STRUCT));
+		}
+
+		if (pLight == NULL)
+		{
+			DPF((DBG_WARNING, "No memory for more lights"));
+			return (NULL);
+		}
+
+		pPoolLights = pLight;
+		nPoolAlloc = nNewAlloc;
+	}
+
+	pLight = &pPoolLights[nLight];
+
+	pLight->nReplaces = -1;
+	pLight->nReplacedBy = -1;
+
+	plightState->num_pool_lights ++;
+
+	if (nPoolTop < plightState->num_pool_lights)
+	{
+		nPoolTop = plightState->num_pool_lights;
+	}
+
+	u32PoolChanges++;
+
+	return (pLight);
+}
+
+
+/**************************************************************************
+ * Function Name  : SwitchPoolLight
+ * Inputs         : switchNode
+ * Outputs        :
+ * Input/Output	  : plightState
+ *
+ * Returns        :
+ * Global Used    : the light pool
+ * Description    : Switches a pool light on or off. Shadows can't be
+ *					switched on for pool lights, as they never have a
+ *					shadow slot.
+ *
+ **************************************************************************/
+
+static void SwitchPoolLight(const LIGHT_SWITCH_NODE_STRUCT * switchNode,
+							LIGHTS_STATE_STRUCT * plightState)
+{
+	POOL_LIGHT_STRUCT *pNew;
+	int nLight, switchOn;
+
+	/*
+	// The newest light with the name is the one in use, as any switched
+	// copy of it would be newer
+	*/
+	for (nLight = plightState->num_pool_lights - 1; nLight >= 0; nLight--)
+	{
+		if (pPoolLights[nLight].Entry.light_name == switchNode->light_name)
+		{
+			break;
+		}
+	}
+
+	if (nLight < 0)
+	{
+		return;
+	}
+
+	switchOn = switchNode->light_switches & switch_light_on;
+
+	if ((!switchOn) == !(pPoolLights[nLight].Entry.light_flags & light_on))
+	{
+		return;
+	}
+
+	pNew = AddPoolLight(plightState);
+
+	if (pNew != NULL)
+	{
+		pNew->Entry = pPoolLights[nLight].Entry;
+		pNew->nReplaces = nLight;
+
+		pPoolLights[nLight].nReplacedBy = plightState->num_pool_lights - 1;
+
+		if (switchOn)
+		{
+			pNew->Entry.light_flags |= light_on;
+		}
+		else
+		{
+			pNew->Entry.light_flags &= ~light_on;
+		}
+	}
+}
+
+
+/**************************************************************************
+ * Function Name  : LightCellRange
+ * Inputs         : fLo, fHi - corners of a box
+ * Outputs        : nLo, nHi - the grid cells it covers on each axis
+ * Input/Output	  :
+ * Returns        : FALSE if the box misses the grid
+ * Global Used    : the grid
+ * Description    :
+ **************************************************************************/
+
+static sgl_bool LightCellRange(const float fLo[3], const float fHi[3],
+							   int nLo[3], int nHi[3])
+{
+	int k;
+
+	for (k = 0; k < 3; k++)
+	{
+		float fCellLo = (fLo[k] - fGridMin[k]) * fGridScale[k];
+		float fCellHi = (fHi[k] - fGridMin[k]) * fGridScale[k];
+
+		if ((fCellHi < 0.0f) || (fCellLo >= (float) nGridCells[k]))
+		{
+			return (FALSE);
+		}
+
+		nLo[k] = (fCellLo > 0.0f) ? (int) fCellLo : 0;
+		nHi[k] = (int) fCellHi;
+
+		if (nHi[k] >= nGridCells[k])
+		{
+			nHi[k] = nGridCells[k] - 1;
+		}
+	}
+
+	return (TRUE);
+}
+
+
+/**************************************************************************
+ * Function Name  : GrowInts
+ * Inputs         : nWanted
+ * Outputs        :
+ * Input/Output	  : ppnArray, pnAlloc
+ * Returns        : FALSE if there was no memory
+ * Global Used    :
+ * Description    : Makes sure an array of ints has room for nWanted.
+ **************************************************************************/
+
+static sgl_bool GrowInts(int **ppnArray, int *pnAlloc, int nWanted)
+{
+	int *pnNew;
+
+	if (nWanted <= *pnAlloc)
+	{
+		return (TRUE);
+	}
+
+	if (*ppnArray == NULL)
+	{
+		pnNew = SGLMalloc (nWanted * sizeof(int));
+	}
+	else
+	{
+		pnNew = SGLRealloc (*ppnArray, nWanted * sizeof(int));
+	}
+
+	if (pnNew == NULL)
+	{
+		return (FALSE);
+	}
+
+	*ppnArray = pnNew;
+	*pnAlloc = nWanted;
+
+	return (TRUE);
+}
+
+
+/**************************************************************************
+ * Function Name  : BuildLightGrid
+ * Inputs         :
+ * Outputs        :
+ * Input/Output	  :
+ * Returns        :
+ * Global Used    : the light pool and the grid
+ * Description    : Sorts the pool lights into those with a range, which go
+ *					in the grid, and those without. The grid covers all the
+ *					ranged lights, with cells about as big as a light's
+ *					reach.
+ **************************************************************************/
+
+static void BuildLightGrid(void)
+{
+	const POOL_LIGHT_STRUCT *pLight;
+	float	fMin[3], fMax[3], fRangeSum, fCellSize;
+	int		nLo[3], nHi[3];
+	int		nMaxCells, nRanged, nCells, nLight, x, y, z, k;
+
+	u32GridChanges = u32PoolChanges;
+	bGridOK = FALSE;
+	nGridCells[0] = nGridCells[1] = nGridCells[2] = 0;
+	nUnbounded = 0;
+
+	if (nPoolTop > nPerLightAlloc)
+	{
+		sgl_uint32 *pu32New;
+		int nAlloc = nPerLightAlloc;
+
+		if (!GrowInts(&pnUnbounded, &nAlloc, nPoolTop))
+		{
+			return;
+		}
+
+		if (pu32Visited == NULL)
+		{
+			pu32New = SGLMalloc (nPoolTop * sizeof(sgl_uint32));
+		}
+		else
+		{
+			pu32New = SGLRealloc (pu32Visited, nPoolTop * sizeof(sgl_uint32));
+		}
+
+		if (pu32New == NULL)
+		{
+			return;
+		}
+
+		for (nLight = 0; nLight < nPoolTop; nLight++)
+		{
+			pu32New[nLight] = 0;
+		}
+
+		pu32Visited = pu32New;
+		u32Visit = 0;
+		nPerLightAlloc = nPoolTop;
+	}
+
+	/*
+	// Find the extent of the ranged lights
+	*/
+	nRanged = 0;
+	fRangeSum = 0.0f;
+
+	for (nLight = 0, pLight = pPoolLights; nLight < nPoolTop; nLight++, pLight++)
+	{
+		const LIGHT_ENTRY_STRUCT *pEntry = &pLight->Entry;
+
+		if (((pEntry->light_flags & mask_light_types) != point_light_type) ||
+			(pEntry->range <= 0.0f))
+		{
+			pnUnbounded[nUnbounded++] = nLight;
+			continue;
+		}
+
+		for (k = 0; k < 3; k++)
+		{
+			float fLo = pEntry->position[k] - pEntry->range;
+			float fHi = pEntry->position[k] + pEntry->range;
+
+			if ((nRanged == 0) || (fLo < fMin[k]))
+			{
+				fMin[k] = fLo;
+			}
+			if ((nRanged == 0) || (fHi > fMax[k]))
+			{
+				fMax[k] = fHi;
+			}
+		}
+
+		fRangeSum += pEntry->range;
+		nRanged++;
+	}
+
+	if (nRanged == 0)
+	{
+		bGridOK = TRUE;
+		return;
+	}
+
+	/*
+	// Aim for cells as wide as an average light's reach, but no more
+	// cells than there are lights
+	*/
+	for (nMaxCells = 1;
+		 (nMaxCells < LIGHT_GRID_MAX_CELLS) &&
+		 ((nMaxCells * nMaxCells * nMaxCells) < nRanged);
+		 nMaxCells++)
+	{
+		/* Nil */
+	}
+
+	fCellSize = 2.0f * fRangeSum / (float) nRanged;
+	nCells = 1;
+
+	for (k = 0; k < 3; k++)
+	{
+		float fExtent = fMax[k] - fMin[k];
+		float fCells = fExtent / fCellSize;
+
+		if (fCells < 1.0f)
+		{
+			nGridCells[k] = 1;
+		}
+		else if (fCells > (float) nMaxCells)
+		{
+			nGridCells[k] = nMaxCells;
+		}
+		else
+		{
+			nGridCells[k] = (int) fCells;
+		}
+
+		fGridMin[k] = fMin[k];
+		fGridScale[k] = (float) nGridCells[k] / fExtent;
+
+		nCells *= nGridCells[k];
+	}
+
+	if (!GrowInts(&pnCellStart, &nCellStartAlloc, nCells + 1))
+	{
+		nGridCells[0] = nGridCells[1] = nGridCells[2] = 0;
+		return;
+	}
+
+	for (k = 0; k <= nCells; k++)
+	{
+		pnCellStart[k] = 0;
+	}
+
+	/*
+	// Count the lights in each cell, and turn the counts into where each
+	// cell's lights end. Filling in then steps each one back to where
+	// they start.
+	*/
+	for (nLight = 0, pLight = pPoolLights; nLight < nPoolTop; nLight++, pLight++)
+	{
+		const LIGHT_ENTRY_STRUCT *pEntry = &pLight->Entry;
+		float fLo[3], fHi[3];
+
+		if (((pEntry->light_flags & mask_light_types) != point_light_type) ||
+			(pEntry->range <= 0.0f))
+		{
+			continue;
+		}
+
+		for (k = 0; k < 3; k++)
+		{
+			fLo[k] = pEntry->position[k] - pEntry->range;
+			fHi[k] = pEntry->position[k] + pEntry->range;
+		}
+
+		LightCellRange(fLo, fHi, nLo, nHi);
+
+		for (z = nLo[2]; z <= nHi[2]; z++)
+		{
+			for (y = nLo[1]; y <= nHi[1]; y++)
+			{
+				for (x = nLo[0]; x <= nHi[0]; x++)
+				{
+					pnCellStart[((z * nGridCells[1]) + y) * nGridCells[0] + x]++;
+				}
+			}
+		}
+	}
+
+	for (k = 1; k <= nCells; k++)
+	{
+		pnCellStart[k] += pnCellStart[k - 1];
+	}
+
+	if (!GrowInts(&pnCellLights, &nCellLightsAlloc, pnCellStart[nCells]))
+	{
+		nGridCells[0] = nGridCells[1] = nGridCells[2] = 0;
+		return;
+	}
+
+	for (nLight = 0, pLight = pPoolLights; nLight < nPoolTop; nLight++, pLight++)
+	{
+		const LIGHT_ENTRY_STRUCT *pEntry = &pLight->Entry;
+		float fLo[3], fHi[3];
+
+		if (((pEntry->light_flags & mask_light_types) != point_light_type) ||
+			(pEntry->range <= 0.0f))
+		{
+			continue;
+		}
+
+		for (k = 0; k < 3; k++)
+		{
+			fLo[k] = pEntry->position[k] - pEntry->range;
+			fHi[k] = pEntry->position[k] + pEntry->range;
+		}
+
+		LightCellRange(fLo, fHi, nLo, nHi);
+
+		for (z = nLo[2]; z <= nHi[2]; z++)
+		{
+			for (y = nLo[1]; y <= nHi[1]; y++)
+			{
+				for (x = nLo[0]; x <= nHi[0]; x++)
+				{
+					int nCell = ((z * nGridCells[1]) + y) * nGridCells[0] + x;
+
+					pnCellLights[--pnCellStart[nCell]] = nLight;
+				}
+			}
+		}
+	}
+
+	bGridOK = TRUE;
+}
+
+
+/**************************************************************************
+ * Function Name  : LightScore
+ * Inputs         : pEntry - a light that is on
+ *					pBox - the object's bounds, or NULL
+ * Outputs        :
+ * Input/Output	  :
+ * Returns        : How much the light matters to the object, or 0 if it
+ *					can't reach it.
+ * Global Used    :
+ * Description    : Lights are scored by their brightness. A ranged light
+ *					counts for less the further away the object is, and
+ *					not at all beyond its range, and a spot light counts
+ *					for nothing if the object is behind it.
+ **************************************************************************/
+
+static float LightScore(const LIGHT_ENTRY_STRUCT * pEntry,
+						const BBOX_MINMAX_STRUCT * pBox)
+{
+	float fScore;
+	int k;
+
+	if (pEntry->light_flags & coloured)
+	{
+		fScore = pEntry->colour[0] + pEntry->colour[1] + pEntry->colour[2];
+	}
+	else
+	{
+		fScore = 3.0f * pEntry->colour[0];
+	}
+
+	if (((pEntry->light_flags & mask_light_types) != point_light_type) ||
+		(pBox == NULL))
+	{
+		return (fScore);
+	}
+
+	if (pEntry->range > 0.0f)
+	{
+		float fDistSq = 0.0f;
+		float fRangeSq = pEntry->range * pEntry->range;
+
+		for (k = 0; k < 3; k++)
+		{
+			float fDist = 0.0f;
+
+			if (pEntry->position[k] < pBox->boxMin[k])
+			{
+				fDist = pBox->boxMin[k] - pEntry->position[k];
+			}
+			else if (pEntry->position[k] > pBox->boxMax[k])
+			{
+				fDist = pEntry->position[k] - pBox->boxMax[k];
+			}
+
+			fDistSq += fDist * fDist;
+		}
+
+		if (fDistSq >= fRangeSq)
+		{
+			return (0.0f);
+		}
+
+		fScore *= 1.0f - (fDistSq / fRangeSq);
+	}
 
 	/*
-	// Return the pointer to the entry
+	// A spot light only lights points where the direction to the light
+	// (which is what pEntry->direction is) is in front of it. Find the
+	// corner of the box that is most that way.
 	*/
-	return (pCurrEntry);
-}
+	if (pEntry->concentration != 0)
+	{
+		float fFront = 0.0f;
 
+		for (k = 0; k < 3; k++)
+		{
+			float fDir = pEntry->direction[k];
+
+			fFront += fDir * (pEntry->position[k] -
+							  ((fDir > 0.0f) ? pBox->boxMin[k] : pBox->boxMax[k]));
+		}
 
+		if (fFront <= 0.0f)
+		{
+			return (0.0f);
+		}
+	}
 
+	return (fScore);
+}
 
 
 /**************************************************************************
- * Function Name  : CalcAverageCol
- * Inputs         : 
-					  
- * Outputs        :  
- * Input/Output	  : lightState
-						  
- * Returns        : 
- * Global Used    : 
- * Description    : Calculates average light colour for light slot 
-					zero, plus the smooth shading intensity values 
- *					
- *				   
+ * Function Name  : ChooseLight
+ * Inputs         : pEntry - a light that is on
+ * Outputs        :
+ * Input/Output	  : pChoice
+ * Returns        :
+ * Global Used    :
+ * Description    : Adds the light to the chosen ones if it is one of the
+ *					best so far.
  **************************************************************************/
 
-
-void	CalcAverageCol(LIGHTS_STATE_STRUCT	* lightState)
+static void ChooseLight(LIGHT_CHOICE_STRUCT * pChoice,
+						const LIGHT_ENTRY_STRUCT * pEntry)
 {
-	int	curEntry;
-	int numOnLights[NUM_LIGHT_SLOTS];
-	sgl_vector	SummedCol[NUM_LIGHT_SLOTS];
-	float fRescale[NUM_LIGHT_SLOTS];
-	float SummedBrightness[NUM_LIGHT_SLOTS];
-	int nSlot;
-	float i;
-
-	/* init the average light colours */
-
-	numOnLights[0] = 1;
+	float fScore = LightScore(pEntry, pChoice->pBox);
+	int nPos;
 
-	if (lightState->flags & lsf_ambient_grey)
+	if (fScore <= 0.0f)
 	{
-		i = lightState->ambient_colour[0];
-	
-		SummedCol[0][0] = i;
-		SummedCol[0][1] = i;
-		SummedCol[0][2] = i;
-
-	  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
-		SummedBrightness[0] = ssqrt (3.0f * (i * i));
-	  #else
-		SummedBrightness[0] = (float)sqrt (3.0f * (i * i));
-	  #endif
+		return;
 	}
-	else if ((lightState->ambient_colour[0] > 0.0f) ||
-			 (lightState->ambient_colour[1] > 0.0f) ||
-			 (lightState->ambient_colour[2] > 0.0f))
-	{
-		SummedCol[0][0] = lightState->ambient_colour[0];
-		SummedCol[0][1] = lightState->ambient_colour[1];
-		SummedCol[0][2] = lightState->ambient_colour[2];
 
-		SummedBrightness[0] = VecLength (lightState->ambient_colour);
-	}
-	else
+	if (pChoice->nChosen == pChoice->nWanted)
 	{
-		numOnLights[0] = 0;
-
-		SummedCol[0][0] = 0.0f;
-		SummedCol[0][1] = 0.0f;
-		SummedCol[0][2] = 0.0f;
+		if ((pChoice->nWanted == 0) ||
+			(fScore <= pChoice->fScore[pChoice->nWanted - 1]))
+		{
+			return;
+		}
 
-		SummedBrightness[0] = 0.0f;
+		/* Drop the worst */
+		pChoice->nChosen --;
 	}
 
-	for (nSlot = 1; nSlot < NUM_LIGHT_SLOTS; ++nSlot)
+	for (nPos = pChoice->nChosen;
+		 (nPos > 0) && (pChoice->fScore[nPos - 1] < fScore);
+		 nPos--)
 	{
-		SummedCol[nSlot][0] = 0.0f;
-		SummedCol[nSlot][1] = 0.0f;
-		SummedCol[nSlot][2] = 0.0f;
-		
-		SummedBrightness[nSlot] = 0.0f;
-
-		numOnLights[nSlot] = 0;
+		pChoice->fScore[nPos] = pChoice->fScore[nPos - 1];
+		pChoice->pChosen[nPos] = pChoice->pChosen[nPos - 1];
 	}
 
-	/* step through all the lights currently in the light entry table */
+	pChoice->fScore[nPos] = fScore;
+	pChoice->pChosen[nPos] = pEntry;
+	pChoice->nChosen ++;
+}
 
-	for (curEntry = 0; curEntry < (lightState->num_lights); curEntry++)
+
+/**************************************************************************
+ * Function Name  : ChoosePoolLight
+ * Inputs         : nLight - index of a pool light
+ * Outputs        :
+ * Input/Output	  : pChoice
+ * Returns        :
+ * Global Used    : the light pool
+ * Description    : Considers a pool light, if it is in scope, on, and
+ *					hasn't been replaced by a switched copy.
+ **************************************************************************/
+
+static void ChoosePoolLight(LIGHT_CHOICE_STRUCT * pChoice, int nLight)
+{
+	const POOL_LIGHT_STRUCT *pLight = &pPoolLights[nLight];
+	int nCopy = pLight->nReplacedBy;
+
+	if ((nLight >= pChoice->nScope) || !(pLight->Entry.light_flags & light_on))
 	{
-		/* only add components of lights that are switched on */
+		return;
+	}
 
-		if (lightState->light_entries[curEntry].light_flags & light_on)
-		{
-			nSlot = lightState->light_entries[curEntry].light_colour_slot;
+	if ((nCopy >= 0) && (nCopy < pChoice->nScope) &&
+		(pPoolLights[nCopy].nReplaces == nLight))
+	{
+		return;
+	}
 
-			ASSERT (nSlot >= 0);			
-			ASSERT (nSlot <= NUM_LIGHT_SLOTS);			
+	ChooseLight(pChoice, &pLight->Entry);
+}
 
-			if (lightState->light_entries[curEntry].light_flags & coloured)
-			{
-				SummedCol[nSlot][0] += lightState->light_entries[curEntry].colour[0];
-				SummedCol[nSlot][1] += lightState->light_entries[curEntry].colour[1];
-				SummedCol[nSlot][2] += lightState->light_entries[curEntry].colour[2];
 
-				SummedBrightness[nSlot] += VecLength (lightState->light_entries[curEntry].colour);
-			}
-			else
-			{
-				i = lightState->light_entries[curEntry].colour[0];
+/**************************************************************************
+ * Function Name  : RnSelectObjectLights
+ * Inputs         : pTransform - the object's transform
+ *					pBox - the object's bounds, or NULL if it has none
+ * Outputs        :
+ * Input/Output	  : plightState - the lights in scope
+ *
+ * Returns        : The light state to shade the object with
+ * Global Used    : the light pool and the grid
+ * Description    : When all the lights in scope fit in the light state it
+ *					is returned as it is. Otherwise the best lights for the
+ *					object are picked from it and the pool. Lights in shadow
+ *					slots are always kept, as the shadows depend on them.
+ *					The returned state is only good until the next call.
+ **************************************************************************/
 
-				SummedCol[nSlot][0] += i;
-				SummedCol[nSlot][1] += i;
-				SummedCol[nSlot][2] += i;
+LIGHTS_STATE_STRUCT * RnSelectObjectLights(LIGHTS_STATE_STRUCT * plightState,
+									const TRANSFORM_STRUCT * pTransform,
+									const BBOX_CENT_STRUCT * pBox)
+{
+	LIGHT_CHOICE_STRUCT		Choice;
+	BBOX_MINMAX_STRUCT		Box;
+	const LIGHT_ENTRY_STRUCT *pKept[SGL_MAX_ACTIVE_LIGHTS];
+	const LIGHT_ENTRY_STRUCT *pEntry;
+	LIGHT_ENTRY_STRUCT		*pOut;
+	int						nKept, nLight, nPass, k;
+
+	if (plightState->num_pool_lights == 0)
+	{
+		return (plightState);
+	}
 
-			  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
-				SummedBrightness[nSlot] += ssqrt (3.0f * (i * i));
-			  #else
-				SummedBrightness[nSlot] += (float)sqrt (3.0f * (i * i));
-			  #endif
-			}
+	if (nLightsPerObject < 0)
+	{
+		nLightsPerObject = SglReadPrivateProfileInt ("Lights", "PerObject",
+									SGL_MAX_ACTIVE_LIGHTS, "sgl.ini");
 
-			numOnLights[nSlot]++;
+		if ((nLightsPerObject < 0) || (nLightsPerObject > SGL_MAX_ACTIVE_LIGHTS))
+		{
+			nLightsPerObject = SGL_MAX_ACTIVE_LIGHTS;
 		}
 	}
 
-	/* calculate the average colours */
-	
-	for (nSlot = 0; nSlot < NUM_LIGHT_SLOTS; ++nSlot)
+	if (pBox != NULL)
 	{
-		if (numOnLights[nSlot])
-		{
-			SummedBrightness[nSlot] = 1.0f / SummedBrightness[nSlot];
-			
-			#if 1
+		TransformBBox(pTransform, pBox, &Box);
+		Choice.pBox = &Box;
+	}
+	else
+	{
+		Choice.pBox = NULL;
+	}
 
-			if (SummedCol[nSlot][0] > 1.0f || SummedCol[nSlot][1] > 1.0f || SummedCol[nSlot][2] > 1.0f)
-			{
-				float fMax = SummedCol[nSlot][0];
-				float f1overMax;
+	Choice.nScope = plightState->num_pool_lights;
+	Choice.nChosen = 0;
 
-				CHOOSE_MAX (fMax, SummedCol[nSlot][1]);
-				CHOOSE_MAX (fMax, SummedCol[nSlot][2]);
+	/*
+	// Keep the shadow lights, and let the others compete for what's left
+	*/
+	nKept = 0;
+	pEntry = plightState->light_entries;
 
-				fRescale[nSlot] = fMax;
-				f1overMax = 1.0f / fMax;
+	for (nLight = plightState->numOnParLights + plightState->numOnPntLights;
+		 nLight != 0; nLight--, pEntry++)
+	{
+		if ((pEntry->assigned_shad_volume != 0) || (pEntry->light_colour_slot != 0))
+		{
+			pKept[nKept++] = pEntry;
+		}
+	}
 
-				SummedCol[nSlot][0] *= f1overMax; 
-				SummedCol[nSlot][1] *= f1overMax; 
-				SummedCol[nSlot][2] *= f1overMax; 
-			}
-			else
-			{
-				fRescale[nSlot] = 1.0f;
-			}
+	Choice.nWanted = (nKept < nLightsPerObject) ? (nLightsPerObject - nKept) : 0;
 
-			#else
+	pEntry = plightState->light_entries;
 
-			fRescale[nSlot] = 1.0f;
+	for (nLight = plightState->numOnParLights + plightState->numOnPntLights;
+		 nLight != 0; nLight--, pEntry++)
+	{
+		if ((pEntry->assigned_shad_volume == 0) && (pEntry->light_colour_slot == 0))
+		{
+			ChooseLight(&Choice, pEntry);
+		}
+	}
 
-			#endif
+	/*
+	// Then the pool lights, using the grid for the ranged ones if we can
+	*/
+	if (u32GridChanges != u32PoolChanges)
+	{
+		BuildLightGrid();
+	}
 
-			lightState->light_slots[nSlot].colour[0] = SummedCol[nSlot][0];
-			lightState->light_slots[nSlot].colour[1] = SummedCol[nSlot][1];
-			lightState->light_slots[nSlot].colour[2] = SummedCol[nSlot][2];
+	if (!bGridOK || (Choice.pBox == NULL))
+	{
+		for (nLight = 0; nLight < Choice.nScope; nLight++)
+		{
+			ChoosePoolLight(&Choice, nLight);
+		}
+	}
+	else
+	{
+		int nLo[3], nHi[3];
+		int x, y, z;
 
-			if (nSlot == 0)	
-			{
-				float fAmbientVecLength;
+		for (k = 0; k < nUnbounded; k++)
+		{
+			ChoosePoolLight(&Choice, pnUnbounded[k]);
+		}
 
-				if (lightState->flags & lsf_ambient_grey)
+		if ((nGridCells[0] != 0) &&
+			LightCellRange(Box.boxMin, Box.boxMax, nLo, nHi))
+		{
+			if (++u32Visit == 0)
+			{
+				for (k = 0; k < nPerLightAlloc; k++)
 				{
-				  #if defined (MIDAS_ARCADE) || defined (ZEUS_ARCADE)
-					fAmbientVecLength = ssqrt (3.0f * (lightState->ambient_colour[0] * lightState->ambient_colour[0]));
-				  #else
-					fAmbientVecLength = (float)sqrt (3.0f * (lightState->ambient_colour[0] * lightState->ambient_colour[0]));
-				  #endif
+					pu32Visited[k] = 0;
 				}
-				else
+
+				u32Visit = 1;
+			}
+
+			for (z = nLo[2]; z <= nHi[2]; z++)
+			{
+				for (y = nLo[1]; y <= nHi[1]; y++)
 				{
-					fAmbientVecLength = VecLength (lightState->ambient_colour);
-				}
+					for (x = nLo[0]; x <= nHi[0]; x++)
+					{
+						int nCell = ((z * nGridCells[1]) + y) * nGridCells[0] + x;
 
-				lightState->ambient_smooth_intensity = fAmbientVecLength * SummedBrightness[nSlot] * fRescale[nSlot];
+						for (k = pnCellStart[nCell]; k < pnCellStart[nCell + 1]; k++)
+						{
+							nLight = pnCellLights[k];
+
+							if (pu32Visited[nLight] != u32Visit)
+							{
+								pu32Visited[nLight] = u32Visit;
+								ChoosePoolLight(&Choice, nLight);
+							}
+						}
+					}
+				}
 			}
 		}
 	}
 
-	/* find largest dot product */
+	/*
+	// Build the object's light state, with the parallel lights first and
+	// then the point lights as usual. The positions and smooth shading
+	// intensities have to be worked out afresh.
+	*/
+	SelectedLights = *plightState;
 
-	for (curEntry = 0; curEntry < lightState->num_lights; curEntry++)
+	SelectedLights.num_pool_lights = 0;
+	SelectedLights.numOnParLights = 0;
+	SelectedLights.numOnPntLights = 0;
+	SelectedLights.numOffLights = 0;
+	SelectedLights.flags |= lsf_dirty_smooth | lsf_dirty_position;
+
+	pOut = SelectedLights.light_entries;
+
+	for (nPass = 0; nPass < 2; nPass++)
 	{
-		/* only interested in lights that are switched on */
+		int nType = (nPass == 0) ? parallel_light_type : point_light_type;
 
-		if (lightState->light_entries[curEntry].light_flags & light_on)
+		for (k = 0; k < nKept + Choice.nChosen; k++)
 		{
-			float fVecLength;
+			pEntry = (k < nKept) ? pKept[k] : Choice.pChosen[k - nKept];
 
-			nSlot = lightState->light_entries[curEntry].light_colour_slot;
-	
-			if (lightState->light_entries[curEntry].light_flags & coloured)
-			{
-				fVecLength = VecLength (lightState->light_entries[curEntry].colour);
-			}
-			else
+			if ((pEntry->light_flags & mask_light_types) == nType)
 			{
-				fVecLength = (float)sqrt (3.0f * (lightState->light_entries[curEntry].colour[0] * 
-										lightState->light_entries[curEntry].colour[0]));
-			}
+				*pOut++ = *pEntry;
 
-			lightState->light_entries[curEntry].smooth_intensity = fVecLength * SummedBrightness[nSlot] * fRescale[nSlot];   
+				if (nPass == 0)
+				{
+					SelectedLights.numOnParLights ++;
+				}
+				else
+				{
+					SelectedLights.numOnPntLights ++;
+				}
+			}
 		}
 	}
 
-	/* clear dirty flag bit. Is now nice and clean */
-   	lightState->flags &= ~lsf_dirty_smooth;
-}	
+	SelectedLights.num_lights = SelectedLights.numOnParLights +
+								SelectedLights.numOnPntLights;
 
+	return (&SelectedLights);
+}
 
 
 /**************************************************************************
@@ -1023,6 +1998,13 @@ void RnProcessLightSwitchNode( const LIGHT_SWITCH_NODE_STRUCT	* switchNode,
 		*/
 
 	}/*end if light found */
+	/*
+	// else it might be one the light manager is looking after
+	*/
+	else if(plightState->num_pool_lights != 0)
+	{
+		SwitchPoolLight(switchNode, plightState);
+	}
 }
 
 
@@ -1245,6 +2227,35 @@ void RnProcessLightNode( const LIGHT_NODE_STRUCT	* lightNode,
 					} /*end if else casting shadows*/
 
 				}/*END IF not at max acive lights*/
+				/*
+				// Else hand it to the light manager. Pool lights never
+				// cast shadows, as the shadow slots go with the light
+				// entries.
+				*/
+				else
+				{
+					POOL_LIGHT_STRUCT *pPoolLight = AddPoolLight(lightState);
+
+					if(pPoolLight != NULL)
+					{
+						pCurrEntry = &pPoolLight->Entry;
+
+						if(LightType == parallel_light_type)
+						{
+							FillParLightEntry(pCurrEntry, lightNode, tranNode,
+											  lightState);
+						}
+						else
+						{
+							FillPointLightEntry(pCurrEntry, lightNode, tranNode,
+												lightState);
+						}
+
+						pCurrEntry->shad_volume=0;
+						pCurrEntry->assigned_shad_volume=0;
+						pCurrEntry->light_colour_slot=0;
+					}
+				}
 
 				break;
 		}
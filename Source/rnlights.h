@@ -46,6 +46,13 @@ extern void	RnProcessMultiShadowNode(const MULTI_SHADOW_NODE_STRUCT * pNode,
 
 extern	void	CalcAverageCol(LIGHTS_STATE_STRUCT	* lightState);
 
+extern	void	RnResetLightPool(void);
+
+extern	LIGHTS_STATE_STRUCT * RnSelectObjectLights(
+									LIGHTS_STATE_STRUCT * plightState,
+									const TRANSFORM_STRUCT * pTransform,
+									const BBOX_CENT_STRUCT * pBox);
+
 				
 
 /*
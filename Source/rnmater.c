@@ -424,6 +424,26 @@ void	RnProcessMaterialNode(const MATERIAL_NODE_STRUCT  * matNode,
 		*/
 		if(matNode->pcached_texture == NULL)
 		{
+			/*
+			// If textures have been moved since the material was set up,
+			// get the texture's control word again.
+			*/
+			if(matNode->texture_moves != dlUserGlobals.u32TextureMoveCount)
+			{
+				MATERIAL_NODE_STRUCT *pMaterial = (MATERIAL_NODE_STRUCT *) matNode;
+				HTEXTURE hTexture;
+				int itemType;
+
+				hTexture = GetNamedItemAndType(dlUserGlobals.pNamtab,
+											   pMaterial->texture_name,
+											   &itemType);
+				if(itemType == nt_texture)
+				{
+					pMaterial->texture_control = hTexture->TSPTextureControlWord;
+				}
+
+				pMaterial->texture_moves = dlUserGlobals.u32TextureMoveCount;
+			}
 
 			/* copy over the texture address + control bits */
 
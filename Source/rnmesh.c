@@ -794,6 +794,8 @@
 /* Needed for optimised object packing routines in dregion.c. */
 #include "dregion.h"
 
+#include "rnmsimd.h"
+
 #define PRE_CULL	0
 
 SGL_EXTERN_TIME_REF /* if we are timing code !!! */
@@ -843,6 +845,30 @@ static	CONV_POINTS_STRUCT			gPointsData[SGL_MAX_INTERNAL_PLANES];
 static	XMESHEXTRA 					gXExtras[SGL_MAX_INTERNAL_PLANES];
 static	SMOOTHPARAMS				gSP;
 
+/*
+// The compiled mesh kernels (rnmsimd.c), picked at initialisation. With
+// only one lane there are none and the vertex data is used.
+*/
+static	MESHXFORMFNS				gXformFns;
+static	int							gnXformLanes = 1;
+
+/*
+// The face planes of a compiled mesh, transformed all at once before the
+// faces are processed, and the first face they go with. gpXPlaneFaces is
+// NULL when the faces' own plane data has to be transformed instead.
+// Expanded as required, like the vertices.
+*/
+typedef struct
+{
+	sgl_vector	normal;
+	float		d;
+
+} XMESHPLANE;
+
+static	int							gnXPlanes = 0;
+static	XMESHPLANE					*gpXPlanes = NULL;
+static	const FACE					*gpXPlaneFaces = NULL;
+
 /*
 // for translucent mesh handling. Ideally this SHOULD be a local, passed,
 // variable, but What the hey.
@@ -1551,6 +1577,8 @@ void RnMeshOnSglInitialise ()
 
 	ASSERT (gpXVertices);
 
+	gnXformLanes = MeshXformSelect (&gXformFns);
+
 #if PRE_CULL
 
 	gpXVertexIndex = SGLMalloc (sizeof (sgl_uint8) * gnXVertices);
@@ -2190,6 +2218,318 @@ static void ProcessVerticesAllVisible( 	 PVERTEX pVertex,
 	SGL_TIME_STOP(TRANSFORM_VERTICES_ALL_TIME)
 }
 
+/**************************************************************************
+ * Function Name  : SetupXformContext  (LOCAL FUNCTION)
+ * Inputs         : pTransform	  - the mesh's transform
+ * Outputs        : pCtx		  - what the compiled mesh kernels read
+ *
+ * Gathers the matrices and projection values the compiled mesh kernels
+ * use. The plane normal matrix is picked the same way as in
+ * TransformAndComputeSabreParamsVisible: the transpose of the inverse
+ * (negated for negative scaling) when the scaling isn't uniform.
+ **************************************************************************/
+
+static void SetupXformContext (const TRANSFORM_STRUCT *pTransform,
+							   MESHXFORMCONTEXT *pCtx)
+{
+	PROJECTION_MATRIX_STRUCT  * const pProjMat = RnGlobalGetProjMat ();
+	int i, j;
+
+	for (i = 0; i < 3; i ++)
+	{
+		for (j = 0; j < 4; j ++)
+		{
+			pCtx->m[i][j] = pTransform->mat[i][j];
+		}
+	}
+
+	if ( (pTransform->scale_flag == arbitrary_scale) ||
+	     (pTransform->has_neg_scaling))
+	{
+		/* Multiplying by 1 leaves the inverse exactly as it was */
+		float fScale = (pTransform->has_neg_scaling) ? -1.0f : 1.0f;
+
+		for (i = 0; i < 3; i ++)
+		{
+			for (j = 0; j < 3; j ++)
+			{
+				pCtx->n[j][i] = pTransform->inv[i][j] * (fScale);
+			}
+		}
+	}
+	else
+	{
+		for (i = 0; i < 3; i ++)
+		{
+			for (j = 0; j < 3; j ++)
+			{
+				pCtx->n[i][j] = pTransform->mat[i][j];
+			}
+		}
+	}
+
+	pCtx->SxDash = pProjMat->SxDash;
+	pCtx->SyDash = pProjMat->SyDash;
+	pCtx->OxDash = pProjMat->OxDash;
+	pCtx->OyDash = pProjMat->OyDash;
+	pCtx->fRegionXScale = pProjMat->fRegionXScale;
+	pCtx->fRoundRegionX = FIX_ROUNDING_PROBLEM;
+
+	pCtx->foregroundDistance = pProjMat->foregroundDistance;
+	pCtx->fViewportMinX = pProjMat->fViewportMinX;
+	pCtx->fViewportMaxX = pProjMat->fViewportMaxX;
+	pCtx->fViewportMinY = pProjMat->fViewportMinY;
+	pCtx->fViewportMaxY = pProjMat->fViewportMaxY;
+	pCtx->FirstXRegion = pProjMat->FirstXRegion;
+	pCtx->LastXRegion = pProjMat->LastXRegion;
+	pCtx->FirstYRegionExact = pProjMat->FirstYRegionExact;
+	pCtx->LastYRegionExact = pProjMat->LastYRegionExact;
+}
+
+/**************************************************************************
+ * Function Name  : ProcessCompiledVerticesAllVisible  (LOCAL FUNCTION)
+ * Inputs         : pMesh		  - a mesh with a compiled form
+ *					nVertices	  - the number of vertices to process
+ *					pCtx		  - from SetupXformContext
+ *
+ * The same as ProcessVerticesAllVisible, but the compiled mesh kernel
+ * does gnXformLanes vertices at a time straight from the compiled
+ * position arrays. The results are copied into the transformed vertices.
+ **************************************************************************/
+
+static void ProcessCompiledVerticesAllVisible (const MESH_NODE_STRUCT *pMesh,
+												int nVertices, 
+						const MESHXFORMCONTEXT	 *pCtx)
+{
+	PTRANSVERTEX 	pXVertex;
+	PVERTEX		 	pVertex;
+	MESHXFORMLANES	Lanes;
+	int				k, nFirst, nLanes;
+
+	ASSERT (pMesh->pCompiled->nVertices >= nVertices);
+
+	SGL_TIME_START(TRANSFORM_VERTICES_ALL_TIME)
+	
+	pXVertex = gpXVertices;
+	pVertex = pMesh->pVertexData;
+
+	for (nFirst = 0; nFirst < nVertices; nFirst += gnXformLanes)
+	{
+		gXformFns.pfnAllVisible (pMesh->pCompiled, nFirst, &Lanes, pCtx);
+
+		nLanes = nVertices - nFirst;
+
+		if (nLanes > gnXformLanes)
+		{
+			nLanes = gnXformLanes;
+		}
+
+		for (k = 0; k < nLanes; ++k, ++pVertex, ++pXVertex)
+		{
+			pXVertex->pvVertex = pVertex->vVertex;
+
+			pXVertex->vWorldSpace[0] = Lanes.fWorld[0][k];
+			pXVertex->vWorldSpace[1] = Lanes.fWorld[1][k];
+			pXVertex->vWorldSpace[2] = Lanes.fWorld[2][k];
+
+			pXVertex->vScreenSpace[0] = Lanes.fScreen[0][k];
+			pXVertex->vScreenSpace[1] = Lanes.fScreen[1][k];
+
+			pXVertex->nRegion[0] = Lanes.nRegion[0][k];
+			pXVertex->nRegion[1] = Lanes.nRegion[1][k];
+
+			ASSERT(RnGlobalProjMatRegionOnScreen(pXVertex->nRegion[0], 
+												 pXVertex->nRegion[1]));
+		}
+	}
+
+	SGL_TIME_STOP(TRANSFORM_VERTICES_ALL_TIME)
+}
+
+/**************************************************************************
+ * Function Name  : ProcessCompiledVerticesPartlyVisible  (LOCAL FUNCTION)
+ * Inputs         : pMesh		  - a mesh with a compiled form
+ *					nVertices	  - the number of vertices to process
+ *					pCtx		  - from SetupXformContext
+ *
+ * The compiled version of ProcessVerticesPartlyVisible. The kernel does
+ * the transform, clip flags and clamped regions; here they are copied
+ * into the transformed vertices (only the world position and flags for
+ * a vertex that is Z clipped, as in the scalar version) and the flags
+ * are totalled up to see whether the mesh is on screen.
+ **************************************************************************/
+
+static TEST_BOX_ENUM ProcessCompiledVerticesPartlyVisible (
+							const MESH_NODE_STRUCT *pMesh,
+							int nVertices, 
+							const MESHXFORMCONTEXT *pCtx)
+{
+	PTRANSVERTEX 	pXVertex;
+	PVERTEX		 	pVertex;
+	MESHXFORMLANES	Lanes;
+	int				k, nFirst, nLanes, Flags;
+	/*
+	// These are used to determine if the mesh is entirely
+	// on screen, or possibly entirely offscreen, or partly on screen.
+	// Any flag set means the vertex was clipped somehow.
+	*/
+	int				OrFlags, AndFlags;
+
+	ASSERT (pMesh->pCompiled->nVertices >= nVertices);
+
+	SGL_TIME_START(TRANSFORM_VERTICES_PARTLY_TIME)
+
+	OrFlags = 0;
+	AndFlags = ~0;
+
+	pXVertex = gpXVertices;
+	pVertex = pMesh->pVertexData;
+
+	for (nFirst = 0; nFirst < nVertices; nFirst += gnXformLanes)
+	{
+		gXformFns.pfnPartlyVisible (pMesh->pCompiled, nFirst, &Lanes, pCtx);
+
+		nLanes = nVertices - nFirst;
+
+		if (nLanes > gnXformLanes)
+		{
+			nLanes = gnXformLanes;
+		}
+
+		for (k = 0; k < nLanes; ++k, ++pVertex, ++pXVertex)
+		{
+			pXVertex->pvVertex = pVertex->vVertex;
+
+			pXVertex->vWorldSpace[0] = Lanes.fWorld[0][k];
+			pXVertex->vWorldSpace[1] = Lanes.fWorld[1][k];
+			pXVertex->vWorldSpace[2] = Lanes.fWorld[2][k];
+
+			Flags = Lanes.Flags[k];
+
+			if (!(Flags & CLIPPED_Z))
+			{
+				pXVertex->vScreenSpace[0] = Lanes.fScreen[0][k];
+				pXVertex->vScreenSpace[1] = Lanes.fScreen[1][k];
+
+				pXVertex->nRegion[0] = Lanes.nRegion[0][k];
+				pXVertex->nRegion[1] = Lanes.nRegion[1][k];
+			}
+
+			pXVertex->Flags = Flags;
+
+			OrFlags |= Flags;
+			AndFlags &= Flags;
+		}
+	}
+
+	SGL_TIME_STOP(TRANSFORM_VERTICES_PARTLY_TIME)
+
+	/*
+	//Decide whether the mesh is entirely on screen etc
+	*/
+	if(!OrFlags)
+	{
+		return(TB_BOX_ALL_ONSCREEN);
+	}
+	else if(AndFlags)
+	{
+		return(TB_BOX_OFFSCREEN);
+	}
+	else
+	{
+		return(TB_BOX_PART_ONSCREEN);
+	}
+}
+
+/**************************************************************************
+ * Function Name  : ProcessCompiledPlanes  (LOCAL FUNCTION)
+ * Inputs         : pMesh		  - a mesh with a compiled form
+ *					pCtx		  - from SetupXformContext
+ *
+ * Transforms every face plane of a compiled mesh and works out its D from
+ * the transformed vertices, so must come after the vertices are done.
+ * Sets gpXPlaneFaces so TransformAndComputeSabreParams(Partly)Visible use
+ * the results, unless there isn't the memory, in which case they do the
+ * planes themselves.
+ **************************************************************************/
+
+static void ProcessCompiledPlanes (const MESH_NODE_STRUCT *pMesh,
+								   const MESHXFORMCONTEXT *pCtx)
+{
+	const COMPILED_MESH_STRUCT *pC = pMesh->pCompiled;
+	MESHPLANELANES	Lanes;
+	XMESHPLANE		*pXP;
+	PTRANSVERTEX 	pVert;
+	int				k, nFirst, nLanes, nFaces;
+
+	nFaces = pC->nFaces;
+
+	ASSERT (nFaces == ListGetItemsInList (pMesh->Faces));
+
+	if (nFaces > gnXPlanes)
+	{
+		XMESHPLANE *pNew;
+
+		pNew = SGLMalloc (sizeof (XMESHPLANE) * nFaces);
+		if (pNew)
+		{
+			DPF ((DBG_WARNING, "Bumping up static plane array to %d", nFaces));
+
+			if (gpXPlanes)
+			{
+				SGLFree (gpXPlanes);
+			}
+			
+			gpXPlanes = pNew;
+			gnXPlanes = nFaces;
+		}
+		else
+		{
+			DPF ((DBG_WARNING,
+			 "Unable to bump up static plane array to %d - using face data", 
+							 nFaces));
+			return ;
+		}
+	}
+
+	pXP = gpXPlanes;
+
+	for (nFirst = 0; nFirst < nFaces; nFirst += gnXformLanes)
+	{
+		/*
+		// Gather the world positions the D values come from. The
+		// padding lanes repeat the last face's vertex.
+		*/
+		for (k = 0; k < gnXformLanes; ++k)
+		{
+			pVert = gpXVertices + pC->pnPlaneVertex[nFirst + k];
+
+			Lanes.fRep[0][k] = pVert->vWorldSpace[0];
+			Lanes.fRep[1][k] = pVert->vWorldSpace[1];
+			Lanes.fRep[2][k] = pVert->vWorldSpace[2];
+		}
+
+		gXformFns.pfnPlanes (pC, nFirst, &Lanes, pCtx);
+
+		nLanes = nFaces - nFirst;
+
+		if (nLanes > gnXformLanes)
+		{
+			nLanes = gnXformLanes;
+		}
+
+		for (k = 0; k < nLanes; ++k, ++pXP)
+		{
+			pXP->normal[0] = Lanes.fNormal[0][k];
+			pXP->normal[1] = Lanes.fNormal[1][k];
+			pXP->normal[2] = Lanes.fNormal[2][k];
+			pXP->d = Lanes.fD[k];
+		}
+	}
+
+	gpXPlaneFaces = ListFindItemFast (pMesh->Faces, 0);
+}
+
 /**************************************************************************
  * Function Name  : ProcessVerticesPartlyVisible  (LOCAL FUNCTION)
  * Inputs         : pVertices     - pointer to start of an array of vertex data
@@ -3215,29 +3555,44 @@ static int TransformAndComputeSabreParamsVisible(const FACE  **ppExtFace,
 			*/
 			float tmp1, tmp2, tmp3;
 			
-			/*
-			// Transform the normal
-			*/
-			#define Norm pFace->PlaneData.normal
-			tmp1 = Norm[0]*m[0][0] + Norm[1]*m[0][1] + Norm[2]*m[0][2];
+			if (gpXPlaneFaces)
+			{
+				/*
+				// A compiled mesh: ProcessCompiledPlanes has done it
+				*/
+				const XMESHPLANE *pXP = gpXPlanes + (pFace - gpXPlaneFaces);
 
-			tmp2 = Norm[0]*m[1][0] + Norm[1]*m[1][1] + Norm[2]*m[1][2];
+				pXPlane->normal[0] = pXP->normal[0];
+				pXPlane->normal[1] = pXP->normal[1];
+				pXPlane->normal[2] = pXP->normal[2];
+				pXPlane->d = pXP->d;
+			}
+			else
+			{
+				/*
+				// Transform the normal
+				*/
+				#define Norm pFace->PlaneData.normal
+				tmp1 = Norm[0]*m[0][0] + Norm[1]*m[0][1] + Norm[2]*m[0][2];
 
-			tmp3 = Norm[0]*m[2][0] + Norm[1]*m[2][1] + Norm[2]*m[2][2];
-			#undef Norm
+				tmp2 = Norm[0]*m[1][0] + Norm[1]*m[1][1] + Norm[2]*m[1][2];
 
-			pXPlane->normal[0] = tmp1;
-			pXPlane->normal[1] = tmp2;
-			pXPlane->normal[2] = tmp3;
-			/*
-			// Get a pointer to a transformed point on this face
-			*/
-			pVert = gpXVertices + pFace->pnVertexIDs[0];
+				tmp3 = Norm[0]*m[2][0] + Norm[1]*m[2][1] + Norm[2]*m[2][2];
+				#undef Norm
 
-			/*
-			// Get the "D" value of the plane
-			*/
-			pXPlane->d = DotProd(pXPlane->normal, pVert->vWorldSpace);
+				pXPlane->normal[0] = tmp1;
+				pXPlane->normal[1] = tmp2;
+				pXPlane->normal[2] = tmp3;
+				/*
+				// Get a pointer to a transformed point on this face
+				*/
+				pVert = gpXVertices + pFace->pnVertexIDs[0];
+
+				/*
+				// Get the "D" value of the plane
+				*/
+				pXPlane->d = DotProd(pXPlane->normal, pVert->vWorldSpace);
+			}
 
 			#if PRE_CULL
 
@@ -3623,31 +3978,47 @@ static int TransformAndComputeSabreParamsPartlyVisible(const FACE **ppExtFace,
 			/*
 			// Now go on with exactly the same processing as in the non Z clipped
 			// routine.....
-			//
-			// Transform the normal
 			*/
-			#define Norm pFace->PlaneData.normal
-			tmp1 = Norm[0]*m[0][0] + Norm[1]*m[0][1] + Norm[2]*m[0][2];
+			if (gpXPlaneFaces)
+			{
+				/*
+				// A compiled mesh: ProcessCompiledPlanes has done it
+				*/
+				const XMESHPLANE *pXP = gpXPlanes + (pFace - gpXPlaneFaces);
 
-			tmp2 = Norm[0]*m[1][0] + Norm[1]*m[1][1] + Norm[2]*m[1][2];
+				pXPlane->normal[0] = pXP->normal[0];
+				pXPlane->normal[1] = pXP->normal[1];
+				pXPlane->normal[2] = pXP->normal[2];
+				pXPlane->d = pXP->d;
+			}
+			else
+			{
+				/*
+				// Transform the normal
+				*/
+				#define Norm pFace->PlaneData.normal
+				tmp1 = Norm[0]*m[0][0] + Norm[1]*m[0][1] + Norm[2]*m[0][2];
 
-			tmp3 = Norm[0]*m[2][0] + Norm[1]*m[2][1] + Norm[2]*m[2][2];
+				tmp2 = Norm[0]*m[1][0] + Norm[1]*m[1][1] + Norm[2]*m[1][2];
 
-			#undef Norm
-			pXPlane->normal[0] = tmp1;
-			pXPlane->normal[1] = tmp2;
-			pXPlane->normal[2] = tmp3;
+				tmp3 = Norm[0]*m[2][0] + Norm[1]*m[2][1] + Norm[2]*m[2][2];
 
+				#undef Norm
+				pXPlane->normal[0] = tmp1;
+				pXPlane->normal[1] = tmp2;
+				pXPlane->normal[2] = tmp3;
 
-			/*
-			// Get a pointer to a transformed point on this face
-			*/
-			pVert = gpXVertices + pFace->pnVertexIDs[0];
 
-			/*
-			// Get the "D" value of the plane
-			*/
-			pXPlane->d = DotProd(pXPlane->normal, pVert->vWorldSpace);
+				/*
+				// Get a pointer to a transformed point on this face
+				*/
+				pVert = gpXVertices + pFace->pnVertexIDs[0];
+
+				/*
+				// Get the "D" value of the plane
+				*/
+				pXPlane->d = DotProd(pXPlane->normal, pVert->vWorldSpace);
+			}
 
 			#if PRE_CULL
 
@@ -5709,6 +6080,8 @@ void RnProcessMeshNode (const MESH_NODE_STRUCT *pMesh,
 	sgl_bool				 bZClipped;
 	sgl_bool				 bMustTextWrap;	
 	sgl_bool				 bIsSmoothShaded;
+	sgl_bool				 bCompiled;
+	MESHXFORMCONTEXT		 XformCtx;
 	TEST_BOX_ENUM BoxCase;
 	PROJECTION_MATRIX_STRUCT  * const pProjMat = RnGlobalGetProjMat ();
 
@@ -5988,6 +6361,23 @@ void RnProcessMeshNode (const MESH_NODE_STRUCT *pMesh,
 	bIsSmoothShaded = (pMesh->ORedPlaneFlags & pf_smooth_shad) &&
 					  (pState->pQualityState->flags & qf_smooth_shading);
 
+	/*
+	// Use the compiled form of the mesh, if it has one and there are
+	// kernels to run on it. Otherwise the vertex data and faces are
+	// transformed one at a time.
+	*/
+	gpXPlaneFaces = NULL;
+	bCompiled = FALSE;
+
+	#if !PRE_CULL
+	if ((gnXformLanes > 1) && pMesh->pCompiled && 
+		(pMesh->pCompiled->nVertices == nVertices))
+	{
+		SetupXformContext (pState->pTransformState, &XformCtx);
+		bCompiled = TRUE;
+	}
+	#endif
+
 	/*
 	// Process the vertices of the mesh. Determine which routine to
 	// use by the flag returned from the bounding box routine
@@ -6000,8 +6390,15 @@ void RnProcessMeshNode (const MESH_NODE_STRUCT *pMesh,
 		//  screen space 
 		*/
 		SGL_TIME_SUSPEND(MESH_NODE_TIME)
-		ProcessVerticesAllVisible (pMesh->pVertexData, nVertices, 
-									  pState->pTransformState);
+		if (bCompiled)
+		{
+			ProcessCompiledVerticesAllVisible (pMesh, nVertices, &XformCtx);
+		}
+		else
+		{
+			ProcessVerticesAllVisible (pMesh->pVertexData, nVertices, 
+										  pState->pTransformState);
+		}
 		SGL_TIME_RESUME(MESH_NODE_TIME)
 	}
 	else
@@ -6018,8 +6415,16 @@ void RnProcessMeshNode (const MESH_NODE_STRUCT *pMesh,
 		// the completely on-screen case, which is faster.
 		*/
 		SGL_TIME_SUSPEND(MESH_NODE_TIME)
-		BoxCase = ProcessVerticesPartlyVisible (pMesh->pVertexData, nVertices, 
-										 pState->pTransformState);
+		if (bCompiled)
+		{
+			BoxCase = ProcessCompiledVerticesPartlyVisible (pMesh, nVertices, 
+															&XformCtx);
+		}
+		else
+		{
+			BoxCase = ProcessVerticesPartlyVisible (pMesh->pVertexData, nVertices, 
+											 pState->pTransformState);
+		}
 		SGL_TIME_RESUME(MESH_NODE_TIME)
 
 		/*
@@ -6034,6 +6439,17 @@ void RnProcessMeshNode (const MESH_NODE_STRUCT *pMesh,
 		}
 	}
 
+	/*
+	// With the vertices done, a compiled mesh can have all its planes
+	// transformed in one go, ready for the face processing
+	*/
+	if (bCompiled)
+	{
+		SGL_TIME_SUSPEND(MESH_NODE_TIME)
+		ProcessCompiledPlanes (pMesh, &XformCtx);
+		SGL_TIME_RESUME(MESH_NODE_TIME)
+	}
+
 	/*
 	// Process the Edges and faces of the mesh. NOTE. I am hoping the
 	// compiler is smart enough to notice that in the previous case where
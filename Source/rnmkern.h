@@ -0,0 +1,197 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rnmkern.h,v $
+Title           :   RNMKERN.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Bodies of the compiled mesh kernels, written once in
+					terms of the vector macros and included by rnmsimd.c
+					for each instruction set. The includer defines
+					MESHXFORM_ALL, MESHXFORM_PARTLY, MESHXFORM_PLANES,
+					MESHXFORM_LANES, MESHXFORM_TARGET and the VF_ / VI_
+					macros first.
+
+					Each lane does what ProcessVerticesAllVisible,
+					ProcessVerticesPartlyVisible or the plane part of
+					TransformAndComputeSabreParams does with one vertex or
+					face, in the same order, so the results match the
+					scalar code.
+
+Program Type    :   C include file (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rnmkern.h,v $
+
+;--
+*****************************************************************************/
+
+/*
+// Model to world: ((x * m0 + y * m1) + z * m2) + m3, as the scalar code
+*/
+#define V_XFORM_ROW(X, Y, Z, r)											\
+	VF_ADD (VF_ADD (VF_ADD (VF_MUL ((X), VF_SET1 (pCtx->m[r][0])),		\
+							VF_MUL ((Y), VF_SET1 (pCtx->m[r][1]))),		\
+					VF_MUL ((Z), VF_SET1 (pCtx->m[r][2]))),				\
+			VF_SET1 (pCtx->m[r][3]))
+
+/*
+// Normals: (x * n0 + y * n1) + z * n2
+*/
+#define V_NORMAL_ROW(X, Y, Z, r)										\
+	VF_ADD (VF_ADD (VF_MUL ((X), VF_SET1 (pCtx->n[r][0])),				\
+					VF_MUL ((Y), VF_SET1 (pCtx->n[r][1]))),				\
+			VF_MUL ((Z), VF_SET1 (pCtx->n[r][2])))
+
+static MESHXFORM_TARGET void MESHXFORM_ALL (const COMPILED_MESH_STRUCT *pC,
+											int nFirst,
+											MESHXFORMLANES *pLanes,
+											const MESHXFORMCONTEXT *pCtx)
+{
+	VF	X, Y, Z, Xws, Yws, Zws, InvZ, Xss, Yss;
+
+	X = VF_LOAD (pC->pfX + nFirst);
+	Y = VF_LOAD (pC->pfY + nFirst);
+	Z = VF_LOAD (pC->pfZ + nFirst);
+
+	Xws = V_XFORM_ROW (X, Y, Z, 0);
+	Yws = V_XFORM_ROW (X, Y, Z, 1);
+	Zws = V_XFORM_ROW (X, Y, Z, 2);
+
+	VF_STORE (pLanes->fWorld[0], Xws);
+	VF_STORE (pLanes->fWorld[1], Yws);
+	VF_STORE (pLanes->fWorld[2], Zws);
+
+	InvZ = VF_DIV (VF_SET1 (1.0f), Zws);
+
+	Xss = VF_ADD (VF_MUL (VF_MUL (VF_SET1 (pCtx->SxDash), Xws), InvZ),
+				  VF_SET1 (pCtx->OxDash));
+	Yss = VF_ADD (VF_MUL (VF_MUL (VF_SET1 (pCtx->SyDash), Yws), InvZ),
+				  VF_SET1 (pCtx->OyDash));
+
+	VF_STORE (pLanes->fScreen[0], Xss);
+	VF_STORE (pLanes->fScreen[1], Yss);
+
+	VI_STORE (pLanes->nRegion[0],
+			  VF_TOI (VF_ADD (VF_MUL (Xss, VF_SET1 (pCtx->fRegionXScale)),
+							  VF_SET1 (pCtx->fRoundRegionX))));
+	VI_STORE (pLanes->nRegion[1], VF_TOI (Yss));
+}
+
+static MESHXFORM_TARGET void MESHXFORM_PARTLY (const COMPILED_MESH_STRUCT *pC,
+											   int nFirst,
+											   MESHXFORMLANES *pLanes,
+											   const MESHXFORMCONTEXT *pCtx)
+{
+	VF	X, Y, Z, Xws, Yws, Zws, InvZ, Xss, Yss;
+	VI	Region, First, Last, mLow, mHigh, Flags, ZFlags, mZ;
+
+	X = VF_LOAD (pC->pfX + nFirst);
+	Y = VF_LOAD (pC->pfY + nFirst);
+	Z = VF_LOAD (pC->pfZ + nFirst);
+
+	Xws = V_XFORM_ROW (X, Y, Z, 0);
+	Yws = V_XFORM_ROW (X, Y, Z, 1);
+	Zws = V_XFORM_ROW (X, Y, Z, 2);
+
+	VF_STORE (pLanes->fWorld[0], Xws);
+	VF_STORE (pLanes->fWorld[1], Yws);
+	VF_STORE (pLanes->fWorld[2], Zws);
+
+	/*
+	// In front of the foreground plane: test against the sides of the
+	// viewing pyramid instead of projecting
+	*/
+	mZ = VF_TO_VI (VF_LT (Zws, VF_SET1 (pCtx->foregroundDistance)));
+
+	ZFlags = VI_SET1 (CLIPPED_Z);
+	ZFlags = VI_OR (ZFlags, VI_AND (VI_SET1 (CLIPPED_MINUS_X),
+		VF_TO_VI (VF_LT (Xws, VF_MUL (VF_SET1 (pCtx->fViewportMinX), Zws)))));
+	ZFlags = VI_OR (ZFlags, VI_AND (VI_SET1 (CLIPPED_PLUS_X),
+		VF_TO_VI (VF_LT (VF_MUL (VF_SET1 (pCtx->fViewportMaxX), Zws), Xws))));
+	ZFlags = VI_OR (ZFlags, VI_AND (VI_SET1 (CLIPPED_MINUS_Y),
+		VF_TO_VI (VF_LT (Yws, VF_MUL (VF_SET1 (pCtx->fViewportMinY), Zws)))));
+	ZFlags = VI_OR (ZFlags, VI_AND (VI_SET1 (CLIPPED_PLUS_Y),
+		VF_TO_VI (VF_LT (VF_MUL (VF_SET1 (pCtx->fViewportMaxY), Zws), Yws))));
+
+	/*
+	// Otherwise project and clamp the regions. The divide is done for
+	// every lane; the Z clipped ones are thrown away.
+	*/
+	InvZ = VF_DIV (VF_SET1 (1.0f), Zws);
+
+	Xss = VF_ADD (VF_MUL (VF_MUL (VF_SET1 (pCtx->SxDash), Xws), InvZ),
+				  VF_SET1 (pCtx->OxDash));
+	Yss = VF_ADD (VF_MUL (VF_MUL (VF_SET1 (pCtx->SyDash), Yws), InvZ),
+				  VF_SET1 (pCtx->OyDash));
+
+	VF_STORE (pLanes->fScreen[0], Xss);
+	VF_STORE (pLanes->fScreen[1], Yss);
+
+	Region = VF_TOI (VF_ADD (VF_MUL (Xss, VF_SET1 (pCtx->fRegionXScale)),
+							 VF_SET1 (pCtx->fRoundRegionX)));
+	First = VI_SET1 (pCtx->FirstXRegion);
+	Last  = VI_SET1 (pCtx->LastXRegion);
+
+	mLow  = VI_GT (First, Region);
+	mHigh = VI_GT (Region, Last);
+
+	VI_STORE (pLanes->nRegion[0], VI_MIN (VI_MAX (Region, First), Last));
+
+	Flags = VI_OR (VI_AND (mLow, VI_SET1 (CLIPPED_MINUS_X)),
+				   VI_AND (mHigh, VI_SET1 (CLIPPED_PLUS_X)));
+
+	/* The first Y region is the top of the viewport - max Y */
+	Region = VF_TOI (Yss);
+	First = VI_SET1 (pCtx->FirstYRegionExact);
+	Last  = VI_SET1 (pCtx->LastYRegionExact);
+
+	mLow  = VI_GT (First, Region);
+	mHigh = VI_GT (Region, Last);
+
+	VI_STORE (pLanes->nRegion[1], VI_MIN (VI_MAX (Region, First), Last));
+
+	Flags = VI_OR (Flags, VI_OR (VI_AND (mLow, VI_SET1 (CLIPPED_PLUS_Y)),
+								 VI_AND (mHigh, VI_SET1 (CLIPPED_MINUS_Y))));
+
+	VI_STORE (pLanes->Flags, VI_SEL (mZ, ZFlags, Flags));
+}
+
+static MESHXFORM_TARGET void MESHXFORM_PLANES (const COMPILED_MESH_STRUCT *pC,
+											   int nFirst,
+											   MESHPLANELANES *pLanes,
+											   const MESHXFORMCONTEXT *pCtx)
+{
+	VF	X, Y, Z, NX, NY, NZ;
+
+	X = VF_LOAD (pC->pfPlaneNX + nFirst);
+	Y = VF_LOAD (pC->pfPlaneNY + nFirst);
+	Z = VF_LOAD (pC->pfPlaneNZ + nFirst);
+
+	NX = V_NORMAL_ROW (X, Y, Z, 0);
+	NY = V_NORMAL_ROW (X, Y, Z, 1);
+	NZ = V_NORMAL_ROW (X, Y, Z, 2);
+
+	VF_STORE (pLanes->fNormal[0], NX);
+	VF_STORE (pLanes->fNormal[1], NY);
+	VF_STORE (pLanes->fNormal[2], NZ);
+
+	/*
+	// D = DotProd (normal, world position of the plane's vertex)
+	*/
+	VF_STORE (pLanes->fD,
+			  VF_ADD (VF_ADD (VF_MUL (NX, VF_LOAD (pLanes->fRep[0])),
+							  VF_MUL (NY, VF_LOAD (pLanes->fRep[1]))),
+					  VF_MUL (NZ, VF_LOAD (pLanes->fRep[2]))));
+}
+
+#undef V_XFORM_ROW
+#undef V_NORMAL_ROW
+
+/*------------------------------- End of File -------------------------------*/
@@ -0,0 +1,241 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rnmsimd.c,v $
+Title           :   Vector compiled mesh transforms
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   SSE2 and AVX2 versions of the vertex and plane
+					transforms rnmesh.c does on a compiled mesh. See
+					rnmsimd.h.
+
+					The kernel bodies are in rnmkern.h and are built once
+					per instruction set, the same way as the triangle setup
+					kernels in dtrisimd.c: gcc (and clang) on x86 build
+					every kernel with the target attribute and ask the CPU
+					at run time, other compilers only get the kernels their
+					own flags allow.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rnmsimd.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_RNMSIMD
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "dlnodes.h"
+#include "pvrosapi.h"
+#include "profile.h"
+#include "rnmsimd.h"
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+	#define MESHXFORM_GCC_X86	1
+#else
+	#define MESHXFORM_GCC_X86	0
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define MESHXFORM_SSE2		1
+	#define MESHXFORM_HAS_SSE2	TRUE
+#elif MESHXFORM_GCC_X86
+	#define MESHXFORM_SSE2		1
+	#define MESHXFORM_HAS_SSE2	__builtin_cpu_supports ("sse2")
+#else
+	#define MESHXFORM_SSE2		0
+#endif
+
+#if defined (__AVX2__)
+	#define MESHXFORM_AVX2		1
+	#define MESHXFORM_HAS_AVX2	TRUE
+#elif MESHXFORM_GCC_X86
+	#define MESHXFORM_AVX2		1
+	#define MESHXFORM_HAS_AVX2	__builtin_cpu_supports ("avx2")
+#else
+	#define MESHXFORM_AVX2		0
+#endif
+
+#if MESHXFORM_MAX_LANES > COMPILED_MESH_PAD
+	#error The compiled mesh arrays are not padded for the widest kernel
+#endif
+
+/*
+// ============================================================================
+// 								SSE2 (4 LANES)
+// ============================================================================
+*/
+
+#if MESHXFORM_SSE2
+
+#include <emmintrin.h>
+
+#if defined (__SSE2__) || !MESHXFORM_GCC_X86
+	#define MESHXFORM_TARGET
+#else
+	#define MESHXFORM_TARGET	__attribute__ ((target ("sse2")))
+#endif
+
+#define MESHXFORM_ALL		MeshXformAllSSE2
+#define MESHXFORM_PARTLY	MeshXformPartlySSE2
+#define MESHXFORM_PLANES	MeshXformPlanesSSE2
+#define MESHXFORM_LANES		4
+
+#define VF				__m128
+#define VI				__m128i
+
+#define VF_SET1(x)		_mm_set1_ps (x)
+#define VF_LOAD(p)		_mm_loadu_ps (p)
+#define VF_STORE(p,a)	_mm_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm_add_ps ((a), (b))
+#define VF_MUL(a,b)		_mm_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm_div_ps ((a), (b))
+#define VF_LT(a,b)		_mm_cmplt_ps ((a), (b))
+#define VF_TOI(a)		_mm_cvttps_epi32 (a)
+#define VF_TO_VI(a)		_mm_castps_si128 (a)
+
+#define VI_SET1(x)		_mm_set1_epi32 (x)
+#define VI_STORE(p,a)	_mm_storeu_si128 ((__m128i *) (p), (a))
+#define VI_AND(a,b)		_mm_and_si128 ((a), (b))
+#define VI_OR(a,b)		_mm_or_si128 ((a), (b))
+#define VI_GT(a,b)		_mm_cmpgt_epi32 ((a), (b))
+
+/* No packed 32 bit min and max before SSE4.1 */
+#define VI_SEL(m,a,b)	_mm_or_si128 (_mm_and_si128 ((m), (a)), _mm_andnot_si128 ((m), (b)))
+#define VI_MAX(a,b)		VI_SEL (_mm_cmpgt_epi32 ((a), (b)), (a), (b))
+#define VI_MIN(a,b)		VI_SEL (_mm_cmpgt_epi32 ((a), (b)), (b), (a))
+
+#include "rnmkern.h"
+
+#undef MESHXFORM_TARGET
+#undef MESHXFORM_ALL
+#undef MESHXFORM_PARTLY
+#undef MESHXFORM_PLANES
+#undef MESHXFORM_LANES
+#undef VF
+#undef VI
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_LT
+#undef VF_TOI
+#undef VF_TO_VI
+#undef VI_SET1
+#undef VI_STORE
+#undef VI_AND
+#undef VI_OR
+#undef VI_GT
+#undef VI_SEL
+#undef VI_MAX
+#undef VI_MIN
+
+#endif /* MESHXFORM_SSE2 */
+
+/*
+// ============================================================================
+// 								AVX2 (8 LANES)
+// ============================================================================
+*/
+
+#if MESHXFORM_AVX2
+
+#include <immintrin.h>
+
+#if defined (__AVX2__) || !MESHXFORM_GCC_X86
+	#define MESHXFORM_TARGET
+#else
+	#define MESHXFORM_TARGET	__attribute__ ((target ("avx2")))
+#endif
+
+#define MESHXFORM_ALL		MeshXformAllAVX2
+#define MESHXFORM_PARTLY	MeshXformPartlyAVX2
+#define MESHXFORM_PLANES	MeshXformPlanesAVX2
+#define MESHXFORM_LANES		8
+
+#define VF				__m256
+#define VI				__m256i
+
+#define VF_SET1(x)		_mm256_set1_ps (x)
+#define VF_LOAD(p)		_mm256_loadu_ps (p)
+#define VF_STORE(p,a)	_mm256_storeu_ps ((p), (a))
+#define VF_ADD(a,b)		_mm256_add_ps ((a), (b))
+#define VF_MUL(a,b)		_mm256_mul_ps ((a), (b))
+#define VF_DIV(a,b)		_mm256_div_ps ((a), (b))
+#define VF_LT(a,b)		_mm256_cmp_ps ((a), (b), _CMP_LT_OS)
+#define VF_TOI(a)		_mm256_cvttps_epi32 (a)
+#define VF_TO_VI(a)		_mm256_castps_si256 (a)
+
+#define VI_SET1(x)		_mm256_set1_epi32 (x)
+#define VI_STORE(p,a)	_mm256_storeu_si256 ((__m256i *) (p), (a))
+#define VI_AND(a,b)		_mm256_and_si256 ((a), (b))
+#define VI_OR(a,b)		_mm256_or_si256 ((a), (b))
+#define VI_GT(a,b)		_mm256_cmpgt_epi32 ((a), (b))
+#define VI_SEL(m,a,b)	_mm256_blendv_epi8 ((b), (a), (m))
+#define VI_MAX(a,b)		_mm256_max_epi32 ((a), (b))
+#define VI_MIN(a,b)		_mm256_min_epi32 ((a), (b))
+
+#include "rnmkern.h"
+
+#endif /* MESHXFORM_AVX2 */
+
+/*
+// ============================================================================
+// 								DISPATCH
+// ============================================================================
+*/
+
+int MeshXformSelect (MESHXFORMFNS *pFns)
+{
+	int nMaxLanes;
+
+	nMaxLanes = SglReadPrivateProfileInt ("Mesh", "SimdLanes",
+										  MESHXFORM_MAX_LANES, "sgl.ini");
+
+	pFns->pfnAllVisible = NULL;
+	pFns->pfnPartlyVisible = NULL;
+	pFns->pfnPlanes = NULL;
+
+	#if MESHXFORM_GCC_X86
+		__builtin_cpu_init ();
+	#endif
+
+	#if MESHXFORM_AVX2
+
+		if ((nMaxLanes >= 8) && MESHXFORM_HAS_AVX2)
+		{
+			pFns->pfnAllVisible = MeshXformAllAVX2;
+			pFns->pfnPartlyVisible = MeshXformPartlyAVX2;
+			pFns->pfnPlanes = MeshXformPlanesAVX2;
+			return (8);
+		}
+
+	#endif
+
+	#if MESHXFORM_SSE2
+
+		if ((nMaxLanes >= 4) && MESHXFORM_HAS_SSE2)
+		{
+			pFns->pfnAllVisible = MeshXformAllSSE2;
+			pFns->pfnPartlyVisible = MeshXformPartlySSE2;
+			pFns->pfnPlanes = MeshXformPlanesSSE2;
+			return (4);
+		}
+
+	#endif
+
+	return (1);
+}
+
+/* rnmsimd.c */
@@ -0,0 +1,123 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: rnmsimd.h,v $
+Title           :   RNMSIMD.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Vector transforms for the compiled form of a mesh (see
+					COMPILED_MESH_STRUCT in dlmesh.h). A kernel takes a
+					group of vertices, or of face planes, straight out of
+					the compiled arrays and works them out a lane per
+					vertex or plane, in the same order as the one at a time
+					code in rnmesh.c. The caller copies the lanes into the
+					TRANSVERTEX array and keeps any running totals.
+
+					The widest kernels the CPU can run are picked at run
+					time. Builds whose compiler has no SSE2 have none and
+					keep the one at a time loops.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: rnmsimd.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __RNMSIMD_H__
+#define __RNMSIMD_H__
+
+/* Widest group any kernel handles; no more than COMPILED_MESH_PAD */
+#define MESHXFORM_MAX_LANES	8
+
+/*
+// Everything the kernels read besides the compiled arrays, gathered once
+// per mesh so the kernels need no globals.
+*/
+typedef struct tagMESHXFORMCONTEXT
+{
+	float	m[3][4];			/* model to world */
+	float	n[3][3];			/* the same for plane normals */
+
+	float	SxDash, SyDash, OxDash, OyDash;
+	float	fRegionXScale;
+	float	fRoundRegionX;		/* FIX_ROUNDING_PROBLEM */
+
+	/* Only read by the partly visible kernel */
+	float	foregroundDistance;
+	float	fViewportMinX, fViewportMaxX, fViewportMinY, fViewportMaxY;
+	int		FirstXRegion, LastXRegion;
+	int		FirstYRegionExact, LastYRegionExact;
+
+} MESHXFORMCONTEXT;
+
+/*
+// One group of vertices in structure of arrays form, laid out as the
+// matching TRANSVERTEX fields. The all visible kernel leaves Flags alone.
+// The partly visible one only sets the world position and Flags of a
+// lane that is in front of the foreground plane (CLIPPED_Z); the rest of
+// that lane is rubbish.
+*/
+typedef struct tagMESHXFORMLANES
+{
+	float	fWorld[3][MESHXFORM_MAX_LANES];
+	float	fScreen[2][MESHXFORM_MAX_LANES];
+	int		nRegion[2][MESHXFORM_MAX_LANES];
+	int		Flags[MESHXFORM_MAX_LANES];
+
+} MESHXFORMLANES;
+
+/*
+// One group of face planes. The caller fills fRep with the world position
+// of each plane's vertex (pnPlaneVertex); the kernel fills in the rest.
+*/
+typedef struct tagMESHPLANELANES
+{
+	float	fRep[3][MESHXFORM_MAX_LANES];
+	float	fNormal[3][MESHXFORM_MAX_LANES];
+	float	fD[MESHXFORM_MAX_LANES];
+
+} MESHPLANELANES;
+
+typedef void (* MESHXFORMFN)(const COMPILED_MESH_STRUCT *pC, int nFirst,
+							 MESHXFORMLANES *pLanes,
+							 const MESHXFORMCONTEXT *pCtx);
+
+typedef void (* MESHPLANEFN)(const COMPILED_MESH_STRUCT *pC, int nFirst,
+							 MESHPLANELANES *pLanes,
+							 const MESHXFORMCONTEXT *pCtx);
+
+typedef struct tagMESHXFORMFNS
+{
+	MESHXFORMFN		pfnAllVisible;
+	MESHXFORMFN		pfnPartlyVisible;
+	MESHPLANEFN		pfnPlanes;
+
+} MESHXFORMFNS;
+
+/*===========================================
+ * Function:	MeshXformSelect
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Picks the widest kernels the CPU supports, unless the
+ *				[Mesh] SimdLanes entry in sgl.ini asks for narrower ones
+ *				(1 turns the kernels off).
+ *
+ * Params:		MESHXFORMFNS *pFns: receives the kernels
+ *
+ * Return:		Lanes the kernels handle per call, or 1 if there are none.
+ *========================================================================================*/
+int MeshXformSelect (MESHXFORMFNS *pFns);
+
+#endif /* __RNMSIMD_H__ */
+
+/*------------------------------- End of File -------------------------------*/
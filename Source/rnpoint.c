@@ -218,12 +218,12 @@ void RnProcessPointSwitchNode(POINT_SWITCH_NODE_STRUCT *pSwitchNode,
 	// traversal of a child list that preserved the state.
 	// OPTIMISATION ? STORE THE POINT'S NAME DIRECTLY IN THE ENTRY STRUCTURE
 	*/
-	ASSERT(pSwitchNode->n16_point_name >= 0);
-	ASSERT(pSwitchNode->n16_point_name != NM_INVALID_NAME);
+	ASSERT(pSwitchNode->n32_point_name >= 0);
+	ASSERT(pSwitchNode->n32_point_name != NM_INVALID_NAME);
 
 	while (nEntry < pCollisionState->num_pnts &&
-	  pCollisionState->pnts[nEntry].p_its_node->node_hdr.n16_name !=
-	  pSwitchNode->n16_point_name)
+	  pCollisionState->pnts[nEntry].p_its_node->node_hdr.n32_name !=
+	  pSwitchNode->n32_point_name)
 	    nEntry++;
 
 	/*
@@ -349,9 +349,9 @@ void RnTestPointsWithTransformedPlanes(
 
 					/* OPTIMISATION: MAKE NM_INVALID_NAME AND SGL_ANON_OBJECT ONE
 					   AND THE SAME TO AVOID THE COMPARISON */
-	                pPointNode->n16ObjectName =
-					  pConvexNode->node_hdr.n16_name == NM_INVALID_NAME ?
-					  SGL_ANON_OBJECT : pConvexNode->node_hdr.n16_name;
+	                pPointNode->n32ObjectName =
+					  pConvexNode->node_hdr.n32_name == NM_INVALID_NAME ?
+					  SGL_ANON_OBJECT : pConvexNode->node_hdr.n32_name;
 	
 					pPointNode->n16ObjectPlane = nClosestPlane;
 
@@ -361,7 +361,7 @@ void RnTestPointsWithTransformedPlanes(
 					pPointNode->fD = pTransformedPlanes[nClosestPlane].d;
 
 					/*
-					// UNFINISHED: Set pPointNode->pn16Path and
+					// UNFINISHED: Set pPointNode->pn32Path and
 					// pPointNode->n16PathLength properly.
 					*/
 					pPointNode->n16PathLength = 0;
@@ -499,9 +499,9 @@ void RnTestPointsWithLocalPlanes(
 
 					/* OPTIMISATION: MAKE NM_INVALID_NAME AND SGL_ANON_OBJECT ONE
 					   AND THE SAME TO AVOID THE COMPARISON */
-					pPointNode->n16ObjectName =
-					  pConvexNode->node_hdr.n16_name == NM_INVALID_NAME ?
-					  SGL_ANON_OBJECT : pConvexNode->node_hdr.n16_name;
+					pPointNode->n32ObjectName =
+					  pConvexNode->node_hdr.n32_name == NM_INVALID_NAME ?
+					  SGL_ANON_OBJECT : pConvexNode->node_hdr.n32_name;
 
 					pPointNode->n16ObjectPlane = nClosestPlane;
 
@@ -511,7 +511,7 @@ void RnTestPointsWithLocalPlanes(
 					  pPlaneData[nClosestPlane].normal);
 
 					/*
-					// UNFINISHED: Set pPointNode->pn16Path and
+					// UNFINISHED: Set pPointNode->pn32Path and
 					// pPointNode->n16PathLength properly.
 					*/
 					pPointNode->n16PathLength = 0;
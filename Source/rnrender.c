@@ -775,6 +775,12 @@
 
 #include "pvrosapi.h"
 #include "parmbuff.h"
+#include "sglmem.h"
+#include "profile.h"
+#include "frmpipe.h"
+#include "txmops.h"
+
+#include <string.h>
 
 #if defined(MIDAS_ARCADE)
 #include <time.h>
@@ -1042,6 +1048,325 @@ void DumpSabreAndTexas(long SabreRegionInfoStart,
 
 #endif /* #if DUMP_PARAMS */
 
+/*
+// ============================================================================
+// 							RETAINED FRAMES
+// ============================================================================
+//
+// A frame built by sgl_render depends only on the display list (and the
+// textures, devices and viewports it refers to), the viewport and camera
+// it was rendered with, and the projection set up from them. Display list
+// editing routines bump dlUserGlobals.u32EditCount (see DlMarkEdited), so
+// when none of these have changed the last frame's parameters can simply
+// be copied into the new buffers and sent again, without the traversal.
+// The key holds the camera, viewport and device fields the projection is
+// set up from, plus the region layout read back from the hardware.
+//
+// Frames that use cached textures are never reused: the texture callback
+// has to see every frame, and what it loads may move texture memory.
+//
+// The parameters are kept in our own memory, as the hardware buffers are
+// handed back after each render and may be reused by SGL-Lite. To avoid
+// the copy for scenes that change every frame, a frame is only kept once
+// it has been built twice in a row with nothing changed.
+//
+// This is whole frame reuse only. Any edit means the whole display list
+// is traversed and packed again: there are no per node dirty flags, and
+// the parameters of unchanged subtrees are not kept. Objects from every
+// subtree share the region lists, the translucent ordering, the light
+// and shadow state and the TSP addresses in the ISP words, so keeping
+// them apart needs changes to how the traversal packs parameters.
+*/
+
+typedef struct
+{
+	/* What the frame was built from */
+	int			nViewportOrDevice;
+	int			nCameraOrList;
+	sgl_uint32	u32EditCount;
+
+	/* The fields RnSetupProjectionMatrix works from */
+	const CAMERA_NODE_STRUCT *pCamera;
+	float		fZoom;
+	float		fForegroundDist, fInvBackgroundDist;
+	float		fInvLogFogFraction;
+	int			nLogFogPower;
+	int			nLeft, nTop, nRight, nBottom;
+	float		fCamLeft, fCamTop, fCamRight, fCamBottom;
+	int			nDevXDim, nDevYDim;
+	DEVICE_REGION_INFO_STRUCT RegionInfo;
+	sgl_uint32	regionMask[MAX_Y_REGIONS];
+
+	#if PCX2 || PCX2_003
+	sgl_colour	FastFogColour;
+	#endif
+
+	/* TRUE if the key was seen on the last build */
+	sgl_bool	bKeyValid;
+
+	/* TRUE if the parameters below hold that frame */
+	sgl_bool	bParamsValid;
+
+	/* What the traversal leaves behind that the render needs */
+	sgl_texture_filter_type eFilterType;
+	sgl_bool	bDithering;
+	#if !WIN32
+	sgl_uint32	SabreRegionInfoStart;
+	#endif
+	#if ISPTSP
+	int			nNumRegionsRendered;
+	#endif
+
+	/* Copies of the ISP, TSP and region parameters */
+	sgl_uint32	*pParams[3];
+	sgl_uint32	uParamsPos[3];
+	sgl_uint32	uParamsSize[3];
+
+} RETAINED_FRAME_STRUCT;
+
+static RETAINED_FRAME_STRUCT RetainedFrame;
+
+/* -1 until read from sgl.ini */
+static int nRetainFrames = -1;
+
+/**************************************************************************
+ * Function Name  : SetupRetainedKey
+ * Inputs         : pCamera - camera the projection was set up from
+ *					pViewport - viewport it was set up for
+ *					pProjMat - the projection just set up
+ * Outputs        : pKey - the camera and viewport part of the key
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Copies out the fields the projection depends on.
+ **************************************************************************/
+static void SetupRetainedKey (RETAINED_FRAME_STRUCT *pKey,
+							  const CAMERA_NODE_STRUCT *pCamera,
+							  const VIEWPORT_NODE_STRUCT *pViewport,
+							  const PROJECTION_MATRIX_STRUCT *pProjMat)
+{
+	pKey->pCamera = pCamera;
+	pKey->fZoom = pCamera->zoom_factor;
+	pKey->fForegroundDist = pCamera->foreground_dist;
+	pKey->fInvBackgroundDist = pCamera->inv_background_dist;
+	pKey->fInvLogFogFraction = pCamera->invlogfogFraction;
+	pKey->nLogFogPower = pCamera->logfogPower;
+
+	pKey->nLeft = pViewport->Left;
+	pKey->nTop = pViewport->Top;
+	pKey->nRight = pViewport->Right;
+	pKey->nBottom = pViewport->Bottom;
+	pKey->fCamLeft = pViewport->fCamLeft;
+	pKey->fCamTop = pViewport->fCamTop;
+	pKey->fCamRight = pViewport->fCamRight;
+	pKey->fCamBottom = pViewport->fCamBottom;
+	pKey->nDevXDim = pViewport->pParentDevice->xDim;
+	pKey->nDevYDim = pViewport->pParentDevice->yDim;
+
+	/* Read back from the hardware by RnSetupProjectionMatrix */
+	pKey->RegionInfo = pProjMat->RegionInfo;
+
+	memcpy (pKey->regionMask, pViewport->regionMask, sizeof (pKey->regionMask));
+}
+
+/**************************************************************************
+ * Function Name  : RetainedKeyMatches
+ * Inputs         : pKey - what the frame about to be built depends on
+ * Outputs        : 
+ * Returns        : TRUE if the last frame was built from the same
+ * Global Used    : RetainedFrame
+ * Description    : Compares pKey with what the last frame was built from.
+ **************************************************************************/
+static sgl_bool RetainedKeyMatches (const RETAINED_FRAME_STRUCT *pKey)
+{
+	if (!RetainedFrame.bKeyValid ||
+		(RetainedFrame.nViewportOrDevice != pKey->nViewportOrDevice) ||
+		(RetainedFrame.nCameraOrList != pKey->nCameraOrList) ||
+		(RetainedFrame.u32EditCount != pKey->u32EditCount))
+	{
+		return (FALSE);
+	}
+
+	if ((RetainedFrame.pCamera != pKey->pCamera) ||
+		(RetainedFrame.fZoom != pKey->fZoom) ||
+		(RetainedFrame.fForegroundDist != pKey->fForegroundDist) ||
+		(RetainedFrame.fInvBackgroundDist != pKey->fInvBackgroundDist) ||
+		(RetainedFrame.fInvLogFogFraction != pKey->fInvLogFogFraction) ||
+		(RetainedFrame.nLogFogPower != pKey->nLogFogPower))
+	{
+		return (FALSE);
+	}
+
+	if ((RetainedFrame.nLeft != pKey->nLeft) ||
+		(RetainedFrame.nTop != pKey->nTop) ||
+		(RetainedFrame.nRight != pKey->nRight) ||
+		(RetainedFrame.nBottom != pKey->nBottom) ||
+		(RetainedFrame.fCamLeft != pKey->fCamLeft) ||
+		(RetainedFrame.fCamTop != pKey->fCamTop) ||
+		(RetainedFrame.fCamRight != pKey->fCamRight) ||
+		(RetainedFrame.fCamBottom != pKey->fCamBottom) ||
+		(RetainedFrame.nDevXDim != pKey->nDevXDim) ||
+		(RetainedFrame.nDevYDim != pKey->nDevYDim))
+	{
+		return (FALSE);
+	}
+
+	#if PCX2 || PCX2_003
+	if (memcmp (RetainedFrame.FastFogColour, pKey->FastFogColour,
+				sizeof (sgl_colour)))
+	{
+		return (FALSE);
+	}
+	#endif
+
+	/* All ints, so there is no padding to compare */
+	if (memcmp (&RetainedFrame.RegionInfo, &pKey->RegionInfo,
+				sizeof (DEVICE_REGION_INFO_STRUCT)))
+	{
+		return (FALSE);
+	}
+
+	return (memcmp (RetainedFrame.regionMask, pKey->regionMask,
+					sizeof (RetainedFrame.regionMask)) == 0);
+}
+
+/**************************************************************************
+ * Function Name  : SetRetainedKey
+ * Inputs         : pKey - what the frame just built depends on
+ * Outputs        : 
+ * Returns        : TRUE if it was built from the same as the last one
+ * Global Used    : RetainedFrame
+ * Description    : Records the key for the frame just built. The
+ *					parameters of any earlier frame are dropped.
+ **************************************************************************/
+static sgl_bool SetRetainedKey (const RETAINED_FRAME_STRUCT *pKey)
+{
+	sgl_bool bSame = RetainedKeyMatches (pKey);
+
+	RetainedFrame.nViewportOrDevice = pKey->nViewportOrDevice;
+	RetainedFrame.nCameraOrList = pKey->nCameraOrList;
+	RetainedFrame.u32EditCount = pKey->u32EditCount;
+
+	RetainedFrame.pCamera = pKey->pCamera;
+	RetainedFrame.fZoom = pKey->fZoom;
+	RetainedFrame.fForegroundDist = pKey->fForegroundDist;
+	RetainedFrame.fInvBackgroundDist = pKey->fInvBackgroundDist;
+	RetainedFrame.fInvLogFogFraction = pKey->fInvLogFogFraction;
+	RetainedFrame.nLogFogPower = pKey->nLogFogPower;
+
+	RetainedFrame.nLeft = pKey->nLeft;
+	RetainedFrame.nTop = pKey->nTop;
+	RetainedFrame.nRight = pKey->nRight;
+	RetainedFrame.nBottom = pKey->nBottom;
+	RetainedFrame.fCamLeft = pKey->fCamLeft;
+	RetainedFrame.fCamTop = pKey->fCamTop;
+	RetainedFrame.fCamRight = pKey->fCamRight;
+	RetainedFrame.fCamBottom = pKey->fCamBottom;
+	RetainedFrame.nDevXDim = pKey->nDevXDim;
+	RetainedFrame.nDevYDim = pKey->nDevYDim;
+
+	RetainedFrame.RegionInfo = pKey->RegionInfo;
+
+	memcpy (RetainedFrame.regionMask, pKey->regionMask,
+			sizeof (RetainedFrame.regionMask));
+
+	#if PCX2 || PCX2_003
+	memcpy (RetainedFrame.FastFogColour, pKey->FastFogColour,
+			sizeof (sgl_colour));
+	#endif
+
+	RetainedFrame.bKeyValid = TRUE;
+	RetainedFrame.bParamsValid = FALSE;
+
+	return (bSame);
+}
+
+/**************************************************************************
+ * Function Name  : RetainParams
+ * Inputs         : pProjMat - projection matrix after the traversal
+ * Outputs        : 
+ * Returns        : 
+ * Global Used    : RetainedFrame, PVRParamBuffs
+ * Description    : Copies the parameters just built. If there is not the
+ *					memory for them, the frame is just not kept.
+ **************************************************************************/
+static void RetainParams (const PROJECTION_MATRIX_STRUCT *pProjMat)
+{
+	int k;
+
+	for (k = 0; k < 3; k++)
+	{
+		sgl_uint32 uPos = PVRParamBuffs[k].uBufferPos;
+
+		if (uPos > RetainedFrame.uParamsSize[k])
+		{
+			sgl_uint32 *pNew;
+
+			pNew = SGLRealloc (RetainedFrame.pParams[k], uPos * sizeof (sgl_uint32));
+
+			if (pNew == NULL)
+			{
+				DPF ((DBG_WARNING, "RetainParams: no memory to keep frame"));
+				return;
+			}
+
+			RetainedFrame.pParams[k] = pNew;
+			RetainedFrame.uParamsSize[k] = uPos;
+		}
+
+		if (uPos)
+		{
+			memcpy (RetainedFrame.pParams[k], PVRParamBuffs[k].pBuffer,
+					uPos * sizeof (sgl_uint32));
+		}
+
+		RetainedFrame.uParamsPos[k] = uPos;
+	}
+
+	RetainedFrame.eFilterType = pProjMat->eFilterType;
+	RetainedFrame.bDithering = pProjMat->bDithering;
+
+	RetainedFrame.bParamsValid = TRUE;
+}
+
+/**************************************************************************
+ * Function Name  : RestoreParams
+ * Inputs         : 
+ * Outputs        : pProjMat - the traversal's settings are restored
+ * Returns        : TRUE if the kept frame is now in the parameter buffers
+ * Global Used    : RetainedFrame, PVRParamBuffs
+ * Description    : Copies the kept frame into the buffers just assigned,
+ *					unless it no longer fits in them.
+ **************************************************************************/
+static sgl_bool RestoreParams (PROJECTION_MATRIX_STRUCT *pProjMat)
+{
+	int k;
+
+	for (k = 0; k < 3; k++)
+	{
+		if (RetainedFrame.uParamsPos[k] > PVRParamBuffs[k].uBufferLimit)
+		{
+			return (FALSE);
+		}
+	}
+
+	for (k = 0; k < 3; k++)
+	{
+		if (RetainedFrame.uParamsPos[k])
+		{
+			memcpy (PVRParamBuffs[k].pBuffer, RetainedFrame.pParams[k],
+					RetainedFrame.uParamsPos[k] * sizeof (sgl_uint32));
+		}
+
+		PVRParamBuffs[k].uBufferPos = RetainedFrame.uParamsPos[k];
+	}
+
+	pProjMat->eFilterType = RetainedFrame.eFilterType;
+	pProjMat->bDithering = RetainedFrame.bDithering;
+
+	return (TRUE);
+}
+
+
 /**************************************************************************
  * Function Name  : sgl_render
  * Inputs         : 
@@ -1085,6 +1410,9 @@ extern void CALL_CONV sgl_render( const  int viewport_or_device,
 	#if ISPTSP
 	int nNumRegionsRendered;
 	#endif
+
+	RETAINED_FRAME_STRUCT Key;
+	sgl_bool bReuse = FALSE;
 	
 	SGL_TIME_START(TOTAL_RENDER_TIME);
 	
@@ -1219,6 +1547,42 @@ extern void CALL_CONV sgl_render( const  int viewport_or_device,
 
 	} /*end if else*/
 
+	/*
+	// See if the frame last built can be sent again
+	*/
+	if (nRetainFrames < 0)
+	{
+		nRetainFrames = SglReadPrivateProfileInt ("Render", "RetainFrames",
+												  TRUE, "sgl.ini");
+	}
+
+	if (nRetainFrames)
+	{
+		Key.nViewportOrDevice = viewport_or_device;
+		Key.nCameraOrList = camera_or_list;
+		Key.u32EditCount = dlUserGlobals.u32EditCount;
+
+		SetupRetainedKey (&Key, pCamera, pViewportOrDevice, pProjMat);
+
+		#if PCX2 || PCX2_003
+		memcpy (Key.FastFogColour, cFastFogColour, sizeof (sgl_colour));
+		#endif
+
+		/* The texture callback has to run on every frame */
+		bReuse = RetainedFrame.bParamsValid && (nCachedTextures == 0) &&
+				 RetainedKeyMatches (&Key);
+
+		/*
+		// Nothing has changed, so there is time to tidy texture memory.
+		// If that moves anything the frame has to be built again.
+		*/
+		if (bReuse && CompactTexturesIdle ())
+		{
+			Key.u32EditCount = dlUserGlobals.u32EditCount;
+			bReuse = FALSE;
+		}
+	}
+
 	/*
 	// For optimisation. Reset the region lists structures to be empty
 	*/
@@ -1229,6 +1593,10 @@ extern void CALL_CONV sgl_render( const  int viewport_or_device,
 	while(! HWFinishedRender());
 #endif
 
+	/*
+	// Don't run more than the pipeline depth ahead of the hardware
+	*/
+	FramePipeBeginFrame ();
 	
 	/*
 	// Get parameter memory, if available...
@@ -1245,132 +1613,170 @@ extern void CALL_CONV sgl_render( const  int viewport_or_device,
 	GetParameterSpace(PVRParamBuffs);
 #endif
 
-	/* //////////////////////////////////////////////////
-	/////////////////////////////////////////////////////
-	// Add some "special" objects direct to the parameter
-	// store. THESE SHOULD BE MOVED OUT AND SET UP ONCE ONLY
-	// DURING INTIALISATION (obviously the initial pointers would have
-	// to take account of these).
-	/////////////////////////////////////////////////////
-	////////////////////////////////////////////////// */
-	AddDummyPlanesL (FALSE);
+	if (bReuse)
+	{
+		bReuse = RestoreParams (pProjMat);
+	}
 
-#if PCX2 || PCX2_003
-	/* Fast fogging. Pack a plane for fogging. Only used by PCX2
-	 * Set colour of plane to FOG COLOUR !!!!
-	 */
+	if (bReuse)
 	{
-		sgl_uint32		nCurrentTSPAddr;
+		#if !WIN32
+		SabreRegionInfoStart = RetainedFrame.SabreRegionInfoStart;
+		#endif
 
-		/* Save current TSP index.
-		 */
-		nCurrentTSPAddr = PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos;
+		#if ISPTSP
+		nNumRegionsRendered = RetainedFrame.nNumRegionsRendered;
+		#endif
+	}
+	else
+	{
+		/* //////////////////////////////////////////////////
+		/////////////////////////////////////////////////////
+		// Add some "special" objects direct to the parameter
+		// store. THESE SHOULD BE MOVED OUT AND SET UP ONCE ONLY
+		// DURING INTIALISATION (obviously the initial pointers would have
+		// to take account of these).
+		/////////////////////////////////////////////////////
+		////////////////////////////////////////////////// */
+		AddDummyPlanesL (FALSE);
 
-		/* Tag ID of 2 (4/2) used for fogging.
+#if PCX2 || PCX2_003
+		/* Fast fogging. Pack a plane for fogging. Only used by PCX2
+		 * Set colour of plane to FOG COLOUR !!!!
 		 */
+		{
+			sgl_uint32		nCurrentTSPAddr;
+
+			/* Save current TSP index.
+			 */
+			nCurrentTSPAddr = PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos;
 
-		PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos = 4;
+			/* Tag ID of 2 (4/2) used for fogging.
+			 */
+
+			PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos = 4;
 		
-		/* Pack a flat plane. Need to set colour to fog colour.
-		 */
-		PackTexasFlat (cFastFogColour, FALSE, FALSE);
+			/* Pack a flat plane. Need to set colour to fog colour.
+			 */
+			PackTexasFlat (cFastFogColour, FALSE, FALSE);
 
-		/* Restore the TSP index.
-		 */
-		PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos = nCurrentTSPAddr;
-	}
+			/* Restore the TSP index.
+			 */
+			PVRParamBuffs[PVR_PARAM_TYPE_TSP].uBufferPos = nCurrentTSPAddr;
+		}
 #endif
 
 
-	/* //////////////////////////////////////////////////
-	// Add the background plane - disable fogging on it
-	// jimp: disable shadows as well
-	////////////////////////////////////////////////// */
-	BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+		/* //////////////////////////////////////////////////
+		// Add the background plane - disable fogging on it
+		// jimp: disable shadows as well
+		////////////////////////////////////////////////// */
+		BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
 
 #if PCX2 || PCX2_003
-	PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
-						0.0f);
-						/* pProjMat->f32FixedProjBackDist); */ 
+		PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
+							0.0f);
+							/* pProjMat->f32FixedProjBackDist); */ 
 #else
-	PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
-						0);
-						/* pProjMat->n32FixedProjBackDist); */ 
+		PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
+							0);
+							/* pProjMat->n32FixedProjBackDist); */ 
 #endif
 
-	/*
-	// create a flushing plane ???????
-	// Add the actual background opaque plane.
-	// This is not a flushing plane !!!
-	*/
-	AddRegionOpaqueL(&pProjMat->RegionsRect, BackGroundStart, 1);
+		/*
+		// create a flushing plane ???????
+		// Add the actual background opaque plane.
+		// This is not a flushing plane !!!
+		*/
+		AddRegionOpaqueL(&pProjMat->RegionsRect, BackGroundStart, 1);
  	
-	BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+		BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
 			   
 #if PCX2 || PCX2_003
-	PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
-						-1.0f);
+		PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
+							-1.0f);
 #else
-	PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
-						-64);
+		PackBackgroundPlane( PackTexasFlat(pCamera->backgroundColour, FALSE, FALSE),
+							-64);
 #endif
 
- 	/* !!!! THIS IS ONLY NEEDED FOR THE MIDAS3 (old PVR1) SIMULATOR !!!! */
-	/* Well, I'm not too sure about that (SJF)*/
-	AddFlushingPlaneL(BackGroundStart);
+	 	/* !!!! THIS IS ONLY NEEDED FOR THE MIDAS3 (old PVR1) SIMULATOR !!!! */
+		/* Well, I'm not too sure about that (SJF)*/
+		AddFlushingPlaneL(BackGroundStart);
 
 
-	/* Add translucent flushing plane.
-	 */
-	BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+		/* Add translucent flushing plane.
+		 */
+		BackGroundStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
 						   
 #if PCX2 || PCX2_003
-	PackBackgroundPlane (PackTexasTransparent (FALSE), -1.0f);
+		PackBackgroundPlane (PackTexasTransparent (FALSE), -1.0f);
 #else
-	PackBackgroundPlane (PackTexasTransparent (FALSE), -64);
+		PackBackgroundPlane (PackTexasTransparent (FALSE), -64);
 #endif
-	AddTransFlushingPlaneL (BackGroundStart);
-
-	/* //////////////////////////////////////////////////
-	/////////////////////////////////////////////////////
-	// Traverse the display list
-	/////////////////////////////////////////////////////
-	////////////////////////////////////////////////// */
-	DPF((DBG_MESSAGE, "Calling traverse"));
+		AddTransFlushingPlaneL (BackGroundStart);
+
+		/* //////////////////////////////////////////////////
+		/////////////////////////////////////////////////////
+		// Traverse the display list
+		/////////////////////////////////////////////////////
+		////////////////////////////////////////////////// */
+		DPF((DBG_MESSAGE, "Calling traverse"));
 	
-	#if DO_FPU_PRECISION
+		#if DO_FPU_PRECISION
 
-		SetupFPU ();
+			SetupFPU ();
 
-	#endif
+		#endif
 
-	RnTraverseDisplayList(pList, pCamera);
+		RnTraverseDisplayList(pList, pCamera);
 
-	#if DO_FPU_PRECISION
+		#if DO_FPU_PRECISION
 
-		RestoreFPU ();
+			RestoreFPU ();
 
-	#endif
+		#endif
 
-	/* //////////////////////////////////////////////////
-	// Convert the regions lists to ones understood by Sabre
-	// Remember where the pointer data begins though.
- 	////////////////////////////////////////////////// */
+		/* //////////////////////////////////////////////////
+		// Convert the regions lists to ones understood by Sabre
+		// Remember where the pointer data begins though.
+	 	////////////////////////////////////////////////// */
 
-	#if !WIN32
-	SabreRegionInfoStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
-	#endif
+		#if !WIN32
+		SabreRegionInfoStart = PVRParamBuffs[PVR_PARAM_TYPE_ISP].uBufferPos;
+		#endif
 
-	/*
-	// Convert our internal region lists into the hardware ones, and
-	// at the same time reset the internal region structures
-	*/
-	/* Call optimised routine.
-	 */
-	#if ISPTSP
-	nNumRegionsRendered = 
-	#endif
-	GenerateObjectPtr(&pProjMat->RegionsRect, pViewportOrDevice->regionMask);
+		/*
+		// Convert our internal region lists into the hardware ones, and
+		// at the same time reset the internal region structures
+		*/
+		/* Call optimised routine.
+		 */
+		SGL_TIME_START(GENERATE_TIME);
+
+		#if ISPTSP
+		nNumRegionsRendered = 
+		#endif
+		GenerateObjectPtr(&pProjMat->RegionsRect, pViewportOrDevice->regionMask);
+
+		SGL_TIME_STOP(GENERATE_TIME);
+
+		/*
+		// Keep the frame if it is the same as the last one built
+		*/
+		if (nRetainFrames && SetRetainedKey (&Key))
+		{
+			RetainParams (pProjMat);
+
+			#if !WIN32
+			RetainedFrame.SabreRegionInfoStart = SabreRegionInfoStart;
+			#endif
+
+			#if ISPTSP
+			RetainedFrame.nNumRegionsRendered = nNumRegionsRendered;
+			#endif
+		}
+	}
 
 
 	/* //////////////////////////////////////////////////
@@ -1444,6 +1850,8 @@ extern void CALL_CONV sgl_render( const  int viewport_or_device,
 		HWStartRender( swap_buffers, hDisplay, pProjMat->bDithering );
 
 		DPF((DBG_MESSAGE, "Done HWtSartRender !!!!"));
+
+		FramePipeEndFrame ();
 	#else
 
 		DPF((DBG_WARNING, "Pretending to Call Render......"));	
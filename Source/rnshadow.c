@@ -71,15 +71,272 @@
 
 #define MODULE_ID MODID_RN
 
+#include <string.h>  /* for memcpy() and memcmp() */
+
 #include "sgl_defs.h"
 #include "debug.h"
 #include "sgl_math.h"
 #include "dlnodes.h"
 #include "rnconvst.h"
 #include "metrics.h"
+#include "sglmem.h"
+#include "profile.h"
 
 SGL_EXTERN_TIME_REF /* if we are timing code */
 
+/*
+// Shadow volume cache.
+//
+// Working out a shadow volume only depends on the convex, the transform
+// it is drawn with and the light's direction or position, all in camera
+// space. When none of those has changed since the last frame (a static
+// caster under a fixed light, seen by a still camera) the volume built
+// then can be used again.
+//
+// The cache is direct mapped. An entry is found by hashing the convex
+// pointer, the translation and the light vector, and is only used if the
+// convex's generation (changed whenever the API edits it), the whole
+// transform and the light vector are exactly as they were. Shadow limit
+// planes change with the camera, so they aren't cached: each entry keeps
+// the forward planes and the rest separately, and the current limit
+// planes go in between as before.
+*/
+typedef struct
+{
+	const CONVEX_NODE_STRUCT *pConvex;		/* NULL if the entry is empty */
+	sgl_uint32		u32Generation;
+
+	TRANSFORM_STRUCT Transform;
+	sgl_bool		bParallelLight;
+	sgl_vector		directionPosition;
+	int				nNumShadLimPlanes;
+
+	sgl_bool		bLightInside;
+	int				nForwardPlanes;		/* planes before the limit planes */
+	int				nPlanes;			/* all the planes in the entry */
+	int				nMaxPlanes;			/* room in pPlanes */
+
+	TRANSFORMED_PLANE_STRUCT *pPlanes;
+
+} SHADOW_CACHE_ENTRY;
+
+/*
+// Number of entries, read from sgl.ini and rounded down to a power of
+// two. Zero turns the cache off.
+*/
+#define SHADOW_CACHE_DEFAULT_ENTRIES 256
+
+static SHADOW_CACHE_ENTRY	*pShadowCache = NULL;
+static int					nShadowCacheEntries = -1;
+
+/******************************************************************************
+ * Function Name: ShadowCacheEntry
+ *
+ * Inputs       : pConvex, pCurrentTransform, directionPosition
+ * Outputs      : -
+ * Returns      : The entry the volume belongs in, or NULL if there is no
+ *				  cache.
+ * Globals Used : pShadowCache, nShadowCacheEntries
+ *
+ * Description  : Finds the cache entry for a shadow volume, allocating the
+ *				  cache the first time through.
+ *****************************************************************************/
+static SHADOW_CACHE_ENTRY *ShadowCacheEntry(const CONVEX_NODE_STRUCT *pConvex,
+									const TRANSFORM_STRUCT *pCurrentTransform,
+									const sgl_vector directionPosition)
+{
+	sgl_uint32 u32Hash;
+	float	   f;
+	int		   i;
+
+	if (nShadowCacheEntries < 0)
+	{
+		int nEntries = SglReadPrivateProfileInt ("Shadows", "CacheEntries",
+										SHADOW_CACHE_DEFAULT_ENTRIES, "sgl.ini");
+
+		nShadowCacheEntries = 0;
+
+		if (nEntries > 0)
+		{
+			/*
+			// Round down to a power of two
+			*/
+			while (nEntries & (nEntries - 1))
+			{
+				nEntries &= nEntries - 1;
+			}
+
+			pShadowCache = SGLMalloc (nEntries * sizeof(SHADOW_CACHE_ENTRY));
+
+			if (pShadowCache != NULL)
+			{
+				for (i = 0; i < nEntries; i++)
+				{
+					pShadowCache[i].pConvex = NULL;
+					pShadowCache[i].pPlanes = NULL;
+					pShadowCache[i].nMaxPlanes = 0;
+				}
+
+				nShadowCacheEntries = nEntries;
+			}
+			else
+			{
+				DPF((DBG_WARNING, "No memory for the shadow volume cache"));
+			}
+		}
+	}
+
+	if (nShadowCacheEntries == 0)
+	{
+		return NULL;
+	}
+
+	u32Hash = ((sgl_uint32) pConvex) >> 4;
+
+	for (i = 0; i < 3; i++)
+	{
+		f = pCurrentTransform->mat[i][3];
+		u32Hash = (u32Hash * 31) + (sgl_uint32) FLOAT_TO_LONG(f);
+
+		f = directionPosition[i];
+		u32Hash = (u32Hash * 31) + (sgl_uint32) FLOAT_TO_LONG(f);
+	}
+
+	u32Hash ^= u32Hash >> 16;
+
+	return &pShadowCache[u32Hash & (nShadowCacheEntries - 1)];
+}
+
+/******************************************************************************
+ * Function Name: SameTransform
+ *
+ * Inputs       : pA, pB
+ * Outputs      : -
+ * Returns      : TRUE if the transforms are exactly the same
+ * Globals Used : -
+ *
+ * Description  : Compares everything the planes are transformed with. The
+ *				  4th column of the inverse can be undefined, so it is
+ *				  left out.
+ *****************************************************************************/
+static sgl_bool SameTransform(const TRANSFORM_STRUCT *pA,
+							  const TRANSFORM_STRUCT *pB)
+{
+	int i;
+
+	if ((pA->scale_flag != pB->scale_flag) ||
+		(pA->rescale != pB->rescale) ||
+		(memcmp (pA->mat, pB->mat, sizeof(pA->mat)) != 0))
+	{
+		return FALSE;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		if (memcmp (pA->inv[i], pB->inv[i], 3 * sizeof(float)) != 0)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/******************************************************************************
+ * Function Name: ShadowCacheMatches
+ *
+ * Inputs       : pEntry, and the inputs of RnGenerateShadowVolume
+ * Outputs      : -
+ * Returns      : TRUE if the entry holds this shadow volume
+ * Globals Used : -
+ *
+ * Description  : Compares everything the volume depends on exactly.
+ *****************************************************************************/
+static sgl_bool ShadowCacheMatches(const SHADOW_CACHE_ENTRY *pEntry,
+								const CONVEX_NODE_STRUCT *pConvex,
+								const TRANSFORM_STRUCT *pCurrentTransform,
+								const SHADOW_LIM_STRUCT *pShadowLimitPlanes,
+								const sgl_bool bParallelLight,
+								const sgl_vector directionPosition)
+{
+	return ((pEntry->pConvex == pConvex) &&
+			(pEntry->u32Generation == pConvex->u32_generation) &&
+			(!pEntry->bParallelLight == !bParallelLight) &&
+			(pEntry->nNumShadLimPlanes == pShadowLimitPlanes->nNumShadLimPlanes) &&
+			(memcmp (pEntry->directionPosition, directionPosition,
+					 sizeof(sgl_vector)) == 0) &&
+			SameTransform(&pEntry->Transform, pCurrentTransform));
+}
+
+/******************************************************************************
+ * Function Name: ShadowCacheStore
+ *
+ * Inputs       : pEntry, the inputs of RnGenerateShadowVolume, and the
+ *				  volume it made
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : -
+ *
+ * Description  : Replaces whatever was in the entry with a new volume. If
+ *				  the entry can't be made big enough it is left empty.
+ *****************************************************************************/
+static void ShadowCacheStore(SHADOW_CACHE_ENTRY *pEntry,
+							 const CONVEX_NODE_STRUCT *pConvex,
+							 const TRANSFORM_STRUCT *pCurrentTransform,
+							 const SHADOW_LIM_STRUCT *pShadowLimitPlanes,
+							 const sgl_bool bParallelLight,
+							 const sgl_vector directionPosition,
+							 const TRANS_PLANE_ARRAY_TYPE ShadowPlanes,
+							 const int nNumShadowPlanes,
+							 const sgl_bool bLightInside,
+							 const int nForwardPlanes)
+{
+	int nLimitPlanes = pShadowLimitPlanes->nNumShadLimPlanes;
+	int nPlanes = nNumShadowPlanes - nLimitPlanes;
+
+	pEntry->pConvex = NULL;
+
+	if (nPlanes > pEntry->nMaxPlanes)
+	{
+		TRANSFORMED_PLANE_STRUCT *pPlanes;
+
+		if (pEntry->pPlanes == NULL)
+		{
+			pPlanes = SGLMalloc (nPlanes * sizeof(TRANSFORMED_PLANE_STRUCT));
+		}
+		else
+		{
+			pPlanes = SGLRealloc (pEntry->pPlanes,
+								  nPlanes * sizeof(TRANSFORMED_PLANE_STRUCT));
+		}
+
+		if (pPlanes == NULL)
+		{
+			return;
+		}
+
+		pEntry->pPlanes = pPlanes;
+		pEntry->nMaxPlanes = nPlanes;
+	}
+
+	memcpy (pEntry->pPlanes, ShadowPlanes,
+			nForwardPlanes * sizeof(TRANSFORMED_PLANE_STRUCT));
+	memcpy (pEntry->pPlanes + nForwardPlanes,
+			ShadowPlanes + nForwardPlanes + nLimitPlanes,
+			(nPlanes - nForwardPlanes) * sizeof(TRANSFORMED_PLANE_STRUCT));
+
+	pEntry->Transform = *pCurrentTransform;
+	memcpy (pEntry->directionPosition, directionPosition, sizeof(sgl_vector));
+
+	pEntry->u32Generation = pConvex->u32_generation;
+	pEntry->bParallelLight = bParallelLight;
+	pEntry->nNumShadLimPlanes = nLimitPlanes;
+	pEntry->bLightInside = bLightInside;
+	pEntry->nForwardPlanes = nForwardPlanes;
+	pEntry->nPlanes = nPlanes;
+	pEntry->pConvex = pConvex;
+}
+
 /******************************************************************************
  * Function Name: RnGenerateShadowVolume
  *
@@ -93,6 +350,7 @@ SGL_EXTERN_TIME_REF /* if we are timing code */
  *				  generates a set of shadow planes for the shadow volume.
  *				  NOTE: It won't generate more than SGL_MAX_PLANES planes. This
  *				  can happen if an object has a large number of planes.
+ *				  Volumes that haven't changed come from the shadow cache.
  *****************************************************************************/
 void RnGenerateShadowVolume(CONVEX_NODE_STRUCT			 *pConvex,
 							const TRANS_PLANE_ARRAY_TYPE  Planes,
@@ -134,6 +392,13 @@ void RnGenerateShadowVolume(CONVEX_NODE_STRUCT			 *pConvex,
 	const TRANSFORMED_PLANE_STRUCT *pForwardPlane,*pReversePlane;
 	const TRANSFORMED_PLANE_STRUCT *pPlane;
 
+	/*
+	// Where this volume lives in the cache, and how many of the
+	// planes are forward planes (ie come before the limit planes)
+	*/
+	SHADOW_CACHE_ENTRY *pCacheEntry;
+	int nForwardPlanes;
+
 	/*
 	// Dot product values for the forward and reverse planes
 	*/
@@ -158,6 +423,43 @@ void RnGenerateShadowVolume(CONVEX_NODE_STRUCT			 *pConvex,
 	ASSERT(pnNumShadowPlanes != NULL);
 	ASSERT(pbLightInside != NULL);
 
+	/*
+	// If nothing has changed since the volume was last built, use it again
+	*/
+	pCacheEntry = ShadowCacheEntry(pConvex, pCurrentTransform, directionPosition);
+
+	if ((pCacheEntry != NULL) &&
+		ShadowCacheMatches(pCacheEntry, pConvex, pCurrentTransform,
+						   pShadowLimitPlanes, bParallelLight, directionPosition))
+	{
+		nForwardPlanes = pCacheEntry->nForwardPlanes;
+
+		memcpy (ShadowPlanes, pCacheEntry->pPlanes,
+				nForwardPlanes * sizeof(TRANSFORMED_PLANE_STRUCT));
+		*pnNumShadowPlanes = nForwardPlanes;
+
+		for (i = 0; i < pShadowLimitPlanes->nNumShadLimPlanes; i++)
+		{
+			ShadowPlanes[*pnNumShadowPlanes] =
+			  (pShadowLimitPlanes->TransShadLimPlanes[i]);
+			(*pnNumShadowPlanes)++;
+		}
+
+		memcpy (ShadowPlanes + *pnNumShadowPlanes,
+				pCacheEntry->pPlanes + nForwardPlanes,
+				(pCacheEntry->nPlanes - nForwardPlanes) *
+				sizeof(TRANSFORMED_PLANE_STRUCT));
+		*pnNumShadowPlanes += pCacheEntry->nPlanes - nForwardPlanes;
+
+		*pbLightInside = pCacheEntry->bLightInside;
+
+		SGL_PROFILE_COUNT(PROF_SHADOW_CACHE_HITS, 1)
+		SGL_TIME_STOP(SHADOW_VOL_TIME)
+		return;
+	}
+
+	SGL_PROFILE_COUNT(PROF_SHADOW_CACHE_MISSES, 1)
+
 	/*
 	// Step through the array of object planes, getting the dot product of the
 	// light direction/position and the normal to the plane, and classifying the
@@ -242,6 +544,8 @@ void RnGenerateShadowVolume(CONVEX_NODE_STRUCT			 *pConvex,
 		}/*end for*/
 	}/*end if else light type*/
 
+	nForwardPlanes = *pnNumShadowPlanes;
+
     /*
 	// If there are shadow limit planes copy them to the shadow plane list
 	*/
@@ -383,6 +687,14 @@ void RnGenerateShadowVolume(CONVEX_NODE_STRUCT			 *pConvex,
 
 	}/*end else*/
 
+	if (pCacheEntry != NULL)
+	{
+		ShadowCacheStore(pCacheEntry, pConvex, pCurrentTransform,
+						 pShadowLimitPlanes, bParallelLight, directionPosition,
+						 ShadowPlanes, *pnNumShadowPlanes, *pbLightInside,
+						 nForwardPlanes);
+	}
+
 	SGL_TIME_STOP(SHADOW_VOL_TIME)
 
 }/*end function*/
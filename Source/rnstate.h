@@ -225,6 +225,7 @@ typedef struct
 	sgl_vector	direction;
 	int			concentration;
 	float		log2concentration;
+	float		range;
 
 	/*
 	// Light position ETC in the current local
@@ -276,6 +277,12 @@ typedef struct
 	// The three following ints MUST equal num_lights.
 	*/
 	int numOnParLights, numOnPntLights, numOffLights;
+
+	/*
+	// Lights that didn't fit in the light entries are kept by the light
+	// manager in rnlights.c. This is how many of its lights are in scope.
+	*/
+	int num_pool_lights;
 	
 	/*
 	// overall set of flags for the lights. This is a
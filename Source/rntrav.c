@@ -286,7 +286,9 @@
 */
 
 #include "rntransf.h"
+#include "rnconvst.h"
 #include "rnconvex.h"
+#include "rnreject.h"
 #include "rnmater.h"
 #include "rnlights.h"
 #include "rnlod.h"
@@ -329,6 +331,9 @@ void InitMasterState( MASTER_STATE_STRUCT *pState)
 	pState->pLightsState->numOnParLights = 0;
 	pState->pLightsState->numOnPntLights= 0;
 	pState->pLightsState->numOffLights= 0;
+	pState->pLightsState->num_pool_lights = 0;
+
+	RnResetLightPool();
 
 	pState->pLightsState->flags = lsf_ambient_grey | 
 								  lsf_earl_grey | 
@@ -800,7 +805,7 @@ static void	RnProcessInstanceSubsNode( INSTANCE_SUBS_NODE_STRUCT* pNode,
 	// Pointer to each of the new substitions, and a pointer to the current
 	// subs
 	*/
-	sgl_int16 * pNew;
+	sgl_int32 * pNew;
 	int * pCurr;
 
 	int newOrig, newReplacement;
@@ -1621,6 +1626,261 @@ static void RnTextureCacheTraverse(const  LIST_NODE_STRUCT * pList,
 	} /*end while*/	
 
 }
+/**************************************************************************
+ * Function Name  : UpdateListBounds  (LOCAL FUNCTION)
+ * Inputs         : None
+ * Outputs        : None
+ * Input/Output	  : pList - pointer to a list node
+ * Returns        : None
+ * Global Used    : None
+ *
+ * Description    : Brings the bounds flags and bounds of a list up to date,
+ *					doing the same for the lists in it first.
+ *
+ *					The list is only cullable if all it draws are convex
+ *					primitives and meshes with bounding boxes, and nothing
+ *					in it has an effect that lasts beyond the list. So
+ *					transforms and materials are only allowed in lists that
+ *					preserve the state, and lights, points, instances, LOD,
+ *					quality and other such nodes aren't allowed at all.
+ **************************************************************************/
+static void UpdateListBounds(LIST_NODE_STRUCT *pList)
+{
+	TRANSFORM_STRUCT	Transform;
+	BBOX_MINMAX_STRUCT	Box;
+	BBOX_CENT_STRUCT	ChildBox;
+	DL_NODE_STRUCT		*pNode;
+	sgl_bool			bPreserves, bEmpty;
+	int					k;
+
+	ASSERT(pList->node_hdr.n16_node_type == nt_list_node);
+
+	if(pList->bounds_flags & lbf_valid)
+	{
+		return;
+	}
+
+	/*
+	// Until we get to the end, assume the list can't be culled
+	*/
+	pList->bounds_flags = lbf_valid;
+
+	SetIdentityMatrix(&Transform);
+	bPreserves = (pList->flags & lf_preserve_state) != 0;
+	bEmpty = TRUE;
+
+	for(pNode = pList->pfirst; pNode != NULL; pNode = pNode->next_node)
+	{
+		const BBOX_CENT_STRUCT *pCentBox = NULL;
+
+		switch(pNode->n16_node_type)
+		{
+			case nt_list_node:
+			{
+				LIST_NODE_STRUCT *pChild = (LIST_NODE_STRUCT *) pNode;
+
+				if(!(pChild->flags & lf_process_list))
+				{
+					break;
+				}
+
+				UpdateListBounds(pChild);
+
+				if(!(pChild->bounds_flags & lbf_cullable))
+				{
+					return;
+				}
+
+				if(!(pChild->bounds_flags & lbf_empty))
+				{
+					for(k = 0; k < 3; k++)
+					{
+						ChildBox.boxCentre[k]  = (pChild->bounds.boxMax[k] + pChild->bounds.boxMin[k]) * 0.5f;
+						ChildBox.boxOffsets[k] = (pChild->bounds.boxMax[k] - pChild->bounds.boxMin[k]) * 0.5f;
+					}
+
+					pCentBox = &ChildBox;
+				}
+				break;
+			}
+
+			case nt_transform:
+			{
+				if(!bPreserves)
+				{
+					return;
+				}
+
+				TransformMultiply(&Transform,
+								  &((TRANSFORM_NODE_STRUCT *) pNode)->transform,
+								  &Transform);
+				break;
+			}
+
+			case nt_material:
+			{
+				if(!bPreserves)
+				{
+					return;
+				}
+				break;
+			}
+
+			case nt_convex:
+			{
+				CONVEX_NODE_STRUCT *pConvex = (CONVEX_NODE_STRUCT *) pNode;
+
+				if(pConvex->u16_num_planes == 0)
+				{
+					break;
+				}
+
+				/*
+				// Infinite objects can't be bounded
+				*/
+				if(!(pConvex->u16_flags & cf_has_bbox))
+				{
+					return;
+				}
+
+				pCentBox = &pConvex->bbox;
+				break;
+			}
+
+			case nt_mesh:
+			{
+				MESH_NODE_STRUCT *pMesh = (MESH_NODE_STRUCT *) pNode;
+
+				/*
+				// Meshes without vertices have negative offsets
+				*/
+				if(pMesh->CentBBox.boxOffsets[0] >= 0.0f)
+				{
+					pCentBox = &pMesh->CentBBox;
+				}
+				break;
+			}
+
+			/*
+			// Nodes that do nothing during traversal
+			*/
+			case nt_camera:
+			case nt_light_pos:
+			case nt_dummy:
+			{
+				break;
+			}
+
+			default:
+			{
+				return;
+			}
+		}/*end switch*/
+
+		if(pCentBox != NULL)
+		{
+			TransformBBox(&Transform, pCentBox, &Box);
+
+			if(bEmpty)
+			{
+				pList->bounds = Box;
+				bEmpty = FALSE;
+			}
+			else
+			{
+				for(k = 0; k < 3; k++)
+				{
+					if(Box.boxMin[k] < pList->bounds.boxMin[k])
+					{
+						pList->bounds.boxMin[k] = Box.boxMin[k];
+					}
+					if(Box.boxMax[k] > pList->bounds.boxMax[k])
+					{
+						pList->bounds.boxMax[k] = Box.boxMax[k];
+					}
+				}
+			}
+		}
+	}/*end for*/
+
+	pList->bounds_flags = lbf_valid | lbf_cullable | (bEmpty ? lbf_empty : 0);
+}
+
+/**************************************************************************
+ * Function Name  : ListIsOffscreen  (LOCAL FUNCTION)
+ * Inputs         : pState - the state the list is about to be entered with
+ * Outputs        : None
+ * Input/Output	  : pList - pointer to a list node
+ * Returns        : TRUE if traversing the list would draw nothing, so it
+ *					can be skipped.
+ * Global Used    : None
+ *
+ * Description    : Tests the bounds of a cullable list against the view
+ *					pyramid. Objects off screen can still cast shadows and
+ *					be hit by collision points, so nothing is culled when
+ *					either of those is on.
+ **************************************************************************/
+static sgl_bool ListIsOffscreen(LIST_NODE_STRUCT *pList,
+								const MASTER_STATE_STRUCT *pState)
+{
+	BBOX_CENT_STRUCT	CentBox;
+	BBOX_MINMAX_STRUCT	BoxInWC;
+	sgl_bool			bClipFront;
+	int					k;
+
+	if((pState->pLightsState->flags & lsf_shadows) &&
+	   (pState->pQualityState->flags & qf_cast_shadows))
+	{
+		return FALSE;
+	}
+
+	if((pState->pCollisionState->num_pnts != 0) &&
+	   (pState->pQualityState->flags & qf_full_collision))
+	{
+		return FALSE;
+	}
+
+	UpdateListBounds(pList);
+
+	if(!(pList->bounds_flags & lbf_cullable))
+	{
+		return FALSE;
+	}
+
+	if(pList->bounds_flags & lbf_empty)
+	{
+		return TRUE;
+	}
+
+	for(k = 0; k < 3; k++)
+	{
+		CentBox.boxCentre[k]  = (pList->bounds.boxMax[k] + pList->bounds.boxMin[k]) * 0.5f;
+		CentBox.boxOffsets[k] = (pList->bounds.boxMax[k] - pList->bounds.boxMin[k]) * 0.5f;
+	}
+
+	TransformBBox(pState->pTransformState, &CentBox, &BoxInWC);
+
+	return (RnTestBoxWithCamera(&BoxInWC, FALSE, &bClipFront) == TB_BOX_OFFSCREEN);
+}
+
+/**************************************************************************
+ * Function Name  : MeshLightBox  (LOCAL FUNCTION)
+ * Inputs         : pMesh - pointer to a mesh node
+ * Outputs        : None
+ * Input/Output	  : None
+ * Returns        : The mesh's bounds, or NULL if it has no vertices
+ * Global Used    : None
+ *
+ * Description    : The bounds used to pick the mesh's lights.
+ **************************************************************************/
+static const BBOX_CENT_STRUCT *MeshLightBox(const MESH_NODE_STRUCT *pMesh)
+{
+	/*
+	// Meshes without vertices have negative offsets
+	*/
+	return ((pMesh->CentBBox.boxOffsets[0] >= 0.0f) ? &pMesh->CentBBox : NULL);
+}
+
 /**************************************************************************
  * Function Name  : RnRecursiveTraverse
  * Inputs         : pList - pointer to a display list
@@ -1682,6 +1942,11 @@ static int RnRecursiveTraverse(const  LIST_NODE_STRUCT  *pList,
 	*/
 	sgl_bool localUpdatePoints;
 
+	/*
+	// The lights state in scope, while an object is handed one of its own
+	*/
+	LIGHTS_STATE_STRUCT *pLightsState;
+
 	/*
 	// initialise the error state
 	*/
@@ -1801,6 +2066,13 @@ static int RnRecursiveTraverse(const  LIST_NODE_STRUCT  *pList,
 					/* DO NOTHING*/
 				}
 				/*
+				// or if nothing it draws is on screen
+				*/
+				else if(ListIsOffscreen(pChildList, pState))
+				{
+					DPF((DBG_VERBOSE,"Culled offscreen list"));
+				}
+				/*
 				// else flag a "too deep" error if we are at the max depth allowed
 				*/
 				else if(depthRemaining == 0)
@@ -1951,11 +2223,22 @@ static int RnRecursiveTraverse(const  LIST_NODE_STRUCT  *pList,
 				*/
 	SGL_TIME_SUSPEND(DATABASE_TRAVERSAL_TIME)
 
+				/*
+				// Shade it with the lights that matter most to it, if
+				// there are more than can be used at once
+				*/
+				pLightsState = pState->pLightsState;
+				pState->pLightsState = RnSelectObjectLights(pLightsState,
+								pState->pTransformState,
+								(pConvex->u16_flags & cf_has_bbox) ? &pConvex->bbox : NULL);
+
 				RnProcessConvexNode(pConvex,
 									pState,
 									&ShadowLimitPlanes,
 									parentUpdatePoints, 
 									current_trans_set_id);
+
+				pState->pLightsState = pLightsState;
 	SGL_TIME_RESUME(DATABASE_TRAVERSAL_TIME)
 				
 				break;
@@ -2007,8 +2290,15 @@ static int RnRecursiveTraverse(const  LIST_NODE_STRUCT  *pList,
 				
 				DPF ((DBG_VERBOSE,"Found mesh node"));
 				SGL_TIME_SUSPEND(DATABASE_TRAVERSAL_TIME)
+				pLightsState = pState->pLightsState;
+				pState->pLightsState = RnSelectObjectLights(pLightsState,
+								pState->pTransformState,
+								MeshLightBox((const MESH_NODE_STRUCT *) pNode));
+
 				RnProcessMeshNode ((const MESH_NODE_STRUCT *) pNode, 
 								   pState,current_trans_set_id);
+
+				pState->pLightsState = pLightsState;
 				SGL_TIME_RESUME(DATABASE_TRAVERSAL_TIME)
 				break;
 			}
@@ -297,9 +297,66 @@ typedef struct
 	sgl_uint32 u32OtherFreeMem;
 	sgl_uint32 u32LargestOtherFreeMem; /* largest contiguous block */
 
+	/*
+	// Only filled in if u32StructSize is big enough for them. Blocks and
+	// sizes count each bank separately, as the sizes above do.
+	*/
+	sgl_uint32 u32FreeBlocks;		/* separate pieces of free memory */
+	sgl_uint32 u32Fragmentation;	/* 0-100, how much is outside the largest */
+	sgl_uint32 u32MovableMem;		/* used memory sgl_compact_texture_memory may move */
+
 } sgl_texture_mem_info;
 
 
+/*
+// Frame profiling. See sgl_profile_enable.
+//
+// Each frame's time is split into broad zones. The times are in
+// microseconds, summed over every thread that worked on the zone, so with
+// several CPUs a zone can take longer than the frame.
+*/
+
+typedef enum
+{
+	sgl_profile_frame,			/* the whole of sgl_render or sgltri_render */
+	sgl_profile_traversal,		/* walking the display list */
+	sgl_profile_projection,		/* projecting planes */
+	sgl_profile_shading,		/* smooth and flat shading parameters */
+	sgl_profile_packing,		/* packing ISP and TSP parameters */
+	sgl_profile_regions,		/* generating the region object lists */
+	sgl_profile_render_wait,	/* waiting for the hardware */
+
+	sgl_profile_num_zones
+
+} sgl_profile_zones;
+
+typedef struct
+{
+	/*
+	// Frame number, counting from when profiling was last enabled
+	*/
+	sgl_uint32 u32Frame;
+
+	/*
+	// When the frame started, in microseconds since profiling was enabled
+	*/
+	sgl_uint32 u32StartTime;
+
+	/*
+	// Time spent in, and number of visits to, each zone
+	*/
+	sgl_uint32 u32ZoneTime[sgl_profile_num_zones];
+	sgl_uint32 u32ZoneCount[sgl_profile_num_zones];
+
+	/*
+	// Shadow volumes reused from earlier frames, and ones built afresh
+	*/
+	sgl_uint32 u32ShadowCacheHits;
+	sgl_uint32 u32ShadowCacheMisses;
+
+} sgl_profile_frame_info;
+
+
 typedef enum
 {
 	sgl_map_16bit,
@@ -1742,6 +1799,93 @@ API_FN(sgl_bool, sgl_get_ini_int, (sgl_int32 *ReturnData,
 								   sgl_int32 DefaultDataValue, 
 								   char *Section, char *Entry))
 
+/*
+// ------------------
+// sgl_profile_enable
+// ------------------
+// Turns frame profiling on or off. Turning it on clears everything
+// recorded so far and restarts the clock and frame count. While it is off
+// the timers cost next to nothing.
+//
+// Not available in builds made with METRIC defined, which do their own
+// timing; there nothing is recorded.
+*/
+API_FN(void, sgl_profile_enable, (sgl_bool enable))
+
+/*
+// ----------------------
+// sgl_profile_get_frames
+// ----------------------
+// Copies up to max_frames of the most recent complete frames into frames,
+// oldest first, and returns how many were copied. Only the last 64 or so
+// frames are kept.
+*/
+API_FN(int, sgl_profile_get_frames, (sgl_profile_frame_info *frames,
+									 int max_frames))
+
+/*
+// -----------------------
+// sgl_profile_write_trace
+// -----------------------
+// Writes the most recent timer events (a few thousand of them) to a file
+// in the Chrome trace event format, which chrome://tracing and Perfetto
+// can load. Returns the number of events written, or sgl_err_bad_parameter
+// if the file cannot be created.
+*/
+API_FN(int, sgl_profile_write_trace, (char *filename))
+
+/*
+// ---------------------------
+// sgl_compact_texture_memory
+// ---------------------------
+// Moves textures in texture memory so that the free memory is in fewer,
+// larger pieces, stopping once about max_bytes have been moved. Returns
+// the number of bytes moved; with max_bytes 0 nothing is moved and it
+// returns non zero if there is anything worth doing. Waits for any renders
+// still in progress. Only textures created through SGL are ever moved.
+//
+// It is also done on frames where nothing has changed if the [Texture]
+// CompactBytes entry of sgl.ini gives the amount to move per frame.
+*/
+API_FN(unsigned long, sgl_compact_texture_memory, (unsigned long max_bytes))
+
+/*
+// -----------------
+// sgl_reserve_names
+// -----------------
+// Makes room for count more named objects (lists, materials, textures
+// and so on) in one go, rather than a bit at a time as they are created.
+// Returns sgl_no_err, or sgl_err_no_name if there can't be that many; at
+// most 1048576 (2^20) names can be in use at once.
+*/
+API_FN(int, sgl_reserve_names, (int count))
+
+/*
+// --------------------
+// sgl_create_materials
+// --------------------
+// Creates count named materials in one go, and puts their names in
+// names. It is the same as calling sgl_create_material (TRUE, FALSE)
+// count times, but the name table only has to grow once; afterwards the
+// last of them is the current material. Either all of them are created,
+// or none are. Returns sgl_no_err, sgl_err_bad_parameter,
+// sgl_err_no_mem or sgl_err_no_name.
+*/
+API_FN(int, sgl_create_materials, (int count, int *names))
+
+/*
+// -------------------
+// sgl_set_light_range
+// -------------------
+// Says how far a point light reaches; 0, the default, means everywhere.
+// Lights don't fade with distance, so objects further away are still lit
+// by it normally. But when more lights are in scope than SGL can use at
+// once (SGL_MAX_ACTIVE_LIGHTS), each object is shaded with the ones that
+// matter most to it, and a light never counts for objects out of its
+// range.
+*/
+API_FN(void, sgl_set_light_range, (int name, float range))
+
 #ifdef _BUILDING_SGL_
 
 /* PRIVATE FUNCTION entry point to allow sgl to understand
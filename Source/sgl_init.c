@@ -308,6 +308,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "sgl.h"
 #include "sgl_defs.h"
@@ -320,6 +321,8 @@
 #include "rnglobal.h"
 #include "rnstate.h"
 #include "rnmesh.h"
+#include "rnconvst.h"
+#include "rnconvpr.h"
 #include "dlothers.h"
 #include "dvdevice.h"
 #include "rncamera.h"
@@ -330,6 +333,7 @@
 #include "pktsp.h"
 #include "texapi.h"
 #include "parmbuff.h"
+#include "sglthrd.h"
 
 
 #if WIN32 || DOS32
@@ -490,6 +494,10 @@ int CALL_CONV SglInitialise(void)
 
 		RnMeshOnSglInitialise ();
 
+		/* Pick the convex plane projection kernel */
+
+		RnConvexOnSglInitialise ();
+
 		/* init fast inverse sqrt lookup table */
 
 		MakeInvSqrtLookupTable ();
@@ -503,6 +511,15 @@ int CALL_CONV SglInitialise(void)
 		
 		InitDefaultQualityFlags ();
 
+		/* start the worker threads, if sgl.ini asks for any. The
+		   Windows DLL stops them again on process detach */
+
+		SglThreadPoolInit (0);
+
+#if !WIN32
+		atexit (SglThreadPoolShutdown);
+#endif
+
 		
 	}/*End if system not initialised*/
 
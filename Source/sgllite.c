@@ -405,6 +405,8 @@ sgl_uint32	nMaxPassCount		= 0x0FFFFFFF;
 #include "profile.h"
 #endif
 
+#include "frmpipe.h"
+
 #if PCX1 || PCX2 || PCX2_003
 extern sgl_uint32 TexParamSize;
 #endif
@@ -995,6 +997,11 @@ extern void CALL_CONV sgltri_startofframe(PSGLCONTEXT pContext)
 	*/
 	ResetRegionDataL (FALSE);
 
+	/*
+	// Don't run more than the pipeline depth ahead of the hardware
+	*/
+	FramePipeBeginFrame ();
+
 	/*
 	// Get parameter memory, if available...
 	*/
@@ -1476,6 +1483,8 @@ extern void CALL_CONV sgltri_render (PSGLCONTEXT pContext)
 	
 	DPF((DBG_MESSAGE, "Done HWStartRender !!!!"));
 
+	FramePipeEndFrame ();
+
 #if DUMP_PARAMS
 	/*
 	// For Sabre/Texas Debugging, output files of the parameter store contents.
@@ -1511,7 +1520,7 @@ extern void CALL_CONV sgltri_render (PSGLCONTEXT pContext)
 	SGL_TIME_SUSPEND(TOTAL_RENDER_TIME);
 	SGL_TIME_START(RENDER_WAITING_TIME);
 
-	while(!HWFinishedRender());
+	FramePipeWait (FramePipeLastIssued ());
 
 	SGL_TIME_STOP(RENDER_WAITING_TIME);
 	SGL_TIME_RESUME(TOTAL_RENDER_TIME);
@@ -1741,7 +1750,9 @@ extern sgl_bool CALL_CONV sgltri_renderstrip (PSGLCONTEXT pContext, int nStrip,
 	
 			#endif
 	
+			SGL_TIME_START(GENERATE_TIME);
 			GenerateObjectPtrLiteStrip (&RegionRect, bRenderAllRegions);
+			SGL_TIME_STOP(GENERATE_TIME);
 	
 			/* //////////////////////////////////////////////////
 			// Wait till the hardware is available,
@@ -1847,10 +1858,8 @@ extern sgl_bool CALL_CONV sgltri_renderstrip (PSGLCONTEXT pContext, int nStrip,
 					HWSetRegionsRegister( nNumRegionsRendered );
 				#endif
 #endif				
-				while (!HWFinishedRender ())
-				{
-					/* Do nothing */
-				}
+				/* One strip renders at a time */
+				FramePipeWait (FramePipeLastIssued ());
 
 				DPF((DBG_VERBOSE, "Calling HWStartRender"));	
 	
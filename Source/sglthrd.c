@@ -0,0 +1,793 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: sglthrd.c,v $
+Title           :   Portable thread services
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Mutexes, events, threads and a worker pool for the few
+					places in SGL and the simulator that split a frame's
+					work across several CPUs. See sglthrd.h.
+
+					There are three back ends: Win32, POSIX threads (for
+					gcc/unix builds of the simulator) and a null version
+					for everything else which runs all tasks serially.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: sglthrd.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_SGLTHRD
+
+#include "sgl_defs.h"
+#include "sgl.h"
+#include "pvrosapi.h"
+#include "sglmem.h"
+#include "profile.h"
+#include "sglthrd.h"
+
+#if WIN32
+
+	#define SGL_THREADS_WIN32	1
+
+	#pragma warning ( disable : 117 )
+	#include <windows.h>
+	#pragma warning ( default : 117 )
+
+	#include <float.h>		/* _controlfp */
+
+#elif defined (GCC) || defined (__unix__)
+
+	#define SGL_THREADS_POSIX	1
+
+	#include <pthread.h>
+
+#else
+
+	#define SGL_THREADS_NONE	1
+
+#endif
+
+/*
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++	                		primitives				                       	 ++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ */
+
+#if SGL_THREADS_POSIX
+
+typedef struct tagPOSIX_EVENT
+{
+	pthread_mutex_t	Mutex;
+	pthread_cond_t	Cond;
+	sgl_bool		bManualReset;
+	sgl_bool		bSignalled;
+} POSIX_EVENT;
+
+typedef struct tagPOSIX_THREAD
+{
+	pthread_t		Thread;
+	SGLTHREADFN		pfnThread;
+	void			*pContext;
+} POSIX_THREAD;
+
+static void *PosixThreadEntry (void *pData)
+{
+	POSIX_THREAD *pThread = (POSIX_THREAD *) pData;
+
+	pThread->pfnThread (pThread->pContext);
+
+	return (NULL);
+}
+
+#endif
+
+sgl_int32 SglAtomicAdd (volatile sgl_int32 *pValue, sgl_int32 nAdd)
+{
+#if SGL_THREADS_WIN32
+
+	return ((sgl_int32) InterlockedExchangeAdd ((LONG *) pValue, (LONG) nAdd));
+
+#elif SGL_THREADS_POSIX
+
+	return (__sync_fetch_and_add (pValue, nAdd));
+
+#else
+
+	sgl_int32 nOld = *pValue;
+
+	*pValue = nOld + nAdd;
+
+	return (nOld);
+
+#endif
+}
+
+SGLMUTEX SglMutexCreate (void)
+{
+#if SGL_THREADS_WIN32
+
+	CRITICAL_SECTION *pCS = NEW (CRITICAL_SECTION);
+
+	if (pCS)
+	{
+		InitializeCriticalSection (pCS);
+	}
+
+	return ((SGLMUTEX) pCS);
+
+#elif SGL_THREADS_POSIX
+
+	pthread_mutex_t *pMutex = NEW (pthread_mutex_t);
+
+	if (pMutex)
+	{
+		pthread_mutex_init (pMutex, NULL);
+	}
+
+	return ((SGLMUTEX) pMutex);
+
+#else
+
+	return ((SGLMUTEX) 1);
+
+#endif
+}
+
+void SglMutexDestroy (SGLMUTEX hMutex)
+{
+#if SGL_THREADS_WIN32
+
+	if (hMutex)
+	{
+		DeleteCriticalSection ((CRITICAL_SECTION *) hMutex);
+		SGLFree (hMutex);
+	}
+
+#elif SGL_THREADS_POSIX
+
+	if (hMutex)
+	{
+		pthread_mutex_destroy ((pthread_mutex_t *) hMutex);
+		SGLFree (hMutex);
+	}
+
+#endif
+}
+
+void SglMutexLock (SGLMUTEX hMutex)
+{
+#if SGL_THREADS_WIN32
+	EnterCriticalSection ((CRITICAL_SECTION *) hMutex);
+#elif SGL_THREADS_POSIX
+	pthread_mutex_lock ((pthread_mutex_t *) hMutex);
+#endif
+}
+
+void SglMutexUnlock (SGLMUTEX hMutex)
+{
+#if SGL_THREADS_WIN32
+	LeaveCriticalSection ((CRITICAL_SECTION *) hMutex);
+#elif SGL_THREADS_POSIX
+	pthread_mutex_unlock ((pthread_mutex_t *) hMutex);
+#endif
+}
+
+SGLEVENT SglEventCreate (sgl_bool bManualReset, sgl_bool bInitialState)
+{
+#if SGL_THREADS_WIN32
+
+	return ((SGLEVENT) CreateEvent (NULL, bManualReset, bInitialState, NULL));
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_EVENT *pEvent = NEW (POSIX_EVENT);
+
+	if (pEvent)
+	{
+		pthread_mutex_init (&pEvent->Mutex, NULL);
+		pthread_cond_init (&pEvent->Cond, NULL);
+		pEvent->bManualReset = bManualReset;
+		pEvent->bSignalled = bInitialState;
+	}
+
+	return ((SGLEVENT) pEvent);
+
+#else
+
+	return ((SGLEVENT) 1);
+
+#endif
+}
+
+void SglEventDestroy (SGLEVENT hEvent)
+{
+#if SGL_THREADS_WIN32
+
+	if (hEvent)
+	{
+		CloseHandle ((HANDLE) hEvent);
+	}
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_EVENT *pEvent = (POSIX_EVENT *) hEvent;
+
+	if (pEvent)
+	{
+		pthread_cond_destroy (&pEvent->Cond);
+		pthread_mutex_destroy (&pEvent->Mutex);
+		SGLFree (pEvent);
+	}
+
+#endif
+}
+
+void SglEventSet (SGLEVENT hEvent)
+{
+#if SGL_THREADS_WIN32
+
+	SetEvent ((HANDLE) hEvent);
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_EVENT *pEvent = (POSIX_EVENT *) hEvent;
+
+	pthread_mutex_lock (&pEvent->Mutex);
+	pEvent->bSignalled = TRUE;
+
+	if (pEvent->bManualReset)
+	{
+		pthread_cond_broadcast (&pEvent->Cond);
+	}
+	else
+	{
+		pthread_cond_signal (&pEvent->Cond);
+	}
+	pthread_mutex_unlock (&pEvent->Mutex);
+
+#endif
+}
+
+void SglEventReset (SGLEVENT hEvent)
+{
+#if SGL_THREADS_WIN32
+
+	ResetEvent ((HANDLE) hEvent);
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_EVENT *pEvent = (POSIX_EVENT *) hEvent;
+
+	pthread_mutex_lock (&pEvent->Mutex);
+	pEvent->bSignalled = FALSE;
+	pthread_mutex_unlock (&pEvent->Mutex);
+
+#endif
+}
+
+void SglEventWait (SGLEVENT hEvent)
+{
+#if SGL_THREADS_WIN32
+
+	WaitForSingleObject ((HANDLE) hEvent, INFINITE);
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_EVENT *pEvent = (POSIX_EVENT *) hEvent;
+
+	pthread_mutex_lock (&pEvent->Mutex);
+
+	while (!pEvent->bSignalled)
+	{
+		pthread_cond_wait (&pEvent->Cond, &pEvent->Mutex);
+	}
+
+	if (!pEvent->bManualReset)
+	{
+		pEvent->bSignalled = FALSE;
+	}
+
+	pthread_mutex_unlock (&pEvent->Mutex);
+
+#endif
+}
+
+#if SGL_THREADS_WIN32
+
+static DWORD WINAPI Win32ThreadEntry (LPVOID pData)
+{
+	void **ppArgs = (void **) pData;
+	SGLTHREADFN pfnThread = (SGLTHREADFN) ppArgs[0];
+	void *pContext = ppArgs[1];
+
+	SGLFree (ppArgs);
+
+	pfnThread (pContext);
+
+	return (0);
+}
+
+#endif
+
+SGLTHREAD SglThreadCreate (SGLTHREADFN pfnThread, void *pContext)
+{
+#if SGL_THREADS_WIN32
+
+	DWORD dwID;
+	HANDLE hThread;
+	void **ppArgs = (void **) SGLMalloc (2 * sizeof (void *));
+
+	if (!ppArgs)
+	{
+		return (NULL);
+	}
+
+	ppArgs[0] = (void *) pfnThread;
+	ppArgs[1] = pContext;
+
+	hThread = CreateThread (NULL, 0, Win32ThreadEntry, ppArgs, 0, &dwID);
+
+	if (!hThread)
+	{
+		SGLFree (ppArgs);
+	}
+
+	return ((SGLTHREAD) hThread);
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_THREAD *pThread = NEW (POSIX_THREAD);
+
+	if (pThread)
+	{
+		pThread->pfnThread = pfnThread;
+		pThread->pContext = pContext;
+
+		if (pthread_create (&pThread->Thread, NULL, PosixThreadEntry, pThread) != 0)
+		{
+			SGLFree (pThread);
+			pThread = NULL;
+		}
+	}
+
+	return ((SGLTHREAD) pThread);
+
+#else
+
+	pfnThread (pContext);
+
+	return ((SGLTHREAD) 1);
+
+#endif
+}
+
+void SglThreadJoin (SGLTHREAD hThread)
+{
+#if SGL_THREADS_WIN32
+
+	if (hThread)
+	{
+		WaitForSingleObject ((HANDLE) hThread, INFINITE);
+		CloseHandle ((HANDLE) hThread);
+	}
+
+#elif SGL_THREADS_POSIX
+
+	POSIX_THREAD *pThread = (POSIX_THREAD *) hThread;
+
+	if (pThread)
+	{
+		pthread_join (pThread->Thread, NULL);
+		SGLFree (pThread);
+	}
+
+#endif
+}
+
+/*
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++	                		worker pool				                       	 ++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ */
+
+typedef struct tagPOOL_WORKER
+{
+	SGLTHREAD	hThread;
+	SGLEVENT	hStart;		/* auto reset: one job per set */
+	int			nThread;
+} POOL_WORKER;
+
+static struct
+{
+	int					nThreads;
+	POOL_WORKER			Workers[SGL_MAX_THREADS];
+	SGLEVENT			hDone;
+
+	/* Held by whichever outside thread currently owns the pool */
+	SGLMUTEX			hLock;
+
+	/* The current job */
+	SGLTASKFN			pfnTask;
+	void				*pContext;
+	int					nTasks;
+	volatile sgl_int32	nNextTask;
+	volatile sgl_int32	nActive;
+	sgl_bool			bQuit;
+
+} gPool = { 1 };
+
+/*
+// Each worker records its POOL_WORKER in thread local storage so that code
+// deep inside a task can find out which pool thread it is running on.
+// While a parallel call is in progress its caller is marked with
+// Workers[0], so a nested call from any task can be spotted and run in
+// place on the same thread index. Other threads see NULL.
+*/
+#if SGL_THREADS_WIN32
+static DWORD			gTlsIndex = TLS_OUT_OF_INDEXES;
+#elif SGL_THREADS_POSIX
+static pthread_key_t	gTlsKey;
+static sgl_bool			gbTlsKey = FALSE;
+#endif
+
+/*===========================================
+ * Function:	PoolSelf
+ *===========================================
+ *
+ * Scope:		Static
+ *
+ * Purpose:		The POOL_WORKER of the calling thread, or NULL if it isn't
+ *				a pool thread (or the caller of a parallel call).
+ *========================================================================================*/
+static POOL_WORKER *PoolSelf (void)
+{
+#if SGL_THREADS_WIN32
+	if (gTlsIndex != TLS_OUT_OF_INDEXES)
+	{
+		return ((POOL_WORKER *) TlsGetValue (gTlsIndex));
+	}
+#elif SGL_THREADS_POSIX
+	if (gbTlsKey)
+	{
+		return ((POOL_WORKER *) pthread_getspecific (gTlsKey));
+	}
+#endif
+
+	return (NULL);
+}
+
+static void PoolSetSelf (POOL_WORKER *pWorker)
+{
+#if SGL_THREADS_WIN32
+	TlsSetValue (gTlsIndex, pWorker);
+#elif SGL_THREADS_POSIX
+	pthread_setspecific (gTlsKey, pWorker);
+#endif
+}
+
+/*===========================================
+ * Function:	PoolRunTasks
+ *===========================================
+ *
+ * Scope:		Static
+ *
+ * Purpose:		Take tasks from the shared counter until there are none left.
+ *========================================================================================*/
+static void PoolRunTasks (int nThread)
+{
+	sgl_int32 nTask;
+
+	while ((nTask = SglAtomicAdd (&gPool.nNextTask, 1)) < gPool.nTasks)
+	{
+		gPool.pfnTask (gPool.pContext, (int) nTask, nThread);
+	}
+}
+
+static void PoolWorker (void *pData)
+{
+	POOL_WORKER *pWorker = (POOL_WORKER *) pData;
+
+	PoolSetSelf (pWorker);
+
+	for (;;)
+	{
+		SglEventWait (pWorker->hStart);
+
+		if (!gPool.bQuit)
+		{
+			PoolRunTasks (pWorker->nThread);
+		}
+
+		/* Last one out wakes the caller */
+		if (SglAtomicAdd (&gPool.nActive, -1) == 1)
+		{
+			SglEventSet (gPool.hDone);
+		}
+
+		if (gPool.bQuit)
+		{
+			break;
+		}
+	}
+}
+
+int SglThreadPoolInit (int nThreads)
+{
+	int k;
+
+	if (gPool.nThreads > 1)
+	{
+		/* already running */
+		return (gPool.nThreads);
+	}
+
+	if (nThreads <= 0)
+	{
+		nThreads = SglReadPrivateProfileInt ("Threads", "Count", 1, "sgl.ini");
+	}
+
+#if SGL_THREADS_NONE
+	nThreads = 1;
+#endif
+
+	if (nThreads > SGL_MAX_THREADS)
+	{
+		nThreads = SGL_MAX_THREADS;
+	}
+
+	gPool.nThreads = 1;
+	gPool.bQuit = FALSE;
+	gPool.Workers[0].nThread = 0;
+
+	if (nThreads <= 1)
+	{
+		return (1);
+	}
+
+	gPool.hDone = SglEventCreate (FALSE, FALSE);
+
+	if (!gPool.hDone)
+	{
+		DPF ((DBG_WARNING, "SglThreadPoolInit: failed to create done event"));
+		return (1);
+	}
+
+	gPool.hLock = SglMutexCreate ();
+
+	if (!gPool.hLock)
+	{
+		DPF ((DBG_WARNING, "SglThreadPoolInit: failed to create pool lock"));
+		SglEventDestroy (gPool.hDone);
+		return (1);
+	}
+
+#if SGL_THREADS_WIN32
+	if (gTlsIndex == TLS_OUT_OF_INDEXES)
+	{
+		gTlsIndex = TlsAlloc ();
+	}
+
+	if (gTlsIndex == TLS_OUT_OF_INDEXES)
+#elif SGL_THREADS_POSIX
+	if (!gbTlsKey)
+	{
+		gbTlsKey = (pthread_key_create (&gTlsKey, NULL) == 0);
+	}
+
+	if (!gbTlsKey)
+#endif
+	{
+		DPF ((DBG_WARNING, "SglThreadPoolInit: no thread local storage"));
+		SglMutexDestroy (gPool.hLock);
+		SglEventDestroy (gPool.hDone);
+		return (1);
+	}
+
+	/*
+	// Thread 0 is always the caller, so only nThreads-1 workers are needed
+	*/
+	for (k = 1; k < nThreads; k++)
+	{
+		POOL_WORKER *pWorker = &gPool.Workers[k];
+
+		pWorker->nThread = k;
+		pWorker->hStart = SglEventCreate (FALSE, FALSE);
+
+		if (!pWorker->hStart)
+		{
+			break;
+		}
+
+		pWorker->hThread = SglThreadCreate (PoolWorker, pWorker);
+
+		if (!pWorker->hThread)
+		{
+			SglEventDestroy (pWorker->hStart);
+			break;
+		}
+
+		gPool.nThreads++;
+	}
+
+	DPF ((DBG_MESSAGE, "SglThreadPoolInit: %d threads", gPool.nThreads));
+
+	return (gPool.nThreads);
+}
+
+void SglThreadPoolShutdown (void)
+{
+	int k;
+
+	if (gPool.nThreads <= 1)
+	{
+		return;
+	}
+
+	gPool.bQuit = TRUE;
+	gPool.nActive = gPool.nThreads - 1;
+
+	for (k = 1; k < gPool.nThreads; k++)
+	{
+		SglEventSet (gPool.Workers[k].hStart);
+	}
+
+	/*
+	// Wait for every worker to say it is leaving rather than for the
+	// threads themselves: this is called from DllMain, where the loader
+	// lock stops a thread from ever finishing while we wait for it.
+	*/
+	SglEventWait (gPool.hDone);
+
+	for (k = 1; k < gPool.nThreads; k++)
+	{
+	#if SGL_THREADS_WIN32
+		CloseHandle ((HANDLE) gPool.Workers[k].hThread);
+	#else
+		SglThreadJoin (gPool.Workers[k].hThread);
+	#endif
+		SglEventDestroy (gPool.Workers[k].hStart);
+	}
+
+	SglEventDestroy (gPool.hDone);
+	SglMutexDestroy (gPool.hLock);
+
+	gPool.nThreads = 1;
+}
+
+int SglThreadPoolCount (void)
+{
+	return (gPool.nThreads);
+}
+
+int SglThreadIndex (void)
+{
+	POOL_WORKER *pWorker = PoolSelf ();
+
+	return (pWorker ? pWorker->nThread : 0);
+}
+
+void SglThreadParallelFor (int nTasks, SGLTASKFN pfnTask, void *pContext)
+{
+	int k, nWorkers;
+	POOL_WORKER *pSelf;
+
+	if (nTasks <= 0)
+	{
+		return;
+	}
+
+	/*
+	// A nested call from a worker, or from the thread that started the
+	// current job, runs in place under that thread's own index so that
+	// it keeps using its own per-thread workspace.
+	*/
+	pSelf = PoolSelf ();
+
+	if (pSelf || (gPool.nThreads <= 1))
+	{
+		int nThread = pSelf ? pSelf->nThread : 0;
+
+		for (k = 0; k < nTasks; k++)
+		{
+			pfnTask (pContext, k, nThread);
+		}
+		return;
+	}
+
+	/*
+	// Any other thread waits for the pool. Running serially as thread 0
+	// instead would share thread 0's workspace with the current owner.
+	*/
+	SglMutexLock (gPool.hLock);
+	PoolSetSelf (&gPool.Workers[0]);
+
+	if (nTasks == 1)
+	{
+		pfnTask (pContext, 0, 0);
+	}
+	else
+	{
+		nWorkers = gPool.nThreads - 1;
+
+		if (nWorkers > nTasks - 1)
+		{
+			nWorkers = nTasks - 1;
+		}
+
+		gPool.pfnTask = pfnTask;
+		gPool.pContext = pContext;
+		gPool.nTasks = nTasks;
+		gPool.nNextTask = 0;
+		gPool.nActive = nWorkers;
+
+		for (k = 1; k <= nWorkers; k++)
+		{
+			SglEventSet (gPool.Workers[k].hStart);
+		}
+
+		PoolRunTasks (0);
+
+		SglEventWait (gPool.hDone);
+	}
+
+	PoolSetSelf (NULL);
+	SglMutexUnlock (gPool.hLock);
+}
+
+/*
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++	                		FPU mode in tasks			                     ++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ */
+
+sgl_uint32 SglThreadSetupFPU (int nThread)
+{
+#if SGL_THREADS_WIN32
+
+	sgl_uint32 uSaveFPU = 0;
+
+	if (nThread != 0)
+	{
+		uSaveFPU = _controlfp (0, 0);
+		_controlfp (_RC_CHOP | _PC_24, _MCW_RC | _MCW_PC);
+	}
+
+	return (uSaveFPU);
+
+#else
+
+	return (0);
+
+#endif
+}
+
+void SglThreadRestoreFPU (int nThread, sgl_uint32 uSaveFPU)
+{
+#if SGL_THREADS_WIN32
+
+	if (nThread != 0)
+	{
+		_controlfp (uSaveFPU, _MCW_RC | _MCW_PC);
+	}
+
+#endif
+}
+
+/* sglthrd.c */
@@ -0,0 +1,207 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: sglthrd.h,v $
+Title           :   SGLTHRD.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Portable thread services. A small set of primitives
+					(mutexes, events, threads and an atomic add) plus a
+					process wide pool of worker threads that can run a
+					set of independent tasks in parallel.
+
+					On builds without thread support (DOS32, MAC) the pool
+					always has a single thread and every task runs on the
+					calling thread, so callers never need a serial
+					special case of their own.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: sglthrd.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __SGLTHRD_H__
+#define __SGLTHRD_H__
+
+/*
+// Upper limit on the number of threads (including the calling thread)
+// that the pool will run.
+*/
+#define SGL_MAX_THREADS		16
+
+/*
+// Opaque handles for the primitives. The implementation is private to
+// sglthrd.c so that nobody else has to include windows.h or pthread.h
+*/
+typedef void *	SGLMUTEX;
+typedef void *	SGLEVENT;
+typedef void *	SGLTHREAD;
+
+/*===========================================
+ * Typedef:		SGLTASKFN
+ *===========================================
+ *
+ * Purpose:		Task callback run by SglThreadParallelFor. nTask is in the
+ *				range 0 to nTasks-1 and nThread identifies the pool thread
+ *				running it (0 is the thread that made the call), so callers
+ *				can index per-thread workspaces without any locking.
+ *========================================================================================*/
+typedef void (* SGLTASKFN)(void *pContext, int nTask, int nThread);
+
+typedef void (* SGLTHREADFN)(void *pContext);
+
+/*===========================================
+ * Function:	SglThreadPoolInit
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Start the worker pool. If nThreads is zero or less the count
+ *				is read from the [Threads] Count entry of sgl.ini, which
+ *				defaults to 1 (ie everything serial).
+ *
+ * Params:		int nThreads: total threads including the caller
+ *
+ * Return:		Number of threads actually available
+ *========================================================================================*/
+int  SglThreadPoolInit (int nThreads);
+
+/*===========================================
+ * Function:	SglThreadPoolShutdown
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Stop and release all the worker threads.
+ *
+ * Params:		void
+ *
+ * Return:		void
+ *========================================================================================*/
+void SglThreadPoolShutdown (void);
+
+/*===========================================
+ * Function:	SglThreadPoolCount
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the number of threads a parallel call may use. This
+ *				is the bound for any per-thread workspace arrays.
+ *
+ * Params:		void
+ *
+ * Return:		int: 1 .. SGL_MAX_THREADS
+ *========================================================================================*/
+int  SglThreadPoolCount (void);
+
+/*===========================================
+ * Function:	SglThreadIndex
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Returns the pool index of the calling thread; the same value
+ *				a task receives as nThread. Any thread that is not a pool
+ *				worker (the caller of SglThreadParallelFor included) is 0.
+ *				Only one outside thread uses the pool at a time, so only
+ *				one thread is ever running as 0 inside a parallel call.
+ *				For code that needs per-thread state but sits too far below
+ *				the task callback to be handed nThread.
+ *
+ * Params:		void
+ *
+ * Return:		int: 0 .. SglThreadPoolCount()-1
+ *========================================================================================*/
+int  SglThreadIndex (void);
+
+/*===========================================
+ * Function:	SglThreadParallelFor
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Run pfnTask for every task in 0..nTasks-1, handing tasks out
+ *				to the pool as threads become free. Returns once every task
+ *				has completed. A nested call from inside a task runs its
+ *				tasks serially in place, under the caller's own thread
+ *				index. A call from another thread while the pool is busy
+ *				waits for the current job to finish.
+ *
+ * Params:		int nTasks: number of tasks
+ *				SGLTASKFN pfnTask: task callback
+ *				void *pContext: passed through to the callback
+ *
+ * Return:		void
+ *========================================================================================*/
+void SglThreadParallelFor (int nTasks, SGLTASKFN pfnTask, void *pContext);
+
+/*===========================================
+ * Function:	SglAtomicAdd
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Atomically add nAdd to *pValue.
+ *
+ * Return:		sgl_int32: the value BEFORE the add
+ *========================================================================================*/
+sgl_int32 SglAtomicAdd (volatile sgl_int32 *pValue, sgl_int32 nAdd);
+
+/*===========================================
+ * Function:	SglThreadSetupFPU
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Gives a pool thread the FPU precision and rounding SetupFPU
+ *				gives the caller of a parallel call. SetupFPU keeps the
+ *				old mode in a single global, so tasks call this instead,
+ *				and SglThreadRestoreFPU at the end. Thread 0 already has
+ *				the mode and is left alone, as is every thread on builds
+ *				that don't set the mode.
+ *
+ * Params:		int nThread: the thread index the task was given
+ *
+ * Return:		sgl_uint32: the old mode, for SglThreadRestoreFPU
+ *========================================================================================*/
+sgl_uint32 SglThreadSetupFPU (int nThread);
+void	   SglThreadRestoreFPU (int nThread, sgl_uint32 uSaveFPU);
+
+/*
+// Mutexes
+*/
+SGLMUTEX SglMutexCreate (void);
+void	 SglMutexDestroy (SGLMUTEX hMutex);
+void	 SglMutexLock (SGLMUTEX hMutex);
+void	 SglMutexUnlock (SGLMUTEX hMutex);
+
+/*
+// Events. A manual reset event stays signalled until SglEventReset is
+// called, an auto reset event releases a single waiter.
+*/
+SGLEVENT SglEventCreate (sgl_bool bManualReset, sgl_bool bInitialState);
+void	 SglEventDestroy (SGLEVENT hEvent);
+void	 SglEventSet (SGLEVENT hEvent);
+void	 SglEventReset (SGLEVENT hEvent);
+void	 SglEventWait (SGLEVENT hEvent);
+
+/*
+// Threads. On builds without thread support SglThreadCreate runs the
+// function to completion immediately and returns a dummy handle.
+*/
+SGLTHREAD SglThreadCreate (SGLTHREADFN pfnThread, void *pContext);
+void	  SglThreadJoin (SGLTHREAD hThread);
+
+#endif /* __SGLTHRD_H__ */
+
+/* sglthrd.h */
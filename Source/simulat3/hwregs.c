@@ -83,12 +83,18 @@
  *
  *****************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
 #include "../sgl.h"
 #include "../sgl_defs.h"
+#include "syscon.h"
 #include "sabre.h"
 #include "hwsabsim.h"
+#include "smtexas.h"
 #include "../dvregion.h"
 #include "../hwinterf.h"
+#include "../sglthrd.h"
+#include "../frmpipe.h"
 
 
 /*
@@ -118,20 +124,214 @@ static sgl_bool		TexasBuffBInUse= FALSE;
 
 UINT32 NoOfSabres=0;
 
+/* read by the board set up (declared in smtexas.h) */
+UINT16	wPCIDeviceID = 0;
+
 
 UINT32	FogRegister;
 UINT32	NumRegionsReg;
 UINT32  ParamStartAddrReg;
 
 
+/* the ISP parameters of the frame being rendered */
+UINT32	* pSimISPStore;
+
+
+/*
+// The renderer runs on a thread of its own, so that building a frame can
+// overlap the render of the one before, as it does with real hardware.
+// The HWSet functions write to a pending copy of the registers, which
+// HWStartRender queues with the frame's fence. The render thread copies
+// each queued set into the globals above, which the renderer reads.
+//
+// The driver starts filling the parameter stores and changing the Texas
+// state as soon as HWStartRender returns, so a queued frame can't render
+// from the live ones. Each queue slot has its own copy of the ISP store
+// and of texture memory (which holds the TSP parameters), taken when the
+// frame is queued, and the slot isn't given up until the frame has been
+// rendered.
+*/
+typedef struct
+{
+	UINT32	FogRegister;
+	UINT32	NumRegionsReg;
+	UINT32	ParamStartAddrReg;
+
+} SIM_REGS;
+
+typedef struct
+{
+	SIM_REGS		Regs;
+	TEXAS_STATE		Texas;
+
+	UINT32			*pISPStore;
+	unsigned long	*pTextureMemory;
+
+	FRAME_FENCE		Fence;
+
+} SIM_RENDER;
+
+static SIM_REGS		PendingRegs;
+
+static SIM_RENDER	RenderQueue[FRAME_PIPE_MAX_DEPTH];
+static int			nQueueHead = 0;
+static int			nQueued = 0;
+
+static SGLMUTEX		QueueLock;
+static SGLEVENT		hQueued = NULL;
+static SGLTHREAD	hRenderThread = NULL;
+static sgl_bool		bRenderThreadTried = FALSE;
+static sgl_bool		bRenderThreadLive = FALSE;
+static sgl_bool		bRenderThreadGone = FALSE;
+
+
+/*
+// Runs the renderer on one frame's registers, state and stores.
+*/
+static void SimRender (const SIM_RENDER *pRender)
+{
+	FogRegister = pRender->Regs.FogRegister;
+	NumRegionsReg = pRender->Regs.NumRegionsReg;
+	ParamStartAddrReg = pRender->Regs.ParamStartAddrReg;
+
+	pSimISPStore = pRender->pISPStore;
+	TexasLoadState (&pRender->Texas, pRender->pTextureMemory);
+
+	/* call the simulated renderer */
+	
+	HWISPRenderer();
+}
+
+
+/*
+// Render thread: renders frames off the queue in order, forever. A frame
+// keeps its slot (and so its copy of the stores) until it is done.
+*/
+static void SimRenderThread (void *pContext)
+{
+	SIM_RENDER	*pRender;
+	FRAME_FENCE	Fence;
+
+	for (;;)
+	{
+		SglEventWait (hQueued);
+
+		/*
+		// Nothing is queued before the thread goes live, so getting here
+		// early means the build has no threads and this is running inline
+		*/
+		if (!bRenderThreadLive)
+		{
+			bRenderThreadGone = TRUE;
+			return;
+		}
+
+		for (;;)
+		{
+			SglMutexLock (QueueLock);
+
+			if (nQueued == 0)
+			{
+				SglMutexUnlock (QueueLock);
+				break;
+			}
+
+			pRender = &RenderQueue[nQueueHead];
+
+			SglMutexUnlock (QueueLock);
+
+			SimRender (pRender);
+
+			SglMutexLock (QueueLock);
+
+			Fence = pRender->Fence;
+
+			nQueueHead = (nQueueHead + 1) % FRAME_PIPE_MAX_DEPTH;
+			nQueued--;
+
+			SglMutexUnlock (QueueLock);
+
+			FramePipeRetire (Fence);
+		}
+	}
+}
+
+
+/*
+// Starts the render thread the first time it is wanted. With a pipeline
+// depth of 1, or if the thread or the copies of the stores can't be made,
+// frames are rendered inline from the live stores.
+*/
+static sgl_bool SimRenderThreadStarted (void)
+{
+	if (!bRenderThreadTried)
+	{
+		int	k;
+		sgl_bool bStores = TRUE;
+
+		bRenderThreadTried = TRUE;
+
+		if (FramePipeDepth () > 1)
+		{
+			for (k = 0; k < FRAME_PIPE_MAX_DEPTH; k++)
+			{
+				RenderQueue[k].pISPStore =
+					(UINT32 *) malloc (SABRE_MEM_SIZE * sizeof (UINT32));
+				RenderQueue[k].pTextureMemory =
+					(unsigned long *) malloc (sizeof (textureMemory));
+
+				if ((RenderQueue[k].pISPStore == NULL) ||
+					(RenderQueue[k].pTextureMemory == NULL))
+				{
+					bStores = FALSE;
+				}
+			}
+
+			if (bStores)
+			{
+				QueueLock = SglMutexCreate ();
+				hQueued = SglEventCreate (FALSE, FALSE);
+			}
+
+			if ((QueueLock != NULL) && (hQueued != NULL))
+			{
+				hRenderThread = SglThreadCreate (SimRenderThread, NULL);
+			}
+
+			if ((hRenderThread != NULL) && !bRenderThreadGone)
+			{
+				bRenderThreadLive = TRUE;
+				FramePipeSetSignalled (TRUE);
+			}
+			else
+			{
+				DPF ((DBG_WARNING, "Simulator renders inline"));
+
+				hRenderThread = NULL;
+
+				for (k = 0; k < FRAME_PIPE_MAX_DEPTH; k++)
+				{
+					free (RenderQueue[k].pISPStore);
+					free (RenderQueue[k].pTextureMemory);
+
+					RenderQueue[k].pISPStore = NULL;
+					RenderQueue[k].pTextureMemory = NULL;
+				}
+			}
+		}
+	}
+
+	return (hRenderThread != NULL);
+}
+
 
 void	HWSetFogRegister(UINT32	FogShiftValue)
 {
 	/* set a global register variable */ 	
 
-	FogRegister = FogShiftValue;   
+	PendingRegs.FogRegister = FogShiftValue;   
 
-	DPF((DBG_WARNING, "Not a warning... Fog level %lx", FogRegister));
+	DPF((DBG_WARNING, "Not a warning... Fog level %lx", FogShiftValue));
 }
 
 
@@ -145,7 +345,7 @@ void	HWSetRegionsRegister(UINT32	NumRegions)
 	// number of regions
 	*/
 	
-	NumRegionsReg = NumRegions-1;
+	PendingRegs.NumRegionsReg = NumRegions-1;
 }
 
 
@@ -159,11 +359,11 @@ void HWSetSabParamBuffRegister(const PARAM_BUFFER_IDS WhichBuffer)
 	*/ 	
 	if(WhichBuffer == PARAM_BUFFER_ID_A)
 	{
-		ParamStartAddrReg = pSabreStore;
+		PendingRegs.ParamStartAddrReg = pSabreStore;
 	}
 	else if(WhichBuffer == PARAM_BUFFER_ID_B)
 	{
-		ParamStartAddrReg = pSabreStore;
+		PendingRegs.ParamStartAddrReg = pSabreStore;
 	}
 	else
 	{
@@ -174,17 +374,17 @@ void HWSetSabParamBuffRegister(const PARAM_BUFFER_IDS WhichBuffer)
 void HWSetSabPtrRegister(const UINT32 RegionBase, const UINT32 RegionOffset)
 {
 	DPF((DBG_MESSAGE, "Setting sabre Region index to:0x%lx",RegionBase));
-	ParamStartAddrReg = RegionBase;
+	PendingRegs.ParamStartAddrReg = RegionBase;
 }
 
 
 
 
-int  HWFinishedRender(void)
+sgl_bool CALL_CONV HWFinishedRender(void)
 {
-	/* parameter store is always free with sim */
+	/* finished once the render thread has retired the last frame */
 
-	return 1;
+	return FramePipeIsDone (FramePipeLastIssued ());
 }
 
 
@@ -201,11 +401,58 @@ void	HWReset(void)
 
 void	HWStartRender()
 {
+	SIM_RENDER	*pRender;
+	SIM_RENDER	Render;
 
-	/* call the simulated renderer */
-	
-	HWISPRenderer();
+	if (!SimRenderThreadStarted ())
+	{
+		Render.Regs = PendingRegs;
+		TexasGetState (&Render.Texas);
+		Render.pISPStore = pSabreStore;
+		Render.pTextureMemory = textureMemory;
+
+		Render.Fence = FramePipeIssue ();
+
+		SimRender (&Render);
+		FramePipeRetire (Render.Fence);
+		return;
+	}
+
+	/*
+	// The frame pipeline keeps no more than its depth outstanding, but
+	// make sure there is a free slot
+	*/
+	SglMutexLock (QueueLock);
+
+	while (nQueued == FRAME_PIPE_MAX_DEPTH)
+	{
+		SglMutexUnlock (QueueLock);
+		FramePipeWait (FramePipeLastIssued () - (FRAME_PIPE_MAX_DEPTH - 1));
+		SglMutexLock (QueueLock);
+	}
+
+	pRender = &RenderQueue[(nQueueHead + nQueued) % FRAME_PIPE_MAX_DEPTH];
+
+	SglMutexUnlock (QueueLock);
+
+	/*
+	// The render thread doesn't look at a slot until it is counted in
+	// nQueued, so it can be filled in without the lock
+	*/
+	pRender->Regs = PendingRegs;
+	TexasGetState (&pRender->Texas);
+
+	memcpy (pRender->pISPStore, pSabreStore, SABRE_MEM_SIZE * sizeof (UINT32));
+	memcpy (pRender->pTextureMemory, textureMemory, sizeof (textureMemory));
 
+	SglMutexLock (QueueLock);
+
+	pRender->Fence = FramePipeIssue ();
+	nQueued++;
+
+	SglMutexUnlock (QueueLock);
+
+	SglEventSet (hQueued);
 }
 
 /**************************************************************************
@@ -523,6 +770,31 @@ void HWReleaseTexasParamMem(const PARAM_BUFFER_IDS TexasBufferIdAllocated)
 
 
 
+/**************************************************************************
+* Function Name  : HWSimISPStore
+* Inputs         : None
+* Outputs        : pu32Words - size of the store in words
+*
+* Returns        : the ISP parameter store
+*
+* Global Used    : pSabreStore
+*
+* Description    : Lets a tool load a frame's ISP parameters itself. Call
+*				   HWInitParamMem first.
+*
+**************************************************************************/
+
+UINT32 *HWSimISPStore(UINT32 *pu32Words)
+{
+	ASSERT(Allocated);
+
+	*pu32Words = SABRE_MEM_SIZE;
+
+	return pSabreStore;
+}
+
+
+
 /**************************************************************************
 * Function Name  : HWInitParamMem
 * Inputs         : 
@@ -95,6 +95,7 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "../sgl_defs.h"
 #include "../dlnodes.h"
@@ -108,8 +109,10 @@
 #include "../pvrlims.h"
 #include "../pkisp.h"
 #include "../sgl_math.h"
+#include "../sglmem.h"
+#include "../sglthrd.h"
 
-extern PARAM_BUF_MANAGEMENT_STRUCT ParamBufferInfo;
+extern UINT32 *pSimISPStore;	/* the frame's ISP parameters, see hwregs.c */
 
 
  /********************************************** 
@@ -266,33 +269,107 @@ void	HWISPRenderer()
 
 #else
 
-void	HWISPRenderer()	
+/*
+// Everything the ISP simulator carries from one plane to the next. The
+// serial renderer uses a single one, the tile parallel renderer has one
+// for each thread.
+*/
+typedef struct
+{
+	span_state		Span;
+	expand_state	Expand;
+	BOOL			secObj;
+	BOOL			firstObj;
+	BOOL			DumpFiles;
+	TEXAS_CONTEXT	*pTexas;
+} ISP_SIM_STATE;
+
+/*
+// One region of the object pointer list. pStartObjectData and curWord
+// locate the tile ID word (possibly via links), the entry state is the
+// pipeline state on arrival at the region and the position and size are
+// filled in as the region is processed.
+*/
+typedef struct
+{
+	UINT32			*pStartObjectData;
+	INT32			curWord;
+
+	expand_state	Expand;
+	BOOL			secObj;
+	BOOL			firstObj;
+
+	INT32			XRegionPos, YRegionPos;
+	INT32			XRegionSize, YRegionSize;
+} ISP_REGION;
+
+/*
+// What the render threads share
+*/
+typedef struct
+{
+	ISP_REGION		*pRegions;
+	ISP_SIM_STATE	*pStates;
+} ISP_PARALLEL_JOB;
+
+/*
+// ProcessRegion results
+*/
+#define REGION_DONE		0	/* another region follows */
+#define REGION_LAST		1	/* that was the last region */
+#define REGION_ERROR	2	/* more than 10 linked lists */
+#define REGION_SERIAL	3	/* parallel render declined, run serially */
+
+/*
+// Rows of the region grid: the y position and size fields are 10 bits
+// each, in units of NUM_SABRES lines
+*/
+#define MAX_REGION_ROWS	2048
+
+
+/**************************************************************************
+ * Function Name  : ProcessRegion
+ * Inputs         : pRegion - start of the region in the object pointers
+					Shade - FALSE to only step the instruction pipeline
+
+ * Outputs        : pNext - start of the following region
+ * Input/Output	  : pState - cell and pipeline state
+						  
+ * Returns        : REGION_DONE, REGION_LAST or REGION_ERROR
+ * Global Used    : pSimISPStore
+
+ * Description    : Renders one region, stepping across in spans of
+					NUM_SABRE_CELLS pixels and passing every plane of every
+					object through the cells for each span.
+
+					With Shade FALSE nothing is rendered, the object list is
+					only walked to find the next region and the pipeline
+					state on leaving this one. That is enough for the
+					parallel renderer to start each region on its own.
+ *				   
+ **************************************************************************/
+
+static int ProcessRegion(ISP_SIM_STATE *pState, ISP_REGION *pRegion,
+						 BOOL Shade, ISP_REGION *pNext)
 {
 	int 	FirstPete;
 	float   fMaxVal,fA,fB,fC;
 	UINT32	XYData;
 	UINT32	ObjectData;
 	INT32	Aparam,Bparam,Cparam;
-	UINT32	PlaneWord;
 
 	double	Creg40;
-	INT32	Ctop32;
 
-	INT32	U_plane_depth[NUM_SABRE_CELLS];  
-	UINT32	U_plane_id[NUM_SABRE_CELLS];
-	BOOL	shadow[NUM_SABRE_CELLS];
+	/* the results for each cell are read straight from its U registers */
+	INT32	*U_plane_depth = pState->Span.U_depth;
+	INT32	*U_plane_id = pState->Span.U_id;
+	INT32	*U_shadow = pState->Span.U_shadow;
 
 	cell_control	WideInstr;
 
-	INT32  	curWord = 0, safetyCnt = 0, curLocalWord = 0;
+	INT32  	curWord, safetyCnt = 0, curLocalWord;
 	INT32	ObjectOff;
 
-	static	BOOL	secObj;
-	static  BOOL	firstObj;
-
-	static	cell_state Cell[NUM_SABRE_CELLS];
-
-	INT32	Region;
 	INT32 	XRegionSize,YRegionSize;
 	INT32 	XRegionPos,YRegionPos;
 
@@ -302,7 +379,6 @@ void	HWISPRenderer()
 	BOOL	LastInRegion;
 	BOOL	DoneAllRegions;
 	BOOL	Translucent;
-	INT32	RegionCount;
 	INT32	fogFactor;
 	UINT32	cl;	
 	UINT32	Index;
@@ -313,529 +389,744 @@ void	HWISPRenderer()
 	INSTR_CODE_ENUMS	Instr;
 
 	double	Avalue;
-	float	Fplane;
-
-
-	secObj = FALSE;
-	firstObj = FALSE;
 
-	InitPowerTable();
-
-	/* Need to be called to open output files.
-	 */
-	InitTexasSimulator();
-
-	pStartObjectData = ParamBufferInfo.isp.pParamStore + ParamStartAddrReg;
-
-	/* Step through all the regions
-	 */ 
 	DoneAllRegions = FALSE;
 
-	RegionCount = 0;
+	pStartObjectData = pRegion->pStartObjectData;
+	curWord = pRegion->curWord;
+
 	pLocalStartObjectData = pStartObjectData;
 	curLocalWord =  curWord;
-	
-	while(!DoneAllRegions)
-	{
-		fprintf(stderr,"Region: %ld\n",(long)RegionCount);	
 
-		RegionCount++;
+	/* NEED TO CHECK IF ObjectData IS POINTER TO PARAMETER INFO OR
+	 * A LINK LIST POINTER.
+	 * Only do after tile ID.
+	 *
+	 */
+	ObjectData = *(pStartObjectData + curWord);
 
-		/* NEED TO CHECK IF ObjectData IS POINTER TO PARAMETER INFO OR
-		 * A LINK LIST POINTER.
-		 * Only do after tile ID.
+	/* Strip bit 31. PCX2 start of translucent pass bit.
+	 */
+	if ((ObjectData & 0x80000000UL) &&
+		(ObjectData & 0x20000000UL))
+	   ObjectData &= 0x5FFFFFFFUL;
+			
+	/* Used to handle linking of regions together.
+	 */
+	while (	((ObjectData & LINK_LIST_BIT) != 0) &&
+			(safetyCnt < 10))
+	{
+		/* Maximum of 10 link lists supported.
+		 */				
+		/* New start of object data.
 		 *
+		pStartObjectData = ObjectData & 0x0007FFFFL;
 		 */
-		ObjectData = *(pStartObjectData + curWord);
-
-		/* Strip bit 31. PCX2 start of translucent pass bit.
-		 */
-		if ((ObjectData & 0x80000000UL) &&
-			(ObjectData & 0x20000000UL))
-		   ObjectData &= 0x5FFFFFFFUL;
+		pStartObjectData = ObjectData & 0x00FFFFFFL;
 				
-		safetyCnt = 0;
-		
-		/* Used to handle linking of regions together.
-		 */
-		while (	((ObjectData & LINK_LIST_BIT) != 0) &&
-				(safetyCnt < 10))
-		{
-			/* Maximum of 10 link lists supported.
-			 */				
-			/* New start of object data.
-			 *
-			pStartObjectData = ObjectData & 0x0007FFFFL;
-			 */
-			pStartObjectData = ObjectData & 0x00FFFFFFL;
-					
-			curWord = 0;
-					
-			ObjectData = *pStartObjectData;
-			safetyCnt++;
-		}
+		curWord = 0;
 				
-		/* Error if more 10 linked lists.
-		 */
-		if (safetyCnt == 10)
-			return;
-					
-		/* Extract data from first word in region data
-		 */
-		XYData = *(pStartObjectData + curWord);
+		ObjectData = *pStartObjectData;
+		safetyCnt++;
+	}
+			
+	/* Error if more 10 linked lists.
+	 */
+	if (safetyCnt == 10)
+		return REGION_ERROR;
+				
+	/* Extract data from first word in region data
+	 */
+	XYData = *(pStartObjectData + curWord);
 
-		/* Make sure first word is xy data
-		 */
-		ASSERT( (XYData & 0x40000000L)!=0);
+	/* Make sure first word is xy data
+	 */
+	ASSERT( (XYData & 0x40000000L)!=0);
 
-		/* x region data is in multiples of number of cells
-		 */ 
-		XRegionSize = ( (XYData & 0x0000001FL) + 1 ) * NUM_SABRE_CELLS;
-		YRegionSize = ( ((XYData & 0x00007FE0L)>>5) + 1) * NUM_SABRES;
+	/* x region data is in multiples of number of cells
+	 */ 
+	XRegionSize = ( (XYData & 0x0000001FL) + 1 ) * NUM_SABRE_CELLS;
+	YRegionSize = ( ((XYData & 0x00007FE0L)>>5) + 1) * NUM_SABRES;
 
-		/* x pixel position of region start
-		 */
-		XRegionPos = ( (XYData & 0x000F8000L)>>15)*NUM_SABRE_CELLS;
+	/* x pixel position of region start
+	 */
+	XRegionPos = ( (XYData & 0x000F8000L)>>15)*NUM_SABRE_CELLS;
 
-		/* y pixel position of region start
-		 */
-		YRegionPos = ( (XYData & 0x3FF00000L)>>20)*NUM_SABRES;
+	/* y pixel position of region start
+	 */
+	YRegionPos = ( (XYData & 0x3FF00000L)>>20)*NUM_SABRES;
+
+	pRegion->XRegionPos = XRegionPos;
+	pRegion->YRegionPos = YRegionPos;
+	pRegion->XRegionSize = XRegionSize;
+	pRegion->YRegionSize = YRegionSize;
 
-		/* 
-		// render the current region, stepping across in steps of 32 pixels in x 
-		// and single lines in y for each 32 (NUM_SABRE_CELLS) span, all the
-		// planes for all the objects are passed through every cell 
-		*/
-		FirstPete=TRUE;
+	/* 
+	// render the current region, stepping across in steps of 32 pixels in x 
+	// and single lines in y for each 32 (NUM_SABRE_CELLS) span, all the
+	// planes for all the objects are passed through every cell 
+	*/
+	FirstPete=TRUE;
 
-   		for (YLine = YRegionPos; YLine<(YRegionPos+YRegionSize); YLine++) 
+	for (YLine = YRegionPos; YLine<(YRegionPos+YRegionSize); YLine++) 
+	{
+		for (XSpan = XRegionPos; XSpan<(XRegionPos+XRegionSize); XSpan+=NUM_SABRE_CELLS)
 		{
-			for (XSpan = XRegionPos; XSpan<(XRegionPos+XRegionSize); XSpan+=NUM_SABRE_CELLS)
+			sgl_bool	NoObjectYet;
+			
+			/********************************************************
+			 Run through all the planes for all the objects 
+			 for a single 32 pixel (NUM_SABRE_CELLS) span  	
+			*********************************************************/
+
+			LastInRegion = FALSE;
+
+		   	/* reset the state data for all the sabre cells
+		   	 */
+			memset(&pState->Span, 0, sizeof(span_state));
+
+			/* Use local copies of start address and position index to handle link
+			 * lists if present. Allows return to start of region if multiple linked 
+			 * objects in a region.
+			 */
+			pLocalStartObjectData = pStartObjectData;
+			curLocalWord = curWord;
+			
+			ObjectOff = 1;
+			NoObjectYet = TRUE;
+			
+			while (!LastInRegion) /* loop through all the objects for the region */
 			{
-				sgl_bool	NoObjectYet;
-				
-				/********************************************************
-				 Run through all the planes for all the objects 
-				 for a single 32 pixel (NUM_SABRE_CELLS) span  	
-				*********************************************************/
-
-				LastInRegion = FALSE;
-
-			   	/* reset the state data for all the sabre cells
-			   	 */
-			   	for(cl=0;cl<NUM_SABRE_CELLS;cl++)
-			   	{
-					Cell[cl].I_depth = 0;
-					Cell[cl].U_depth = 0;
-					Cell[cl].I_id = 0;
-					Cell[cl].U_id = 0;
-					Cell[cl].I_visib = FALSE;
-					Cell[cl].I_forward = FALSE;
-					Cell[cl].shad_temp = FALSE;
-					Cell[cl].U_visib = FALSE;
-					Cell[cl].U_shadow = FALSE;
-					Cell[cl].Delayed_clear_uid = FALSE;
-				}
+				/* Extract data for object
+				 */
+				ObjectData = *(pLocalStartObjectData + curLocalWord + ObjectOff);
+				 
+				/* Strip bit 31. PCX2 start of translucent pass bit.
+				 */
+				if ((ObjectData & 0x80000000UL) &&
+					(ObjectData & 0x20000000UL))
+				   ObjectData &= 0x5FFFFFFFUL;
 
-				/* Use local copies of start address and position index to handle link
-				 * lists if present. Allows return to start of region if multiple linked 
-				 * objects in a region.
+				/* Used to handle linking of objects together within one region.
 				 */
-				pLocalStartObjectData = pStartObjectData;
-				curLocalWord = curWord;
-				
-				ObjectOff = 1;
-				NoObjectYet = TRUE;
-				
-				while (!LastInRegion) /* loop through all the objects for the region */
+				while (	((ObjectData & LINK_LIST_BIT) != 0) &&
+						(safetyCnt < 10))
 				{
-					/* Extract data for object
-					 */
-					ObjectData = *(pLocalStartObjectData + curLocalWord + ObjectOff);
-					 
-					/* Strip bit 31. PCX2 start of translucent pass bit.
+					/* Maximum of 10 link lists supported.
+					 * New start of object data.
+					 *
+					pStartObjectData = (NextObjectData & 0x0007FFFFL);
 					 */
-					if ((ObjectData & 0x80000000UL) &&
-						(ObjectData & 0x20000000UL))
-					   ObjectData &= 0x5FFFFFFFUL;
+					pLocalStartObjectData = (ObjectData & 0x00FFFFFFL);
 
-					/* Used to handle linking of objects together within one region.
-					 */
-					while (	((ObjectData & LINK_LIST_BIT) != 0) &&
-							(safetyCnt < 10))
-					{
-						/* Maximum of 10 link lists supported.
-						 * New start of object data.
-						 *
-						pStartObjectData = (NextObjectData & 0x0007FFFFL);
-						 */
-						pLocalStartObjectData = (ObjectData & 0x00FFFFFFL);
-
-						curLocalWord = 0;
-						ObjectOff = 0;	/* to prevent skip of object pointer.	*/
-						
-						ObjectData = *pLocalStartObjectData;
+					curLocalWord = 0;
+					ObjectOff = 0;	/* to prevent skip of object pointer.	*/
+					
+					ObjectData = *pLocalStartObjectData;
 
-						safetyCnt++;
-					}
-				
-					/* Error if more 10 linked lists.
-					 */
-					if (safetyCnt == 10)
-						return;
+					safetyCnt++;
+				}
+			
+				/* Error if more 10 linked lists.
+				 */
+				if (safetyCnt == 10)
+					return REGION_ERROR;
 
-					NumPlanes = (ObjectData & 0x1FF80000L)>>19;
+				NumPlanes = (ObjectData & 0x1FF80000L)>>19;
 
-					PlaneOffAddr = (ObjectData & 0x0007FFFFL);
+				PlaneOffAddr = (ObjectData & 0x0007FFFFL);
 
-					PlaneAddr = ParamBufferInfo.isp.pParamStore + PlaneOffAddr;
+				PlaneAddr = pSimISPStore + PlaneOffAddr;
 
-					Translucent=FALSE;
-					for (Plane=0;Plane<NumPlanes;Plane++)
-					{
-						/*
-						// Unpack the 3 words... into A,B,C, instruction and
-						// index
-						//
-						// Offset 0 contains A param, the instruction,
-						// and the upper 6 bits of the 18 bit tag
-						*/
+				Translucent=FALSE;
+				for (Plane=0;Plane<NumPlanes;Plane++)
+				{
+					/*
+					// Unpack the 3 words... into A,B,C, instruction and
+					// index
+					//
+					// Offset 0 contains A param, the instruction,
+					// and the upper 6 bits of the 18 bit tag
+					*/
 
 #if PCX2
-						/* PCX2 version. Floating point, linked lists, 4 word parameter
-						 * format and perpendicular plane scaling.
-						 */
+					/* PCX2 version. Floating point, linked lists, 4 word parameter
+					 * format and perpendicular plane scaling.
+					 */
 /*
-						if(FirstPete && DUMP_PARAM_FILES == 1)
-						{
-							fprintf(FsabreFloat,"%08X %08X %08X %08X ",
-							PlaneAddr[0],PlaneAddr[1],PlaneAddr[2],PlaneAddr[3]);
-						}
+					if(FirstPete && DUMP_PARAM_FILES == 1)
+					{
+						fprintf(FsabreFloat,"%08X %08X %08X %08X ",
+						PlaneAddr[0],PlaneAddr[1],PlaneAddr[2],PlaneAddr[3]);
+					}
 */
 
-						fA=LONG_TO_FLOAT(PlaneAddr[0]);
-						fB=LONG_TO_FLOAT(PlaneAddr[1]);
-						fC=LONG_TO_FLOAT(PlaneAddr[2]);
+					fA=LONG_TO_FLOAT(PlaneAddr[0]);
+					fB=LONG_TO_FLOAT(PlaneAddr[1]);
+					fC=LONG_TO_FLOAT(PlaneAddr[2]);
 
-   						Instr = PlaneAddr[3] & 0xf;
-						Index = PlaneAddr[3] >> 4;
-						
-						/* If a perpendicular plane then scale.
+					Instr = PlaneAddr[3] & 0xf;
+					Index = PlaneAddr[3] >> 4;
+					
+					/* If a perpendicular plane then scale.
+					 */
+					if(Instr==2 || Instr==4 || Instr==0xA || Instr==0xC)
+					{
+					   	#define MAX_CENTRE  (1024.0f)
+						#define HALF_OFFSET (1024.0f)
+						fMaxVal = sfabs(fC) + 2.0f*MAX_CENTRE*(sfabs(fA) + sfabs(fB));
+
+						#undef MAX_CENTRE
+						#undef HALF_OFFSET
+
+						fMaxVal = ApproxRecip(fMaxVal);
+								
+						/* If PackTo20Bit() being used then need to correct for
+						 * overflow. ie x0.125.
+						 *
+						fMaxVal *= 0.125f;
 						 */
-						if(Instr==2 || Instr==4 || Instr==0xA || Instr==0xC)
-						{
-						   	#define MAX_CENTRE  (1024.0f)
-							#define HALF_OFFSET (1024.0f)
-							fMaxVal = sfabs(fC) + 2.0f*MAX_CENTRE*(sfabs(fA) + sfabs(fB));
-
-							#undef MAX_CENTRE
-							#undef HALF_OFFSET
-
-							fMaxVal = ApproxRecip(fMaxVal);
-									
-							/* If PackTo20Bit() being used then need to correct for
-							 * overflow. ie x0.125.
-							 *
-							fMaxVal *= 0.125f;
-							 */
-						}
-						else
-						{
-							/* If PackTo20Bit() being used then need to correct for
-							 * overflow. ie x0.125.
-							 *
-							fMaxVal = 0.125f;
-							 */
-							fMaxVal=1.0f;
-						}
-						Aparam = PackTo20Bit(fA * fMaxVal);
-						Bparam = PackTo20Bit(fB * fMaxVal);
-						Cparam = FLOAT_TO_FIXED * fC * fMaxVal;
+					}
+					else
+					{
+						/* If PackTo20Bit() being used then need to correct for
+						 * overflow. ie x0.125.
+						 *
+						fMaxVal = 0.125f;
+						 */
+						fMaxVal=1.0f;
+					}
+					Aparam = PackTo20Bit(fA * fMaxVal);
+					Bparam = PackTo20Bit(fB * fMaxVal);
+					Cparam = FLOAT_TO_FIXED * fC * fMaxVal;
 
-						if(FirstPete && DUMP_PARAM_FILES == 1)
-						{
+					if(FirstPete && DUMP_PARAM_FILES == 1)
+					{
 /*
-							fprintf(FsabreFloat,"%08X %08X %08X\n",
-									(Instr<<26) |((0x3f000 & Index) << 8) | Aparam,
-									Bparam|(Index<<20),
-									Cparam);
+						fprintf(FsabreFloat,"%08X %08X %08X\n",
+								(Instr<<26) |((0x3f000 & Index) << 8) | Aparam,
+								Bparam|(Index<<20),
+								Cparam);
 */
-						}
+					}
 #elif 0
-						/* PCX2 version. Floating point, linked lists, 4 word parameter
-						 * format. ie no perpendicular scaling.
-						 */
-						if(FirstPete && DUMP_PARAM_FILES == 1)
-						{
-							fprintf(FsabreFloat,"%X %X %X %X ",
-							PlaneAddr[0],PlaneAddr[1],PlaneAddr[2],PlaneAddr[3]);
-						}
-						Aparam = PackTo20Bit(LONG_TO_FLOAT(PlaneAddr[0]));
-						Bparam = PackTo20Bit(LONG_TO_FLOAT(PlaneAddr[1]));
-						Cparam = FLOAT_TO_FIXED*LONG_TO_FLOAT(PlaneAddr[2]);
+					/* PCX2 version. Floating point, linked lists, 4 word parameter
+					 * format. ie no perpendicular scaling.
+					 */
+					if(FirstPete && DUMP_PARAM_FILES == 1)
+					{
+						fprintf(FsabreFloat,"%X %X %X %X ",
+						PlaneAddr[0],PlaneAddr[1],PlaneAddr[2],PlaneAddr[3]);
+					}
+					Aparam = PackTo20Bit(LONG_TO_FLOAT(PlaneAddr[0]));
+					Bparam = PackTo20Bit(LONG_TO_FLOAT(PlaneAddr[1]));
+					Cparam = FLOAT_TO_FIXED*LONG_TO_FLOAT(PlaneAddr[2]);
 
-   						Instr = PlaneAddr[3] & 0xf;
-						Index = PlaneAddr[3] >> 4;
-						if(FirstPete && DUMP_PARAM_FILES == 1)
-						{
-							fprintf(FsabreFloat,"%X %X %X\n",Aparam,Bparam,Cparam);
-						}
+					Instr = PlaneAddr[3] & 0xf;
+					Index = PlaneAddr[3] >> 4;
+					if(FirstPete && DUMP_PARAM_FILES == 1)
+					{
+						fprintf(FsabreFloat,"%X %X %X\n",Aparam,Bparam,Cparam);
+					}
 #else
-						/* PCX1version.
-						 */
-						Aparam = PlaneAddr[0] & 0xFFFFF;
-						Instr  = PlaneAddr[0]  & 0x3c000000;
-						Index =  (PlaneAddr[0] >> (20 - 12)) & 0x3F000;
-							
-						/*
-						// Offset 1 contains the B param and lower 12 bits
-						*/
-					    Bparam = PlaneAddr[1] & 0xFFFFF;
-						Index |= PlaneAddr[1] >> 20;
+					/* PCX1version.
+					 */
+					Aparam = PlaneAddr[0] & 0xFFFFF;
+					Instr  = PlaneAddr[0]  & 0x3c000000;
+					Index =  (PlaneAddr[0] >> (20 - 12)) & 0x3F000;
+						
+					/*
+					// Offset 1 contains the B param and lower 12 bits
+					*/
+				    Bparam = PlaneAddr[1] & 0xFFFFF;
+					Index |= PlaneAddr[1] >> 20;
 
-						/*
-						// C is in offset 2
-						*/
-					    Cparam = PlaneAddr[2];			
+					/*
+					// C is in offset 2
+					*/
+				    Cparam = PlaneAddr[2];			
 #endif						
-						/*
-						// Advance the pointer
-						*/
-						PlaneAddr += WORDS_PER_PLANE;			
-
-						/* 
-						// must check to see if this is second object given 
-						// to sabre for this span 
-						*/
-						if ( (Instr == forw_visib_fp) || (Instr == forw_invis_fp)
-						    || (Instr == test_shad_forw_fp) )
-						{
-							if (NoObjectYet)
-		   	   				{
-	   							secObj=FALSE;
-	   							firstObj=TRUE;
-								NoObjectYet = FALSE;
-		   	   				}
-		   	   				else if ( (firstObj == TRUE) && (secObj == FALSE) )  	
-		   	   				{
-	   							firstObj=FALSE;
-	   							secObj=TRUE;
-		   	   				}
-	   		   				else
-							{
-	   	   						secObj=FALSE;
-							}
- 	   	   				}
+					/*
+					// Advance the pointer
+					*/
+					PlaneAddr += WORDS_PER_PLANE;			
 
-						if(Translucent==FALSE)
+					/* 
+					// must check to see if this is second object given 
+					// to sabre for this span 
+					*/
+					if ( (Instr == forw_visib_fp) || (Instr == forw_invis_fp)
+					    || (Instr == test_shad_forw_fp) )
+					{
+						if (NoObjectYet)
+	   	   				{
+   							pState->secObj=FALSE;
+   							pState->firstObj=TRUE;
+							NoObjectYet = FALSE;
+	   	   				}
+	   	   				else if ( (pState->firstObj == TRUE) && (pState->secObj == FALSE) )  	
+	   	   				{
+   							pState->firstObj=FALSE;
+   							pState->secObj=TRUE;
+	   	   				}
+   		   				else
 						{
-							/* decode compact instruction onto wide format
-							 */
-							WideInstr=ExpandInstruction(Instr, FALSE, secObj, FALSE);
+   	   						pState->secObj=FALSE;
+						}
+	   	   			}
 
+					if(Translucent==FALSE)
+					{
+						/* decode compact instruction onto wide format
+						 */
+						WideInstr=ExpandInstructionState(&pState->Expand, Instr,
+														 FALSE, pState->secObj, FALSE);
 
+						if(Shade)
+						{
 		   					/* calculate depth of current plane at x,y pixel position
 	    					 */
 		    	  			Creg40 = InitialCalc(XSpan, YLine, Aparam, Bparam, Cparam );
 
-							/* Creg40 is divided by 256
-							 */
-
 							 /* 
 							// Adder is 40 bits wide therefore C has to be kept as a 
-							// 40 bit number 
+							// 40 bit number. SpanProcess divides it by 256
+							// for each cell's comparator.
 							*/
-							Ctop32 = (long) (Creg40 * (3.90625E-3));
-
 							Avalue = (double) conv20_to_30(Aparam); 
 	
 	   		   				/* process the 32 'NUM_SABRE_CELLS' cells
 							 */
-							 for(cl=0; cl<NUM_SABRE_CELLS; cl++)
-							 {
-							 	U_plane_id[cl] = SurfProcess(&Cell[cl], WideInstr, Ctop32, Index, &shadow[cl], &U_plane_depth[cl]);
-
-								Creg40 += Avalue; 	
-
-								Ctop32 = (long) (Creg40*(3.90625E-3));/* Ctop32 which is passed to comparator in surf_process */
-							}	
-						}
-						if(Instr == begin_trans)
-						{
-							Translucent=TRUE;
+							SpanProcess(&pState->Span, WideInstr, Creg40, Avalue, Index);
 						}
-					} /* end of plane loop */
-
-					/*
-					// If this plane indicates the beginning of a new
-					// translucent pass, texas must 
-					//	be called so it can store the current span 
-					*/
-   					if (Translucent)
+					}
+					if(Instr == begin_trans)
 					{
-	   					for(cl=0;cl<NUM_SABRE_CELLS;cl++)
-	   					{
-							/*  
-							// return the fogging factor for visible depth 
-							//at pixel 
-							*/
-							fogFactor = Fog(U_plane_depth[cl]);
+						Translucent=TRUE;
+					}
+				} /* end of plane loop */
+
+				/*
+				// If this plane indicates the beginning of a new
+				// translucent pass, texas must 
+				//	be called so it can store the current span 
+				*/
+				if (Translucent && Shade)
+				{
+   					for(cl=0;cl<NUM_SABRE_CELLS;cl++)
+   					{
+						/*  
+						// return the fogging factor for visible depth 
+						//at pixel 
+						*/
+						fogFactor = Fog(U_plane_depth[cl]);
 
-							if(DUMP_PARAM_FILES==1)
+						if(DUMP_PARAM_FILES==1 && pState->DumpFiles)
+						{
+					  		if((XSpan+cl)%32==0)
 							{
-						  		if((XSpan+cl)%32==0)
-								{
-									fprintf(FtexasInputSabOutputFormat,
-									  "01%08lX\n",(YLine<<8)+((XSpan+cl)>>5));
-								}
 								fprintf(FtexasInputSabOutputFormat,
-										"00%08lX\n",
-								  (shadow[cl]<<28)+(fogFactor<<20)+U_plane_id[cl]);  
+								  "01%08lX\n",(YLine<<8)+((XSpan+cl)>>5));
+							}
+							fprintf(FtexasInputSabOutputFormat,
+									"00%08lX\n",
+							  ((U_shadow[cl] & 1)<<28)+(fogFactor<<20)+U_plane_id[cl]);  
 
-								fprintf(FtexasInput,
-		"%d %d %d %d %d\n",XSpan+cl,YLine,U_plane_id[cl],shadow[cl],fogFactor); 
+							fprintf(FtexasInput,
+	"%d %d %d %d %d\n",XSpan+cl,YLine,U_plane_id[cl],(U_shadow[cl] & 1),fogFactor); 
 
-					 		}
+				 		}
 
-	   		   				if(U_plane_id[cl])
-	   		   					Texas(XSpan+cl,YLine,U_plane_id[cl]<<1,
-										(unsigned char)shadow[cl],
-										(unsigned char) fogFactor);
-						}
+   		   				if(U_plane_id[cl])
+   		   					TexasCtx(pState->pTexas, XSpan+cl,YLine,U_plane_id[cl]<<1,
+									(unsigned char)(U_shadow[cl] & 1),
+									(unsigned char) fogFactor);
 					}
+				}
 
-					/*
-					// There are two things we must do to determine if this is
-					// the last object of the region..
-					//
-					// 1) If it is marked as the LAST Pointer, then there is
-					//	  no more data (pointers or regions)
-					//
-					// 2) If the above is not set, then check if the NEXT word
-					//	  is region data
-					*/
-					if(ObjectData & OBJ_VERY_LAST_PTR)
-					{
-						DoneAllRegions = TRUE;
-						LastInRegion = TRUE;
-					}
+				/*
+				// There are two things we must do to determine if this is
+				// the last object of the region..
+				//
+				// 1) If it is marked as the LAST Pointer, then there is
+				//	  no more data (pointers or regions)
+				//
+				// 2) If the above is not set, then check if the NEXT word
+				//	  is region data
+				*/
+				if(ObjectData & OBJ_VERY_LAST_PTR)
+				{
+					DoneAllRegions = TRUE;
+					LastInRegion = TRUE;
+				}
 
-					/*
-					// Else see if the next lot of data is the start of a 
-					// new region. ie is it a tile ID.
-					*/
-					else
-					{
-						UINT32	NextObjectData;
-					
-						NextObjectData =
-							*(pLocalStartObjectData + curLocalWord + ObjectOff + 1);
+				/*
+				// Else see if the next lot of data is the start of a 
+				// new region. ie is it a tile ID.
+				*/
+				else
+				{
+					UINT32	NextObjectData;
+				
+					NextObjectData =
+						*(pLocalStartObjectData + curLocalWord + ObjectOff + 1);
 
-						/* Strip bit 31. PCX2 start of translucent pass bit.
-						 */
-						if ((NextObjectData & 0x80000000UL) &&
-							(NextObjectData & 0x20000000UL))
-						   NextObjectData &= 0x5FFFFFFFUL;
-							
-						/* NEED TO CHECK IF NextObjectData IS POINTER TO PARAMETER INFO OR
-						 * A LINK LIST POINTER.
-						 * Simple check. Linking is performed else where.
+					/* Strip bit 31. PCX2 start of translucent pass bit.
+					 */
+					if ((NextObjectData & 0x80000000UL) &&
+						(NextObjectData & 0x20000000UL))
+					   NextObjectData &= 0x5FFFFFFFUL;
+						
+					/* NEED TO CHECK IF NextObjectData IS POINTER TO PARAMETER INFO OR
+					 * A LINK LIST POINTER.
+					 * Simple check. Linking is performed else where.
+					 */
+					if ((NextObjectData & LINK_LIST_BIT) != 0)
+					{
+						UINT32	*pStartObject;
+						safetyCnt = 0;
+						
+						/* Handle multiple linked lists.
 						 */
-						if ((NextObjectData & LINK_LIST_BIT) != 0)
+						while (	((NextObjectData & LINK_LIST_BIT) != 0) &&
+								(safetyCnt < 10))
 						{
-							UINT32	*pStartObject;
-							safetyCnt = 0;
+							pStartObject = (NextObjectData & 0x00FFFFFFL);
+							safetyCnt++;
 							
-							/* Handle multiple linked lists.
-							 */
-							while (	((NextObjectData & LINK_LIST_BIT) != 0) &&
-									(safetyCnt < 10))
-							{
-								pStartObject = (NextObjectData & 0x00FFFFFFL);
-								safetyCnt++;
-								
-								NextObjectData = *pStartObject;
-							}
-				
-							/* Error if more 10 linked lists.
-							 */
-							if (safetyCnt >= 10)
-								return;
-								
-							/* Check if last in region.
-							 */
-							LastInRegion = NextObjectData & REG_COMPULSARY_BITS;
-						}
-						else
-						{
-							/* Not a link list pointer. continue as normally.
-							 */
-							LastInRegion =
-								*(pLocalStartObjectData + curLocalWord + ObjectOff + 1) & 
-															REG_COMPULSARY_BITS;
+							NextObjectData = *pStartObject;
 						}
+			
+						/* Error if more 10 linked lists.
+						 */
+						if (safetyCnt >= 10)
+							return REGION_ERROR;
+							
+						/* Check if last in region.
+						 */
+						LastInRegion = NextObjectData & REG_COMPULSARY_BITS;
 					}
+					else
+					{
+						/* Not a link list pointer. continue as normally.
+						 */
+						LastInRegion =
+							*(pLocalStartObjectData + curLocalWord + ObjectOff + 1) & 
+														REG_COMPULSARY_BITS;
+					}
+				}
+				
+				/* Is the next word a tile ID or is current object last in last tile.
+				 */
+   	   			if (LastInRegion && Shade)
+	   			{
+					/*
+					// First issue a flush down the pipeline
+					// NOTE only the "do_flush" is imporatant here
+					*/
+				#if 1
+  		  			WideInstr=ExpandInstructionState(&pState->Expand, Instr,
+													 FALSE, FALSE, TRUE);
+					SpanProcess(&pState->Span, WideInstr, 0.0, 0.0, 0);
 					
-					/* Is the next word a tile ID or is current object last in last tile.
-					 */
-	   	   			if (LastInRegion)
-		   			{
-						/*
-						// First issue a flush down the pipeline
-						// NOTE only the "do_flush" is imporatant here
-						*/
-					#if 1
-   		  				WideInstr=ExpandInstruction(Instr, FALSE, FALSE, TRUE);
-		   	    		for(cl = 0; cl < NUM_SABRE_CELLS; cl++)
-						{
-		   					U_plane_id[cl] = SurfProcess(&Cell[cl], WideInstr, 
-									0, 0,&shadow[cl], &U_plane_depth[cl]);
-						}
-						
-					#endif
-		   	    		for(cl = 0; cl < NUM_SABRE_CELLS; cl++)
-		   	    		{
-							/*  return the fogging factor for visible depth at pixel
-							 */
-							fogFactor = Fog(U_plane_depth[cl]);
+				#endif
+	   	    		for(cl = 0; cl < NUM_SABRE_CELLS; cl++)
+	   	    		{
+						/*  return the fogging factor for visible depth at pixel
+						 */
+						fogFactor = Fog(U_plane_depth[cl]);
 
-if(DUMP_PARAM_FILES==1)
+if(DUMP_PARAM_FILES==1 && pState->DumpFiles)
 {
 	if((XSpan+cl)%32==0)
 	{
 		fprintf(FtexasInputSabOutputFormat,"01%08lX\n",(YLine<<8)+((XSpan+cl)>>5));
 	}
 	fprintf(FtexasInputSabOutputFormat,
-		 "00%08lX\n",(shadow[cl]<<28)+(fogFactor<<20)+U_plane_id[cl]);  
+		 "00%08lX\n",((U_shadow[cl] & 1)<<28)+(fogFactor<<20)+U_plane_id[cl]);  
 
 	fprintf(FtexasInput,
-		"%d %d %d %d %d\n",XSpan+cl,YLine,U_plane_id[cl],shadow[cl],fogFactor);
+		"%d %d %d %d %d\n",XSpan+cl,YLine,U_plane_id[cl],(U_shadow[cl] & 1),fogFactor);
 }
 
-	   						if(U_plane_id[cl])
-   								Texas(	XSpan+cl, YLine, U_plane_id[cl] << 1,
-   										(unsigned char)shadow[cl], (unsigned char) fogFactor);
-			  	 		}
-					}
+   						if(U_plane_id[cl])
+							TexasCtx(pState->pTexas, XSpan+cl, YLine, U_plane_id[cl] << 1,
+									(unsigned char)(U_shadow[cl] & 1), (unsigned char) fogFactor);
+		  	 		}
+				}
 
-	   				ObjectOff++;
+   				ObjectOff++;
 
-			  	} /* while for all objects in region */
+		  	} /* while for all objects in region */
 
-				FirstPete=FALSE;
-			} /* x spans */
+			FirstPete=FALSE;
+		} /* x spans */
 
-		} /*y line */
+	} /*y line */
 
-		/* Move to data for next region
-		 */
-		curWord = curLocalWord + ObjectOff;
-		
-		/* Used to set start address to one before next region ID. Needed for linked
-		 * list support. Doesn't effect ordinary ISP object pointers. ie unlinked case.
-		 */
-		pStartObjectData = pLocalStartObjectData;
-	} /*  regions loop */
+	/* Move to data for next region
+	 */
+	pNext->curWord = curLocalWord + ObjectOff;
+	
+	/* Used to set start address to one before next region ID. Needed for linked
+	 * list support. Doesn't effect ordinary ISP object pointers. ie unlinked case.
+	 */
+	pNext->pStartObjectData = pLocalStartObjectData;
+
+	return (DoneAllRegions ? REGION_LAST : REGION_DONE);
+}
+
+
+/**************************************************************************
+ * Function Name  : RenderRegionTask
+ * Inputs         : pContext - the ISP_PARALLEL_JOB
+					nTask - region to render
+					nThread - which pool thread we are on
+ * Outputs        :  
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Thread pool task. Renders one region with the calling
+					thread's own cell and texas state, starting from the
+					pipeline state recorded for the region by the scan.
+ **************************************************************************/
+
+static void RenderRegionTask(void *pContext, int nTask, int nThread)
+{
+	ISP_PARALLEL_JOB	*pJob = (ISP_PARALLEL_JOB *) pContext;
+	ISP_SIM_STATE		*pState = &pJob->pStates[nThread];
+	ISP_REGION			*pRegion = &pJob->pRegions[nTask];
+	ISP_REGION			Next;
+
+	pState->Expand = pRegion->Expand;
+	pState->secObj = pRegion->secObj;
+	pState->firstObj = pRegion->firstObj;
+
+	ProcessRegion(pState, pRegion, TRUE, &Next);
+}
+
+
+/**************************************************************************
+ * Function Name  : RenderParallel
+ * Inputs         : pFirst - start of the first region
+
+ * Outputs        :  
+ * Input/Output	  : pExpand - pipeline state carried between frames
+						  
+ * Returns        : REGION_LAST when the frame has been rendered, or
+					REGION_SERIAL if it has to be rendered serially instead
+ * Global Used    : 
+
+ * Description    : Tile parallel version of the region loop. A first pass
+					walks the object pointers without rendering anything,
+					recording where each region starts and the pipeline
+					state on the way in. The regions are then rendered by
+					the thread pool, each thread with its own cells and
+					texas state. Regions cover separate pixels, so the
+					frame buffer comes out exactly as the serial loop
+					leaves it.
+
+					The params/ dump files record pixels in the order they
+					are rendered, so they are not written in this mode.
+ **************************************************************************/
+
+static int RenderParallel(ISP_REGION *pFirst, expand_state *pExpand)
+{
+	static ISP_SIM_STATE	States[SGL_MAX_THREADS];
+	static TEXAS_CONTEXT	TexasStates[SGL_MAX_THREADS];
+	static UINT32			RowCover[MAX_REGION_ROWS];
+
+	ISP_SIM_STATE		Scan;
+	ISP_REGION			Region;
+	ISP_REGION			*pRegions, *pNewRegions;
+	ISP_PARALLEL_JOB	Job;
+	int					nRegions, nAllocated, nThreads;
+	int					Status, i, j;
+
+	nThreads = SglThreadPoolCount();
+
+	nAllocated = 64;
+	pRegions = SGLMalloc (nAllocated * sizeof(ISP_REGION));
+
+	if (!pRegions)
+	{
+		return REGION_SERIAL;
+	}
+
+	Scan.Expand = *pExpand;
+	Scan.secObj = FALSE;
+	Scan.firstObj = FALSE;
+	Scan.DumpFiles = FALSE;
+	Scan.pTexas = NULL;
+
+	Region = *pFirst;
+	nRegions = 0;
+
+	/*
+	// Scan pass
+	*/
+	do
+	{
+		if (nRegions == nAllocated)
+		{
+			nAllocated *= 2;
+			pNewRegions = SGLRealloc (pRegions, nAllocated * sizeof(ISP_REGION));
+
+			if (!pNewRegions)
+			{
+				SGLFree (pRegions);
+				return REGION_SERIAL;
+			}
+
+			pRegions = pNewRegions;
+		}
+
+		Region.Expand = Scan.Expand;
+		Region.secObj = Scan.secObj;
+		Region.firstObj = Scan.firstObj;
+
+		pRegions[nRegions] = Region;
+
+		Status = ProcessRegion(&Scan, &pRegions[nRegions], FALSE, &Region);
+
+		nRegions++;
+
+	} while (Status == REGION_DONE);
+
+	/*
+	// A broken object list, or a region that is rendered more than once,
+	// depends on the serial order
+	*/
+	if (Status == REGION_ERROR)
+	{
+		SGLFree (pRegions);
+		return REGION_SERIAL;
+	}
+
+	/*
+	// Regions sit on a grid of 32 pixel columns by NUM_SABRES lines, so
+	// mark each region's cells in a coverage map with one word per row
+	// of the grid. A cell that is already marked means an overlap.
+	*/
+	memset (RowCover, 0, sizeof(RowCover));
+
+	for (i = 0; i < nRegions; i++)
+	{
+		ISP_REGION	*pA = &pRegions[i];
+		UINT32		ColMask;
+		int			XCell, XCells, YRow, YRows;
+
+		XCell = pA->XRegionPos / NUM_SABRE_CELLS;
+		XCells = pA->XRegionSize / NUM_SABRE_CELLS;
+		YRow = pA->YRegionPos / NUM_SABRES;
+		YRows = pA->YRegionSize / NUM_SABRES;
+
+		ColMask = (XCells >= 32) ? 0xFFFFFFFFUL : ((1UL << XCells) - 1);
+		ColMask <<= XCell;
+
+		for (j = YRow; (j < YRow + YRows) && (j < MAX_REGION_ROWS); j++)
+		{
+			if (RowCover[j] & ColMask)
+			{
+				SGLFree (pRegions);
+				return REGION_SERIAL;
+			}
+
+			RowCover[j] |= ColMask;
+		}
+	}
+
+	/*
+	// Render pass
+	*/
+	for (i = 0; i < nThreads; i++)
+	{
+		InitTexasContext (&TexasStates[i], FALSE);
+
+		States[i].DumpFiles = FALSE;
+		States[i].pTexas = &TexasStates[i];
+	}
+
+	Job.pRegions = pRegions;
+	Job.pStates = States;
+
+	SglThreadParallelFor (nRegions, RenderRegionTask, &Job);
+
+	for (i = 0; i < nThreads; i++)
+	{
+		TexasTraceFlushContext (&TexasStates[i]);
+	}
+
+	*pExpand = Scan.Expand;
+
+	SGLFree (pRegions);
+
+	return REGION_LAST;
+}
+
+
+void	HWISPRenderer()	
+{
+	/*
+	// The instruction pipeline state carries over from one frame to the
+	// next, as it did when it lived inside ExpandInstruction.
+	*/
+	static expand_state	Expand;
+
+	static ISP_SIM_STATE	State;
+
+	ISP_REGION	Region;
+	INT32		RegionCount;
+	int			Status;
+
+	InitPowerTable();
+
+	/* Need to be called to open output files.
+	 */
+	InitTexasSimulator();
+
+	Region.pStartObjectData = pSimISPStore + ParamStartAddrReg;
+	Region.curWord = 0;
+
+	/*
+	// Render the regions on the thread pool if there is one ([Threads]
+	// Count in sgl.ini). The texas cache models need the regions in
+	// order, so they keep it serial.
+	*/
+	if ((SglThreadPoolCount() > 1) && !TexasCacheModel)
+	{
+		if (RenderParallel(&Region, &Expand) == REGION_LAST)
+		{
+			FinishTexasSimulator();
+			return;
+		}
+	}
+
+	State.Expand = Expand;
+	State.secObj = FALSE;
+	State.firstObj = FALSE;
+	State.DumpFiles = TexasDumpFiles;
+	State.pTexas = &TexasContext;
+
+	/* Step through all the regions
+	 */ 
+	RegionCount = 0;
+
+	do
+	{
+		TexasCacheRegion(RegionCount);
+
+		RegionCount++;
+
+		Status = ProcessRegion(&State, &Region, TRUE, &Region);
+
+	} while (Status == REGION_DONE);
+
+	Expand = State.Expand;
+
+	/* Error if more 10 linked lists.
+	 */
+	if (Status == REGION_ERROR)
+		return;
 
 	FinishTexasSimulator();
 }
@@ -59,6 +59,8 @@
 #define BOOL long
 #endif
 
+#include "hwsabsim.h"
+
 
 
 /* size of mantissa for A and B values */
@@ -183,26 +185,27 @@ cell_control	wideCom(int i,int u,int shad,BOOL pvis,BOOL clearUid,
 
 
 /**************************************************************************
- * Function Name  : ExpandInstruction
+ * Function Name  : ExpandInstructionState
  * Inputs         : instr
 					do_nop
 					sec_object
+					do_flush
  * Outputs        :  
- * Input/Output	  : 
+ * Input/Output	  : state - previous instruction carried between planes
 						  
  * Returns        : cell_control
  * Global Used    : 
- * Description    : Expands plane instruction from compact form to wide format
- * 					used internally  
- *					
+ * Description    : As ExpandInstruction, but the caller owns the state that
+ *					carries over from one plane to the next. This lets each
+ *					render thread run its own pipeline.
  *				   
  **************************************************************************/
 
-cell_control ExpandInstruction(int instr,BOOL do_nop,BOOL sec_object, 
-								   BOOL do_flush)
+cell_control ExpandInstructionState(expand_state *state, int instr,
+									BOOL do_nop, BOOL sec_object,
+									BOOL do_flush)
 {
-	static int prev_intern;
-	static int prev_intern_out;
+	int prev_intern;
 	cell_control wide;
 
 	if (do_nop)
@@ -321,7 +324,7 @@ cell_control ExpandInstruction(int instr,BOOL do_nop,BOOL sec_object,
 
 
 
-		switch(prev_intern_out)
+		switch(state->prev_intern_out)
 		{
 			case prev_shad_forw:
 				wide.test_shad=test_shad_closer;
@@ -351,7 +354,7 @@ cell_control ExpandInstruction(int instr,BOOL do_nop,BOOL sec_object,
 
 		}
 
-	prev_intern_out=prev_intern;
+	state->prev_intern_out=prev_intern;
 
 	}
 
@@ -362,6 +365,31 @@ cell_control ExpandInstruction(int instr,BOOL do_nop,BOOL sec_object,
 
 
 
+/**************************************************************************
+ * Function Name  : ExpandInstruction
+ * Inputs         : instr
+					do_nop
+					sec_object
+ * Outputs        :  
+ * Input/Output	  : 
+						  
+ * Returns        : cell_control
+ * Global Used    : 
+ * Description    : Expands plane instruction from compact form to wide format
+ * 					used internally. Keeps its own copy of the previous
+ *					instruction state, see ExpandInstructionState.
+ *				   
+ **************************************************************************/
+
+cell_control ExpandInstruction(int instr,BOOL do_nop,BOOL sec_object, 
+								   BOOL do_flush)
+{
+	static expand_state state;
+
+	return ExpandInstructionState(&state, instr, do_nop, sec_object, do_flush);
+}
+
+
 /**************************************************************************
  * Function Name  : SurfProcess
  * Inputs         : instruction - this is in the internal wide format
@@ -626,5 +654,291 @@ int	SurfProcess(cell_state *cell,cell_control	instruction,long	C,unsigned long i
 }
 
 
+/*
+** Vector helpers for SpanProcess. Each "lanes" value holds SPAN_LANES
+** cells; the AVX2 or SSE2 version is picked when the compiler targets it,
+** otherwise the lanes are plain ints and the loop runs a cell at a time.
+*/
+
+#if defined (__AVX2__)
+
+#include <immintrin.h>
+
+#define SPAN_LANES		8
+
+typedef __m256i lanes;
+
+#define L_LOAD(p)		_mm256_loadu_si256 ((const __m256i *) (p))
+#define L_STORE(p,a)	_mm256_storeu_si256 ((__m256i *) (p), (a))
+#define L_SET(x)		_mm256_set1_epi32 (x)
+#define L_AND(a,b)		_mm256_and_si256 ((a), (b))
+#define L_OR(a,b)		_mm256_or_si256 ((a), (b))
+#define L_ANDNOT(a,b)	_mm256_andnot_si256 ((a), (b))
+#define L_GT(a,b)		_mm256_cmpgt_epi32 ((a), (b))
+
+static lanes SpanDepth (double Creg40, double Avalue, int cl)
+{
+	__m256d	base = _mm256_set1_pd (Creg40);
+	__m256d	a = _mm256_set1_pd (Avalue);
+	__m256d	scale = _mm256_set1_pd (3.90625E-3);
+	__m256d	lo, hi;
+
+	lo = _mm256_set_pd (cl+3, cl+2, cl+1, cl);
+	hi = _mm256_set_pd (cl+7, cl+6, cl+5, cl+4);
+
+	lo = _mm256_mul_pd (_mm256_add_pd (base, _mm256_mul_pd (lo, a)), scale);
+	hi = _mm256_mul_pd (_mm256_add_pd (base, _mm256_mul_pd (hi, a)), scale);
+
+	return _mm256_inserti128_si256 (
+				_mm256_castsi128_si256 (_mm256_cvttpd_epi32 (lo)),
+				_mm256_cvttpd_epi32 (hi), 1);
+}
+
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+
+#include <emmintrin.h>
+
+#define SPAN_LANES		4
+
+typedef __m128i lanes;
+
+#define L_LOAD(p)		_mm_loadu_si128 ((const __m128i *) (p))
+#define L_STORE(p,a)	_mm_storeu_si128 ((__m128i *) (p), (a))
+#define L_SET(x)		_mm_set1_epi32 (x)
+#define L_AND(a,b)		_mm_and_si128 ((a), (b))
+#define L_OR(a,b)		_mm_or_si128 ((a), (b))
+#define L_ANDNOT(a,b)	_mm_andnot_si128 ((a), (b))
+#define L_GT(a,b)		_mm_cmpgt_epi32 ((a), (b))
+
+static lanes SpanDepth (double Creg40, double Avalue, int cl)
+{
+	__m128d	base = _mm_set1_pd (Creg40);
+	__m128d	a = _mm_set1_pd (Avalue);
+	__m128d	scale = _mm_set1_pd (3.90625E-3);
+	__m128d	lo, hi;
+
+	lo = _mm_set_pd (cl+1, cl);
+	hi = _mm_set_pd (cl+3, cl+2);
+
+	lo = _mm_mul_pd (_mm_add_pd (base, _mm_mul_pd (lo, a)), scale);
+	hi = _mm_mul_pd (_mm_add_pd (base, _mm_mul_pd (hi, a)), scale);
+
+	return _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (lo), _mm_cvttpd_epi32 (hi));
+}
+
+#else
+
+#define SPAN_LANES		1
+
+typedef INT32 lanes;
+
+#define L_LOAD(p)		(*(p))
+#define L_STORE(p,a)	(*(p) = (a))
+#define L_SET(x)		((INT32) (x))
+#define L_AND(a,b)		((a) & (b))
+#define L_OR(a,b)		((a) | (b))
+#define L_ANDNOT(a,b)	(~(a) & (b))
+#define L_GT(a,b)		(((a) > (b)) ? ~0 : 0)
+
+static lanes SpanDepth (double Creg40, double Avalue, int cl)
+{
+	return (INT32) ((Creg40 + cl * Avalue) * (3.90625E-3));
+}
+
+#endif
+
+#define L_NOT(a)		L_ANDNOT ((a), L_SET (~0))
+#define L_SEL(m,a,b)	L_OR (L_AND ((m), (a)), L_ANDNOT ((m), (b)))
+
+
+/**************************************************************************
+ * Function Name  : SpanProcess
+ * Inputs         : instruction - this is in the internal wide format
+					Creg40 - depth of the plane at the first cell, times 256
+					Avalue - depth increment from one cell to the next
+					index - planes id
+
+ * Outputs        :  
+ * Input/Output	  : span - the state of every cell in the span
+						  
+ * Returns        : 
+ * Global Used    : 
+ * Description    : Passes one plane through all NUM_SABRE_CELLS cells. This
+					gives exactly the same results as calling SurfProcess
+					for each cell in turn with the C value stepped by
+					Avalue, but works on SPAN_LANES cells at once.
+
+					The C values are integers held in doubles, so cell cl
+					can be computed directly as Creg40 + cl*Avalue without
+					changing the result.
+
+					The results for each cell are its U_id, U_depth and
+					U_shadow entries.
+ *
+ **************************************************************************/
+
+void	SpanProcess(span_state *span, cell_control instruction,
+					double Creg40, double Avalue, unsigned long index)
+{
+	lanes	Zero = L_SET (0);
+	lanes	Ones = L_SET (~0);
+	lanes	Index = L_SET (index);
+	lanes	PlaneVisib = instruction.plane_visib ? Ones : Zero;
+	int		cl;
+
+	for (cl = 0; cl < NUM_SABRE_CELLS; cl += SPAN_LANES)
+	{
+		lanes	C, mux, gte, lte, sign, cond;
+		lanes	I_depth, U_depth, I_id, U_id;
+		lanes	I_visib, I_forward, shad_temp, U_visib, U_shadow;
+		lanes	I_RE, I_visib_new, I_forward_new;
+		lanes	U_RE, U_visib_new, U_shadow_new, shad_temp_new;
+
+		C = SpanDepth (Creg40, Avalue, cl);
+
+		I_depth   = L_LOAD (&span->I_depth[cl]);
+		U_depth   = L_LOAD (&span->U_depth[cl]);
+		I_id      = L_LOAD (&span->I_id[cl]);
+		U_id      = L_LOAD (&span->U_id[cl]);
+		I_visib   = L_LOAD (&span->I_visib[cl]);
+		I_forward = L_LOAD (&span->I_forward[cl]);
+		shad_temp = L_LOAD (&span->shad_temp[cl]);
+		U_visib   = L_LOAD (&span->U_visib[cl]);
+		U_shadow  = L_LOAD (&span->U_shadow[cl]);
+
+		if (instruction.delayed_clear_u_id)
+		{
+			U_id = Zero;
+		}
+
+		/* sign bit of C, the multiplexor and the comparator */
+
+		sign = L_GT (Zero, C);
+
+		mux = instruction.mux_sel ? U_depth : C;
+
+		gte = L_NOT (L_GT (mux, I_depth));
+		lte = L_NOT (L_GT (I_depth, mux));
+
+		switch (instruction.i_load)
+		{
+			case load_i_nop:
+				I_RE = Zero;
+				I_visib_new = I_visib;
+				I_forward_new = I_forward;
+				break;
+
+			case load_i:
+				I_RE = Ones;
+				I_visib_new = PlaneVisib;
+				I_forward_new = Ones;
+				break;
+
+			case load_i_further:
+				cond = instruction.plane_perp ? sign : gte;
+
+				I_RE = cond;
+				I_visib_new = L_SEL (cond, PlaneVisib, I_visib);
+				I_forward_new = L_OR (cond, I_forward);
+				break;
+
+			case load_i_closer:
+				cond = L_NOT (gte);
+
+				I_RE = cond;
+				I_visib_new = L_SEL (cond, PlaneVisib, I_visib);
+				I_forward_new = L_ANDNOT (cond, I_forward);
+				break;
+
+			case load_i_invis_forw:
+				cond = L_ANDNOT (I_visib, I_forward);
+
+				I_RE = cond;
+				I_visib_new = L_SEL (cond, PlaneVisib, I_visib);
+				I_forward_new = L_ANDNOT (cond, I_forward);
+				break;
+
+			default:
+				I_RE = Zero;
+				I_visib_new = Zero;
+				I_forward_new = Zero;
+				break;
+		}
+
+		/* U_ID_RE is always the same as U_RE */
+
+		switch (instruction.u_load)
+		{
+			case load_u_nop:
+				U_RE = Zero;
+				U_visib_new = U_visib;
+				break;
+
+			case load_u:
+				U_RE = Ones;
+				U_visib_new = I_visib;
+				break;
+
+			case load_u_closer:
+				U_RE = L_OR (L_AND (gte, I_visib), L_NOT (U_visib));
+				U_visib_new = L_SEL (U_RE, I_visib, U_visib);
+				break;
+
+			default:
+				U_RE = Zero;
+				U_visib_new = Zero;
+				break;
+		}
+
+		switch (instruction.test_shad)
+		{
+			case test_shad_nop:
+				U_shadow_new = U_shadow;
+				shad_temp_new = shad_temp;
+				break;
+
+			case test_shad_closer:
+				U_shadow_new = U_shadow;
+				shad_temp_new = L_NOT (lte);
+				break;
+
+			case test_shadow_further:
+				U_shadow_new = L_OR (U_shadow, L_AND (lte, shad_temp));
+				shad_temp_new = shad_temp;
+				break;
+
+			case test_light_further:
+				U_shadow_new = L_ANDNOT (L_AND (lte, shad_temp), U_shadow);
+				shad_temp_new = shad_temp;
+				break;
+
+			default:
+				U_shadow_new = Zero;
+				shad_temp_new = Zero;
+				break;
+		}
+
+		/* a U register load clears the shadow flags */
+
+		U_shadow_new = L_ANDNOT (U_RE, U_shadow_new);
+		shad_temp_new = L_ANDNOT (U_RE, shad_temp_new);
+
+		/* process the registers */
+
+		L_STORE (&span->U_depth[cl], L_SEL (U_RE, I_depth, U_depth));
+		L_STORE (&span->U_id[cl], L_SEL (U_RE, I_id, U_id));
+
+		L_STORE (&span->I_depth[cl], L_SEL (I_RE, C, I_depth));
+		L_STORE (&span->I_id[cl], L_SEL (I_RE, Index, I_id));
+
+		L_STORE (&span->I_visib[cl], I_visib_new);
+		L_STORE (&span->I_forward[cl], I_forward_new);
+		L_STORE (&span->shad_temp[cl], shad_temp_new);
+		L_STORE (&span->U_visib[cl], U_visib_new);
+		L_STORE (&span->U_shadow[cl], U_shadow_new);
+	}
+}
+
+
 
 /*---------------------------- End of File -------------------------------*/
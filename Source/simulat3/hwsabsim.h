@@ -58,9 +58,35 @@ extern	cell_control ExpandInstruction(int instr,
 									BOOL sec_object,
 									BOOL do_flush);
 
+extern	cell_control ExpandInstructionState(expand_state *state,
+									int instr,
+									BOOL do_nop,
+									BOOL sec_object,
+									BOOL do_flush);
+
 /*extern cell_control expand_instruction(int instr,BOOL do_nop,BOOL sec_object);*/
 
 
+/*
+** The whole cell array in structure of arrays form, one lane per cell.
+** The flags are held as masks, 0 for FALSE and ~0 for TRUE, so that a
+** span can be processed a vector at a time. Clear it to reset the cells.
+*/
+typedef struct {
+	INT32	I_depth[NUM_SABRE_CELLS];
+	INT32	U_depth[NUM_SABRE_CELLS];
+	INT32	I_id[NUM_SABRE_CELLS];
+	INT32	U_id[NUM_SABRE_CELLS];
+	INT32	I_visib[NUM_SABRE_CELLS];
+	INT32	I_forward[NUM_SABRE_CELLS];
+	INT32	shad_temp[NUM_SABRE_CELLS];
+	INT32	U_visib[NUM_SABRE_CELLS];
+	INT32	U_shadow[NUM_SABRE_CELLS];
+} span_state;
+
+extern	void	SpanProcess(span_state *span, cell_control instruction,
+							double Creg40, double Avalue, unsigned long index);
+
 extern	int	SurfProcess(cell_state *cell,cell_control	instruction,long  C,unsigned long index,BOOL *shadow,long *U_plane_depth);
 
 
@@ -68,4 +94,10 @@ extern	long conv20_to_30(long	number);
 
 extern	void	HWISPRenderer();
 
+/*
+** The ISP store the next frame's parameters are written to, and its size
+** in words. For tools that load frames themselves, such as replay.
+*/
+extern	UINT32	*HWSimISPStore(UINT32 *pu32Words);
+
 /*---------------------------- End of File -------------------------------*/
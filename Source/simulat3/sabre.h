@@ -147,5 +147,13 @@ typedef struct {
 } cell_state;
 
 
+/* the part of the instruction decode that carries over from one plane
+   to the next, see ExpandInstructionState */
+
+typedef struct {
+	int	prev_intern_out;
+} expand_state;
+
+
 
 /*---------------------------- End of File -------------------------------*/
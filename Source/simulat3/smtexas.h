@@ -71,12 +71,15 @@
  *****************************************************************************/
 
 
+#ifndef __SMTEXAS_H__
+#define __SMTEXAS_H__
+
 #define DUMP_PARAM_FILES	1
 
 #define PCX2_DEVICE_ID				0x0046  /* PCX2 */
 
-/* Required in HW Setup */
-UINT16	wPCIDeviceID = 0;
+/* Required in HW Setup (defined in hwregs.c) */
+extern UINT16	wPCIDeviceID;
 
 #define TEXTURE_MEMORY_SIZE	2097152
 
@@ -154,6 +157,160 @@ UINT16	wPCIDeviceID = 0;
 extern unsigned long textureMemory[TEXTURE_MEMORY_SIZE>>1]; /* changed to 32 bit words*/
 
 
+typedef struct
+{
+	long m;
+	int  e;
+} pfloat;
+
+typedef struct {
+	unsigned char Blue;
+	unsigned char Green;
+	unsigned char Red;
+}RGB;
+
+typedef struct {
+	unsigned char Blue;
+	unsigned char Green;
+	unsigned char Red;
+	unsigned char Alpha;
+}RGBA;
+
+
+/*
+** A TSP parameter block unpacked into its fields. Texas decodes the
+** block once at the start of each span and shades the rest of the span
+** from here rather than going back to the parameter store every pixel.
+*/
+
+typedef struct
+{
+	unsigned long address;		/* the block this was decoded from */
+	unsigned long control;		/* word 0, holds all the MASK_ flags */
+
+	/* flat shading, or the origin for smooth shading */
+	int x_offset,y_offset;
+	RGB base,shadowColour;
+
+	/* texturing */
+	int a,b,c,d,e,f,p,q,r;
+	int exp,globalTrans;
+	unsigned long texture_address;
+	unsigned char mapSize,colourDepth,mipMapped,transPass,col4444or555,flipUV;
+	pfloat pmip;
+
+	/* smooth shading, the light and the one possible shadow light */
+	int t0,t1,t2;
+	RGB holdCol;
+	int st0,st1,st2;
+	RGB holdCol1;
+
+	/* flat highlight, [0] when the shadow light was used, else [1] */
+	RGB highlightCol[2],shadowHighlightCol[2];
+} TSP_DECODE;
+
+/*
+** One shaded pixel in the binary trace. x==y==0xffff marks the start of
+** a frame, with the frame number in address.
+*/
+
+typedef struct
+{
+	sgl_uint16	x,y;
+	sgl_uint32	address;
+	sgl_uint8	red,green,blue,alpha;
+	sgl_uint8	shadow,fog;
+	sgl_uint16	reserved;
+} TEXAS_TRACE_RECORD;
+
+/*
+** Counts from the cache models.
+*/
+
+typedef struct
+{
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+} TEXAS_CACHE_STATS;
+
+/*
+** The state the driver sets between frames with TexasSetDim,
+** TexasSetFogColour and TexasSetCFRScale. Those change a pending copy,
+** which a frame takes when it is started, so that setting up the next
+** frame doesn't change one that is still waiting to be rendered.
+*/
+
+typedef struct
+{
+	sgl_map_pixel FogColour;
+	UINT16 CFRScale;
+	int XDim,YDim;
+} TEXAS_STATE;
+
+/* pixels a context collects before passing them to the trace buffer */
+#define TEXAS_TRACE_BATCH	64
+
+/*
+** The state texas carries from one pixel to the next. Texas() uses a
+** single global one of these, a render thread passes its own to TexasCtx()
+** so that several regions can be shaded at once.
+*/
+
+typedef struct
+{
+	/* span tracking for the dump files */
+	int lastPlane;
+	int lastX;
+	int lastY;
+	int iterCount;
+	int spanFlag;
+	int previousPlaneWasTextured;
+
+	/* bilinear fetch shuffling */
+	int currentTag;
+	int currentX;
+	int currentY;
+	unsigned long lastFetched;
+	unsigned long dummyABase;
+	unsigned long dummyBBase;
+
+	/* statistics */
+	unsigned long shuffCount;
+	unsigned long dummyBreakCount;
+	unsigned long textureCallCount;
+	unsigned long highestCount;
+	unsigned long lowestCount;
+
+	/* non zero to write the params/ files, they are only meaningful
+	   when the pixels arrive in the serial order */
+	int dumpFiles;
+
+	/* the current span's TSP parameters */
+	TSP_DECODE decode;
+
+	/* pixels waiting to go to the trace, see TexasTraceFlushContext */
+	int traceCount;
+	TEXAS_TRACE_RECORD trace[TEXAS_TRACE_BATCH];
+} TEXAS_CONTEXT;
+
+extern TEXAS_CONTEXT TexasContext;
+
+/*
+** Set from the [Simulator] section of sgl.ini by InitTexasSimulator.
+** FastShading=1 turns the params/ dump files off unless DumpFiles=1 asks
+** for them, TraceFile=name writes every shaded pixel to a binary trace.
+*/
+extern int TexasDumpFiles;
+
+/*
+** Non zero when ParamCache=1 or TextureCache=1 in the [Simulator] section.
+** The counts depend on the order of the fetches, so the renderer must
+** then shade the regions one at a time, in order.
+*/
+extern int TexasCacheModel;
+
+
 
 /*=========================================================================
 name	|Texas
@@ -173,6 +330,59 @@ post	|-
 =========================================================================*/
 void Texas(int x,int y,unsigned long address,unsigned char shadow,unsigned char fog);
 
+/*=========================================================================
+name	|TexasCtx
+function|As Texas, but all the state carried between pixels is in pCtx.
+in		|pCtx, the callers texas state
+		|x,y,address,shadow,fog, as Texas
+out		|-
+rd		|parameterStore
+wr		|frameBuffer
+pre		|pCtx set up by InitTexasContext
+post	|-		 
+=========================================================================*/
+void TexasCtx(TEXAS_CONTEXT *pCtx,int x,int y,unsigned long address,
+			  unsigned char shadow,unsigned char fog);
+
+/*=========================================================================
+name	|InitTexasContext
+function|sets a texas state block to the power on values.
+in		|pCtx,
+		|dumpFiles, non zero to write the params/ dump files
+out		|-
+rd		|-
+wr		|pCtx
+pre		|-
+post	|-		 
+=========================================================================*/
+void InitTexasContext(TEXAS_CONTEXT *pCtx,int dumpFiles);
+
+/*=========================================================================
+name	|TexasTraceFlushContext
+function|passes the pixels a context has collected on to the trace. A
+		|render thread must call this when it has finished.
+in		|pCtx,
+out		|-
+rd		|-
+wr		|pCtx
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasTraceFlushContext(TEXAS_CONTEXT *pCtx);
+
+/*=========================================================================
+name	|TexasCacheRegion
+function|tells the cache models a new region is starting, so they can
+		|report the counts for the last one.
+in		|region, the number of the region in the frame
+out		|-
+rd		|-
+wr		|-
+pre		|InitTexasSimulator
+post	|-		 
+=========================================================================*/
+void TexasCacheRegion(long region);
+
 /*=========================================================================
 name	|WritePixel
 function|writes a pixel into the texture memory
@@ -241,12 +451,11 @@ void DumpParameterMemory();
 
 /*=========================================================================
 name	|FlushCache
-function|makes each cache slot empty
+function|makes each slot of the cache models empty
 in		|-
 out		|-
 rd		|-
-wr		|tags
-	   	|missCount
+wr		|CacheModel
 pre		|-
 post	|-		 
 =========================================================================*/
@@ -259,7 +468,7 @@ in		|x,
 		|y,
 out		|-
 rd		|-
-wr		|Bitmap_ydim,Bitmap_xdim
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
@@ -271,7 +480,7 @@ function|.
 in		|Colour,
 out		|-
 rd		|-
-wr		|fogColour
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
@@ -284,12 +493,40 @@ function|This can be the distance between the center of projection and the
 in		|Scale,
 out		|-
 rd		|-
-wr		|fogColour
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
 void TexasSetCFRScale(UINT16 Scale);
 
+/*=========================================================================
+name	|TexasGetState
+function|takes a copy of the state set by the functions above, for a frame
+		|that is being started.
+in		|-
+out		|pState
+rd		|PendingState
+wr		|-
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasGetState(TEXAS_STATE *pState);
+
+/*=========================================================================
+name	|TexasLoadState
+function|makes a frame's state current just before it is rendered. Texels
+		|and TSP parameters are read from pTextureMemory, which is the
+		|frame's copy of texture memory or textureMemory itself.
+in		|pState,
+		|pTextureMemory
+out		|-
+rd		|-
+wr		|fogColour,cfrScale,Bitmap_ydim,Bitmap_xdim
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasLoadState(const TEXAS_STATE *pState,unsigned long *pTextureMemory);
+
 /*=========================================================================
 name	|FetchPixel
 function|returns a raw 16 bit pixel given an address
@@ -336,3 +573,5 @@ extern FILE *FrawTexPixels;
 extern FILE *FtexasInput;
 extern FILE *Fpixels;
 extern FILE *FtexasInputSabOutputFormat; /*I'm having a laugh*/
+
+#endif /* __SMTEXAS_H__ */
@@ -88,33 +88,17 @@
  *****************************************************************************/
 
 #include <math.h>
+#include <string.h>
 #include "../sgl_defs.h"
 #include "../dlnodes.h"
 #include "../rnglobal.h"
 #include "../ldbmp.h"
 #include "../txmops.h"
+#include "../sglmem.h"
+#include "../sglthrd.h"
+#include "../profile.h"
+#include "smtexas.h"
 
-int iter_count; /*this is for ians simulation testing*/
-
-
-typedef struct
-{
-	long m;
-	int  e;
-} pfloat;
-
-typedef struct {
-	unsigned char Blue;
-	unsigned char Green;
-	unsigned char Red;
-}RGB;
-
-typedef struct {
-	unsigned char Blue;
-	unsigned char Green;
-	unsigned char Red;
-	unsigned char Alpha;
-}RGBA;
 
 
 
@@ -124,16 +108,10 @@ unsigned long PixelCamMiss=0;
 unsigned long PixelCamHit=0;
 unsigned long PCXCache=0;
 unsigned long PCXCacheNU=0;
-unsigned long HighestCount=0;
-unsigned long LowestCount=0;
 
-unsigned long ShuffCount=0;
-int	CurrentTag=-1;
 
 unsigned long BreakCount=0;
-unsigned long DummyBreakCount=0;
 
-unsigned long TextureCallCount=0;
 
 unsigned short cfrScale;			/*the scalar for 'c','f' and 'r' */
 
@@ -143,29 +121,81 @@ RGB fogColour;
 
 int Bitmap_ydim,Bitmap_xdim; /*this is for bringing texas simulator up with sgl*/
 
+/*
+// The frame being rendered reads texels and parameters from here, which
+// is a copy of texture memory taken when it was started if the renderer
+// runs on a thread of its own. The setters below change PendingState,
+// which the frame picks up the same way (see TexasLoadState).
+*/
+static unsigned long *pTexelMemory = textureMemory;
+static UINT32 *pParamMemory = (UINT32 *) textureMemory;
+static TEXAS_STATE PendingState;
+
 RGB frameBuffer[MAX_X_DIM * MAX_Y_DIM]; /*what texas writes into*/
 
 
-int spanflag=0; /*just to show where the spans starts for TOIAN stuff*/
-int previousPlaneWasTextured=1; /*for ians pre-calc stuff */
+/*
+** the state Texas() carries between pixels, ie when sabre is run serially.
+** spanFlag shows where the spans start for the TOIAN stuff and
+** previousPlaneWasTextured is for ians pre-calc stuff.
+*/
+TEXAS_CONTEXT TexasContext={-1,-1,-1,0,0,1,
+							-1,0,0,0,(unsigned long)-1,(unsigned long)-1,
+							0,0,0,0,0,
+							DUMP_PARAM_FILES};
 
 
 /*
-**    The following variables are used for the cache simulation.
-**
+**    The cache simulation. There is a model for the parameter fetches and
+**    one for the texel fetches, each set up from the [Simulator] section
+**    of sgl.ini by InitTexasSimulator. When a model is off the fetches
+**    only test its enabled flag.
 */
 
-long missCount=0;
-long Mtag,Mblock;
+#define CACHE_PARAM		0
+#define CACHE_TEXTURE	1
+#define CACHE_TEXTURES	256		/* textures with their own counts, per frame */
 
-unsigned char replace[1<<CACHE_ENTRIES]; /* the toggle for which set to replace*/
+typedef struct
+{
+	unsigned long block;
+	unsigned long lastUse;
+	int valid;
+} CACHE_LINE;
 
-struct tagEntry {
-	long address;
-	unsigned char empty;
-};
+typedef struct
+{
+	char *name;
+	int enabled;
+	int ways;
+	int blockShift;				/* log2 of the words (or texels) in a block */
+	int sets;					/* a power of 2 */
+	CACHE_LINE *pLines;			/* sets * ways, a set at a time */
+	unsigned long clock;		/* for the least recently used replacement */
+	TEXAS_CACHE_STATS frame;
+	TEXAS_CACHE_STATS region;
+} CACHE_MODEL;
 
-struct tagEntry tags[2][1<<CACHE_ENTRIES]; /* the array of cache tags */
+typedef struct
+{
+	unsigned long texture;		/* the map address, or -1 for all the rest */
+	TEXAS_CACHE_STATS stats;
+} CACHE_TEXTURE_STATS;
+
+static CACHE_MODEL CacheModel[2]={{"parameter"},{"texture"}};
+
+static CACHE_TEXTURE_STATS CacheTextures[CACHE_TEXTURES];
+static int CacheTextureCount;
+
+static unsigned long CacheTexture;	/* the map the texels are coming from */
+static long CacheRegion=-1;
+static unsigned long CacheFrame=0;
+static FILE *CacheReport;
+
+int TexasCacheModel=0;
+
+static void CacheStartFrame();
+static void CacheEndFrame();
 
 FILE *FsabreFloat;
 FILE *FshadePreCalc;
@@ -180,6 +210,173 @@ FILE *Fbilin3;
 FILE *Fbilin4;
 
 
+/*
+** Set from sgl.ini by InitTexasSimulator, see smtexas.h
+*/
+int TexasDumpFiles=DUMP_PARAM_FILES;
+
+/*
+**    The binary pixel trace. Contexts pass their pixels to one of two
+**    buffers, when that is full it is handed to a writer thread and the
+**    other buffer is filled while it is written out.
+*/
+
+#define TRACE_BUFFER_SIZE	16384		/* records in each buffer */
+#define TRACE_VERSION		1
+
+typedef struct
+{
+	FILE *file;
+	TEXAS_TRACE_RECORD *pRecords;
+	int count;
+} TRACE_WRITE;
+
+static struct
+{
+	int initialised;
+	FILE *file;						/* NULL when there is no trace */
+	SGLMUTEX hLock;
+	TEXAS_TRACE_RECORD *pBuffer[2];
+	int fill;						/* the buffer being filled */
+	int count;						/* and the records in it */
+	TRACE_WRITE write;				/* the buffer being written */
+	SGLTHREAD hWriter;
+	unsigned long frame;
+} Trace;
+
+static void TraceWriter(void *pData)
+{
+	TRACE_WRITE *pWrite=(TRACE_WRITE *)pData;
+
+	fwrite(pWrite->pRecords,sizeof(TEXAS_TRACE_RECORD),pWrite->count,pWrite->file);
+	fflush(pWrite->file);
+}
+
+/*=========================================================================
+name	|TraceFlush
+function|starts writing the buffer being filled and switches to the
+		|other one. Call with the trace lock held.
+in		|wait, non zero to wait for the write to finish
+out		|-
+rd		|-
+wr		|Trace
+pre		|Trace.file!=NULL
+post	|-		 
+=========================================================================*/
+static void TraceFlush(int wait)
+{
+	/* the previous write must be done before its buffer is reused */
+
+	if(Trace.hWriter)
+	{
+		SglThreadJoin(Trace.hWriter);
+		Trace.hWriter=NULL;
+	}
+
+	if(Trace.count)
+	{
+		Trace.write.file=Trace.file;
+		Trace.write.pRecords=Trace.pBuffer[Trace.fill];
+		Trace.write.count=Trace.count;
+
+		Trace.hWriter=SglThreadCreate(TraceWriter,&Trace.write);
+
+		if(!Trace.hWriter)
+		{
+			/* no thread, so write it now */
+			TraceWriter(&Trace.write);
+		}
+
+		Trace.fill^=1;
+		Trace.count=0;
+	}
+
+	if(wait && Trace.hWriter)
+	{
+		SglThreadJoin(Trace.hWriter);
+		Trace.hWriter=NULL;
+	}
+}
+
+static void TraceAppend(TEXAS_TRACE_RECORD *pRecords,int count)
+{
+	int n;
+
+	SglMutexLock(Trace.hLock);
+
+	while(count)
+	{
+		n=TRACE_BUFFER_SIZE-Trace.count;
+
+		if(n>count)
+			n=count;
+
+		memcpy(Trace.pBuffer[Trace.fill]+Trace.count,pRecords,n*sizeof(TEXAS_TRACE_RECORD));
+
+		Trace.count+=n;
+		pRecords+=n;
+		count-=n;
+
+		if(Trace.count==TRACE_BUFFER_SIZE)
+			TraceFlush(FALSE);
+	}
+
+	SglMutexUnlock(Trace.hLock);
+}
+
+/*=========================================================================
+name	|TraceOpen
+function|opens the trace file named by sgl.ini, if there is one, and
+		|writes its header: "TXTR", the version and the record size.
+in		|-
+out		|-
+rd		|-
+wr		|Trace
+pre		|-
+post	|-		 
+=========================================================================*/
+static void TraceOpen()
+{
+	char szName[256];
+	sgl_uint32 header[2];
+
+	Trace.initialised=TRUE;
+
+	SglReadPrivateProfileString("Simulator","TraceFile","",szName,sizeof(szName),"sgl.ini");
+
+	if(szName[0]=='\0')
+		return;
+
+	Trace.pBuffer[0]=SGLMalloc(TRACE_BUFFER_SIZE*sizeof(TEXAS_TRACE_RECORD));
+	Trace.pBuffer[1]=SGLMalloc(TRACE_BUFFER_SIZE*sizeof(TEXAS_TRACE_RECORD));
+	Trace.hLock=SglMutexCreate();
+
+	Trace.file=fopen(szName,"wb");
+
+	if(!Trace.pBuffer[0] || !Trace.pBuffer[1] || !Trace.hLock || !Trace.file)
+	{
+		DPF((DBG_WARNING,"Texas: unable to start the trace %s",szName));
+
+		if(Trace.file)
+			fclose(Trace.file);
+		if(Trace.hLock)
+			SglMutexDestroy(Trace.hLock);
+
+		SGLFree(Trace.pBuffer[0]);
+		SGLFree(Trace.pBuffer[1]);
+
+		Trace.file=NULL;
+		return;
+	}
+
+	header[0]=TRACE_VERSION;
+	header[1]=sizeof(TEXAS_TRACE_RECORD);
+
+	fwrite("TXTR",1,4,Trace.file);
+	fwrite(header,sizeof(header),1,Trace.file);
+}
+
+
 void FlushPixelCam()
 {
 	int i;
@@ -195,19 +392,53 @@ void FlushPixelCam()
 
 /*=========================================================================
 name	|InitTexasSimulator
-function|opens the param files for writing
+function|reads the [Simulator] settings from sgl.ini and opens the param
+		|files for writing, if they are wanted.
 in		|
 out		|-
 rd		|
-wr		|-
+wr		|TexasDumpFiles, Trace
 pre		|-
 post	|-		 
 =========================================================================*/
 void InitTexasSimulator()
 {
+	int fastShading;
 
 	FlushPixelCam();
 
+	/*
+	** the dump files are off in the fast mode, unless they are asked for
+	*/
+
+	fastShading=SglReadPrivateProfileInt("Simulator","FastShading",0,"sgl.ini");
+
+	TexasDumpFiles=SglReadPrivateProfileInt("Simulator","DumpFiles",
+											fastShading ? 0 : DUMP_PARAM_FILES,"sgl.ini");
+
+	TexasContext.dumpFiles=TexasDumpFiles;
+
+	CacheStartFrame();
+
+	if(!Trace.initialised)
+		TraceOpen();
+
+	if(Trace.file)
+	{
+		TEXAS_TRACE_RECORD frameStart;
+
+		memset(&frameStart,0,sizeof(frameStart));
+
+		frameStart.x=0xffff;
+		frameStart.y=0xffff;
+		frameStart.address=Trace.frame++;
+
+		TraceAppend(&frameStart,1);
+	}
+
+	if(!TexasDumpFiles)
+		return;
+
 	FsabreFloat=fopen("params/sabrefloat.txt","wb");
 	FshadePreCalc=fopen("params/shadeprecalc.txt","wb"); 
 	FtexPreCalc=fopen("params/texprecalc.txt","wb"); 
@@ -235,9 +466,25 @@ post	|-
 =========================================================================*/
 void FinishTexasSimulator()
 {
+	/* the frame's trace is on disk before the next frame starts */
+
+	CacheEndFrame();
+
+	if(Trace.file)
+	{
+		TexasTraceFlushContext(&TexasContext);
+
+		SglMutexLock(Trace.hLock);
+		TraceFlush(TRUE);
+		SglMutexUnlock(Trace.hLock);
+	}
+
+	if(!TexasDumpFiles)
+		return;
+
 	/*complete the last span */
 
-   	fprintf(FtexPreCalc,"%d\n",iter_count);
+   	fprintf(FtexPreCalc,"%d\n",TexasContext.iterCount);
 
 	/*close all those files*/
 
@@ -316,14 +563,14 @@ in		|x,
 		|y,
 out		|-
 rd		|-
-wr		|Bitmap_ydim,Bitmap_xdim
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
 void TexasSetDim(int x,int y)
 {
-	Bitmap_ydim =(y > MAX_Y_DIM) ? MAX_Y_DIM : y;
-	Bitmap_xdim =(x > MAX_X_DIM) ? MAX_X_DIM : x;
+	PendingState.YDim =(y > MAX_Y_DIM) ? MAX_Y_DIM : y;
+	PendingState.XDim =(x > MAX_X_DIM) ? MAX_X_DIM : x;
 }
 
 /*=========================================================================
@@ -332,15 +579,13 @@ function|.
 in		|Colour,
 out		|-
 rd		|-
-wr		|fogColour
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
 void TexasSetFogColour(sgl_map_pixel Colour)
 {
-	fogColour.Red  =Colour.red;
-	fogColour.Green=Colour.green;
-	fogColour.Blue =Colour.blue;
+	PendingState.FogColour=Colour;
 	DPF((DBG_MESSAGE, "fog colour is %02X%02X%02X",Colour.red,Colour.green,Colour.blue));
 
 }
@@ -352,13 +597,58 @@ function|This can be the distance between the center of projection and the
 in		|Scale,
 out		|-
 rd		|-
-wr		|fogColour
+wr		|PendingState
 pre		|-
 post	|-		 
 =========================================================================*/
 void TexasSetCFRScale(UINT16 Scale)
 {
-	cfrScale=Scale;
+	PendingState.CFRScale=Scale;
+}
+
+/*=========================================================================
+name	|TexasGetState
+function|takes a copy of the state set by the functions above, for a frame
+		|that is being started.
+in		|-
+out		|pState
+rd		|PendingState
+wr		|-
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasGetState(TEXAS_STATE *pState)
+{
+	*pState=PendingState;
+}
+
+/*=========================================================================
+name	|TexasLoadState
+function|makes a frame's state current just before it is rendered.
+in		|pState,
+		|pTextureMemory,	the frame's copy of texture memory (or
+		|					textureMemory itself)
+out		|-
+rd		|-
+wr		|fogColour,cfrScale,Bitmap_ydim,Bitmap_xdim,pTexelMemory,
+		|pParamMemory
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasLoadState(const TEXAS_STATE *pState,unsigned long *pTextureMemory)
+{
+	fogColour.Red  =pState->FogColour.red;
+	fogColour.Green=pState->FogColour.green;
+	fogColour.Blue =pState->FogColour.blue;
+
+	cfrScale=pState->CFRScale;
+
+	Bitmap_ydim=pState->YDim;
+	Bitmap_xdim=pState->XDim;
+
+	/* the TSP parameters are at the bottom of texture memory */
+	pTexelMemory=pTextureMemory;
+	pParamMemory=(UINT32 *) pTextureMemory;
 }
 
 
@@ -368,133 +658,326 @@ function|makes each cache slot empty
 in		|-
 out		|-
 rd		|-
-wr		|tags
-	   	|missCount
+wr		|CacheModel
 pre		|-
 post	|-		 
 =========================================================================*/
 void FlushCache()
 {
-	int i;
+	int i,j;
 
-	for(i=0;i<(1<<CACHE_ENTRIES);i++)
+	for(i=0;i<2;i++)
 	{
-		tags[0][i].empty=TRUE;
-		tags[1][i].empty=TRUE;
-	}
+		if(CacheModel[i].pLines)
+		{
+			for(j=0;j<CacheModel[i].sets*CacheModel[i].ways;j++)
+				CacheModel[i].pLines[j].valid=FALSE;
+		}
 
-    missCount=0;
+		CacheModel[i].clock=0;
+	}
 }
 
 /*=========================================================================
-name	|FetchParameter
-function|
-in		|-
+name	|CacheSetup
+function|reads a cache model's geometry from sgl.ini, eg for the texture
+		|cache TextureCache=1, TextureCacheWays, TextureCacheBlockSize (in
+		|texels) and TextureCacheEntries (sets). The sizes are rounded
+		|down to powers of 2.
+in		|key, the prefix of the sgl.ini entries
+		|defWays,defBlockShift,defSetShift, the defaults
 out		|-
 rd		|-
-wr		|-
+wr		|pCache
 pre		|-
 post	|-		 
 =========================================================================*/
-unsigned long FetchParameter(unsigned long address)
+static void CacheSetup(CACHE_MODEL *pCache,char *key,int defWays,int defBlockShift,int defSetShift)
 {
-	unsigned long tag;
-	unsigned long block_address;
-	unsigned char miss;
+	char entry[64];
+	int ways,blockSize,sets,blockShift;
 
+	pCache->enabled=SglReadPrivateProfileInt("Simulator",key,0,"sgl.ini");
 
-if(0) /*remove the cache simulation for speed*/
-{
-	
-	block_address=address >> CACHE_BLOCK_SIZE; /*reduce the granularity of the cache entries*/
-	
-	tag=block_address & ((1<<CACHE_ENTRIES)-1);   /*direct map the address into the cache */
+	if(!pCache->enabled)
+		return;
 
-	Mblock=block_address;
-	Mtag=tag;
+	sprintf(entry,"%sWays",key);
+	ways=SglReadPrivateProfileInt("Simulator",entry,defWays,"sgl.ini");
 
-	if((tags[0][tag].address==block_address) && (tags[0][tag].empty==FALSE))    
-	{
-		/*
-		** there is a hit in bank 0
-		*/
+	sprintf(entry,"%sBlockSize",key);
+	blockSize=SglReadPrivateProfileInt("Simulator",entry,1<<defBlockShift,"sgl.ini");
 
-		miss=FALSE;
-		replace[tag]=1;   /* if we have to replace, replace bank 1*/
+	sprintf(entry,"%sEntries",key);
+	sets=SglReadPrivateProfileInt("Simulator",entry,1<<defSetShift,"sgl.ini");
 
-	}
-	else
+	if(ways<1)
+		ways=1;
+
+	for(blockShift=0;(2<<blockShift)<=blockSize;blockShift++)
+		;
+
+	while(sets & (sets-1))
+		sets&=sets-1;
+
+	if(sets<1)
+		sets=1;
+
+	if(!pCache->pLines || ways!=pCache->ways || sets!=pCache->sets)
 	{
-		if((tags[1][tag].address==block_address) && (tags[1][tag].empty==FALSE))    
-		{
-			/*
-			** there is a hit in bank 1
-			*/
-			miss=FALSE;
-			replace[tag]=0;    /* if we have to replace, replace bank 0*/
+		SGLFree(pCache->pLines);
 
+		pCache->pLines=SGLMalloc(ways*sets*sizeof(CACHE_LINE));
 
+		if(!pCache->pLines)
+		{
+			DPF((DBG_WARNING,"Texas: no memory for the %s cache model",pCache->name));
+			pCache->enabled=FALSE;
+			return;
 		}
-		else
+	}
+
+	pCache->ways=ways;
+	pCache->blockShift=blockShift;
+	pCache->sets=sets;
+}
+
+/*=========================================================================
+name	|CacheFetch
+function|passes one fetch through a cache model and counts the hit or
+		|the miss, and any eviction.
+in		|address, a parameter word or texel address
+out		|-
+rd		|CacheTexture
+wr		|pCache, CacheTextures
+pre		|pCache->enabled
+post	|-		 
+=========================================================================*/
+static void CacheFetch(CACHE_MODEL *pCache,unsigned long address)
+{
+	unsigned long block;
+	CACHE_LINE *pSet,*pVictim;
+	TEXAS_CACHE_STATS *pTexture;
+	int i,hit,evict;
+
+	block=address >> pCache->blockShift;
+
+	pSet=pCache->pLines + (block & (pCache->sets-1))*pCache->ways;
+
+	pCache->clock++;
+
+	/*
+	** the victim is the first empty way, otherwise the least recently
+	** used one. With 2 ways this is the old replace bank toggle.
+	*/
+
+	hit=FALSE;
+	pVictim=pSet;
+
+	for(i=0;i<pCache->ways;i++)
+	{
+		if(pSet[i].valid && pSet[i].block==block)
 		{
-			miss=TRUE;
-			missCount++;
-			
+			hit=TRUE;
+			pVictim=&pSet[i];
+			break;
 		}
 
+		if(pVictim->valid && (!pSet[i].valid || pSet[i].lastUse<pVictim->lastUse))
+			pVictim=&pSet[i];
 	}
 
-	if(miss==TRUE)
+	evict=!hit && pVictim->valid;
+
+	pVictim->valid=TRUE;
+	pVictim->block=block;
+	pVictim->lastUse=pCache->clock;
+
+	pCache->frame.hits+=hit;
+	pCache->frame.misses+=!hit;
+	pCache->frame.evictions+=evict;
+
+	pCache->region.hits+=hit;
+	pCache->region.misses+=!hit;
+	pCache->region.evictions+=evict;
+
+	if(pCache==&CacheModel[CACHE_TEXTURE])
 	{
-		if(tags[0][tag].empty && tags[1][tag].empty)
-		{
-			/*
-			** both entries are empty
-			*/
-			
-			tags[0][tag].empty=FALSE;
-			tags[0][tag].address=block_address;
+		/*
+		** find the map's counts, the last entry takes the overflow
+		*/
+
+		pTexture=NULL;
 
-			replace[tag]=1; /* not vital*/
+		for(i=0;i<CacheTextureCount;i++)
+		{
+			if(CacheTextures[i].texture==CacheTexture)
+			{
+				pTexture=&CacheTextures[i].stats;
+				break;
+			}
 		}
-		else
+
+		if(!pTexture)
 		{
-			if(tags[0][tag].empty)
+			if(CacheTextureCount<CACHE_TEXTURES)
 			{
-				tags[0][tag].empty=FALSE;
-				tags[0][tag].address=block_address;
+				i=CacheTextureCount++;
 
-				replace[tag]=1; 
-				
+				CacheTextures[i].texture=(i==CACHE_TEXTURES-1) ? (unsigned long)-1 : CacheTexture;
+				memset(&CacheTextures[i].stats,0,sizeof(TEXAS_CACHE_STATS));
 			}
 			else
 			{
-				if(tags[1][tag].empty)
-				{
-					tags[1][tag].empty=FALSE;
-					tags[1][tag].address=block_address;
+				i=CACHE_TEXTURES-1;
+			}
 
-					replace[tag]=0; 
-				
-				}
-				else
-				{
-					/*
-					** we have to throw away some data.
-					*/
+			pTexture=&CacheTextures[i].stats;
+		}
 
-					tags[replace[tag]][tag].address=block_address;
-					replace[tag]^=1;    /*toggle replace bank*/
+		pTexture->hits+=hit;
+		pTexture->misses+=!hit;
+		pTexture->evictions+=evict;
+	}
+}
 
-				}
+static void CachePrint(char *scope,long number,char *name,TEXAS_CACHE_STATS *pStats)
+{
+	fprintf(CacheReport,"%s %ld %s: hits %lu misses %lu evictions %lu\n",scope,number,name,
+			pStats->hits,pStats->misses,pStats->evictions);
+}
 
-			}
+/*=========================================================================
+name	|CacheStartFrame
+function|sets the cache models up from sgl.ini and empties them.
+in		|-
+out		|-
+rd		|-
+wr		|CacheModel, TexasCacheModel
+pre		|-
+post	|-		 
+=========================================================================*/
+static void CacheStartFrame()
+{
+	char szName[256];
+
+	CacheSetup(&CacheModel[CACHE_PARAM],"ParamCache",2,CACHE_BLOCK_SIZE,CACHE_ENTRIES);
+	CacheSetup(&CacheModel[CACHE_TEXTURE],"TextureCache",2,2,CACHE_ENTRIES);
+
+	TexasCacheModel=CacheModel[CACHE_PARAM].enabled || CacheModel[CACHE_TEXTURE].enabled;
+
+	if(!TexasCacheModel)
+		return;
+
+	if(!CacheReport)
+	{
+		SglReadPrivateProfileString("Simulator","CacheReport","",szName,sizeof(szName),"sgl.ini");
+
+		CacheReport=szName[0] ? fopen(szName,"w") : NULL;
+
+		if(!CacheReport)
+			CacheReport=stdout;
+	}
+
+	FlushCache();
+
+	memset(&CacheModel[CACHE_PARAM].frame,0,sizeof(TEXAS_CACHE_STATS));
+	memset(&CacheModel[CACHE_TEXTURE].frame,0,sizeof(TEXAS_CACHE_STATS));
+
+	CacheTextureCount=0;
+	CacheRegion=-1;
+}
+
+/*=========================================================================
+name	|TexasCacheRegion
+function|reports the cache counts for the region that has just finished.
+in		|region, the region about to start, or -1 at the end of the frame
+out		|-
+rd		|-
+wr		|CacheModel
+pre		|-
+post	|-		 
+=========================================================================*/
+void TexasCacheRegion(long region)
+{
+	int i;
+
+	if(!TexasCacheModel)
+		return;
+
+	for(i=0;i<2;i++)
+	{
+		if(CacheModel[i].enabled)
+		{
+			if(CacheRegion>=0)
+				CachePrint("region",CacheRegion,CacheModel[i].name,&CacheModel[i].region);
+
+			memset(&CacheModel[i].region,0,sizeof(TEXAS_CACHE_STATS));
 		}
 	}
 
+	CacheRegion=region;
+}
+
+/*=========================================================================
+name	|CacheEndFrame
+function|reports the cache counts for the last region, the frame and
+		|each texture.
+in		|-
+out		|-
+rd		|-
+wr		|-
+pre		|-
+post	|-		 
+=========================================================================*/
+static void CacheEndFrame()
+{
+	char name[32];
+	int i;
+
+	if(!TexasCacheModel)
+		return;
+
+	TexasCacheRegion(-1);
+
+	for(i=0;i<2;i++)
+	{
+		if(CacheModel[i].enabled)
+			CachePrint("frame",CacheFrame,CacheModel[i].name,&CacheModel[i].frame);
+	}
+
+	for(i=0;i<CacheTextureCount;i++)
+	{
+		if(CacheTextures[i].texture==(unsigned long)-1)
+			strcpy(name,"texture other");
+		else
+			sprintf(name,"texture %06lX",CacheTextures[i].texture);
+
+		CachePrint("frame",CacheFrame,name,&CacheTextures[i].stats);
+	}
+
+	fflush(CacheReport);
+
+	CacheFrame++;
 }
 
-	return(ParamBufferInfo.tsp.pParamStore[address]);
+/*=========================================================================
+name	|FetchParameter
+function|returns a word of the parameter store, via the parameter cache
+		|model when that is on.
+in		|address,
+out		|the parameter word
+rd		|parameterStore
+wr		|CacheModel
+pre		|-
+post	|-		 
+=========================================================================*/
+unsigned long FetchParameter(unsigned long address)
+{
+	if(CacheModel[CACHE_PARAM].enabled)
+		CacheFetch(&CacheModel[CACHE_PARAM],address);
+
+	return(pParamMemory[address]);
 
 }
 
@@ -520,13 +1003,13 @@ void DumpParameterMemory()
 
 	for(i=0;i<262144;i++)
 	{
-		ch=(ParamBufferInfo.tsp.pParamStore[i]>>24) & 0xff;
+		ch=(pParamMemory[i]>>24) & 0xff;
 		putc(ch,dumpFile); 
-		ch=(ParamBufferInfo.tsp.pParamStore[i]>>16) & 0xff;
+		ch=(pParamMemory[i]>>16) & 0xff;
 		putc(ch,dumpFile); 
-		ch=(ParamBufferInfo.tsp.pParamStore[i]>>8) & 0xff;
+		ch=(pParamMemory[i]>>8) & 0xff;
 		putc(ch,dumpFile); 
-		ch=(ParamBufferInfo.tsp.pParamStore[i]) & 0xff;
+		ch=(pParamMemory[i]) & 0xff;
 		putc(ch,dumpFile); 
 
 	}
@@ -757,25 +1240,22 @@ unsigned long AddressCalc(long u,long v,unsigned long address,unsigned char mapS
 }
 
 
-void FetchPixelDummy(unsigned long address)
+void FetchPixelDummy(TEXAS_CONTEXT *pCtx,unsigned long address)
 {
-	static unsigned long Abase=-1;
-	static unsigned long Bbase=-1; 
-
 	if(address < BIG_BANK)
 	{
-		if((address & 0xfffffe00)!=Abase)
+		if((address & 0xfffffe00)!=pCtx->dummyABase)
 		{
-			Abase=address & 0xfffffe00;
-			DummyBreakCount++;
+			pCtx->dummyABase=address & 0xfffffe00;
+			pCtx->dummyBreakCount++;
 		}
 	}
 	else
 	{
-		if((address & 0xfffffe00)!=Bbase)
+		if((address & 0xfffffe00)!=pCtx->dummyBBase)
 		{
-			Bbase=address & 0xfffffe00;
-			DummyBreakCount++;
+			pCtx->dummyBBase=address & 0xfffffe00;
+			pCtx->dummyBreakCount++;
 		}
 
 	}
@@ -783,7 +1263,7 @@ void FetchPixelDummy(unsigned long address)
 }
 
 
-void ShufflePixels(int NextX,int NextY,int NextTag,unsigned char mapSize,int whichMap,
+void ShufflePixels(TEXAS_CONTEXT *pCtx,int NextX,int NextY,int NextTag,unsigned char mapSize,int whichMap,
 				   unsigned char colourDepth,unsigned char mipMapped,unsigned char flipUV)
 
 {
@@ -792,8 +1272,6 @@ void ShufflePixels(int NextX,int NextY,int NextTag,unsigned char mapSize,int whi
 									0x003f,
 									0x001f};
 
-    static int  CurrentX,CurrentY;
-	static unsigned long lastFetched;
 	int TextSizeX,TextSizeY;
     int DiffX,DiffY;
 	int bit8;
@@ -823,153 +1301,153 @@ void ShufflePixels(int NextX,int NextY,int NextTag,unsigned char mapSize,int whi
 	TextSizeY=mapMask[mapSize]>>(whichMap+1); /*32 bit word*/
 
 
-    DiffX=(NextX-CurrentX+1) & TextSizeX;
-    DiffY=(NextY-CurrentY+1) & TextSizeY;
+    DiffX=(NextX-pCtx->currentX+1) & TextSizeX;
+    DiffY=(NextY-pCtx->currentY+1) & TextSizeY;
 
-    CurrentX=NextX;
-    CurrentY=NextY;
+    pCtx->currentX=NextX;
+    pCtx->currentY=NextY;
 
 	Reorder=((AddrA & 0xfffffe00) != (AddrB & 0xfffffe00));
 
 	if(Reorder)
 		Reorder=1;
 
-/*	CurrentTag=-1;  just for mark*/
+/*	pCtx->currentTag=-1;  just for mark*/
 
 
-    if(NextTag==CurrentTag && DiffX==0 && DiffY==0)
+    if(NextTag==pCtx->currentTag && DiffX==0 && DiffY==0)
     {
     	/*left and up case*/
-		ShuffCount+=3;
-   	    fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrB,AddrC);
+		pCtx->shuffCount+=3;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrB,AddrC);
 		if(Reorder)
 		{
-			FetchPixelDummy(AddrA);
-			FetchPixelDummy(AddrC);
-			FetchPixelDummy(AddrB);
+			FetchPixelDummy(pCtx,AddrA);
+			FetchPixelDummy(pCtx,AddrC);
+			FetchPixelDummy(pCtx,AddrB);
 		}
 		else
 		{
-			FetchPixelDummy(AddrA);
-			FetchPixelDummy(AddrB);
-			FetchPixelDummy(AddrC);
+			FetchPixelDummy(pCtx,AddrA);
+			FetchPixelDummy(pCtx,AddrB);
+			FetchPixelDummy(pCtx,AddrC);
 		}
-		lastFetched=AddrC;
+		pCtx->lastFetched=AddrC;
 
     }
-    else if(NextTag==CurrentTag && DiffX==1 && DiffY==0)
+    else if(NextTag==pCtx->currentTag && DiffX==1 && DiffY==0)
     {
     	/*up case*/
-		ShuffCount+=2;
-   	    fprintf(Fbilin4,"%d %d\n",AddrA,AddrB);
-		FetchPixelDummy(AddrA);
-		FetchPixelDummy(AddrB);
-		lastFetched=AddrB;
+		pCtx->shuffCount+=2;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d\n",AddrA,AddrB);
+		FetchPixelDummy(pCtx,AddrA);
+		FetchPixelDummy(pCtx,AddrB);
+		pCtx->lastFetched=AddrB;
     }
-    else if(NextTag==CurrentTag && DiffX==2 && DiffY==0)
+    else if(NextTag==pCtx->currentTag && DiffX==2 && DiffY==0)
     {
     	/*right and up case*/
-		ShuffCount+=3;
-   	    fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrB,AddrD);
-		FetchPixelDummy(AddrA);
-		FetchPixelDummy(AddrB);
-		FetchPixelDummy(AddrD);
-		lastFetched=AddrD;
+		pCtx->shuffCount+=3;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrB,AddrD);
+		FetchPixelDummy(pCtx,AddrA);
+		FetchPixelDummy(pCtx,AddrB);
+		FetchPixelDummy(pCtx,AddrD);
+		pCtx->lastFetched=AddrD;
     }
-    else if(NextTag==CurrentTag && DiffX==0 && DiffY==1)
+    else if(NextTag==pCtx->currentTag && DiffX==0 && DiffY==1)
     {
     	/*left case*/
-		ShuffCount+=2;
-   	    fprintf(Fbilin4,"%d %d\n",AddrA,AddrC);
-		FetchPixelDummy(AddrA);
-		FetchPixelDummy(AddrC);
-		lastFetched=AddrC;
+		pCtx->shuffCount+=2;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d\n",AddrA,AddrC);
+		FetchPixelDummy(pCtx,AddrA);
+		FetchPixelDummy(pCtx,AddrC);
+		pCtx->lastFetched=AddrC;
 
     }
-    else if(NextTag==CurrentTag && DiffX==1 && DiffY==1)
+    else if(NextTag==pCtx->currentTag && DiffX==1 && DiffY==1)
     {
     	/*no movement case*/
 		/* ian's sdram interface HAS to fetch something */
 
-		ShuffCount+=1;
-   	    fprintf(Fbilin4,"%d\n",lastFetched); 
+		pCtx->shuffCount+=1;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d\n",pCtx->lastFetched); 
 
     }
-    else if(NextTag==CurrentTag && DiffX==2 && DiffY==1)
+    else if(NextTag==pCtx->currentTag && DiffX==2 && DiffY==1)
     {
     	/*right case*/
-		ShuffCount+=2;
-   	    fprintf(Fbilin4,"%d %d\n",AddrB,AddrD);
-		FetchPixelDummy(AddrB);
-		FetchPixelDummy(AddrD);
-		lastFetched=AddrD;
+		pCtx->shuffCount+=2;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d\n",AddrB,AddrD);
+		FetchPixelDummy(pCtx,AddrB);
+		FetchPixelDummy(pCtx,AddrD);
+		pCtx->lastFetched=AddrD;
 
     }
-    else if(NextTag==CurrentTag && DiffX==0 && DiffY==2)
+    else if(NextTag==pCtx->currentTag && DiffX==0 && DiffY==2)
     {
     	/*left and down case*/
-		ShuffCount+=3;
-   	    fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrC,AddrD);
-		FetchPixelDummy(AddrA);
-		FetchPixelDummy(AddrC);
-		FetchPixelDummy(AddrD);
-		lastFetched=AddrD;
+		pCtx->shuffCount+=3;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",AddrA,AddrC,AddrD);
+		FetchPixelDummy(pCtx,AddrA);
+		FetchPixelDummy(pCtx,AddrC);
+		FetchPixelDummy(pCtx,AddrD);
+		pCtx->lastFetched=AddrD;
 
     }
-    else if(NextTag==CurrentTag && DiffX==1 && DiffY==2)
+    else if(NextTag==pCtx->currentTag && DiffX==1 && DiffY==2)
     {
     	/*down case*/
-		ShuffCount+=2;
-   	    fprintf(Fbilin4,"%d %d\n",AddrC,AddrD);
-		FetchPixelDummy(AddrC);
-		FetchPixelDummy(AddrD);
-		lastFetched=AddrD;
+		pCtx->shuffCount+=2;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d\n",AddrC,AddrD);
+		FetchPixelDummy(pCtx,AddrC);
+		FetchPixelDummy(pCtx,AddrD);
+		pCtx->lastFetched=AddrD;
 
     }
-    else if(NextTag==CurrentTag && DiffX==2 && DiffY==2)
+    else if(NextTag==pCtx->currentTag && DiffX==2 && DiffY==2)
     {
     	/*right and down case*/
-		ShuffCount+=3;
-   	    fprintf(Fbilin4,"%d %d %d\n",AddrB,AddrC,AddrD);
+		pCtx->shuffCount+=3;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",AddrB,AddrC,AddrD);
 		if(Reorder)
 		{
-			FetchPixelDummy(AddrC);
-			FetchPixelDummy(AddrB);
-			FetchPixelDummy(AddrD);
+			FetchPixelDummy(pCtx,AddrC);
+			FetchPixelDummy(pCtx,AddrB);
+			FetchPixelDummy(pCtx,AddrD);
 		}
 		else
 		{
-			FetchPixelDummy(AddrB);
-			FetchPixelDummy(AddrC);
-			FetchPixelDummy(AddrD);
+			FetchPixelDummy(pCtx,AddrB);
+			FetchPixelDummy(pCtx,AddrC);
+			FetchPixelDummy(pCtx,AddrD);
 		}
 
 
-		lastFetched=AddrD;
+		pCtx->lastFetched=AddrD;
 
     }
     else
     {
     	/*all pixels must be flushed*/
 
-    	CurrentTag=NextTag;
-		ShuffCount+=4;
-   	    fprintf(Fbilin4,"%d %d %d %d\n",AddrA,AddrB,AddrC,AddrD);
+    	pCtx->currentTag=NextTag;
+		pCtx->shuffCount+=4;
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d %d\n",AddrA,AddrB,AddrC,AddrD);
 		if(Reorder)
 		{
-			FetchPixelDummy(AddrA);
-			FetchPixelDummy(AddrC);
-			FetchPixelDummy(AddrB);
-			FetchPixelDummy(AddrD);
+			FetchPixelDummy(pCtx,AddrA);
+			FetchPixelDummy(pCtx,AddrC);
+			FetchPixelDummy(pCtx,AddrB);
+			FetchPixelDummy(pCtx,AddrD);
 		}
 		else
 		{
-			FetchPixelDummy(AddrA);
-			FetchPixelDummy(AddrB);
-			FetchPixelDummy(AddrC);
-			FetchPixelDummy(AddrD);
+			FetchPixelDummy(pCtx,AddrA);
+			FetchPixelDummy(pCtx,AddrB);
+			FetchPixelDummy(pCtx,AddrC);
+			FetchPixelDummy(pCtx,AddrD);
 		}
-		lastFetched=AddrD;
+		pCtx->lastFetched=AddrD;
 
     }
 
@@ -1034,22 +1512,24 @@ unsigned short FetchPixel(unsigned long address)
 	static unsigned long Bbase=-1; 
 
 	unsigned long PixelWord;
-	static lastMiss=0;
 
 
 
 	if(address < (TEXTURE_MEMORY_SIZE/2))
 
-		PixelWord=textureMemory[address>>1];
+		PixelWord=pTexelMemory[address>>1];
 
 	else if( (address >= BIG_BANK) && (address < (BIG_BANK+(TEXTURE_MEMORY_SIZE/2))) )
 
-		PixelWord=textureMemory[((address ^ BIG_BANK)+(TEXTURE_MEMORY_SIZE/2))>>1];
+		PixelWord=pTexelMemory[((address ^ BIG_BANK)+(TEXTURE_MEMORY_SIZE/2))>>1];
 
 	else
 
 		fprintf(stderr,"FetchPixel: Out of address range :%lX\n",address);
 
+	if(CacheModel[CACHE_TEXTURE].enabled)
+		CacheFetch(&CacheModel[CACHE_TEXTURE],address);
+
 	if(address & 1)
 	{
 		pixel=PixelWord & 0xFFFFul;
@@ -1061,15 +1541,6 @@ unsigned short FetchPixel(unsigned long address)
 
 /*	CAMSim(address>>1,PixelWord); */
 
-	if(lastMiss!=PixelCamMiss)
-	{
-
-		lastMiss=PixelCamMiss;
-/*   		pixel=0xfff0; */
-
-	}
-
-
 /*	if(address < BIG_BANK)
 	{
 		if((address & 0xfffffe00)!=Abase)
@@ -1345,7 +1816,7 @@ post	|-
         | currently the 332 colour is expanded up to 888 incorrectly
 =========================================================================*/
 
-RGBA TexturePixel(int x,int y,int a,int b,int c,int d,int e,int f,int p,int q,int r,
+RGBA TexturePixel(TEXAS_CONTEXT *pCtx,int x,int y,int a,int b,int c,int d,int e,int f,int p,int q,int r,
 				  int exp,unsigned long address,unsigned char mapSize,
 				  pfloat pmip,unsigned char colourDepth,
 				  unsigned char mipMapped,unsigned char col4444or555,
@@ -1368,7 +1839,7 @@ RGBA TexturePixel(int x,int y,int a,int b,int c,int d,int e,int f,int p,int q,in
 	int red,green,blue,alpha;
 
 
-	TextureCallCount++;
+	pCtx->textureCallCount++;
 
 	abc=a*x + b*y + c*cfrScale;
 	def=d*x + e*y + f*cfrScale;
@@ -1377,7 +1848,7 @@ RGBA TexturePixel(int x,int y,int a,int b,int c,int d,int e,int f,int p,int q,in
 
 
 
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 
 fprintf(FtexPreCalc,"%d %d %ld %d %ld %d %ld %ld %d %ld %d %d %d %d %d %d %d ",
@@ -1505,7 +1976,7 @@ fprintf(FtexPreCalc,"%d %d %ld %d %ld %d %ld %ld %d %ld %d %d %d %d %d %d %d ",
 		/*
 		** only fetch the highest resolution map
 		*/
-		HighestCount++;
+		pCtx->highestCount++;
 
 		high_res_address=AddressCalc(u,v,address,mapSize,0,colourDepth,mipMapped,flipUV);
 
@@ -1514,7 +1985,7 @@ fprintf(FtexPreCalc,"%d %d %ld %d %ld %d %ld %ld %d %ld %d %d %d %d %d %d %d ",
 
 if(0)
 { 
-   	    fprintf(Fbilin4,"%d\n",high_res_address>>1); 
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d\n",high_res_address>>1); 
 /*   	    fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1); */
 
 			/*convert from 555 to 24Bit colour*/
@@ -1526,20 +1997,20 @@ if(0)
 }
 else
 {
-   	    fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,1);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,1);
 		
 		uFrac &= 31;
 		vFrac &= 31;
 
-   	    fprintf(Fbilin2,"%d %d %d ",uFrac,vFrac,raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d %d %d ",uFrac,vFrac,raw_pixel);
 
-		ShufflePixels(u,v,address,mapSize,0,colourDepth,mipMapped,flipUV);
+		ShufflePixels(pCtx,u,v,address,mapSize,0,colourDepth,mipMapped,flipUV);
 	
 		high_res_address=AddressCalc((u+1)& 255,v,address,mapSize,0,colourDepth,mipMapped,flipUV);
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d ",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d ",raw_pixel);
 
 		u1=ColourConvert(raw_pixel,colourDepth,(u+1) & 1,col4444or555);
  
@@ -1549,7 +2020,7 @@ else
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d ",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d ",raw_pixel);
 
 		v1=ColourConvert(raw_pixel,colourDepth,u & 1,col4444or555);
  
@@ -1559,7 +2030,7 @@ else
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d\n",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d\n",raw_pixel);
 
 		u1v1=ColourConvert(raw_pixel,colourDepth,(u+1) & 1,col4444or555);
  
@@ -1574,7 +2045,7 @@ else
 		InCD.Blue =(v1.Blue <<3) + 4 + ((u1v1.Blue -v1.Blue )*uFrac>>2);
 		InCD.Alpha=(v1.Alpha) +        ((u1v1.Alpha-v1.Alpha)*uFrac>>5);
 
-   	    fprintf(Fbilin3,"%d %d %d %d %d %d %d %d\n",InAB.Red ,InAB.Green,InAB.Blue,InAB.Alpha,
+   	    if(pCtx->dumpFiles) fprintf(Fbilin3,"%d %d %d %d %d %d %d %d\n",InAB.Red ,InAB.Green,InAB.Blue,InAB.Alpha,
 												    InCD.Red ,InCD.Green,InCD.Blue,InCD.Alpha);
 
 		red  =((int)InCD.Red   - InAB.Red  )*vFrac; 
@@ -1606,7 +2077,7 @@ else
 		/*
 		** only fetch from lowest resolution map (1x1) 
 		*/
-		LowestCount++;
+		pCtx->lowestCount++;
 
 		low_res_address=AddressCalc(u,v,address,0,8,colourDepth,mipMapped,flipUV);
 
@@ -1619,10 +2090,10 @@ else
 		tcol.Green=(tcol.Green<<3)+4;
 		tcol.Blue =(tcol.Blue <<3)+4;
 
-   	    fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,9);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,9);
 
-		CurrentTag=-1; /* so that the next shuffle fetches all 4 pixels*/
-  	    fprintf(Fbilin4,"%d\n",low_res_address>>1); 
+		pCtx->currentTag=-1; /* so that the next shuffle fetches all 4 pixels*/
+  	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d\n",low_res_address>>1); 
 /*   	    fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1); */
 
 	}
@@ -1635,7 +2106,7 @@ if(1)
 {
 		Compress=bot.e-1; 
 
-   	    fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,Compress+1);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin1,"%d %d %d %d\n",uFrac,vFrac,address>>1,Compress+1);
 
 		uFrac>>=Compress;
 		vFrac>>=Compress;
@@ -1645,11 +2116,11 @@ if(1)
 
 		high_res_address=AddressCalc(u,v,address,mapSize,Compress,colourDepth,mipMapped,flipUV);
 
-		ShufflePixels(u,v,address,mapSize,Compress,colourDepth,mipMapped,flipUV);
+		ShufflePixels(pCtx,u,v,address,mapSize,Compress,colourDepth,mipMapped,flipUV);
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d %d %d ",uFrac,vFrac,raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d %d %d ",uFrac,vFrac,raw_pixel);
 
 		high_pixel=ColourConvert(raw_pixel,colourDepth,u & 1,col4444or555);
  
@@ -1660,7 +2131,7 @@ if(1)
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d ",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d ",raw_pixel);
 
 		u1=ColourConvert(raw_pixel,colourDepth,u & 1,col4444or555);
 
@@ -1670,7 +2141,7 @@ if(1)
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d ",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d ",raw_pixel);
 
 		v1=ColourConvert(raw_pixel,colourDepth,u & 1,col4444or555);
  
@@ -1680,7 +2151,7 @@ if(1)
 
 		raw_pixel=FetchPixel(high_res_address);
 
-   	    fprintf(Fbilin2,"%d\n",raw_pixel);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin2,"%d\n",raw_pixel);
 
 		u1v1=ColourConvert(raw_pixel,colourDepth,u & 1,col4444or555);
  
@@ -1695,7 +2166,7 @@ if(1)
 		InCD.Blue =(v1.Blue <<3) + 4 + ((u1v1.Blue -v1.Blue )*uFrac>>2);
 		InCD.Alpha=(v1.Alpha) +        ((u1v1.Alpha-v1.Alpha)*uFrac>>5);
 
-   	    fprintf(Fbilin3,"%d %d %d %d %d %d %d %d\n",InAB.Red ,InAB.Green,InAB.Blue,InAB.Alpha,
+   	    if(pCtx->dumpFiles) fprintf(Fbilin3,"%d %d %d %d %d %d %d %d\n",InAB.Red ,InAB.Green,InAB.Blue,InAB.Alpha,
 												    InCD.Red ,InCD.Green,InCD.Blue,InCD.Alpha);
 
 		red  =((int)InCD.Red   - InAB.Red  )*vFrac; 
@@ -1727,11 +2198,11 @@ if(0)
 		low_res_address	=AddressCalc(u,v,address,mapSize,bot.e  ,colourDepth,mipMapped,flipUV);
 
 /*   	    fprintf(Fbilin4,"%d\n",high_res_address>>1); */
-   	    fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1);
+   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1);
 		if(low_res_address!=last_low_res_address)
 		{
 /*	   	    fprintf(Fbilin4,"%d\n",low_res_address>>1); */
-	   	    fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1);
+	   	    if(pCtx->dumpFiles) fprintf(Fbilin4,"%d %d %d\n",x,y,high_res_address>>1);
 		}
 		/*for pcx1 cache simulation*/
 		if(low_res_address==last_low_res_address)
@@ -1876,10 +2347,178 @@ long LinearShade(int t0,int t1,int t2,int x_local,int y_local)
 }
 
 /*=========================================================================
-name	|Texas
+name	|DecodeHighlight
+function|unpacks the flat highlight colours for DecodeTSP.
+in		|which, 0 for the pixels that used the shadow light
+		|address, the address of the highlight word
+out		|-
+rd		|parameterStore
+wr		|pDecode
+pre		|-
+post	|-		 
+=========================================================================*/
+
+static void DecodeHighlight(TSP_DECODE *pDecode,int which,unsigned long address)
+{
+	RGB highlightCol,shadowHighlightCol;
+
+	highlightCol      =ConvertFrom16to24(FetchParameter(address)>>16);
+	shadowHighlightCol=ConvertFrom16to24(FetchParameter(address));
+
+	highlightCol.Red=  highlightCol.Red>>3;
+	highlightCol.Green=highlightCol.Green>>3;
+	highlightCol.Blue= highlightCol.Blue>>3;
+        
+	shadowHighlightCol.Red=  shadowHighlightCol.Red>>3;
+	shadowHighlightCol.Green=shadowHighlightCol.Green>>3;
+	shadowHighlightCol.Blue= shadowHighlightCol.Blue>>3;
+
+	pDecode->highlightCol[which]=highlightCol;
+	pDecode->shadowHighlightCol[which]=shadowHighlightCol;
+}
+
+/*=========================================================================
+name	|DecodeTSP
+function|unpacks a TSP parameter block into a TSP_DECODE, so that the
+		|pixels of a span can be shaded without going back to the
+		|parameter store.
+in		|address, the address of the shading instruction
+out		|-
+rd		|parameterStore
+wr		|pDecode
+pre		|-
+post	|-		 
+=========================================================================*/
+
+static void DecodeTSP(TSP_DECODE *pDecode,unsigned long address)
+{
+	unsigned long control;
+	unsigned long inc_address;
+
+	control=FetchParameter(address);
+
+	pDecode->address=address;
+	pDecode->control=control;
+
+	inc_address=address;
+
+	/*
+	** unpack the base colour or offsets 
+	*/
+
+	if(control & MASK_SMOOTH_SHADE)
+	{
+		pDecode->x_offset=ToInt(FetchParameter(address+1)>>16);
+		pDecode->y_offset=ToInt(FetchParameter(address+1));
+	}
+	else
+	{
+		pDecode->base.Red  =control & 0xff;
+		pDecode->base.Green=(FetchParameter(address+1)>>24 ) & 0xff;
+		pDecode->base.Blue =(FetchParameter(address+1)>>16 ) & 0xff;
+
+		pDecode->shadowColour=ConvertFrom16to24(FetchParameter(address+1) & 0xffff);
+	}
+
+	/*
+	** unpack the texture parameters 
+	*/
+
+	if(control & MASK_TEXTURE) 
+	{
+		pDecode->a=ToInt(FetchParameter(address+5));
+		pDecode->b=ToInt(FetchParameter(address+5)>>16);
+		pDecode->c=ToInt(FetchParameter(address+4));
+
+		pDecode->d=ToInt(FetchParameter(address+7));
+		pDecode->e=ToInt(FetchParameter(address+7)>>16);
+		pDecode->f=ToInt(FetchParameter(address+6));
+
+		pDecode->p=ToInt(FetchParameter(address+3));
+		pDecode->q=ToInt(FetchParameter(address+3)>>16);
+		pDecode->r=ToInt(FetchParameter(address+2));
+
+		pDecode->exp=(control & MASK_EXPONENT) >> SHIFT_EXPONENT;
+
+		pDecode->globalTrans=(control & MASK_GLOBAL_TRANS) >> SHIFT_GLOBAL_TRANS;
+
+		pDecode->flipUV=(control & MASK_FLIP_UV) >> SHIFT_FLIP_UV;
+
+		pDecode->transPass=(control & MASK_TRANS) > 0;
+
+		pDecode->texture_address=(FetchParameter(address+4) >> 16) | (FetchParameter(address+6) & 0x00ff0000);
+
+		pDecode->mapSize=(FetchParameter(address+6) & MASK_MAP_SIZE) >> SHIFT_MAP_SIZE;
+
+		pDecode->pmip.m=(FetchParameter(address+2) & MASK_PMIP_M) >> SHIFT_PMIP_M;
+		pDecode->pmip.e=(FetchParameter(address+2) & MASK_PMIP_E) >> SHIFT_PMIP_E;
+
+		pDecode->colourDepth=(FetchParameter(address+6) & MASK_8_16_MAPS) > 0;
+
+		pDecode->mipMapped=(FetchParameter(address+6) & MASK_MIP_MAPPED) > 0;
+
+		pDecode->col4444or555=(FetchParameter(address+6) & MASK_4444_555) > 0;
+
+		inc_address+=8;
+	}
+	else
+	{
+ 		inc_address+=2;
+	}
+
+	/*
+	** unpack the smooth shading, the shadow light is only used by the
+	** pixels that are not in shadow
+	*/
+
+	if(control & MASK_SMOOTH_SHADE)
+	{
+		pDecode->t0=ToInt(FetchParameter(inc_address));
+		pDecode->t1=ToInt(FetchParameter(inc_address+1)>>16);
+		pDecode->t2=ToInt(FetchParameter(inc_address+1));
+			
+   		pDecode->holdCol=ConvertFrom16to24(FetchParameter(inc_address)>>16);
+
+		pDecode->holdCol.Red>>=3;
+		pDecode->holdCol.Green>>=3;
+		pDecode->holdCol.Blue>>=3;
+
+		inc_address+=2;
+
+		if(control & MASK_SHADOW_FLAG)
+		{
+			pDecode->st0=ToInt(FetchParameter(inc_address));
+			pDecode->st1=ToInt(FetchParameter(inc_address+1)>>16);
+			pDecode->st2=ToInt(FetchParameter(inc_address+1));
+
+			pDecode->holdCol1=ConvertFrom16to24(FetchParameter(inc_address)>>16);
+
+			pDecode->holdCol1.Red>>=3;
+			pDecode->holdCol1.Green>>=3;
+			pDecode->holdCol1.Blue>>=3;
+		}
+	}
+
+	/*
+	** unpack the flat highlight. Where it is depends on whether the pixel
+	** used the shadow light, so keep both.
+	*/
+
+	if(control & MASK_FLAT_HIGHLIGHT)
+	{
+		DecodeHighlight(pDecode,1,inc_address);
+
+		if((control & MASK_SMOOTH_SHADE) && (control & MASK_SHADOW_FLAG))
+			DecodeHighlight(pDecode,0,inc_address+2);
+	}
+}
+
+/*=========================================================================
+name	|TexasCtx
 function|This is the pixel interface with Sabre. Sabre communucates x,y
 		|,instruction address etc and the routine colours that pixel.
-in		|x, the x coordinate
+in		|pCtx, the state carried between pixels
+		|x, the x coordinate
 		|y, the y coordinate
 		|address, the address of the shading instruction
 		|shadow, the shadow bit 1==in shadow
@@ -1892,75 +2531,70 @@ pre		|0<x<2048
 post	|-		 
 =========================================================================*/
 
-void Texas(int x,int y,unsigned long address,unsigned char shadow,unsigned char fog)
+void TexasCtx(TEXAS_CONTEXT *pCtx,int x,int y,unsigned long address,
+			  unsigned char shadow,unsigned char fog)
 {
 	
 
 	RGBA colour;
-	RGB base,holdCol,holdCol1,shadowColour,highlightCol,shadowHighlightCol;
+	RGB base,holdCol,holdCol1,highlightCol,shadowHighlightCol;
 	int	red,green,blue;
 	
 	long fraction;
-	int t0,t1,t2;
-	int a,b,c,d,e,f,p,q,r;
-	int exp,globalTrans;
-	int x_offset,y_offset;
-	unsigned long texture_address;
-	unsigned char mapSize,colourDepth,mipMapped,transPass,col4444or555,flipUV;
-	pfloat pmip;
-	unsigned long inc_address;
+	int shadowLight;
+	TSP_DECODE *pD;
 
-	static int last_plane=-1; /*this is for ians simulation testing*/
-	static int last_x=-1;
-	static int last_y=-1;
 
-	static long lastMiss=-1;
 
+	pD=&pCtx->decode;
 
-	if(address==last_plane && ((x % 32)!=0) && last_y==y && last_x==x-1) 
+	if(address==pCtx->lastPlane && ((x % 32)!=0) && pCtx->lastY==y && pCtx->lastX==x-1) 
 /*	if(address==last_plane && iter_count<31 && last_y==y && last_x==x-1)  */
 	{
-		iter_count++;
-		last_x=x;
-		spanflag=0;
+		pCtx->iterCount++;
+		pCtx->lastX=x;
+		pCtx->spanFlag=0;
 	}
 	else
 	{
-		if(DUMP_PARAM_FILES==1)
+		/* a new span, so unpack its parameters */
+
+		DecodeTSP(pD,address);
+
+		if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles)
 		{
-		   fprintf(FshadePreCalc,"%d\n%d %d %d %d %d ", iter_count,
-				  (FetchParameter(address) & MASK_TEXTURE)>0,
-				  (FetchParameter(address) & MASK_SMOOTH_SHADE)>0,
-				  (FetchParameter(address) & MASK_SHADOW_FLAG)>0,
-				  (FetchParameter(address) & MASK_FLAT_HIGHLIGHT)>0,
-			  	  (FetchParameter(address) & MASK_TRANS) > 0 );
+		   fprintf(FshadePreCalc,"%d\n%d %d %d %d %d ", pCtx->iterCount,
+				  (pD->control & MASK_TEXTURE)>0,
+				  (pD->control & MASK_SMOOTH_SHADE)>0,
+				  (pD->control & MASK_SHADOW_FLAG)>0,
+				  (pD->control & MASK_FLAT_HIGHLIGHT)>0,
+			  	  (pD->control & MASK_TRANS) > 0 );
 		}
-		if(DUMP_PARAM_FILES==1 && previousPlaneWasTextured)
+		if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->previousPlaneWasTextured)
 		{
-			fprintf(FtexPreCalc,"%d\n",iter_count);
+			fprintf(FtexPreCalc,"%d\n",pCtx->iterCount);
 		} 
-		iter_count=0;
-		last_plane=address;
-		last_x=x;
-		last_y=y;
-		spanflag=1;
+		pCtx->iterCount=0;
+		pCtx->lastPlane=address;
+		pCtx->lastX=x;
+		pCtx->lastY=y;
+		pCtx->spanFlag=1;
 
 	}
 
-	previousPlaneWasTextured=(FetchParameter(address) & MASK_TEXTURE)>0; /*for texprecalc*/
+	pCtx->previousPlaneWasTextured=(pD->control & MASK_TEXTURE)>0; /*for texprecalc*/
 
-	inc_address=address;
+	/* the shadow light only lights the pixels that are not in shadow */
+
+	shadowLight=(pD->control & MASK_SHADOW_FLAG) && (shadow==0);
 
 	/*
-	** unpack the base colour or offsets 
+	** the base colour 
 	*/
 
-	if(FetchParameter(address) & MASK_SMOOTH_SHADE)
+	if(pD->control & MASK_SMOOTH_SHADE)
 	{
-		x_offset=ToInt(FetchParameter(address+1)>>16);
-		y_offset=ToInt(FetchParameter(address+1));
-
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"0 0 0 0 0 0 ");
 
@@ -1968,28 +2602,24 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 	}
 	else
 	{
-		base.Red  =FetchParameter(address) & 0xff;
-		base.Green=(FetchParameter(address+1)>>24 ) & 0xff;
-		base.Blue =(FetchParameter(address+1)>>16 ) & 0xff;
-
-		shadowColour=ConvertFrom16to24(FetchParameter(address+1) & 0xffff);
+		base=pD->base;
 
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"%d %d %d %d %d %d ",(int)base.Red,(int)base.Green,(int)base.Blue,
-		   (int)shadowColour.Red>>3,(int)shadowColour.Green>>3,(int)shadowColour.Blue>>3);
+		   (int)pD->shadowColour.Red>>3,(int)pD->shadowColour.Green>>3,(int)pD->shadowColour.Blue>>3);
 
 }
 
-		if((FetchParameter(address) & MASK_SHADOW_FLAG) && (shadow==0))
+		if(shadowLight)
 		{
 			/*
 			** add in the shadow light
 			*/
 			
-			red  =base.Red   + shadowColour.Red;
-			green=base.Green + shadowColour.Green;
-			blue =base.Blue  + shadowColour.Blue;
+			red  =base.Red   + pD->shadowColour.Red;
+			green=base.Green + pD->shadowColour.Green;
+			blue =base.Blue  + pD->shadowColour.Blue;
 
 			/*clip to 255*/
 
@@ -2006,51 +2636,16 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 	** perform the texture calculation
 	*/
 
-	if(FetchParameter(address) & MASK_TEXTURE) 
+	if(pD->control & MASK_TEXTURE) 
 	{
+		if(TexasCacheModel)
+			CacheTexture=pD->texture_address;
 
+		colour=TexturePixel(pCtx,x,y,pD->a,pD->b,pD->c,pD->d,pD->e,pD->f,pD->p,pD->q,pD->r,
+							pD->exp,pD->texture_address,pD->mapSize,pD->pmip,pD->colourDepth,
+							pD->mipMapped,pD->col4444or555,pD->globalTrans,pD->flipUV,pD->transPass);
 
-		/*
-		** unpack the parameters 
-		*/
-
-		a=ToInt(FetchParameter(address+5));
-		b=ToInt(FetchParameter(address+5)>>16);
-		c=ToInt(FetchParameter(address+4));
-
-		d=ToInt(FetchParameter(address+7));
-		e=ToInt(FetchParameter(address+7)>>16);
-		f=ToInt(FetchParameter(address+6));
-
-		p=ToInt(FetchParameter(address+3));
-		q=ToInt(FetchParameter(address+3)>>16);
-		r=ToInt(FetchParameter(address+2));
-
-		exp=(FetchParameter(address) & MASK_EXPONENT) >> SHIFT_EXPONENT;
-
-		globalTrans=(FetchParameter(address) & MASK_GLOBAL_TRANS) >> SHIFT_GLOBAL_TRANS;
-
-		flipUV=(FetchParameter(address) & MASK_FLIP_UV) >> SHIFT_FLIP_UV;
-
-		transPass=(FetchParameter(address) & MASK_TRANS) > 0;
-
-		texture_address=(FetchParameter(address+4) >> 16) | (FetchParameter(address+6) & 0x00ff0000);
-
-		mapSize=(FetchParameter(address+6) & MASK_MAP_SIZE) >> SHIFT_MAP_SIZE;
-
-		pmip.m=(FetchParameter(address+2) & MASK_PMIP_M) >> SHIFT_PMIP_M;
-		pmip.e=(FetchParameter(address+2) & MASK_PMIP_E) >> SHIFT_PMIP_E;
-
-		colourDepth=(FetchParameter(address+6) & MASK_8_16_MAPS) > 0;
-
-		mipMapped=(FetchParameter(address+6) & MASK_MIP_MAPPED) > 0;
-
-		col4444or555=(FetchParameter(address+6) & MASK_4444_555) > 0;
-
-		colour=TexturePixel(x,y,a,b,c,d,e,f,p,q,r,exp,texture_address,mapSize,pmip,colourDepth,mipMapped,
-							col4444or555,globalTrans,flipUV,transPass);
-
-if(DUMP_PARAM_FILES==1)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles)
 {
 	fprintf(FrawTexPixels,"%d %d %d %d\n",(int)colour.Red,(int)colour.Green,
 										  (int)colour.Blue,(int)colour.Alpha);
@@ -2062,7 +2657,7 @@ if(DUMP_PARAM_FILES==1)
 		** perform the flat shading
 		*/
 
-		if((FetchParameter(address) & MASK_SMOOTH_SHADE)==0)
+		if((pD->control & MASK_SMOOTH_SHADE)==0)
 		{
 			/*multiply by the base colour*/
 
@@ -2072,7 +2667,6 @@ if(DUMP_PARAM_FILES==1)
 
 
 		}
-		inc_address+=8;
 	}
 	else
 	{
@@ -2080,32 +2674,22 @@ if(DUMP_PARAM_FILES==1)
 		colour.Green=base.Green;
 		colour.Blue =base.Blue;
 		colour.Alpha=0;
-
- 		inc_address+=2;
 	}
 
-	if(FetchParameter(address) & MASK_SMOOTH_SHADE)
+	if(pD->control & MASK_SMOOTH_SHADE)
 	{
 
 		/*
 		**  Non shadowed smooth shade white.
 		*/
 
-		t0=ToInt(FetchParameter(inc_address));
-		t1=ToInt(FetchParameter(inc_address+1)>>16);
-		t2=ToInt(FetchParameter(inc_address+1));
-			
-		fraction=LinearShade(t0,t1,t2,x-x_offset,y-y_offset);
-
-   		holdCol=ConvertFrom16to24(FetchParameter(inc_address)>>16);
+		fraction=LinearShade(pD->t0,pD->t1,pD->t2,x-pD->x_offset,y-pD->y_offset);
 
-		holdCol.Red>>=3;
-		holdCol.Green>>=3;
-		holdCol.Blue>>=3;
+   		holdCol=pD->holdCol;
 
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
-	fprintf(FshadePreCalc,"%ld %d %d %d %d ",fraction,t2,(int)holdCol.Red,
+	fprintf(FshadePreCalc,"%ld %d %d %d %d ",fraction,pD->t2,(int)holdCol.Red,
 											(int)holdCol.Green,(int)holdCol.Blue);
 
 }
@@ -2134,30 +2718,19 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 			holdCol.Blue+=4;
 		}
 
-		inc_address+=2;
-
 		/*
 		**  Deal with the one possible shadow light.
 		*/
 			
-		if((FetchParameter(address) & MASK_SHADOW_FLAG) && (shadow==0))
+		if(shadowLight)
 		{
+			fraction=LinearShade(pD->st0,pD->st1,pD->st2,x-pD->x_offset,y-pD->y_offset);
 
-			t0=ToInt(FetchParameter(inc_address));
-			t1=ToInt(FetchParameter(inc_address+1)>>16);
-			t2=ToInt(FetchParameter(inc_address+1));
-
-			fraction=LinearShade(t0,t1,t2,x-x_offset,y-y_offset);
-
-			holdCol1=ConvertFrom16to24(FetchParameter(inc_address)>>16);
-
-			holdCol1.Red>>=3;
-			holdCol1.Green>>=3;
-			holdCol1.Blue>>=3;
+			holdCol1=pD->holdCol1;
 	
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
-	fprintf(FshadePreCalc,"%ld %d %d %d %d ",fraction,t2,(int)holdCol1.Red,
+	fprintf(FshadePreCalc,"%ld %d %d %d %d ",fraction,pD->st2,(int)holdCol1.Red,
 											(int)holdCol1.Green,(int)holdCol1.Blue);
 
 }
@@ -2194,14 +2767,10 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 			holdCol.Red  =(red  >255) ? 255 : red;
 			holdCol.Green=(green>255) ? 255 : green;
 			holdCol.Blue =(blue >255) ? 255 : blue;
-
-			inc_address+=2;
-
-
 		}
         else
         {
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"0 0 0 0 0 ");
 
@@ -2209,7 +2778,7 @@ if(DUMP_PARAM_FILES==1 && spanflag)
         }
 
 
-		if((FetchParameter(address) & MASK_TEXTURE)==0) 
+		if((pD->control & MASK_TEXTURE)==0) 
 		{
 
 			colour.Red  =holdCol.Red;
@@ -2232,7 +2801,7 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 	}
     else
     {
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"0 0 0 0 0 0 0 0 0 0 ");
 
@@ -2240,31 +2809,31 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 
 	}
    	/*
-	**  Deal with the flat highlights.
+	**  Deal with the flat highlights. The smooth shaded shadow light moves
+	**  the highlight along.
 	*/
 
-    if(FetchParameter(address) & MASK_FLAT_HIGHLIGHT)
+    if(pD->control & MASK_FLAT_HIGHLIGHT)
     {
-		highlightCol      =ConvertFrom16to24(FetchParameter(inc_address)>>16);
-		shadowHighlightCol=ConvertFrom16to24(FetchParameter(inc_address));
-
-		highlightCol.Red=  highlightCol.Red>>3;
-		highlightCol.Green=highlightCol.Green>>3;
-		highlightCol.Blue= highlightCol.Blue>>3;
-        
-		shadowHighlightCol.Red=  shadowHighlightCol.Red>>3;
-		shadowHighlightCol.Green=shadowHighlightCol.Green>>3;
-		shadowHighlightCol.Blue= shadowHighlightCol.Blue>>3;
-
+		if((pD->control & MASK_SMOOTH_SHADE) && shadowLight)
+		{
+			highlightCol      =pD->highlightCol[0];
+			shadowHighlightCol=pD->shadowHighlightCol[0];
+		}
+		else
+		{
+			highlightCol      =pD->highlightCol[1];
+			shadowHighlightCol=pD->shadowHighlightCol[1];
+		}
 
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"%d %d %d %d %d %d ",(int)highlightCol.Red>>3,(int)highlightCol.Green>>3,
 											   (int)highlightCol.Blue>>3,(int)shadowHighlightCol.Red>>3,
 											   (int)shadowHighlightCol.Green>>3,(int)shadowHighlightCol.Blue>>3);
 
 }		
-		if((FetchParameter(address) & MASK_SHADOW_FLAG) && (shadow==0))
+		if(shadowLight)
 		{
 			/* add in the shadow light's highlight */
 			
@@ -2291,12 +2860,10 @@ if(DUMP_PARAM_FILES==1 && spanflag)
    		colour.Red  =(red  >255) ? 255 : red;
    		colour.Green=(green>255) ? 255 : green;
    		colour.Blue =(blue >255) ? 255 : blue;
-
-		inc_address+=1;
 	}
     else
     {
-if(DUMP_PARAM_FILES==1 && spanflag)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles && pCtx->spanFlag)
 {
 	fprintf(FshadePreCalc,"0 0 0 0 0 0 ");
 
@@ -2306,7 +2873,7 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 
 
 	/* now interpolate with the fog colour */
-	if((FetchParameter(address) & MASK_DISABLE_FOG) == 0)
+	if((pD->control & MASK_DISABLE_FOG) == 0)
 	{
 
 	/*	colour.Red   =( (colour.Red  *(256-fog)) + (fogColour.Red  *fog) )>>8;
@@ -2322,7 +2889,7 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 		colour.Blue =(blue >>8)+(int)colour.Blue; 
 	}
 
-	if((FetchParameter(address) & MASK_TRANS) > 0)
+	if((pD->control & MASK_TRANS) > 0)
 	{
 		/* make 15 completely translucent */
 
@@ -2354,7 +2921,7 @@ if(DUMP_PARAM_FILES==1 && spanflag)
 		colour.Blue =blue;
 	}		
 
-if(DUMP_PARAM_FILES==1)
+if(DUMP_PARAM_FILES==1 && pCtx->dumpFiles)
 {
 
         fprintf(Fpixels,"%d %d %d\n",(int)colour.Red,(int)colour.Green,(int)colour.Blue);
@@ -2373,16 +2940,105 @@ if(DUMP_PARAM_FILES==1)
 	frameBuffer[y*Bitmap_xdim + x].Green=colour.Green;
    	frameBuffer[y*Bitmap_xdim + x].Blue =colour.Blue; 
 
-	if(x==639 && y==479)
+	if(Trace.file)
+	{
+		TEXAS_TRACE_RECORD *pRecord=&pCtx->trace[pCtx->traceCount++];
+
+		pRecord->x=x;
+		pRecord->y=y;
+		pRecord->address=address;
+		pRecord->red=colour.Red;
+		pRecord->green=colour.Green;
+		pRecord->blue=colour.Blue;
+		pRecord->alpha=colour.Alpha;
+		pRecord->shadow=shadow;
+		pRecord->fog=fog;
+		pRecord->reserved=0;
+
+		if(pCtx->traceCount==TEXAS_TRACE_BATCH)
+			TexasTraceFlushContext(pCtx);
+	}
+
+	/* only the serial context sees the pixels in order */
+
+	if(pCtx==&TexasContext && x==639 && y==479)
 	{
 		printf("ShuffCount=%d PixelCamMiss=%d PixelCamHit=%d PCXCache=%d PCXCacheNU=%d HighestCount=%d LowestCount=%d\n",
-			ShuffCount,PixelCamMiss,PixelCamHit,PCXCache,PCXCacheNU,HighestCount,LowestCount);
+			pCtx->shuffCount,PixelCamMiss,PixelCamHit,PCXCache,PCXCacheNU,pCtx->highestCount,pCtx->lowestCount);
 
 	}
-	if(x==319 && y==255)
+	if(pCtx==&TexasContext && x==319 && y==255)
 	{
-		printf("BreakCount=%d DummyBreakCount=%d\n",BreakCount,DummyBreakCount);
+		printf("BreakCount=%d DummyBreakCount=%d\n",BreakCount,pCtx->dummyBreakCount);
 
 	}
 }
 
+/*=========================================================================
+name	|Texas
+function|Texas with the global serial context, see TexasCtx.
+=========================================================================*/
+
+void Texas(int x,int y,unsigned long address,unsigned char shadow,unsigned char fog)
+{
+	TexasCtx(&TexasContext,x,y,address,shadow,fog);
+}
+
+/*=========================================================================
+name	|InitTexasContext
+function|sets a texas state block to the power on values.
+in		|pCtx,
+		|dumpFiles, non zero to write the params/ dump files
+out		|-
+rd		|-
+wr		|pCtx
+pre		|-
+post	|-		 
+=========================================================================*/
+
+void InitTexasContext(TEXAS_CONTEXT *pCtx,int dumpFiles)
+{
+	pCtx->lastPlane=-1;
+	pCtx->lastX=-1;
+	pCtx->lastY=-1;
+	pCtx->iterCount=0;
+	pCtx->spanFlag=0;
+	pCtx->previousPlaneWasTextured=1;
+
+	pCtx->currentTag=-1;
+	pCtx->currentX=0;
+	pCtx->currentY=0;
+	pCtx->lastFetched=0;
+	pCtx->dummyABase=-1;
+	pCtx->dummyBBase=-1;
+
+	pCtx->shuffCount=0;
+	pCtx->dummyBreakCount=0;
+	pCtx->textureCallCount=0;
+	pCtx->highestCount=0;
+	pCtx->lowestCount=0;
+
+	pCtx->dumpFiles=dumpFiles;
+
+	pCtx->traceCount=0;
+}
+
+/*=========================================================================
+name	|TexasTraceFlushContext
+function|passes the pixels a context has collected on to the trace.
+in		|pCtx,
+out		|-
+rd		|-
+wr		|pCtx, Trace
+pre		|-
+post	|-		 
+=========================================================================*/
+
+void TexasTraceFlushContext(TEXAS_CONTEXT *pCtx)
+{
+	if(Trace.file && pCtx->traceCount)
+		TraceAppend(pCtx->trace,pCtx->traceCount);
+
+	pCtx->traceCount=0;
+}
+
@@ -202,6 +202,7 @@
 #include "tmalloc.h"
 #include "texapi.h"
 #include "texapip.h"
+#include "texconv.h"
 
 #include "memory.h"
 
@@ -482,6 +483,13 @@ HTEXTURE CALL_CONV TextureCreate (HTEXHEAP hTexHeap, PTEXTURESPEC pTextureSpec)
 	*pTPD->pTextureSpec->pFormat = *pTextureSpec->pFormat;
 
 	pTPD->MemBlock = MemBlock;
+
+	/* the creator promises not to keep copies of the control word */
+	if(pTextureSpec->pFormat->Flags & TF_MOVABLE)
+	{
+		TSetOwner(&pTPD->MemBlock, hTex);
+		pTPD->pTextureSpec->pFormat->Flags &= ~TF_MOVABLE;
+	}
 	
 	/*calculate the texture address*/
 	TextureAddress=MemBlock.MNode->MemoryAddress>>1; /* from bytes to 16Bit words*/
@@ -568,263 +576,134 @@ sgl_uint32 CALL_CONV TextureFree (HTEXHEAP hTexHeap, HTEXTURE hTex)
 } /* end of TextureFree */
 
 /******************************************************************************
- *  The following functions write 8x8 pixels for different map levels.
- *				  
- *   Write 8 Pixels for the MapLevel with:
- *
- *   pPixels,              pPixels+2, 
- *   pPixels+4*MapWidth,   pPixels+4*MapWidth+2, 
- *   pPixels+4,            pPixels+6, 
- *   pPixels+4*MapWidth+4, pPixels+4*MapWidth+6. 
- * 
- *   Write 2 Pixels for:
+ * Function Name: TextureMoved    INTERNAL ONLY
  *
- *			  pPixels,              pPixels+MapWidth,
- *			  pPixels+1,            pPixels+MapWidth+1,
- *			  pPixels+2*MapWidth,   pPixels+3*MapWidth,
- *			  pPixels+2*MapWidth+1, pPixels+3*MapWidth+1. 
+ * Inputs       : hTexHeap, MNode, OldAddress.
  *
- *****************************************************************************/
-#if 0      		
-	/*       c functions      */
-	#define PixelPair(pDst, pSrc, DstIndex, TexWidth) \
-    	IW (pDst, DstIndex, (((*(pSrc))<<16) | (*(pSrc+TexWidth))))
-	#define FourPairs(pDst, pSrc, TexWidth) \
-	PixelPair(pDst, pSrc,              0, TexWidth);\
-	PixelPair(pDst, pSrc+1,            1, TexWidth);\
-	PixelPair(pDst, pSrc+2*TexWidth,   2, TexWidth);\
-	PixelPair(pDst, pSrc+2*TexWidth+1, 3, TexWidth)				
-	
-/******************************************************************************
- * Function Name: Write8x8Pixels   INTERNAL ONLY
- *
- * Inputs       : *pPixels, Pitch, *pAddress.
- *				  
  * Outputs      : None
- * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 8x8. 
  *
- *****************************************************************************/
-static void Write8x8Pixels(sgl_uint16  *pPixels, 
-				  	int			Pitch,
-				  	sgl_uint32  *pAddress)
-{
-	FourPairs(pAddress, pPixels, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+2, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+32, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+34, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+4, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+6, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+36, 8);
-	pAddress += Pitch >> 1;
-	FourPairs(pAddress, pPixels+38, 8);
-}
-
-/******************************************************************************
- * Function Name: Write8x8PixelsFor16   INTERNAL ONLY
- *
- * Inputs       : *pPixels, Pitch, **pAddress.
- *				  
- * Outputs      : None
  * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 16x16. 
  *
+ * Description  : TCompact callback. Copies both banks of a block that has
+ *				  been moved (MIP maps use both banks whichever one they
+ *				  were allocated in) and updates the textures in it.
  *****************************************************************************/
-static void Write8x8PixelsFor16(	sgl_uint16  *pPixels, 
-				  			int			  Pitch,
-				  			sgl_uint32  **pAddress)
+static void TextureMoved (HTEXHEAP hTexHeap, MNODE *MNode, sgl_uint32 OldAddress)
 {
-	FourPairs((*pAddress), pPixels, 16);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+2, 16);
-	(*pAddress) += 4 + ((Pitch-16) >> 1);	
-	FourPairs((*pAddress), pPixels+64, 16);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+66, 16);
-	(*pAddress) += 4 + ((Pitch-16) >> 1);	
-	FourPairs((*pAddress), pPixels+4, 16);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+6, 16);
-	(*pAddress) += 4 + ((Pitch-16) >> 1);	
-	FourPairs((*pAddress), pPixels+68, 16);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+70, 16);
-	(*pAddress) += 4 + ((Pitch-16) >> 1);	
-}
+	sgl_uint32 *pTexMem = (sgl_uint32 *) hTexHeap->pTextureMemory;
+	sgl_uint32 *pSrc, *pDst;
+	sgl_uint32 Bank, Words, k;
+	int nBank;
 
-/******************************************************************************
- * Function Name: Write8x8PixelsFor32   INTERNAL ONLY
- *
- * Inputs       : *pPixels, Pitch, **pAddress.
- *				  
- * Outputs      : None
- * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 32x32. 
- *
- *****************************************************************************/
-static void Write8x8PixelsFor32(	sgl_uint16  *pPixels, 
-				  			int			  Pitch,
-				  			sgl_uint32  **pAddress)
-{
-	FourPairs((*pAddress), pPixels, 32);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+2, 32);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+128, 32);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+130, 32);
-	(*pAddress) += 4 + ((Pitch-32) >> 1);	
-	FourPairs((*pAddress), pPixels+4, 32);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+6, 32);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+132, 32);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+134, 32);
-	(*pAddress) += 4 + ((Pitch-32) >> 1);	
-}
+	Words = MNode->BlockSize >> 2;
 
-/******************************************************************************
- * Function Name: Write8x8PixelsFor64   INTERNAL ONLY
- *
- * Inputs       : *pPixels, Pitch, **pAddress.
- *				  
- * Outputs      : None
- * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 64x64. 
- *
- *****************************************************************************/
+	for(nBank=0; nBank<2; nBank++)
+	{
+		Bank = nBank ? BIG_BANK : 0;
 
-static void Write8x8PixelsFor64(	sgl_uint16  *pPixels, 
-				  			int			  Pitch,
-				  			sgl_uint32  **pAddress)
-{
-	FourPairs((*pAddress), pPixels, 64);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+2, 64);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+256, 64);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+258, 64);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+4, 64);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+6, 64);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+260, 64);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+262, 64);
-	(*pAddress) += 4 + ((Pitch-64) >> 1);	
-}
+		pSrc = pTexMem + ((Bank | (OldAddress >> 1)) >> 1);
+		pDst = pTexMem + ((Bank | (MNode->MemoryAddress >> 1)) >> 1);
 
-/******************************************************************************
- * Function Name: Write8x8PixelsFor128   INTERNAL ONLY
- *
- * Inputs       : *pPixels, **pAddress.
- *				  
- * Outputs      : None
- * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 128x128. 
- *
- *****************************************************************************/
-static void Write8x8PixelsFor128(sgl_uint16  *pPixels, 
-				  		sgl_uint32  **pAddress)
-{
-	FourPairs((*pAddress), pPixels, 128);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+2, 128);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+512, 128);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+514, 128);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+4, 128);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+6, 128);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+516, 128);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+518, 128);
-	(*pAddress) += 4;	
+		/* the two may overlap */
+		if(pDst > pSrc)
+		{
+			for(k=Words; k>0; k--)
+			{
+				IW( pDst, k-1, IR( pSrc, k-1));
+			}
+		}
+		else
+		{
+			for(k=0; k<Words; k++)
+			{
+				IW( pDst, k, IR( pSrc, k));
+			}
+		}
+	}
+
+	for(nBank=0; nBank<2; nBank++)
+	{
+		HTEXTURE hTex = (HTEXTURE) MNode->Owner[nBank];
+
+		if(hTex != NULL)
+		{
+			((TPRIVATEDATA *) hTex->pPrivateData)->MemBlock.MNode = MNode;
+
+			hTex->TSPTextureControlWord += (MNode->MemoryAddress >> 1) - (OldAddress >> 1);
+		}
+	}
 }
 
 /******************************************************************************
- * Function Name: Write8x8PixelsFor256   INTERNAL ONLY
+ * Function Name: TextureCompact
+ *
+ * Inputs       : hTexHeap, MaxBytes.
  *
- * Inputs       : *pPixels, **pAddress.
- *				  
  * Outputs      : None
- * Returns      : None
- * Globals Used : None
  *
- * Description  : Write 8x8 Pixels into texture memory for 256. 
+ * Returns      : Bytes moved. If MaxBytes is 0, nothing is moved and it
+ *				  returns non zero if there may be something to move.
  *
+ * Description  : Moves textures created with TF_MOVABLE together so that
+ *				  the free texture memory ends up in one piece, stopping
+ *				  after roughly MaxBytes. The caller has to make sure that
+ *				  the hardware is not using the textures, and that nothing
+ *				  holds on to their old control words.
  *****************************************************************************/
-static void Write8x8PixelsFor256(sgl_uint16  *pPixels, 
-				  		sgl_uint32  **pAddress)
+sgl_uint32 CALL_CONV TextureCompact (HTEXHEAP hTexHeap, sgl_uint32 MaxBytes)
 {
-	FourPairs((*pAddress), pPixels, 256);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+2, 256);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+1024, 256);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+1026, 256);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+4, 256);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+6, 256);
-	(*pAddress) += 4;	
-	FourPairs((*pAddress), pPixels+1028, 256);
-	(*pAddress) += 4;
-	FourPairs((*pAddress), pPixels+1030, 256);
-	(*pAddress) += 4;	
-}
-	
-#else
-	/* assembler functions   */
-	extern Write8x8PixelsFor256(void *pSrc, void *pDst, sgl_uint32 MaskRGB);
-	extern Write8x8PixelsFor128(void *pSrc, void *pDst, sgl_uint32 MaskRGB);
-	extern Write8x8PixelsFor64(void *pSrc, int Pitch, void *pDst, sgl_uint32 MaskRGB);
-	extern Write8x8PixelsFor32(void *pSrc, int Pitch, void *pDst, sgl_uint32 MaskRGB);
-	extern Write8x8PixelsFor16(void *pSrc, int Pitch, void *pDst, sgl_uint32 MaskRGB);
-	extern Write8x8Pixels(void *pSrc, int Pitch, void *pDst, sgl_uint32 MaskRGB);
-
-	extern Write8x8For256ReversedAlpha(void *pSrc, void *pDst, sgl_uint32 AlphaMasks);
-	extern Write8x8For128ReversedAlpha(void *pSrc, void *pDst, sgl_uint32 AlphaMasks);
-	extern Write8x8For64ReversedAlpha(void *pSrc, int Pitch, void *pDst, sgl_uint32 AlphaMasks);
-	extern Write8x8For32ReversedAlpha(void *pSrc, int Pitch, void *pDst, sgl_uint32 AlphaMasks);
-	extern Write8x8For16ReversedAlpha(void *pSrc, int Pitch, void *pDst, sgl_uint32 AlphaMasks);
-	extern Write8x8ReversedAlpha(void *pSrc, int Pitch, void *pDst, sgl_uint32 AlphaMasks);
-#endif
+	sgl_uint32 Moved;
+
+	ASSERT(hTexHeap != NULL);
+
+	if(!TNeedsCompacting(hTexHeap))
+	{
+		return(0);
+	}
+
+	if(MaxBytes == 0)
+	{
+		return(1);
+	}
+
+	SynchroniseTexMemAccess (hTexHeap, TRUE);
+
+	Moved = TCompact(hTexHeap, MaxBytes, TextureMoved);
+
+	SynchroniseTexMemAccess (hTexHeap, FALSE);
+
+	return(Moved);
+
+} /* end of TextureCompact */
+
+/*
+// The kernel maps of 8x8 and up are twiddled with (see texconv.h), picked
+// the first time it is needed. nTexTwiddleLanes is 0 until then.
+*/
+static TEXTWIDDLEFN	pfnTexTwiddle = NULL;
+static int			nTexTwiddleLanes = 0;
+
+/*
+// The kernel TextureLoad converts with (see texconv.h), picked the first
+// time it is needed. nTexConvLanes is 0 until then.
+*/
+static TEXCONVFN	pfnTexConv = NULL;
+static int			nTexConvLanes = 0;
 
 /******************************************************************************
  * Function Name: WriteTexture    INTERNAL ONLY
  *
- * Inputs       : DestAddress, pBusBurstSpace, MapLevel, Pitch, *pPixels, nReversedAlpha.
+ * Inputs       : DestAddress, pBusBurstSpace, MapLevel, Pitch, *pPixels, nReversedAlpha,
+ *				  pConv.
  *
  * Outputs      : None
  *
  * Returns      : None
  *
  * Description  : Writes one level texture map  directly into the texture
- *				  memory.
+ *				  memory. If pConv isn't NULL, pPixels are the unconverted
+ *				  source pixels, converted as they are written; only maps
+ *				  of 8x8 and up can be written that way.
  *				  
  *****************************************************************************/
 static void WriteTexture(	sgl_uint32		DestAddress,
@@ -834,23 +713,12 @@ static void WriteTexture(	sgl_uint32		DestAddress,
 					sgl_uint16		*pPixels,
 					int				nReversedAlpha,
 					sgl_uint32		AlphaMasks,
-					sgl_uint32 		MaskRGB)
+					sgl_uint32 		MaskRGB,
+					const TEXCONV	*pConv)
 { 
-	int n16, n32, n64, n128;
 	sgl_uint32 *pAddress;
-	sgl_uint16 *pPixels16, *pPixels32, *pPixels64, *pPixels128;
 
-	int nIndex32For64[4] = {0, 2048, 32, 2080};
-	int nIndex16For64[4] = {0, 1024, 16, 1040};
-	
-	int nIndex64For128[4] = {0, 8192, 64, 8256};
-	int nIndex32For128[4] = {0, 4096, 32, 4128};
-	int nIndex16For128[4] = {0, 2048, 16, 2064};
-	
-	int nIndex128For256[4] = {0, 32768, 128, 32896};
-	int nIndex64For256[4] =  {0, 16384,  64, 16448};
-	int nIndex32For256[4] =  {0,  8192,  32,  8224};
-	int nIndex16For256[4] =  {0,  4096,  16,  4112};
+	ASSERT((pConv == NULL) || (MapLevel >= MIPMAP_LEVEL_3));
 
 	pAddress = pBusBurstSpace + (DestAddress>>1);
 	switch(MapLevel)
@@ -935,249 +803,49 @@ static void WriteTexture(	sgl_uint32		DestAddress,
 			break;
 		}
 	    case  MIPMAP_LEVEL_3:
-		{	
-			/* 8x8 */
-			if(!nReversedAlpha)
-			{
-				Write8x8Pixels(pPixels, Pitch, pAddress, MaskRGB);
-			}
-			else		/* reversed alpha   */
-			{
-				Write8x8ReversedAlpha(pPixels, Pitch, pAddress, AlphaMasks);
-			}
-			break;
-		}
 		case  MIPMAP_LEVEL_4:
-		{	
-			/* 16x16 */
-			/*  Write one quarter of the pixels for each level with:
-			//  pPixels,      			pPixels+HalfLevelWidth*MapWidth,
-			//  pPixels+HalfLevelWidth, pPixels+HalfLevelWidth*MapWidth+HalfLevelWidth.
-			*/
-			if(!nReversedAlpha)
-			{
-				Write8x8PixelsFor16(pPixels, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor16(pPixels+128, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor16(pPixels+8, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor16(pPixels+136, Pitch, &pAddress, MaskRGB);
-			}
-			else		/* reversed alpha   */
-			{
-				Write8x8For16ReversedAlpha(pPixels, Pitch, &pAddress, AlphaMasks);
-				Write8x8For16ReversedAlpha(pPixels+128, Pitch, &pAddress, AlphaMasks);
-				Write8x8For16ReversedAlpha(pPixels+8, Pitch, &pAddress, AlphaMasks);
-				Write8x8For16ReversedAlpha(pPixels+136, Pitch, &pAddress, AlphaMasks);
-			}
-			break;
-		}
 		case  MIPMAP_LEVEL_5:
-		{	
-			/* 32x32 */
-			if(!nReversedAlpha)
-			{
-				Write8x8PixelsFor32(pPixels,     Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+256, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+8,   Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+264, Pitch, &pAddress, MaskRGB);
-			
-				Write8x8PixelsFor32(pPixels+512, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+768, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+520, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+776, Pitch, &pAddress, MaskRGB);
-			
-				Write8x8PixelsFor32(pPixels+16,  Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+272, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+24,  Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+280, Pitch, &pAddress, MaskRGB);
-			
-				Write8x8PixelsFor32(pPixels+528, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+784, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+536, Pitch, &pAddress, MaskRGB);
-				Write8x8PixelsFor32(pPixels+792, Pitch, &pAddress, MaskRGB);
-			}
-			else		/* reversed alpha   */
-			{
-				Write8x8For32ReversedAlpha(pPixels,     Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+256, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+8,   Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+264, Pitch, &pAddress, AlphaMasks);
-			
-				Write8x8For32ReversedAlpha(pPixels+512, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+768, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+520, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+776, Pitch, &pAddress, AlphaMasks);
-			
-				Write8x8For32ReversedAlpha(pPixels+16,  Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+272, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+24,  Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+280, Pitch, &pAddress, AlphaMasks);
-			
-				Write8x8For32ReversedAlpha(pPixels+528, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+784, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+536, Pitch, &pAddress, AlphaMasks);
-				Write8x8For32ReversedAlpha(pPixels+792, Pitch, &pAddress, AlphaMasks);
-			}
-			break;
-		}
 		case  MIPMAP_LEVEL_6:
+		case  MIPMAP_LEVEL_7:
+		case  MIPMAP_LEVEL_8:
 		{
-			/* 64x64  */
-			for(n32=0; n32<4; n32++)
+			/* 8x8 to 256x256 */
+			if(nTexTwiddleLanes == 0)
 			{
-				/* 32x32 for 64x64 */
-				pPixels32 = pPixels + nIndex32For64[n32];
-				for(n16=0; n16<4; n16++)
-				{
-					/* 16x16 for 64x64 */
-					pPixels16 = pPixels32 + nIndex16For64[n16];
-					if(!nReversedAlpha)
-					{
-						Write8x8PixelsFor64(pPixels16, Pitch, &pAddress, MaskRGB);
-						Write8x8PixelsFor64(pPixels16+512, Pitch, &pAddress, MaskRGB);
-						Write8x8PixelsFor64(pPixels16+8, Pitch, &pAddress, MaskRGB);
-						Write8x8PixelsFor64(pPixels16+520, Pitch, &pAddress, MaskRGB);
-					}
-					else		/* reversed alpha   */
-					{
-						Write8x8For64ReversedAlpha(pPixels16, Pitch, &pAddress, AlphaMasks);
-						Write8x8For64ReversedAlpha(pPixels16+512, Pitch, &pAddress, AlphaMasks);
-						Write8x8For64ReversedAlpha(pPixels16+8, Pitch, &pAddress, AlphaMasks);
-						Write8x8For64ReversedAlpha(pPixels16+520, Pitch, &pAddress, AlphaMasks);
-					}
-				}
+				nTexTwiddleLanes = TexTwiddleSelect(SglReadPrivateProfileInt("Texture", "ConvertLanes",
+																			 TEXCONV_MAX_LANES, "sgl.ini"),
+													&pfnTexTwiddle);
 			}
-			break;
-		}
-		case  MIPMAP_LEVEL_7:
-		{
-			/* 128x128 */
-			for(n64=0; n64<4; n64++)
+			if(pConv != NULL)
 			{
-				/* 64x64 for 128x128 */
-				pPixels64 = pPixels + nIndex64For128[n64];
-				for(n32=0; n32<4; n32++)
+				/* convert a strip at a time on the way in */
+				if(!nReversedAlpha)
 				{
-					/* 32x32 for 128x128 */
-					pPixels32 = pPixels64 + nIndex32For128[n32];
-					for(n16=0; n16<4; n16++)
-					{
-						/* 16x16 for 128x128 */
-						pPixels16 = pPixels32 + nIndex16For128[n16];	
-						
-						if(!nReversedAlpha)
-						{
-							Write8x8PixelsFor128(pPixels16, &pAddress, MaskRGB);
-							Write8x8PixelsFor128(pPixels16+1024, &pAddress, MaskRGB);
-	    					pAddress += (Pitch-128) >> 1;
-							Write8x8PixelsFor128(pPixels16+8, &pAddress, MaskRGB);
-							Write8x8PixelsFor128(pPixels16+1032, &pAddress, MaskRGB);
-							pAddress += (Pitch-128) >> 1;
-						}
-						else		/* reversed alpha   */
-						{
-							Write8x8For128ReversedAlpha(pPixels16, &pAddress, AlphaMasks);
-							Write8x8For128ReversedAlpha(pPixels16+1024, &pAddress, AlphaMasks);
-	    					pAddress += (Pitch-128) >> 1;
-							Write8x8For128ReversedAlpha(pPixels16+8, &pAddress, AlphaMasks);
-							Write8x8For128ReversedAlpha(pPixels16+1032, &pAddress, AlphaMasks);
-							pAddress += (Pitch-128) >> 1;
-						}
-					}
+					TexConvTwiddle((TEXCONV_PIXEL32 *) pAddress, pPixels, Pitch,
+								   1 << (MapLevel - 1), pConv, pfnTexConv,
+								   pfnTexTwiddle, MaskRGB, 0);
 				}
-			}
-			break;
-		}		
-		case  MIPMAP_LEVEL_8:
-		{
-			/* 256x256 */
-			for(n128=0; n128<4; n128++)
-			{
-				/* 128x128 for 256x256 */
-				pPixels128 = pPixels + nIndex128For256[n128];
-				for(n64=0; n64<4; n64++)
+				else		/* reversed alpha   */
 				{
-					/* 64x64 for 256x256 */
-					pPixels64 = pPixels128 + nIndex64For256[n64];
-					for(n32=0; n32<4; n32++)
-					{
-						/* 32x32 for 256x256 */
-						pPixels32 = pPixels64 + nIndex32For256[n32];
-						for(n16=0; n16<4; n16++)
-						{
-							/* 16x16 for 256x256 */
-							pPixels16 = pPixels32 + nIndex16For256[n16];	
-						
-							if(!nReversedAlpha)		
-							{
-								Write8x8PixelsFor256(pPixels16, &pAddress, MaskRGB);
-								Write8x8PixelsFor256(pPixels16+2048, &pAddress, MaskRGB);
-								Write8x8PixelsFor256(pPixels16+8, &pAddress, MaskRGB);
-								Write8x8PixelsFor256(pPixels16+2056, &pAddress, MaskRGB);
-							}
-							else		/* reversed alpha   */
-							{
-								Write8x8For256ReversedAlpha(pPixels16, &pAddress, AlphaMasks);
-								Write8x8For256ReversedAlpha(pPixels16+2048, &pAddress, AlphaMasks);
-								Write8x8For256ReversedAlpha(pPixels16+8, &pAddress, AlphaMasks);
-								Write8x8For256ReversedAlpha(pPixels16+2056, &pAddress, AlphaMasks);
-							}
-	    					pAddress += (Pitch-256) >> 1;
-						}
-					}
+					TexConvTwiddle((TEXCONV_PIXEL32 *) pAddress, pPixels, Pitch,
+								   1 << (MapLevel - 1), pConv, pfnTexConv,
+								   pfnTexTwiddle, 0xFFFFFFFF, AlphaMasks);
 				}
 			}
+			else if(!nReversedAlpha)
+			{
+				pfnTexTwiddle((TEXCONV_PIXEL32 *) pAddress, pPixels, Pitch,
+							  1 << (MapLevel - 1), MaskRGB, 0);
+			}
+			else		/* reversed alpha   */
+			{
+				pfnTexTwiddle((TEXCONV_PIXEL32 *) pAddress, pPixels, Pitch,
+							  1 << (MapLevel - 1), 0xFFFFFFFF, AlphaMasks);
+			}
 			break;
 		}
 	}
 }	/* end of WriteTexture */
-#if 1
-	/*       c functions      */
-static void FourPairsPalettised(sgl_uint32 *pDst, sgl_uint8 *pSrc, int TexWidth, 
-						sgl_uint16 *pPalette, sgl_uint8 *pSrc2) 
-{
-	IW (pDst, 0, ( ( pPalette[*(pSrc)]<<16) | pPalette[*(pSrc2)] ));
-	IW (pDst, 1, ( ( pPalette[*(pSrc+1)]<<16) | pPalette[*(pSrc2+1)] ));
-	IW (pDst, 2, ( ( pPalette[*(pSrc+2*TexWidth)]<<16) | pPalette[*(pSrc2+2*TexWidth)] ));
-	IW (pDst, 3, ( ( pPalette[*(pSrc+2*TexWidth+1)]<<16) | pPalette[*(pSrc2+2*TexWidth+1)] ));
-		
-}		
-
-/******************************************************************************
- * Function Name: Write8x8PixelsPalettised   INTERNAL ONLY
- *
- * Inputs       : *pPixels, Pitch, *pAddress.
- *				  
- * Outputs      : None
- * Returns      : None
- * Globals Used : None
- *
- * Description  : Write 8x8 Pixels into texture memory for 8x8. 
- *
- *****************************************************************************/
-static void Write8x8PixelsPalettised(sgl_uint8  *pPixels, 
-				  	int			Pitch,
-				  	sgl_uint32  **pAddress,
-					sgl_uint16	*pPalette,
-					sgl_uint8  *pPixels2)
-{
-	int Pitch4 = Pitch << 2;
-	FourPairsPalettised((*pAddress), pPixels, Pitch, pPalette, pPixels2);
-	FourPairsPalettised(((*pAddress)+4), pPixels+2, Pitch, pPalette, pPixels2+2);
-	FourPairsPalettised(((*pAddress)+8), pPixels+Pitch4, Pitch, pPalette, pPixels2+Pitch4);
-	FourPairsPalettised(((*pAddress)+12), pPixels+Pitch4+2, Pitch, pPalette, pPixels2+Pitch4+2);
-	FourPairsPalettised(((*pAddress)+16), pPixels+4, Pitch, pPalette, pPixels2+4);
-	FourPairsPalettised(((*pAddress)+20), pPixels+6, Pitch, pPalette, pPixels2+6);
-	FourPairsPalettised(((*pAddress)+24), pPixels+Pitch4+4, Pitch, pPalette, pPixels2+Pitch4+4);
-	FourPairsPalettised(((*pAddress)+28), pPixels+Pitch4+6, Pitch, pPalette, pPixels2+Pitch4+6);
-	(*pAddress) += 32;
-}
-
-#else
-	/* assembler functions   */
-   	extern Write8x8PixelsPalettised(void *pSrc, int Pitch, void *pDst, 
-   									void *pPalette, void *pSrc2);
-#endif	
-
 /******************************************************************************
  * Function Name: WriteTexturePalettised    INTERNAL ONLY
  *
@@ -1198,14 +866,7 @@ static void Write8x8PixelsPalettised(sgl_uint8  *pPixels,
 					sgl_uint8		*pPixels,
 					sgl_uint16		*pPalette)
 { 
-	int n16, n32, n64, n128, num16, num32, num64, num128;
 	sgl_uint32 *pAddress;
-	sgl_uint8 *pPixels16, *pPixels32, *pPixels64, *pPixels128;
-
-	int nIndex128[4] = {0, 0, 128, 0};
-	int nIndex64[4] =  {0, 0,  64, 0};
-	int nIndex32[4] =  {0, 0,  32, 0};
-	int nIndex16[4] =  {0, 0,  16, 0};
 
 	pAddress = pBusBurstSpace + (DestAddress>>1);
 	switch(MapLevel)
@@ -1260,75 +921,15 @@ static void Write8x8PixelsPalettised(sgl_uint8  *pPixels,
 			break;
 		}
 	    case  MIPMAP_LEVEL_3:
-		{	
-			/* 8x8 */
-			Write8x8PixelsPalettised(pPixels, Pitch, &pAddress, pPalette, pPixels+Pitch);
-			break;
-		}
-		case  	MIPMAP_LEVEL_4:
-		case	MIPMAP_LEVEL_5:
-		case	MIPMAP_LEVEL_6:
-		case	MIPMAP_LEVEL_7:
-		case	MIPMAP_LEVEL_8:
+		case  MIPMAP_LEVEL_4:
+		case  MIPMAP_LEVEL_5:
+		case  MIPMAP_LEVEL_6:
+		case  MIPMAP_LEVEL_7:
+		case  MIPMAP_LEVEL_8:
 		{
-			int Pitch8 = Pitch << 3;
-			nIndex16[1] = Pitch << 4;
-			nIndex16[3] = nIndex16[1] + 16;
-			nIndex32[1] = Pitch << 5;
-			nIndex32[3] = nIndex32[1] + 32;
-			nIndex64[1] = Pitch << 6;
-			nIndex64[3] = nIndex64[1] + 64;
-			nIndex128[1] = Pitch << 7;
-			nIndex128[3] = nIndex128[1] + 128;
-			
-			num128 = num64 = num32 = num16 = 4;
-		  
-		  	if(MapLevel < MIPMAP_LEVEL_8) 
-			{
-				num128 = 1;
-				if(MapLevel < MIPMAP_LEVEL_7) 
-				{
-					num64 = 1;
-					if(MapLevel < MIPMAP_LEVEL_6) 
-					{
-						num32 = 1;
-						if(MapLevel < MIPMAP_LEVEL_5) 
-						{
-							num16 = 1;
-						}
-					}
-				}
-			}
-			
-			for(n128=0; n128<num128; n128++)
-			{
-				/* write 128x128 pixels */
-				pPixels128 = pPixels + nIndex128[n128];		
-				for(n64=0; n64<num64; n64++)
-				{
-					/* write 64x64 pixels */
-					pPixels64 = pPixels128 + nIndex64[n64];
-					for(n32=0; n32<num32; n32++)
-					{
-						/* write 32x32 pixels */
-						pPixels32 = pPixels64 + nIndex32[n32];
-						for(n16=0; n16<num16; n16++)
-						{
-							/* write 16x16 pixels */
-							pPixels16 = pPixels32 + nIndex16[n16];	
-						
-							Write8x8PixelsPalettised(pPixels16, Pitch, &pAddress, pPalette,
-												 pPixels16+Pitch);
-							Write8x8PixelsPalettised(pPixels16+Pitch8, Pitch, &pAddress, pPalette,
-												 pPixels16+Pitch+Pitch8);
-							Write8x8PixelsPalettised(pPixels16+8, Pitch, &pAddress, pPalette,
-												 pPixels16+Pitch+8);
-							Write8x8PixelsPalettised(pPixels16+Pitch8+8, Pitch, &pAddress, pPalette,
-												 pPixels16+Pitch+Pitch8+8);
-						}
-					}
-				}
-			}
+			/* 8x8 to 256x256 */
+			TexTwiddlePalettised((TEXCONV_PIXEL32 *) pAddress, pPixels, Pitch,
+								 1 << (MapLevel - 1), pPalette);
 			break;
 		}
 	}
@@ -1338,7 +939,7 @@ static void Write8x8PixelsPalettised(sgl_uint8  *pPixels,
  * Function Name: WriteTextureToMem    INTERNAL ONLY
  *
  * Inputs       : TextureAddress, MapSize, MapLevel, nReversedAlpha 
- *                Pitch, *pPixels.
+ *                Pitch, *pPixels, pConv (see WriteTexture).
  *
  * Outputs      : None
  *
@@ -1358,7 +959,8 @@ static void WriteTextureToMem(	sgl_uint32		TextureAddress,
 						int 			nPalettised,
 						sgl_uint16		*pPalette,
 						sgl_uint32		AlphaMasks,
-						sgl_uint32 		MaskRGB)
+						sgl_uint32 		MaskRGB,
+						const TEXCONV	*pConv)
 { 
 	ASSERT(MapLevel >= NON_MIPMAPED);
 	ASSERT(MapLevel <= MIPMAP_LEVEL_8);
@@ -1377,7 +979,8 @@ static void WriteTextureToMem(	sgl_uint32		TextureAddress,
 		{	
 		 	/*  write translucent textures  */
 		 	WriteTexture(TextureAddress, pBusBurstSpace, MapSize, Pitch, 
-		 						(sgl_uint16 *)pPixels, nReversedAlpha, AlphaMasks, MaskRGB);
+		 						(sgl_uint16 *)pPixels, nReversedAlpha, AlphaMasks, MaskRGB,
+								pConv);
 		}
 	}
 	else
@@ -1402,7 +1005,8 @@ static void WriteTextureToMem(	sgl_uint32		TextureAddress,
 		{
 		 	/*  write translucent textures  */
 		 	WriteTexture(DestAddress, pBusBurstSpace, MapLevel, Pitch, 
-									(sgl_uint16 *)pPixels, nReversedAlpha, AlphaMasks, MaskRGB);
+									(sgl_uint16 *)pPixels, nReversedAlpha, AlphaMasks, MaskRGB,
+									pConv);
 		}
 	}
 }  /* end of WriteTextureToMem */	
@@ -2099,6 +1703,195 @@ static void ConvertUnknownTextureFormats( int nMapSize,
 	}
 }
 
+/******************************************************************************
+ * Function Name: GetTexConv   INTERNAL ONLY
+ *
+ * Inputs       : nEnumType, pSFormat, nColourKey, KeyColour, nTrans1555.
+ *				  
+ * Outputs      : pConv
+ * Returns      : TRUE if the conversion can be done by the texconv.c kernels
+ * Globals Used : None
+ *
+ * Description  : Describes the conversion done by Convert555WithColourKey,
+ *				  ConvertTextureFormats16, ConvertTextureFormats32 or
+ *				  ConvertUnknownTextureFormats for the same arguments, as
+ *				  fields to mask and shift (see texconv.h). The one
+ *				  conversion it can't describe is unknown formats with less
+ *				  than 4 bits of alpha, which have the alpha replicated.
+ *
+ *****************************************************************************/
+static sgl_bool GetTexConv(TEXCONV *pConv, int nEnumType, PTEXTUREFORMAT pSFormat,
+							int nColourKey, sgl_uint32 KeyColour, int nTrans1555)
+{
+	int nAlphaLeftShift, nAlphaRightShift, nRedLeftShift, nRedRightShift,
+		nGreenLeftShift, nGreenRightShift, nBlueLeftShift, nBlueRightShift;
+	sgl_uint32 RedMask, GreenMask, BlueMask, AlphaMask;
+
+	switch(nEnumType)
+	{
+		case 1:
+		{
+			/* 555 with colour key to 4444, or to 1555 for PCX2_003 */
+			TexConvInit(pConv, 16);
+			if(!nTrans1555)
+			{
+				TexConvAddField(pConv, 0x7800, 3, 0);	/*R*/
+				TexConvAddField(pConv, 0x03C0, 2, 0);	/*G*/
+				TexConvAddField(pConv, 0x001E, 1, 0);	/*B*/
+				TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0xF000);
+			}
+			else
+			{
+				TexConvAddField(pConv, 0xFFFF, 0, 0);
+				TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0x8000);
+			}
+			return (TRUE);
+		}
+		case 3:
+		{
+			/* 1555 to 4444 */
+			TexConvInit(pConv, 16);
+			TexConvAddField(pConv, 0x7800, 3, 0);	/*R*/
+			TexConvAddField(pConv, 0x03C0, 2, 0);	/*G*/
+			TexConvAddField(pConv, 0x001E, 1, 0);	/*B*/
+			TexConvSetTest(pConv, 0x8000, 0x8000, 0xF000);
+			return (TRUE);
+		}
+		case 4:
+		{
+			TexConvInit(pConv, 16);
+			if(!nColourKey || nTrans1555)
+			{
+				/* 565 to 555, with the colour key to 1555 for PCX2_003 */
+				TexConvAddField(pConv, 0xFFC0, 1, 0);	/*R* and *G*/
+				TexConvAddField(pConv, 0x001F, 0, 0);	/*B*/
+				if(nColourKey)
+				{
+					TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0x8000);
+				}
+			}
+			else
+			{
+				/* 565 with colour key to 4444 */
+				TexConvAddField(pConv, 0xF000, 4, 0);	/*R*/
+				TexConvAddField(pConv, 0x0780, 3, 0);	/*G*/
+				TexConvAddField(pConv, 0x001E, 1, 0);	/*B*/
+				TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0xF000);
+			}
+			return (TRUE);
+		}
+		case 5:
+		case 6:
+		{
+			TexConvInit(pConv, 32);
+			if((nEnumType == 5) || (nColourKey && nTrans1555))
+			{
+				/* 888 or 8888(ARGB) to 555, with the colour key to 1555 for PCX2_003 */
+				TexConvAddField(pConv, 0x00F80000, 9, 0);
+				TexConvAddField(pConv, 0x0000F800, 6, 0);
+				TexConvAddField(pConv, 0x000000F8, 3, 0);
+				if((nEnumType == 6) && nColourKey)
+				{
+					TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0x8000);
+				}
+			}
+			else
+			{
+				/* 8888(ARGB) to 4444, or 888(ARGB) to 4444 with colour key */
+				if(!nColourKey)
+				{
+					TexConvAddField(pConv, 0xF0000000, 16, 0);
+				}
+				TexConvAddField(pConv, 0x00F00000, 12, 0);
+				TexConvAddField(pConv, 0x0000F000, 8, 0);
+				TexConvAddField(pConv, 0x000000F0, 4, 0);
+				if(nColourKey)
+				{
+					TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0xF000);
+				}
+			}
+			return (TRUE);
+		}
+		case 7:
+		case 8:
+		{
+			TexConvInit(pConv, 32);
+			if((nEnumType == 7) || (nColourKey && nTrans1555))
+			{
+				/* 888 or 8888(ABGR) to 555, with the colour key to 1555 for PCX2_003 */
+				TexConvAddField(pConv, 0x00F80000, 19, 0);	/*B*/
+				TexConvAddField(pConv, 0x0000F800, 6, 0);	/*G*/
+				TexConvAddField(pConv, 0x000000F8, 0, 7);	/*R*/
+				if((nEnumType == 8) && nColourKey)
+				{
+					TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0x8000);
+				}
+			}
+			else
+			{
+				/* 8888(ABGR) to 4444, or 888(ABGR) to 4444 with colour key */
+				if(!nColourKey)
+				{
+					TexConvAddField(pConv, 0xF0000000, 16, 0);	/*A*/
+				}
+				TexConvAddField(pConv, 0x00F00000, 20, 0);	/*B*/
+				TexConvAddField(pConv, 0x0000F000, 8, 0);	/*G*/
+				TexConvAddField(pConv, 0x000000F0, 0, 4);	/*R*/
+				if(nColourKey)
+				{
+					TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0xF000);
+				}
+			}
+			return (TRUE);
+		}
+	}
+
+	/* Unknown formats, as ConvertUnknownTextureFormats */
+	TexConvInit(pConv, (pSFormat->BitDepth == 16) ? 16 : 32);
+
+	RedMask = pSFormat->rgbyuv.rgb.RedMask;
+	GreenMask = pSFormat->rgbyuv.rgb.GreenMask;
+	BlueMask = pSFormat->rgbyuv.rgb.BlueMask;
+	AlphaMask = pSFormat->AlphaMask;
+
+	if(!AlphaMask || (nColourKey && nTrans1555))
+	{
+		/* R G B in 555 */
+		GetShiftValues(&nBlueLeftShift, &nBlueRightShift, 0, 5, BlueMask);
+		GetShiftValues(&nGreenLeftShift, &nGreenRightShift, 5, 5, GreenMask);
+		GetShiftValues(&nRedLeftShift, &nRedRightShift, 10, 5, RedMask);
+		if(AlphaMask)
+		{
+			TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0x8000);
+		}
+	}
+	else
+	{
+		/* R G B in 4444, with A or the colour key */
+		GetShiftValues(&nBlueLeftShift, &nBlueRightShift, 0, 4, BlueMask);
+		GetShiftValues(&nGreenLeftShift, &nGreenRightShift, 4, 4, GreenMask);
+		GetShiftValues(&nRedLeftShift, &nRedRightShift, 8, 4, RedMask);
+		if(nColourKey)
+		{
+			TexConvSetTest(pConv, 0xFFFFFFFF, KeyColour, 0xF000);
+		}
+		else
+		{
+			GetShiftValues(&nAlphaLeftShift, &nAlphaRightShift, 12, 4, AlphaMask);
+			/* Less than 4 bits of alpha are replicated */
+			if((nAlphaLeftShift > 12) ||
+			   !TexConvAddField(pConv, AlphaMask, nAlphaRightShift, nAlphaLeftShift))
+			{
+				return (FALSE);
+			}
+		}
+	}
+
+	return (TexConvAddField(pConv, RedMask, nRedRightShift, nRedLeftShift) &&
+			TexConvAddField(pConv, GreenMask, nGreenRightShift, nGreenLeftShift) &&
+			TexConvAddField(pConv, BlueMask, nBlueRightShift, nBlueLeftShift));
+}
+
 /******************************************************************************
  * Function Name: TextureLoad
  *
@@ -2208,7 +2001,7 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 						  pSource->pPixels,
 						  nReversedAlpha,
 						  nPalettised,
-						  Palette, AlphaMasks, MaskRGB);
+						  Palette, AlphaMasks, MaskRGB, NULL);
 
 		SynchroniseTexMemAccess (hTexHeap, FALSE);
 		return(PVROS_GROOVY);	
@@ -2245,7 +2038,7 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 	if(pSFormat->Flags & TF_HWSUPPORT) 
 	{
 		/* the source is either 555 or 4444 */
-		if(pSFormat->Flags == pTFormat->Flags)
+		if((pSFormat->Flags & ~TF_MOVABLE) == pTFormat->Flags)
 		{
 			if((pSFormat->BitDepth != pTFormat->BitDepth) ||
 				(pSFormat->rgbyuv.rgb.RedMask != pTFormat->rgbyuv.rgb.RedMask) ||
@@ -2454,15 +2247,63 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 	{
 		int nMapSize, nMapWidth;
 		sgl_uint16 *pDestPixels;
+		TEXCONV TexConv;
 		nMapWidth = 1 << (map_size - 1);
 		nMapSize = nMapWidth*nMapWidth;
+		/* pick the conversion kernel the first time through */
+		if(nTexConvLanes == 0)
+		{
+			nTexConvLanes = TexConvSelect(SglReadPrivateProfileInt("Texture", "ConvertLanes",
+																	TEXCONV_MAX_LANES, "sgl.ini"),
+										  &pfnTexConv);
+		}
+		if(nEnumType >= 9)
+		{
+			if((pSFormat->Flags & TF_OGLALPHA) != (pTFormat->Flags & TF_OGLALPHA)
+				&& (pTFormat->Flags & TF_TRANSLUCENT))
+			{
+				nReversedAlpha = 1;	    
+			}
+		}
+		/* 
+		// Use the vector kernels if there are any. Without them, the
+		// assembler functions below are as quick as the scalar kernel.
+		// Maps of 8x8 and up are converted as they are twiddled into
+		// texture memory, without converting the whole map first.
+		*/
+		if((nTexConvLanes > 1) && (nMapWidth >= TEXTWIDDLE_MIN_WIDTH) &&
+		   GetTexConv(&TexConv, nEnumType, pSFormat, nColourKey, KeyColour, nTrans1555))
+		{
+			/* turn off reversed alpha for colour key */
+			if(nColourKey)	 nReversedAlpha = 0;   
+
+			SynchroniseTexMemAccess (hTexHeap, TRUE);
+
+			WriteTextureToMem(TextureAddress,
+							  (sgl_uint32 *)(hTexHeap->pTextureMemory),
+							  map_size,
+							  DestinationMap,
+							  nMapWidth,
+							  pSource->pPixels,
+							  nReversedAlpha,
+							  nPalettised,
+							  pSource->pPalette, AlphaMasks, MaskRGB, &TexConv);
+
+			SynchroniseTexMemAccess (hTexHeap, FALSE);
+			return(PVROS_GROOVY);
+		}
 		pDestPixels = PVROSMalloc(nMapSize*sizeof(sgl_uint16));
 		if(pDestPixels == NULL)
 		{
 			PVROSPrintf("TAPI: Out of Memory.\n");
 			return (PVROS_DODGY);
 		}
-		if(nEnumType == 1 && nColourKey)
+		if((nTexConvLanes > 1) &&
+		   GetTexConv(&TexConv, nEnumType, pSFormat, nColourKey, KeyColour, nTrans1555))
+		{
+			pfnTexConv(&TexConv, pSource->pPixels, pDestPixels, nMapSize);
+		}
+		else if(nEnumType == 1 && nColourKey)
 		{
 			Convert555WithColourKey(nMapSize, &pDestPixels,
 									pSource->pPixels, nColourKey, KeyColour, nTrans1555);
@@ -2476,22 +2317,14 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 		{
 			ConvertTextureFormats32(nMapSize, nEnumType, &pDestPixels,
 									pSource->pPixels, nColourKey, KeyColour, nTrans1555);
-			Pitch = Pitch >> 1;
 		}
 		else
 		{
-			if((pSFormat->Flags & TF_OGLALPHA) != (pTFormat->Flags & TF_OGLALPHA)
-				&& (pTFormat->Flags & TF_TRANSLUCENT))
-			{
-				nReversedAlpha = 1;	    
-			}
 			ConvertUnknownTextureFormats(nMapSize, &pDestPixels,
 											pSource, nColourKey, KeyColour, nTrans1555);
-			if(pSFormat->BitDepth == 32)
-			{
-				Pitch = Pitch >> 1;
-			}
 		}
+		/* the converted map has no gaps between rows */
+		Pitch = nMapWidth;
 		/* turn off reversed alpha for colour key */
 		if(nColourKey)	 nReversedAlpha = 0;   
 		
@@ -2509,7 +2342,7 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 						  pDestPixels, 
 						  nReversedAlpha,
 						  nPalettised,
-						  pSource->pPalette, AlphaMasks, MaskRGB);
+						  pSource->pPalette, AlphaMasks, MaskRGB, NULL);
 		PVROSFree(pDestPixels);	
 		SynchroniseTexMemAccess (hTexHeap, FALSE);
 	}
@@ -2525,7 +2358,7 @@ PVROSERR CALL_CONV TextureLoad (	HTEXHEAP hTexHeap,
 						  pSource->pPixels,
 						  nReversedAlpha,
 						  nPalettised,
-						  pSource->pPalette, AlphaMasks, MaskRGB);
+						  pSource->pPalette, AlphaMasks, MaskRGB, NULL);
 
 		SynchroniseTexMemAccess (hTexHeap, FALSE);
 	}
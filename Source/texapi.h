@@ -93,6 +93,7 @@
 #define TF_HWSUPPORT 	0x00080000  /* for hardware support */
 #define TF_OGLALPHA 	0x00100000  /* for alpha conversion */
 #define TF_COLOURKEY 	0x00200000  /* set for using colour key */
+#define TF_MOVABLE	 	0x00400000  /* TextureCompact may move it; creation only */
 
 typedef sgl_uint32 PVRFOURCC;
 
@@ -160,6 +161,7 @@ typedef struct
   HDEVICE 		hDeviceID;
   DEVICE_TYPE	DeviceType;
   unsigned int  uTexCount;
+  void  		*pFreeIndex;	/* TMALLOC_INDEX */
 	
 } TEXTUREHEAP, *HTEXHEAP; /* handle to texture heap */
 
@@ -238,6 +240,12 @@ typedef struct TEXAPI_IF
 						sgl_texture_mem_info *pInfo 
 					);
 
+	sgl_uint32 	(CALL_CONV *pfnTextureCompact)
+					(
+						HTEXHEAP hTexHeap,
+						sgl_uint32 MaxBytes
+					);
+
 } TEXAPI_IF, *PTEXAPI_IF;
 
 #endif
@@ -62,4 +62,6 @@ PVROSERR 	CALL_CONV AutoMipmap ( HTEXHEAP hTexHeap,
 									
 sgl_uint32 	CALL_CONV TextureFree (HTEXHEAP hTexHeap, HTEXTURE hTex);
 
+sgl_uint32 	CALL_CONV TextureCompact (HTEXHEAP hTexHeap, sgl_uint32 MaxBytes);
+
 #endif
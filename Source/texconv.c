@@ -0,0 +1,803 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: texconv.c,v $
+Title           :   Vector texture format conversion
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Scalar, SSE2, AVX2 and NEON versions of the pixel
+					conversions done by TextureLoad, and scalar, SSE2 and
+					NEON versions of the twiddled writes. See texconv.h.
+
+					16 bit sources are worked on in 16 bit lanes. 32 bit
+					sources are worked on in 32 bit lanes and narrowed to
+					16 bits at the end, two vectors at a time. With gcc
+					(and clang) on x86 every kernel is built whatever the
+					-m flags say, using the target attribute, and the CPU
+					is asked at run time which ones it can run. Other
+					compilers only get the kernels their own flags allow.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: texconv.c,v $
+
+;--
+*****************************************************************************/
+
+#define MODULE_ID MODID_TEXCONV
+
+/* Just the types, so tools/texbench can build this file on its own */
+#include "sgl.h"
+#include "texconv.h"
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+	#define TEXCONV_GCC_X86		1
+#else
+	#define TEXCONV_GCC_X86		0
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define TEXCONV_SSE2		1
+	#define TEXCONV_HAS_SSE2	TRUE
+#elif TEXCONV_GCC_X86
+	#define TEXCONV_SSE2		1
+	#define TEXCONV_HAS_SSE2	__builtin_cpu_supports ("sse2")
+#else
+	#define TEXCONV_SSE2		0
+#endif
+
+#if defined (__AVX2__)
+	#define TEXCONV_AVX2		1
+	#define TEXCONV_HAS_AVX2	TRUE
+#elif TEXCONV_GCC_X86
+	#define TEXCONV_AVX2		1
+	#define TEXCONV_HAS_AVX2	__builtin_cpu_supports ("avx2")
+#else
+	#define TEXCONV_AVX2		0
+#endif
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+	#define TEXCONV_NEON		1
+#else
+	#define TEXCONV_NEON		0
+#endif
+
+/*
+// ============================================================================
+// 								SET UP
+// ============================================================================
+*/
+
+void TexConvInit (TEXCONV *pConv, int nSrcBits)
+{
+	pConv->nSrcBits = nSrcBits;
+	pConv->nFields = 0;
+
+	pConv->TestMask = 0;
+	pConv->TestValue = 0;
+	pConv->TestSet = 0;
+}
+
+sgl_bool TexConvAddField (TEXCONV *pConv, sgl_uint32 Mask,
+						  int nRightShift, int nLeftShift)
+{
+	int k = pConv->nFields;
+
+	if ((k == TEXCONV_MAX_FIELDS) ||
+		(nRightShift < 0) || (nRightShift > 31) ||
+		(nLeftShift < 0) || (nLeftShift > 31))
+	{
+		return (FALSE);
+	}
+
+	/* A 16 bit source has nothing above bit 15 to mask */
+	if (pConv->nSrcBits == 16)
+	{
+		Mask &= 0xFFFF;
+	}
+
+	pConv->Mask[k] = Mask;
+	pConv->RightShift[k] = nRightShift;
+	pConv->LeftShift[k] = nLeftShift;
+	pConv->nFields = k + 1;
+
+	return (TRUE);
+}
+
+void TexConvSetTest (TEXCONV *pConv, sgl_uint32 TestMask,
+					 sgl_uint32 TestValue, sgl_uint16 TestSet)
+{
+	if (pConv->nSrcBits == 16)
+	{
+		TestMask &= 0xFFFF;
+	}
+
+	/*
+	// A value with bits outside the mask (a 32 bit colour key on a 16
+	// bit texture, say) never matches, so there is no test.
+	*/
+	if (TestValue & ~TestMask)
+	{
+		TestSet = 0;
+	}
+
+	pConv->TestMask = TestMask;
+	pConv->TestValue = TestValue;
+	pConv->TestSet = TestSet;
+}
+
+/*
+// ============================================================================
+// 								SCALAR
+// ============================================================================
+*/
+
+void TexConvScalar (const TEXCONV *pConv, const void *pSrc,
+					sgl_uint16 *pDst, int nPixels)
+{
+	const sgl_uint16	*pSrc16 = (const sgl_uint16 *) pSrc;
+	const TEXCONV_PIXEL32	*pSrc32 = (const TEXCONV_PIXEL32 *) pSrc;
+	sgl_uint32			Src, Out;
+	int					i, k;
+
+	for (i = 0; i < nPixels; i++)
+	{
+		Src = (pConv->nSrcBits == 16) ? (sgl_uint32) pSrc16[i] : pSrc32[i];
+		Out = 0;
+
+		for (k = 0; k < pConv->nFields; k++)
+		{
+			Out |= ((Src & pConv->Mask[k]) >> pConv->RightShift[k]) << pConv->LeftShift[k];
+		}
+
+		if ((Src & pConv->TestMask) == pConv->TestValue)
+		{
+			Out |= pConv->TestSet;
+		}
+
+		pDst[i] = (sgl_uint16) Out;
+	}
+}
+
+/*
+// ============================================================================
+// 								TWIDDLING
+// ============================================================================
+*/
+
+/*
+// The even bits of a byte, packed into the bottom 4 bits. Twiddled word
+// indices split into x (the even bits) and y / 2 (the odd bits) with it.
+*/
+static const sgl_uint8 EvenBits[256] =
+{
+	 0,  1,  0,  1,  2,  3,  2,  3,  0,  1,  0,  1,  2,  3,  2,  3,
+	 4,  5,  4,  5,  6,  7,  6,  7,  4,  5,  4,  5,  6,  7,  6,  7,
+	 0,  1,  0,  1,  2,  3,  2,  3,  0,  1,  0,  1,  2,  3,  2,  3,
+	 4,  5,  4,  5,  6,  7,  6,  7,  4,  5,  4,  5,  6,  7,  6,  7,
+	 8,  9,  8,  9, 10, 11, 10, 11,  8,  9,  8,  9, 10, 11, 10, 11,
+	12, 13, 12, 13, 14, 15, 14, 15, 12, 13, 12, 13, 14, 15, 14, 15,
+	 8,  9,  8,  9, 10, 11, 10, 11,  8,  9,  8,  9, 10, 11, 10, 11,
+	12, 13, 12, 13, 14, 15, 14, 15, 12, 13, 12, 13, 14, 15, 14, 15,
+	 0,  1,  0,  1,  2,  3,  2,  3,  0,  1,  0,  1,  2,  3,  2,  3,
+	 4,  5,  4,  5,  6,  7,  6,  7,  4,  5,  4,  5,  6,  7,  6,  7,
+	 0,  1,  0,  1,  2,  3,  2,  3,  0,  1,  0,  1,  2,  3,  2,  3,
+	 4,  5,  4,  5,  6,  7,  6,  7,  4,  5,  4,  5,  6,  7,  6,  7,
+	 8,  9,  8,  9, 10, 11, 10, 11,  8,  9,  8,  9, 10, 11, 10, 11,
+	12, 13, 12, 13, 14, 15, 14, 15, 12, 13, 12, 13, 14, 15, 14, 15,
+	 8,  9,  8,  9, 10, 11, 10, 11,  8,  9,  8,  9, 10, 11, 10, 11,
+	12, 13, 12, 13, 14, 15, 14, 15, 12, 13, 12, 13, 14, 15, 14, 15
+};
+
+/* Enough for the 10 bit block numbers of a 256 by 256 map */
+#define EVEN_BITS(n)		(EvenBits[(n) & 0xFF] | (EvenBits[((n) >> 8) & 0xFF] << 4))
+
+/*
+// The maps are written an 8x8 block (32 words) at a time. Block b's
+// number is the word index of its first word shifted down 5, so its top
+// left pixel is at
+*/
+#define BLOCK_COLUMN(b)		(EVEN_BITS ((b) >> 1) << 3)
+#define BLOCK_ROW(b)		(EVEN_BITS (b) << 3)
+
+/*
+// ... and the pixels of word w within the block are BLOCK_WORD_ROW rows
+// down and BLOCK_WORD_COLUMN columns across from there
+*/
+#define BLOCK_WORD_COLUMN(w)	EvenBits[w]
+#define BLOCK_WORD_ROW(w)		(EvenBits[(w) >> 1] << 1)
+
+void TexTwiddleScalar (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+					   int nPitch, int nWidth,
+					   sgl_uint32 AndMask, sgl_uint32 XorMask)
+{
+	int	nOffset[32];
+	int	nBlocks = (nWidth * nWidth) >> 6;
+	int	b, w;
+
+	for (w = 0; w < 32; w++)
+	{
+		nOffset[w] = BLOCK_WORD_ROW (w) * nPitch + BLOCK_WORD_COLUMN (w);
+	}
+
+	for (b = 0; b < nBlocks; b++, pDst += 32)
+	{
+		const sgl_uint16 *pBlock = pSrc + BLOCK_ROW (b) * nPitch + BLOCK_COLUMN (b);
+
+		for (w = 0; w < 32; w++)
+		{
+			const sgl_uint16 *pPixel = pBlock + nOffset[w];
+
+			pDst[w] = ((((TEXCONV_PIXEL32) pPixel[0] << 16) | pPixel[nPitch]) & AndMask) ^ XorMask;
+		}
+	}
+}
+
+void TexTwiddlePalettised (TEXCONV_PIXEL32 *pDst, const sgl_uint8 *pSrc,
+						   int nPitch, int nWidth, const sgl_uint16 *pPalette)
+{
+	int	nOffset[32];
+	int	nBlocks = (nWidth * nWidth) >> 6;
+	int	b, w;
+
+	for (w = 0; w < 32; w++)
+	{
+		nOffset[w] = BLOCK_WORD_ROW (w) * nPitch + BLOCK_WORD_COLUMN (w);
+	}
+
+	for (b = 0; b < nBlocks; b++, pDst += 32)
+	{
+		const sgl_uint8 *pBlock = pSrc + BLOCK_ROW (b) * nPitch + BLOCK_COLUMN (b);
+
+		for (w = 0; w < 32; w++)
+		{
+			const sgl_uint8 *pPixel = pBlock + nOffset[w];
+
+			pDst[w] = ((TEXCONV_PIXEL32) pPalette[pPixel[0]] << 16) | pPalette[pPixel[nPitch]];
+		}
+	}
+}
+
+/*
+// Where block (bx, by) goes: the inverse of BLOCK_COLUMN and BLOCK_ROW.
+// A 256 by 256 map is 32 blocks across, so 5 bits of each.
+*/
+static int SpreadBits (int n)
+{
+	int	Spread = 0;
+	int	i;
+
+	for (i = 0; i < 5; i++)
+	{
+		Spread |= ((n >> i) & 1) << (2 * i);
+	}
+
+	return (Spread);
+}
+
+#define BLOCK_NUMBER(bx, by)	((SpreadBits (bx) << 1) | SpreadBits (by))
+
+/* Widest map, and so the longest strip row */
+#define STRIP_WIDTH		256
+
+void TexConvTwiddle (TEXCONV_PIXEL32 *pDst, const void *pSrc,
+					 int nPitch, int nWidth,
+					 const TEXCONV *pConv, TEXCONVFN pfnConvert,
+					 TEXTWIDDLEFN pfnTwiddle,
+					 sgl_uint32 AndMask, sgl_uint32 XorMask)
+{
+	sgl_uint16		Strip[8 * STRIP_WIDTH];
+	const sgl_uint8	*pRow = (const sgl_uint8 *) pSrc;
+	int				nRowBytes = nPitch * (pConv->nSrcBits >> 3);
+	int				nBlocks = nWidth >> 3;
+	int				bx, by, r;
+
+	for (by = 0; by < nBlocks; by++)
+	{
+		/*
+		// Convert the strip's eight rows, in one go if there are no gaps
+		// between them
+		*/
+		if (nPitch == nWidth)
+		{
+			pfnConvert (pConv, pRow, Strip, 8 * nWidth);
+			pRow += 8 * nRowBytes;
+		}
+		else
+		{
+			for (r = 0; r < 8; r++, pRow += nRowBytes)
+			{
+				pfnConvert (pConv, pRow, Strip + r * nWidth, nWidth);
+			}
+		}
+
+		/* then twiddle each of its blocks into place */
+		for (bx = 0; bx < nBlocks; bx++)
+		{
+			pfnTwiddle (pDst + (BLOCK_NUMBER (bx, by) << 5), Strip + (bx << 3),
+						nWidth, 8, AndMask, XorMask);
+		}
+	}
+}
+
+/*
+// ============================================================================
+// 								SSE2 (8 PIXELS)
+// ============================================================================
+*/
+
+#if TEXCONV_SSE2
+
+#include <emmintrin.h>
+
+#if defined (__SSE2__) || !TEXCONV_GCC_X86
+	#define TEXCONV_TARGET
+#else
+	#define TEXCONV_TARGET		__attribute__ ((target ("sse2")))
+#endif
+
+/*
+// The fields and test of a conversion, for four 32 bit source pixels
+*/
+static TEXCONV_TARGET __m128i Conv32SSE2 (const TEXCONV *pConv, __m128i Src)
+{
+	__m128i	Out = _mm_setzero_si128 ();
+	int		k;
+
+	for (k = 0; k < pConv->nFields; k++)
+	{
+		__m128i Field = _mm_and_si128 (Src, _mm_set1_epi32 ((int) pConv->Mask[k]));
+
+		Field = _mm_srl_epi32 (Field, _mm_cvtsi32_si128 (pConv->RightShift[k]));
+		Out = _mm_or_si128 (Out, _mm_sll_epi32 (Field, _mm_cvtsi32_si128 (pConv->LeftShift[k])));
+	}
+
+	if (pConv->TestSet)
+	{
+		__m128i Match = _mm_cmpeq_epi32 (_mm_and_si128 (Src, _mm_set1_epi32 ((int) pConv->TestMask)),
+										 _mm_set1_epi32 ((int) pConv->TestValue));
+
+		Out = _mm_or_si128 (Out, _mm_and_si128 (Match, _mm_set1_epi32 (pConv->TestSet)));
+	}
+
+	/* Sign extend the low halves so the saturating pack keeps them as is */
+	return (_mm_srai_epi32 (_mm_slli_epi32 (Out, 16), 16));
+}
+
+static TEXCONV_TARGET void TexConvSSE2 (const TEXCONV *pConv, const void *pSrc,
+										sgl_uint16 *pDst, int nPixels)
+{
+	int		i = 0, k;
+
+	if (pConv->nSrcBits == 16)
+	{
+		const sgl_uint16	*pSrc16 = (const sgl_uint16 *) pSrc;
+		__m128i				Mask[TEXCONV_MAX_FIELDS];
+		__m128i				Right[TEXCONV_MAX_FIELDS];
+		__m128i				Left[TEXCONV_MAX_FIELDS];
+		__m128i				TestMask, TestValue, TestSet;
+
+		for (k = 0; k < pConv->nFields; k++)
+		{
+			Mask[k] = _mm_set1_epi16 ((short) pConv->Mask[k]);
+			Right[k] = _mm_cvtsi32_si128 (pConv->RightShift[k]);
+			Left[k] = _mm_cvtsi32_si128 (pConv->LeftShift[k]);
+		}
+
+		TestMask = _mm_set1_epi16 ((short) pConv->TestMask);
+		TestValue = _mm_set1_epi16 ((short) pConv->TestValue);
+		TestSet = _mm_set1_epi16 ((short) pConv->TestSet);
+
+		for (/* Nothing */; i + 8 <= nPixels; i += 8)
+		{
+			__m128i Src = _mm_loadu_si128 ((const __m128i *) (pSrc16 + i));
+			__m128i Out = _mm_setzero_si128 ();
+
+			for (k = 0; k < pConv->nFields; k++)
+			{
+				__m128i Field = _mm_srl_epi16 (_mm_and_si128 (Src, Mask[k]), Right[k]);
+
+				Out = _mm_or_si128 (Out, _mm_sll_epi16 (Field, Left[k]));
+			}
+
+			Out = _mm_or_si128 (Out, _mm_and_si128 (TestSet,
+							_mm_cmpeq_epi16 (_mm_and_si128 (Src, TestMask), TestValue)));
+
+			_mm_storeu_si128 ((__m128i *) (pDst + i), Out);
+		}
+
+		TexConvScalar (pConv, pSrc16 + i, pDst + i, nPixels - i);
+	}
+	else
+	{
+		const TEXCONV_PIXEL32	*pSrc32 = (const TEXCONV_PIXEL32 *) pSrc;
+
+		for (/* Nothing */; i + 8 <= nPixels; i += 8)
+		{
+			__m128i Lo = Conv32SSE2 (pConv, _mm_loadu_si128 ((const __m128i *) (pSrc32 + i)));
+			__m128i Hi = Conv32SSE2 (pConv, _mm_loadu_si128 ((const __m128i *) (pSrc32 + i + 4)));
+
+			_mm_storeu_si128 ((__m128i *) (pDst + i), _mm_packs_epi32 (Lo, Hi));
+		}
+
+		TexConvScalar (pConv, pSrc32 + i, pDst + i, nPixels - i);
+	}
+}
+
+/*
+// Twiddles an 8x8 block four rows at a time. Interleaving two rows gives
+// the words for their eight columns in order; the words for columns 0
+// and 1 of two row pairs are then words 0 to 3 of the block, columns 2
+// and 3 are words 4 to 7, and so on.
+*/
+static TEXCONV_TARGET void TexTwiddleSSE2 (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+										   int nPitch, int nWidth,
+										   sgl_uint32 AndMask, sgl_uint32 XorMask)
+{
+	__m128i	And = _mm_set1_epi32 ((int) AndMask);
+	__m128i	Xor = _mm_set1_epi32 ((int) XorMask);
+	int		nBlocks = (nWidth * nWidth) >> 6;
+	int		b, q;
+
+	for (b = 0; b < nBlocks; b++, pDst += 32)
+	{
+		const sgl_uint16 *pRow = pSrc + BLOCK_ROW (b) * nPitch + BLOCK_COLUMN (b);
+
+		for (q = 0; q < 2; q++, pRow += 4 * nPitch)
+		{
+			__m128i Row0 = _mm_loadu_si128 ((const __m128i *) pRow);
+			__m128i Row1 = _mm_loadu_si128 ((const __m128i *) (pRow + nPitch));
+			__m128i Row2 = _mm_loadu_si128 ((const __m128i *) (pRow + 2 * nPitch));
+			__m128i Row3 = _mm_loadu_si128 ((const __m128i *) (pRow + 3 * nPitch));
+
+			__m128i Lo01 = _mm_unpacklo_epi16 (Row1, Row0);
+			__m128i Hi01 = _mm_unpackhi_epi16 (Row1, Row0);
+			__m128i Lo23 = _mm_unpacklo_epi16 (Row3, Row2);
+			__m128i Hi23 = _mm_unpackhi_epi16 (Row3, Row2);
+
+			__m128i *pOut = (__m128i *) (pDst + 8 * q);
+
+			_mm_storeu_si128 (pOut, _mm_xor_si128 (_mm_and_si128 (_mm_unpacklo_epi64 (Lo01, Lo23), And), Xor));
+			_mm_storeu_si128 (pOut + 1, _mm_xor_si128 (_mm_and_si128 (_mm_unpackhi_epi64 (Lo01, Lo23), And), Xor));
+			_mm_storeu_si128 (pOut + 4, _mm_xor_si128 (_mm_and_si128 (_mm_unpacklo_epi64 (Hi01, Hi23), And), Xor));
+			_mm_storeu_si128 (pOut + 5, _mm_xor_si128 (_mm_and_si128 (_mm_unpackhi_epi64 (Hi01, Hi23), And), Xor));
+		}
+	}
+}
+
+#undef TEXCONV_TARGET
+
+#endif /* TEXCONV_SSE2 */
+
+/*
+// ============================================================================
+// 								AVX2 (16 PIXELS)
+// ============================================================================
+*/
+
+#if TEXCONV_AVX2
+
+#include <immintrin.h>
+
+#if defined (__AVX2__) || !TEXCONV_GCC_X86
+	#define TEXCONV_TARGET
+#else
+	#define TEXCONV_TARGET		__attribute__ ((target ("avx2")))
+#endif
+
+/*
+// The fields and test of a conversion, for eight 32 bit source pixels
+*/
+static TEXCONV_TARGET __m256i Conv32AVX2 (const TEXCONV *pConv, __m256i Src)
+{
+	__m256i	Out = _mm256_setzero_si256 ();
+	int		k;
+
+	for (k = 0; k < pConv->nFields; k++)
+	{
+		__m256i Field = _mm256_and_si256 (Src, _mm256_set1_epi32 ((int) pConv->Mask[k]));
+
+		Field = _mm256_srl_epi32 (Field, _mm_cvtsi32_si128 (pConv->RightShift[k]));
+		Out = _mm256_or_si256 (Out, _mm256_sll_epi32 (Field, _mm_cvtsi32_si128 (pConv->LeftShift[k])));
+	}
+
+	if (pConv->TestSet)
+	{
+		__m256i Match = _mm256_cmpeq_epi32 (_mm256_and_si256 (Src, _mm256_set1_epi32 ((int) pConv->TestMask)),
+											_mm256_set1_epi32 ((int) pConv->TestValue));
+
+		Out = _mm256_or_si256 (Out, _mm256_and_si256 (Match, _mm256_set1_epi32 (pConv->TestSet)));
+	}
+
+	return (_mm256_srai_epi32 (_mm256_slli_epi32 (Out, 16), 16));
+}
+
+static TEXCONV_TARGET void TexConvAVX2 (const TEXCONV *pConv, const void *pSrc,
+										sgl_uint16 *pDst, int nPixels)
+{
+	int		i = 0, k;
+
+	if (pConv->nSrcBits == 16)
+	{
+		const sgl_uint16	*pSrc16 = (const sgl_uint16 *) pSrc;
+		__m256i				Mask[TEXCONV_MAX_FIELDS];
+		__m128i				Right[TEXCONV_MAX_FIELDS];
+		__m128i				Left[TEXCONV_MAX_FIELDS];
+		__m256i				TestMask, TestValue, TestSet;
+
+		for (k = 0; k < pConv->nFields; k++)
+		{
+			Mask[k] = _mm256_set1_epi16 ((short) pConv->Mask[k]);
+			Right[k] = _mm_cvtsi32_si128 (pConv->RightShift[k]);
+			Left[k] = _mm_cvtsi32_si128 (pConv->LeftShift[k]);
+		}
+
+		TestMask = _mm256_set1_epi16 ((short) pConv->TestMask);
+		TestValue = _mm256_set1_epi16 ((short) pConv->TestValue);
+		TestSet = _mm256_set1_epi16 ((short) pConv->TestSet);
+
+		for (/* Nothing */; i + 16 <= nPixels; i += 16)
+		{
+			__m256i Src = _mm256_loadu_si256 ((const __m256i *) (pSrc16 + i));
+			__m256i Out = _mm256_setzero_si256 ();
+
+			for (k = 0; k < pConv->nFields; k++)
+			{
+				__m256i Field = _mm256_srl_epi16 (_mm256_and_si256 (Src, Mask[k]), Right[k]);
+
+				Out = _mm256_or_si256 (Out, _mm256_sll_epi16 (Field, Left[k]));
+			}
+
+			Out = _mm256_or_si256 (Out, _mm256_and_si256 (TestSet,
+							_mm256_cmpeq_epi16 (_mm256_and_si256 (Src, TestMask), TestValue)));
+
+			_mm256_storeu_si256 ((__m256i *) (pDst + i), Out);
+		}
+
+		TexConvScalar (pConv, pSrc16 + i, pDst + i, nPixels - i);
+	}
+	else
+	{
+		const TEXCONV_PIXEL32	*pSrc32 = (const TEXCONV_PIXEL32 *) pSrc;
+
+		for (/* Nothing */; i + 16 <= nPixels; i += 16)
+		{
+			__m256i Lo = Conv32AVX2 (pConv, _mm256_loadu_si256 ((const __m256i *) (pSrc32 + i)));
+			__m256i Hi = Conv32AVX2 (pConv, _mm256_loadu_si256 ((const __m256i *) (pSrc32 + i + 8)));
+
+			/* The pack works within 128 bit halves, so put the quarters back in order */
+			__m256i Out = _mm256_permute4x64_epi64 (_mm256_packs_epi32 (Lo, Hi), 0xD8);
+
+			_mm256_storeu_si256 ((__m256i *) (pDst + i), Out);
+		}
+
+		TexConvScalar (pConv, pSrc32 + i, pDst + i, nPixels - i);
+	}
+}
+
+#undef TEXCONV_TARGET
+
+#endif /* TEXCONV_AVX2 */
+
+/*
+// ============================================================================
+// 								NEON (8 PIXELS)
+// ============================================================================
+*/
+
+#if TEXCONV_NEON
+
+#include <arm_neon.h>
+
+/*
+// The fields and test of a conversion, for four 32 bit source pixels.
+// NEON shifts right by shifting left a negative amount.
+*/
+static uint16x4_t Conv32NEON (const TEXCONV *pConv, uint32x4_t Src)
+{
+	uint32x4_t	Out = vdupq_n_u32 (0);
+	int			k;
+
+	for (k = 0; k < pConv->nFields; k++)
+	{
+		uint32x4_t Field = vandq_u32 (Src, vdupq_n_u32 (pConv->Mask[k]));
+
+		Field = vshlq_u32 (Field, vdupq_n_s32 (-pConv->RightShift[k]));
+		Out = vorrq_u32 (Out, vshlq_u32 (Field, vdupq_n_s32 (pConv->LeftShift[k])));
+	}
+
+	if (pConv->TestSet)
+	{
+		uint32x4_t Match = vceqq_u32 (vandq_u32 (Src, vdupq_n_u32 (pConv->TestMask)),
+									  vdupq_n_u32 (pConv->TestValue));
+
+		Out = vorrq_u32 (Out, vandq_u32 (Match, vdupq_n_u32 (pConv->TestSet)));
+	}
+
+	return (vmovn_u32 (Out));
+}
+
+static void TexConvNEON (const TEXCONV *pConv, const void *pSrc,
+						 sgl_uint16 *pDst, int nPixels)
+{
+	int		i = 0, k;
+
+	if (pConv->nSrcBits == 16)
+	{
+		const sgl_uint16	*pSrc16 = (const sgl_uint16 *) pSrc;
+		uint16x8_t			Mask[TEXCONV_MAX_FIELDS];
+		int16x8_t			Right[TEXCONV_MAX_FIELDS];
+		int16x8_t			Left[TEXCONV_MAX_FIELDS];
+		uint16x8_t			TestMask, TestValue, TestSet;
+
+		for (k = 0; k < pConv->nFields; k++)
+		{
+			Mask[k] = vdupq_n_u16 ((sgl_uint16) pConv->Mask[k]);
+			Right[k] = vdupq_n_s16 ((short) -pConv->RightShift[k]);
+			Left[k] = vdupq_n_s16 ((short) pConv->LeftShift[k]);
+		}
+
+		TestMask = vdupq_n_u16 ((sgl_uint16) pConv->TestMask);
+		TestValue = vdupq_n_u16 ((sgl_uint16) pConv->TestValue);
+		TestSet = vdupq_n_u16 (pConv->TestSet);
+
+		for (/* Nothing */; i + 8 <= nPixels; i += 8)
+		{
+			uint16x8_t Src = vld1q_u16 (pSrc16 + i);
+			uint16x8_t Out = vdupq_n_u16 (0);
+
+			for (k = 0; k < pConv->nFields; k++)
+			{
+				uint16x8_t Field = vshlq_u16 (vandq_u16 (Src, Mask[k]), Right[k]);
+
+				Out = vorrq_u16 (Out, vshlq_u16 (Field, Left[k]));
+			}
+
+			Out = vorrq_u16 (Out, vandq_u16 (TestSet,
+							 vceqq_u16 (vandq_u16 (Src, TestMask), TestValue)));
+
+			vst1q_u16 (pDst + i, Out);
+		}
+
+		TexConvScalar (pConv, pSrc16 + i, pDst + i, nPixels - i);
+	}
+	else
+	{
+		const TEXCONV_PIXEL32	*pSrc32 = (const TEXCONV_PIXEL32 *) pSrc;
+
+		for (/* Nothing */; i + 8 <= nPixels; i += 8)
+		{
+			uint16x4_t Lo = Conv32NEON (pConv, vld1q_u32 ((const uint32_t *) pSrc32 + i));
+			uint16x4_t Hi = Conv32NEON (pConv, vld1q_u32 ((const uint32_t *) pSrc32 + i + 4));
+
+			vst1q_u16 (pDst + i, vcombine_u16 (Lo, Hi));
+		}
+
+		TexConvScalar (pConv, pSrc32 + i, pDst + i, nPixels - i);
+	}
+}
+
+/*
+// As TexTwiddleSSE2
+*/
+static void TexTwiddleNEON (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+							int nPitch, int nWidth,
+							sgl_uint32 AndMask, sgl_uint32 XorMask)
+{
+	uint32x4_t	And = vdupq_n_u32 (AndMask);
+	uint32x4_t	Xor = vdupq_n_u32 (XorMask);
+	int			nBlocks = (nWidth * nWidth) >> 6;
+	int			b, q;
+
+	for (b = 0; b < nBlocks; b++, pDst += 32)
+	{
+		const sgl_uint16 *pRow = pSrc + BLOCK_ROW (b) * nPitch + BLOCK_COLUMN (b);
+
+		for (q = 0; q < 2; q++, pRow += 4 * nPitch)
+		{
+			uint16x8x2_t Rows01 = vzipq_u16 (vld1q_u16 (pRow + nPitch), vld1q_u16 (pRow));
+			uint16x8x2_t Rows23 = vzipq_u16 (vld1q_u16 (pRow + 3 * nPitch), vld1q_u16 (pRow + 2 * nPitch));
+
+			uint32x4_t Lo01 = vreinterpretq_u32_u16 (Rows01.val[0]);
+			uint32x4_t Hi01 = vreinterpretq_u32_u16 (Rows01.val[1]);
+			uint32x4_t Lo23 = vreinterpretq_u32_u16 (Rows23.val[0]);
+			uint32x4_t Hi23 = vreinterpretq_u32_u16 (Rows23.val[1]);
+
+			uint32_t *pOut = (uint32_t *) (pDst + 8 * q);
+
+			vst1q_u32 (pOut, veorq_u32 (vandq_u32 (vcombine_u32 (vget_low_u32 (Lo01), vget_low_u32 (Lo23)), And), Xor));
+			vst1q_u32 (pOut + 4, veorq_u32 (vandq_u32 (vcombine_u32 (vget_high_u32 (Lo01), vget_high_u32 (Lo23)), And), Xor));
+			vst1q_u32 (pOut + 16, veorq_u32 (vandq_u32 (vcombine_u32 (vget_low_u32 (Hi01), vget_low_u32 (Hi23)), And), Xor));
+			vst1q_u32 (pOut + 20, veorq_u32 (vandq_u32 (vcombine_u32 (vget_high_u32 (Hi01), vget_high_u32 (Hi23)), And), Xor));
+		}
+	}
+}
+
+#endif /* TEXCONV_NEON */
+
+/*
+// ============================================================================
+// 								DISPATCH
+// ============================================================================
+*/
+
+int TexConvSelect (int nMaxLanes, TEXCONVFN *pfnConvert)
+{
+	*pfnConvert = TexConvScalar;
+
+	#if TEXCONV_GCC_X86
+		__builtin_cpu_init ();
+	#endif
+
+	#if TEXCONV_AVX2
+
+		if ((nMaxLanes >= 16) && TEXCONV_HAS_AVX2)
+		{
+			*pfnConvert = TexConvAVX2;
+			return (16);
+		}
+
+	#endif
+
+	#if TEXCONV_SSE2
+
+		if ((nMaxLanes >= 8) && TEXCONV_HAS_SSE2)
+		{
+			*pfnConvert = TexConvSSE2;
+			return (8);
+		}
+
+	#endif
+
+	#if TEXCONV_NEON
+
+		if (nMaxLanes >= 8)
+		{
+			*pfnConvert = TexConvNEON;
+			return (8);
+		}
+
+	#endif
+
+	return (1);
+}
+
+int TexTwiddleSelect (int nMaxLanes, TEXTWIDDLEFN *pfnTwiddle)
+{
+	*pfnTwiddle = TexTwiddleScalar;
+
+	#if TEXCONV_GCC_X86
+		__builtin_cpu_init ();
+	#endif
+
+	#if TEXCONV_SSE2
+
+		if ((nMaxLanes >= 8) && TEXCONV_HAS_SSE2)
+		{
+			*pfnTwiddle = TexTwiddleSSE2;
+			return (8);
+		}
+
+	#endif
+
+	#if TEXCONV_NEON
+
+		if (nMaxLanes >= 8)
+		{
+			*pfnTwiddle = TexTwiddleNEON;
+			return (8);
+		}
+
+	#endif
+
+	return (1);
+}
+
+/* texconv.c */
@@ -0,0 +1,235 @@
+/*****************************************************************************
+;++
+Name           	:   $RCSfile: texconv.h,v $
+Title           :   TEXCONV.H
+Created         :   17/10/2026
+
+Copyright		: 	1995-2022 Imagination Technologies (c)
+License			:	MIT
+
+Description     :   Vector texture format conversion for TextureLoad.
+					Every 16 and 32 bit source format TextureLoad converts
+					(565, 555 and 1555 with or without a colour key, 888
+					and 8888 in either byte order, and the unknown formats
+					described by masks) comes down to the same sum: up to
+					four fields, each masked out of the source pixel and
+					shifted into place, plus some bits set when the pixel
+					matches a value (the alpha bit of 1555, or the colour
+					key). A TEXCONV describes the sum and a kernel does it
+					for a run of pixels.
+
+					The same goes for writing a map to texture memory in
+					the twiddled order the hardware reads it in (see
+					TEXTWIDDLEFN below).
+
+					The widest kernel the CPU can run is picked at run
+					time. Builds whose compiler has no vector support get
+					the scalar kernel only.
+
+Program Type    :   C module (ANSI)
+
+RCS info:
+
+  $Date$
+  $Revision$
+  $Locker:  $
+  $Log: texconv.h,v $
+
+;--
+*****************************************************************************/
+
+#ifndef __TEXCONV_H__
+#define __TEXCONV_H__
+
+/* Most fields a conversion has (A, R, G and B) */
+#define TEXCONV_MAX_FIELDS	4
+
+/* Widest group any kernel handles, in pixels */
+#define TEXCONV_MAX_LANES	16
+
+/*
+// A 32 bit source pixel. sgl_uint32 is a long, which isn't 32 bits
+// everywhere.
+*/
+typedef unsigned int	TEXCONV_PIXEL32;
+
+/*
+// Each output pixel is
+//
+//		OR of ((Src & Mask[k]) >> RightShift[k]) << LeftShift[k]
+//
+// over the fields, cut to 16 bits, ORed with TestSet if
+// (Src & TestMask) == TestValue. Shifts are less than 32. Set these up
+// with TexConvInit, TexConvAddField and TexConvSetTest.
+*/
+typedef struct tagTEXCONV
+{
+	int			nSrcBits;		/* 16 or 32 */
+	int			nFields;
+
+	sgl_uint32	Mask[TEXCONV_MAX_FIELDS];
+	int			RightShift[TEXCONV_MAX_FIELDS];
+	int			LeftShift[TEXCONV_MAX_FIELDS];
+
+	sgl_uint32	TestMask;
+	sgl_uint32	TestValue;
+	sgl_uint16	TestSet;		/* 0 if there is no test */
+
+} TEXCONV;
+
+typedef void (* TEXCONVFN)(const TEXCONV *pConv, const void *pSrc,
+						   sgl_uint16 *pDst, int nPixels);
+
+/*
+// Setting up a conversion. TexConvAddField returns FALSE if the field
+// can't be done this way (too many fields, or a shift out of range); the
+// conversion should then be done with the old code.
+*/
+void TexConvInit (TEXCONV *pConv, int nSrcBits);
+
+sgl_bool TexConvAddField (TEXCONV *pConv, sgl_uint32 Mask,
+						  int nRightShift, int nLeftShift);
+
+void TexConvSetTest (TEXCONV *pConv, sgl_uint32 TestMask,
+					 sgl_uint32 TestValue, sgl_uint16 TestSet);
+
+/*===========================================
+ * Function:	TexConvScalar
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Converts nPixels pixels from pSrc to pDst one at a time.
+ *				This is what every kernel must match, and what they use
+ *				for the pixels left over after the last full group.
+ *
+ * Params:		const TEXCONV *pConv: the conversion
+ *				const void *pSrc: source pixels, nSrcBits each
+ *				sgl_uint16 *pDst: output pixels
+ *				int nPixels: number of pixels
+ *
+ * Return:		void
+ *========================================================================================*/
+void TexConvScalar (const TEXCONV *pConv, const void *pSrc,
+					sgl_uint16 *pDst, int nPixels);
+
+/*===========================================
+ * Function:	TexConvSelect
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Picks the widest kernel the CPU supports that handles no
+ *				more than nMaxLanes pixels at a time.
+ *
+ * Params:		int nMaxLanes: widest kernel wanted (1 for the scalar one)
+ *				TEXCONVFN *pfnConvert: receives the kernel
+ *
+ * Return:		Pixels the kernel handles per group, or 1 if it is the
+ *				scalar kernel.
+ *========================================================================================*/
+int TexConvSelect (int nMaxLanes, TEXCONVFN *pfnConvert);
+
+/*
+// Twiddling. Texture memory holds a W by W map (W a power of 2) as 32 bit
+// words, each with two pixels from the same column: the one on an even
+// row in the top half and the one below it in the bottom half. The word
+// for column x and row pair y / 2 is at the index made by interleaving the
+// bits of x and y / 2, x taking bit 0. A kernel writes a whole map of at
+// least TEXTWIDDLE_MIN_WIDTH pixels, in word order, with each word ANDed
+// with AndMask and then XORed with XorMask (for the 555 alpha bit and
+// reversed alpha).
+*/
+#define TEXTWIDDLE_MIN_WIDTH	8
+
+typedef void (* TEXTWIDDLEFN)(TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+							  int nPitch, int nWidth,
+							  sgl_uint32 AndMask, sgl_uint32 XorMask);
+
+/*===========================================
+ * Function:	TexTwiddleScalar
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Writes a map to texture memory twiddled, a word at a time.
+ *
+ * Params:		TEXCONV_PIXEL32 *pDst: the map in texture memory
+ *				const sgl_uint16 *pSrc: top left source pixel
+ *				int nPitch: source pixels from one row to the next
+ *				int nWidth: map width, a power of 2 from 8 to 256
+ *				sgl_uint32 AndMask, XorMask: applied to each word
+ *
+ * Return:		void
+ *========================================================================================*/
+void TexTwiddleScalar (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+					   int nPitch, int nWidth,
+					   sgl_uint32 AndMask, sgl_uint32 XorMask);
+
+/*===========================================
+ * Function:	TexTwiddlePalettised
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		As TexTwiddleScalar, for 8 bit source pixels looked up in
+ *				a palette. There are no masks; the palette has them.
+ *
+ * Params:		TEXCONV_PIXEL32 *pDst: the map in texture memory
+ *				const sgl_uint8 *pSrc: top left source pixel
+ *				int nPitch: source pixels from one row to the next
+ *				int nWidth: map width, a power of 2 from 8 to 256
+ *				const sgl_uint16 *pPalette: 16 bit colours
+ *
+ * Return:		void
+ *========================================================================================*/
+void TexTwiddlePalettised (TEXCONV_PIXEL32 *pDst, const sgl_uint8 *pSrc,
+						   int nPitch, int nWidth, const sgl_uint16 *pPalette);
+
+/*===========================================
+ * Function:	TexConvTwiddle
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		Converts a map and writes it to texture memory twiddled,
+ *				with no whole map buffer in between. Each strip of eight
+ *				rows is converted into a small buffer, which stays in the
+ *				cache, and then twiddled a block at a time.
+ *
+ * Params:		TEXCONV_PIXEL32 *pDst: the map in texture memory
+ *				const void *pSrc: top left source pixel
+ *				int nPitch: source pixels from one row to the next
+ *				int nWidth: map width, a power of 2 from 8 to 256
+ *				const TEXCONV *pConv: the conversion
+ *				TEXCONVFN pfnConvert: from TexConvSelect
+ *				TEXTWIDDLEFN pfnTwiddle: from TexTwiddleSelect
+ *				sgl_uint32 AndMask, XorMask: applied to each word
+ *
+ * Return:		void
+ *========================================================================================*/
+void TexConvTwiddle (TEXCONV_PIXEL32 *pDst, const void *pSrc,
+					 int nPitch, int nWidth,
+					 const TEXCONV *pConv, TEXCONVFN pfnConvert,
+					 TEXTWIDDLEFN pfnTwiddle,
+					 sgl_uint32 AndMask, sgl_uint32 XorMask);
+
+/*===========================================
+ * Function:	TexTwiddleSelect
+ *===========================================
+ *
+ * Scope:		SGL
+ *
+ * Purpose:		As TexConvSelect, for the twiddling kernels.
+ *
+ * Params:		int nMaxLanes: widest kernel wanted (1 for the scalar one)
+ *				TEXTWIDDLEFN *pfnTwiddle: receives the kernel
+ *
+ * Return:		Source pixels a row the kernel reads at a time, or 1 if it
+ *				is the scalar kernel.
+ *========================================================================================*/
+int TexTwiddleSelect (int nMaxLanes, TEXTWIDDLEFN *pfnTwiddle);
+
+#endif /* __TEXCONV_H__ */
+
+/*------------------------------- End of File -------------------------------*/
@@ -106,7 +106,277 @@
 #include "texapi.h"
 #include "tmalloc.h"
 
-#define BEST_FIT  TRUE /* Set FALSE for previous 'first fit' operation. */
+/*
+** How many blocks of the request's own size class TMalloc looks at for a
+** close fit before taking the first block of a larger class.
+*/
+#define FIT_TRIES	4
+
+#define ROOT(hTexHeap)	((MNODE*)(hTexHeap)->pMemoryRoot)
+#define INDEX(hTexHeap)	((TMALLOC_INDEX*)(hTexHeap)->pFreeIndex)
+
+/******************************************************************************
+ * Function Name: HighestBit
+ *
+ * Inputs       : Value, non zero and below 2^32.
+ * Outputs      : -
+ * Returns      : The number of the highest bit set.
+ * Globals Used : -
+ * Description  : -
+ *****************************************************************************/
+static int HighestBit(sgl_uint32 Value)
+{
+	int Bit = 0;
+
+	if (Value & 0xFFFF0000UL)	{ Bit += 16; Value >>= 16; }
+	if (Value & 0xFF00)			{ Bit += 8;  Value >>= 8; }
+	if (Value & 0xF0)			{ Bit += 4;  Value >>= 4; }
+	if (Value & 0xC)			{ Bit += 2;  Value >>= 2; }
+	if (Value & 0x2)			{ Bit += 1; }
+
+	return (Bit);
+}
+
+#define LowestBit(Value)	HighestBit((Value) & (~(Value) + 1))
+
+/******************************************************************************
+ * Function Name: SizeClass
+ *
+ * Inputs       : Size, in bytes.
+ * Outputs      : FL, SL: the list the size belongs in.
+ * Returns      : -
+ * Globals Used : -
+ * Description  : Sizes below TMALLOC_SL_COUNT get a list each; above that
+ *				  each power of two is split into TMALLOC_SL_COUNT lists.
+ *****************************************************************************/
+static void SizeClass(sgl_uint32 Size, int *FL, int *SL)
+{
+	if (Size < TMALLOC_SL_COUNT)
+	{
+		*FL = 0;
+		*SL = (int) Size;
+	}
+	else
+	{
+		int Top = HighestBit(Size);
+
+		*FL = Top - TMALLOC_SL_BITS + 1;
+		*SL = (int) (Size >> (Top - TMALLOC_SL_BITS)) - TMALLOC_SL_COUNT;
+	}
+}
+
+/*
+** Free block lists. A node must be taken off before its size changes.
+*/
+static void FreeInsert(TMALLOC_INDEX *Index, MNODE *Node)
+{
+	int FL, SL;
+
+	SizeClass(Node->BlockSize, &FL, &SL);
+
+	Node->PrevFree = NULL;
+	Node->NextFree = Index->FreeLists[FL][SL];
+
+	if (Node->NextFree != NULL)
+		Node->NextFree->PrevFree = Node;
+	Index->FreeLists[FL][SL] = Node;
+
+	Index->FirstLevelMap |= 1UL << FL;
+	Index->SecondLevelMap[FL] |= 1UL << SL;
+	Index->FreeBlocks++;
+}
+
+static void FreeRemove(TMALLOC_INDEX *Index, MNODE *Node)
+{
+	int FL, SL;
+
+	SizeClass(Node->BlockSize, &FL, &SL);
+
+	if (Node->PrevFree != NULL)
+		Node->PrevFree->NextFree = Node->NextFree;
+	else
+		Index->FreeLists[FL][SL] = Node->NextFree;
+
+	if (Node->NextFree != NULL)
+		Node->NextFree->PrevFree = Node->PrevFree;
+
+	if (Index->FreeLists[FL][SL] == NULL)
+	{
+		Index->SecondLevelMap[FL] &= ~(1UL << SL);
+
+		if (Index->SecondLevelMap[FL] == 0)
+			Index->FirstLevelMap &= ~(1UL << FL);
+	}
+
+	Index->FreeBlocks--;
+}
+
+/*
+** Free buddy lists. The same sizes usually come back, so a buddy list
+** seldom holds more than one size and the exact match is near its head.
+*/
+static void BuddyInsert(TMALLOC_INDEX *Index, MNODE *Node)
+{
+	int FL, SL;
+
+	SizeClass(Node->BlockSize, &FL, &SL);
+
+	Node->PrevBuddy = NULL;
+	Node->NextBuddy = Index->BuddyLists[FL][SL];
+
+	if (Node->NextBuddy != NULL)
+		Node->NextBuddy->PrevBuddy = Node;
+	Index->BuddyLists[FL][SL] = Node;
+
+	Index->BuddyBlocks++;
+}
+
+static void BuddyRemove(TMALLOC_INDEX *Index, MNODE *Node)
+{
+	int FL, SL;
+
+	SizeClass(Node->BlockSize, &FL, &SL);
+
+	if (Node->PrevBuddy != NULL)
+		Node->PrevBuddy->NextBuddy = Node->NextBuddy;
+	else
+		Index->BuddyLists[FL][SL] = Node->NextBuddy;
+
+	if (Node->NextBuddy != NULL)
+		Node->NextBuddy->PrevBuddy = Node->PrevBuddy;
+
+	Index->BuddyBlocks--;
+}
+
+/******************************************************************************
+ * Function Name: FindFree
+ *
+ * Inputs       : Index, RequestSize.
+ * Outputs      : -
+ * Returns      : A free block of at least RequestSize bytes, or NULL.
+ * Globals Used : -
+ * Description  : Looks at the first few blocks of the request's own class
+ *				  for the closest fit, then takes the first block of the
+ *				  smallest class whose blocks are all big enough.
+ *****************************************************************************/
+static MNODE *FindFree(TMALLOC_INDEX *Index, sgl_uint32 RequestSize)
+{
+	MNODE *MemWalk, *BestNode = NULL;
+	sgl_uint32 Map, Round;
+	int FL, SL, Tries;
+
+	SizeClass(RequestSize, &FL, &SL);
+
+	MemWalk = Index->FreeLists[FL][SL];
+
+	for (Tries = 0; (MemWalk != NULL) && (Tries < FIT_TRIES); Tries++)
+	{
+		if (MemWalk->BlockSize >= RequestSize &&
+		   (BestNode == NULL || MemWalk->BlockSize < BestNode->BlockSize))
+		{
+			BestNode = MemWalk;
+		}
+		MemWalk = MemWalk->NextFree;
+	}
+
+	if (BestNode != NULL)
+	{
+		return (BestNode);
+	}
+
+	/* round up to the next class boundary, so anything in the class fits */
+
+	Round = (RequestSize < TMALLOC_SL_COUNT) ? 0 :
+			(1UL << (HighestBit(RequestSize) - TMALLOC_SL_BITS)) - 1;
+
+	if (RequestSize + Round < RequestSize)
+	{
+		return (NULL);
+	}
+
+	SizeClass(RequestSize + Round, &FL, &SL);
+
+	Map = Index->SecondLevelMap[FL] & (0xFFFFFFFFUL << SL);
+
+	if (Map == 0)
+	{
+		Map = Index->FirstLevelMap & (0xFFFFFFFFUL << (FL + 1));
+
+		if (Map == 0)
+		{
+			return (NULL);
+		}
+
+		FL = LowestBit(Map);
+		Map = Index->SecondLevelMap[FL];
+	}
+
+	SL = LowestBit(Map);
+
+	return (Index->FreeLists[FL][SL]);
+}
+
+/******************************************************************************
+ * Function Name: FindBuddy
+ *
+ * Inputs       : Index, RequestSize.
+ * Outputs      : -
+ * Returns      : A free buddy of exactly RequestSize bytes, or NULL.
+ * Globals Used : -
+ * Description  : -
+ *****************************************************************************/
+static MNODE *FindBuddy(TMALLOC_INDEX *Index, sgl_uint32 RequestSize)
+{
+	MNODE *MemWalk;
+	int FL, SL;
+
+	SizeClass(RequestSize, &FL, &SL);
+
+	for (MemWalk = Index->BuddyLists[FL][SL]; MemWalk != NULL; MemWalk = MemWalk->NextBuddy)
+	{
+		if (MemWalk->BlockSize == RequestSize)
+		{
+			break;
+		}
+	}
+
+	return (MemWalk);
+}
+
+/******************************************************************************
+ * Function Name: MergeNext
+ *
+ * Inputs       : Index, Node, a block that is free in both banks and not in
+ *				  the free lists.
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : -
+ * Description  : If the block after Node is free as well, adds it to Node
+ *				  and deletes it.
+ *****************************************************************************/
+static void MergeNext(TMALLOC_INDEX *Index, MNODE *Node)
+{
+	MNODE *TempNode = Node->Next;
+
+	if (TempNode != NULL && TempNode->UsedStatus == 0)
+	{
+		FreeRemove(Index, TempNode);
+
+		/* add the space togeather. */
+
+		Node->BlockSize += TempNode->BlockSize;
+
+		/* unlink the node from the master list*/
+
+		Node->Next = TempNode->Next;
+		if (TempNode->Next != NULL)
+			TempNode->Next->Prev = Node;
+
+		/* deallocate the MNode space */
+
+		PVROSFree(TempNode);
+	}
+}
 
 /******************************************************************************
  * Function Name: InitTextureMemory
@@ -118,14 +388,17 @@
  *				  MemoryLeft
  * Description  : This should only be called once. If it is called more than
  *				  once it will unlink any list at the root, so main memory
- *				  will be lost. 
+ *				  will be lost.
  *****************************************************************************/
 void InitTextureMemory(sgl_uint32 TextureMemorySize, HTEXHEAP hTexHeap)
-{	
+{
+	TMALLOC_INDEX *Index = INDEX(hTexHeap);
+	int FL, SL;
+
 	((MNODE*)hTexHeap->pMemoryRoot)->Prev			= NULL;
 	((MNODE*)hTexHeap->pMemoryRoot)->Next			= NULL;
 	((MNODE*)hTexHeap->pMemoryRoot)->MemoryAddress	= 0;
-	((MNODE*)hTexHeap->pMemoryRoot)->BlockSize		= TextureMemorySize >> 1; 
+	((MNODE*)hTexHeap->pMemoryRoot)->BlockSize		= TextureMemorySize >> 1;
 											/*the size of a bank in bytes*/
 	((MNODE*)hTexHeap->pMemoryRoot)->UsedStatus		= 0;
 
@@ -147,6 +420,27 @@ void InitTextureMemory(sgl_uint32 TextureMemorySize, HTEXHEAP hTexHeap)
 
 	((MNODE*)hTexHeap->pMemoryRoot)->AllocatedBlocks	= 0;
 	((MNODE*)hTexHeap->pMemoryRoot)->LowWaterMark		= hTexHeap->TexParamSize;
+
+	((MNODE*)hTexHeap->pMemoryRoot)->Owner[0]		= NULL;
+	((MNODE*)hTexHeap->pMemoryRoot)->Owner[1]		= NULL;
+
+	for (FL = 0; FL < TMALLOC_FL_COUNT; FL++)
+	{
+		for (SL = 0; SL < TMALLOC_SL_COUNT; SL++)
+		{
+			Index->FreeLists[FL][SL] = NULL;
+			Index->BuddyLists[FL][SL] = NULL;
+		}
+		Index->SecondLevelMap[FL] = 0;
+	}
+
+	Index->FirstLevelMap = 0;
+	Index->FreeBlocks = 0;
+	Index->BuddyBlocks = 0;
+	Index->Changes = 0;
+	Index->CompactedAt = 0;
+
+	FreeInsert(Index, hTexHeap->pMemoryRoot);
 }
 
 /******************************************************************************
@@ -158,123 +452,65 @@ void InitTextureMemory(sgl_uint32 TextureMemorySize, HTEXHEAP hTexHeap)
  * Globals Used : MemoryRoot
  *				  MemoryLeft
  * Description  : This routine allocates memory from the texture memory.
- *				  The design document gives a brief explaination of the algorthm 
+ *				  The design document gives a brief explaination of the algorthm
  *		   		  implemented.
+ *
+ *				  A free buddy of the exact size is used first. Otherwise a
+ *				  free block is split, taking the closest fit among the
+ *				  first few of the request's size class or else the first
+ *				  block of a larger class, so the cost no longer grows with
+ *				  the number of blocks.
  * Pre-condition: InitTextureMemory has been called.
  *****************************************************************************/
 void TMalloc(sgl_uint32 RequestSize, HTEXHEAP hTexHeap, MNODE_BLOCK *FreeNode)
 {
+	TMALLOC_INDEX *Index = INDEX(hTexHeap);
 	MNODE *MemWalk;
 	MNODE *NewNode;
 
 	/*
-	** search the buddy list for a free buddy of the exact size 
+	** look for a free buddy of the exact size
 	*/
 
-	MemWalk = hTexHeap->pMemoryRoot;
-
-	while(MemWalk->NextBuddy != NULL && 
-	(MemWalk->BlockSize != RequestSize || MemWalk->UsedStatus==0 || MemWalk->UsedStatus==3))
-		MemWalk=MemWalk->NextBuddy;
+	MemWalk = FindBuddy(Index, RequestSize);
 
-	if(MemWalk->UsedStatus==A_BANK || MemWalk->UsedStatus==B_BANK)
-	{	
-		if(MemWalk->BlockSize == RequestSize)
-		{
-
-			/* remove this block from the buddy list */
-
-			if(MemWalk != (MNODE*) hTexHeap->pMemoryRoot)
- 			{
+	if (MemWalk != NULL)
+	{
+		BuddyRemove(Index, MemWalk);
 
-				MemWalk->PrevBuddy->NextBuddy=MemWalk->NextBuddy;
-				if(MemWalk->NextBuddy != NULL)
-					MemWalk->NextBuddy->PrevBuddy=MemWalk->PrevBuddy;
+		/* return the free buddy */
 
-			}
-			/* return the free buddy */
-	  
-		#if TMALLOC_BACKWARDS
-			MemWalk->MemoryAddress=((MNODE*)hTexHeap->pMemoryRoot)->MemorySize-MemWalk->MemoryOffset-RequestSize;
-		#endif
+	#if TMALLOC_BACKWARDS
+		MemWalk->MemoryAddress=ROOT(hTexHeap)->MemorySize-MemWalk->MemoryOffset-RequestSize;
+	#endif
 
-			FreeNode->Status=MemWalk->UsedStatus ^ 3;
-			FreeNode->MNode=MemWalk;
+		FreeNode->Status=MemWalk->UsedStatus ^ 3;
+		FreeNode->MNode=MemWalk;
 
-			/* mark this block as full */
+		/* mark this block as full */
 
-			MemWalk->UsedStatus=A_BANK | B_BANK;
-			
-			((MNODE*)hTexHeap->pMemoryRoot)->MemoryLeft-=RequestSize;
-			((MNODE*)hTexHeap->pMemoryRoot)->AllocatedBlocks ++;
+		MemWalk->UsedStatus=A_BANK | B_BANK;
+		MemWalk->Owner[FreeNode->Status - 1]=NULL;
 
-			return ;
+		ROOT(hTexHeap)->MemoryLeft-=RequestSize;
+		ROOT(hTexHeap)->AllocatedBlocks ++;
+		Index->Changes ++;
 
-		}
+		return ;
 	}
 
 	/*
 	**
-	** There are NO correct Buddies,so do a first or best fit in the free list.
+	** There are NO correct Buddies, so find a free block that fits.
 	**
 	*/
 
-	MemWalk=hTexHeap->pMemoryRoot;
-
-#if BEST_FIT
-	{
-		sgl_uint32  u32BestSize = 0xffffffff;
-		MNODE  *pBestNode = MemWalk;
-
-		ASSERT(MemWalk != NULL);
-		do
-		{
-			if (MemWalk->UsedStatus == 0 && MemWalk->BlockSize >= RequestSize
-			  && MemWalk->BlockSize < u32BestSize)
-			{
-				u32BestSize = MemWalk->BlockSize;
-				pBestNode = MemWalk;
-			}
-			MemWalk=MemWalk->NextFree;
+	MemWalk = FindFree(Index, RequestSize);
 
-		} while (MemWalk != NULL);
-
-		ASSERT(pBestNode != NULL);
-		MemWalk = pBestNode;
-	}
-#else
-	while (MemWalk->NextFree != NULL &&
-	  (MemWalk->BlockSize < RequestSize || MemWalk->UsedStatus!=0))
-	{
-		MemWalk=MemWalk->NextFree;
-	}
-#endif
-
-	if(MemWalk->UsedStatus==0 && MemWalk->BlockSize >= RequestSize) 
+	if (MemWalk != NULL)
 	{
 		/* allocate from this space */
 
-		/* unlink the node from the free list */
-
-		if(MemWalk != (MNODE*)hTexHeap->pMemoryRoot)
- 		{
-			MemWalk->PrevFree->NextFree=MemWalk->NextFree;
-			if(MemWalk->NextFree != NULL)
-				MemWalk->NextFree->PrevFree=MemWalk->PrevFree;
-		}
-
-		/* put the node on the buddy list*/
-
-		if(MemWalk != (MNODE*)hTexHeap->pMemoryRoot)
-		{
-			MemWalk->PrevBuddy = hTexHeap->pMemoryRoot;
-			MemWalk->NextBuddy = ((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy;
-
-			if(((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy !=NULL)
-				((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy->PrevBuddy=MemWalk;
-			((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy=MemWalk;
-		}
-
 		if(MemWalk->BlockSize > RequestSize)
 		{
 			/*
@@ -282,75 +518,90 @@ void TMalloc(sgl_uint32 RequestSize, HTEXHEAP hTexHeap, MNODE_BLOCK *FreeNode)
 			*/
 
 			NewNode=(MNODE*)PVROSMalloc(sizeof(MNODE));
+		}
+		else
+		{
+			NewNode=NULL;
+		}
 
-			/* link new node into the master list */
-
-			NewNode->Prev=MemWalk;
-			NewNode->Next=MemWalk->Next;
+		if (MemWalk->BlockSize > RequestSize && NewNode == NULL)
+		{
+			DPF((DBG_ERROR, "TMalloc: no memory for a new block"));
+		}
+		else
+		{
+			FreeRemove(Index, MemWalk);
 
-			if(MemWalk->Next !=NULL)
-				MemWalk->Next->Prev=NewNode;
-			MemWalk->Next=NewNode;
+			if (NewNode != NULL)
+			{
+				/* link new node into the master list */
 
-			/* fill out the other fields */
+				NewNode->Prev=MemWalk;
+				NewNode->Next=MemWalk->Next;
 
-		#if TMALLOC_BACKWARDS
-			NewNode->MemoryOffset=MemWalk->MemoryOffset + RequestSize;
-		#else
-			NewNode->MemoryAddress=MemWalk->MemoryAddress + RequestSize;
-		#endif
-			NewNode->BlockSize=MemWalk->BlockSize - RequestSize;
-			NewNode->UsedStatus=0;
+				if(MemWalk->Next !=NULL)
+					MemWalk->Next->Prev=NewNode;
+				MemWalk->Next=NewNode;
 
-			/*link free node after root node*/
+				/* fill out the other fields */
 
-			NewNode->PrevFree=hTexHeap->pMemoryRoot;
-			NewNode->NextFree=((MNODE*)hTexHeap->pMemoryRoot)->NextFree;
+			#if TMALLOC_BACKWARDS
+				NewNode->MemoryOffset=MemWalk->MemoryOffset + RequestSize;
+			#else
+				NewNode->MemoryAddress=MemWalk->MemoryAddress + RequestSize;
+			#endif
+				NewNode->BlockSize=MemWalk->BlockSize - RequestSize;
+				NewNode->UsedStatus=0;
+				NewNode->BlockType=NORMAL_BLOCK;
+				NewNode->Owner[0]=NULL;
+				NewNode->Owner[1]=NULL;
 
-			if(((MNODE*)hTexHeap->pMemoryRoot)->NextFree !=NULL)
-				((MNODE*)hTexHeap->pMemoryRoot)->NextFree->PrevFree=NewNode;
-			((MNODE*)hTexHeap->pMemoryRoot)->NextFree=NewNode;
+				FreeInsert(Index, NewNode);
+			}
 
-			NewNode->NextBuddy=NULL; /*not strictly required */
-			NewNode->PrevBuddy=NULL;
+			MemWalk->BlockSize=RequestSize;
+			MemWalk->UsedStatus=A_BANK;
+			MemWalk->Owner[0]=NULL;
+			MemWalk->Owner[1]=NULL;
 
-		}
+			/* bank B of it is a free buddy */
 
-		MemWalk->BlockSize=RequestSize;
-		MemWalk->UsedStatus=A_BANK;
+			BuddyInsert(Index, MemWalk);
 
-		#if TMALLOC_BACKWARDS
-			MemWalk->MemoryAddress=((MNODE*)hTexHeap->pMemoryRoot)->MemorySize-MemWalk->MemoryOffset-RequestSize;
-		#endif
+			#if TMALLOC_BACKWARDS
+				MemWalk->MemoryAddress=ROOT(hTexHeap)->MemorySize-MemWalk->MemoryOffset-RequestSize;
+			#endif
 
-		FreeNode->Status=A_BANK;
-		FreeNode->MNode=MemWalk;
+			FreeNode->Status=A_BANK;
+			FreeNode->MNode=MemWalk;
 
-		((MNODE*)hTexHeap->pMemoryRoot)->MemoryLeft-=RequestSize;
-		((MNODE*)hTexHeap->pMemoryRoot)->AllocatedBlocks ++;
+			ROOT(hTexHeap)->MemoryLeft-=RequestSize;
+			ROOT(hTexHeap)->AllocatedBlocks ++;
+			Index->Changes ++;
 
-		return ;
+			return ;
+		}
 	}
-	
+
 	/* there is no free space, so return with an error */
 
 	FreeNode->Status=-1;
 	FreeNode->MNode=NULL;
 
 	#if DEBUG
-	
+
 		{
 			sgl_uint32 Start, Size;
 			DPF((DBG_WARNING, "TMalloc failed!: Requested size was %d", RequestSize));
 			DPF((DBG_WARNING, "Set module debug level to 4 to dump texture heap"));
-		
+
 			MemWalk = hTexHeap->pMemoryRoot;
 
 			while (MemWalk)
 			{
 				Start = MemWalk->MemoryOffset;
 				Size = MemWalk->BlockSize;
-				
+
 				switch (MemWalk->UsedStatus)
 				{
 					case 0:
@@ -374,49 +625,16 @@ void TMalloc(sgl_uint32 RequestSize, HTEXHEAP hTexHeap, MNODE_BLOCK *FreeNode)
 						break;
 					}
 				}
-				
+
 				MemWalk = MemWalk->Next;
 			}
-			
-			DPF ((DBG_MESSAGE, "Free list:"));
 
-			MemWalk = hTexHeap->pMemoryRoot;
+			DPF ((DBG_MESSAGE, "%d free blocks, %d free buddies",
+				  Index->FreeBlocks, Index->BuddyBlocks));
 
-			while (MemWalk)
-			{
-				Start = MemWalk->MemoryOffset;
-				Size = MemWalk->BlockSize;
-				
-				switch (MemWalk->UsedStatus)
-				{
-					case 0:
-					{
-					    DPF ((DBG_MESSAGE, "\t%08lx (%d): Unused", Start, Size));
-						break;
-					}
-					case A_BANK:
-					{
-						DPF ((DBG_MESSAGE, "\t%08lx (%d): Bank A used", Start, Size));
-						break;
-					}
-					case B_BANK:
-					{
-						DPF ((DBG_MESSAGE, "\t%08lx (%d): Bank B used", Start, Size));
-						break;
-					}
-					case A_BANK | B_BANK:
-					{
-						DPF ((DBG_MESSAGE, "\t%08lx (%d): Banks A&B used", Start, Size));
-						break;
-					}
-				}
-				
-				MemWalk = MemWalk->NextFree;
-			}
-			
 			DPF ((DBG_MESSAGE, "End of heap dump"));
 		}
-		
+
 	#endif
 }
 
@@ -432,144 +650,217 @@ void TMalloc(sgl_uint32 RequestSize, HTEXHEAP hTexHeap, MNODE_BLOCK *FreeNode)
  *				  MemoryLeft
  * Description  : This routine de-allocated memory from the texture memory.
  *				  This routine has to be called with a valid MNODE_BLOCK. So,
- *				  if the same block is deleted twise, the routine many not 
+ *				  if the same block is deleted twise, the routine many not
  *				  function correctly.
  * Pre-condition: InitTextureMemory has been called.
  *				: FreeNode is an allocated MNODE_BLOCK.
  *****************************************************************************/
-void TFree(MNODE_BLOCK *FreeNode, HTEXHEAP hTexHeap) 
+void TFree(MNODE_BLOCK *FreeNode, HTEXHEAP hTexHeap)
 {
+	TMALLOC_INDEX *Index = INDEX(hTexHeap);
+	MNODE *Node = FreeNode->MNode;
 
-	MNODE *TempNode;
+	ROOT(hTexHeap)->MemoryLeft += Node->BlockSize;
+	Index->Changes ++;
 
-	((MNODE*)hTexHeap->pMemoryRoot)->MemoryLeft += FreeNode->MNode->BlockSize;
+	Node->Owner[FreeNode->Status - 1] = NULL;
 
 	/*
 	** do we need to create an empty buddy ?
 	*/
 
-
-	if(FreeNode->MNode->UsedStatus == (A_BANK | B_BANK))
+	if(Node->UsedStatus == (A_BANK | B_BANK))
 	{
-	 	/*
-		** insert the buddy after the root node.
-		*/
-
-		if(FreeNode->MNode != (MNODE*)hTexHeap->pMemoryRoot)
-		{
-			FreeNode->MNode->PrevBuddy=hTexHeap->pMemoryRoot;
-			FreeNode->MNode->NextBuddy=((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy;
-
-			if(((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy !=NULL)
-				((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy->PrevBuddy=FreeNode->MNode;
-			((MNODE*)hTexHeap->pMemoryRoot)->NextBuddy=FreeNode->MNode;
-		}
-
 		/* clear the used status of the buddy */
 
-		FreeNode->MNode->UsedStatus = FreeNode->Status ^ 3;
+		Node->UsedStatus = FreeNode->Status ^ 3;
 
+		BuddyInsert(Index, Node);
 	}
 	else
 	{
-		FreeNode->MNode->UsedStatus=0;
+		BuddyRemove(Index, Node);
+
+		Node->UsedStatus=0;
 
 		/*
-		**
 		** free up the memory and try and coalesce with adjacent memory.
-		**
 		*/
 
-		/* unlink the free buddy */
-
+		/* first try coelescing the next block */
 
-		if(FreeNode->MNode != (MNODE*)hTexHeap->pMemoryRoot)
-		{
-			FreeNode->MNode->PrevBuddy->NextBuddy=FreeNode->MNode->NextBuddy;
-			if(FreeNode->MNode->NextBuddy != NULL)
-				FreeNode->MNode->NextBuddy->PrevBuddy=FreeNode->MNode->PrevBuddy;
-		}
+		MergeNext(Index, Node);
+		FreeInsert(Index, Node);
 
-		/* insert the free block after the root node */
+		/* secondly, try coelescing with the previous block */
 
-		if(FreeNode->MNode != (MNODE*)hTexHeap->pMemoryRoot)
+		if(Node->Prev != NULL && Node->Prev->UsedStatus==0)
 		{
-			FreeNode->MNode->PrevFree=hTexHeap->pMemoryRoot;
-			FreeNode->MNode->NextFree=((MNODE*)hTexHeap->pMemoryRoot)->NextFree;
+			Node = Node->Prev;
 
-			if(((MNODE*)hTexHeap->pMemoryRoot)->NextFree !=NULL)
-				((MNODE*)hTexHeap->pMemoryRoot)->NextFree->PrevFree=FreeNode->MNode;
-			((MNODE*)hTexHeap->pMemoryRoot)->NextFree=FreeNode->MNode;
+			FreeRemove(Index, Node);
+			MergeNext(Index, Node);
+			FreeInsert(Index, Node);
 		}
+	}
 
-		/*
-		** try and coalesce the free block 
-		*/
-
-		/* first try coelescing the next block */
+	/* are we empty, and do we therefore need to reset the high water mark? */
 
-		if(FreeNode->MNode->Next != NULL && FreeNode->MNode->Next->UsedStatus==0)
-		{
-			TempNode=FreeNode->MNode->Next;
+	if (--((MNODE*)hTexHeap->pMemoryRoot)->AllocatedBlocks == 5)
+	{
+		DPF ((DBG_MESSAGE, "Setting high water mark: %d", ((MNODE*)hTexHeap->pMemoryRoot)->LowWaterMark));
 
-			/* add the space togeather. */
- 
-			FreeNode->MNode->BlockSize += TempNode->BlockSize;
+		PVROSSetTSPHighWaterMark (hTexHeap, ((MNODE*)hTexHeap->pMemoryRoot)->LowWaterMark, TRUE);
+	}
+}
 
-			/* unlink the node from the free list */
+/******************************************************************************
+ * Function Name: TSetOwner
+ *
+ * Inputs       : Block, as filled in by TMalloc.
+ *				  Owner, the texture using the block, passed back by the
+ *				  TCompact callback.
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : -
+ * Description  : Lets TCompact move the block. Blocks whose every used bank
+ *				  has an owner can be moved; the rest stay put.
+ *****************************************************************************/
+void TSetOwner(MNODE_BLOCK *Block, void *Owner)
+{
+	Block->MNode->Owner[Block->Status - 1] = Owner;
+}
 
-			TempNode->PrevFree->NextFree=TempNode->NextFree;
-			if(TempNode->NextFree != NULL)
-				TempNode->NextFree->PrevFree=TempNode->PrevFree;
+/******************************************************************************
+ * Function Name: TMovable
+ *
+ * Inputs       : MNode.
+ * Outputs      : -
+ * Returns      : TRUE if TCompact may move this used block.
+ * Globals Used : -
+ * Description  : Moves shift blocks by the size of the free block before
+ *				  them, so both have to keep the word alignment.
+ *****************************************************************************/
+sgl_bool TMovable(MNODE *MNode)
+{
+	return ((MNode->UsedStatus != 0) &&
+			(MNode->BlockType == NORMAL_BLOCK) &&
+			((MNode->BlockSize & 3) == 0) &&
+			(!(MNode->UsedStatus & A_BANK) || (MNode->Owner[0] != NULL)) &&
+			(!(MNode->UsedStatus & B_BANK) || (MNode->Owner[1] != NULL)));
+}
 
+/******************************************************************************
+ * Function Name: TNeedsCompacting
+ *
+ * Inputs       : hTexHeap.
+ * Outputs      : -
+ * Returns      : TRUE if TCompact might find something to move.
+ * Globals Used : -
+ * Description  : Cheap enough to call every frame. There is nothing to do
+ *				  with only one free block, or if nothing has been allocated
+ *				  or freed since TCompact last ran to completion.
+ *****************************************************************************/
+sgl_bool TNeedsCompacting(HTEXHEAP hTexHeap)
+{
+	TMALLOC_INDEX *Index = INDEX(hTexHeap);
 
-			/* unlink the node from the master list*/
+	return ((Index->FreeBlocks > 1) && (Index->Changes != Index->CompactedAt));
+}
 
-			FreeNode->MNode->Next=TempNode->Next;
-			if(TempNode->Next != NULL)
-				TempNode->Next->Prev=FreeNode->MNode;
+/******************************************************************************
+ * Function Name: TCompact
+ *
+ * Inputs       : hTexHeap.
+ *				  MaxBytes, roughly how much to move this time.
+ *				  pfnMoved, called for each block moved.
+ * Outputs      : -
+ * Returns      : The number of bytes (per bank) moved.
+ * Globals Used : MemoryRoot
+ * Description  : Slides movable blocks over the free blocks in front of
+ *				  them, so the free space gathers up against the next block
+ *				  that can't move (normally the TSP parameters). Each used
+ *				  block swaps places with the free block before it: the free
+ *				  block's node takes over the used block, and the used
+ *				  block's node becomes the free block behind it, merged with
+ *				  any free block after.
+ *
+ *				  At least one block is moved if any can be, however big.
+ *				  The texture memory must not be in use by the hardware.
+ *****************************************************************************/
+sgl_uint32 TCompact(HTEXHEAP hTexHeap, sgl_uint32 MaxBytes, TMOVE_CALLBACK pfnMoved)
+{
+	TMALLOC_INDEX *Index = INDEX(hTexHeap);
+	MNODE *Node, *Hole;
+	sgl_uint32 Moved = 0, HoleSize, OldAddress;
+	sgl_uint8 UsedStatus;
 
-			/* deallocate the MNode space */
+	for (Node = ROOT(hTexHeap)->Next; Node != NULL; Node = Node->Next)
+	{
+		Hole = Node->Prev;
 
-			PVROSFree(TempNode);
+		if (Hole->UsedStatus != 0 || Hole->BlockSize == 0 ||
+			(Hole->BlockSize & 3) != 0 || !TMovable(Node))
+		{
+			continue;
+		}
 
+		if (Moved != 0 && Moved + Node->BlockSize > MaxBytes)
+		{
+			/* leave the rest for next time */
+			return (Moved);
 		}
 
-		/* secondly, try coelescing FreeNode with the previous block */
+		HoleSize = Hole->BlockSize;
+		UsedStatus = Node->UsedStatus;
+		OldAddress = Node->MemoryAddress;
 
-		if(FreeNode->MNode->Prev != NULL && FreeNode->MNode->Prev->UsedStatus==0)
+		FreeRemove(Index, Hole);
+
+		if (UsedStatus != (A_BANK | B_BANK))
 		{
-			/* add the space togeather. */
+			BuddyRemove(Index, Node);
+		}
 
-			FreeNode->MNode->Prev->BlockSize += FreeNode->MNode->BlockSize;
+		/* the hole's node takes over the block */
 
-			/* unlink FreeNode from the free list */
+		Hole->BlockSize = Node->BlockSize;
+		Hole->UsedStatus = UsedStatus;
+		Hole->BlockType = Node->BlockType;
+		Hole->Owner[0] = Node->Owner[0];
+		Hole->Owner[1] = Node->Owner[1];
 
-			FreeNode->MNode->PrevFree->NextFree=FreeNode->MNode->NextFree;
-			if(FreeNode->MNode->NextFree != NULL)
-				FreeNode->MNode->NextFree->PrevFree=FreeNode->MNode->PrevFree;
+	#if TMALLOC_BACKWARDS
+		Hole->MemoryAddress = ROOT(hTexHeap)->MemorySize - Hole->MemoryOffset - Hole->BlockSize;
+		Node->MemoryOffset = Hole->MemoryOffset + Hole->BlockSize;
+	#else
+		Node->MemoryAddress = Hole->MemoryAddress + Hole->BlockSize;
+	#endif
 
-			/* unlink the node from the master list*/
+		if (UsedStatus != (A_BANK | B_BANK))
+		{
+			BuddyInsert(Index, Hole);
+		}
 
-			FreeNode->MNode->Prev->Next=FreeNode->MNode->Next;
-			if(FreeNode->MNode->Next != NULL)
-				FreeNode->MNode->Next->Prev=FreeNode->MNode->Prev;
+		/* and the block's node becomes the hole */
 
-			/* deallocate the MNode space */
+		Node->BlockSize = HoleSize;
+		Node->UsedStatus = 0;
+		Node->BlockType = NORMAL_BLOCK;
+		Node->Owner[0] = NULL;
+		Node->Owner[1] = NULL;
 
-			PVROSFree(FreeNode->MNode);
+		MergeNext(Index, Node);
+		FreeInsert(Index, Node);
 
-		}
-	}
+		Moved += Hole->BlockSize;
 
-	/* are we empty, and do we therefore need to reset the high water mark? */
-		
-	if (--((MNODE*)hTexHeap->pMemoryRoot)->AllocatedBlocks == 5)
-	{
-		DPF ((DBG_MESSAGE, "Setting high water mark: %d", ((MNODE*)hTexHeap->pMemoryRoot)->LowWaterMark));
-		
-		PVROSSetTSPHighWaterMark (hTexHeap, ((MNODE*)hTexHeap->pMemoryRoot)->LowWaterMark, TRUE);
+		pfnMoved(hTexHeap, Hole, OldAddress);
 	}
+
+	Index->CompactedAt = Index->Changes;
+
+	return (Moved);
 }
 
 /******************************************************************************
@@ -633,10 +924,19 @@ sgl_int32 CALL_CONV PVROSSetTSPHighWaterMark (PVRHANDLE TexHeap, sgl_int32 nRequ
 				{
 					DPF((DBG_MESSAGE,"Extending HWM: %d -> %d\n", nCurrentPos, nRequested));
 
+					/* both change size, so take them out of the index */
+
+					FreeRemove(INDEX(hTexHeap), MemWalk);
+					BuddyRemove(INDEX(hTexHeap), MemWalk->Next);
+
 					MemWalk->Next->BlockSize += nOffset;
 					MemWalk->Next->MemoryOffset -= nOffset;
 
 					MemWalk->BlockSize -= nOffset;
+
+					FreeInsert(INDEX(hTexHeap), MemWalk);
+					BuddyInsert(INDEX(hTexHeap), MemWalk->Next);
+					INDEX(hTexHeap)->Changes ++;
 					
 					nCurrentPos = nRequested;
 				}
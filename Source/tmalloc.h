@@ -90,6 +90,8 @@ typedef struct _MNODE {
 
 	sgl_int32	LowWaterMark;
 
+	void		*Owner[2];	/* texture in each bank that TCompact may move */
+
 } MNODE;
 
 typedef struct {
@@ -97,12 +99,50 @@ typedef struct {
 	int Status;	/* A_BANK ^ B_BANK ^ -1 */
 } MNODE_BLOCK;
 
+/*
+** Free blocks (UsedStatus 0) and free buddies (UsedStatus A_BANK or B_BANK)
+** are kept in segregated lists, one per size class. The first level is the
+** top bit of the size and the second splits each power of two into
+** TMALLOC_SL_COUNT steps. A bitmap of the non empty free lists finds a block
+** that fits without walking anything. NextFree/PrevFree link the free
+** lists, NextBuddy/PrevBuddy the buddy lists.
+*/
+#define TMALLOC_SL_BITS		4
+#define TMALLOC_SL_COUNT	(1 << TMALLOC_SL_BITS)
+#define TMALLOC_FL_COUNT	(32 - TMALLOC_SL_BITS + 1)
+
+typedef struct {
+	MNODE		*FreeLists[TMALLOC_FL_COUNT][TMALLOC_SL_COUNT];
+	MNODE		*BuddyLists[TMALLOC_FL_COUNT][TMALLOC_SL_COUNT];
+
+	sgl_uint32	FirstLevelMap;		/* bit per non empty FreeLists row */
+	sgl_uint32	SecondLevelMap[TMALLOC_FL_COUNT];
+
+	sgl_uint32	FreeBlocks;			/* blocks free in both banks */
+	sgl_uint32	BuddyBlocks;		/* blocks free in one bank */
+
+	sgl_uint32	Changes;			/* bumped by every TMalloc and TFree */
+	sgl_uint32	CompactedAt;		/* Changes when TCompact last finished */
+} TMALLOC_INDEX;
+
 #include "texapi.h"
 
+/*
+** Called by TCompact after it has moved a block. MNode is where the block
+** now is and OldAddress where it was; MNode->MemoryAddress is the new
+** address. The callback copies both banks of the block and points the
+** owners' MNODE_BLOCKs at MNode.
+*/
+typedef void (*TMOVE_CALLBACK)(HTEXHEAP hTexHeap, MNODE *MNode, sgl_uint32 OldAddress);
+
 void InitTextureMemory(sgl_uint32 TextureMemorySize, HTEXHEAP hTexHeap);
 void TMalloc(sgl_uint32 RequestSize, HTEXHEAP hTexHeap, MNODE_BLOCK *FreeNode);
 void TFree(MNODE_BLOCK *FreeNode, HTEXHEAP hTexHeap);
 sgl_int32 TSetHighWaterMark (HTEXHEAP hTexHeap, sgl_int32 nRequested);
+void TSetOwner(MNODE_BLOCK *Block, void *Owner);
+sgl_bool TMovable(MNODE *MNode);
+sgl_bool TNeedsCompacting(HTEXHEAP hTexHeap);
+sgl_uint32 TCompact(HTEXHEAP hTexHeap, sgl_uint32 MaxBytes, TMOVE_CALLBACK pfnMoved);
 
 
 #endif	/* __TMALLOC_H__	*/
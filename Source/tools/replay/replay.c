@@ -0,0 +1,554 @@
+/******************************************************************************
+ * Name : replay.c
+ * Title : capture replay tool
+ * Author :
+ * Created : 17/10/2026
+ *
+ * Copyright : 1995-2022 Imagination Technologies (c)
+ * License	 : MIT
+ *
+ * Description : Replays a capture written by the driver (see capture.h)
+ *				 through the simulator, without the application. The file
+ *				 is mapped rather than read, and each frame's texture
+ *				 pages, registers and parameters are loaded into the
+ *				 simulator's own stores in turn. Renders go through
+ *				 HWStartRender, and so through the simulator's render
+ *				 thread when the frame pipeline is deeper than 1. The
+ *				 time from starting each render to its fence retiring
+ *				 is printed, so a fixed set of captures can be used to
+ *				 benchmark and bisect changes to the renderer.
+ *
+ *				 replay [options] file.cap
+ *
+ *					-first n	start at frame n
+ *					-frames n	replay n frames (default all)
+ *					-repeat n	replay the frames n times
+ *					-bmp name	write each frame to name<frame>.bmp
+ *
+ * Platform : ANSI compatible, plus mmap or Win32 file mapping
+ *
+ * Modifications:-
+ * $Log: replay.c,v $
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../../sgl_defs.h"
+#include "../../hwinterf.h"
+#include "../../frmpipe.h"
+#include "../../capture.h"
+#include "../../simulat3/syscon.h"
+#include "../../simulat3/sabre.h"
+#include "../../simulat3/hwsabsim.h"
+#include "../../simulat3/smtexas.h"
+
+/*
+// The registers replay looks at, from pcx/hwregs.h
+*/
+#define PCX_FOGAMOUNT	0x006
+#define PCX_FOGCOL		0x00E
+#define PCX_CAMERA		0x00F
+
+/*
+// One frame of the capture, as pointers into the mapping
+*/
+typedef struct
+{
+	const CAPTURE_FRAME		*pFrame;
+	const CAPTURE_UINT32	*pRegs;
+	const CAPTURE_UINT32	*pISP;
+	const CAPTURE_UINT32	*pTSP;
+	const CAPTURE_UINT32	*pRegion;
+	CAPTURE_UINT32			u32ISPWords;
+	CAPTURE_UINT32			u32TSPWords;
+	CAPTURE_UINT32			u32RegionWords;
+
+	const unsigned char		*pFirstChunk;	/* for the texture pages */
+	const unsigned char		*pEnd;
+
+} REPLAY_FRAME;
+
+static const unsigned char	*pMap;
+static size_t				MapBytes;
+
+static const CAPTURE_HEADER	*pHeader;
+
+static REPLAY_FRAME			*pFrames = NULL;
+static int					nFrames = 0;
+
+/*
+// The simulator's ISP store. The TSP parameters live at the bottom of
+// texture memory, as on the hardware.
+*/
+static sgl_uint32			*pISPStore = NULL;
+static sgl_uint32			u32ISPStoreWords = 0;
+
+
+/**************************************************************************
+ * Function Name  : MapCapture
+ * Inputs         : pszFile
+ * Outputs        : pMap, MapBytes
+ * Returns        : TRUE if the file was mapped
+ * Description    : Maps the whole capture read only.
+ **************************************************************************/
+static sgl_bool MapCapture(const char *pszFile)
+{
+#if WIN32
+
+	HANDLE	hFile, hMapping;
+
+	hFile = CreateFile(pszFile, GENERIC_READ, FILE_SHARE_READ, NULL,
+					   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return FALSE;
+	}
+
+	MapBytes = (size_t) GetFileSize(hFile, NULL);
+
+	hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile);
+
+	if (hMapping == NULL)
+	{
+		return FALSE;
+	}
+
+	pMap = (const unsigned char *) MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping);
+
+	return (pMap != NULL);
+
+#else
+
+	struct stat	Stat;
+	int			fd;
+	void		*p;
+
+	fd = open(pszFile, O_RDONLY);
+
+	if (fd < 0)
+	{
+		return FALSE;
+	}
+
+	if (fstat(fd, &Stat) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	MapBytes = (size_t) Stat.st_size;
+
+	p = mmap(NULL, MapBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (p == MAP_FAILED)
+	{
+		return FALSE;
+	}
+
+	pMap = (const unsigned char *) p;
+
+	return TRUE;
+
+#endif
+}
+
+
+/**************************************************************************
+ * Function Name  : IndexFrames
+ * Inputs         : pMap, MapBytes
+ * Outputs        : pFrames, nFrames
+ * Returns        : FALSE if the file is not a capture we can read
+ * Description    : Checks the header and finds each frame's chunks. A
+ *					frame cut short by the end of the file is dropped.
+ **************************************************************************/
+static sgl_bool IndexFrames(void)
+{
+	const unsigned char	*p, *pLimit;
+	REPLAY_FRAME		Frame;
+	int					nAlloc = 0;
+	sgl_bool			bInFrame = FALSE;
+
+	pHeader = (const CAPTURE_HEADER *) pMap;
+
+	if ((MapBytes < sizeof(CAPTURE_HEADER)) ||
+		(pHeader->u32Magic != CAPTURE_MAGIC))
+	{
+		fprintf(stderr, "replay: not a capture file\n");
+		return FALSE;
+	}
+
+	if (pHeader->u32ByteOrder != CAPTURE_BYTE_ORDER)
+	{
+		fprintf(stderr, "replay: capture was made on a machine of the other byte order\n");
+		return FALSE;
+	}
+
+	if ((pHeader->u32Version > CAPTURE_VERSION) ||
+		(pHeader->u32HeaderBytes < sizeof(CAPTURE_HEADER)) ||
+		(pHeader->u32HeaderBytes > MapBytes))
+	{
+		fprintf(stderr, "replay: capture version %u is not supported\n",
+				(unsigned) pHeader->u32Version);
+		return FALSE;
+	}
+
+	p = pMap + pHeader->u32HeaderBytes;
+	pLimit = pMap + MapBytes;
+
+	memset(&Frame, 0, sizeof(Frame));
+
+	while (p + sizeof(CAPTURE_CHUNK) <= pLimit)
+	{
+		const CAPTURE_CHUNK		*pChunk = (const CAPTURE_CHUNK *) p;
+		const CAPTURE_UINT32	*pData = (const CAPTURE_UINT32 *) (pChunk + 1);
+		CAPTURE_UINT32			u32Words = pChunk->u32Bytes / sizeof(CAPTURE_UINT32);
+
+		if ((size_t) (pLimit - (const unsigned char *) pData) < pChunk->u32Bytes)
+		{
+			/* truncated */
+			break;
+		}
+
+		switch (pChunk->u32Tag)
+		{
+			case CAPTURE_TAG_FRAME:
+			{
+				memset(&Frame, 0, sizeof(Frame));
+				Frame.pFrame = (const CAPTURE_FRAME *) pData;
+				Frame.pFirstChunk = p;
+				bInFrame = TRUE;
+				break;
+			}
+
+			case CAPTURE_TAG_REGS:
+			{
+				if (u32Words >= CAPTURE_NUM_REGS)
+				{
+					Frame.pRegs = pData;
+				}
+				break;
+			}
+
+			case CAPTURE_TAG_ISP:
+			{
+				Frame.pISP = pData;
+				Frame.u32ISPWords = u32Words;
+				break;
+			}
+
+			case CAPTURE_TAG_TSP:
+			{
+				Frame.pTSP = pData;
+				Frame.u32TSPWords = u32Words;
+				break;
+			}
+
+			case CAPTURE_TAG_REGION:
+			{
+				Frame.pRegion = pData;
+				Frame.u32RegionWords = u32Words;
+				break;
+			}
+
+			case CAPTURE_TAG_END:
+			{
+				if (bInFrame && (Frame.pRegs != NULL))
+				{
+					Frame.pEnd = p;
+
+					if (nFrames == nAlloc)
+					{
+						nAlloc = nAlloc ? nAlloc * 2 : 64;
+						pFrames = realloc(pFrames, nAlloc * sizeof(REPLAY_FRAME));
+
+						if (pFrames == NULL)
+						{
+							fprintf(stderr, "replay: out of memory\n");
+							return FALSE;
+						}
+					}
+
+					pFrames[nFrames++] = Frame;
+				}
+
+				bInFrame = FALSE;
+				break;
+			}
+
+			default:
+			{
+				/* Tags from a later version, or texture pages (done at replay) */
+				break;
+			}
+		}
+
+		p = (const unsigned char *) pData + pChunk->u32Bytes;
+	}
+
+	return TRUE;
+}
+
+
+/**************************************************************************
+ * Function Name  : LoadWords
+ * Inputs         : pSrc, u32Words
+ * Outputs        : pDest
+ * Returns        : -
+ * Description    : Copies capture words into simulator words, which are
+ *					sgl_uint32 and so may be wider.
+ **************************************************************************/
+static void LoadWords(sgl_uint32 *pDest, const CAPTURE_UINT32 *pSrc, sgl_uint32 u32Words)
+{
+	sgl_uint32 k;
+
+	for (k = 0; k < u32Words; k++)
+	{
+		pDest[k] = pSrc[k];
+	}
+}
+
+
+/**************************************************************************
+ * Function Name  : LoadFrame
+ * Inputs         : pFrame
+ * Outputs        : -
+ * Returns        : FALSE if the frame's parameters don't fit
+ * Global Used    : textureMemory, the simulator's stores and registers
+ * Description    : Sets the simulator up to render one frame. The region
+ *					words go straight after the ISP words, as the
+ *					simulator finds them from the same store. The TSP
+ *					words go in after the texture pages, which may have
+ *					an older copy of them.
+ **************************************************************************/
+static sgl_bool LoadFrame(const REPLAY_FRAME *pFrame)
+{
+	const unsigned char	*p;
+	sgl_map_pixel		FogColour;
+	sgl_uint32			u32TexWords = TEXTURE_MEMORY_SIZE >> 1;
+	sgl_uint32			u32PageWords = pHeader->u32PageBytes / sizeof(CAPTURE_UINT32);
+	CAPTURE_UINT32		u32Fog;
+
+	/*
+	// Texture pages
+	*/
+	for (p = pFrame->pFirstChunk; p < pFrame->pEnd; )
+	{
+		const CAPTURE_CHUNK		*pChunk = (const CAPTURE_CHUNK *) p;
+		const CAPTURE_UINT32	*pData = (const CAPTURE_UINT32 *) (pChunk + 1);
+
+		if ((pChunk->u32Tag == CAPTURE_TAG_TEXTURE) &&
+			(pChunk->u32Bytes == sizeof(CAPTURE_UINT32) + pHeader->u32PageBytes))
+		{
+			sgl_uint32 u32First = pData[0] * u32PageWords;
+			sgl_uint32 k;
+
+			for (k = 0; (k < u32PageWords) && (u32First + k < u32TexWords); k++)
+			{
+				textureMemory[u32First + k] = pData[1 + k];
+			}
+		}
+
+		p = (const unsigned char *) pData + pChunk->u32Bytes;
+	}
+
+	/*
+	// Parameters
+	*/
+	if ((pFrame->u32ISPWords + pFrame->u32RegionWords > u32ISPStoreWords) ||
+		(pFrame->u32TSPWords > u32TexWords))
+	{
+		return FALSE;
+	}
+
+	LoadWords(pISPStore, pFrame->pISP, pFrame->u32ISPWords);
+	LoadWords(pISPStore + pFrame->u32ISPWords, pFrame->pRegion, pFrame->u32RegionWords);
+	LoadWords(textureMemory, pFrame->pTSP, pFrame->u32TSPWords);
+
+	/*
+	// Registers
+	*/
+	HWSetFogRegister(pFrame->pRegs[PCX_FOGAMOUNT]);
+	HWSetSabPtrRegister(pFrame->u32ISPWords, 0);
+
+	u32Fog = pFrame->pRegs[PCX_FOGCOL];
+
+	FogColour.red	= (unsigned char) (u32Fog >> 16);
+	FogColour.green	= (unsigned char) (u32Fog >> 8);
+	FogColour.blue	= (unsigned char) u32Fog;
+	FogColour.alpha	= 0;
+
+	TexasSetFogColour(FogColour);
+	TexasSetCFRScale((UINT16) pFrame->pRegs[PCX_CAMERA]);
+
+	return TRUE;
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char	*pszFile = NULL;
+	const char	*pszBMP = NULL;
+	int			nFirst = 0, nCount = -1, nRepeat = 1;
+	int			k, nPass, nRendered = 0;
+	double		fTotal = 0.0, fMin = 0.0, fMax = 0.0;
+
+	for (k = 1; k < argc; k++)
+	{
+		if (!strcmp(argv[k], "-first") && (k + 1 < argc))
+		{
+			nFirst = atoi(argv[++k]);
+		}
+		else if (!strcmp(argv[k], "-frames") && (k + 1 < argc))
+		{
+			nCount = atoi(argv[++k]);
+		}
+		else if (!strcmp(argv[k], "-repeat") && (k + 1 < argc))
+		{
+			nRepeat = atoi(argv[++k]);
+		}
+		else if (!strcmp(argv[k], "-bmp") && (k + 1 < argc))
+		{
+			pszBMP = argv[++k];
+		}
+		else if (argv[k][0] != '-')
+		{
+			pszFile = argv[k];
+		}
+		else
+		{
+			pszFile = NULL;
+			break;
+		}
+	}
+
+	if (pszFile == NULL)
+	{
+		fprintf(stderr, "usage: replay [-first n] [-frames n] [-repeat n] [-bmp name] file.cap\n");
+		return 1;
+	}
+
+	if (!MapCapture(pszFile))
+	{
+		fprintf(stderr, "replay: can't map %s\n", pszFile);
+		return 1;
+	}
+
+	if (!IndexFrames())
+	{
+		return 1;
+	}
+
+	if ((nFirst < 0) || (nFirst > nFrames))
+	{
+		nFirst = nFrames;
+	}
+
+	if ((nCount < 0) || (nFirst + nCount > nFrames))
+	{
+		nCount = nFrames - nFirst;
+	}
+
+	printf("%s: %d frames, replaying %d from %d\n", pszFile, nFrames, nCount, nFirst);
+
+	if (HWInitParamMem() != 0)
+	{
+		fprintf(stderr, "replay: can't set up the simulator\n");
+		return 1;
+	}
+
+	pISPStore = HWSimISPStore(&u32ISPStoreWords);
+
+	for (nPass = 0; nPass < nRepeat; nPass++)
+	{
+		/*
+		// Every texture page up to the first frame has to be loaded, so
+		// each pass starts from frame 0 and just doesn't render the early
+		// ones
+		*/
+		for (k = 0; k < nFirst + nCount; k++)
+		{
+			const REPLAY_FRAME	*pFrame = &pFrames[k];
+			clock_t				Start;
+			double				fMs;
+
+			if (!LoadFrame(pFrame))
+			{
+				fprintf(stderr, "replay: frame %u is too big for the simulator\n",
+						(unsigned) pFrame->pFrame->u32Frame);
+				return 1;
+			}
+
+			if (k < nFirst)
+			{
+				continue;
+			}
+
+			Start = clock();
+
+			HWStartRender();
+			FramePipeWait(FramePipeLastIssued());
+
+			fMs = (double) (clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+
+			printf("frame %5u%s: isp %7u tsp %7u region %7u words, %8.2f ms\n",
+				   (unsigned) pFrame->pFrame->u32Frame,
+				   (pFrame->pFrame->u32Flags & CAPTURE_FRAME_STRIP) ? " (strip)" : "",
+				   (unsigned) pFrame->u32ISPWords,
+				   (unsigned) pFrame->u32TSPWords,
+				   (unsigned) pFrame->u32RegionWords,
+				   fMs);
+
+			if (pszBMP != NULL)
+			{
+				char szName[512];
+
+				sprintf(szName, "%.500s%u.bmp", pszBMP, (unsigned) pFrame->pFrame->u32Frame);
+				TexasWriteBMP(szName);
+			}
+
+			fTotal += fMs;
+
+			if (!nRendered || (fMs < fMin))
+			{
+				fMin = fMs;
+			}
+
+			if (!nRendered || (fMs > fMax))
+			{
+				fMax = fMs;
+			}
+
+			nRendered++;
+		}
+	}
+
+	if (nRendered)
+	{
+		printf("%d renders: mean %.2f ms, min %.2f ms, max %.2f ms\n",
+			   nRendered, fTotal / nRendered, fMin, fMax);
+	}
+
+	return 0;
+}
+
+/*
+// END OF FILE
+*/
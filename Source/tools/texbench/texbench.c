@@ -0,0 +1,519 @@
+/******************************************************************************
+ * Name : texbench.c
+ * Title : texture conversion benchmark
+ * Author :
+ * Created : 17/10/2026
+ *
+ * Copyright : 1995-2022 Imagination Technologies (c)
+ * License	 : MIT
+ *
+ * Description : Times the texconv.c kernels TextureLoad converts with, for
+ *				 each of the source formats it converts, and checks every
+ *				 vector kernel gives the same pixels as the scalar one.
+ *				 The conversions are set up as GetTexConv in texapi.c sets
+ *				 them up. Prints millions of pixels a second per kernel.
+ *
+ *				 Then times the twiddled writes for each map size from
+ *				 8 by 8 up, against the unrolled writer texapi.c had
+ *				 before them, checking each against the bit
+ *				 interleaving texconv.h describes.
+ *
+ *				 texbench [options]
+ *
+ *					-size n		maps of n by n pixels (default 256)
+ *					-repeat n	convert each map n times (default 200)
+ *
+ * Platform : ANSI compatible
+ *
+ * Modifications:-
+ * $Log: texbench.c,v $
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../sgl.h"
+#include "../../texconv.h"
+
+#define KEY_COLOUR16	0x1234
+#define KEY_COLOUR32	0x00123456UL
+
+typedef enum
+{
+	BENCH_565_TO_555,
+	BENCH_1555_TO_4444,
+	BENCH_555_KEY_TO_4444,
+	BENCH_565_KEY_TO_4444,
+	BENCH_888_TO_555,
+	BENCH_8888_TO_4444,
+	BENCH_8888BGR_TO_4444,
+	BENCH_888_KEY_TO_1555,
+	BENCH_FORMATS
+
+} BENCH_FORMAT;
+
+static const char *pszFormatName[BENCH_FORMATS] =
+{
+	"565 to 555",
+	"1555 to 4444",
+	"555 key to 4444",
+	"565 key to 4444",
+	"888 to 555",
+	"8888 to 4444",
+	"8888 BGR to 4444",
+	"888 key to 1555"
+};
+
+/*
+// The conversion for a format, as texapi.c does it
+*/
+static void SetUpFormat (TEXCONV *pConv, BENCH_FORMAT eFormat)
+{
+	switch (eFormat)
+	{
+		case BENCH_565_TO_555:
+			TexConvInit (pConv, 16);
+			TexConvAddField (pConv, 0xFFC0, 1, 0);
+			TexConvAddField (pConv, 0x001F, 0, 0);
+			break;
+
+		case BENCH_1555_TO_4444:
+		case BENCH_555_KEY_TO_4444:
+			TexConvInit (pConv, 16);
+			TexConvAddField (pConv, 0x7800, 3, 0);
+			TexConvAddField (pConv, 0x03C0, 2, 0);
+			TexConvAddField (pConv, 0x001E, 1, 0);
+
+			if (eFormat == BENCH_1555_TO_4444)
+			{
+				TexConvSetTest (pConv, 0x8000, 0x8000, 0xF000);
+			}
+			else
+			{
+				TexConvSetTest (pConv, 0xFFFFFFFF, KEY_COLOUR16, 0xF000);
+			}
+			break;
+
+		case BENCH_565_KEY_TO_4444:
+			TexConvInit (pConv, 16);
+			TexConvAddField (pConv, 0xF000, 4, 0);
+			TexConvAddField (pConv, 0x0780, 3, 0);
+			TexConvAddField (pConv, 0x001E, 1, 0);
+			TexConvSetTest (pConv, 0xFFFFFFFF, KEY_COLOUR16, 0xF000);
+			break;
+
+		case BENCH_888_TO_555:
+		case BENCH_888_KEY_TO_1555:
+			TexConvInit (pConv, 32);
+			TexConvAddField (pConv, 0x00F80000, 9, 0);
+			TexConvAddField (pConv, 0x0000F800, 6, 0);
+			TexConvAddField (pConv, 0x000000F8, 3, 0);
+
+			if (eFormat == BENCH_888_KEY_TO_1555)
+			{
+				TexConvSetTest (pConv, 0xFFFFFFFF, KEY_COLOUR32, 0x8000);
+			}
+			break;
+
+		case BENCH_8888_TO_4444:
+			TexConvInit (pConv, 32);
+			TexConvAddField (pConv, 0xF0000000, 16, 0);
+			TexConvAddField (pConv, 0x00F00000, 12, 0);
+			TexConvAddField (pConv, 0x0000F000, 8, 0);
+			TexConvAddField (pConv, 0x000000F0, 4, 0);
+			break;
+
+		default:
+			TexConvInit (pConv, 32);
+			TexConvAddField (pConv, 0xF0000000, 16, 0);
+			TexConvAddField (pConv, 0x00F00000, 20, 0);
+			TexConvAddField (pConv, 0x0000F000, 8, 0);
+			TexConvAddField (pConv, 0x000000F0, 0, 4);
+			break;
+	}
+}
+
+/*
+// Random source pixels, with some set to the colour key
+*/
+static void FillSource (TEXCONV_PIXEL32 *pSrc32, sgl_uint16 *pSrc16, int nPixels)
+{
+	int k;
+
+	srand (1);
+
+	for (k = 0; k < nPixels; k++)
+	{
+		TEXCONV_PIXEL32 Pixel = ((TEXCONV_PIXEL32) rand () << 16) ^ (TEXCONV_PIXEL32) rand ();
+
+		if ((rand () & 7) == 0)
+		{
+			pSrc32[k] = KEY_COLOUR32;
+			pSrc16[k] = KEY_COLOUR16;
+		}
+		else
+		{
+			pSrc32[k] = Pixel;
+			pSrc16[k] = (sgl_uint16) Pixel;
+		}
+	}
+}
+
+/*
+// Converts the map nRepeat times and returns millions of pixels a second
+*/
+static double TimeKernel (TEXCONVFN pfnConvert, const TEXCONV *pConv, const void *pSrc,
+						  sgl_uint16 *pDst, int nPixels, int nRepeat)
+{
+	clock_t	Start;
+	double	fSecs;
+	int		k;
+
+	Start = clock ();
+
+	for (k = 0; k < nRepeat; k++)
+	{
+		pfnConvert (pConv, pSrc, pDst, nPixels);
+	}
+
+	fSecs = (double) (clock () - Start) / CLOCKS_PER_SEC;
+
+	if (fSecs <= 0.0)
+	{
+		return (0.0);
+	}
+
+	return ((double) nPixels * nRepeat / fSecs / 1.0e6);
+}
+
+/*
+// The unrolled C writer texapi.c had before the twiddling kernels: each
+// 16x16 block as four 8x8 blocks, each of those as eight runs of four
+// words, with the 16x16 blocks taken in twiddled order by nested loops.
+*/
+#define OLD_PAIR(pDst, k, pSrc, nPitch) \
+	((pDst)[k] = ((TEXCONV_PIXEL32) (pSrc)[0] << 16) | (pSrc)[nPitch])
+
+#define OLD_FOUR_PAIRS(pDst, pSrc, nPitch) \
+	OLD_PAIR (pDst, 0, pSrc, nPitch); \
+	OLD_PAIR (pDst, 1, (pSrc) + 1, nPitch); \
+	OLD_PAIR (pDst, 2, (pSrc) + 2 * (nPitch), nPitch); \
+	OLD_PAIR (pDst, 3, (pSrc) + 2 * (nPitch) + 1, nPitch)
+
+static TEXCONV_PIXEL32 *OldWrite8x8 (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc, int nPitch)
+{
+	int nPitch4 = nPitch << 2;
+
+	OLD_FOUR_PAIRS (pDst, pSrc, nPitch);
+	OLD_FOUR_PAIRS (pDst + 4, pSrc + 2, nPitch);
+	OLD_FOUR_PAIRS (pDst + 8, pSrc + nPitch4, nPitch);
+	OLD_FOUR_PAIRS (pDst + 12, pSrc + nPitch4 + 2, nPitch);
+	OLD_FOUR_PAIRS (pDst + 16, pSrc + 4, nPitch);
+	OLD_FOUR_PAIRS (pDst + 20, pSrc + 6, nPitch);
+	OLD_FOUR_PAIRS (pDst + 24, pSrc + nPitch4 + 4, nPitch);
+	OLD_FOUR_PAIRS (pDst + 28, pSrc + nPitch4 + 6, nPitch);
+
+	return (pDst + 32);
+}
+
+static void OldTwiddle (TEXCONV_PIXEL32 *pDst, const sgl_uint16 *pSrc,
+						int nPitch, int nWidth,
+						sgl_uint32 AndMask, sgl_uint32 XorMask)
+{
+	int nIndex[4][4];
+	int nCount[4];
+	int nLevel, n128, n64, n32, n16;
+	int nPitch8 = nPitch << 3;
+
+	/* the masks went into the assembler versions only */
+	(void) AndMask;
+	(void) XorMask;
+
+	if (nWidth == 8)
+	{
+		OldWrite8x8 (pDst, pSrc, nPitch);
+		return;
+	}
+
+	for (nLevel = 0; nLevel < 4; nLevel++)
+	{
+		int nSize = 16 << nLevel;
+
+		nIndex[nLevel][0] = 0;
+		nIndex[nLevel][1] = nSize * nPitch;
+		nIndex[nLevel][2] = nSize;
+		nIndex[nLevel][3] = nSize * nPitch + nSize;
+
+		nCount[nLevel] = (nWidth > nSize) ? 4 : 1;
+	}
+
+	for (n128 = 0; n128 < nCount[3]; n128++)
+	{
+		for (n64 = 0; n64 < nCount[2]; n64++)
+		{
+			for (n32 = 0; n32 < nCount[1]; n32++)
+			{
+				for (n16 = 0; n16 < nCount[0]; n16++)
+				{
+					const sgl_uint16 *pBlock = pSrc + nIndex[3][n128] + nIndex[2][n64] +
+												nIndex[1][n32] + nIndex[0][n16];
+
+					pDst = OldWrite8x8 (pDst, pBlock, nPitch);
+					pDst = OldWrite8x8 (pDst, pBlock + nPitch8, nPitch);
+					pDst = OldWrite8x8 (pDst, pBlock + 8, nPitch);
+					pDst = OldWrite8x8 (pDst, pBlock + nPitch8 + 8, nPitch);
+				}
+			}
+		}
+	}
+}
+
+/*
+// The bits of n spread out to the even bits
+*/
+static sgl_uint32 SpreadBits (sgl_uint32 n)
+{
+	sgl_uint32	Spread = 0;
+	int			k;
+
+	for (k = 0; k < 16; k++)
+	{
+		Spread |= ((n >> k) & 1) << (2 * k);
+	}
+
+	return (Spread);
+}
+
+/*
+// Twiddles the map nRepeat times and returns millions of pixels a second,
+// or -1 if the words aren't where texconv.h says they go
+*/
+static double TimeTwiddle (TEXTWIDDLEFN pfnTwiddle, const sgl_uint16 *pSrc, int nWidth,
+						   TEXCONV_PIXEL32 *pDst, int nRepeat)
+{
+	clock_t	Start;
+	double	fSecs;
+	int		k, x, y;
+
+	Start = clock ();
+
+	for (k = 0; k < nRepeat; k++)
+	{
+		pfnTwiddle (pDst, pSrc, nWidth, nWidth, 0xFFFFFFFF, 0);
+	}
+
+	fSecs = (double) (clock () - Start) / CLOCKS_PER_SEC;
+
+	for (y = 0; y < nWidth; y += 2)
+	{
+		for (x = 0; x < nWidth; x++)
+		{
+			TEXCONV_PIXEL32 Word = ((TEXCONV_PIXEL32) pSrc[y * nWidth + x] << 16) |
+								   pSrc[(y + 1) * nWidth + x];
+
+			if (pDst[SpreadBits (x) | (SpreadBits (y / 2) << 1)] != Word)
+			{
+				return (-1.0);
+			}
+		}
+	}
+
+	if (fSecs <= 0.0)
+	{
+		return (0.0);
+	}
+
+	return ((double) nWidth * nWidth * nRepeat / fSecs / 1.0e6);
+}
+
+int main (int argc, char *argv[])
+{
+	int				nSize = 256, nRepeat = 200;
+	int				nPixels, nKernels, k, nLanes;
+	int				nKernelLanes[3];
+	TEXCONVFN		pfnKernel[3];
+	TEXCONV_PIXEL32	*pSrc32;
+	sgl_uint16		*pSrc16, *pRef, *pOut;
+	BENCH_FORMAT	eFormat;
+	int				nFailed = 0;
+
+	for (k = 1; k < argc; k++)
+	{
+		if (!strcmp (argv[k], "-size") && (k + 1 < argc))
+		{
+			nSize = atoi (argv[++k]);
+		}
+		else if (!strcmp (argv[k], "-repeat") && (k + 1 < argc))
+		{
+			nRepeat = atoi (argv[++k]);
+		}
+		else
+		{
+			fprintf (stderr, "usage: texbench [-size n] [-repeat n]\n");
+			return 1;
+		}
+	}
+
+	if ((nSize < 1) || (nRepeat < 1))
+	{
+		fprintf (stderr, "texbench: bad size or repeat\n");
+		return 1;
+	}
+
+	/*
+	// The scalar kernel, then each wider one the CPU runs
+	*/
+	nKernels = 0;
+
+	for (nLanes = 1; nLanes <= TEXCONV_MAX_LANES; nLanes *= 2)
+	{
+		TEXCONVFN	pfnConvert;
+		int			nGot = TexConvSelect (nLanes, &pfnConvert);
+
+		if ((nKernels == 0) || (nGot > nKernelLanes[nKernels - 1]))
+		{
+			pfnKernel[nKernels] = pfnConvert;
+			nKernelLanes[nKernels] = nGot;
+			nKernels++;
+		}
+	}
+
+	nPixels = nSize * nSize;
+
+	pSrc32 = malloc (nPixels * sizeof (TEXCONV_PIXEL32));
+	pSrc16 = malloc (nPixels * sizeof (sgl_uint16));
+	pRef = malloc (nPixels * sizeof (sgl_uint16));
+	pOut = malloc (nPixels * sizeof (sgl_uint16));
+
+	if (!pSrc32 || !pSrc16 || !pRef || !pOut)
+	{
+		fprintf (stderr, "texbench: out of memory\n");
+		return 1;
+	}
+
+	FillSource (pSrc32, pSrc16, nPixels);
+
+	printf ("%d by %d maps, %d times, in Mpixels/s\n\n", nSize, nSize, nRepeat);
+	printf ("%-18s", "format");
+
+	for (k = 0; k < nKernels; k++)
+	{
+		printf ("  %7d lane%s", nKernelLanes[k], (nKernelLanes[k] == 1) ? " " : "s");
+	}
+
+	printf ("\n");
+
+	for (eFormat = 0; eFormat < BENCH_FORMATS; eFormat++)
+	{
+		TEXCONV		Conv;
+		const void	*pSrc;
+
+		SetUpFormat (&Conv, eFormat);
+
+		pSrc = (Conv.nSrcBits == 16) ? (const void *) pSrc16 : (const void *) pSrc32;
+
+		TexConvScalar (&Conv, pSrc, pRef, nPixels);
+
+		printf ("%-18s", pszFormatName[eFormat]);
+
+		for (k = 0; k < nKernels; k++)
+		{
+			double fRate = TimeKernel (pfnKernel[k], &Conv, pSrc, pOut, nPixels, nRepeat);
+
+			if (memcmp (pOut, pRef, nPixels * sizeof (sgl_uint16)))
+			{
+				printf ("  %13s", "MISMATCH");
+				nFailed++;
+			}
+			else
+			{
+				printf ("  %13.1f", fRate);
+			}
+		}
+
+		printf ("\n");
+	}
+
+	/*
+	// The twiddled writes, on the 16 bit source pixels: the old writer,
+	// the scalar kernel and the vector one if the CPU has it
+	*/
+	{
+		TEXTWIDDLEFN	pfnTwiddle[3];
+		const char		*pszTwiddleName[3];
+		int				nTwiddlers = 0, nWidth;
+		TEXCONV_PIXEL32	*pWords = malloc (256 * 256 / 2 * sizeof (TEXCONV_PIXEL32));
+		sgl_uint16		*pMap = malloc (256 * 256 * sizeof (sgl_uint16));
+
+		if (!pWords || !pMap)
+		{
+			fprintf (stderr, "texbench: out of memory\n");
+			return 1;
+		}
+
+		for (k = 0; k < 256 * 256; k++)
+		{
+			pMap[k] = pSrc16[k % nPixels];
+		}
+
+		pfnTwiddle[nTwiddlers] = OldTwiddle;
+		pszTwiddleName[nTwiddlers++] = "old";
+
+		TexTwiddleSelect (1, &pfnTwiddle[nTwiddlers]);
+		pszTwiddleName[nTwiddlers++] = "scalar";
+
+		if (TexTwiddleSelect (TEXCONV_MAX_LANES, &pfnTwiddle[nTwiddlers]) > 1)
+		{
+			pszTwiddleName[nTwiddlers++] = "vector";
+		}
+
+		printf ("\ntwiddling, in Mpixels/s\n\n%-18s", "map");
+
+		for (k = 0; k < nTwiddlers; k++)
+		{
+			printf ("  %13s", pszTwiddleName[k]);
+		}
+
+		printf ("\n");
+
+		for (nWidth = TEXTWIDDLE_MIN_WIDTH; nWidth <= 256; nWidth *= 2)
+		{
+			/* about the same number of pixels as the conversions */
+			int nMapRepeat = (int) (((double) nPixels * nRepeat) / (nWidth * nWidth)) + 1;
+
+			printf ("%3d by %-11d", nWidth, nWidth);
+
+			for (k = 0; k < nTwiddlers; k++)
+			{
+				double fRate = TimeTwiddle (pfnTwiddle[k], pMap, nWidth, pWords, nMapRepeat);
+
+				if (fRate < 0.0)
+				{
+					printf ("  %13s", "MISMATCH");
+					nFailed++;
+				}
+				else
+				{
+					printf ("  %13.1f", fRate);
+				}
+			}
+
+			printf ("\n");
+		}
+
+		free (pWords);
+		free (pMap);
+	}
+
+	free (pSrc32);
+	free (pSrc16);
+	free (pRef);
+	free (pOut);
+
+	return (nFailed ? 1 : 0);
+}
+
+/* texbench.c */
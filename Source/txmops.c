@@ -360,6 +360,8 @@
 #include "sglmem.h"
 #include "hwinterf.h"
 #include "texapi.h"
+#include "profile.h"
+#include "frmpipe.h"
 
 #if DOS32
 #include "hwtexas.h"
@@ -2428,11 +2430,11 @@ static TEXTUREFORMAT TexFormat888[2] =
 
 static TEXTUREFORMAT TexFormat[5] =
 {  /* Flags, FourCC, BitDepth, KeyColour, Red, Green, Blue, Alpha */
-	{TF_HWSUPPORT | TF_RGB | TF_CANMIPMAP, 0, 16, 0, 0x7C00, 0x03E0, 0x001F, 0x0000}, 
-	{TF_HWSUPPORT | TF_RGB | TF_CANMIPMAP, 0, 16, 0, 0x7C00, 0x03E0, 0x001F, 0x0000},
-	{TF_PALETTISED8, 0, 8, 0, 0, 0, 0, 0},
-	{TF_TRANSLUCENT | TF_HWSUPPORT | TF_OGLALPHA | TF_RGB | TF_CANMIPMAP, 0, 16, 0, 0x0F00, 0x00F0, 0x000F, 0xF000},
-	{TF_TRANSLUCENT | TF_HWSUPPORT | TF_OGLALPHA | TF_RGB | TF_CANMIPMAP, 0 ,16, 0, 0x0F00, 0x00F0, 0x000F, 0xF000}
+	{TF_HWSUPPORT | TF_RGB | TF_CANMIPMAP | TF_MOVABLE, 0, 16, 0, 0x7C00, 0x03E0, 0x001F, 0x0000}, 
+	{TF_HWSUPPORT | TF_RGB | TF_CANMIPMAP | TF_MOVABLE, 0, 16, 0, 0x7C00, 0x03E0, 0x001F, 0x0000},
+	{TF_PALETTISED8 | TF_MOVABLE, 0, 8, 0, 0, 0, 0, 0},
+	{TF_TRANSLUCENT | TF_HWSUPPORT | TF_OGLALPHA | TF_RGB | TF_CANMIPMAP | TF_MOVABLE, 0, 16, 0, 0x0F00, 0x00F0, 0x000F, 0xF000},
+	{TF_TRANSLUCENT | TF_HWSUPPORT | TF_OGLALPHA | TF_RGB | TF_CANMIPMAP | TF_MOVABLE, 0 ,16, 0, 0x0F00, 0x00F0, 0x000F, 0xF000}
 };
 
 static sgl_uint32 MapSize[4] = {32,64,128,256};
@@ -3095,6 +3097,8 @@ extern int CALL_CONV sgl_create_texture ( sgl_map_types map_type,
 										  const sgl_intermediate_map *pixel_data,
 										  const	sgl_intermediate_map *filtered_maps[] )
 {
+	DlMarkEdited ();
+
 	/*	
 	**	Initialise sgl if this hasn't yet been done		
 	*/
@@ -3135,6 +3139,8 @@ extern void CALL_CONV sgl_direct_set_texture_type( int Name,
 {
 	HTEXTURE hTex;
 
+	DlMarkEdited ();
+
 	if((NewMapType < sgl_map_16bit) || (NewMapType > sgl_map_trans16_mm))
 	{
 		DPFDEV((DBG_ERROR,"sgl_create_texture: bad NewMapType"));
@@ -3183,6 +3189,8 @@ extern int CALL_CONV sgl_direct_create_texture( sgl_map_types map_type,
 	HTEXTURE		hTex;
 	TEXTURESPEC 	TextureSpec;
 	int 			name;
+
+	DlMarkEdited ();
 	
 	if((map_type < sgl_map_16bit) || (map_type > sgl_map_trans16_mm))
 	{
@@ -3332,6 +3340,8 @@ extern void CALL_CONV sgl_direct_set_texture( int TextureName,
 	sgl_map_types map_type;
 	TPRIVATEDATA *pTPD;
 
+	DlMarkEdited ();
+
 	/*	
 	**	Initialise sgl if this hasn't yet been done		
 	*/
@@ -3775,6 +3785,8 @@ extern void CALL_CONV sgl_set_texture ( int texture_name,
 	TEXTURESOURCE TextureSource;
 	sgl_bool Translucent;
 
+	DlMarkEdited ();
+
 	/*	
 	**	Initialise sgl if this hasn't yet been done		
 	*/
@@ -4016,6 +4028,8 @@ extern int CALL_CONV sgl_set_texture_extended (
 
 	sgl_bool Translucent;
 
+	DlMarkEdited ();
+
 	/*	
 	**	Initialise sgl if this hasn't yet been done		
 	*/
@@ -4273,6 +4287,8 @@ extern void  CALL_CONV sgl_delete_texture ( int texture_name )
 	HTEXTURE hTex;
 	int	type;
 
+	DlMarkEdited ();
+
 	/*	
 	**	Initialise sgl if this hasn't yet been done		
 	*/
@@ -4416,6 +4432,8 @@ int CALL_CONV sgl_create_cached_texture( long user_id )
 	int name;
 	CACHED_TEXT_STRUCT_TYPE * pNextFree;
 
+	DlMarkEdited ();
+
 	/*
 	//initialise the system if need be
 	*/
@@ -4538,6 +4556,8 @@ void CALL_CONV sgl_load_cached_texture ( int name,
 	CACHED_TEXT_STRUCT_TYPE * pCachedTex;
 	
 	int internalTextName;
+
+	DlMarkEdited ();
 	
 	if((map_type < sgl_map_16bit) || (map_type > sgl_map_trans16_mm))
 	{
@@ -4651,6 +4671,8 @@ void CALL_CONV sgl_unload_cached_texture( int name )
 {
 	int itemType;
 	CACHED_TEXT_STRUCT_TYPE * pCachedTex;
+
+	DlMarkEdited ();
 	
 	/*
 	//initialise the system if need be
@@ -4853,6 +4875,9 @@ void CALL_CONV sgl_register_texture_callback(
 		UserTexDataSize			= array_size;
 		SglError(sgl_no_err);
 	}
+
+	/* A kept frame was built without this callback */
+	DlMarkEdited ();
 }
 
 
@@ -5062,6 +5087,88 @@ extern void CALL_CONV sgl_get_free_texture_mem_info (
 } /* sgl_get_free_texture_mem_info */
 
 
+/******************************************************************************
+ * Function Name: sgl_compact_texture_memory
+ *
+ * Inputs       : max_bytes: roughly how much to move, 0 to just ask.
+ * Outputs      : -
+ * Returns      : the number of bytes moved, or with max_bytes 0, non zero
+ *				  if there is anything to move.
+ * Globals Used : dlUserGlobals.u32TextureMoveCount
+ *
+ * Description  : Moves the textures SGL created so that the free texture
+ *				  memory is in fewer pieces. Anything rendering is waited
+ *				  for first, as it may be reading the textures.
+ *****************************************************************************/
+
+extern unsigned long CALL_CONV sgl_compact_texture_memory (unsigned long max_bytes)
+{
+	sgl_uint32 Moved;
+
+	SglError(sgl_no_err);
+
+	if (gpTextureIF->pfnTextureCompact(gHLogicalDev->TexHeap, 0) == 0)
+	{
+		return (0);
+	}
+
+	if (max_bytes == 0)
+	{
+		return (1);
+	}
+
+	FramePipeWait (FramePipeLastIssued ());
+
+	Moved = gpTextureIF->pfnTextureCompact(gHLogicalDev->TexHeap, (sgl_uint32) max_bytes);
+
+	if (Moved != 0)
+	{
+		/* control words held by materials and retained frames are stale */
+		dlUserGlobals.u32TextureMoveCount++;
+		DlMarkEdited ();
+	}
+
+	return (Moved);
+
+} /* sgl_compact_texture_memory */
+
+
+/******************************************************************************
+ * Function Name: CompactTexturesIdle
+ *
+ * Inputs       : -
+ * Outputs      : -
+ * Returns      : TRUE if any textures moved
+ * Globals Used : -
+ *
+ * Description  : Called by sgl_render on frames where nothing has changed.
+ *				  Moves up to [Texture] CompactBytes of sgl.ini (default 0,
+ *				  which turns it off) of textures.
+ *****************************************************************************/
+
+sgl_bool CompactTexturesIdle (void)
+{
+	static int nCompactBytes = -1;
+
+	if (nCompactBytes < 0)
+	{
+		nCompactBytes = SglReadPrivateProfileInt ("Texture", "CompactBytes", 0, "sgl.ini");
+
+		if (nCompactBytes < 0)
+		{
+			nCompactBytes = 0;
+		}
+	}
+
+	if (nCompactBytes == 0)
+	{
+		return (FALSE);
+	}
+
+	return (sgl_compact_texture_memory ((unsigned long) nCompactBytes) != 0);
+}
+
+
 /******************************************************************************
  * Function Name: sgl_get_free_texture_mem
  *
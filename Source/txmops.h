@@ -134,6 +134,20 @@ unsigned long Twid(int x,int y);
  *****************************************************************************/
 void SetupOverflowArea(sgl_uint32 Size);
 
+/******************************************************************************
+ * Function Name: CompactTexturesIdle
+ *
+ * Inputs       : -
+ * Outputs      : -
+ * Returns      : TRUE if any textures moved
+ * Globals Used : -
+ *
+ * Description  : Called by sgl_render on frames where nothing has changed,
+ *				  to spend them moving textures together. Does nothing
+ *				  unless [Texture] CompactBytes in sgl.ini is set.
+ *****************************************************************************/
+sgl_bool CompactTexturesIdle (void);
+
 
 #endif /* _TXMOPS_H_ */
 /*
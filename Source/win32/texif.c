@@ -123,6 +123,7 @@ typedef struct texheapstruct
 	TEXAPI_IF TexIF;
 //	MNODE_BLOCK MemBlock[8];
 	MNODE_BLOCK MemBlock[10];
+	TMALLOC_INDEX FreeIndex;
 } TexHeapStruct;
 
 static TexHeapStruct TexHeaps[NO_OF_TEX_HEAPS] = {0}; 
@@ -500,16 +501,13 @@ void CALL_CONV TextureGetFreeMemoryInfo( HTEXHEAP hTexHeap,
 									  	 sgl_texture_mem_info *pInfo )
 {
 	MNODE *MemWalk;
+	sgl_uint32 u32FreeBlocks, u32MovableMem, u32Largest, u32Total;
 
 	if (pInfo == NULL) 
 	{
 		return;
 	}
 
-	/*
-	// BUDDY MEMORY
-	*/
-
 	/*
 	// Note: If we add any new members to the structure we must read
 	// pInfo->u32StructSize, and not overwrite application memory beyond the
@@ -530,68 +528,78 @@ void CALL_CONV TextureGetFreeMemoryInfo( HTEXHEAP hTexHeap,
 	pInfo->free128_16bit_mipmap = 0;
 	pInfo->free256_16bit_mipmap = 0;
 
-	if ( (((MNODE*)hTexHeap->pMemoryRoot)->UsedStatus == A_BANK) || 
-		 (((MNODE*)hTexHeap->pMemoryRoot)->UsedStatus == B_BANK) )
-	{
-		AddBuddyInfo(pInfo,((MNODE*)hTexHeap->pMemoryRoot)->BlockSize);
-	}
+	pInfo->u32OtherFreeMem = 0;
+	pInfo->u32LargestOtherFreeMem = 0;
 
-	MemWalk = hTexHeap->pMemoryRoot;
+	u32FreeBlocks = 0;
+	u32MovableMem = 0;
+	u32Largest = 0;
+	u32Total = 0;
 
-	while (MemWalk->NextBuddy != NULL)
+	/*
+	// One walk of every block, in address order. A free block is free in
+	// both banks, a buddy in one of them.
+	*/
+	for (MemWalk = hTexHeap->pMemoryRoot; MemWalk != NULL; MemWalk = MemWalk->Next)
 	{
-		MemWalk = MemWalk->NextBuddy;
-
-		AddBuddyInfo(pInfo,MemWalk->BlockSize);
-		
-		ASSERT(MemWalk->PrevBuddy->NextBuddy == MemWalk);
-
-		if (MemWalk->NextBuddy != NULL)
+		if (MemWalk->BlockSize == 0)
 		{
-			ASSERT(MemWalk->NextBuddy->PrevBuddy == MemWalk);
-		}     
-	}
+			continue;
+		}
 
-	/*
-	// NON-BUDDY MEMORY
-	*/
+		if (MemWalk->UsedStatus == 0)
+		{
+			pInfo->u32OtherFreeMem += MemWalk->BlockSize*2;
 
-	pInfo->u32OtherFreeMem = 0;
-	pInfo->u32LargestOtherFreeMem = 0;
+			if (MemWalk->BlockSize > pInfo->u32LargestOtherFreeMem)
+			{
+				pInfo->u32LargestOtherFreeMem = MemWalk->BlockSize;
+			}
 
-	if ( ((MNODE*)hTexHeap->pMemoryRoot)->UsedStatus == 0 )
-	{
-		pInfo->u32OtherFreeMem = (((MNODE*)hTexHeap->pMemoryRoot)->BlockSize) << 1;
-		pInfo->u32LargestOtherFreeMem = ((MNODE*)hTexHeap->pMemoryRoot)->BlockSize;
-	}
+			u32FreeBlocks += 2;
+			u32Total += MemWalk->BlockSize*2;
+		}
+		else if ((MemWalk->UsedStatus == A_BANK) || (MemWalk->UsedStatus == B_BANK))
+		{
+			AddBuddyInfo(pInfo,MemWalk->BlockSize);
 
-	MemWalk = hTexHeap->pMemoryRoot;
+			u32FreeBlocks++;
+			u32Total += MemWalk->BlockSize;
+		}
 
-	while (MemWalk->NextFree != NULL)
-	{
-		MemWalk = MemWalk->NextFree;
+		if ((MemWalk->UsedStatus != 0) && TMovable(MemWalk))
+		{
+			u32MovableMem += (MemWalk->UsedStatus == 3) ? MemWalk->BlockSize*2 : MemWalk->BlockSize;
+		}
 
-		pInfo->u32OtherFreeMem += MemWalk->BlockSize*2;
+		if ((MemWalk->UsedStatus == 0) && (MemWalk->BlockSize*2 > u32Largest))
+		{
+			u32Largest = MemWalk->BlockSize*2;
+		}
+		else if ((MemWalk->UsedStatus != 3) && (MemWalk->BlockSize > u32Largest))
+		{
+			u32Largest = MemWalk->BlockSize;
+		}
 
-		if (MemWalk->BlockSize > pInfo->u32LargestOtherFreeMem)
+		if (MemWalk->Next != NULL)
 		{
-			pInfo->u32LargestOtherFreeMem = MemWalk->BlockSize;
+			ASSERT(MemWalk->Next->Prev == MemWalk);
 		}
+	}
 
-		/*
-		// Ensure the 'free' block has not been used.
-		*/
-		ASSERT(MemWalk->UsedStatus == 0);
+	if (pInfo->u32StructSize >= sizeof (sgl_texture_mem_info))
+	{
+		pInfo->u32FreeBlocks = u32FreeBlocks;
+		pInfo->u32MovableMem = u32MovableMem;
 
-		ASSERT(MemWalk->PrevFree->NextFree == MemWalk);
+		/* share of the free memory not in the largest piece */
+		pInfo->u32Fragmentation = 0;
 
-		if (MemWalk->NextFree != NULL)
+		if (u32Total != 0)
 		{
-			ASSERT(MemWalk->NextFree->PrevFree == MemWalk);
+			pInfo->u32Fragmentation = (sgl_uint32) (((double) (u32Total - u32Largest) * 100.0) / (double) u32Total);
 		}
-
-	} /* while (MemWalk->NextFree != NULL) */
-
+	}
 }
 
 /*****************************************************************************/
@@ -618,6 +626,7 @@ sgl_uint32 CALL_CONV PVROSGetTexInterface (HDEVICE hDeviceID, void **ppIF)
 	 	pt->TexIF.pfnTextureFree				= (void *) TextureFree;
 		pt->TexIF.pfnTextureGetFreeMemory	 	= (void *) TextureGetFreeMemory;
 		pt->TexIF.pfnTextureGetFreeMemoryInfo 	= (void *) TextureGetFreeMemoryInfo;
+		pt->TexIF.pfnTextureCompact				= (void *) TextureCompact;
 				
 		*ppIF = (void *) &pt->TexIF;
 		
@@ -650,6 +659,7 @@ PVRHANDLE CALL_CONV PVROSCreateTexHeap(HDEVICE hDeviceID)
 		PVROSGetPCIDeviceInfo (hDeviceID, &pb);
 
 		pt->TexHeap.pMemoryRoot		= &(pt->MemoryRoot);
+		pt->TexHeap.pFreeIndex		= &(pt->FreeIndex);
 	 	pt->TexHeap.pTextureMemory	= (void*) pb.LinearMemWindows[1];
 		
 		/* Read the size for the texture parameter space in bytes */
@@ -420,6 +420,8 @@
 #include "pvrosapi.h"
 #include "hwregs.h"
 #include "heap.h"
+#include "capture.h"
+#include "sglthrd.h"
 
 #define API_FNBLOCK
 #include "sgl.h"
@@ -581,6 +583,10 @@ BOOL WINAPI DllMain (HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
 				hSystemInstance = NULL;
 			}
 
+			SglThreadPoolShutdown ();
+
+			CaptureClose ();
+
 			PVROSAPIExit ();
 			
 			if (gnInstances == 0)